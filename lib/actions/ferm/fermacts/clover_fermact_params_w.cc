@@ -20,7 +20,7 @@ namespace Chroma
     max_norm_usedP=false;
     twisted_m_usedP = false;
     twisted_m = Real(0);
-
+    fused_schurP = false;
   }
 
   //! Read parameters
@@ -96,6 +96,12 @@ namespace Chroma
       twisted_m_usedP = false;
     }
 
+    if( paramtop.count("FusedSchur") != 0 ) {
+      read(paramtop, "FusedSchur", fused_schurP);
+    }
+    else {
+      fused_schurP = false;
+    }
   }
 
   //! Read parameters
@@ -133,6 +139,10 @@ namespace Chroma
       write(xml, "TwistedM", param.twisted_m);
     }
 
+    if (param.fused_schurP) {
+      write(xml, "FusedSchur", param.fused_schurP);
+    }
+
     pop(xml);
   }
 
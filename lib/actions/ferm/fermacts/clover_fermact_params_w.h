@@ -32,6 +32,8 @@ namespace Chroma
     Real twisted_m;
     bool twisted_m_usedP;
 
+    // Optional fused Schur complement in the even-odd operator
+    bool fused_schurP;
   };
 
 
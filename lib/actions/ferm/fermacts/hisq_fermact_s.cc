@@ -39,7 +39,7 @@ theory (one day).
 #include "util/gauge/stag_phases_s.h"
 #include "util/gauge/reunit.h"
 #include "util/gauge/sun_proj.h"
-#include "meas/gfix/polar_dec.h"
+#include "util/gauge/su3_batch.h"
 
 // DEBUG
 #include "util/gauge/unit_check.h"
@@ -192,16 +192,13 @@ namespace Chroma
     Fat7_Links(u_with_phases, u_fat_I, pp);
 
     // reunitarise (using polar method)
-   LatticeReal  alpha ; // complex phase (not needed here)
-   Real  JacAccu = 0.00000000001 ;
-   int JacMax = 100 ; 
    LatticeColorMatrix  w ;
-   QDPIO::cout << "SU3 polar projection Accuracy " << JacAccu << " max iters = " <<  JacMax << std::endl;
+   QDPIO::cout << "SU3 polar projection" << std::endl;
 
    for(int i = 0; i < Nd; i++) 
      {
        w = u_fat_I[i] ;
-       polar_dec(w, u_fat_I[i],alpha, JacAccu, JacMax) ;
+       SU3Batch::polarProject(u_fat_I[i], w) ;
      }
 
    // with HISQ the three links are fat
@@ -0,0 +1,348 @@
+/*! \file
+ *  \brief Coarse lattices, fields and stencil operators of the aggregation multigrid
+ */
+
+#include "actions/ferm/invert/amg/amg_coarse.h"
+#include "util/info/perf_counters.h"
+
+#if defined(ARCH_PARSCALAR) || defined(ARCH_PARSCALARVEC)
+#include <qmp.h>
+#endif
+
+namespace Chroma
+{
+  namespace AMG
+  {
+
+    // Coarsen a lattice
+    CoarseGeometry::CoarseGeometry(const multi1d<int>& fine_latt,
+				   const multi1d<int>& fine_local,
+				   const multi1d<int>& block)
+    {
+      latt.resize(Nd);
+      L.resize(Nd);
+      stride.resize(Nd);
+
+      vol = 1;
+      for(int mu=0; mu < Nd; ++mu)
+      {
+	if (block[mu] < 1 || fine_local[mu] % block[mu] != 0)
+	{
+	  QDPIO::cerr << "AMG: block extent " << block[mu] << " does not divide the node extent "
+		      << fine_local[mu] << " in direction " << mu << std::endl;
+	  QDP_abort(1);
+	}
+
+	latt[mu]   = fine_latt[mu] / block[mu];
+	L[mu]      = fine_local[mu] / block[mu];
+	stride[mu] = vol;
+	vol *= L[mu];
+      }
+
+      const multi1d<int>& nodes = Layout::logicalSize();
+
+      // Halo faces, only towards other nodes
+      halo_offset.resize(2*Nd);
+      halo_vol = 0;
+      for(int dir=0; dir < 2*Nd; ++dir)
+      {
+	int mu = dir % Nd;
+	if (nodes[mu] > 1)
+	{
+	  halo_offset[dir] = halo_vol;
+	  halo_vol += vol / L[mu];
+	}
+	else
+	  halo_offset[dir] = -1;
+      }
+
+      // Neighbours and faces. Faces are in the lexicographic order of the
+      // sites, which is the same on all nodes.
+      nbr.resize(2*Nd*vol);
+      std::vector<int> pos_lo(Nd, 0), pos_hi(Nd, 0);
+      multi1d<int> c(Nd);
+
+      for(int x=0; x < vol; ++x)
+      {
+	coords(x, c);
+
+	for(int mu=0; mu < Nd; ++mu)
+	{
+	  int lo = -1, hi = -1;
+	  if (c[mu] == 0)
+	  {
+	    lo = pos_lo[mu]++;
+	    face_site[mu].push_back(x);
+	  }
+	  if (c[mu] == L[mu]-1)
+	  {
+	    hi = pos_hi[mu]++;
+	    face_site[Nd+mu].push_back(x);
+	  }
+
+	  multi1d<int> cn = c;
+
+	  // Forward
+	  if (hi >= 0 && halo_offset[mu] >= 0)
+	    nbr[x*2*Nd + mu] = vol + halo_offset[mu] + hi;
+	  else
+	  {
+	    cn[mu] = (c[mu] + 1) % L[mu];
+	    nbr[x*2*Nd + mu] = site(cn);
+	  }
+
+	  // Backward
+	  if (lo >= 0 && halo_offset[Nd+mu] >= 0)
+	    nbr[x*2*Nd + Nd+mu] = vol + halo_offset[Nd+mu] + lo;
+	  else
+	  {
+	    cn[mu] = (c[mu] + L[mu] - 1) % L[mu];
+	    nbr[x*2*Nd + Nd+mu] = site(cn);
+	  }
+	}
+      }
+    }
+
+
+    // Node coordinates of a site
+    void CoarseGeometry::coords(int x, multi1d<int>& c) const
+    {
+      c.resize(Nd);
+      for(int mu=0; mu < Nd; ++mu)
+	c[mu] = (x / stride[mu]) % L[mu];
+    }
+
+
+    // Site of node coordinates
+    int CoarseGeometry::site(const multi1d<int>& c) const
+    {
+      int x = 0;
+      for(int mu=0; mu < Nd; ++mu)
+	x += c[mu] * stride[mu];
+
+      return x;
+    }
+
+
+    // Global coordinates of a site
+    void CoarseGeometry::globalCoords(int x, multi1d<int>& c) const
+    {
+      coords(x, c);
+      for(int mu=0; mu < Nd; ++mu)
+	c[mu] += Layout::nodeCoord()[mu] * L[mu];
+    }
+
+
+    /*! Fill the halo
+     *
+     *  The forward face of a node holds the sites  c[mu] = 0  of the node
+     *  above it, and the backward face the sites  c[mu] = L[mu]-1  of the
+     *  node below. All faces are exchanged at once.
+     */
+    void CoarseGeometry::exchange(const std::vector<Cplx>& v, int nc, std::vector<Cplx>& halo) const
+    {
+      halo.resize(halo_vol*nc);
+
+#if defined(ARCH_PARSCALAR) || defined(ARCH_PARSCALARVEC)
+      if (halo_vol == 0)
+	return;
+
+      std::vector< std::vector<Cplx> > send(2*Nd);
+      std::vector<QMP_msgmem_t>    mm;
+      std::vector<QMP_msghandle_t> mh;
+      double sent = 0;
+
+      for(int dir=0; dir < 2*Nd; ++dir)
+      {
+	if (halo_offset[dir] < 0)
+	  continue;
+
+	const int mu = dir % Nd;
+	const bool forward = (dir < Nd);
+	const std::vector<int>& fs = face_site[dir];
+
+	send[dir].resize(fs.size()*nc);
+	for(int i=0; i < fs.size(); ++i)
+	  for(int a=0; a < nc; ++a)
+	    send[dir][i*nc + a] = v[fs[i]*nc + a];
+
+	const size_t bytes = fs.size() * nc * sizeof(Cplx);
+
+	QMP_msgmem_t m_recv = QMP_declare_msgmem(&halo[halo_offset[dir]*nc], bytes);
+	QMP_msgmem_t m_send = QMP_declare_msgmem(&send[dir][0], bytes);
+	mm.push_back(m_recv);
+	mm.push_back(m_send);
+	sent += bytes;
+
+	mh.push_back(QMP_declare_receive_relative(m_recv, mu, forward ? +1 : -1, 0));
+	mh.push_back(QMP_declare_send_relative(m_send, mu, forward ? -1 : +1, 0));
+      }
+
+      QMP_msghandle_t all = QMP_declare_multiple(&mh[0], mh.size());
+      if (all == (QMP_msghandle_t)NULL)
+	QDP_error_exit("AMG: QMP_declare_multiple failed in CoarseGeometry::exchange\n");
+
+      {
+	PerfCounters::HaloRegion perf_halo(sent);
+
+	QMP_status_t err;
+	if ((err = QMP_start(all)) != QMP_SUCCESS)
+	  QDP_error_exit(QMP_error_string(err));
+	if ((err = QMP_wait(all)) != QMP_SUCCESS)
+	  QDP_error_exit(QMP_error_string(err));
+      }
+
+      QMP_free_msghandle(all);
+      for(int i=0; i < mm.size(); ++i)
+	QMP_free_msgmem(mm[i]);
+#endif
+    }
+
+
+    //--------------------------------------------------------------------------
+    namespace
+    {
+      //! Arguments of the stencil loop
+      struct ApplyArgs
+      {
+	const CoarseOperator*  op;
+	const Cplx*            in;
+	const Cplx*            halo;
+	Cplx*                  out;
+      };
+
+      //! out(x) for the sites of a thread
+      void applySiteLoop(int lo, int hi, int myId, ApplyArgs* a)
+      {
+	const CoarseOperator& op = *(a->op);
+	const CoarseGeometry& g = op.geometry();
+	const int nc  = op.numColours();
+	const int vol = g.volume();
+
+	for(int x=lo; x < hi; ++x)
+	{
+	  Cplx* o = a->out + x*nc;
+
+	  const Cplx* M = op.diag(x);
+	  const Cplx* v = a->in + x*nc;
+	  for(int i=0; i < nc; ++i)
+	  {
+	    Cplx s = 0;
+	    for(int j=0; j < nc; ++j)
+	      s += M[i*nc + j] * v[j];
+	    o[i] = s;
+	  }
+
+	  for(int dir=0; dir < 2*Nd; ++dir)
+	  {
+	    int n = g.neighbour(x, dir);
+	    M = op.hop(x, dir);
+	    v = (n < vol) ? a->in + n*nc : a->halo + (n-vol)*nc;
+
+	    for(int i=0; i < nc; ++i)
+	    {
+	      Cplx s = 0;
+	      for(int j=0; j < nc; ++j)
+		s += M[i*nc + j] * v[j];
+	      o[i] += s;
+	    }
+	  }
+	}
+      }
+    }
+
+
+    // Zero operator
+    CoarseOperator::CoarseOperator(Handle<CoarseGeometry> geom_, int nc_) : geom(geom_), nc(nc_)
+    {
+      D.resize(geom->volume()*nc*nc);
+      Y.resize(geom->volume()*2*Nd*nc*nc);
+      setZero();
+    }
+
+
+    // Zero
+    void CoarseOperator::setZero()
+    {
+      for(int i=0; i < D.size(); ++i)
+	D[i] = 0;
+      for(int i=0; i < Y.size(); ++i)
+	Y[i] = 0;
+    }
+
+
+    // Apply
+    void CoarseOperator::operator()(CoarseVector& out, const CoarseVector& in) const
+    {
+      geom->exchange(in.data, nc, halo);
+
+      out.nc = nc;
+      out.data.resize(in.data.size());
+
+      ApplyArgs a;
+      a.op   = this;
+      a.in   = &in.data[0];
+      a.halo = halo.size() > 0 ? &halo[0] : 0;
+      a.out  = &out.data[0];
+
+      dispatch_to_threads(geom->volume(), a, applySiteLoop);
+    }
+
+
+    //--------------------------------------------------------------------------
+    // Global < x, y >
+    Cplx dotProduct(const CoarseVector& x, const CoarseVector& y)
+    {
+      double s[2] = {0, 0};
+      for(int i=0; i < x.data.size(); ++i)
+      {
+	Cplx d = std::conj(x.data[i]) * y.data[i];
+	s[0] += d.real();
+	s[1] += d.imag();
+      }
+
+      {
+	PerfCounters::ReductionRegion perf_sum(2);
+	QDPInternal::globalSumArray(s, 2);
+      }
+      return Cplx(s[0], s[1]);
+    }
+
+    // Global || x ||^2
+    double normSq(const CoarseVector& x)
+    {
+      double s = 0;
+      for(int i=0; i < x.data.size(); ++i)
+	s += std::norm(x.data[i]);
+
+      {
+	PerfCounters::ReductionRegion perf_sum(1);
+	QDPInternal::globalSum(s);
+      }
+      return s;
+    }
+
+    // y += a x
+    void axpy(CoarseVector& y, const Cplx& a, const CoarseVector& x)
+    {
+      for(int i=0; i < y.data.size(); ++i)
+	y.data[i] += a * x.data[i];
+    }
+
+    // x *= a
+    void scale(CoarseVector& x, const Cplx& a)
+    {
+      for(int i=0; i < x.data.size(); ++i)
+	x.data[i] *= a;
+    }
+
+    // x = 0
+    void setZero(CoarseVector& x)
+    {
+      for(int i=0; i < x.data.size(); ++i)
+	x.data[i] = 0;
+    }
+
+  } // namespace AMG
+
+} // namespace Chroma
@@ -0,0 +1,164 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Coarse lattices, fields and stencil operators of the aggregation multigrid
+ */
+
+#ifndef __amg_coarse_h__
+#define __amg_coarse_h__
+
+#include "chromabase.h"
+#include "handle.h"
+
+#include <complex>
+#include <vector>
+
+namespace Chroma
+{
+  namespace AMG
+  {
+    //! Scalar type of the coarse levels
+    typedef std::complex<double> Cplx;
+
+
+    //! A coarse lattice, made of blocks of a finer one
+    /*! \ingroup invert
+     *
+     * Every node holds the coarse sites of its own blocks, so the node
+     * grid is the one of QDP. Blocks may not straddle nodes. Sites are
+     * numbered lexicographically within the node.
+     *
+     * The neighbours of a site are either on the node, or in a halo
+     * that exchange() fills from the neighbouring nodes.
+     */
+    class CoarseGeometry
+    {
+    public:
+      //! Coarsen a lattice
+      /*!
+       * \param fine_latt    global extents of the finer lattice ( Read )
+       * \param fine_local   node extents of the finer lattice ( Read )
+       * \param block        block extents ( Read )
+       */
+      CoarseGeometry(const multi1d<int>& fine_latt,
+		     const multi1d<int>& fine_local,
+		     const multi1d<int>& block);
+
+      //! Global extents
+      const multi1d<int>& lattSize() const {return latt;}
+
+      //! Node extents
+      const multi1d<int>& subgridLattSize() const {return L;}
+
+      //! Sites on the node
+      int volume() const {return vol;}
+
+      //! Node coordinates of a site
+      void coords(int x, multi1d<int>& c) const;
+
+      //! Site of node coordinates
+      int site(const multi1d<int>& c) const;
+
+      //! Global coordinates of a site
+      void globalCoords(int x, multi1d<int>& c) const;
+
+      //! Neighbour of x in direction dir, forward mu = dir < Nd, backward mu = dir-Nd
+      /*! Indices from volume() on are halo sites */
+      int neighbour(int x, int dir) const {return nbr[x*2*Nd + dir];}
+
+      //! Number of halo sites
+      int haloVolume() const {return halo_vol;}
+
+      //! Fill the halo of a field with nc components per site
+      void exchange(const std::vector<Cplx>& v, int nc, std::vector<Cplx>& halo) const;
+
+    private:
+      multi1d<int>  latt;
+      multi1d<int>  L;
+      multi1d<int>  stride;
+      int           vol;
+
+      std::vector<int>  nbr;         /*!< 2*Nd neighbours per site */
+      int               halo_vol;
+      multi1d<int>      halo_offset; /*!< first halo site of each of the 2*Nd faces, -1 if local */
+      std::vector<int>  face_site[2*Nd]; /*!< sites sent to fill the face dir of the neighbour */
+    };
+
+
+    //! A field on a coarse lattice, nc components per site
+    /*! \ingroup invert */
+    struct CoarseVector
+    {
+      CoarseVector() : nc(0) {}
+      CoarseVector(const CoarseGeometry& g, int nc_) : nc(nc_), data(g.volume()*nc_, Cplx(0)) {}
+
+      Cplx* site(int x) {return &data[x*nc];}
+      const Cplx* site(int x) const {return &data[x*nc];}
+
+      int                nc;
+      std::vector<Cplx>  data;
+    };
+
+
+    //! Nearest neighbour stencil on a coarse lattice
+    /*! \ingroup invert
+     *
+     *  out(x) = D(x) in(x) + sum_dir Y_dir(x) in(x + dir)
+     *
+     * with nc x nc matrices, stored row major.
+     */
+    class CoarseOperator
+    {
+    public:
+      //! Zero operator on a lattice
+      CoarseOperator(Handle<CoarseGeometry> geom_, int nc_);
+
+      //! Apply
+      void operator()(CoarseVector& out, const CoarseVector& in) const;
+
+      //! Set all matrices to zero
+      void setZero();
+
+      //! Site matrix
+      Cplx* diag(int x) {return &D[x*nc*nc];}
+      const Cplx* diag(int x) const {return &D[x*nc*nc];}
+
+      //! Hopping matrix
+      Cplx* hop(int x, int dir) {return &Y[(x*2*Nd + dir)*nc*nc];}
+      const Cplx* hop(int x, int dir) const {return &Y[(x*2*Nd + dir)*nc*nc];}
+
+      //! Components per site
+      int numColours() const {return nc;}
+
+      //! The lattice
+      const CoarseGeometry& geometry() const {return *geom;}
+      Handle<CoarseGeometry> geometryHandle() const {return geom;}
+
+    private:
+      Handle<CoarseGeometry>  geom;
+      int                     nc;
+      std::vector<Cplx>       D;
+      std::vector<Cplx>       Y;
+      mutable std::vector<Cplx> halo;
+    };
+
+
+    //! Global < x, y >
+    Cplx dotProduct(const CoarseVector& x, const CoarseVector& y);
+
+    //! Global || x ||^2
+    double normSq(const CoarseVector& x);
+
+    //! y += a x
+    void axpy(CoarseVector& y, const Cplx& a, const CoarseVector& x);
+
+    //! x *= a
+    void scale(CoarseVector& x, const Cplx& a);
+
+    //! x = 0
+    void setZero(CoarseVector& x);
+
+  } // namespace AMG
+
+} // namespace Chroma
+
+#endif
@@ -0,0 +1,396 @@
+/*! \file
+ *  \brief Levels and cycles of the aggregation multigrid
+ */
+
+#include "actions/ferm/invert/amg/amg_hierarchy.h"
+#include "meas/inline/io/named_objmap.h"
+
+#include <random>
+
+namespace Chroma
+{
+  namespace AMG
+  {
+
+    // Allocate the levels
+    Hierarchy::Hierarchy(const SysSolverAMGParams& p_) : p(p_), n_levels(p_.MGLevels), fp(0)
+    {
+      START_CODE();
+
+      fine_transfer = new FineTransfer(p.Blocking[0], p.NullVecs[0]);
+      fine_vecs.resize(p.NullVecs[0]);
+
+      transfer.resize(n_levels-1);
+      op.resize(n_levels);
+      vecs.resize(n_levels-1);
+
+      op[1] = new CoarseOperator(fine_transfer->coarseGeometry(), fine_transfer->numCoarseColours());
+
+      for(int l=1; l < n_levels-1; ++l)
+      {
+	transfer[l] = new CoarseTransfer(op[l]->geometryHandle(), op[l]->numColours(),
+					 p.Blocking[l], p.NullVecs[l]);
+	op[l+1] = new CoarseOperator(transfer[l]->coarseGeometry(), transfer[l]->numCoarseColours());
+      }
+
+      for(int l=1; l < n_levels; ++l)
+      {
+	const multi1d<int>& latt = op[l]->geometry().lattSize();
+	QDPIO::cout << "AMG: level " << l << " lattice";
+	for(int mu=0; mu < Nd; ++mu)
+	  QDPIO::cout << " " << latt[mu];
+	QDPIO::cout << " with " << op[l]->numColours() << " components per site" << std::endl;
+      }
+
+      END_CODE();
+    }
+
+
+    // Make the levels
+    void Hierarchy::setup(Handle< LinearOperator<T> > A_)
+    {
+      START_CODE();
+
+      StopWatch swatch;
+      swatch.reset();
+      swatch.start();
+
+      A = A_;
+
+      if (A->subset().numSiteTable() != Layout::sitesOnNode())
+      {
+	QDPIO::cerr << "AMG: the operator must act on the whole lattice, not on one checkerboard" << std::endl;
+	QDP_abort(1);
+      }
+
+      for(int l=0; l < n_levels-1; ++l)
+      {
+	initialVectors(l);
+	coarsenFrom(l, false);
+      }
+
+      improve(p.SetupCycles);
+      fp = fingerprint(*A);
+
+      swatch.stop();
+      QDPIO::cout << "AMG_SETUP: " << n_levels << " levels in " << swatch.getTimeInSeconds() << " sec" << std::endl;
+
+      END_CODE();
+    }
+
+
+    // Follow the operator
+    void Hierarchy::update(Handle< LinearOperator<T> > A_)
+    {
+      START_CODE();
+
+      double f = fingerprint(*A_);
+      A = A_;
+
+      if (std::abs(f - fp) <= 1.0e-10 * std::abs(fp))
+      {
+	END_CODE();
+	return;
+      }
+
+      if (p.RefreshCycles <= 0)
+      {
+	QDPIO::cout << "AMG: new operator, new setup" << std::endl;
+	setup(A);
+	END_CODE();
+	return;
+      }
+
+      StopWatch swatch;
+      swatch.reset();
+      swatch.start();
+
+      coarsenFrom(0, true);
+      improve(p.RefreshCycles);
+      fp = fingerprint(*A);
+
+      swatch.stop();
+      QDPIO::cout << "AMG_REFRESH: " << p.RefreshCycles << " passes in " << swatch.getTimeInSeconds() << " sec" << std::endl;
+
+      END_CODE();
+    }
+
+
+    // || A v_0 ||^2
+    double Hierarchy::fingerprint(const LinearOperator<T>& A_) const
+    {
+      T t;
+      A_(t, fine_vecs[0], PLUS);
+      return toDouble(norm2(t));
+    }
+
+
+    // First null vectors
+    void Hierarchy::initialVectors(int l)
+    {
+      START_CODE();
+
+      if (l == 0)
+      {
+	LevelOp<T> A0 = [this](T& out, const T& in) {(*A)(out, in, PLUS);};
+	T b = zero;
+
+	// The setup must not move the random number stream of the run
+	Seed ran_seed;
+	QDP::RNG::savern(ran_seed);
+
+	for(int k=0; k < fine_vecs.size(); ++k)
+	{
+	  gaussian(fine_vecs[k]);
+	  mrSteps(A0, fine_vecs[k], b, p.NullIters[0]);
+	  fine_vecs[k] *= Real(1.0 / std::sqrt(normSq(fine_vecs[k])));
+	}
+
+	QDP::RNG::setrn(ran_seed);
+      }
+      else
+      {
+	const CoarseOperator& Al = *op[l];
+	LevelOp<CoarseVector> Aop = [&Al](CoarseVector& out, const CoarseVector& in) {Al(out, in);};
+	CoarseVector b(Al.geometry(), Al.numColours());
+
+	vecs[l].assign(p.NullVecs[l], b);
+	for(int k=0; k < vecs[l].size(); ++k)
+	{
+	  std::mt19937 gen(9973 * Layout::nodeNumber() + 101 * l + k);
+	  std::normal_distribution<double> gauss;
+
+	  CoarseVector& v = vecs[l][k];
+	  for(int i=0; i < v.data.size(); ++i)
+	    v.data[i] = Cplx(gauss(gen), gauss(gen));
+
+	  mrSteps(Aop, v, b, p.NullIters[l]);
+	  scale(v, Cplx(1.0 / std::sqrt(normSq(v))));
+	}
+      }
+
+      END_CODE();
+    }
+
+
+    // One step  x -= M A x  on each null vector
+    void Hierarchy::improveVectors(int l)
+    {
+      START_CODE();
+
+      if (l == 0)
+      {
+	T r, e;
+	for(int k=0; k < fine_vecs.size(); ++k)
+	{
+	  (*A)(r, fine_vecs[k], PLUS);
+	  (*this)(e, r);
+	  fine_vecs[k] -= e;
+	  fine_vecs[k] *= Real(1.0 / std::sqrt(normSq(fine_vecs[k])));
+	}
+      }
+      else
+      {
+	const CoarseOperator& Al = *op[l];
+	CoarseVector r(Al.geometry(), Al.numColours());
+	CoarseVector e(Al.geometry(), Al.numColours());
+
+	for(int k=0; k < vecs[l].size(); ++k)
+	{
+	  CoarseVector& v = vecs[l][k];
+	  Al(r, v);
+	  coarseCycle(l, e, r);
+	  axpy(v, Cplx(-1), e);
+	  scale(v, Cplx(1.0 / std::sqrt(normSq(v))));
+	}
+      }
+
+      END_CODE();
+    }
+
+
+    // Rebuild the coarse operators
+    void Hierarchy::coarsenFrom(int l, bool deep)
+    {
+      START_CODE();
+
+      if (l == 0)
+      {
+	fine_transfer->setVectors(fine_vecs);
+	fine_transfer->coarsen(*A, *op[1]);
+      }
+      else
+      {
+	transfer[l]->setVectors(vecs[l]);
+	transfer[l]->coarsen(*op[l], *op[l+1]);
+      }
+
+      if (deep)
+      {
+	for(int m=l+1; m < n_levels-1; ++m)
+	  transfer[m]->coarsen(*op[m], *op[m+1]);
+      }
+
+      END_CODE();
+    }
+
+
+    // Improving passes
+    void Hierarchy::improve(int passes)
+    {
+      for(int pass=0; pass < passes; ++pass)
+	for(int l=0; l < n_levels-1; ++l)
+	{
+	  improveVectors(l);
+	  coarsenFrom(l, true);
+	}
+    }
+
+
+    /*! Coarse correction
+     *
+     *  GMRES on the coarsest level. Above it, a K-cycle runs a few FGMRES
+     *  steps preconditioned by the cycle of the level, and a V-cycle
+     *  applies the cycle once.
+     */
+    void Hierarchy::coarseSolve(int l, CoarseVector& x, const CoarseVector& b) const
+    {
+      const CoarseOperator& Al = *op[l];
+      LevelOp<CoarseVector> Aop = [&Al](CoarseVector& out, const CoarseVector& in) {Al(out, in);};
+
+      x = CoarseVector(Al.geometry(), Al.numColours());
+      double r_norm;
+
+      if (l == n_levels-1)
+      {
+	fgmres(Aop, (const LevelOp<CoarseVector>*)0, x, b,
+	       p.CoarsestNKrylov, p.CoarsestMaxIter, toDouble(p.CoarsestRsd), r_norm);
+      }
+      else if (p.Cycle == "K")
+      {
+	LevelOp<CoarseVector> M = [this,l](CoarseVector& out, const CoarseVector& in) {coarseCycle(l, out, in);};
+	fgmres(Aop, &M, x, b, p.KCycleIters, p.KCycleIters, toDouble(p.KCycleRsd), r_norm);
+      }
+      else
+      {
+	coarseCycle(l, x, b);
+      }
+    }
+
+
+    // One cycle on coarse level l
+    void Hierarchy::coarseCycle(int l, CoarseVector& x, const CoarseVector& b) const
+    {
+      const CoarseOperator& Al = *op[l];
+      LevelOp<CoarseVector> Aop = [&Al](CoarseVector& out, const CoarseVector& in) {Al(out, in);};
+
+      x = CoarseVector(Al.geometry(), Al.numColours());
+      mrSteps(Aop, x, b, p.PreSmooth);
+
+      CoarseVector r = b;
+      if (p.PreSmooth > 0)
+      {
+	CoarseVector t;
+	Al(t, x);
+	axpy(r, Cplx(-1), t);
+      }
+
+      CoarseVector rc, ec, e;
+      transfer[l]->restrictTo(rc, r);
+      coarseSolve(l+1, ec, rc);
+      transfer[l]->prolong(e, ec);
+      axpy(x, Cplx(1), e);
+
+      mrSteps(Aop, x, b, p.PostSmooth);
+    }
+
+
+    // One cycle on the fine level
+    void Hierarchy::operator()(T& x, const T& b) const
+    {
+      START_CODE();
+
+      LevelOp<T> A0 = [this](T& out, const T& in) {(*A)(out, in, PLUS);};
+
+      x = zero;
+      mrSteps(A0, x, b, p.PreSmooth);
+
+      T r = b;
+      if (p.PreSmooth > 0)
+      {
+	T t;
+	(*A)(t, x, PLUS);
+	r -= t;
+      }
+
+      CoarseVector rc, ec;
+      fine_transfer->restrictTo(rc, r);
+      coarseSolve(1, ec, rc);
+
+      T e;
+      fine_transfer->prolong(e, ec);
+      x += e;
+
+      mrSteps(A0, x, b, p.PostSmooth);
+
+      END_CODE();
+    }
+
+
+    //--------------------------------------------------------------------------
+    // The setup held under an id
+    std::shared_ptr<Hierarchy> getHierarchy(const std::string& subspaceId)
+    {
+      if (TheNamedObjMap::Instance().check(subspaceId))
+	return TheNamedObjMap::Instance().getData< std::shared_ptr<Hierarchy> >(subspaceId);
+
+      return std::shared_ptr<Hierarchy>();
+    }
+
+
+    // Make and hold a setup
+    std::shared_ptr<Hierarchy> createHierarchy(const SysSolverAMGParams& p,
+					       Handle< LinearOperator<LatticeFermion> > A)
+    {
+      START_CODE();
+
+      deleteHierarchy(p.SubspaceId);
+
+      QDPIO::cout << "AMG: creating subspace " << p.SubspaceId << std::endl;
+
+      std::shared_ptr<Hierarchy> h = std::make_shared<Hierarchy>(p);
+      h->setup(A);
+
+      XMLBufferWriter file_xml;
+      push(file_xml, "FileXML");
+      pop(file_xml);
+
+      XMLBufferWriter record_xml;
+      push(record_xml, "RecordXML");
+      write(record_xml, "InvertParam", p);
+      pop(record_xml);
+
+      TheNamedObjMap::Instance().create< std::shared_ptr<Hierarchy> >(p.SubspaceId);
+      TheNamedObjMap::Instance().get(p.SubspaceId).setFileXML(file_xml);
+      TheNamedObjMap::Instance().get(p.SubspaceId).setRecordXML(record_xml);
+      TheNamedObjMap::Instance().getData< std::shared_ptr<Hierarchy> >(p.SubspaceId) = h;
+
+      END_CODE();
+
+      return h;
+    }
+
+
+    // Drop a setup
+    void deleteHierarchy(const std::string& subspaceId)
+    {
+      if (TheNamedObjMap::Instance().check(subspaceId))
+      {
+	QDPIO::cout << "AMG: deleting subspace " << subspaceId << std::endl;
+	TheNamedObjMap::Instance().erase(subspaceId);
+      }
+    }
+
+  } // namespace AMG
+
+} // namespace Chroma
@@ -0,0 +1,115 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Levels and cycles of the aggregation multigrid
+ */
+
+#ifndef __amg_hierarchy_h__
+#define __amg_hierarchy_h__
+
+#include "chromabase.h"
+#include "handle.h"
+#include "linearop.h"
+#include "actions/ferm/invert/amg/syssolver_amg_params.h"
+#include "actions/ferm/invert/amg/amg_coarse.h"
+#include "actions/ferm/invert/amg/amg_transfer.h"
+#include "actions/ferm/invert/amg/amg_krylov.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Chroma
+{
+  namespace AMG
+  {
+
+    //! The levels of an adaptive aggregation multigrid
+    /*! \ingroup invert
+     *
+     * Level 0 is the fine operator. Each coarser level l+1 is the Galerkin
+     * product of level l with the aggregation of its near null vectors.
+     *
+     * The vectors are first found by MR steps on  A x = 0  from random
+     * vectors (inverse iteration), level by level. SetupCycles passes then
+     * improve them with the multigrid cycle itself: every vector takes a
+     * step  x -= M A x, and the coarse operators are rebuilt.
+     *
+     * The setup belongs to the gauge field, not to one solve. When the
+     * operator changes, as it does between HMC trajectories, update()
+     * keeps the vectors, rebuilds the coarse operators, and runs
+     * RefreshCycles improving passes, which costs far less than a new
+     * setup.
+     */
+    class Hierarchy
+    {
+    public:
+      typedef LatticeFermion T;
+
+      //! Allocate the levels
+      Hierarchy(const SysSolverAMGParams& p);
+
+      //! Make the levels of an operator
+      void setup(Handle< LinearOperator<T> > A);
+
+      //! Follow a possibly new operator
+      /*!
+       * Detected from  || A v_0 ||  for the first null vector. The same
+       * operator is only taken over, a new one is refreshed.
+       */
+      void update(Handle< LinearOperator<T> > A);
+
+      //! One cycle,  x ~ A^{-1} b
+      void operator()(T& x, const T& b) const;
+
+      //! The parameters of the setup
+      const SysSolverAMGParams& params() const {return p;}
+
+    private:
+      //! Coarse correction on level l, x from 0
+      void coarseSolve(int l, CoarseVector& x, const CoarseVector& b) const;
+
+      //! One cycle on coarse level l
+      void coarseCycle(int l, CoarseVector& x, const CoarseVector& b) const;
+
+      //! First null vectors of level l
+      void initialVectors(int l);
+
+      //! One improving step on the null vectors of level l
+      void improveVectors(int l);
+
+      //! Rebuild the coarse operators below level l
+      void coarsenFrom(int l, bool deep);
+
+      //! Passes of improveVectors over all levels
+      void improve(int passes);
+
+      //! Changes with the operator
+      double fingerprint(const LinearOperator<T>& A) const;
+
+      SysSolverAMGParams                      p;
+      int                                     n_levels;
+      Handle< LinearOperator<T> >             A;
+      Handle<FineTransfer>                    fine_transfer;
+      multi1d<T>                              fine_vecs;
+      std::vector< Handle<CoarseTransfer> >   transfer;   /*!< from level l to l+1, l >= 1 */
+      std::vector< Handle<CoarseOperator> >   op;         /*!< operator of level l >= 1 */
+      std::vector< std::vector<CoarseVector> > vecs;      /*!< null vectors of level l >= 1 */
+      double                                  fp;
+    };
+
+
+    //! The setup held under an id, null if there is none
+    std::shared_ptr<Hierarchy> getHierarchy(const std::string& subspaceId);
+
+    //! Make and hold a setup
+    std::shared_ptr<Hierarchy> createHierarchy(const SysSolverAMGParams& p,
+					       Handle< LinearOperator<LatticeFermion> > A);
+
+    //! Drop a setup
+    void deleteHierarchy(const std::string& subspaceId);
+
+  } // namespace AMG
+
+} // namespace Chroma
+
+#endif
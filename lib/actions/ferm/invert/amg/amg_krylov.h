@@ -0,0 +1,204 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief MR and flexible GMRES on any level of the aggregation multigrid
+ */
+
+#ifndef __amg_krylov_h__
+#define __amg_krylov_h__
+
+#include "chromabase.h"
+#include "actions/ferm/invert/amg/amg_coarse.h"
+
+#include <functional>
+#include <vector>
+
+namespace Chroma
+{
+  namespace AMG
+  {
+    //! Operator of a level,  out = A in
+    template<typename V>
+    using LevelOp = std::function<void(V&, const V&)>;
+
+
+    //! The fine level vector operations, on the whole lattice
+    inline Cplx dotProduct(const LatticeFermion& x, const LatticeFermion& y)
+    {
+      DComplex d = innerProduct(x, y);
+      return Cplx(toDouble(real(d)), toDouble(imag(d)));
+    }
+
+    inline double normSq(const LatticeFermion& x)
+    {
+      return toDouble(norm2(x));
+    }
+
+    inline void axpy(LatticeFermion& y, const Cplx& a, const LatticeFermion& x)
+    {
+      y += cmplx(Real(a.real()), Real(a.imag())) * x;
+    }
+
+    inline void scale(LatticeFermion& x, const Cplx& a)
+    {
+      LatticeFermion t = cmplx(Real(a.real()), Real(a.imag())) * x;
+      x = t;
+    }
+
+    inline void setZero(LatticeFermion& x)
+    {
+      x = zero;
+    }
+
+
+    //! Minimal residual steps on  A x = b, from the given x
+    /*! \ingroup invert */
+    template<typename V>
+    void mrSteps(const LevelOp<V>& A, V& x, const V& b, int n)
+    {
+      if (n <= 0)
+	return;
+
+      V r(b), Ar(b);
+      A(Ar, x);
+      axpy(r, Cplx(-1), Ar);
+
+      for(int k=0; k < n; ++k)
+      {
+	A(Ar, r);
+
+	double ar2 = normSq(Ar);
+	if (ar2 <= 0)
+	  break;
+
+	Cplx a = dotProduct(Ar, r) / ar2;
+	axpy(x, a, r);
+	axpy(r, -a, Ar);
+      }
+    }
+
+
+    //! Restarted flexible GMRES on  A x = b, from the given x
+    /*! \ingroup invert
+     *
+     * The preconditioner may change from one call to the next, as the
+     * multigrid cycles do. Stops when  || r || <= rsd || b ||  or after
+     * max_iter applications of A. The residuum is recomputed at every
+     * restart.
+     *
+     * \return  the number of iterations
+     */
+    template<typename V>
+    int fgmres(const LevelOp<V>& A, const LevelOp<V>* M,
+	       V& x, const V& b,
+	       int n_krylov, int max_iter, double rsd,
+	       double& r_norm)
+    {
+      const double target = rsd * std::sqrt(normSq(b));
+
+      V r(b), w(b);
+      A(w, x);
+      axpy(r, Cplx(-1), w);
+      r_norm = std::sqrt(normSq(r));
+
+      std::vector<V> v(n_krylov+1, b);
+      std::vector<V> z(n_krylov, b);
+
+      // Hessenberg matrix, column major, reduced by Givens rotations
+      std::vector<Cplx> H((n_krylov+1)*n_krylov);
+      std::vector<Cplx> cs(n_krylov), sn(n_krylov), g(n_krylov+1);
+
+      int iters = 0;
+      while (r_norm > target && iters < max_iter)
+      {
+	v[0] = r;
+	scale(v[0], Cplx(1.0/r_norm));
+	for(int i=0; i <= n_krylov; ++i)
+	  g[i] = 0;
+	g[0] = r_norm;
+
+	int dim = 0;
+	for(int j=0; j < n_krylov && iters < max_iter; ++j)
+	{
+	  if (M)
+	    (*M)(z[j], v[j]);
+	  else
+	    z[j] = v[j];
+
+	  A(w, z[j]);
+	  ++iters;
+
+	  Cplx* h = &H[j*(n_krylov+1)];
+	  for(int i=0; i <= j; ++i)
+	  {
+	    h[i] = dotProduct(v[i], w);
+	    axpy(w, -h[i], v[i]);
+	  }
+	  double w_norm = std::sqrt(normSq(w));
+	  h[j+1] = w_norm;
+
+	  // The old rotations, then a new one that zeroes h[j+1]
+	  for(int i=0; i < j; ++i)
+	  {
+	    Cplx t = std::conj(cs[i])*h[i] + std::conj(sn[i])*h[i+1];
+	    h[i+1] = -sn[i]*h[i] + cs[i]*h[i+1];
+	    h[i] = t;
+	  }
+
+	  double t = std::sqrt(std::norm(h[j]) + std::norm(h[j+1]));
+	  if (t > 0)
+	  {
+	    cs[j] = h[j] / t;
+	    sn[j] = h[j+1] / t;
+	  }
+	  else
+	  {
+	    cs[j] = 1;
+	    sn[j] = 0;
+	  }
+	  h[j] = t;
+	  h[j+1] = 0;
+
+	  g[j+1] = -sn[j]*g[j];
+	  g[j]   = std::conj(cs[j])*g[j];
+
+	  dim = j+1;
+
+	  if (w_norm <= 0 || std::abs(g[j+1]) <= target)
+	    break;
+
+	  v[j+1] = w;
+	  scale(v[j+1], Cplx(1.0/w_norm));
+	}
+
+	// Back substitution for the coefficients of z
+	std::vector<Cplx> y(dim);
+	for(int i=dim-1; i >= 0; --i)
+	{
+	  Cplx s = g[i];
+	  for(int k=i+1; k < dim; ++k)
+	    s -= H[k*(n_krylov+1) + i] * y[k];
+
+	  const Cplx d = H[i*(n_krylov+1) + i];
+	  y[i] = (std::abs(d) > 0) ? s / d : Cplx(0);
+	}
+
+	for(int i=0; i < dim; ++i)
+	  axpy(x, y[i], z[i]);
+
+	r = b;
+	A(w, x);
+	axpy(r, Cplx(-1), w);
+	r_norm = std::sqrt(normSq(r));
+
+	if (dim == 0)
+	  break;
+      }
+
+      return iters;
+    }
+
+  } // namespace AMG
+
+} // namespace Chroma
+
+#endif
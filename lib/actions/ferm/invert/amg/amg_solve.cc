@@ -0,0 +1,90 @@
+/*! \file
+ *  \brief Multigrid preconditioned solves on the whole lattice or on the odd sites
+ */
+
+#include "actions/ferm/invert/amg/amg_solve.h"
+#include "actions/ferm/invert/amg/amg_krylov.h"
+
+namespace Chroma
+{
+  namespace AMG
+  {
+
+    // The operator the levels are made from
+    Handle< LinearOperator<LatticeFermion> > fineOperator(Handle< LinearOperator<LatticeFermion> > A)
+    {
+      typedef LatticeFermion               T;
+      typedef multi1d<LatticeColorMatrix>  Q;
+
+      if (A->subset().numSiteTable() == Layout::sitesOnNode())
+	return A;
+
+      const EvenOddPrecLinearOperator<T,Q,Q>* M = dynamic_cast<const EvenOddPrecLinearOperator<T,Q,Q>*>(A.operator->());
+      if (M == 0)
+      {
+	QDPIO::cerr << "AMG: the operator must act on the whole lattice, or be an even-odd preconditioned one" << std::endl;
+	QDP_abort(1);
+      }
+
+      return new UnprecAdaptor(A, *M);
+    }
+
+
+    // Solve  A psi = chi  or  A^dag psi = chi
+    int solve(const Hierarchy& h, const LinearOperator<LatticeFermion>& A,
+	      LatticeFermion& psi, const LatticeFermion& chi, enum PlusMinus isign,
+	      const SysSolverAMGParams& p, double& r_norm)
+    {
+      typedef LatticeFermion T;
+
+      const Subset& sub = A.subset();
+      const bool whole = (sub.numSiteTable() == Layout::sitesOnNode());
+
+      // The vector operations of FGMRES run on the whole lattice, so
+      // everything is kept zero off the subset
+      LevelOp<T> Aop = [&A,isign](T& out, const T& in) {
+	out = zero;
+	A(out, in, isign);
+      };
+
+      LevelOp<T> M = [&h,&sub,whole,isign](T& out, const T& in) {
+	T b;
+	if (whole)
+	  b = in;
+	else
+	{
+	  b = zero;
+	  b[sub] = in;
+	}
+
+	if (isign == MINUS)
+	{
+	  T g5b = Gamma(Ns*Ns - 1) * b;
+	  h(b, g5b);
+	  out = Gamma(Ns*Ns - 1) * b;
+	}
+	else
+	  h(out, b);
+
+	if (! whole)
+	{
+	  T t = zero;
+	  t[sub] = out;
+	  out = t;
+	}
+      };
+
+      T x = zero;
+      T b = zero;
+      x[sub] = psi;
+      b[sub] = chi;
+
+      int n_count = fgmres(Aop, &M, x, b, p.NKrylov, p.MaxIter, toDouble(p.RsdTarget), r_norm);
+
+      psi[sub] = x;
+      return n_count;
+    }
+
+  } // namespace AMG
+
+} // namespace Chroma
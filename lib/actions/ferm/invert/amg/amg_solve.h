@@ -0,0 +1,90 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Multigrid preconditioned solves on the whole lattice or on the odd sites
+ */
+
+#ifndef __amg_solve_h__
+#define __amg_solve_h__
+
+#include "chromabase.h"
+#include "handle.h"
+#include "linearop.h"
+#include "eoprec_linop.h"
+#include "actions/ferm/invert/amg/syssolver_amg_params.h"
+#include "actions/ferm/invert/amg/amg_hierarchy.h"
+
+namespace Chroma
+{
+  namespace AMG
+  {
+
+    //! The unpreconditioned operator of an even-odd preconditioned one
+    /*! \ingroup invert */
+    class UnprecAdaptor : public LinearOperator<LatticeFermion>
+    {
+    public:
+      typedef LatticeFermion               T;
+      typedef multi1d<LatticeColorMatrix>  Q;
+
+      //! Keep the preconditioned operator
+      UnprecAdaptor(Handle< LinearOperator<T> > A_, const EvenOddPrecLinearOperator<T,Q,Q>& M_) :
+	A(A_), M(M_) {}
+
+      //! Destructor is automatic
+      ~UnprecAdaptor() {}
+
+      //! The whole lattice
+      const Subset& subset() const {return all;}
+
+      //! Apply the unpreconditioned operator
+      void operator() (T& chi, const T& psi, enum PlusMinus isign) const
+      {
+	M.unprecLinOp(chi, psi, isign);
+      }
+
+    private:
+      Handle< LinearOperator<T> >              A;
+      const EvenOddPrecLinearOperator<T,Q,Q>&  M;
+    };
+
+
+    //! The operator the levels are made from
+    /*!
+     * The operator itself when it acts on the whole lattice. For the
+     * Schur complement on the odd sites of an even-odd preconditioned
+     * operator, its unpreconditioned operator, as the Schur complement
+     * couples sites two hops apart and does not coarsen onto a nearest
+     * neighbour stencil.
+     */
+    Handle< LinearOperator<LatticeFermion> > fineOperator(Handle< LinearOperator<LatticeFermion> > A);
+
+
+    //! Solve  A psi = chi, or  A^dag psi = chi, by FGMRES and the cycles of h
+    /*! \ingroup invert
+     *
+     * On the odd sites, the Schur complement S is preconditioned by the
+     * odd part of the cycle of the whole lattice operator, applied to the
+     * source on the odd sites: that is  S^{-1}  for an exact cycle.
+     * For MINUS the cycle is sandwiched by gamma_5, which is exact for
+     * gamma_5-hermitian operators. FGMRES always runs on A itself, so the
+     * solution is right whatever the preconditioner.
+     *
+     * \param h         the levels ( Read )
+     * \param A         the operator ( Read )
+     * \param psi       solution, starting from the given one ( Modify )
+     * \param chi       source ( Read )
+     * \param isign     A or A^dag ( Read )
+     * \param p         outer FGMRES parameters ( Read )
+     * \param r_norm    the final residuum ( Write )
+     *
+     * \return  the number of iterations
+     */
+    int solve(const Hierarchy& h, const LinearOperator<LatticeFermion>& A,
+	      LatticeFermion& psi, const LatticeFermion& chi, enum PlusMinus isign,
+	      const SysSolverAMGParams& p, double& r_norm);
+
+  } // namespace AMG
+
+} // namespace Chroma
+
+#endif
@@ -0,0 +1,795 @@
+/*! \file
+ *  \brief Aggregation of a level of the multigrid onto the next coarser one
+ */
+
+#include "actions/ferm/invert/amg/amg_transfer.h"
+
+namespace Chroma
+{
+  namespace AMG
+  {
+
+    namespace
+    {
+      //! Parity class of the block a site is in
+      class ParityClassFunc : public SetFunc
+      {
+      public:
+	ParityClassFunc(const multi1d<int>& blk) : block(blk) {}
+
+	int operator() (const multi1d<int>& coordinate) const
+	{
+	  int c = 0;
+	  for(int mu=0; mu < Nd; ++mu)
+	    c |= ((coordinate[mu] / block[mu]) % 2) << mu;
+
+	  return c;
+	}
+
+	int numSubsets() const {return 1 << Nd;}
+
+      private:
+	multi1d<int> block;
+      };
+
+
+      //! Orthonormalise  n  vectors of len components, in place
+      /*! Vectors that vanish stay zero */
+      void gramSchmidt(std::vector< std::vector<Cplx> >& u)
+      {
+	for(int k=0; k < u.size(); ++k)
+	{
+	  for(int j=0; j < k; ++j)
+	  {
+	    Cplx p = 0;
+	    for(int i=0; i < u[k].size(); ++i)
+	      p += std::conj(u[j][i]) * u[k][i];
+	    for(int i=0; i < u[k].size(); ++i)
+	      u[k][i] -= p * u[j][i];
+	  }
+
+	  double n = 0;
+	  for(int i=0; i < u[k].size(); ++i)
+	    n += std::norm(u[k][i]);
+
+	  double inv = (n > 0) ? 1.0/std::sqrt(n) : 0.0;
+	  for(int i=0; i < u[k].size(); ++i)
+	    u[k][i] *= inv;
+	}
+      }
+
+
+#ifndef QDP_IS_QDPJIT
+      //! Arguments of the fine level loops
+      struct FineArgs
+      {
+	REAL* const*       vec;         /*!< the columns of P */
+	int                nc;
+	int                nw;          /*!< complex words of a fine site */
+	int                nvec;
+	const int*         start;
+	const int*         sites;
+	const REAL*        f_in;
+	REAL*              f_out;
+	const Cplx*        c_in;
+	Cplx*              c_out;
+      };
+
+
+      //! Block orthonormalisation of each chirality
+      void orthoBlockLoop(int lo, int hi, int myId, FineArgs* a)
+      {
+	const int nw = a->nw;
+
+	for(int x=lo; x < hi; ++x)
+	{
+	  const int n_sites = a->start[x+1] - a->start[x];
+	  const int* sites = a->sites + a->start[x];
+
+	  for(int chi=0; chi < 2; ++chi)
+	  {
+	    std::vector< std::vector<Cplx> > u(a->nvec, std::vector<Cplx>(n_sites*nw));
+
+	    for(int k=0; k < a->nvec; ++k)
+	    {
+	      const REAL* v = a->vec[chi*a->nvec + k];
+	      for(int s=0; s < n_sites; ++s)
+		for(int i=0; i < nw; ++i)
+		  u[k][s*nw + i] = Cplx(v[2*(sites[s]*nw + i)], v[2*(sites[s]*nw + i)+1]);
+	    }
+
+	    gramSchmidt(u);
+
+	    for(int k=0; k < a->nvec; ++k)
+	    {
+	      REAL* v = a->vec[chi*a->nvec + k];
+	      for(int s=0; s < n_sites; ++s)
+		for(int i=0; i < nw; ++i)
+		{
+		  v[2*(sites[s]*nw + i)]   = u[k][s*nw + i].real();
+		  v[2*(sites[s]*nw + i)+1] = u[k][s*nw + i].imag();
+		}
+	    }
+	  }
+	}
+      }
+
+
+      //! c(x) = P^dag f on the block of x
+      void restrictBlockLoop(int lo, int hi, int myId, FineArgs* a)
+      {
+	const int nw = a->nw;
+	const int nc = a->nc;
+
+	for(int x=lo; x < hi; ++x)
+	{
+	  Cplx* c = a->c_out + x*nc;
+	  for(int i=0; i < nc; ++i)
+	    c[i] = 0;
+
+	  for(int j=a->start[x]; j < a->start[x+1]; ++j)
+	  {
+	    const int site = a->sites[j];
+	    const REAL* f = a->f_in + 2*site*nw;
+
+	    for(int i=0; i < nc; ++i)
+	    {
+	      const REAL* v = a->vec[i] + 2*site*nw;
+	      double re = 0, im = 0;
+	      for(int w=0; w < 2*nw; w += 2)
+	      {
+		re += double(v[w])*double(f[w])   + double(v[w+1])*double(f[w+1]);
+		im += double(v[w])*double(f[w+1]) - double(v[w+1])*double(f[w]);
+	      }
+	      c[i] += Cplx(re, im);
+	    }
+	  }
+	}
+      }
+
+
+      //! f = P c on the block of x
+      void prolongBlockLoop(int lo, int hi, int myId, FineArgs* a)
+      {
+	const int nw = a->nw;
+	const int nc = a->nc;
+
+	for(int x=lo; x < hi; ++x)
+	{
+	  const Cplx* c = a->c_in + x*nc;
+
+	  for(int j=a->start[x]; j < a->start[x+1]; ++j)
+	  {
+	    const int site = a->sites[j];
+	    REAL* f = a->f_out + 2*site*nw;
+
+	    for(int w=0; w < 2*nw; w += 2)
+	    {
+	      double re = 0, im = 0;
+	      for(int i=0; i < nc; ++i)
+	      {
+		const REAL* v = a->vec[i] + 2*site*nw;
+		re += double(v[w])*c[i].real() - double(v[w+1])*c[i].imag();
+		im += double(v[w])*c[i].imag() + double(v[w+1])*c[i].real();
+	      }
+	      f[w]   = re;
+	      f[w+1] = im;
+	    }
+	  }
+	}
+      }
+
+
+      //! Arguments of the probing loop
+      struct ProbeArgs
+      {
+	FineArgs           f;
+	const int*         face_up;
+	const int*         face_dn;
+	const int*         parity;
+	int                cls;       /*!< parity class of the probe */
+	int                col;       /*!< column of the probe */
+	CoarseOperator*    Ac;
+      };
+
+
+      /*! Sort  P^dag A (P e_col on the blocks of class cls)  into the stencil
+       *
+       *  A coarse site of the class gets its diagonal matrix. A site whose
+       *  parities differ from the class in direction mu only has its two
+       *  neighbours in mu in the class, and the parts of the result on
+       *  its upper and lower faces belong to Y_{+mu} and Y_{-mu}.
+       */
+      void probeBlockLoop(int lo, int hi, int myId, ProbeArgs* a)
+      {
+	const int nw = a->f.nw;
+	const int nc = a->f.nc;
+	const int col = a->col;
+
+	for(int x=lo; x < hi; ++x)
+	{
+	  const int diff = a->parity[x] ^ a->cls;
+
+	  int mu = -1;
+	  if (diff != 0)
+	  {
+	    for(int nu=0; nu < Nd; ++nu)
+	      if (diff == (1 << nu))
+		mu = nu;
+
+	    // Not coupled to the probe
+	    if (mu < 0)
+	      continue;
+	  }
+
+	  for(int j=a->f.start[x]; j < a->f.start[x+1]; ++j)
+	  {
+	    const int site = a->f.sites[j];
+
+	    Cplx* M;
+	    if (mu < 0)
+	      M = a->Ac->diag(x);
+	    else if (a->face_up[site] & (1 << mu))
+	      M = a->Ac->hop(x, mu);
+	    else if (a->face_dn[site] & (1 << mu))
+	      M = a->Ac->hop(x, Nd+mu);
+	    else
+	      continue;
+
+	    const REAL* f = a->f.f_in + 2*site*nw;
+
+	    for(int i=0; i < nc; ++i)
+	    {
+	      const REAL* v = a->f.vec[i] + 2*site*nw;
+	      double re = 0, im = 0;
+	      for(int w=0; w < 2*nw; w += 2)
+	      {
+		re += double(v[w])*double(f[w])   + double(v[w+1])*double(f[w+1]);
+		im += double(v[w])*double(f[w+1]) - double(v[w+1])*double(f[w]);
+	      }
+	      M[i*nc + col] += Cplx(re, im);
+	    }
+	  }
+	}
+      }
+#endif
+    }
+
+
+    //--------------------------------------------------------------------------
+    // Constructor
+    FineTransfer::FineTransfer(const multi1d<int>& block_, int nvec_) : block(block_), nvec(nvec_)
+    {
+      START_CODE();
+
+#ifdef QDP_IS_QDPJIT
+      QDPIO::cerr << "AMG: the aggregation multigrid is not available with QDP-JIT" << std::endl;
+      QDP_abort(1);
+#else
+      if (block.size() != Nd || nvec < 1)
+      {
+	QDPIO::cerr << "AMG: need a block extent in each of the " << Nd
+		    << " directions and at least one null vector" << std::endl;
+	QDP_abort(1);
+      }
+
+      const multi1d<int>& latt = Layout::lattSize();
+      for(int mu=0; mu < Nd; ++mu)
+      {
+	int nb = (block[mu] > 0) ? latt[mu] / block[mu] : 0;
+
+	// Probing needs distinct faces and parity classes that do not wrap
+	if (block[mu] < 2 || latt[mu] % block[mu] != 0 || (nb > 1 && nb % 2 != 0))
+	{
+	  QDPIO::cerr << "AMG: blocks of extent " << block[mu] << " in direction " << mu
+		      << " must be at least 2 and give an even number of blocks, or one" << std::endl;
+	  QDP_abort(1);
+	}
+      }
+
+      geom = new CoarseGeometry(latt, Layout::subgridLattSize(), block);
+      class_set.make(ParityClassFunc(block));
+
+      // Fine sites of each coarse site
+      const int vol = geom->volume();
+      const multi1d<int>& L = Layout::subgridLattSize();
+      std::vector< std::vector<int> > sites(vol);
+
+      face_up.resize(Layout::sitesOnNode());
+      face_dn.resize(Layout::sitesOnNode());
+
+      multi1d<int> c(Nd);
+      for(int site=0; site < Layout::sitesOnNode(); ++site)
+      {
+	multi1d<int> coord = Layout::siteCoords(Layout::nodeNumber(), site);
+
+	face_up[site] = 0;
+	face_dn[site] = 0;
+	for(int mu=0; mu < Nd; ++mu)
+	{
+	  c[mu] = (coord[mu] % L[mu]) / block[mu];
+
+	  int b = coord[mu] % block[mu];
+	  if (b == block[mu]-1)
+	    face_up[site] |= 1 << mu;
+	  if (b == 0)
+	    face_dn[site] |= 1 << mu;
+	}
+
+	sites[geom->site(c)].push_back(site);
+      }
+
+      site_start.assign(1, 0);
+      site_list.clear();
+      parity.resize(vol);
+      for(int x=0; x < vol; ++x)
+      {
+	site_list.insert(site_list.end(), sites[x].begin(), sites[x].end());
+	site_start.push_back(site_list.size());
+
+	geom->globalCoords(x, c);
+	parity[x] = 0;
+	for(int mu=0; mu < Nd; ++mu)
+	  parity[x] |= (c[mu] % 2) << mu;
+      }
+
+      vec.resize(2*nvec);
+#endif
+
+      END_CODE();
+    }
+
+
+    // New null vectors
+    void FineTransfer::setVectors(const multi1d<T>& v)
+    {
+      START_CODE();
+
+#ifndef QDP_IS_QDPJIT
+      for(int k=0; k < nvec; ++k)
+      {
+	T g5v = Gamma(Ns*Ns - 1) * v[k];
+	vec[k]      = Real(0.5) * (v[k] + g5v);
+	vec[nvec+k] = Real(0.5) * (v[k] - g5v);
+      }
+
+      std::vector<REAL*> vp(2*nvec);
+      for(int i=0; i < 2*nvec; ++i)
+	vp[i] = (REAL*)&(vec[i].elem(0));
+
+      FineArgs a;
+      a.vec   = &vp[0];
+      a.nc    = 2*nvec;
+      a.nw    = sizeof(vec[0].elem(0)) / (2*sizeof(REAL));
+      a.nvec  = nvec;
+      a.start = &site_start[0];
+      a.sites = &site_list[0];
+
+      dispatch_to_threads(geom->volume(), a, orthoBlockLoop);
+#endif
+
+      END_CODE();
+    }
+
+
+    // c = P^dag f
+    void FineTransfer::restrictTo(CoarseVector& c, const T& f) const
+    {
+#ifndef QDP_IS_QDPJIT
+      if (c.nc != 2*nvec || c.data.size() != geom->volume()*2*nvec)
+	c = CoarseVector(*geom, 2*nvec);
+
+      std::vector<REAL*> vp(2*nvec);
+      for(int i=0; i < 2*nvec; ++i)
+	vp[i] = (REAL*)&(vec[i].elem(0));
+
+      FineArgs a;
+      a.vec   = &vp[0];
+      a.nc    = 2*nvec;
+      a.nw    = sizeof(f.elem(0)) / (2*sizeof(REAL));
+      a.start = &site_start[0];
+      a.sites = &site_list[0];
+      a.f_in  = (const REAL*)&(f.elem(0));
+      a.c_out = &c.data[0];
+
+      dispatch_to_threads(geom->volume(), a, restrictBlockLoop);
+#endif
+    }
+
+
+    // f = P c
+    void FineTransfer::prolong(T& f, const CoarseVector& c) const
+    {
+#ifndef QDP_IS_QDPJIT
+      std::vector<REAL*> vp(2*nvec);
+      for(int i=0; i < 2*nvec; ++i)
+	vp[i] = (REAL*)&(vec[i].elem(0));
+
+      FineArgs a;
+      a.vec   = &vp[0];
+      a.nc    = 2*nvec;
+      a.nw    = sizeof(f.elem(0)) / (2*sizeof(REAL));
+      a.start = &site_start[0];
+      a.sites = &site_list[0];
+      a.f_out = (REAL*)&(f.elem(0));
+      a.c_in  = &c.data[0];
+
+      dispatch_to_threads(geom->volume(), a, prolongBlockLoop);
+#endif
+    }
+
+
+    /*! Galerkin product by probing
+     *
+     *  For each parity class of blocks and each column of P, A is applied
+     *  to that column restricted to the blocks of the class. That is
+     *  2^Nd * 2 nvec applications of A.
+     */
+    void FineTransfer::coarsen(const LinearOperator<T>& A, CoarseOperator& Ac) const
+    {
+      START_CODE();
+
+#ifndef QDP_IS_QDPJIT
+      StopWatch swatch;
+      swatch.reset();
+      swatch.start();
+
+      Ac.setZero();
+
+      std::vector<REAL*> vp(2*nvec);
+      for(int i=0; i < 2*nvec; ++i)
+	vp[i] = (REAL*)&(vec[i].elem(0));
+
+      T probe, out;
+
+      ProbeArgs a;
+      a.f.vec   = &vp[0];
+      a.f.nc    = 2*nvec;
+      a.f.nw    = sizeof(out.elem(0)) / (2*sizeof(REAL));
+      a.f.start = &site_start[0];
+      a.f.sites = &site_list[0];
+      a.f.f_in  = (const REAL*)&(out.elem(0));
+      a.face_up = &face_up[0];
+      a.face_dn = &face_dn[0];
+      a.parity  = &parity[0];
+      a.Ac      = &Ac;
+
+      int n_apply = 0;
+      for(int cls=0; cls < class_set.numSubsets(); ++cls)
+      {
+	// Classes are empty along directions with a single block
+	double n_sites = class_set[cls].numSiteTable();
+	QDPInternal::globalSum(n_sites);
+	if (n_sites == 0)
+	  continue;
+
+	a.cls = cls;
+	for(int col=0; col < 2*nvec; ++col)
+	{
+	  probe = zero;
+	  probe[class_set[cls]] = vec[col];
+	  A(out, probe, PLUS);
+	  ++n_apply;
+
+	  a.col = col;
+	  dispatch_to_threads(geom->volume(), a, probeBlockLoop);
+	}
+      }
+
+      swatch.stop();
+      QDPIO::cout << "AMG: coarse operator from " << n_apply << " probes in "
+		  << swatch.getTimeInSeconds() << " sec" << std::endl;
+#endif
+
+      END_CODE();
+    }
+
+
+    //--------------------------------------------------------------------------
+    namespace
+    {
+      //! Arguments of the coarse level loops
+      struct CoarseArgs
+      {
+	const Cplx* const*  vec;       /*!< the columns of P */
+	const Cplx* const*  halo;      /*!< their halos */
+	int                 fine_nc;
+	int                 nc;
+	int                 fine_vol;
+	const int*          start;
+	const int*          sites;
+	const int*          block;
+	const Cplx*         in;
+	Cplx*               out;
+	const CoarseOperator* A;
+	CoarseOperator*     Ac;
+      };
+
+      //! c(X) = P^dag f on the block X
+      void restrictCoarseLoop(int lo, int hi, int myId, CoarseArgs* a)
+      {
+	const int fnc = a->fine_nc;
+	const int nc  = a->nc;
+
+	for(int X=lo; X < hi; ++X)
+	{
+	  Cplx* c = a->out + X*nc;
+	  for(int i=0; i < nc; ++i)
+	    c[i] = 0;
+
+	  for(int j=a->start[X]; j < a->start[X+1]; ++j)
+	  {
+	    const int x = a->sites[j];
+	    const Cplx* f = a->in + x*fnc;
+
+	    for(int i=0; i < nc; ++i)
+	    {
+	      const Cplx* v = a->vec[i] + x*fnc;
+	      Cplx s = 0;
+	      for(int b=0; b < fnc; ++b)
+		s += std::conj(v[b]) * f[b];
+	      c[i] += s;
+	    }
+	  }
+	}
+      }
+
+      //! f = P c on the block X
+      void prolongCoarseLoop(int lo, int hi, int myId, CoarseArgs* a)
+      {
+	const int fnc = a->fine_nc;
+	const int nc  = a->nc;
+
+	for(int X=lo; X < hi; ++X)
+	{
+	  const Cplx* c = a->in + X*nc;
+
+	  for(int j=a->start[X]; j < a->start[X+1]; ++j)
+	  {
+	    const int x = a->sites[j];
+	    Cplx* f = a->out + x*fnc;
+
+	    for(int b=0; b < fnc; ++b)
+	      f[b] = 0;
+	    for(int i=0; i < nc; ++i)
+	    {
+	      const Cplx* v = a->vec[i] + x*fnc;
+	      for(int b=0; b < fnc; ++b)
+		f[b] += v[b] * c[i];
+	    }
+	  }
+	}
+      }
+
+      /*! Galerkin product on the block X
+       *
+       *  Every coupling  M  from x in X to its neighbour n adds
+       *  P(x)^dag M P(n)  to the diagonal of X if n is in X, and to the
+       *  hopping matrix of that direction otherwise.
+       */
+      void coarsenCoarseLoop(int lo, int hi, int myId, CoarseArgs* a)
+      {
+	const int fnc = a->fine_nc;
+	const int nc  = a->nc;
+	const CoarseGeometry& g = a->A->geometry();
+
+	std::vector<Cplx> T(fnc*nc);
+
+	for(int X=lo; X < hi; ++X)
+	{
+	  for(int j=a->start[X]; j < a->start[X+1]; ++j)
+	  {
+	    const int x = a->sites[j];
+
+	    for(int dir=-1; dir < 2*Nd; ++dir)
+	    {
+	      const int n = (dir < 0) ? x : g.neighbour(x, dir);
+	      const Cplx* M = (dir < 0) ? a->A->diag(x) : a->A->hop(x, dir);
+
+	      // T = M P(n)
+	      for(int b=0; b < fnc; ++b)
+		for(int k=0; k < nc; ++k)
+		{
+		  const Cplx* p = (n < a->fine_vol) ? a->vec[k] + n*fnc : a->halo[k] + (n - a->fine_vol)*fnc;
+		  Cplx s = 0;
+		  for(int e=0; e < fnc; ++e)
+		    s += M[b*fnc + e] * p[e];
+		  T[b*nc + k] = s;
+		}
+
+	      bool inside = (n < a->fine_vol) && (a->block[n] == X);
+	      Cplx* R = inside ? a->Ac->diag(X) : a->Ac->hop(X, dir);
+
+	      // R += P(x)^dag T
+	      for(int i=0; i < nc; ++i)
+	      {
+		const Cplx* v = a->vec[i] + x*fnc;
+		for(int k=0; k < nc; ++k)
+		{
+		  Cplx s = 0;
+		  for(int b=0; b < fnc; ++b)
+		    s += std::conj(v[b]) * T[b*nc + k];
+		  R[i*nc + k] += s;
+		}
+	      }
+	    }
+	  }
+	}
+      }
+    }
+
+
+    // Constructor
+    CoarseTransfer::CoarseTransfer(Handle<CoarseGeometry> fine_geom_, int fine_nc_,
+				   const multi1d<int>& block, int nvec_) :
+      fine_geom(fine_geom_), fine_nc(fine_nc_), nvec(nvec_)
+    {
+      START_CODE();
+
+      if (block.size() != Nd || nvec < 1)
+      {
+	QDPIO::cerr << "AMG: need a block extent in each of the " << Nd
+		    << " directions and at least one null vector" << std::endl;
+	QDP_abort(1);
+      }
+
+      geom = new CoarseGeometry(fine_geom->lattSize(), fine_geom->subgridLattSize(), block);
+
+      const int vol = geom->volume();
+      std::vector< std::vector<int> > sites(vol);
+
+      site_block.resize(fine_geom->volume());
+
+      multi1d<int> c(Nd);
+      for(int x=0; x < fine_geom->volume(); ++x)
+      {
+	fine_geom->coords(x, c);
+	for(int mu=0; mu < Nd; ++mu)
+	  c[mu] /= block[mu];
+
+	site_block[x] = geom->site(c);
+	sites[site_block[x]].push_back(x);
+      }
+
+      site_start.assign(1, 0);
+      site_list.clear();
+      for(int X=0; X < vol; ++X)
+      {
+	site_list.insert(site_list.end(), sites[X].begin(), sites[X].end());
+	site_start.push_back(site_list.size());
+      }
+
+      END_CODE();
+    }
+
+
+    // New null vectors
+    void CoarseTransfer::setVectors(const std::vector<CoarseVector>& v)
+    {
+      START_CODE();
+
+      const int half = fine_nc / 2;
+
+      // Project onto the chiralities
+      vec.resize(2*nvec);
+      for(int chi=0; chi < 2; ++chi)
+	for(int k=0; k < nvec; ++k)
+	{
+	  CoarseVector& u = vec[chi*nvec + k];
+	  u = v[k];
+	  for(int x=0; x < fine_geom->volume(); ++x)
+	    for(int b=0; b < fine_nc; ++b)
+	      if ((b < half) != (chi == 0))
+		u.site(x)[b] = 0;
+	}
+
+      // Orthonormalise on each block
+      for(int X=0; X < geom->volume(); ++X)
+      {
+	const int n_sites = site_start[X+1] - site_start[X];
+
+	for(int chi=0; chi < 2; ++chi)
+	{
+	  std::vector< std::vector<Cplx> > u(nvec, std::vector<Cplx>(n_sites*fine_nc));
+
+	  for(int k=0; k < nvec; ++k)
+	    for(int s=0; s < n_sites; ++s)
+	      for(int b=0; b < fine_nc; ++b)
+		u[k][s*fine_nc + b] = vec[chi*nvec + k].site(site_list[site_start[X] + s])[b];
+
+	  gramSchmidt(u);
+
+	  for(int k=0; k < nvec; ++k)
+	    for(int s=0; s < n_sites; ++s)
+	      for(int b=0; b < fine_nc; ++b)
+		vec[chi*nvec + k].site(site_list[site_start[X] + s])[b] = u[k][s*fine_nc + b];
+	}
+      }
+
+      END_CODE();
+    }
+
+
+    // c = P^dag f
+    void CoarseTransfer::restrictTo(CoarseVector& c, const CoarseVector& f) const
+    {
+      if (c.nc != 2*nvec || c.data.size() != geom->volume()*2*nvec)
+	c = CoarseVector(*geom, 2*nvec);
+
+      std::vector<const Cplx*> vp(2*nvec);
+      for(int i=0; i < 2*nvec; ++i)
+	vp[i] = &vec[i].data[0];
+
+      CoarseArgs a;
+      a.vec     = &vp[0];
+      a.fine_nc = fine_nc;
+      a.nc      = 2*nvec;
+      a.start   = &site_start[0];
+      a.sites   = &site_list[0];
+      a.in      = &f.data[0];
+      a.out     = &c.data[0];
+
+      dispatch_to_threads(geom->volume(), a, restrictCoarseLoop);
+    }
+
+
+    // f = P c
+    void CoarseTransfer::prolong(CoarseVector& f, const CoarseVector& c) const
+    {
+      if (f.nc != fine_nc || f.data.size() != fine_geom->volume()*fine_nc)
+	f = CoarseVector(*fine_geom, fine_nc);
+
+      std::vector<const Cplx*> vp(2*nvec);
+      for(int i=0; i < 2*nvec; ++i)
+	vp[i] = &vec[i].data[0];
+
+      CoarseArgs a;
+      a.vec     = &vp[0];
+      a.fine_nc = fine_nc;
+      a.nc      = 2*nvec;
+      a.start   = &site_start[0];
+      a.sites   = &site_list[0];
+      a.in      = &c.data[0];
+      a.out     = &f.data[0];
+
+      dispatch_to_threads(geom->volume(), a, prolongCoarseLoop);
+    }
+
+
+    // Ac = P^dag A P
+    void CoarseTransfer::coarsen(const CoarseOperator& A, CoarseOperator& Ac) const
+    {
+      START_CODE();
+
+      Ac.setZero();
+
+      // The columns of P on the neighbouring nodes
+      std::vector< std::vector<Cplx> > halo(2*nvec);
+      std::vector<const Cplx*> vp(2*nvec), hp(2*nvec);
+      for(int i=0; i < 2*nvec; ++i)
+      {
+	fine_geom->exchange(vec[i].data, fine_nc, halo[i]);
+	vp[i] = &vec[i].data[0];
+	hp[i] = halo[i].size() > 0 ? &halo[i][0] : 0;
+      }
+
+      CoarseArgs a;
+      a.vec      = &vp[0];
+      a.halo     = &hp[0];
+      a.fine_nc  = fine_nc;
+      a.nc       = 2*nvec;
+      a.fine_vol = fine_geom->volume();
+      a.start    = &site_start[0];
+      a.sites    = &site_list[0];
+      a.block    = &site_block[0];
+      a.A        = &A;
+      a.Ac       = &Ac;
+
+      dispatch_to_threads(geom->volume(), a, coarsenCoarseLoop);
+
+      END_CODE();
+    }
+
+  } // namespace AMG
+
+} // namespace Chroma
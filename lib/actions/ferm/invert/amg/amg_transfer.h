@@ -0,0 +1,139 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Aggregation of a level of the multigrid onto the next coarser one
+ */
+
+#ifndef __amg_transfer_h__
+#define __amg_transfer_h__
+
+#include "chromabase.h"
+#include "handle.h"
+#include "linearop.h"
+#include "actions/ferm/invert/amg/amg_coarse.h"
+
+#include <vector>
+
+namespace Chroma
+{
+  namespace AMG
+  {
+
+    //! Aggregation of the fine lattice fermions
+    /*! \ingroup invert
+     *
+     * An aggregate is a BlockFunc block of the lattice and one chirality.
+     * Its prolongator columns are the near null vectors, projected with
+     * (1 +- gamma_5)/2 and orthonormalised on the block, so a coarse site
+     * has 2 * nvec components and the coarse operator keeps the
+     * gamma_5-hermiticity of the fine one.
+     *
+     * The coarse operator is the Galerkin product  P^dag A P. It is found
+     * by probing A with the columns of P put on all blocks of one parity
+     * class (the parities of the block coordinates), which needs A to be
+     * a nearest neighbour operator on the whole lattice, as the
+     * unpreconditioned Wilson and clover operators are.
+     */
+    class FineTransfer
+    {
+    public:
+      typedef LatticeFermion T;
+
+      //! Constructor
+      /*!
+       * \param block   block extents ( Read )
+       * \param nvec    number of near null vectors ( Read )
+       */
+      FineTransfer(const multi1d<int>& block, int nvec);
+
+      //! Take new near null vectors
+      void setVectors(const multi1d<T>& v);
+
+      //! c = P^dag f
+      void restrictTo(CoarseVector& c, const T& f) const;
+
+      //! f = P c
+      void prolong(T& f, const CoarseVector& c) const;
+
+      //! Ac = P^dag A P
+      void coarsen(const LinearOperator<T>& A, CoarseOperator& Ac) const;
+
+      //! The coarse lattice
+      Handle<CoarseGeometry> coarseGeometry() const {return geom;}
+
+      //! Components of a coarse site
+      int numCoarseColours() const {return 2*nvec;}
+
+    private:
+      multi1d<int>            block;
+      int                     nvec;
+      Handle<CoarseGeometry>  geom;
+
+      multi1d<T>              vec;         /*!< columns of P */
+
+      // Fine sites of coarse site x: site_list[site_start[x] .. site_start[x+1]-1]
+      std::vector<int>        site_start;
+      std::vector<int>        site_list;
+      std::vector<int>        face_up;     /*!< bit mu set on the upper face of the block in mu */
+      std::vector<int>        face_dn;     /*!< bit mu set on the lower face of the block in mu */
+      std::vector<int>        parity;      /*!< parities of the block coordinates of coarse site x */
+
+      Set                     class_set;   /*!< blocks by parity class */
+    };
+
+
+    //! Aggregation of a coarse level onto a coarser one
+    /*! \ingroup invert
+     *
+     * As FineTransfer, with the chirality of a coarse component given by
+     * the half of the site it is in. The Galerkin product is formed from
+     * the stencil matrices directly.
+     */
+    class CoarseTransfer
+    {
+    public:
+      //! Constructor
+      /*!
+       * \param fine_geom  lattice of the finer level ( Read )
+       * \param fine_nc    components of a site of the finer level ( Read )
+       * \param block      block extents, in sites of the finer level ( Read )
+       * \param nvec       number of near null vectors ( Read )
+       */
+      CoarseTransfer(Handle<CoarseGeometry> fine_geom, int fine_nc,
+		     const multi1d<int>& block, int nvec);
+
+      //! Take new near null vectors
+      void setVectors(const std::vector<CoarseVector>& v);
+
+      //! c = P^dag f
+      void restrictTo(CoarseVector& c, const CoarseVector& f) const;
+
+      //! f = P c
+      void prolong(CoarseVector& f, const CoarseVector& c) const;
+
+      //! Ac = P^dag A P
+      void coarsen(const CoarseOperator& A, CoarseOperator& Ac) const;
+
+      //! The coarser lattice
+      Handle<CoarseGeometry> coarseGeometry() const {return geom;}
+
+      //! Components of a site of the coarser level
+      int numCoarseColours() const {return 2*nvec;}
+
+    private:
+      Handle<CoarseGeometry>  fine_geom;
+      int                     fine_nc;
+      int                     nvec;
+      Handle<CoarseGeometry>  geom;
+
+      std::vector<CoarseVector>  vec;      /*!< columns of P */
+
+      std::vector<int>        site_start;
+      std::vector<int>        site_list;
+      std::vector<int>        site_block;  /*!< coarser site of each finer site */
+    };
+
+  } // namespace AMG
+
+} // namespace Chroma
+
+#endif
@@ -0,0 +1,141 @@
+/*! \file
+ *  \brief Params of the aggregation multigrid solver
+ */
+#include <string>
+#include "actions/ferm/invert/amg/syssolver_amg_params.h"
+
+namespace Chroma
+{
+
+  namespace
+  {
+    //! Read a per level entry, a single element is used for all levels
+    template<typename T>
+    void readLevels(XMLReader& xml, const std::string& path, multi1d<T>& result, int n)
+    {
+      multi1d<T> in;
+      read(xml, path, in);
+
+      if (in.size() != 1 && in.size() != n)
+      {
+	QDPIO::cerr << "AMG: " << path << " needs 1 or " << n << " elements" << std::endl;
+	QDP_abort(1);
+      }
+
+      result.resize(n);
+      for(int i=0; i < n; ++i)
+	result[i] = in[(in.size() == 1) ? 0 : i];
+    }
+  }
+
+
+  // Read parameters
+  void read(XMLReader& xml, const std::string& path, SysSolverAMGParams& p)
+  {
+    XMLReader paramtop(xml, path);
+
+    read(paramtop, "RsdTarget",  p.RsdTarget);
+    read(paramtop, "MaxIter",    p.MaxIter);
+    read(paramtop, "NKrylov",    p.NKrylov);
+    read(paramtop, "MGLevels",   p.MGLevels);
+    read(paramtop, "SubspaceId", p.SubspaceId);
+
+    if (p.MGLevels < 2)
+    {
+      QDPIO::cerr << "AMG: MGLevels must be at least 2" << std::endl;
+      QDP_abort(1);
+    }
+
+    readLevels(paramtop, "Blocking",  p.Blocking,  p.MGLevels-1);
+    readLevels(paramtop, "NullVecs",  p.NullVecs,  p.MGLevels-1);
+    readLevels(paramtop, "NullIters", p.NullIters, p.MGLevels-1);
+
+    if (paramtop.count("SetupCycles") == 1)
+      read(paramtop, "SetupCycles", p.SetupCycles);
+
+    if (paramtop.count("RefreshCycles") == 1)
+      read(paramtop, "RefreshCycles", p.RefreshCycles);
+
+    if (paramtop.count("Cycle") == 1)
+      read(paramtop, "Cycle", p.Cycle);
+
+    if (p.Cycle != "V" && p.Cycle != "K")
+    {
+      QDPIO::cerr << "AMG: unknown Cycle " << p.Cycle << ", use V or K" << std::endl;
+      QDP_abort(1);
+    }
+
+    if (paramtop.count("PreSmooth") == 1)
+      read(paramtop, "PreSmooth", p.PreSmooth);
+
+    if (paramtop.count("PostSmooth") == 1)
+      read(paramtop, "PostSmooth", p.PostSmooth);
+
+    if (paramtop.count("KCycleIters") == 1)
+      read(paramtop, "KCycleIters", p.KCycleIters);
+
+    if (paramtop.count("KCycleRsd") == 1)
+      read(paramtop, "KCycleRsd", p.KCycleRsd);
+
+    if (paramtop.count("CoarsestNKrylov") == 1)
+      read(paramtop, "CoarsestNKrylov", p.CoarsestNKrylov);
+
+    if (paramtop.count("CoarsestMaxIter") == 1)
+      read(paramtop, "CoarsestMaxIter", p.CoarsestMaxIter);
+
+    if (paramtop.count("CoarsestRsd") == 1)
+      read(paramtop, "CoarsestRsd", p.CoarsestRsd);
+  }
+
+  // Writer parameters
+  void write(XMLWriter& xml, const std::string& path, const SysSolverAMGParams& p)
+  {
+    push(xml, path);
+    write(xml, "invType",         "AMG_INVERTER");
+    write(xml, "RsdTarget",       p.RsdTarget);
+    write(xml, "MaxIter",         p.MaxIter);
+    write(xml, "NKrylov",         p.NKrylov);
+    write(xml, "MGLevels",        p.MGLevels);
+    write(xml, "Blocking",        p.Blocking);
+    write(xml, "NullVecs",        p.NullVecs);
+    write(xml, "NullIters",       p.NullIters);
+    write(xml, "SetupCycles",     p.SetupCycles);
+    write(xml, "RefreshCycles",   p.RefreshCycles);
+    write(xml, "Cycle",           p.Cycle);
+    write(xml, "PreSmooth",       p.PreSmooth);
+    write(xml, "PostSmooth",      p.PostSmooth);
+    write(xml, "KCycleIters",     p.KCycleIters);
+    write(xml, "KCycleRsd",       p.KCycleRsd);
+    write(xml, "CoarsestNKrylov", p.CoarsestNKrylov);
+    write(xml, "CoarsestMaxIter", p.CoarsestMaxIter);
+    write(xml, "CoarsestRsd",     p.CoarsestRsd);
+    write(xml, "SubspaceId",      p.SubspaceId);
+    pop(xml);
+  }
+
+  //! Default constructor
+  SysSolverAMGParams::SysSolverAMGParams()
+  {
+    RsdTarget = 0;
+    MaxIter = 0;
+    NKrylov = 0;
+    MGLevels = 2;
+    SetupCycles = 1;
+    RefreshCycles = 1;
+    Cycle = "K";
+    PreSmooth = 0;
+    PostSmooth = 4;
+    KCycleIters = 2;
+    KCycleRsd = 0.1;
+    CoarsestNKrylov = 24;
+    CoarsestMaxIter = 100;
+    CoarsestRsd = 0.1;
+  }
+
+  //! Read parameters
+  SysSolverAMGParams::SysSolverAMGParams(XMLReader& xml, const std::string& path) : SysSolverAMGParams()
+  {
+    read(xml, path, *this);
+  }
+
+}
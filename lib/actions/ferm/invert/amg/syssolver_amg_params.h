@@ -0,0 +1,64 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Params of the aggregation multigrid solver
+ */
+
+#ifndef __syssolver_amg_params_h__
+#define __syssolver_amg_params_h__
+
+#include "chromabase.h"
+
+#include <string>
+
+namespace Chroma
+{
+
+  //! Params for the aggregation multigrid inverter
+  /*! \ingroup invert
+   *
+   * Per level entries have MGLevels-1 elements, one for each coarsening,
+   * or a single element used for all of them.
+   */
+  struct SysSolverAMGParams
+  {
+    SysSolverAMGParams();
+    SysSolverAMGParams(XMLReader& in, const std::string& path);
+
+    // Outer FGMRES
+    Real          RsdTarget;           /*!< Target Residuum */
+    int           MaxIter;             /*!< Total Number of Iterations */
+    int           NKrylov;             /*!< Iterations between restarts */
+
+    // Hierarchy
+    int                       MGLevels;   /*!< Number of levels, including the fine one */
+    multi1d< multi1d<int> >   Blocking;   /*!< Block extents of each coarsening */
+    multi1d<int>              NullVecs;   /*!< Near null vectors of each coarsening */
+    multi1d<int>              NullIters;  /*!< MR steps on A x = 0 for the first vectors */
+    int                       SetupCycles;   /*!< Passes improving the vectors with the cycle */
+    int                       RefreshCycles; /*!< Passes on a new operator, 0 for a new setup */
+
+    // Cycle
+    std::string   Cycle;               /*!< "V" or "K" */
+    int           PreSmooth;           /*!< MR steps before the coarse correction */
+    int           PostSmooth;          /*!< MR steps after it */
+    int           KCycleIters;         /*!< FGMRES steps of a K-cycle level */
+    Real          KCycleRsd;           /*!< Relative residuum of a K-cycle level */
+    int           CoarsestNKrylov;     /*!< GMRES restart length on the coarsest level */
+    int           CoarsestMaxIter;     /*!< GMRES iterations on the coarsest level */
+    Real          CoarsestRsd;         /*!< Relative residuum on the coarsest level */
+
+    std::string   SubspaceId;          /*!< Named object holding the setup */
+  };
+
+
+  // Reader/writers
+  /*! \ingroup invert */
+  void read(XMLReader& xml, const std::string& path, SysSolverAMGParams& param);
+
+  /*! \ingroup invert */
+  void write(XMLWriter& xml, const std::string& path, const SysSolverAMGParams& param);
+
+} // End namespace
+
+#endif 
+
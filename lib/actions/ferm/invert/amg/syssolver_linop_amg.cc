@@ -0,0 +1,85 @@
+/*! \file
+ *  \brief Solve a M*psi=chi linear system by adaptive aggregation multigrid
+ */
+#include "chromabase.h"
+#include "actions/ferm/invert/syssolver_linop_factory.h"
+#include "actions/ferm/invert/syssolver_linop_aggregate.h"
+
+#include "actions/ferm/invert/amg/syssolver_linop_amg.h"
+#include "actions/ferm/invert/amg/amg_solve.h"
+
+namespace Chroma
+{
+
+  //! AMG system solver namespace
+  namespace LinOpSysSolverAMGEnv
+  {
+    //! Callback function
+    LinOpSystemSolver<LatticeFermion>* createFerm(XMLReader& xml_in,
+						  const std::string& path,
+						  Handle< FermState< LatticeFermion, multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> > > state,
+						  Handle< LinearOperator<LatticeFermion> > A)
+    {
+      return new LinOpSysSolverAMG(A, state, SysSolverAMGParams(xml_in, path));
+    }
+
+
+    //! Name to be used
+    const std::string name("AMG_INVERTER");
+
+    //! Local registration flag
+    static bool registered = false;
+
+    //! Register all the factories
+    bool registerAll()
+    {
+      bool success = true;
+      if (! registered)
+      {
+	success &= Chroma::TheLinOpFermSystemSolverFactory::Instance().registerObject(name, createFerm);
+	registered = true;
+      }
+      return success;
+    }
+  }
+
+
+  // Solve the linear system  A psi = chi  with FGMRES and the multigrid cycle
+  SystemSolverResults_t
+  LinOpSysSolverAMG::operator() (T& psi, const T& chi) const
+  {
+    START_CODE();
+    SystemSolverResults_t res; // Value to return
+
+    StopWatch swatch;
+    swatch.reset();
+    swatch.start();
+
+    Handle< LinearOperator<T> > A_fine = AMG::fineOperator(A_);
+    std::shared_ptr<AMG::Hierarchy> h = AMG::getHierarchy(invParam_.SubspaceId);
+    if (! h)
+      h = AMG::createHierarchy(invParam_, A_fine);
+    else
+      h->update(A_fine);
+
+    swatch.stop();
+    double setup_time = swatch.getTimeInSeconds();
+    swatch.reset();
+    swatch.start();
+
+    double r_norm;
+    res.n_count = AMG::solve(*h, *A_, psi, chi, PLUS, invParam_, r_norm);
+    res.resid = r_norm;
+
+    swatch.stop();
+
+    Double norm_rhs = sqrt(norm2(chi, A_->subset()));
+    QDPIO::cout << "AMG_INVERTER: Done. Iters=" << res.n_count
+		<< " || r ||/|| b ||=" << res.resid / norm_rhs << " Target=" << invParam_.RsdTarget << std::endl;
+    QDPIO::cout << "AMG_INVERTER_TIME: setup " << setup_time << " sec, solve " << swatch.getTimeInSeconds() << " sec" << std::endl;
+
+    END_CODE();
+    return res;
+  }
+
+}
@@ -0,0 +1,83 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Solve a M*psi=chi linear system by adaptive aggregation multigrid
+ */
+
+#ifndef __syssolver_linop_amg_h__
+#define __syssolver_linop_amg_h__
+
+#include "chroma_config.h"
+#include "handle.h"
+#include "state.h"
+#include "syssolver.h"
+#include "linearop.h"
+
+#include "actions/ferm/invert/syssolver_linop.h"
+#include "actions/ferm/invert/syssolver_linop_factory.h"
+#include "actions/ferm/invert/amg/syssolver_amg_params.h"
+#include "actions/ferm/invert/amg/amg_hierarchy.h"
+
+namespace Chroma
+{
+
+  //! AMG system solver namespace
+  namespace LinOpSysSolverAMGEnv
+  {
+    //! Register the syssolver
+    bool registerAll();
+  }
+
+
+  //! Solve a M*psi=chi linear system by adaptive aggregation multigrid
+  /*! \ingroup invert
+   *
+   * Flexible GMRES, preconditioned by one cycle of an AMG::Hierarchy.
+   * The setup is held as a named object under SubspaceId and reused by
+   * later solves. If the operator has changed since, as between HMC
+   * trajectories, the setup is refreshed rather than redone.
+   *
+   * Meant for the Wilson and clover operators, unpreconditioned or
+   * even-odd preconditioned. The levels are always made from the
+   * unpreconditioned operator, see AMG::fineOperator.
+   */
+  class LinOpSysSolverAMG : public LinOpSystemSolver<LatticeFermion>
+  {
+  public:
+    using T = LatticeFermion;
+    using U = LatticeColorMatrix;
+    using Q = multi1d<U>;
+
+    //! Constructor
+    /*!
+     * \param A_        Linear operator ( Read )
+     * \param invParam  inverter parameters ( Read )
+     */
+    LinOpSysSolverAMG(Handle< LinearOperator<T> > A,
+		      Handle< FermState<T,Q,Q> > state,
+		      const SysSolverAMGParams& invParam) :
+      A_(A), state_(state), invParam_(invParam) {}
+
+    //! Destructor is automatic
+    ~LinOpSysSolverAMG() {}
+
+    //! Return the subset on which the operator acts
+    const Subset& subset() const {return A_->subset();}
+
+    //! Solver the linear system
+    /*!
+     * \param psi      solution ( Modify )
+     * \param chi      source ( Read )
+     * \return syssolver results
+     */
+    SystemSolverResults_t operator() (T& psi, const T& chi) const;
+
+  private:
+    Handle< LinearOperator<T> > A_;
+    Handle< FermState<T,Q,Q> > state_;
+    SysSolverAMGParams invParam_;
+  };
+
+} // End namespace
+
+#endif
+
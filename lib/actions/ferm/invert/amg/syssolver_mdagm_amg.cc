@@ -0,0 +1,119 @@
+/*! \file
+ *  \brief Solve a MdagM*psi=chi linear system by adaptive aggregation multigrid
+ */
+#include "chromabase.h"
+#include "actions/ferm/invert/syssolver_mdagm_factory.h"
+#include "actions/ferm/invert/syssolver_mdagm_aggregate.h"
+
+#include "actions/ferm/invert/amg/syssolver_mdagm_amg.h"
+#include "actions/ferm/invert/amg/amg_solve.h"
+#include "lmdagm.h"
+
+namespace Chroma
+{
+
+  //! AMG system solver namespace
+  namespace MdagMSysSolverAMGEnv
+  {
+    //! Callback function
+    MdagMSystemSolver<LatticeFermion>* createFerm(XMLReader& xml_in,
+						  const std::string& path,
+						  Handle< FermState< LatticeFermion, multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> > > state,
+						  Handle< LinearOperator<LatticeFermion> > A)
+    {
+      return new MdagMSysSolverAMG(A, state, SysSolverAMGParams(xml_in, path));
+    }
+
+
+    //! Name to be used
+    const std::string name("AMG_INVERTER");
+
+    //! Local registration flag
+    static bool registered = false;
+
+    //! Register all the factories
+    bool registerAll()
+    {
+      bool success = true;
+      if (! registered)
+      {
+	success &= Chroma::TheMdagMFermSystemSolverFactory::Instance().registerObject(name, createFerm);
+	registered = true;
+      }
+      return success;
+    }
+  }
+
+
+  // Solve  M^dag M psi = chi  as  M^dag y = chi,  M psi = y
+  SystemSolverResults_t
+  MdagMSysSolverAMG::operator() (T& psi, const T& chi) const
+  {
+    START_CODE();
+    SystemSolverResults_t res; // Value to return
+
+    StopWatch swatch;
+    swatch.reset();
+    swatch.start();
+
+    Handle< LinearOperator<T> > A_fine = AMG::fineOperator(A_);
+    std::shared_ptr<AMG::Hierarchy> h = AMG::getHierarchy(invParam_.SubspaceId);
+    if (! h)
+      h = AMG::createHierarchy(invParam_, A_fine);
+    else
+      h->update(A_fine);
+
+    swatch.stop();
+    double setup_time = swatch.getTimeInSeconds();
+    swatch.reset();
+    swatch.start();
+
+    // Start from  y = M psi
+    T y = zero;
+    (*A_)(y, psi, PLUS);
+
+    double r_norm;
+    res.n_count  = AMG::solve(*h, *A_, y, chi, MINUS, invParam_, r_norm);
+    res.n_count += AMG::solve(*h, *A_, psi, y, PLUS, invParam_, r_norm);
+
+    // The true residuum
+    {
+      const Subset& sub = A_->subset();
+      T r = zero;
+      MdagMLinOp<T> MdagM(A_);
+      MdagM(r, psi, PLUS);
+      r[sub] -= chi;
+      res.resid = sqrt(norm2(r, sub));
+    }
+
+    swatch.stop();
+
+    Double norm_rhs = sqrt(norm2(chi, A_->subset()));
+    QDPIO::cout << "AMG_INVERTER: Done. Iters=" << res.n_count
+		<< " || r ||/|| b ||=" << res.resid / norm_rhs << " Target=" << invParam_.RsdTarget << std::endl;
+    QDPIO::cout << "AMG_INVERTER_TIME: setup " << setup_time << " sec, solve " << swatch.getTimeInSeconds() << " sec" << std::endl;
+
+    END_CODE();
+    return res;
+  }
+
+
+  // Predict the start, then solve
+  SystemSolverResults_t
+  MdagMSysSolverAMG::operator() (T& psi, const T& chi,
+				 AbsChronologicalPredictor4D<T>& predictor) const
+  {
+    START_CODE();
+
+    MdagMLinOp<T> MdagM(A_);
+    predictor(psi, MdagM, chi);
+
+    SystemSolverResults_t res = (*this)(psi, chi);
+
+    predictor.newVector(psi);
+
+    END_CODE();
+    return res;
+  }
+
+}
@@ -0,0 +1,85 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Solve a MdagM*psi=chi linear system by adaptive aggregation multigrid
+ */
+
+#ifndef __syssolver_mdagm_amg_h__
+#define __syssolver_mdagm_amg_h__
+
+#include "chroma_config.h"
+#include "handle.h"
+#include "state.h"
+#include "syssolver.h"
+#include "linearop.h"
+
+#include "actions/ferm/invert/syssolver_mdagm.h"
+#include "actions/ferm/invert/amg/syssolver_amg_params.h"
+#include "actions/ferm/invert/amg/amg_hierarchy.h"
+
+namespace Chroma
+{
+
+  //! AMG system solver namespace
+  namespace MdagMSysSolverAMGEnv
+  {
+    //! Register the syssolver
+    bool registerAll();
+  }
+
+
+  //! Solve a M^dag*M*psi=chi linear system by adaptive aggregation multigrid
+  /*! \ingroup invert
+   *
+   * Two multigrid preconditioned FGMRES solves,  M^dag y = chi  and then
+   * M psi = y. The second uses the cycle of M, the first the same cycle
+   * between gamma_5, which is the cycle of M^dag for gamma_5-hermitian M.
+   *
+   * M may be the Schur complement of an even-odd preconditioned operator,
+   * as in the HMC monomials. The levels are then made from its
+   * unpreconditioned operator. They are held under SubspaceId as for
+   * LinOpSysSolverAMG, and refreshed when the gauge field moves.
+   */
+  class MdagMSysSolverAMG : public MdagMSystemSolver<LatticeFermion>
+  {
+  public:
+    using T = LatticeFermion;
+    using U = LatticeColorMatrix;
+    using Q = multi1d<U>;
+
+    //! Constructor
+    /*!
+     * \param A_        Linear operator ( Read )
+     * \param invParam  inverter parameters ( Read )
+     */
+    MdagMSysSolverAMG(Handle< LinearOperator<T> > A,
+		      Handle< FermState<T,Q,Q> > state,
+		      const SysSolverAMGParams& invParam) :
+      A_(A), state_(state), invParam_(invParam) {}
+
+    //! Destructor is automatic
+    ~MdagMSysSolverAMG() {}
+
+    //! Return the subset on which the operator acts
+    const Subset& subset() const {return A_->subset();}
+
+    //! Solver the linear system
+    /*!
+     * \param psi      solution ( Modify )
+     * \param chi      source ( Read )
+     * \return syssolver results
+     */
+    SystemSolverResults_t operator() (T& psi, const T& chi) const;
+
+    //! Solver the linear system, with a predicted start
+    SystemSolverResults_t operator() (T& psi, const T& chi,
+				      AbsChronologicalPredictor4D<T>& predictor) const;
+
+  private:
+    Handle< LinearOperator<T> > A_;
+    Handle< FermState<T,Q,Q> > state_;
+    SysSolverAMGParams invParam_;
+  };
+
+} // End namespace
+
+#endif
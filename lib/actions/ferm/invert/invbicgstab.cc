@@ -4,6 +4,7 @@
 
 #include "chromabase.h"
 #include "actions/ferm/invert/invbicgstab.h"
+#include "util/info/perf_counters.h"
 
 namespace Chroma {
 
@@ -28,6 +29,12 @@ InvBiCGStab_a(const LinearOperator<T>& A,
   swatch.reset();
   swatch.start();
 
+  // Per-kernel counters: one field in/out per operator application,
+  // one field read per norm and two per inner product
+  const double perf_field_bytes = PerfCounters::fieldBytes(chi, s);
+  const double perf_norm_flops  = double(4*Nc*Ns)*double(s.numSiteTable());
+  const double perf_inner_flops = double(8*Nc*Ns)*double(s.numSiteTable());
+
   Double chi_sq =  norm2(chi,s);
   flopcount.addSiteFlops(4*Nc*Ns,s);
 
@@ -74,7 +81,10 @@ InvBiCGStab_a(const LinearOperator<T>& A,
   for(int k = 1; k <= MaxBiCGStab && !convP ; k++) { 
     
     // rho_{k+1} = < r_0 | r >
-    rho = innerProduct(r0,r,s);
+    {
+      PerfCounters::Region perf_region("reduction", perf_inner_flops, 2*perf_field_bytes);
+      rho = innerProduct(r0,r,s);
+    }
 
 
     if( toBool( real(rho) == 0 ) && toBool( imag(rho) == 0 ) ) {
@@ -98,12 +108,19 @@ InvBiCGStab_a(const LinearOperator<T>& A,
 
 
     // v = Ap
-    A(v,p,isign);
+    {
+      PerfCounters::Region perf_region("linop", A.nFlops(), 2*perf_field_bytes);
+      A(v,p,isign);
+    }
 
 
     // alpha = rho_{k+1} / < r_0 | v >
     // put <r_0 | v > into tmp
-    DComplex ctmp = innerProduct(r0,v,s);
+    DComplex ctmp;
+    {
+      PerfCounters::Region perf_region("reduction", perf_inner_flops, 2*perf_field_bytes);
+      ctmp = innerProduct(r0,v,s);
+    }
 
 
     if( toBool( real(ctmp) == 0 ) && toBool( imag(ctmp) == 0 ) ) {
@@ -123,11 +140,18 @@ InvBiCGStab_a(const LinearOperator<T>& A,
 
 
     // t = As  = Ar 
-    A(t,r,isign);
+    {
+      PerfCounters::Region perf_region("linop", A.nFlops(), 2*perf_field_bytes);
+      A(t,r,isign);
+    }
     // omega = < t | s > / < t | t > = < t | r > / norm2(t);
 
     // This does the full 5D norm
-    Double t_norm = norm2(t,s);
+    Double t_norm;
+    {
+      PerfCounters::Region perf_region("reduction", perf_norm_flops, perf_field_bytes);
+      t_norm = norm2(t,s);
+    }
 
 
     if( toBool(t_norm == 0) ) { 
@@ -136,7 +160,10 @@ InvBiCGStab_a(const LinearOperator<T>& A,
     }
 
     // accumulate <t | s > = <t | r> into omega
-    omega = innerProduct(t,r,s);
+    {
+      PerfCounters::Region perf_region("reduction", perf_inner_flops, 2*perf_field_bytes);
+      omega = innerProduct(t,r,s);
+    }
     omega /= t_norm;
 
     // psi = psi + omega s + alpha p 
@@ -157,7 +184,11 @@ InvBiCGStab_a(const LinearOperator<T>& A,
     r[s] -= omega_r*t;
 
 
-    Double r_norm = norm2(r,s);
+    Double r_norm;
+    {
+      PerfCounters::Region perf_region("reduction", perf_norm_flops, perf_field_bytes);
+      r_norm = norm2(r,s);
+    }
 
 
     //    QDPIO::cout << "Iteration " << k << " : r = " << r_norm << std::endl;
@@ -193,6 +224,7 @@ InvBiCGStab_a(const LinearOperator<T>& A,
 
   QDPIO::cout << "InvBiCGStab: k = " << ret.n_count << " resid = " << ret.resid << std::endl;
   flopcount.report("invbicgstab", swatch.getTimeInSeconds());
+  PerfCounters::record("solver:invbicgstab", swatch.getTimeInSeconds(), flopcount.getFlops(), 0);
 
   if ( ret.n_count == MaxBiCGStab ) { 
     QDPIO::cerr << "Nonconvergence of BiCGStab. MaxIters reached " << std::endl;
@@ -4,6 +4,7 @@
 
 #include "chromabase.h"
 #include "actions/ferm/invert/invcg2.h"
+#include "util/info/perf_counters.h"
 
 using namespace QDP::Hints;
 #undef PAT
@@ -96,6 +97,12 @@ namespace Chroma
     swatch.reset();
     swatch.start();
 
+    // Per-kernel counters: one field in/out per operator application,
+    // one field read per reduction
+    PerfCounters::Region perf_solve("solver:invcg2");
+    const double perf_field_bytes = PerfCounters::fieldBytes(r, s);
+    const double perf_norm_flops  = double(4*Nc*Ns)*double(s.numSiteTable());
+
 //  Real rsd_sq = (RsdCG * RsdCG) * Real(norm2(chi,s));
     Double chi_sq =  norm2(chi_internal,s);
     flopcount.addSiteFlops(4*Nc*Ns,s);
@@ -139,6 +146,7 @@ namespace Chroma
       res.resid   = sqrt(cp);
       swatch.stop();
       flopcount.report("invcg2", swatch.getTimeInSeconds());
+      perf_solve.addFlops(flopcount.getFlops());
       revertFromFastMemoryHint(psi,true);
       END_CODE();
       return res;
@@ -159,16 +167,25 @@ namespace Chroma
       //      	       	       	       	       	  +
       //  First compute  d  =  < p, A.p >  =  < p, M . M . p >  =  < M.p, M.p >
       //  Mp = M(u) * p
-      M(mp, p, PLUS);  flopcount.addFlops(M.nFlops());
+      {
+	PerfCounters::Region perf_region("linop", M.nFlops(), 2*perf_field_bytes);
+	M(mp, p, PLUS);  flopcount.addFlops(M.nFlops());
+      }
 
       //  d = | mp | ** 2
-      d = norm2(mp, s);  flopcount.addSiteFlops(4*Nc*Ns,s);
+      {
+	PerfCounters::Region perf_region("reduction", perf_norm_flops, perf_field_bytes);
+	d = norm2(mp, s);  flopcount.addSiteFlops(4*Nc*Ns,s);
+      }
 
       //  r[k] -= a[k] A . p[k] ;
       //      	       +            +
       //  r  =  r  -  M(u)  . Mp  =  M  . M . p  =  A . p
-      M(mmp, mp, MINUS);
-      flopcount.addFlops(M.nFlops());
+      {
+	PerfCounters::Region perf_region("linop", M.nFlops(), 2*perf_field_bytes);
+	M(mmp, mp, MINUS);
+	flopcount.addFlops(M.nFlops());
+      }
 
  
       a = c/d;
@@ -179,7 +196,10 @@ namespace Chroma
       flopcount.addSiteFlops(4*Nc*Ns, s);
 
       //  cp  =  | r[k] |**2
-      cp = norm2(r, s);    flopcount.addSiteFlops(4*Nc*Ns,s);
+      {
+	PerfCounters::Region perf_region("reduction", perf_norm_flops, perf_field_bytes);
+	cp = norm2(r, s);    flopcount.addSiteFlops(4*Nc*Ns,s);
+      }
 
       //  Psi[k] += a[k] p[k]
       psi[s] += ar * p;    flopcount.addSiteFlops(4*Nc*Ns,s);
@@ -198,6 +218,7 @@ namespace Chroma
 	swatch.stop();
 	//	QDPIO::cout << "InvCG: k = " << k << "  cp = " << cp << std::endl;
 	flopcount.report("invcg2", swatch.getTimeInSeconds());
+	perf_solve.addFlops(flopcount.getFlops());
 	revertFromFastMemoryHint(psi,true);
 
 	// Compute the actual residual
@@ -224,6 +245,7 @@ namespace Chroma
     swatch.stop();
     QDPIO::cerr << "Nonconvergence Warning" << std::endl;
     flopcount.report("invcg2", swatch.getTimeInSeconds());
+    perf_solve.addFlops(flopcount.getFlops());
     revertFromFastMemoryHint(psi,true);
     QDPIO::cerr << "too many CG iterations: count =" << res.n_count <<" rsd^2= " << cp << std::endl <<std::flush;
 
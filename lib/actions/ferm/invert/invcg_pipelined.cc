@@ -0,0 +1,215 @@
+/*! \file
+ *  \brief Pipelined Conjugate-Gradient algorithm for a generic Linear Operator
+ */
+
+#include "chromabase.h"
+#include "actions/ferm/invert/invcg_pipelined.h"
+#include "actions/ferm/invert/merged_reductions.h"
+#include "lmdagm.h"
+#include "util/info/perf_counters.h"
+
+#include <vector>
+
+namespace Chroma 
+{
+
+  //! Pipelined Conjugate-Gradient (CGNE) algorithm for a generic Linear Operator
+  /*! \ingroup invert
+   * See the header for the algorithm.
+   *
+   * QDP++ has only blocking global sums, so the one reduction of an
+   * iteration is not yet overlapped with  q = A w. It is placed just
+   * before it, so that a non-blocking sum can be dropped in there.
+   */
+  template<typename T, typename RT>
+  SystemSolverResults_t 
+  InvCGPipelined_a(const LinearOperator<T>& M,
+		   const T& chi,
+		   T& psi,
+		   const Real& RsdCG, 
+		   int MaxCG,
+		   int ReplaceInterval)
+  {
+    START_CODE();
+
+    const Subset& s = M.subset();
+
+    SystemSolverResults_t  res;
+    T r, w, q, p, sv, z;
+    T tmp;
+
+    QDPIO::cout << "InvCGPipelined: starting" << std::endl;
+
+    FlopCounter flopcount;
+    flopcount.reset();
+    StopWatch swatch;
+    swatch.reset();
+    swatch.start();
+
+    PerfCounters::Region perf_solve("solver:invcg_pipelined");
+    const double perf_field_bytes = PerfCounters::fieldBytes(r, s);
+    const double perf_dot_flops   = double(12*Nc*Ns)*double(s.numSiteTable());
+
+    Double chi_sq = norm2(chi,s);
+    flopcount.addSiteFlops(4*Nc*Ns,s);
+
+    Double rsd_sq = (RsdCG * RsdCG) * chi_sq;
+
+    // r = Chi - A Psi,  w = A r
+    applyMdagM(M, tmp, psi);
+    r[s] = chi - tmp;
+    applyMdagM(M, w, r);
+    flopcount.addFlops(4*M.nFlops());
+    flopcount.addSiteFlops(2*Nc*Ns,s);
+
+    p[s]  = zero;
+    sv[s] = zero;
+    z[s]  = zero;
+
+    // gamma = <r,r>  and  delta = <w,r>  in one reduction
+    std::vector<const T*> dot_x(2), dot_y(2);
+    dot_x[0] = &r;  dot_y[0] = &r;
+    dot_x[1] = &w;  dot_y[1] = &r;
+    multi1d<DComplex> dot;
+
+    Double gamma, gamma_old, delta, a, a_old, b;
+
+    int  k = 0;              // iterations done
+    int  since_replace = 0;
+    int  n_replace = 0;
+    bool replace = false;
+    bool r_true  = true;     // r is the true residuum
+
+    while (true)
+    {
+      if (replace)
+      {
+	// Residual replacement: r and the products carried with it
+	applyMdagM(M, tmp, psi);
+	r[s] = chi - tmp;
+	applyMdagM(M, w, r);
+	applyMdagM(M, sv, p);
+	applyMdagM(M, z, sv);
+	flopcount.addFlops(8*M.nFlops());
+	flopcount.addSiteFlops(2*Nc*Ns,s);
+
+	replace = false;
+	r_true = true;
+	since_replace = 0;
+	++n_replace;
+      }
+
+      {
+	PerfCounters::Region perf_region("reduction", perf_dot_flops, 2*perf_field_bytes);
+	mergedInnerProducts(dot_x, dot_y, dot, s);
+	flopcount.addSiteFlops(12*Nc*Ns,s);
+      }
+      gamma = real(dot[0]);
+      delta = real(dot[1]);
+
+      if ( toBool(gamma <= rsd_sq) )
+      {
+	// Only stop on the true residuum
+	if (r_true)
+	  break;
+
+	replace = true;
+	continue;
+      }
+
+      if (k >= MaxCG)
+	break;
+
+      // q = A w, independent of the reduction above
+      {
+	PerfCounters::Region perf_region("linop", 2*M.nFlops(), 4*perf_field_bytes);
+	applyMdagM(M, q, w);
+	flopcount.addFlops(2*M.nFlops());
+      }
+
+      if (k == 0)
+      {
+	b = zero;
+	a = gamma / delta;
+      }
+      else
+      {
+	b = gamma / gamma_old;
+	a = gamma / (delta - b*gamma/a_old);
+      }
+
+      RT ar = a;
+      RT br = b;
+
+      z[s]   = q + br*z;
+      sv[s]  = w + br*sv;
+      p[s]   = r + br*p;
+      psi[s] += ar*p;
+      r[s]   -= ar*sv;
+      w[s]   -= ar*z;
+      flopcount.addSiteFlops(24*Nc*Ns,s);
+
+      gamma_old = gamma;
+      a_old = a;
+
+      ++k;
+      r_true = false;
+
+      if (ReplaceInterval > 0 && ++since_replace >= ReplaceInterval)
+	replace = true;
+    }
+
+    // Compute the actual residual
+    {
+      applyMdagM(M, tmp, psi);
+      r[s] = chi - tmp;
+      flopcount.addFlops(2*M.nFlops());
+    }
+
+    res.n_count = k;
+    res.resid   = sqrt(norm2(r,s));
+
+    swatch.stop();
+
+    QDPIO::cout << "InvCGPipelined: k = " << k << " replacements = " << n_replace
+		<< " resid = " << res.resid << std::endl;
+
+    if ( toBool(res.resid*res.resid > rsd_sq) )
+      QDPIO::cerr << "Nonconvergence Warning: InvCGPipelined" << std::endl;
+
+    flopcount.report("invcg_pipelined", swatch.getTimeInSeconds());
+    perf_solve.addFlops(flopcount.getFlops());
+
+    END_CODE();
+    return res;
+  }
+
+
+  //
+  // Explicit versions
+  //
+  // Single precision
+  SystemSolverResults_t 
+  InvCGPipelined(const LinearOperator<LatticeFermionF>& M,
+		 const LatticeFermionF& chi,
+		 LatticeFermionF& psi,
+		 const Real& RsdCG, 
+		 int MaxCG,
+		 int ReplaceInterval)
+  {
+    return InvCGPipelined_a<LatticeFermionF,RealF>(M, chi, psi, RsdCG, MaxCG, ReplaceInterval);
+  }
+
+  // Double precision
+  SystemSolverResults_t 
+  InvCGPipelined(const LinearOperator<LatticeFermionD>& M,
+		 const LatticeFermionD& chi,
+		 LatticeFermionD& psi,
+		 const Real& RsdCG, 
+		 int MaxCG,
+		 int ReplaceInterval)
+  {
+    return InvCGPipelined_a<LatticeFermionD,RealD>(M, chi, psi, RsdCG, MaxCG, ReplaceInterval);
+  }
+
+}  // end namespace Chroma
@@ -0,0 +1,73 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Pipelined Conjugate-Gradient algorithm for a generic Linear Operator
+ */
+
+#ifndef __invcg_pipelined__
+#define __invcg_pipelined__
+
+#include "linearop.h"
+#include "syssolver.h"
+
+namespace Chroma 
+{
+
+  //! Pipelined Conjugate-Gradient (CGNE) algorithm for a generic Linear Operator
+  /*! \ingroup invert
+   * Solves  Chi = A . Psi  with  A = M^dag . M  by the pipelined CG of
+   * Ghysels and Vanroose (Parallel Computing 40, 2014).
+   *
+   * The recurrences carry w = A r, s = A p and z = A s along with r and p,
+   * so that  |r|^2  and  <w,r>  are known at the same point of an
+   * iteration, independent of the product  q = A w. They are summed in
+   * one global reduction per iteration, against two for InvCG2.
+   *
+   * Algorithm:
+   *
+   *  r := Chi - A Psi;  w := A r
+   *  FOR k FROM 0 TO MaxCG-1 DO
+   *      gamma := |r|^2;  delta := <w,r>             One reduction
+   *      IF gamma <= RsdCG^2 |Chi|^2 THEN RETURN;
+   *      q := A w
+   *      b := gamma / gamma_old;  a := gamma / (delta - b gamma / a_old)
+   *      z := q + b z;  s := w + b s;  p := r + b p
+   *      Psi += a p;  r -= a s;  w -= a z
+   *
+   * The recurred residuum drifts from the true one faster than in
+   * plain CG. Every  ReplaceInterval  iterations, and when the recurred
+   * residuum converges, r, w, s and z are recomputed from Psi and p.
+   *
+   *  \param M                Linear Operator               (Read)
+   *  \param chi              Source                        (Read)
+   *  \param psi              Solution                      (Modify)
+   *  \param RsdCG            CG residual accuracy          (Read)
+   *  \param MaxCG            Maximum CG iterations         (Read)
+   *  \param ReplaceInterval  iterations between residual replacements, 0 for none (Read)
+   *  \return res             System solver results
+   *
+   * @{
+   */
+
+  // Single precision
+  SystemSolverResults_t 
+  InvCGPipelined(const LinearOperator<LatticeFermionF>& M,
+		 const LatticeFermionF& chi,
+		 LatticeFermionF& psi,
+		 const Real& RsdCG, 
+		 int MaxCG,
+		 int ReplaceInterval);
+
+  // Double precision
+  SystemSolverResults_t 
+  InvCGPipelined(const LinearOperator<LatticeFermionD>& M,
+		 const LatticeFermionD& chi,
+		 LatticeFermionD& psi,
+		 const Real& RsdCG, 
+		 int MaxCG,
+		 int ReplaceInterval);
+
+  /*! @} */  // end of group invert
+
+}  // end namespace Chroma
+
+#endif
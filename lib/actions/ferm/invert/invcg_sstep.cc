@@ -0,0 +1,337 @@
+/*! \file
+ *  \brief s-step Conjugate-Gradient algorithm for a generic Linear Operator
+ */
+
+#include "chromabase.h"
+#include "actions/ferm/invert/invcg_sstep.h"
+#include "actions/ferm/invert/merged_reductions.h"
+#include "lmdagm.h"
+#include "util/info/perf_counters.h"
+
+#include <vector>
+
+namespace Chroma 
+{
+
+  namespace
+  {
+    //! c^dag G d
+    DComplex gramProduct(const multi2d<DComplex>& G,
+			 const multi1d<DComplex>& c,
+			 const multi1d<DComplex>& d)
+    {
+      DComplex sum = zero;
+      for(int i=0; i < c.size(); ++i)
+      {
+	DComplex Gd = zero;
+	for(int j=0; j < d.size(); ++j)
+	  Gd += G(i,j)*d[j];
+
+	sum += conj(c[i])*Gd;
+      }
+      return sum;
+    }
+
+    //! Coefficients of A Y c:  one power up within each block
+    void shiftBasis(int sstep,
+		    const multi1d<DComplex>& c,
+		    multi1d<DComplex>& d)
+    {
+      for(int i=0; i < d.size(); ++i)
+	d[i] = zero;
+
+      for(int j=0; j < sstep; ++j)
+      {
+	d[j+1]         = c[j];           // p block: A^j p -> A^{j+1} p
+	if (j+1 < sstep)
+	  d[sstep+2+j] = c[sstep+1+j];   // r block: A^j r -> A^{j+1} r
+      }
+    }
+  }
+
+
+  //! s-step Conjugate-Gradient (CGNE) algorithm for a generic Linear Operator
+  /*! \ingroup invert
+   * See the header for the algorithm.
+   */
+  template<typename T, typename CT>
+  SystemSolverResults_t 
+  InvCGSStep_a(const LinearOperator<T>& M,
+	       const T& chi,
+	       T& psi,
+	       const Real& RsdCG, 
+	       int MaxCG,
+	       int SStep,
+	       int ReplaceInterval)
+  {
+    START_CODE();
+
+    const Subset& s = M.subset();
+    const int sstep = (SStep < 1) ? 1 : SStep;
+    const int nb    = 2*sstep + 1;       // size of the basis
+
+    SystemSolverResults_t  res;
+    T r, p;
+    T tmp;
+    multi1d<T> Y(nb);
+
+    QDPIO::cout << "InvCGSStep: starting, s = " << sstep << std::endl;
+
+    FlopCounter flopcount;
+    flopcount.reset();
+    StopWatch swatch;
+    swatch.reset();
+    swatch.start();
+
+    PerfCounters::Region perf_solve("solver:invcg_sstep");
+    const double perf_field_bytes = PerfCounters::fieldBytes(r, s);
+
+    Double chi_sq = norm2(chi,s);
+    flopcount.addSiteFlops(4*Nc*Ns,s);
+
+    Double rsd_sq = (RsdCG * RsdCG) * chi_sq;
+
+    // The Gram matrix is Hermitian: one product per pair i <= j
+    std::vector<const T*> dot_x, dot_y;
+    for(int i=0; i < nb; ++i)
+    {
+      for(int j=i; j < nb; ++j)
+      {
+	dot_x.push_back(&Y[i]);
+	dot_y.push_back(&Y[j]);
+      }
+    }
+    const int npairs = dot_x.size();
+    const double perf_gram_flops = double(8*Nc*Ns)*double(s.numSiteTable())*npairs;
+
+    multi1d<DComplex> dot;
+    multi2d<DComplex> G(nb,nb);
+
+    // Coefficient vectors in the basis Y
+    multi1d<DComplex> pc(nb), rc(nb), xc(nb), apc(nb);
+
+    // r = Chi - A Psi,  p = r
+    applyMdagM(M, tmp, psi);
+    r[s] = chi - tmp;
+    p[s] = r;
+    flopcount.addFlops(2*M.nFlops());
+    flopcount.addSiteFlops(2*Nc*Ns,s);
+
+    Double rr = norm2(r,s);
+    flopcount.addSiteFlops(4*Nc*Ns,s);
+
+    int  k = 0;              // CG steps done
+    int  since_replace = 0;
+    int  n_replace = 0;
+    int  n_outer = 0;
+    bool replace = false;
+    bool restart = false;    // also reset p to r
+    bool p_fresh = true;     // p is the true residuum
+    bool r_true  = true;     // r is the true residuum
+
+    while (true)
+    {
+      if (replace)
+      {
+	// Residual replacement; p is kept unless restarting
+	applyMdagM(M, tmp, psi);
+	r[s] = chi - tmp;
+	rr = norm2(r,s);
+	flopcount.addFlops(2*M.nFlops());
+	flopcount.addSiteFlops(6*Nc*Ns,s);
+
+	if (restart)
+	{
+	  p[s] = r;
+	  p_fresh = true;
+	}
+
+	replace = false;
+	restart = false;
+	r_true = true;
+	since_replace = 0;
+	++n_replace;
+      }
+
+      if ( toBool(rr <= rsd_sq) )
+      {
+	// Only stop on the true residuum
+	if (r_true)
+	  break;
+
+	replace = true;
+	continue;
+      }
+
+      if (k >= MaxCG)
+	break;
+
+      ++n_outer;
+
+      // Basis  [ p .. A^s p, r .. A^{s-1} r ]:  2s-1 products, no reductions
+      {
+	PerfCounters::Region perf_region("linop", 2*(nb-2)*M.nFlops(), 4*(nb-2)*perf_field_bytes);
+
+	Y[0][s] = p;
+	for(int j=1; j <= sstep; ++j)
+	{
+	  applyMdagM(M, Y[j], Y[j-1]);
+	}
+
+	Y[sstep+1][s] = r;
+	for(int j=1; j < sstep; ++j)
+	{
+	  applyMdagM(M, Y[sstep+1+j], Y[sstep+j]);
+	}
+	flopcount.addFlops(2*(nb-2)*M.nFlops());
+      }
+
+      // Gram matrix in one reduction
+      {
+	PerfCounters::Region perf_region("reduction", perf_gram_flops, 2*npairs*perf_field_bytes);
+	mergedInnerProducts(dot_x, dot_y, dot, s);
+	flopcount.addSiteFlops(8*Nc*Ns*npairs,s);
+      }
+
+      int n = 0;
+      for(int i=0; i < nb; ++i)
+      {
+	for(int j=i; j < nb; ++j, ++n)
+	{
+	  G(i,j) = dot[n];
+	  G(j,i) = conj(dot[n]);
+	}
+      }
+
+      // s CG steps on the coefficients
+      for(int i=0; i < nb; ++i)
+      {
+	pc[i] = zero;
+	rc[i] = zero;
+	xc[i] = zero;
+      }
+      pc[0]       = Double(1);
+      rc[sstep+1] = Double(1);
+
+      rr = real(G(sstep+1,sstep+1));
+
+      for(int j=0; j < sstep && k < MaxCG; ++j)
+      {
+	shiftBasis(sstep, pc, apc);
+
+	Double pap = real(gramProduct(G, pc, apc));
+	if ( toBool(pap <= Double(0)) )
+	{
+	  // The basis has lost A-definiteness: rebuild from the true residuum
+	  QDPIO::cout << "InvCGSStep: <p,Ap> = " << pap << " at k = " << k << ", restarting" << std::endl;
+	  if (j == 0 && p_fresh)
+	  {
+	    QDPIO::cerr << "InvCGSStep: breakdown on a fresh restart, is the operator positive definite?" << std::endl;
+	    QDP_abort(1);
+	  }
+	  replace = true;
+	  restart = true;
+	  break;
+	}
+	Double a = rr / pap;
+
+	for(int i=0; i < nb; ++i)
+	{
+	  xc[i] += a*pc[i];
+	  rc[i] -= a*apc[i];
+	}
+
+	Double rr_new = real(gramProduct(G, rc, rc));
+	Double b = rr_new / rr;
+
+	for(int i=0; i < nb; ++i)
+	  pc[i] = rc[i] + b*pc[i];
+
+	rr = rr_new;
+	++k;
+	++since_replace;
+
+	if ( toBool(rr <= rsd_sq) )
+	  break;
+      }
+
+      // Back to the lattice
+      r[s] = zero;
+      p[s] = zero;
+      for(int i=0; i < nb; ++i)
+      {
+	CT x_i = xc[i];
+	CT r_i = rc[i];
+	CT p_i = pc[i];
+	psi[s] += x_i*Y[i];
+	r[s]   += r_i*Y[i];
+	p[s]   += p_i*Y[i];
+      }
+      flopcount.addSiteFlops(24*Nc*Ns*nb,s);
+
+      r_true  = false;
+      p_fresh = false;
+
+      if (ReplaceInterval > 0 && since_replace >= ReplaceInterval)
+	replace = true;
+    }
+
+    // Compute the actual residual
+    if (! r_true)
+    {
+      applyMdagM(M, tmp, psi);
+      r[s] = chi - tmp;
+      rr = norm2(r,s);
+      flopcount.addFlops(2*M.nFlops());
+    }
+
+    res.n_count = k;
+    res.resid   = sqrt(rr);
+
+    swatch.stop();
+
+    QDPIO::cout << "InvCGSStep: k = " << k << " outer = " << n_outer
+		<< " replacements = " << n_replace
+		<< " resid = " << res.resid << std::endl;
+
+    if ( toBool(rr > rsd_sq) )
+      QDPIO::cerr << "Nonconvergence Warning: InvCGSStep" << std::endl;
+
+    flopcount.report("invcg_sstep", swatch.getTimeInSeconds());
+    perf_solve.addFlops(flopcount.getFlops());
+
+    END_CODE();
+    return res;
+  }
+
+
+  //
+  // Explicit versions
+  //
+  // Single precision
+  SystemSolverResults_t 
+  InvCGSStep(const LinearOperator<LatticeFermionF>& M,
+	     const LatticeFermionF& chi,
+	     LatticeFermionF& psi,
+	     const Real& RsdCG, 
+	     int MaxCG,
+	     int SStep,
+	     int ReplaceInterval)
+  {
+    return InvCGSStep_a<LatticeFermionF,ComplexF>(M, chi, psi, RsdCG, MaxCG, SStep, ReplaceInterval);
+  }
+
+  // Double precision
+  SystemSolverResults_t 
+  InvCGSStep(const LinearOperator<LatticeFermionD>& M,
+	     const LatticeFermionD& chi,
+	     LatticeFermionD& psi,
+	     const Real& RsdCG, 
+	     int MaxCG,
+	     int SStep,
+	     int ReplaceInterval)
+  {
+    return InvCGSStep_a<LatticeFermionD,ComplexD>(M, chi, psi, RsdCG, MaxCG, SStep, ReplaceInterval);
+  }
+
+}  // end namespace Chroma
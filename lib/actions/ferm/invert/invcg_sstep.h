@@ -0,0 +1,70 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief s-step Conjugate-Gradient algorithm for a generic Linear Operator
+ */
+
+#ifndef __invcg_sstep__
+#define __invcg_sstep__
+
+#include "linearop.h"
+#include "syssolver.h"
+
+namespace Chroma 
+{
+
+  //! s-step (communication avoiding) Conjugate-Gradient (CGNE) algorithm
+  /*! \ingroup invert
+   * Solves  Chi = A . Psi  with  A = M^dag . M, taking  s  CG steps per
+   * global reduction (Chronopoulos and Gear 1989; Carson and Demmel 2014).
+   *
+   * Each outer step builds the monomial basis
+   *
+   *    Y = [ p, A p, .. A^s p, r, A r, .. A^{s-1} r ]
+   *
+   * with 2s-1 products, and its Gram matrix  G = Y^dag Y  in one
+   * global reduction. The next s CG steps then run on coefficient
+   * vectors in the basis Y:  A Y c = Y B c, where B shifts each block
+   * by one power, and  <Y c, Y d> = c^dag G d. Only at the end of the
+   * outer step are Psi, r and p formed on the lattice again.
+   *
+   * The monomial basis gets ill-conditioned as s grows; s of 2 to 5
+   * is the useful range. Every  ReplaceInterval  iterations, and when the
+   * recurred residuum converges, r is recomputed from Psi.
+   *
+   *  \param M                Linear Operator               (Read)
+   *  \param chi              Source                        (Read)
+   *  \param psi              Solution                      (Modify)
+   *  \param RsdCG            CG residual accuracy          (Read)
+   *  \param MaxCG            Maximum CG iterations         (Read)
+   *  \param SStep            CG steps per reduction        (Read)
+   *  \param ReplaceInterval  iterations between residual replacements, 0 for none (Read)
+   *  \return res             System solver results
+   *
+   * @{
+   */
+
+  // Single precision
+  SystemSolverResults_t 
+  InvCGSStep(const LinearOperator<LatticeFermionF>& M,
+	     const LatticeFermionF& chi,
+	     LatticeFermionF& psi,
+	     const Real& RsdCG, 
+	     int MaxCG,
+	     int SStep,
+	     int ReplaceInterval);
+
+  // Double precision
+  SystemSolverResults_t 
+  InvCGSStep(const LinearOperator<LatticeFermionD>& M,
+	     const LatticeFermionD& chi,
+	     LatticeFermionD& psi,
+	     const Real& RsdCG, 
+	     int MaxCG,
+	     int SStep,
+	     int ReplaceInterval);
+
+  /*! @} */  // end of group invert
+
+}  // end namespace Chroma
+
+#endif
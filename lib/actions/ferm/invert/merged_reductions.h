@@ -0,0 +1,125 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Several inner products with a single global reduction
+ */
+
+#ifndef __merged_reductions_h__
+#define __merged_reductions_h__
+
+#include "chromabase.h"
+#include "util/info/perf_counters.h"
+
+#include <vector>
+
+namespace Chroma
+{
+
+  namespace MergedReductions
+  {
+    //! Arguments of the site loop
+    template<typename W>
+    struct DotArgs
+    {
+      const W* const*  x;
+      const W* const*  y;
+      int              npairs;
+      int              nw;        /*!< words per site */
+      const int*       tab;
+      double*          partial;   /*!< 2*npairs per thread */
+    };
+
+    //! Node local sums of conj(x) y, one pass over the sites for all pairs
+    template<typename W>
+    void dotSiteLoop(int lo, int hi, int myId, DotArgs<W>* a)
+    {
+      const int npairs = a->npairs;
+      const int nw     = a->nw;
+      double* acc = a->partial + 2*npairs*myId;
+
+      for(int j=lo; j < hi; ++j)
+      {
+	const int site = a->tab[j];
+
+	for(int p=0; p < npairs; ++p)
+	{
+	  const W* xs = a->x[p] + site*nw;
+	  const W* ys = a->y[p] + site*nw;
+
+	  double re = 0, im = 0;
+	  for(int i=0; i < nw; i += 2)
+	  {
+	    re += double(xs[i])*double(ys[i])   + double(xs[i+1])*double(ys[i+1]);
+	    im += double(xs[i])*double(ys[i+1]) - double(xs[i+1])*double(ys[i]);
+	  }
+
+	  acc[2*p]   += re;
+	  acc[2*p+1] += im;
+	}
+      }
+    }
+  }
+
+
+  //! Inner products  dot[i] = < x[i], y[i] >  on a subset, with one global sum
+  /*! \ingroup invert
+   *
+   * All the products are summed on the node in one pass over the sites,
+   * and then go through a single QDPInternal::globalSumArray. A Krylov
+   * solver that needs several scalars at the same point of an iteration
+   * thus waits for one allreduce instead of one per product. Norms are
+   * the real parts of < x, x >.
+   *
+   * The fields must be made of complex words, as fermions are.
+   */
+  template<typename T>
+  void mergedInnerProducts(const std::vector<const OLattice<T>*>& x,
+			   const std::vector<const OLattice<T>*>& y,
+			   multi1d<DComplex>& dot,
+			   const Subset& s)
+  {
+    const int npairs = x.size();
+    dot.resize(npairs);
+
+#ifndef QDP_IS_QDPJIT
+    typedef typename WordType<T>::Type_t W;
+
+    std::vector<const W*> xw(npairs), yw(npairs);
+    for(int p=0; p < npairs; ++p)
+    {
+      xw[p] = (const W*)&(x[p]->elem(0));
+      yw[p] = (const W*)&(y[p]->elem(0));
+    }
+
+    std::vector<double> partial(2*npairs*qdpNumThreads(), 0.0);
+
+    MergedReductions::DotArgs<W> a;
+    a.x       = &xw[0];
+    a.y       = &yw[0];
+    a.npairs  = npairs;
+    a.nw      = sizeof(T) / sizeof(W);
+    a.tab     = s.siteTable().slice();
+    a.partial = &partial[0];
+
+    dispatch_to_threads(s.numSiteTable(), a, MergedReductions::dotSiteLoop<W>);
+
+    std::vector<double> sums(2*npairs, 0.0);
+    for(int t=0; t < qdpNumThreads(); ++t)
+      for(int i=0; i < 2*npairs; ++i)
+	sums[i] += partial[2*npairs*t + i];
+
+    {
+      PerfCounters::ReductionRegion perf_sum(2*npairs);
+      QDPInternal::globalSumArray(&sums[0], 2*npairs);
+    }
+
+    for(int p=0; p < npairs; ++p)
+      dot[p] = cmplx(Double(sums[2*p]), Double(sums[2*p+1]));
+#else
+    for(int p=0; p < npairs; ++p)
+      dot[p] = innerProduct(*x[p], *y[p], s);
+#endif
+  }
+
+} // End namespace
+
+#endif
@@ -0,0 +1,364 @@
+/*! \file
+ *  \brief Multishift Conjugate-Gradient algorithm for several right hand sides
+ */
+
+#include "linearop.h"
+#include "actions/ferm/invert/minvcg_mrhs.h"
+
+#include <vector>
+
+namespace Chroma
+{
+
+  namespace
+  {
+    //! Iteration state of one source
+    template<typename T>
+    struct MInvCGState_t
+    {
+      T                r;         /*!< residual of the unshifted system */
+      multi1d<T>       p;         /*!< directions per shift, but the smallest */
+      multi1d<Double>  bs;        /*!< shifted step sizes */
+      multi2d<Double>  z;         /*!< shifted residual scalings, current and previous */
+      multi1d<Double>  rsd_sq;    /*!< target residual norms squared */
+      multi1d<bool>    convsP;    /*!< converged shifts */
+      Double           a;
+      Double           b;
+      Double           c;         /*!< |r[k]|^2 */
+      Double           cp;        /*!< |r[k-1]|^2 */
+      int              iz;
+    };
+
+
+    //! Apply A + shift to the smallest shift directions of the active sources
+    /*! P holds those directions in the order of the active sources */
+    template<typename T>
+    void applyShifted(const LinearOperator<T>& A,
+		      multi1d<T>& Ap,
+		      const multi1d<T>& P,
+		      const Real& shift,
+		      FlopCounter& flopcount)
+    {
+      const Subset& sub = A.subset();
+
+      // All the sources in one call
+      A(Ap, P, PLUS);                                  flopcount.addFlops(P.size()*A.nFlops());
+
+      for(int k=0; k < P.size(); ++k)
+      {
+	Ap[k][sub] += shift*P[k];                      flopcount.addSiteFlops(4*Nc*Ns,sub);
+      }
+    }
+
+
+    //! Drop the directions of the sources that left, keep[j] is the old position of the j-th
+    template<typename T>
+    void compactDirections(multi1d<T>& P, const std::vector<int>& keep, const Subset& sub)
+    {
+      if (keep.size() == P.size())
+	return;
+
+      multi1d<T> Q(keep.size());
+      for(int j=0; j < keep.size(); ++j)
+	Q[j][sub] = P[keep[j]];
+
+      P.resize(keep.size());
+      for(int j=0; j < keep.size(); ++j)
+	P[j][sub] = Q[j];
+    }
+  }
+
+
+  //! Multishift Conjugate-Gradient (CG1) algorithm for several sources
+  /*! \ingroup invert
+   *
+   * The recursion for each source is the one of MInvCG (Jegerlehner,
+   * hep-lat/9708029), only the applications of A are batched over the
+   * sources.
+   */
+  template<typename T>
+  void MInvCGMultiRHS_a(const LinearOperator<T>& A,
+			const multi1d<T>& chi,
+			multi1d< multi1d<T> >& psi,
+			const multi1d<Real>& shifts,
+			const multi1d<Real>& RsdCG,
+			int MaxCG,
+			multi1d<int>& n_count)
+  {
+    START_CODE();
+
+    const Subset& sub = A.subset();
+
+    if (shifts.size() != RsdCG.size())
+    {
+      QDPIO::cerr << "MInvCGMultiRHS: number of shifts and residuals must match" << std::endl;
+      QDP_abort(1);
+    }
+
+    int n_shift = shifts.size();
+    int n_rhs   = chi.size();
+
+    if (n_shift == 0)
+    {
+      QDPIO::cerr << "MInvCGMultiRHS: You must supply at least 1 mass: mass.size() = "
+		  << n_shift << std::endl;
+      QDP_abort(1);
+    }
+
+    /* Now find the smallest mass */
+    int isz = 0;
+    for(int findit=1; findit < n_shift; ++findit) {
+      if ( toBool( shifts[findit] < shifts[isz])  ) {
+	isz = findit;
+      }
+    }
+
+    psi.resize(n_rhs);
+    n_count.resize(n_rhs);
+
+    FlopCounter flopcount;
+    flopcount.reset();
+    StopWatch swatch;
+    swatch.reset();
+    swatch.start();
+
+    multi1d< MInvCGState_t<T> > st(n_rhs);
+    std::vector<int> active;
+
+    for(int n=0; n < n_rhs; ++n)
+    {
+      if( psi[n].size() <  n_shift ) {
+	psi[n].resize(n_shift);
+      }
+
+      // For this algorithm, all the psi have to be 0 to start
+      for(int s = 0; s < n_shift; ++s) {
+	psi[n][s][sub] = zero;
+      }
+
+      n_count[n] = 0;
+
+      // If chi has zero norm then the result is zero
+      Double chi_norm_sq = norm2(chi[n],sub);          flopcount.addSiteFlops(4*Nc*Ns,sub);
+      if( toBool( sqrt(chi_norm_sq) < fuzz ))
+	continue;
+
+      MInvCGState_t<T>& x = st[n];
+      x.rsd_sq.resize(n_shift);
+      x.bs.resize(n_shift);
+      x.z.resize(2, n_shift);
+      x.convsP.resize(n_shift);
+      x.p.resize(n_shift);
+
+      x.cp = chi_norm_sq;
+      for(int s = 0; s < n_shift; ++s) {
+	x.rsd_sq[s] = Real(x.cp) * RsdCG[s] * RsdCG[s];
+	x.convsP[s] = false;
+	if (s != isz)
+	  x.p[s][sub] = chi[n];
+      }
+      x.r[sub] = chi[n];
+
+      active.push_back(n);
+    }
+
+    // The smallest shift directions of the active sources, in one batch
+    // that goes to A as it is
+    multi1d<T> P(active.size());
+    for(int k=0; k < active.size(); ++k)
+      P[k][sub] = chi[active[k]];
+
+    //  b[0] := - | r[0] |**2 / < p[0], Ap[0] > ;
+    multi1d<T> Ap;
+    if (active.size() > 0)
+      applyShifted(A, Ap, P, shifts[isz], flopcount);
+
+    std::vector<int> still_active;
+    std::vector<int> keep;
+    for(int k=0; k < active.size(); ++k)
+    {
+      int n = active[k];
+      MInvCGState_t<T>& x = st[n];
+
+      Double d = innerProductReal(P[k], Ap[k], sub);  flopcount.addSiteFlops(4*Nc*Ns,sub);
+      x.b = -x.cp/d;
+
+      /* Compute the shifted bs and z */
+      x.z[0][isz] = Double(1);
+      x.z[1][isz] = Double(1);
+      x.bs[isz] = x.b;
+      x.iz = 1;
+
+      for(int s = 0; s < n_shift; ++s)
+      {
+	if( s != isz ) {
+	  x.z[1-x.iz][s] = Double(1);
+	  x.z[x.iz][s] = Double(1) / (Double(1) - (Double(shifts[s])-Double(shifts[isz]))*x.b);
+	  x.bs[s] = x.b * x.z[x.iz][s];
+	}
+      }
+
+      //  r[1] += b[0] A . p[0];
+      x.r[sub] += Real(x.b)*Ap[k];                      flopcount.addSiteFlops(4*Nc*Ns,sub);
+
+      //  Psi[1] -= b[0] p[0] = - b[0] chi;
+      for(int s = 0; s < n_shift; ++s) {
+	psi[n][s][sub] = - Real(x.bs[s])*chi[n];        flopcount.addSiteFlops(2*Nc*Ns,sub);
+      }
+
+      //  c = |r[1]|^2
+      x.c = norm2(x.r,sub);                             flopcount.addSiteFlops(4*Nc*Ns,sub);
+
+      n_count[n] = 1;
+
+      if (! toBool( x.c < x.rsd_sq[isz] ))
+      {
+	still_active.push_back(n);
+	keep.push_back(k);
+      }
+    }
+    active.swap(still_active);
+    compactDirections(P, keep, sub);
+
+    for(int k = 1; k <= MaxCG && active.size() > 0; ++k)
+    {
+      //  p[k+1] := r[k+1] + a[k+1] p[k];
+      for(int j=0; j < active.size(); ++j)
+      {
+	MInvCGState_t<T>& x = st[active[j]];
+
+	//  a[k+1] := |r[k]|**2 / |r[k-1]|**2 ;
+	x.a = x.c/x.cp;
+
+	for(int s = 0; s < n_shift; ++s)
+	{
+	  // Always update p[isz] even if isz is converged
+	  // since the other p-s depend on it.
+	  if (s == isz)
+	  {
+	    P[j][sub] = x.r + Real(x.a)*P[j];                            flopcount.addSiteFlops(4*Nc*Ns,sub);
+	  }
+	  else if( ! x.convsP[s] )
+	  {
+	    Double as = x.a * x.z[x.iz][s]*x.bs[s] / (x.z[1-x.iz][s]*x.b);
+	    x.p[s][sub] = Real(x.z[x.iz][s])*x.r + Real(as)*x.p[s];    flopcount.addSiteFlops(6*Nc*Ns,sub);
+	  }
+	}
+
+	//  cp  =  | r[k] |**2
+	x.cp = x.c;
+      }
+
+      //  Ap = A . p  for all the active sources
+      applyShifted(A, Ap, P, shifts[isz], flopcount);
+
+      still_active.clear();
+      keep.clear();
+      for(int j=0; j < active.size(); ++j)
+      {
+	int n = active[j];
+	MInvCGState_t<T>& x = st[n];
+
+	/*  d =  < p, A.p >  */
+	Double d = innerProductReal(P[j], Ap[j], sub);                  flopcount.addSiteFlops(4*Nc*Ns,sub);
+
+	Double bp = x.b;
+	x.b = -x.cp/d;
+
+	// Compute the shifted bs and z
+	x.bs[isz] = x.b;
+	x.iz = 1 - x.iz;
+	for(int s = 0; s < n_shift; s++)
+	{
+	  if (s != isz && !x.convsP[s] )
+	  {
+	    Double z0 = x.z[1-x.iz][s];
+	    Double z1 = x.z[x.iz][s];
+	    x.z[x.iz][s] = z0*z1*bp;
+	    x.z[x.iz][s] /= x.b*x.a*(z1-z0) + z1*bp*(Double(1) - (shifts[s] - shifts[isz])*x.b);
+	    x.bs[s] = x.b*x.z[x.iz][s]/z0;
+	  }
+	}
+
+	//  r[k+1] += b[k] A . p[k] ;
+	x.r[sub] += Real(x.b)*Ap[j];                                    flopcount.addSiteFlops(4*Nc*Ns,sub);
+
+	//  Psi[k+1] -= b[k] p[k] ;
+	for(int s = 0; s < n_shift; ++s)
+	{
+	  if (! x.convsP[s] )
+	  {
+	    const T& ps = (s == isz) ? P[j] : x.p[s];
+	    psi[n][s][sub] -= Real(x.bs[s])*ps;                         flopcount.addSiteFlops(2*Nc*Ns,sub);
+	  }
+	}
+
+	//  c  =  | r[k] |**2
+	x.c = norm2(x.r,sub);                                           flopcount.addSiteFlops(4*Nc*Ns,sub);
+
+	// Check norm of shifted residuals
+	bool convP = true;
+	for(int s = 0; s < n_shift; s++)
+	{
+	  if (! x.convsP[s] )
+	  {
+	    Double css = x.c * x.z[x.iz][s]* x.z[x.iz][s];
+	    x.convsP[s] = toBool( css < x.rsd_sq[s] );
+	  }
+	  convP &= x.convsP[s];
+	}
+
+	n_count[n] = k;
+
+	if (! convP)
+	{
+	  still_active.push_back(n);
+	  keep.push_back(j);
+	}
+      }
+      active.swap(still_active);
+      compactDirections(P, keep, sub);
+    }
+
+    swatch.stop();
+
+    for(int n=0; n < n_rhs; ++n)
+      QDPIO::cout << "MInvCGMultiRHS: source " << n << ": " << n_count[n] << " iterations" << std::endl;
+    flopcount.report("minvcg_mrhs", swatch.getTimeInSeconds());
+
+    if (active.size() > 0) {
+      QDP_error_exit("too many CG iterationns: %d\n", MaxCG);
+    }
+
+    END_CODE();
+  }
+
+
+  /*! \ingroup invert */
+  template<>
+  void MInvCGMultiRHS(const LinearOperator<LatticeFermion>& A,
+		      const multi1d<LatticeFermion>& chi,
+		      multi1d< multi1d<LatticeFermion> >& psi,
+		      const multi1d<Real>& shifts,
+		      const multi1d<Real>& RsdCG,
+		      int MaxCG,
+		      multi1d<int>& n_count)
+  {
+    MInvCGMultiRHS_a(A, chi, psi, shifts, RsdCG, MaxCG, n_count);
+  }
+
+
+  /*! \ingroup invert */
+  template<>
+  void MInvCGMultiRHS(const LinearOperator<LatticeStaggeredFermion>& A,
+		      const multi1d<LatticeStaggeredFermion>& chi,
+		      multi1d< multi1d<LatticeStaggeredFermion> >& psi,
+		      const multi1d<Real>& shifts,
+		      const multi1d<Real>& RsdCG,
+		      int MaxCG,
+		      multi1d<int>& n_count)
+  {
+    MInvCGMultiRHS_a(A, chi, psi, shifts, RsdCG, MaxCG, n_count);
+  }
+
+}  // end namespace Chroma
@@ -0,0 +1,43 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Multishift Conjugate-Gradient algorithm for several right hand sides
+ */
+
+#ifndef MINVCG_MRHS_INCLUDE
+#define MINVCG_MRHS_INCLUDE
+
+#include "linearop.h"
+
+namespace Chroma
+{
+
+  //! Multishift CG for several sources at once
+  /*! \ingroup invert
+   *
+   * Solves  (A + shifts[s]) psi[n][s] = chi[n]  for all sources n and all
+   * shifts s. The sources iterate in lockstep, so each iteration applies A
+   * to all the unconverged sources in one call. An operator that overrides
+   * the multi-vector apply can then share its gauge field work between the
+   * sources. A source leaves the lockstep once all its shifts converged.
+   *
+   * \param A         Hermitian linear operator                   (Read)
+   * \param chi       sources                                      (Read)
+   * \param psi       solutions, indexed by source then shift      (Write)
+   * \param shifts    shifts of form  A + mass                     (Read)
+   * \param RsdCG     residual accuracy per shift                  (Read)
+   * \param MaxCG     maximum number of iterations                 (Read)
+   * \param n_count   number of iterations per source              (Write)
+   */
+  template<typename T>
+  void MInvCGMultiRHS(const LinearOperator<T>& A,
+		      const multi1d<T>& chi,
+		      multi1d< multi1d<T> >& psi,
+		      const multi1d<Real>& shifts,
+		      const multi1d<Real>& RsdCG,
+		      int MaxCG,
+		      multi1d<int>& n_count);
+
+}  // end namespace Chroma
+
+
+#endif
@@ -4,6 +4,7 @@
 
 #include "chromabase.h"
 #include "actions/ferm/invert/reliable_bicgstab.h"
+#include "util/info/perf_counters.h"
 
 #include "actions/ferm/invert/bicgstab_kernels.h"
 
@@ -53,6 +54,12 @@ RelInvBiCGStab_a(const LinearOperator<T>& A,
   swatch.reset();
   swatch.start();
 
+  // Per-kernel counters: one field in/out per operator application,
+  // and every field a fused reduction streams
+  const double perf_field_bytes  = PerfCounters::fieldBytes(r, s);
+  const double perf_dble_bytes   = PerfCounters::fieldBytes(tmp, s);
+  const double perf_site_flops   = double(Nc*Ns)*double(s.numSiteTable());
+
   x[s]=zero;
   p[s] = zero;
   v[s] = zero;
@@ -133,11 +140,17 @@ RelInvBiCGStab_a(const LinearOperator<T>& A,
     }
 
     // v = Ap
-    AF(v,p,isign);
+    {
+      PerfCounters::Region perf_region("linop", AF.nFlops(), 2*perf_field_bytes);
+      AF(v,p,isign);
+    }
 
     // alpha = rho_{k+1} / < r_0 | v >
     // put <r_0 | v > into tmp
-    ctmp = innerProduct(r0,v,s);
+    {
+      PerfCounters::Region perf_region("reduction", 8*perf_site_flops, 2*perf_field_bytes);
+      ctmp = innerProduct(r0,v,s);
+    }
 
     if( toBool( real(ctmp) == 0 ) && toBool( imag(ctmp) == 0 ) ) {
       QDPIO::cout << "BiCGStab breakdown: <r_0|v> = 0" << std::endl;
@@ -157,7 +170,10 @@ RelInvBiCGStab_a(const LinearOperator<T>& A,
 
 
     // t = As  = Ar 
-    AF(t,r,isign);
+    {
+      PerfCounters::Region perf_region("linop", AF.nFlops(), 2*perf_field_bytes);
+      AF(t,r,isign);
+    }
 
 
     // omega = < t | s > / < t | t > = < t | r > / norm2(t);
@@ -170,8 +186,10 @@ RelInvBiCGStab_a(const LinearOperator<T>& A,
     // Double t_norm = norm2(t,s);
     // omega = innerProduct(t,r,s);
 
-    
-    norm2x_cdotxy(t,r, t_norm, omega, s);
+    {
+      PerfCounters::Region perf_region("reduction", 12*perf_site_flops, 2*perf_field_bytes);
+      norm2x_cdotxy(t,r, t_norm, omega, s);
+    }
     
     omega /= t_norm;
 
@@ -197,7 +215,10 @@ RelInvBiCGStab_a(const LinearOperator<T>& A,
     // r_sq = norm2(r,s);
     // rho = innerProduct(r0,r,s);
 
-    xmay_normx_cdotzx(r, t, r0, omega_r, r_sq, rho,s); 
+    {
+      PerfCounters::Region perf_region("reduction", 20*perf_site_flops, 4*perf_field_bytes);
+      xmay_normx_cdotzx(r, t, r0, omega_r, r_sq, rho,s); 
+    }
 
     // Flops so far: Standard BiCGStab Flops
     // -----------------------------------------
@@ -219,7 +240,10 @@ RelInvBiCGStab_a(const LinearOperator<T>& A,
     
       x_dble[s] = x;
 
-      A(tmp, x_dble, isign); // Use full solution so far
+      {
+	PerfCounters::Region perf_region("linop", A.nFlops(), 2*perf_dble_bytes);
+	A(tmp, x_dble, isign); // Use full solution so far
+      }
 
       // Roll this together - can eliminate r_dble which is an intermediary
 	
@@ -280,6 +304,7 @@ RelInvBiCGStab_a(const LinearOperator<T>& A,
   else { 
     QDPIO::cout << "reliable_bicgstab: n_count " << ret.n_count << " r-updates: " << rupdates << " xr-updates: " << xupdates  << std::endl;
     flopcount.report("reliable_bicgstab", swatch.getTimeInSeconds());
+    PerfCounters::record("solver:reliable_bicgstab", swatch.getTimeInSeconds(), flopcount.getFlops(), 0);
   }
 
   BiCGStabKernels::finishKernels();
@@ -0,0 +1,563 @@
+/*! \file
+ *  \brief Schwarz alternating procedure on red-black coloured blocks
+ */
+
+#include "actions/ferm/invert/sap_precond.h"
+#include "util/ferm/block_subset.h"
+
+#include <map>
+#include <algorithm>
+
+namespace Chroma
+{
+
+  namespace
+  {
+    //! Colour of the block a site is in
+    class SAPColourFunc : public SetFunc
+    {
+    public:
+      SAPColourFunc(const multi1d<int>& blk) : block(blk) {}
+
+      int operator() (const multi1d<int>& coordinate) const
+      {
+	int sum = 0;
+	for(int mu=0; mu < Nd; ++mu)
+	  sum += coordinate[mu] / block[mu];
+
+	return sum % 2;
+      }
+
+      int numSubsets() const {return 2;}
+
+    private:
+      multi1d<int> block;
+    };
+
+
+    //! Parity of the coordinate in one direction
+    class SAPParityFunc : public SetFunc
+    {
+    public:
+      SAPParityFunc(int dir) : mu(dir) {}
+
+      int operator() (const multi1d<int>& coordinate) const
+      {
+	return coordinate[mu] % 2;
+      }
+
+      int numSubsets() const {return 2;}
+
+    private:
+      int mu;
+    };
+
+
+#ifndef QDP_IS_QDPJIT
+    //! Words of a fermion on one site, and colour-spin block size
+    const int nw = 2*Ns*Nc;
+    const int nm = 2*Nc;
+
+    //! Wilson hopping term in direction mu
+    /*! (1 - gamma_mu) U_mu(x) psi(x+mu) + (1 + gamma_mu) U_mu^dag(x-mu) psi(x-mu) */
+    LatticeFermion hopping(const multi1d<LatticeColorMatrix>& u, const LatticeFermion& psi, int mu)
+    {
+      LatticeFermion f = u[mu] * shift(psi, FORWARD, mu);
+      LatticeFermion b = shift(adj(u[mu]) * psi, BACKWARD, mu);
+
+      return (f - (Gamma(1 << mu) * f)) + (b + (Gamma(1 << mu) * b));
+    }
+
+
+    //! Site term on one site: two chiral blocks, spins (0,1) and (2,3)
+    inline void siteDiag(const REAL* D, const REAL* psi, double* y)
+    {
+      for(int k=0; k < 2; ++k)
+      {
+	const REAL* Dk = D + 2*nm*nm*k;
+	const REAL* p  = psi + 2*nm*k;
+	double*     yk = y + 2*nm*k;
+
+	for(int i=0; i < nm; ++i)
+	{
+	  double re = 0, im = 0;
+	  for(int j=0; j < nm; ++j)
+	  {
+	    const REAL* d = Dk + 2*(nm*i + j);
+	    re += double(d[0])*double(p[2*j])   - double(d[1])*double(p[2*j+1]);
+	    im += double(d[0])*double(p[2*j+1]) + double(d[1])*double(p[2*j]);
+	  }
+	  yk[2*i]   = re;
+	  yk[2*i+1] = im;
+	}
+      }
+    }
+
+
+    //! Arguments of the block loop
+    struct BlockArgs
+    {
+      REAL*        e;
+      REAL*        r;
+      const REAL*  u[Nd];
+      const REAL*  diag;
+      const REAL*  coef;
+      const int*   gperm;
+      const REAL*  gphase;
+      const int*   start;
+      const int*   sites;
+      const int*   nbr;
+      int          nmr;
+    };
+
+
+    //! Block operator on site j of the block list, with Dirichlet boundaries
+    inline void blockSite(const BlockArgs* a, int j, double* y)
+    {
+      const int site = a->sites[j];
+      const int nu   = 2*Nc*Nc;
+
+      siteDiag(a->diag + 4*nm*nm*site, a->r + nw*site, y);
+
+      double f[2*Ns*Nc];
+
+      for(int mu=0; mu < Nd; ++mu)
+      {
+	const double c  = a->coef[mu];
+	const int*   gp = a->gperm + Ns*mu;
+	const REAL*  gf = a->gphase + 2*Ns*mu;
+
+	for(int dir=0; dir < 2; ++dir)
+	{
+	  const int n = a->nbr[2*Nd*j + 2*mu + dir];
+	  if (n < 0)
+	    continue;
+
+	  const REAL* p = a->r + nw*n;
+
+	  // Forward  U_mu(x) psi(x+mu),  backward  U_mu^dag(x-mu) psi(x-mu)
+	  const REAL* U = a->u[mu] + nu*((dir == 0) ? site : n);
+
+	  for(int s=0; s < Ns; ++s)
+	    for(int i=0; i < Nc; ++i)
+	    {
+	      double re = 0, im = 0;
+	      for(int k=0; k < Nc; ++k)
+	      {
+		const REAL* m = (dir == 0) ? U + 2*(Nc*i + k) : U + 2*(Nc*k + i);
+		const double mi = (dir == 0) ? double(m[1]) : -double(m[1]);
+		const REAL* q = p + 2*(Nc*s + k);
+
+		re += double(m[0])*double(q[0]) - mi*double(q[1]);
+		im += double(m[0])*double(q[1]) + mi*double(q[0]);
+	      }
+	      f[2*(Nc*s + i)]   = re;
+	      f[2*(Nc*s + i)+1] = im;
+	    }
+
+	  // (1 -+ gamma_mu) f,  with  (gamma_mu f)_s = g_s f_{gp[s]}
+	  const double sg = (dir == 0) ? -1 : 1;
+
+	  for(int s=0; s < Ns; ++s)
+	  {
+	    const double g_re = sg*double(gf[2*s]);
+	    const double g_im = sg*double(gf[2*s+1]);
+	    const double* ft = f + 2*Nc*gp[s];
+
+	    for(int i=0; i < Nc; ++i)
+	    {
+	      const int w = 2*(Nc*s + i);
+	      y[w]   += c*(f[w]   + g_re*ft[2*i]   - g_im*ft[2*i+1]);
+	      y[w+1] += c*(f[w+1] + g_re*ft[2*i+1] + g_im*ft[2*i]);
+	    }
+	  }
+	}
+      }
+    }
+
+
+    //! MR steps on whole blocks, each thread doing its own blocks
+    void blockLoop(int lo, int hi, int myId, BlockArgs* a)
+    {
+      int nmax = 0;
+      for(int b=lo; b < hi; ++b)
+	nmax = std::max(nmax, a->start[b+1] - a->start[b]);
+
+      std::vector<double> Ar(nw*nmax);
+
+      for(int b=lo; b < hi; ++b)
+      {
+	const int j0 = a->start[b];
+	const int n  = a->start[b+1] - j0;
+
+	for(int it=0; it < a->nmr; ++it)
+	{
+	  for(int j=0; j < n; ++j)
+	    blockSite(a, j0 + j, &Ar[nw*j]);
+
+	  double re = 0, im = 0, nrm = 0;
+	  for(int j=0; j < n; ++j)
+	  {
+	    const double* x = &Ar[nw*j];
+	    const REAL*   y = a->r + nw*a->sites[j0 + j];
+
+	    for(int i=0; i < nw; i += 2)
+	    {
+	      re  += x[i]*double(y[i])   + x[i+1]*double(y[i+1]);
+	      im  += x[i]*double(y[i+1]) - x[i+1]*double(y[i]);
+	      nrm += x[i]*x[i] + x[i+1]*x[i+1];
+	    }
+	  }
+
+	  if (nrm == 0)
+	    break;
+
+	  const double a_re = re/nrm;
+	  const double a_im = im/nrm;
+
+	  for(int j=0; j < n; ++j)
+	  {
+	    const double* x = &Ar[nw*j];
+	    REAL* ee = a->e + nw*a->sites[j0 + j];
+	    REAL* rr = a->r + nw*a->sites[j0 + j];
+
+	    for(int i=0; i < nw; i += 2)
+	    {
+	      const double r_re = rr[i], r_im = rr[i+1];
+
+	      ee[i]   += REAL(a_re*r_re - a_im*r_im);
+	      ee[i+1] += REAL(a_re*r_im + a_im*r_re);
+	      rr[i]   -= REAL(a_re*x[i]   - a_im*x[i+1]);
+	      rr[i+1] -= REAL(a_re*x[i+1] + a_im*x[i]);
+	    }
+	  }
+	}
+      }
+    }
+#endif
+  }
+
+
+  // Constructor
+  SAPPrecond::SAPPrecond(Handle< LinearOperator<T> > A_,
+			 Handle< FermState<T,Q,Q> > state_,
+			 const multi1d<int>& block_,
+			 int ncycles_, int nmr_) :
+    A(A_), block(block_), ncycles(ncycles_), nmr(nmr_)
+  {
+    START_CODE();
+
+#ifdef QDP_IS_QDPJIT
+    QDPIO::cerr << "SAPPrecond: the block kernel is not available with QDP-JIT" << std::endl;
+    QDP_abort(1);
+#else
+    if (block.size() != Nd)
+    {
+      QDPIO::cerr << "SAPPrecond: need a block extent in each of the " << Nd << " directions" << std::endl;
+      QDP_abort(1);
+    }
+
+    if (Ns != 4 || A->subset().numSiteTable() != Layout::sitesOnNode())
+    {
+      QDPIO::cerr << "SAPPrecond: need an unpreconditioned four spinor operator" << std::endl;
+      QDP_abort(1);
+    }
+
+    const multi1d<int>& latt = Layout::lattSize();
+    const multi1d<int>& L = Layout::subgridLattSize();
+    for(int mu=0; mu < Nd; ++mu)
+    {
+      // Blocks must not be split by the node grid
+      if (block[mu] < 1 || L[mu] % block[mu] != 0)
+      {
+	QDPIO::cerr << "SAPPrecond: block extent " << block[mu]
+		    << " does not divide the node sub-lattice extent " << L[mu]
+		    << " in direction " << mu << std::endl;
+	QDP_abort(1);
+      }
+
+      // Blocks of the same colour must not touch across the boundary
+      int nb = latt[mu] / block[mu];
+      if (nb > 1 && nb % 2 != 0)
+      {
+	QDPIO::cerr << "SAPPrecond: need an even number of blocks in direction " << mu
+		    << ", have " << nb << std::endl;
+	QDP_abort(1);
+      }
+    }
+
+    colour_set.make(SAPColourFunc(block));
+    u = state_->getLinks();
+
+    probe();
+
+    // Node local block lists of each colour
+    BlockFunc block_func(block);
+    SAPColourFunc colour_func(block);
+
+    std::map<int,int> lblock[2];
+    std::vector< std::vector<int> > sites[2];
+
+    for(int site=0; site < Layout::sitesOnNode(); ++site)
+    {
+      multi1d<int> coord = Layout::siteCoords(Layout::nodeNumber(), site);
+      int c = colour_func(coord);
+      int b = block_func(coord);
+
+      std::map<int,int>::iterator it = lblock[c].find(b);
+      if (it == lblock[c].end())
+      {
+	it = lblock[c].insert(std::make_pair(b, int(sites[c].size()))).first;
+	sites[c].push_back(std::vector<int>());
+      }
+
+      sites[c][it->second].push_back(site);
+    }
+
+    for(int c=0; c < 2; ++c)
+    {
+      block_start[c].assign(1, 0);
+      block_site[c].clear();
+
+      for(int b=0; b < sites[c].size(); ++b)
+      {
+	block_site[c].insert(block_site[c].end(), sites[c][b].begin(), sites[c][b].end());
+	block_start[c].push_back(block_site[c].size());
+      }
+
+      // Neighbours in the same block; these are on the node
+      block_nbr[c].assign(2*Nd*block_site[c].size(), -1);
+
+      for(int j=0; j < block_site[c].size(); ++j)
+      {
+	multi1d<int> coord = Layout::siteCoords(Layout::nodeNumber(), block_site[c][j]);
+	int b = block_func(coord);
+
+	for(int mu=0; mu < Nd; ++mu)
+	  for(int dir=0; dir < 2; ++dir)
+	  {
+	    multi1d<int> x = coord;
+	    x[mu] = (x[mu] + ((dir == 0) ? 1 : latt[mu]-1)) % latt[mu];
+
+	    if (block_func(x) == b)
+	      block_nbr[c][2*Nd*j + 2*mu + dir] = Layout::linearSiteIndex(x);
+	  }
+      }
+    }
+
+    QDPIO::cout << "SAPPrecond: " << block_start[0].size() + block_start[1].size() - 2
+		<< " node local blocks of";
+    for(int mu=0; mu < Nd; ++mu)
+      QDPIO::cout << " " << block[mu];
+    QDPIO::cout << ", hopping coefficients";
+    for(int mu=0; mu < Nd; ++mu)
+      QDPIO::cout << " " << coef[mu];
+    QDPIO::cout << std::endl;
+#endif
+
+    END_CODE();
+  }
+
+
+  /*! The site terms come from A on unit vectors on one checkerboard,
+   *  where the neighbours do not contribute. The hopping coefficient in
+   *  direction mu comes from A on a field that vanishes on odd x_mu: on
+   *  the odd sites only the mu hopping term is left. The model is then
+   *  checked against A on a random field.
+   */
+  void SAPPrecond::probe()
+  {
+#ifndef QDP_IS_QDPJIT
+    const int vol = Layout::sitesOnNode();
+
+    // Gamma matrices: one entry per row
+    gperm.assign(Nd*Ns, 0);
+    gphase.assign(2*Nd*Ns, 0);
+
+    for(int mu=0; mu < Nd; ++mu)
+      for(int t=0; t < Ns; ++t)
+      {
+	T p = zero;
+	((REAL*)&(p.elem(0)))[2*Nc*t] = 1;
+
+	T q = Gamma(1 << mu) * p;
+	const REAL* qs = (const REAL*)&(q.elem(0));
+
+	for(int s=0; s < Ns; ++s)
+	  if (qs[2*Nc*s] != 0 || qs[2*Nc*s+1] != 0)
+	  {
+	    gperm[Ns*mu + s] = t;
+	    gphase[2*(Ns*mu + s)]   = qs[2*Nc*s];
+	    gphase[2*(Ns*mu + s)+1] = qs[2*Nc*s+1];
+	  }
+      }
+
+    // Site terms, column by column
+    diag.assign(4*nm*nm*vol, 0);
+
+    for(int cb=0; cb < rb.numSubsets(); ++cb)
+    {
+      const int* tab = rb[cb].siteTable().slice();
+      const int  n   = rb[cb].numSiteTable();
+
+      for(int col=0; col < nw/2; ++col)
+      {
+	T p = zero;
+	for(int j=0; j < n; ++j)
+	  ((REAL*)&(p.elem(tab[j])))[2*col] = 1;
+
+	T q;
+	(*A)(q, p, PLUS);
+
+	const int k  = col / nm;
+	const int jj = col % nm;
+
+	for(int j=0; j < n; ++j)
+	{
+	  const REAL* qs = (const REAL*)&(q.elem(tab[j]));
+	  REAL* D = &diag[4*nm*nm*tab[j] + 2*nm*nm*k];
+
+	  for(int i=0; i < nm; ++i)
+	  {
+	    D[2*(nm*i + jj)]   = qs[2*(nm*k + i)];
+	    D[2*(nm*i + jj)+1] = qs[2*(nm*k + i)+1];
+	  }
+	}
+      }
+    }
+
+    Seed ran_seed;
+    QDP::RNG::savern(ran_seed);
+
+    // Hopping coefficients
+    const multi1d<int>& latt = Layout::lattSize();
+    coef.assign(Nd, 0);
+
+    for(int mu=0; mu < Nd; ++mu)
+    {
+      if (latt[mu] % 2 != 0)
+      {
+	QDPIO::cerr << "SAPPrecond: need an even lattice extent in direction " << mu << std::endl;
+	QDP_abort(1);
+      }
+
+      Set parity;
+      parity.make(SAPParityFunc(mu));
+
+      T g;
+      gaussian(g);
+
+      T p = zero;
+      p[parity[0]] = g;
+
+      T q;
+      (*A)(q, p, PLUS);
+
+      T h = hopping(u, p, mu);
+      coef[mu] = toDouble(real(innerProduct(h, q, parity[1])) / norm2(h, parity[1]));
+    }
+
+    // Check the model against A
+    T p;
+    gaussian(p);
+
+    QDP::RNG::setrn(ran_seed);
+
+    T q;
+    (*A)(q, p, PLUS);
+
+    T m = zero;
+    for(int site=0; site < vol; ++site)
+    {
+      double y[nw];
+      siteDiag(&diag[4*nm*nm*site], (const REAL*)&(p.elem(site)), y);
+
+      REAL* ms = (REAL*)&(m.elem(site));
+      for(int i=0; i < nw; ++i)
+	ms[i] = y[i];
+    }
+
+    for(int mu=0; mu < Nd; ++mu)
+      m += Real(coef[mu]) * hopping(u, p, mu);
+
+    const double tol = (sizeof(REAL) == sizeof(float)) ? 1e-5 : 1e-10;
+    const double dev = toDouble(sqrt(norm2(q - m) / norm2(q)));
+
+    if (dev > tol)
+    {
+      QDPIO::cerr << "SAPPrecond: the operator is not a site term plus Wilson hopping terms"
+		  << " (relative deviation " << dev << "); it must be an unpreconditioned"
+		  << " Wilson or clover operator" << std::endl;
+      QDP_abort(1);
+    }
+#endif
+  }
+
+
+  // Dirichlet block solves
+  void SAPPrecond::blockSolve(T& e, T& r, int c) const
+  {
+#ifndef QDP_IS_QDPJIT
+    BlockArgs a;
+    a.e = (REAL*)&(e.elem(0));
+    a.r = (REAL*)&(r.elem(0));
+    for(int mu=0; mu < Nd; ++mu)
+      a.u[mu] = (const REAL*)&(u[mu].elem(0));
+    a.diag   = &diag[0];
+    a.coef   = &coef[0];
+    a.gperm  = &gperm[0];
+    a.gphase = &gphase[0];
+    a.start  = &block_start[c][0];
+    a.sites  = (block_site[c].size() > 0) ? &block_site[c][0] : 0;
+    a.nbr    = (block_nbr[c].size() > 0) ? &block_nbr[c][0] : 0;
+    a.nmr    = nmr;
+
+    dispatch_to_threads(int(block_start[c].size()) - 1, a, blockLoop);
+#endif
+  }
+
+
+  /*! Schwarz sweeps
+   *
+   *  With P_c the restriction to the blocks of colour c, each half sweep
+   *  does
+   *
+   *    e ~ (P_c A P_c)^{-1} P_c r,   x += e,   r -= A e
+   *
+   *  by  nmr  MR steps on each block. The block kernel leaves the block
+   *  residua in r on colour c, so A e is only needed for the other
+   *  colour, one application of A per half sweep. The sweep starts from
+   *  x = 0, so r = v.
+   */
+  void SAPPrecond::operator()(T& x, const T& v) const
+  {
+    START_CODE();
+
+    T r   = v;
+    T e   = zero;
+    T tmp = zero;
+
+    x = zero;
+
+    for(int cycle=0; cycle < ncycles; ++cycle)
+    {
+      for(int c=0; c < 2; ++c)
+      {
+	e = zero;
+	blockSolve(e, r, c);
+
+	x += e;
+
+	// The residuum is not needed after the last half sweep
+	if (cycle < ncycles-1 || c == 0)
+	{
+	  (*A)(tmp, e, PLUS);
+	  r[colour_set[1-c]] -= tmp;
+	}
+      }
+    }
+
+    END_CODE();
+  }
+
+} // End namespace
@@ -0,0 +1,102 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Schwarz alternating procedure on red-black coloured blocks
+ */
+
+#ifndef __sap_precond_h__
+#define __sap_precond_h__
+
+#include "chromabase.h"
+#include "handle.h"
+#include "state.h"
+#include "linearop.h"
+
+#include <vector>
+
+namespace Chroma
+{
+
+  //! Multiplicative Schwarz preconditioner on lattice blocks
+  /*! \ingroup invert
+   *
+   * The lattice is cut into blocks (the BlockFunc blocks of
+   * block_subset.h), coloured black and white like a chess board of
+   * blocks. Blocks of one colour do not couple to each other, so a
+   * sweep solves all black blocks, updates the residuum, and then all
+   * white blocks (Luscher, Comput. Phys. Commun. 165, 2005).
+   *
+   * The block problems have Dirichlet boundaries, and each is solved
+   * approximately by a few MR steps with its own coefficients. They run
+   * on a site-local kernel: the site term of the operator plus the
+   * Wilson hopping terms to neighbours in the same block. The blocks
+   * must lie within the node sub-lattice, so the block solves need no
+   * communication at all. The only halo exchange is the update of the
+   * residuum on the other colour after each half sweep.
+   *
+   * The operator must be an unpreconditioned Wilson type operator, i.e.
+   * a site term plus  -1/2 c_mu (1 -+ gamma_mu) U  hopping terms. The
+   * site terms and the c_mu are read off the operator when the
+   * preconditioner is made, and the result is checked against it.
+   *
+   * The approximate inverse changes with its argument, so it must be
+   * used with a flexible outer solver.
+   */
+  class SAPPrecond
+  {
+  public:
+    using T = LatticeFermion;
+    using U = LatticeColorMatrix;
+    using Q = multi1d<U>;
+
+    //! Constructor
+    /*!
+     * \param A_        Linear operator ( Read )
+     * \param state_    gauge field of the operator ( Read )
+     * \param block_    block extent in each direction ( Read )
+     * \param ncycles_  number of Schwarz sweeps ( Read )
+     * \param nmr_      MR steps on each block ( Read )
+     */
+    SAPPrecond(Handle< LinearOperator<T> > A_,
+	       Handle< FermState<T,Q,Q> > state_,
+	       const multi1d<int>& block_,
+	       int ncycles_, int nmr_);
+
+    //! Approximate solution of A x = v
+    void operator()(T& x, const T& v) const;
+
+  private:
+    //! Hide default constructor
+    SAPPrecond() {}
+
+    //! Read the site terms and hopping coefficients off the operator
+    void probe();
+
+    //! Dirichlet block solves on all blocks of colour c
+    /*! e gets the corrections, r on the blocks is replaced by the block residua */
+    void blockSolve(T& e, T& r, int c) const;
+
+    Handle< LinearOperator<T> > A;
+    multi1d<int>  block;
+    int           ncycles;
+    int           nmr;
+
+    Set           colour_set;  /*!< the two block colours */
+    Q             u;           /*!< links, with the boundary conditions */
+
+    std::vector<REAL>  diag;   /*!< site term, two chiral (2Nc)x(2Nc) blocks per site */
+    std::vector<REAL>  coef;   /*!< hopping coefficient  -c_mu/2  */
+    std::vector<int>   gperm;  /*!< gamma_mu: row s has its entry in column gperm[mu*Ns+s] */
+    std::vector<REAL>  gphase; /*!< ... which is gphase[2*(mu*Ns+s)] + i gphase[2*(mu*Ns+s)+1] */
+
+    // Node local blocks of each colour: sites of block b are
+    // block_site[c][block_start[c][b] .. block_start[c][b+1]-1], and
+    // block_nbr[c][2*Nd*j + 2*mu + {0,1}] is the forward and backward
+    // neighbour of block_site[c][j], or -1 outside its block
+    std::vector<int>  block_start[2];
+    std::vector<int>  block_site[2];
+    std::vector<int>  block_nbr[2];
+  };
+
+} // End namespace
+
+#endif
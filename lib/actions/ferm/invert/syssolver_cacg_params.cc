@@ -0,0 +1,56 @@
+/*! \file
+ *  \brief Params of the pipelined and s-step CG inverters
+ */
+
+#include "actions/ferm/invert/syssolver_cacg_params.h"
+
+namespace Chroma
+{
+
+  // Read parameters
+  void read(XMLReader& xml, const std::string& path, SysSolverCACGParams& param)
+  {
+    XMLReader paramtop(xml, path);
+
+    read(paramtop, "RsdCG", param.RsdCG);
+    read(paramtop, "MaxCG", param.MaxCG);
+
+    if( paramtop.count("SStep") > 0 ) { 
+      read(paramtop, "SStep", param.SStep);
+    }
+
+    if( paramtop.count("ReplaceInterval") > 0 ) { 
+      read(paramtop, "ReplaceInterval", param.ReplaceInterval);
+    }
+  }
+
+  // Writer parameters
+  void write(XMLWriter& xml, const std::string& path, const SysSolverCACGParams& param)
+  {
+    push(xml, path);
+
+    write(xml, "RsdCG", param.RsdCG);
+    write(xml, "MaxCG", param.MaxCG);
+    write(xml, "SStep", param.SStep);
+    write(xml, "ReplaceInterval", param.ReplaceInterval);
+    pop(xml);
+  }
+
+  //! Default constructor
+  SysSolverCACGParams::SysSolverCACGParams()
+  {
+    RsdCG = zero;
+    MaxCG = 0;
+    SStep = 4;
+    ReplaceInterval = 100;
+  }
+
+  //! Read parameters
+  SysSolverCACGParams::SysSolverCACGParams(XMLReader& xml, const std::string& path)
+  {
+    SStep = 4;
+    ReplaceInterval = 100;
+    read(xml, path, *this);
+  }
+
+}
@@ -0,0 +1,40 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Params of the GCRO-DR recycling solver
+ */
+
+#ifndef __syssolver_gcrodr_params_h__
+#define __syssolver_gcrodr_params_h__
+
+#include "chromabase.h"
+
+namespace Chroma
+{
+
+  //! Params for GCRODR inverter
+  /*! \ingroup invert */
+  struct SysSolverGCRODRParams
+  {
+    SysSolverGCRODRParams();
+    SysSolverGCRODRParams(XMLReader& in, const std::string& path);
+    
+    Real          RsdTarget;           /*!< Target Residuum */
+    int           NKrylov;             /*!< Number of new vectors in a cycle */
+    int           NDefl;               /*!< Dimension of the recycled subspace */
+    int           MaxIter;             /*!< Total Number of Iterations */
+    int           RefreshInterval;     /*!< Update the subspace every this many solves, 0 to freeze it once built */
+    bool          RefreshEveryCycle;   /*!< Update it after every cycle of such a solve, not only the last */
+  };
+
+
+  // Reader/writers
+  /*! \ingroup invert */
+  void read(XMLReader& xml, const std::string& path, SysSolverGCRODRParams& param);
+
+  /*! \ingroup invert */
+  void write(XMLWriter& xml, const std::string& path, const SysSolverGCRODRParams& param);
+
+} // End namespace
+
+#endif 
+
@@ -6,6 +6,7 @@
 #include "actions/ferm/invert/syssolver_linop_aggregate.h"
 
 #include "actions/ferm/invert/syssolver_linop_cg.h"
+#include "actions/ferm/invert/syssolver_linop_cacg.h"
 #include "actions/ferm/invert/syssolver_linop_bicgstab.h"
 #include "actions/ferm/invert/syssolver_linop_ibicgstab.h"
 #include "actions/ferm/invert/syssolver_linop_bicrstab.h"
@@ -18,6 +19,9 @@
 #include "actions/ferm/invert/syssolver_linop_rel_ibicgstab_clover.h"
 #include "actions/ferm/invert/syssolver_linop_rel_cg_clover.h"
 #include "actions/ferm/invert/syssolver_linop_fgmres_dr.h"
+#include "actions/ferm/invert/syssolver_linop_gcrodr.h"
+#include "actions/ferm/invert/syssolver_linop_sap_gcr.h"
+#include "actions/ferm/invert/amg/syssolver_linop_amg.h"
 
 
 #include "chroma_config.h"
@@ -70,6 +74,7 @@ namespace Chroma
       {
 	// 4D system solvers
 	success &= LinOpSysSolverCGEnv::registerAll();
+	success &= LinOpSysSolverCACGEnv::registerAll();
 	success &= LinOpSysSolverBiCGStabEnv::registerAll();
 	success &= LinOpSysSolverBiCRStabEnv::registerAll();
 	success &= LinOpSysSolverIBiCGStabEnv::registerAll();
@@ -82,6 +87,9 @@ namespace Chroma
 	success &= LinOpSysSolverReliableIBiCGStabCloverEnv::registerAll();
 	success &= LinOpSysSolverReliableCGCloverEnv::registerAll();
 	success &= LinOpSysSolverFGMRESDREnv::registerAll();
+	success &= LinOpSysSolverGCRODREnv::registerAll();
+	success &= LinOpSysSolverSAPGCREnv::registerAll();
+	success &= LinOpSysSolverAMGEnv::registerAll();
 
 #ifdef BUILD_QUDA
 	success &= LinOpSysSolverQUDACloverEnv::registerAll();
@@ -0,0 +1,83 @@
+/*! \file
+ *  \brief Solve a M*psi=chi linear system by pipelined or s-step CG
+ */
+#include "state.h"
+#include "actions/ferm/invert/syssolver_linop_factory.h"
+#include "actions/ferm/invert/syssolver_linop_aggregate.h"
+
+#include "actions/ferm/invert/syssolver_linop_cacg.h"
+
+namespace Chroma
+{
+
+  //! Pipelined and s-step CG system solver namespace
+  namespace LinOpSysSolverCACGEnv
+  {
+    //! Anonymous namespace
+    namespace
+    {
+      //! Names to be used
+      const std::string pipelined_name("PIPELINED_CG_INVERTER");
+      const std::string sstep_name("SSTEP_CG_INVERTER");
+
+      //! Local registration flag
+      bool registered = false;
+    }
+
+
+    //! Callback function
+    LinOpSystemSolver<LatticeFermion>* createPipelinedFerm(XMLReader& xml_in,
+							   const std::string& path,
+							   Handle< FermState< LatticeFermion, multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> > > state, 
+							   Handle< LinearOperator<LatticeFermion> > A)
+    {
+      return new LinOpSysSolverCACG<LatticeFermion>(A, SysSolverCACGParams(xml_in, path),
+						    LinOpSysSolverCACG<LatticeFermion>::PIPELINED);
+    }
+
+    //! Callback function
+    LinOpSystemSolver<LatticeFermionF>* createPipelinedFermF(XMLReader& xml_in,
+							     const std::string& path,
+							     Handle< FermState< LatticeFermionF, multi1d<LatticeColorMatrixF>, multi1d<LatticeColorMatrixF> > > state, 
+							     Handle< LinearOperator<LatticeFermionF> > A)
+    {
+      return new LinOpSysSolverCACG<LatticeFermionF>(A, SysSolverCACGParams(xml_in, path),
+						     LinOpSysSolverCACG<LatticeFermionF>::PIPELINED);
+    }
+
+    //! Callback function
+    LinOpSystemSolver<LatticeFermion>* createSStepFerm(XMLReader& xml_in,
+						       const std::string& path,
+						       Handle< FermState< LatticeFermion, multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> > > state, 
+						       Handle< LinearOperator<LatticeFermion> > A)
+    {
+      return new LinOpSysSolverCACG<LatticeFermion>(A, SysSolverCACGParams(xml_in, path),
+						    LinOpSysSolverCACG<LatticeFermion>::SSTEP);
+    }
+
+    //! Callback function
+    LinOpSystemSolver<LatticeFermionF>* createSStepFermF(XMLReader& xml_in,
+							 const std::string& path,
+							 Handle< FermState< LatticeFermionF, multi1d<LatticeColorMatrixF>, multi1d<LatticeColorMatrixF> > > state, 
+							 Handle< LinearOperator<LatticeFermionF> > A)
+    {
+      return new LinOpSysSolverCACG<LatticeFermionF>(A, SysSolverCACGParams(xml_in, path),
+						     LinOpSysSolverCACG<LatticeFermionF>::SSTEP);
+    }
+
+    //! Register all the factories
+    bool registerAll() 
+    {
+      bool success = true; 
+      if (! registered)
+      {
+	success &= Chroma::TheLinOpFermSystemSolverFactory::Instance().registerObject(pipelined_name, createPipelinedFerm);
+	success &= Chroma::TheLinOpFFermSystemSolverFactory::Instance().registerObject(pipelined_name, createPipelinedFermF);
+	success &= Chroma::TheLinOpFermSystemSolverFactory::Instance().registerObject(sstep_name, createSStepFerm);
+	success &= Chroma::TheLinOpFFermSystemSolverFactory::Instance().registerObject(sstep_name, createSStepFermF);
+	registered = true;
+      }
+      return success;
+    }
+  }
+}
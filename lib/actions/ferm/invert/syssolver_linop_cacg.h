@@ -0,0 +1,114 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Solve a M*psi=chi linear system by pipelined or s-step CG
+ */
+
+#ifndef __syssolver_linop_cacg_h__
+#define __syssolver_linop_cacg_h__
+#include "chroma_config.h"
+#include "handle.h"
+#include "syssolver.h"
+#include "linearop.h"
+#include "actions/ferm/invert/syssolver_linop.h"
+#include "actions/ferm/invert/syssolver_cacg_params.h"
+#include "actions/ferm/invert/invcg_pipelined.h"
+#include "actions/ferm/invert/invcg_sstep.h"
+
+
+namespace Chroma
+{
+
+  //! Pipelined and s-step CG system solver namespace
+  namespace LinOpSysSolverCACGEnv
+  {
+    //! Register the syssolver
+    bool registerAll();
+  }
+
+
+  //! Solve a M*psi=chi linear system by CGNE with fewer global reductions
+  /*! \ingroup invert
+   *
+   * Like LinOpSysSolverCG, but with the pipelined CG (one reduction per
+   * iteration) or the s-step CG (one reduction per s iterations).
+   */
+  template<typename T>
+  class LinOpSysSolverCACG : public LinOpSystemSolver<T>
+  {
+  public:
+    //! Which algorithm
+    enum Variant_t {PIPELINED, SSTEP};
+
+    //! Constructor
+    /*!
+     * \param A_        Linear operator ( Read )
+     * \param invParam  inverter parameters ( Read )
+     * \param variant_  pipelined or s-step ( Read )
+     */
+    LinOpSysSolverCACG(Handle< LinearOperator<T> > A_,
+		       const SysSolverCACGParams& invParam_,
+		       Variant_t variant_) : 
+      A(A_), invParam(invParam_), variant(variant_)
+      {}
+
+    //! Destructor is automatic
+    ~LinOpSysSolverCACG() {}
+
+    //! Return the subset on which the operator acts
+    const Subset& subset() const {return A->subset();}
+
+    //! Solver the linear system
+    /*!
+     * \param psi      solution ( Modify )
+     * \param chi      source ( Read )
+     * \return syssolver results
+     */
+    SystemSolverResults_t operator() (T& psi, const T& chi) const
+      {
+	START_CODE();	
+	SystemSolverResults_t res;  // initialized by a constructor
+	StopWatch swatch;
+	swatch.reset();
+	swatch.start();
+
+	T chi_tmp;
+	(*A)(chi_tmp, chi, MINUS);
+
+	if (variant == PIPELINED)
+	  res = InvCGPipelined(*A, chi_tmp, psi, invParam.RsdCG, invParam.MaxCG, invParam.ReplaceInterval);
+	else
+	  res = InvCGSStep(*A, chi_tmp, psi, invParam.RsdCG, invParam.MaxCG, invParam.SStep, invParam.ReplaceInterval);
+
+	swatch.stop();
+	double time = swatch.getTimeInSeconds();
+
+	{ 
+	  T r;
+	  r[A->subset()]=chi;
+	  T tmp;
+	  (*A)(tmp, psi, PLUS);
+	  r[A->subset()] -= tmp;
+	  res.resid = sqrt(norm2(r, A->subset()));
+	}
+	QDPIO::cout << "CACG_SOLVER: " << res.n_count << " iterations. Rsd = " << res.resid << " Relative Rsd = " << res.resid/sqrt(norm2(chi,A->subset())) << std::endl;
+	QDPIO::cout << "CACG_SOLVER_TIME: "<<time<< " sec" << std::endl;
+
+	END_CODE();
+
+	return res;
+      }
+
+
+  private:
+    // Hide default constructor
+    LinOpSysSolverCACG() {}
+
+    Handle< LinearOperator<T> > A;
+    SysSolverCACGParams invParam;
+    Variant_t variant;
+  };
+
+} // End namespace
+
+#endif 
+
@@ -0,0 +1,477 @@
+/*! \file
+ *  \brief Solve a sequence of M*psi=chi linear systems by GCRO-DR
+ */
+#include <algorithm>
+#include <vector>
+#include "chromabase.h"
+#include "qdp-lapack.h"
+#include "actions/ferm/invert/syssolver_linop_factory.h"
+#include "actions/ferm/invert/syssolver_linop_aggregate.h"
+
+#include "actions/ferm/invert/syssolver_linop_gcrodr.h"
+
+namespace Chroma
+{
+
+  //! GCRODR system solver namespace
+  namespace LinOpSysSolverGCRODREnv
+  {
+    //! Callback function
+    LinOpSystemSolver<LatticeFermion>* createFerm(XMLReader& xml_in,
+						  const std::string& path,
+						  Handle< FermState< LatticeFermion, multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> > > state,
+						  Handle< LinearOperator<LatticeFermion> > A)
+    {
+      return new LinOpSysSolverGCRODR(A, state, SysSolverGCRODRParams(xml_in, path));
+    }
+
+
+    //! Name to be used
+    const std::string name("GCRODR_INVERTER");
+
+    //! Local registration flag
+    static bool registered = false;
+
+    //! Register all the factories
+    bool registerAll()
+    {
+      bool success = true;
+      if (! registered)
+      {
+	success &= Chroma::TheLinOpFermSystemSolverFactory::Instance().registerObject(name, createFerm);
+	registered = true;
+      }
+      return success;
+    }
+  }
+
+
+  /*! Initialize the cycle workspace (resize and zero)
+   *  The recycled space starts empty.
+   */
+  void LinOpSysSolverGCRODR::InitMatrices()
+  {
+    int n_krylov = invParam_.NKrylov;
+    int n_defl   = invParam_.NDefl;
+
+    // Matrices are (n_cols, n_rows) as for LAPACK
+    H_.resize(n_krylov, n_krylov+1);
+    R_.resize(n_krylov, n_krylov+1);
+    B_.resize(n_krylov, (n_defl > 0) ? n_defl : 1);
+
+    V_.resize(n_krylov+1);
+    givens_rots_.resize(n_krylov+1);
+    g_.resize(n_krylov+1);
+    eta_.resize(n_krylov);
+
+    U_.resize(0);
+    C_.resize(0);
+  }
+
+
+  /*! Remove the part of the residuum in span C
+   *
+   *  Since A U = C, this is the minimal residual correction
+   *  from the recycled space:
+   *
+   *    psi += U C^dag r,   r -= C C^dag r
+   */
+  void LinOpSysSolverGCRODR::Project(T& psi, T& r) const
+  {
+    const Subset& s = A_->subset();
+
+    for(int i=0; i < C_.size(); ++i) {
+      DComplex a = innerProduct(C_[i], r, s);
+      psi[s] += a*U_[i];
+      r[s] -= a*C_[i];
+    }
+  }
+
+
+  /*! Arnoldi process for (1 - C C^dag) A
+   *
+   *  Starts from V_0 = r / || r ||, with r orthogonal to C. Produces
+   *
+   *    A V_j = C B_j + V_{j+1} H_j
+   *
+   *  and reduces H to R with Givens rotations on the way, so that
+   *  |g_{j+1}| is the residuum of the cycle so far.
+   *
+   * \param n_krylov   maximum number of new vectors
+   * \param dim        number of new vectors made ( Write )
+   * \param breakdown  A V_{dim-1} lies in the spaces already made ( Write )
+   */
+  void LinOpSysSolverGCRODR::Arnoldi(int n_krylov,
+				     const T& r,
+				     const Double& r_norm,
+				     const Double& target,
+				     int& dim,
+				     bool& breakdown) const
+  {
+    const Subset& s = A_->subset();
+    const int k = C_.size();
+
+    for(int col=0; col < H_.size2(); ++col) {
+      for(int row=0; row < H_.size1(); ++row) {
+	H_(col,row) = zero;
+	R_(col,row) = zero;
+      }
+      for(int row=0; row < B_.size1(); ++row) {
+	B_(col,row) = zero;
+      }
+    }
+    for(int row=0; row < g_.size(); ++row) {
+      g_[row] = zero;
+    }
+    g_[0] = r_norm;
+
+    Double beta_inv = Double(1)/r_norm;
+    V_[0][s] = beta_inv * r;
+
+    dim = 0;
+    breakdown = false;
+
+    for(int j=0; j < n_krylov; ++j) {
+      T w;
+      (*A_)(w, V_[j], PLUS);
+
+      // Orthogonalize against the recycled space...
+      for(int i=0; i < k; ++i) {
+	B_(j,i) = innerProduct(C_[i], w, s);
+	w[s] -= B_(j,i)*C_[i];
+      }
+
+      // ... and then against the basis of this cycle
+      for(int i=0; i <= j; ++i) {
+	H_(j,i) = innerProduct(V_[i], w, s);
+	w[s] -= H_(j,i)*V_[i];
+      }
+
+      Double wnorm = sqrt(norm2(w,s));
+      H_(j,j+1) = DComplex(wnorm);
+
+      // Update R with the old and one new rotation
+      for(int i=0; i <= j+1; ++i) {
+	R_(j,i) = H_(j,i);
+      }
+      for(int i=0; i < j; ++i) {
+	(*givens_rots_[i])(j,R_);
+      }
+      givens_rots_[j] = new Givens(j,R_);
+      (*givens_rots_[j])(j,R_);
+      (*givens_rots_[j])(g_);
+
+      dim = j+1;
+
+      Double accum_resid = sqrt(norm2(g_[j+1]));
+      QDPIO::cout << "GCRODR: Iter " << dim << " || r || = " << accum_resid << " Target=" << target << std::endl;
+
+      if ( toBool( wnorm <= Double(1.0e-14)*r_norm ) ) {
+	// Nothing new: the cycle solves the system exactly
+	breakdown = true;
+	return;
+      }
+
+      Double invwnorm = Double(1)/wnorm;
+      V_[j+1][s] = invwnorm*w;
+
+      if ( toBool( accum_resid <= target ) ) {
+	return;
+      }
+    }
+  }
+
+
+  /*! Solve  R eta = g  by back substitution
+   *
+   *  R is the Givens rotated H of the cycle, so eta minimizes
+   *  || || r || e_0 - H eta ||.
+   */
+  void LinOpSysSolverGCRODR::LeastSquaresSolve(int dim) const
+  {
+    eta_[dim-1] = g_[dim-1]/R_(dim-1,dim-1);
+    for(int row = dim-2; row >= 0; --row) {
+      eta_[row] = g_[row];
+      for(int col=row+1; col < dim; ++col) {
+	eta_[row] -= R_(col,row)*eta_[col];
+      }
+      eta_[row] /= R_(row,row);
+    }
+  }
+
+
+  /*! Update the recycled space
+   *
+   *  With W = [ U | V_0 .. V_{dim-1} ] and What = [ C | V_0 .. V_dim ]
+   *  we have A W = What G, where
+   *
+   *    G = [ 1  B ]
+   *        [ 0  H ]
+   *
+   *  The harmonic Ritz pairs of A on span W solve
+   *
+   *    G^dag G z = theta G^dag What^dag W z
+   *
+   *  From the NDefl of smallest |theta|, P = [ z_1 .. z_k ]:
+   *  G P = Q R gives the new C = What Q, orthonormal, and U = W P R^{-1},
+   *  so that again A U = C.
+   *
+   *  NB: as in FGMRES-DR, zgetrf/zgetrs bring this to a standard
+   *  eigenproblem for zgeev.
+   */
+  void LinOpSysSolverGCRODR::Refresh(int dim) const
+  {
+    const Subset& s = A_->subset();
+    const int k     = C_.size();
+    const int n     = k + dim;
+    const int k_new = std::min(invParam_.NDefl, n);
+
+    // G, (n+1) rows and n columns, stored (col,row)
+    multi2d<DComplex> G(n, n+1);
+    multi2d<DComplex> S(n, n+1);  // What^dag W
+    for(int col=0; col < n; ++col) {
+      for(int row=0; row < n+1; ++row) {
+	G(col,row) = zero;
+	S(col,row) = zero;
+      }
+    }
+
+    for(int i=0; i < k; ++i) {
+      G(i,i) = Double(1);
+    }
+    for(int j=0; j < dim; ++j) {
+      for(int i=0; i < k; ++i) {
+	G(k+j,i) = B_(j,i);
+      }
+      for(int i=0; i <= j+1; ++i) {
+	G(k+j,k+i) = H_(j,i);
+      }
+    }
+
+    // The V are orthonormal and orthogonal to C, U is neither
+    for(int l=0; l < k; ++l) {
+      for(int i=0; i < k; ++i) {
+	S(l,i) = innerProduct(C_[i], U_[l], s);
+      }
+      for(int i=0; i <= dim; ++i) {
+	S(l,k+i) = innerProduct(V_[i], U_[l], s);
+      }
+    }
+    for(int j=0; j < dim; ++j) {
+      S(k+j,k+j) = Double(1);
+    }
+
+    // M1 = G^dag G,  M2 = G^dag S
+    multi2d<DComplex> M1(n,n);
+    multi2d<DComplex> M2(n,n);
+    for(int col=0; col < n; ++col) {
+      for(int row=0; row < n; ++row) {
+	M1(col,row) = zero;
+	M2(col,row) = zero;
+	for(int i=0; i < n+1; ++i) {
+	  M1(col,row) += conj(G(row,i))*G(col,i);
+	  M2(col,row) += conj(G(row,i))*S(col,i);
+	}
+      }
+    }
+
+    // E = M2^{-1} M1
+    multi1d<int> ipiv(n);
+    int info;
+    QDPLapack::zgetrf(n,n,M2,n,ipiv,info);
+    if (info != 0) {
+      QDPIO::cout << "GCRODR: ZGETRF reported failure: info=" << info << ", recycled space not updated" << std::endl;
+      return;
+    }
+
+    multi2d<DComplex> E(n,n);
+    for(int col=0; col < n; ++col) {
+      multi1d<DComplex> x(n);
+      for(int row=0; row < n; ++row) {
+	x[row] = M1(col,row);
+      }
+
+      char trans='N';
+      QDPLapack::zgetrs(trans,n,1,M2,n,ipiv,x,n,info);
+      if (info != 0) {
+	QDPIO::cout << "GCRODR: ZGETRS reported failure: info=" << info << ", recycled space not updated" << std::endl;
+	return;
+      }
+
+      for(int row=0; row < n; ++row) {
+	E(col,row) = x[row];
+      }
+    }
+
+    multi1d<DComplex> evals(n);
+    multi2d<DComplex> evecs(n,n);
+    QDPLapack::zgeev(n, E, evals, evecs);
+
+    // Smallest modulus first
+    std::vector<int> order(n);
+    for(int i=0; i < n; ++i) {
+      order[i]=i;
+    }
+    std::sort(order.begin(), order.end(),
+	      [&evals](int i, int j)->bool {
+		return toBool( norm2(evals[i]) < norm2(evals[j]) );
+	      });
+
+    // G P, to be overwritten by its QR decomposition
+    multi2d<DComplex> GP(k_new, n+1);
+    for(int j=0; j < k_new; ++j) {
+      for(int row=0; row < n+1; ++row) {
+	GP(j,row) = zero;
+	for(int l=0; l < n; ++l) {
+	  GP(j,row) += G(l,row)*evecs(order[j],l);
+	}
+      }
+    }
+
+    multi1d<DComplex> tau;
+    QDPLapack::zgeqrf(n+1, k_new, GP, tau);
+
+    multi2d<DComplex> Rk(k_new, k_new);
+    for(int col=0; col < k_new; ++col) {
+      for(int row=0; row < k_new; ++row) {
+	Rk(col,row) = (row <= col) ? GP(col,row) : DComplex(zero);
+      }
+    }
+
+    QDPLapack::zungqr(n+1, k_new, k_new, GP, tau);
+
+    // C = What Q  and  U = W P R^{-1}
+    multi1d<T> new_U(k_new);
+    multi1d<T> new_C(k_new);
+    for(int j=0; j < k_new; ++j) {
+      new_U[j][s] = zero;
+      new_C[j][s] = zero;
+
+      for(int l=0; l < k; ++l) {
+	new_U[j][s] += evecs(order[j],l)*U_[l];
+	new_C[j][s] += GP(j,l)*C_[l];
+      }
+      for(int l=0; l < dim; ++l) {
+	new_U[j][s] += evecs(order[j],k+l)*V_[l];
+      }
+      for(int l=0; l <= dim; ++l) {
+	new_C[j][s] += GP(j,k+l)*V_[l];
+      }
+
+      for(int i=0; i < j; ++i) {
+	new_U[j][s] -= Rk(j,i)*new_U[i];
+      }
+      DComplex rinv = DComplex(1)/Rk(j,j);
+      new_U[j][s] = rinv*new_U[j];
+    }
+
+    U_.resize(k_new);
+    C_.resize(k_new);
+    for(int j=0; j < k_new; ++j) {
+      U_[j][s] = new_U[j];
+      C_[j][s] = new_C[j];
+    }
+
+    QDPIO::cout << "GCRODR: recycled space updated, dim=" << k_new
+		<< " smallest |theta|=" << sqrt(norm2(evals[order[0]])) << std::endl;
+  }
+
+
+  /*! Solve the linear system  A psi = chi  via GCRO-DR
+   *
+   *  The recycled space of the earlier calls is used from the start.
+   *  Whether this call updates it is set by RefreshInterval and
+   *  RefreshEveryCycle. While there is no space yet, it is built
+   *  after every cycle.
+   */
+  SystemSolverResults_t
+  LinOpSysSolverGCRODR::operator() (T& psi, const T& chi) const
+  {
+    START_CODE();
+    SystemSolverResults_t res; // Value to return
+
+    const Subset& s = A_->subset();
+    Double norm_rhs = sqrt(norm2(chi,s));   //  || b ||
+    Double target = norm_rhs * invParam_.RsdTarget; // Target  || r || < || b || RsdTarget
+
+    bool refresh = (invParam_.NDefl > 0) &&
+      ( C_.size() == 0 ||
+	(invParam_.RefreshInterval > 0 && num_solves_ % invParam_.RefreshInterval == 0) );
+    ++num_solves_;
+
+    // Compute r, and take out its part in the recycled space
+    T r = zero; T tmp = zero;
+    r[s] = chi;
+    (*A_)(tmp, psi, PLUS);
+    r[s] -= tmp;
+
+    Project(psi, r);
+
+    // The current residuum
+    Double r_norm = sqrt(norm2(r,s));
+
+    // Initialize iterations
+    int iters_total = 0;
+    int n_cycles = 0;
+
+    // We are done if norm is sufficiently accurate,
+    bool finished = toBool( r_norm <= target ) || (invParam_.MaxIter <= 0);
+
+    while( !finished ) {
+      ++n_cycles;
+
+      int k = C_.size();
+      int n_krylov = std::min(invParam_.NKrylov, invParam_.MaxIter - iters_total);
+      int dim;
+      bool breakdown;
+
+      Arnoldi(n_krylov, r, r_norm, target, dim, breakdown);
+      LeastSquaresSolve(dim);
+
+      // dx = V eta - U B eta, so that A dx = V H eta
+      T dx = zero;
+      for(int j=0; j < dim; ++j) {
+	dx[s] += eta_[j]*V_[j];
+      }
+      for(int i=0; i < k; ++i) {
+	DComplex b_eta = zero;
+	for(int j=0; j < dim; ++j) {
+	  b_eta += B_(j,i)*eta_[j];
+	}
+	dx[s] -= b_eta*U_[i];
+      }
+      psi[s] += dx;
+
+      iters_total += dim;
+
+      // Recompute r
+      r[s] = chi;
+      (*A_)(tmp, psi, PLUS);
+      r[s] -= tmp;
+      r_norm = sqrt(norm2(r,s));
+
+      bool last = toBool( r_norm <= target ) || (iters_total >= invParam_.MaxIter);
+
+      if ( refresh && ! breakdown && (last || k == 0 || invParam_.RefreshEveryCycle) ) {
+	Refresh(dim);
+      }
+
+      // Keep r orthogonal to the (possibly new) C
+      Project(psi, r);
+      r_norm = sqrt(norm2(r,s));
+
+      QDPIO::cout << "GCRODR: Cycle finished with " << dim << " iterations, || r || = " << r_norm << " target = " << target << std::endl;
+
+      finished = toBool( r_norm <= target ) || (iters_total >= invParam_.MaxIter);
+    }
+
+    res.n_count = iters_total;
+    res.resid = r_norm;
+    QDPIO::cout << "GCRODR: Done. Cycles=" << n_cycles << ", Iters=" << iters_total
+		<< " || r ||/|| b ||=" << r_norm / norm_rhs << " Target=" << invParam_.RsdTarget
+		<< " Recycled=" << C_.size() << std::endl;
+    END_CODE();
+    return res;
+  }
+
+}
@@ -0,0 +1,142 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Solve a sequence of M*psi=chi linear systems by GCRO-DR
+ */
+
+#ifndef __syssolver_linop_gcrodr_h__
+#define __syssolver_linop_gcrodr_h__
+
+#include "chroma_config.h"
+#include "handle.h"
+#include "state.h"
+#include "syssolver.h"
+#include "linearop.h"
+
+#include "actions/ferm/invert/syssolver_linop.h"
+#include "actions/ferm/invert/syssolver_linop_factory.h"
+#include "actions/ferm/invert/syssolver_linop_fgmres_dr.h"
+#include "actions/ferm/invert/syssolver_gcrodr_params.h"
+
+namespace Chroma
+{
+
+  //! GCRODR system solver namespace
+  namespace LinOpSysSolverGCRODREnv
+  {
+    //! Register the syssolver
+    bool registerAll();
+  }
+
+
+  //! Solve a sequence of M*psi=chi linear systems by GCRO-DR
+  /*! \ingroup invert
+   *
+   * GMRES with deflated restarting, where the deflation space is kept
+   * from one call to the next (Parks et al., SIAM J. Sci. Comput. 28, 2006).
+   *
+   * The solver holds a recycled space U with C = A U orthonormal. Each
+   * cycle builds an Arnoldi basis of (1 - C C^dag) A, and the correction
+   * is taken from U and the new basis together. The space is updated
+   * from the harmonic Ritz vectors of smallest modulus of A on U and the
+   * last basis, and then serves the next right hand side. Since it
+   * belongs to the operator, it lives as long as this solver object.
+   */
+  class LinOpSysSolverGCRODR : public LinOpSystemSolver<LatticeFermion>
+  {
+  public:
+    using T = LatticeFermion;
+    using U = LatticeColorMatrix;
+    using Q = multi1d<U>;
+
+    //! Constructor
+    /*!
+     * \param A_        Linear operator ( Read )
+     * \param invParam  inverter parameters ( Read )
+     */
+    LinOpSysSolverGCRODR(Handle< LinearOperator<T> > A,
+			 Handle< FermState<T,Q,Q> > state,
+			 const SysSolverGCRODRParams& invParam) :
+      A_(A), state_(state), invParam_(invParam), num_solves_(0)
+      {
+#ifndef BUILD_LAPACK
+	QDPIO::cout << "WARNING: LAPACK Is not built!!!" << std::endl;
+	QDPIO::cout << "WARNING: SUBSPACE Recycling requires it!!!!" << std::endl;
+
+	if( invParam_.NDefl > 0 ) {
+	  QDPIO::cout << " invParam.NDefl > 0: This mode is not supported without LAPACK" <<std::endl;
+	  QDP_abort(1);
+	}
+#endif
+
+	if( invParam_.NKrylov < 1 ) {
+	  QDPIO::cerr << "GCRODR: NKrylov must be positive" << std::endl;
+	  QDP_abort(1);
+	}
+
+	// Initialize stuff
+	InitMatrices();
+      }
+
+
+    //! Initialize the internal matrices
+    void InitMatrices();
+
+
+    //! Destructor is automatic
+    ~LinOpSysSolverGCRODR() {}
+
+    //! Return the subset on which the operator acts
+    const Subset& subset() const {return A_->subset();}
+
+    //! Solver the linear system
+    /*!
+     * \param psi      solution ( Modify )
+     * \param chi      source ( Read )
+     * \return syssolver results
+     */
+    SystemSolverResults_t operator() (T& psi, const T& chi) const;
+
+  private:
+    // Hide default constructor
+    LinOpSysSolverGCRODR() {}
+
+    //! Remove the part of r in span C
+    void Project(T& psi, T& r) const;
+
+    //! Arnoldi cycle of (1 - C C^dag) A, starting from r
+    void Arnoldi(int n_krylov,
+		 const T& r,
+		 const Double& r_norm,
+		 const Double& target,
+		 int& dim,
+		 bool& breakdown) const;
+
+    //! Back substitution for the cycle coefficients
+    void LeastSquaresSolve(int dim) const;
+
+    //! Update the recycled space from U and the last basis
+    void Refresh(int dim) const;
+
+    Handle< LinearOperator<T> > A_;
+    Handle< FermState<T,Q,Q> > state_;
+    SysSolverGCRODRParams invParam_;
+
+    // The recycled space, carried from one solve to the next
+    mutable multi1d<T> U_;  // Recycled vectors
+    mutable multi1d<T> C_;  // C = A U, orthonormal
+    mutable int num_solves_;
+
+    // Workspace of a cycle
+    mutable multi1d<T> V_;                // Arnoldi basis
+    mutable multi2d<DComplex> H_;         // (1 - C C^dag) A V = V H
+    mutable multi2d<DComplex> B_;         // B = C^dag A V
+    mutable multi2d<DComplex> R_;         // H reduced by Givens rotations
+    mutable multi1d< Handle<Givens> > givens_rots_;
+    mutable multi1d<DComplex> g_;
+    mutable multi1d<DComplex> eta_;
+  };
+
+} // End namespace
+
+#endif
+
@@ -0,0 +1,170 @@
+/*! \file
+ *  \brief Solve a M*psi=chi linear system by SAP preconditioned GCR
+ */
+#include <vector>
+#include "chromabase.h"
+#include "actions/ferm/invert/syssolver_linop_factory.h"
+#include "actions/ferm/invert/syssolver_linop_aggregate.h"
+#include "actions/ferm/invert/merged_reductions.h"
+
+#include "actions/ferm/invert/syssolver_linop_sap_gcr.h"
+
+namespace Chroma
+{
+
+  //! SAP GCR system solver namespace
+  namespace LinOpSysSolverSAPGCREnv
+  {
+    //! Callback function
+    LinOpSystemSolver<LatticeFermion>* createFerm(XMLReader& xml_in,
+						  const std::string& path,
+						  Handle< FermState< LatticeFermion, multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> > > state,
+						  Handle< LinearOperator<LatticeFermion> > A)
+    {
+      return new LinOpSysSolverSAPGCR(A, state, SysSolverSAPGCRParams(xml_in, path));
+    }
+
+
+    //! Name to be used
+    const std::string name("SAP_GCR_INVERTER");
+
+    //! Local registration flag
+    static bool registered = false;
+
+    //! Register all the factories
+    bool registerAll()
+    {
+      bool success = true;
+#ifndef QDP_IS_QDPJIT
+      // The block kernel works on raw site data
+      if (! registered)
+      {
+	success &= Chroma::TheLinOpFermSystemSolverFactory::Instance().registerObject(name, createFerm);
+	registered = true;
+      }
+#endif
+      return success;
+    }
+  }
+
+
+  /*! Solve the linear system  A psi = chi  via SAP preconditioned GCR
+   *
+   *  Iteration k of a cycle takes  z = M r,  w = A z  and then, from the
+   *  single reduction
+   *
+   *    d_j = < w_j, w >  (j < k),   < w, w >,   < w, r >
+   *
+   *  orthogonalises w (and z alongside) against the earlier w_j,
+   *  normalises it, and takes the step  alpha = < w, r > / || w ||.
+   *  Since r is orthogonal to the w_j, < w, r > is not changed by the
+   *  orthogonalisation, and  || r ||^2  drops by  |alpha|^2.
+   */
+  SystemSolverResults_t
+  LinOpSysSolverSAPGCR::operator() (T& psi, const T& chi) const
+  {
+    START_CODE();
+    SystemSolverResults_t res; // Value to return
+
+    StopWatch swatch;
+    swatch.reset();
+    swatch.start();
+
+    const Subset& s = A_->subset();
+    const int n_krylov = invParam_.NKrylov;
+
+    Double norm_rhs = sqrt(norm2(chi,s));   //  || b ||
+    Double target = norm_rhs * invParam_.RsdTarget; // Target  || r || < || b || RsdTarget
+
+    multi1d<T> z(n_krylov);
+    multi1d<T> w(n_krylov);
+
+    T r = zero; T tmp = zero;
+    r[s] = chi;
+    (*A_)(tmp, psi, PLUS);
+    r[s] -= tmp;
+
+    Double r_norm2 = norm2(r,s);
+
+    int iters_total = 0;
+    int n_cycles = 0;
+    bool finished = toBool( r_norm2 <= target*target ) || (invParam_.MaxIter <= 0);
+
+    while( !finished ) {
+      ++n_cycles;
+
+      int k;
+      for(k=0; k < n_krylov && iters_total < invParam_.MaxIter; ++k) {
+	M_(z[k], r);
+	(*A_)(w[k], z[k], PLUS);
+	++iters_total;
+
+	std::vector<const T*> x_dot, y_dot;
+	for(int j=0; j < k; ++j) {
+	  x_dot.push_back(&w[j]);
+	  y_dot.push_back(&w[k]);
+	}
+	x_dot.push_back(&w[k]);  y_dot.push_back(&w[k]);
+	x_dot.push_back(&w[k]);  y_dot.push_back(&r);
+
+	multi1d<DComplex> dot;
+	mergedInnerProducts(x_dot, y_dot, dot, s);
+
+	Double w_norm2 = real(dot[k]);
+	for(int j=0; j < k; ++j) {
+	  w_norm2 -= real(conj(dot[j])*dot[j]);
+	  w[k][s] -= dot[j]*w[j];
+	  z[k][s] -= dot[j]*z[j];
+	}
+
+	// The norm from the Gram coefficients loses digits when w was
+	// almost in the span of the earlier directions
+	if ( toBool( w_norm2 < Double(1.0e-4)*real(dot[k]) ) ) {
+	  w_norm2 = norm2(w[k],s);
+	}
+
+	if ( toBool( w_norm2 <= Double(0) ) ) {
+	  QDPIO::cout << "SAP_GCR: breakdown, the new direction is in the span of the old ones" << std::endl;
+	  break;
+	}
+
+	Double w_norm = sqrt(w_norm2);
+	Real w_inv = Real(Double(1)/w_norm);
+	w[k][s] *= w_inv;
+	z[k][s] *= w_inv;
+
+	DComplex alpha = dot[k+1] / w_norm;
+	psi[s] += alpha*z[k];
+	r[s] -= alpha*w[k];
+	r_norm2 -= real(conj(alpha)*alpha);
+
+	if ( toBool( r_norm2 <= target*target ) ) {
+	  ++k;
+	  break;
+	}
+      }
+
+      // Restart from the true residuum
+      r[s] = chi;
+      (*A_)(tmp, psi, PLUS);
+      r[s] -= tmp;
+      r_norm2 = norm2(r,s);
+
+      QDPIO::cout << "SAP_GCR: Cycle finished with " << k << " iterations, || r || = " << sqrt(r_norm2) << " target = " << target << std::endl;
+
+      // A cycle that made no direction cannot make progress
+      finished = toBool( r_norm2 <= target*target ) || (iters_total >= invParam_.MaxIter) || (k == 0);
+    }
+
+    swatch.stop();
+
+    res.n_count = iters_total;
+    res.resid = sqrt(r_norm2);
+    QDPIO::cout << "SAP_GCR: Done. Cycles=" << n_cycles << ", Iters=" << iters_total
+		<< " || r ||/|| b ||=" << res.resid / norm_rhs << " Target=" << invParam_.RsdTarget << std::endl;
+    QDPIO::cout << "SAP_GCR_TIME: " << swatch.getTimeInSeconds() << " sec" << std::endl;
+    END_CODE();
+    return res;
+  }
+
+}
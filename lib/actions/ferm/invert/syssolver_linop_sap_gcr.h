@@ -0,0 +1,92 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Solve a M*psi=chi linear system by SAP preconditioned GCR
+ */
+
+#ifndef __syssolver_linop_sap_gcr_h__
+#define __syssolver_linop_sap_gcr_h__
+
+#include "chroma_config.h"
+#include "handle.h"
+#include "state.h"
+#include "syssolver.h"
+#include "linearop.h"
+
+#include "actions/ferm/invert/syssolver_linop.h"
+#include "actions/ferm/invert/syssolver_linop_factory.h"
+#include "actions/ferm/invert/syssolver_sap_gcr_params.h"
+#include "actions/ferm/invert/sap_precond.h"
+
+namespace Chroma
+{
+
+  //! SAP GCR system solver namespace
+  namespace LinOpSysSolverSAPGCREnv
+  {
+    //! Register the syssolver
+    bool registerAll();
+  }
+
+
+  //! Solve a M*psi=chi linear system by SAP preconditioned GCR
+  /*! \ingroup invert
+   *
+   * Flexible GCR, restarted after NKrylov directions, with the Schwarz
+   * alternating procedure of SAPPrecond as the right preconditioner.
+   * Meant for the unpreconditioned Wilson and clover operators.
+   *
+   * The search directions are kept with  A z_j = w_j  and the w_j
+   * orthonormal. The residuum is orthogonal to all earlier w_j, so the
+   * Gram-Schmidt coefficients, the norm and the step length of a new
+   * direction all come from one merged reduction per iteration. The
+   * residuum is recomputed at each restart.
+   */
+  class LinOpSysSolverSAPGCR : public LinOpSystemSolver<LatticeFermion>
+  {
+  public:
+    using T = LatticeFermion;
+    using U = LatticeColorMatrix;
+    using Q = multi1d<U>;
+
+    //! Constructor
+    /*!
+     * \param A_        Linear operator ( Read )
+     * \param invParam  inverter parameters ( Read )
+     */
+    LinOpSysSolverSAPGCR(Handle< LinearOperator<T> > A,
+			 Handle< FermState<T,Q,Q> > state,
+			 const SysSolverSAPGCRParams& invParam) :
+      A_(A), state_(state), invParam_(invParam),
+      M_(A, state, invParam.Block, invParam.NCycles, invParam.NMR)
+      {
+	if( invParam_.NKrylov < 1 ) {
+	  QDPIO::cerr << "SAP_GCR: NKrylov must be positive" << std::endl;
+	  QDP_abort(1);
+	}
+      }
+
+    //! Destructor is automatic
+    ~LinOpSysSolverSAPGCR() {}
+
+    //! Return the subset on which the operator acts
+    const Subset& subset() const {return A_->subset();}
+
+    //! Solver the linear system
+    /*!
+     * \param psi      solution ( Modify )
+     * \param chi      source ( Read )
+     * \return syssolver results
+     */
+    SystemSolverResults_t operator() (T& psi, const T& chi) const;
+
+  private:
+    Handle< LinearOperator<T> > A_;
+    Handle< FermState<T,Q,Q> > state_;
+    SysSolverSAPGCRParams invParam_;
+    SAPPrecond M_;
+  };
+
+} // End namespace
+
+#endif
+
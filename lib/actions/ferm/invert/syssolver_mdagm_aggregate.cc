@@ -6,6 +6,7 @@
 
 
 #include "actions/ferm/invert/syssolver_mdagm_cg.h"
+#include "actions/ferm/invert/syssolver_mdagm_cacg.h"
 #include "actions/ferm/invert/syssolver_mdagm_bicgstab.h"
 #include "actions/ferm/invert/syssolver_mdagm_ibicgstab.h"
 #include "actions/ferm/invert/syssolver_mdagm_cg_timing.h"
@@ -16,6 +17,7 @@
 #include "actions/ferm/invert/syssolver_mdagm_rel_ibicgstab_clover.h"
 #include "actions/ferm/invert/syssolver_mdagm_rel_cg_clover.h"
 #include "actions/ferm/invert/syssolver_mdagm_cg_lf_clover.h"
+#include "actions/ferm/invert/amg/syssolver_mdagm_amg.h"
 #ifdef BUILD_QOP_MG
 #include "actions/ferm/invert/qop_mg/syssolver_mdagm_qop_mg_w.h"
 #endif
@@ -50,6 +52,7 @@ namespace Chroma
       {
 	// Sources
 	success &= MdagMSysSolverCGEnv::registerAll();
+	success &= MdagMSysSolverCACGEnv::registerAll();
 	success &= MdagMSysSolverCGTimingsEnv::registerAll();
 	success &= MdagMSysSolverBiCGStabEnv::registerAll();
 	success &= MdagMSysSolverIBiCGStabEnv::registerAll();
@@ -59,6 +62,7 @@ namespace Chroma
 	success &= MdagMSysSolverReliableIBiCGStabCloverEnv::registerAll();
 	success &= MdagMSysSolverReliableCGCloverEnv::registerAll();
 	success &= MdagMSysSolverCGLFCloverEnv::registerAll();//
+	success &= MdagMSysSolverAMGEnv::registerAll();
 #ifdef BUILD_QOP_MG
 	success &= MdagMSysSolverQOPMGEnv::registerAll();
 #endif
@@ -0,0 +1,100 @@
+/*! \file
+ *  \brief Solve a MdagM*psi=chi linear system by pipelined or s-step CG
+ */
+
+#include "actions/ferm/invert/syssolver_mdagm_factory.h"
+#include "actions/ferm/invert/syssolver_mdagm_aggregate.h"
+
+#include "actions/ferm/invert/syssolver_mdagm_cacg.h"
+
+namespace Chroma
+{
+
+  //! Pipelined and s-step CG system solver namespace
+  namespace MdagMSysSolverCACGEnv
+  {
+    //! Anonymous namespace
+    namespace
+    {
+      //! Names to be used
+      const std::string pipelined_name("PIPELINED_CG_INVERTER");
+      const std::string sstep_name("SSTEP_CG_INVERTER");
+
+      //! Local registration flag
+      bool registered = false;
+    }
+
+
+    //! Callback function
+    MdagMSystemSolver<LatticeFermion>* createPipelinedFerm(XMLReader& xml_in,
+							   const std::string& path,
+							   Handle< FermState< LatticeFermion, multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> > > state, 
+							   Handle< LinearOperator<LatticeFermion> > A)
+    {
+      return new MdagMSysSolverCACG<LatticeFermion>(A, SysSolverCACGParams(xml_in, path), MdagMSysSolverCACG<LatticeFermion>::PIPELINED);
+    }
+
+    //! Callback function
+    MdagMSystemSolver<LatticeFermionF>* createPipelinedFermF(XMLReader& xml_in,
+							     const std::string& path,
+							     Handle< FermState< LatticeFermionF, multi1d<LatticeColorMatrixF>, multi1d<LatticeColorMatrixF> > > state, 
+							     Handle< LinearOperator<LatticeFermionF> > A)
+    {
+      return new MdagMSysSolverCACG<LatticeFermionF>(A, SysSolverCACGParams(xml_in, path), MdagMSysSolverCACG<LatticeFermionF>::PIPELINED);
+    }
+
+    //! Callback function
+    MdagMSystemSolver<LatticeFermionD>* createPipelinedFermD(XMLReader& xml_in,
+							     const std::string& path,
+							     Handle< FermState< LatticeFermionD, multi1d<LatticeColorMatrixD>, multi1d<LatticeColorMatrixD> > > state, 
+							     Handle< LinearOperator<LatticeFermionD> > A)
+    {
+      return new MdagMSysSolverCACG<LatticeFermionD>(A, SysSolverCACGParams(xml_in, path), MdagMSysSolverCACG<LatticeFermionD>::PIPELINED);
+    }
+
+    //! Callback function
+    MdagMSystemSolver<LatticeFermion>* createSStepFerm(XMLReader& xml_in,
+						       const std::string& path,
+						       Handle< FermState< LatticeFermion, multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> > > state, 
+						       Handle< LinearOperator<LatticeFermion> > A)
+    {
+      return new MdagMSysSolverCACG<LatticeFermion>(A, SysSolverCACGParams(xml_in, path), MdagMSysSolverCACG<LatticeFermion>::SSTEP);
+    }
+
+    //! Callback function
+    MdagMSystemSolver<LatticeFermionF>* createSStepFermF(XMLReader& xml_in,
+							 const std::string& path,
+							 Handle< FermState< LatticeFermionF, multi1d<LatticeColorMatrixF>, multi1d<LatticeColorMatrixF> > > state, 
+							 Handle< LinearOperator<LatticeFermionF> > A)
+    {
+      return new MdagMSysSolverCACG<LatticeFermionF>(A, SysSolverCACGParams(xml_in, path), MdagMSysSolverCACG<LatticeFermionF>::SSTEP);
+    }
+
+    //! Callback function
+    MdagMSystemSolver<LatticeFermionD>* createSStepFermD(XMLReader& xml_in,
+							 const std::string& path,
+							 Handle< FermState< LatticeFermionD, multi1d<LatticeColorMatrixD>, multi1d<LatticeColorMatrixD> > > state, 
+							 Handle< LinearOperator<LatticeFermionD> > A)
+    {
+      return new MdagMSysSolverCACG<LatticeFermionD>(A, SysSolverCACGParams(xml_in, path), MdagMSysSolverCACG<LatticeFermionD>::SSTEP);
+    }
+
+    //! Register all the factories
+    bool registerAll() 
+    {
+      bool success = true; 
+      if (! registered)
+      {
+	success &= Chroma::TheMdagMFermSystemSolverFactory::Instance().registerObject(pipelined_name, createPipelinedFerm);
+	success &= Chroma::TheMdagMFermFSystemSolverFactory::Instance().registerObject(pipelined_name, createPipelinedFermF);
+	success &= Chroma::TheMdagMFermDSystemSolverFactory::Instance().registerObject(pipelined_name, createPipelinedFermD);
+
+	success &= Chroma::TheMdagMFermSystemSolverFactory::Instance().registerObject(sstep_name, createSStepFerm);
+	success &= Chroma::TheMdagMFermFSystemSolverFactory::Instance().registerObject(sstep_name, createSStepFermF);
+	success &= Chroma::TheMdagMFermDSystemSolverFactory::Instance().registerObject(sstep_name, createSStepFermD);
+	registered = true;
+      }
+      return success;
+    }
+  }
+}
@@ -0,0 +1,135 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Solve a MdagM*psi=chi linear system by pipelined or s-step CG
+ */
+
+#ifndef __syssolver_mdagm_cacg_h__
+#define __syssolver_mdagm_cacg_h__
+#include "chroma_config.h"
+#include "handle.h"
+#include "syssolver.h"
+#include "linearop.h"
+#include "lmdagm.h"
+#include "actions/ferm/invert/syssolver_mdagm.h"
+#include "actions/ferm/invert/syssolver_cacg_params.h"
+#include "actions/ferm/invert/invcg_pipelined.h"
+#include "actions/ferm/invert/invcg_sstep.h"
+
+
+namespace Chroma
+{
+
+  //! Pipelined and s-step CG system solver namespace
+  namespace MdagMSysSolverCACGEnv
+  {
+    //! Register the syssolver
+    bool registerAll();
+  }
+
+
+  //! Solve a MdagM system by CG with fewer global reductions
+  /*! \ingroup invert
+   *
+   * Like MdagMSysSolverCG, but with the pipelined CG (one reduction per
+   * iteration) or the s-step CG (one reduction per s iterations).
+   */
+  template<typename T>
+  class MdagMSysSolverCACG : public MdagMSystemSolver<T>
+  {
+  public:
+    //! Which algorithm
+    enum Variant_t {PIPELINED, SSTEP};
+
+    //! Constructor
+    /*!
+     * \param A_        Linear operator ( Read )
+     * \param invParam  inverter parameters ( Read )
+     * \param variant_  pipelined or s-step ( Read )
+     */
+    MdagMSysSolverCACG(Handle< LinearOperator<T> > A_,
+		       const SysSolverCACGParams& invParam_,
+		       Variant_t variant_) : 
+      A(A_), invParam(invParam_), variant(variant_)
+      {}
+
+    //! Destructor is automatic
+    ~MdagMSysSolverCACG() {}
+
+    //! Return the subset on which the operator acts
+    const Subset& subset() const {return A->subset();}
+
+    //! Solver the linear system
+    /*!
+     * \param psi      solution ( Modify )
+     * \param chi      source ( Read )
+     * \return syssolver results
+     */
+    SystemSolverResults_t operator() (T& psi, const T& chi) const
+      {
+	START_CODE();
+	StopWatch swatch;
+	swatch.reset(); swatch.start();
+
+	SystemSolverResults_t res;  // initialized by a constructor
+
+	if (variant == PIPELINED)
+	  res = InvCGPipelined(*A, chi, psi, invParam.RsdCG, invParam.MaxCG, invParam.ReplaceInterval);
+	else
+	  res = InvCGSStep(*A, chi, psi, invParam.RsdCG, invParam.MaxCG, invParam.SStep, invParam.ReplaceInterval);
+
+	swatch.stop();
+	QDPIO::cout << "CACG_SOLVER: " << res.n_count 
+		    << " iterations. Rsd = " << res.resid 
+		    << " Relative Rsd = " << res.resid/sqrt(norm2(chi,A->subset())) << std::endl;
+
+	double time = swatch.getTimeInSeconds();
+	QDPIO::cout << "CACG_SOLVER_TIME: "<<time<< " sec" << std::endl;
+
+	END_CODE();
+
+	return res;
+      }
+
+
+    //! Solve the linear system starting with a chrono guess 
+    /*! 
+     * \param psi solution (Write)
+     * \param chi source   (Read)
+     * \param predictor   a chronological predictor (Read)
+     * \return syssolver results
+     */
+    SystemSolverResults_t operator()(T& psi, const T& chi, 
+				     AbsChronologicalPredictor4D<T>& predictor) const 
+    {
+      START_CODE();
+
+      // The solvers work on A^dag A
+      {
+	Handle< LinearOperator<T> > MdagM( new MdagMLinOp<T>(A) );
+	predictor(psi, (*MdagM), chi);
+      }
+
+      // Do solve
+      SystemSolverResults_t res=(*this)(psi,chi);
+
+      // Store result
+      predictor.newVector(psi);
+
+      END_CODE();
+      return res;
+    }
+
+
+  private:
+    // Hide default constructor
+    MdagMSysSolverCACG() {}
+
+    Handle< LinearOperator<T> > A;
+    SysSolverCACGParams invParam;
+    Variant_t variant;
+  };
+
+} // End namespace
+
+#endif 
+
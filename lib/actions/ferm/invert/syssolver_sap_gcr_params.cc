@@ -0,0 +1,57 @@
+/*! \file
+ *  \brief Params of the SAP preconditioned GCR solver
+ */
+#include <string>
+#include "actions/ferm/invert/syssolver_sap_gcr_params.h"
+
+namespace Chroma
+{
+
+  // Read parameters
+  void read(XMLReader& xml, const std::string& path, SysSolverSAPGCRParams& p)
+  {
+    XMLReader paramtop(xml, path);
+
+    read(paramtop, "RsdTarget", p.RsdTarget);
+    read(paramtop, "MaxIter",   p.MaxIter);
+    read(paramtop, "NKrylov",   p.NKrylov);
+    read(paramtop, "Block",     p.Block);
+
+    if (paramtop.count("NCycles") == 1)
+      read(paramtop, "NCycles", p.NCycles);
+
+    if (paramtop.count("NMR") == 1)
+      read(paramtop, "NMR", p.NMR);
+  }
+
+  // Writer parameters
+  void write(XMLWriter& xml, const std::string& path, const SysSolverSAPGCRParams& p)
+  {
+    push(xml, path);
+    write(xml, "invType",   "SAP_GCR_INVERTER");
+    write(xml, "RsdTarget", p.RsdTarget);
+    write(xml, "MaxIter",   p.MaxIter);
+    write(xml, "NKrylov",   p.NKrylov);
+    write(xml, "Block",     p.Block);
+    write(xml, "NCycles",   p.NCycles);
+    write(xml, "NMR",       p.NMR);
+    pop(xml);
+  }
+
+  //! Default constructor
+  SysSolverSAPGCRParams::SysSolverSAPGCRParams()
+  {
+    RsdTarget = 0;
+    MaxIter = 0;
+    NKrylov = 0;
+    NCycles = 4;
+    NMR = 4;
+  }
+
+  //! Read parameters
+  SysSolverSAPGCRParams::SysSolverSAPGCRParams(XMLReader& xml, const std::string& path) : SysSolverSAPGCRParams()
+  {
+    read(xml, path, *this);
+  }
+
+}
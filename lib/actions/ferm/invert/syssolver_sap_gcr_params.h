@@ -0,0 +1,40 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Params of the SAP preconditioned GCR solver
+ */
+
+#ifndef __syssolver_sap_gcr_params_h__
+#define __syssolver_sap_gcr_params_h__
+
+#include "chromabase.h"
+
+namespace Chroma
+{
+
+  //! Params for the SAP preconditioned GCR inverter
+  /*! \ingroup invert */
+  struct SysSolverSAPGCRParams
+  {
+    SysSolverSAPGCRParams();
+    SysSolverSAPGCRParams(XMLReader& in, const std::string& path);
+    
+    Real          RsdTarget;     /*!< Target Residuum */
+    int           MaxIter;       /*!< Total Number of GCR Iterations */
+    int           NKrylov;       /*!< GCR directions kept before a restart */
+    multi1d<int>  Block;         /*!< Block extent in each direction */
+    int           NCycles;       /*!< Schwarz sweeps per preconditioner call */
+    int           NMR;           /*!< MR steps on each block */
+  };
+
+
+  // Reader/writers
+  /*! \ingroup invert */
+  void read(XMLReader& xml, const std::string& path, SysSolverSAPGCRParams& param);
+
+  /*! \ingroup invert */
+  void write(XMLWriter& xml, const std::string& path, const SysSolverSAPGCRParams& param);
+
+} // End namespace
+
+#endif 
+
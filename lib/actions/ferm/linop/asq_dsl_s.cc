@@ -137,4 +137,61 @@ namespace Chroma
     END_CODE();
   }
 
+
+  void QDPStaggeredDslash::apply (multi1d<LatticeStaggeredFermion>& chi, const multi1d<LatticeStaggeredFermion>& psi, enum PlusMinus isign, int cb) const
+  {
+    START_CODE();
+
+    const multi1d<LatticeColorMatrix>& u_fat = state->getFatLinks();
+    const multi1d<LatticeColorMatrix>& u_triple = state->getTripleLinks();
+
+    // The terms are summed in the same order as for a single vector
+    chi.resize(psi.size());
+    for(int n=0; n < psi.size(); ++n)
+      chi[n][rb[cb]] = zero;
+
+    LatticeStaggeredFermion tmp_0 = zero;
+    LatticeStaggeredFermion tmp_1 = zero;
+    LatticeStaggeredFermion tmp_2 = zero;
+
+    /* Forward one-hop and three-hop neigbhors */
+    for(int mu = 0; mu < Nd; ++mu)
+    {
+      for(int n=0; n < psi.size(); ++n)
+      {
+	tmp_0 = shift(psi[n], FORWARD, mu);
+	chi[n][rb[cb]] += u_fat[mu] * tmp_0;
+	tmp_1 = shift(tmp_0, FORWARD, mu);
+	tmp_2 = shift(tmp_1, FORWARD, mu);
+	chi[n][rb[cb]] += u_triple[mu] * tmp_2;
+      }
+    }
+
+    /* Backward one-hop and three-hop neigbhors */
+    for(int mu = 0; mu < Nd; ++mu)
+    {
+      // Shifted once here instead of once per vector
+      LatticeColorMatrix u_fat_back = shift(adj(u_fat[mu]), BACKWARD, mu);
+      LatticeColorMatrix u_triple_back = shift(adj(u_triple[mu]), BACKWARD, mu);
+
+      for(int n=0; n < psi.size(); ++n)
+      {
+	chi[n][rb[cb]] -= u_fat_back * shift(psi[n], BACKWARD, mu);
+	tmp_0 = u_triple_back * shift(psi[n], BACKWARD, mu);
+	tmp_1 = shift(tmp_0, BACKWARD, mu);
+	tmp_2 = shift(tmp_1, BACKWARD, mu);
+
+	chi[n][rb[cb]] -= tmp_2;
+      }
+    }
+
+    if(isign == MINUS)
+    {
+      for(int n=0; n < psi.size(); ++n)
+	chi[n] = -chi[n];
+    }
+
+    END_CODE();
+  }
+
 } // End Namespace Chroma
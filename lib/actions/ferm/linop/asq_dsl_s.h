@@ -81,6 +81,14 @@ namespace Chroma
      */
     void apply (LatticeStaggeredFermion& chi, const LatticeStaggeredFermion& psi, 
 		enum PlusMinus isign, int cb) const;
+
+    //! Apply onto several vectors
+    /*!
+     * Same as above for each vector, but the backward links are
+     * communicated once for all of them
+     */
+    void apply (multi1d<LatticeStaggeredFermion>& chi, const multi1d<LatticeStaggeredFermion>& psi, 
+		enum PlusMinus isign, int cb) const;
   
     //! Subset is all here
     const Subset& subset() const {return all;}
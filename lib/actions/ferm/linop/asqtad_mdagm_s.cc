@@ -63,5 +63,29 @@ namespace Chroma
     END_CODE();
   }
 
+
+  //! Apply onto several vectors, sharing the link communications
+  void AsqtadMdagM::operator()(multi1d<LatticeStaggeredFermion>& chi, 
+			       const multi1d<LatticeStaggeredFermion>& psi, 
+			       enum PlusMinus isign) const
+  {
+    START_CODE();
+
+    Real mass_sq = Mass*Mass;
+    multi1d<LatticeStaggeredFermion> tmp1(psi.size()), tmp2(psi.size());
+
+    for(int n=0; n < psi.size(); ++n)
+      tmp1[n] = tmp2[n] = zero;
+
+    D.apply(tmp1, psi, isign, 1);
+    D.apply(tmp2, tmp1, isign, 0);
+
+    chi.resize(psi.size());
+    for(int n=0; n < psi.size(); ++n)
+      chi[n][rb[0]] = 4*mass_sq*psi[n] - tmp2[n];
+  
+    END_CODE();
+  }
+
 } // End Namespace Chroma
 
@@ -70,6 +70,10 @@ namespace Chroma
     //! Apply the operator onto a source std::vector
     void operator() (LatticeStaggeredFermion& chi, const LatticeStaggeredFermion& psi, enum PlusMinus isign) const;
 
+    //! Apply the operator onto several source vectors at once
+    void operator() (multi1d<LatticeStaggeredFermion>& chi, const multi1d<LatticeStaggeredFermion>& psi, 
+		     enum PlusMinus isign) const;
+
   private:
     Real Mass;
     AsqtadDslash D;
@@ -0,0 +1,673 @@
+/*! \file
+ *  \brief Fused, plane streamed Schur complement of the even-odd clover operator
+ */
+
+#include "actions/ferm/linop/clover_schur_fused_w.h"
+#include "io/aniso_io.h"
+#include "util/info/perf_counters.h"
+
+#if defined(ARCH_PARSCALAR) || defined(ARCH_PARSCALARVEC)
+#include <qmp.h>
+#endif
+
+namespace Chroma
+{
+
+#if ! defined(QDP_IS_QDPJIT) && (QDP_ND == 4) && (QDP_NS == 4)
+  namespace
+  {
+    typedef FusedCloverSchur::Spinor      Spinor;
+    typedef FusedCloverSchur::HalfSpinor  HalfSpinor;
+    typedef FusedCloverSchur::ColorMat    ColorMat;
+    typedef FusedCloverSchur::Triang      Triang;
+
+    //! acc += (1 -+ gamma_mu) c U v,  or  adj(U)  if dagger
+    /*!
+     * minus picks the  1 - gamma_mu  projector, and c is the anisotropy
+     * coefficient of the link, 1 if null
+     */
+    inline void hop(Spinor& acc, const ColorMat& U, const Spinor& v,
+		    int mu, bool minus, bool dagger, const Real* c)
+    {
+      HalfSpinor h, uh;
+
+      switch (mu)
+      {
+      case 0:
+	if (minus) h = spinProjectDir0Minus(v); else h = spinProjectDir0Plus(v);
+	break;
+      case 1:
+	if (minus) h = spinProjectDir1Minus(v); else h = spinProjectDir1Plus(v);
+	break;
+      case 2:
+	if (minus) h = spinProjectDir2Minus(v); else h = spinProjectDir2Plus(v);
+	break;
+      default:
+	if (minus) h = spinProjectDir3Minus(v); else h = spinProjectDir3Plus(v);
+	break;
+      }
+
+      if (dagger)
+	uh = adj(U) * h;
+      else
+	uh = U * h;
+
+      if (c)
+	uh = uh * c->elem();
+
+      switch (mu)
+      {
+      case 0:
+	if (minus) acc += spinReconstructDir0Minus(uh); else acc += spinReconstructDir0Plus(uh);
+	break;
+      case 1:
+	if (minus) acc += spinReconstructDir1Minus(uh); else acc += spinReconstructDir1Plus(uh);
+	break;
+      case 2:
+	if (minus) acc += spinReconstructDir2Minus(uh); else acc += spinReconstructDir2Plus(uh);
+	break;
+      default:
+	if (minus) acc += spinReconstructDir3Minus(uh); else acc += spinReconstructDir3Plus(uh);
+	break;
+      }
+    }
+
+
+    //! out = A in  for the packed blocks of one site
+    /*!
+     * The same arithmetic as QDPCloverTermT::applySite: block b acts on
+     * spins 2b and 2b+1, and its strict lower triangle is stored by rows.
+     */
+    inline void cloverSite(const Triang& A, const Spinor& in, Spinor& out)
+    {
+      const int N = 2*Nc;
+      const RComplex<REAL>* x = (const RComplex<REAL>*)&(in.elem(0).elem(0));
+      RComplex<REAL>*       y = (RComplex<REAL>*)&(out.elem(0).elem(0));
+
+      for(int b=0; b < 2; ++b)
+      {
+	const RComplex<REAL>* xb = x + b*N;
+	RComplex<REAL>*       yb = y + b*N;
+
+	for(int i=0; i < N; ++i)
+	{
+	  RComplex<REAL> s = A.diag[b][i] * xb[i];
+
+	  for(int j=0; j < i; ++j)
+	    s += A.offd[b][i*(i-1)/2 + j] * xb[j];
+
+	  for(int j=i+1; j < N; ++j)
+	    s += conj(A.offd[b][j*(j-1)/2 + i]) * xb[j];
+
+	  yb[i] = s;
+	}
+      }
+    }
+  }
+#endif
+
+
+  // The tables of the layout, made on first use
+  const FusedCloverSchur::Geometry& FusedCloverSchur::geometry()
+  {
+    static Geometry geo;
+    static bool made = false;
+
+    if (made)
+      return geo;
+
+    made   = true;
+    geo.ok = false;
+
+#if ! defined(QDP_IS_QDPJIT) && (QDP_ND == 4) && (QDP_NS == 4)
+    const multi1d<int>& L     = Layout::subgridLattSize();
+    const multi1d<int>& nodes = Layout::logicalSize();
+    const multi1d<int>& ncrd  = Layout::nodeCoord();
+
+    for(int mu=0; mu < Nd; ++mu)
+    {
+      if (L[mu] % 2 != 0)
+	return geo;
+    }
+
+    const int vol    = Layout::sitesOnNode();
+    const int nplane = L[Nd-1];
+    const int half   = vol / (2*nplane);
+
+    geo.vol        = vol;
+    geo.nplane     = nplane;
+    geo.half       = half;
+    geo.split_time = (nodes[Nd-1] > 1);
+
+    // Local coordinates and parities
+    std::vector<int> lc(vol*Nd);
+    std::vector<int> par(vol);
+    for(int x=0; x < vol; ++x)
+    {
+      multi1d<int> c = Layout::siteCoords(Layout::nodeNumber(), x);
+      int sum = 0;
+      for(int mu=0; mu < Nd; ++mu)
+      {
+	sum += c[mu];
+	lc[x*Nd + mu] = c[mu] - ncrd[mu] * L[mu];
+      }
+      par[x] = sum % 2;
+    }
+
+    // Rows: the sites of a parity by plane, and in a plane by site index
+    std::vector<int> row_of(vol);
+    std::vector<int> fill(2*nplane, 0);
+    for(int q=0; q < 2; ++q)
+      geo.site[q].assign(nplane*half, 0);
+
+    for(int x=0; x < vol; ++x)
+    {
+      const int q = par[x];
+      const int t = lc[x*Nd + Nd-1];
+      const int k = fill[q*nplane + t]++;
+
+      // Planes with different numbers of even and odd sites
+      if (k >= half)
+	return geo;
+
+      row_of[x] = t*half + k;
+      geo.site[q][t*half + k] = x;
+    }
+
+    // Faces towards other nodes, and the place of a site in its face
+    std::vector< std::vector<int> > rank(2*Nd);
+    geo.halo_vol = 0;
+    for(int d=0; d < 2*Nd; ++d)
+    {
+      const int mu = d % Nd;
+      const int c_face = (d < Nd) ? 0 : L[mu]-1;
+
+      for(int q=0; q < 2; ++q)
+      {
+	geo.face[d][q].clear();
+	geo.halo_off[d][q] = -1;
+      }
+
+      if (nodes[mu] == 1)
+	continue;
+
+      rank[d].assign(vol, -1);
+      for(int x=0; x < vol; ++x)
+      {
+	if (lc[x*Nd + mu] == c_face)
+	{
+	  rank[d][x] = geo.face[d][par[x]].size();
+	  geo.face[d][par[x]].push_back(x);
+	}
+      }
+
+      for(int q=0; q < 2; ++q)
+      {
+	geo.halo_off[d][q] = geo.halo_vol;
+	geo.halo_vol += geo.face[d][q].size();
+      }
+    }
+
+    /*
+     * Neighbours. A site across a forward face has  c[mu] = 0  on the node
+     * above, and one across a backward face  c[mu] = L[mu]-1  on the node
+     * below. The nodes order their faces alike, so its halo slot is its
+     * rank in our own face.
+     */
+    multi1d<int> c(Nd);
+    geo.nbr_idx.assign(nplane*half*2*Nd, -1);
+    for(int q=0; q < 2; ++q)
+    {
+      geo.nbr[q].assign(nplane*half*2*Nd, 0);
+
+      for(int row=0; row < nplane*half; ++row)
+      {
+	const int x = geo.site[q][row];
+
+	for(int d=0; d < 2*Nd; ++d)
+	{
+	  const int mu = d % Nd;
+	  for(int nu=0; nu < Nd; ++nu)
+	    c[nu] = lc[x*Nd + nu];
+	  const int cn = c[mu] + ((d < Nd) ? 1 : -1);
+
+	  if (nodes[mu] > 1 && (cn < 0 || cn >= L[mu]))
+	  {
+	    c[mu] = (d < Nd) ? 0 : L[mu]-1;
+	    for(int nu=0; nu < Nd; ++nu)
+	      c[nu] += ncrd[nu] * L[nu];
+
+	    const int xr = Layout::linearSiteIndex(c);
+	    geo.nbr[q][row*2*Nd + d] = vol + geo.halo_off[d][1-q] + rank[d][xr];
+	  }
+	  else
+	  {
+	    c[mu] = (cn + L[mu]) % L[mu];
+	    for(int nu=0; nu < Nd; ++nu)
+	      c[nu] += ncrd[nu] * L[nu];
+
+	    const int xn = Layout::linearSiteIndex(c);
+	    geo.nbr[q][row*2*Nd + d] = xn;
+	    if (q == 1)
+	      geo.nbr_idx[row*2*Nd + d] = row_of[xn] % half;
+	  }
+	}
+      }
+    }
+
+    // The even faces as one list
+    geo.face_row.clear();
+    geo.face_slot.clear();
+    for(int d=0; d < 2*Nd; ++d)
+      for(int i=0; i < geo.face[d][0].size(); ++i)
+      {
+	geo.face_row.push_back(row_of[geo.face[d][0][i]]);
+	geo.face_slot.push_back(geo.halo_off[d][0] + i);
+      }
+
+    // Stream when every thread gets a slab long enough
+    geo.stream = (nplane >= int(MinSlab) * qdpNumThreads());
+    geo.ok = true;
+
+    QDPIO::cout << "FusedCloverSchur: " << (geo.stream ? "streaming " : "two passes over ")
+		<< nplane << " planes of " << half << " sites, halo " << geo.halo_vol << std::endl;
+#endif
+
+    return geo;
+  }
+
+
+  // Take the links and the clover blocks
+  void FusedCloverSchur::create(Handle< FermState<T,Q,Q> > fs_,
+				const CloverFermActParams& param,
+				const Triang* tri_,
+				const Triang* inv_tri_)
+  {
+    START_CODE();
+
+    ok = false;
+    links_ready = false;
+
+#if ! defined(QDP_IS_QDPJIT) && (QDP_ND == 4) && (QDP_NS == 4)
+    if (! param.fused_schurP)
+    {
+      END_CODE();
+      return;
+    }
+
+    tri     = tri_;
+    inv_tri = inv_tri_;
+
+    if (tri == 0 || inv_tri == 0)
+    {
+      END_CODE();
+      return;
+    }
+
+    if (fs_->getFermBC()->nontrivialP())
+    {
+      END_CODE();
+      return;
+    }
+
+    g = &geometry();
+    if (! g->ok)
+    {
+      END_CODE();
+      return;
+    }
+
+    twisted   = param.twisted_m_usedP;
+    twisted_m = param.twisted_m;
+
+    // The links stay in the state, the anisotropy goes in the hops
+    aniso  = param.anisoParam.anisoP;
+    coeffs = makeFermCoeffs(param.anisoParam);
+
+    fs = fs_;
+    for(int mu=0; mu < Nd; ++mu)
+      u[mu] = &((fs->getLinks())[mu].elem(0));
+
+    ok = true;
+#endif
+
+    END_CODE();
+  }
+
+
+#if ! defined(QDP_IS_QDPJIT) && (QDP_ND == 4) && (QDP_NS == 4)
+  // t_e at even site row
+  void FusedCloverSchur::evenSite(Spinor& t, int row, const Spinor* psi, int isign, bool g5) const
+  {
+    const int  vol = g->vol;
+    const int* nb  = &(g->nbr[0][row*2*Nd]);
+    const int  x   = g->site[0][row];
+
+    Spinor acc;
+    zero_rep(acc);
+
+    Spinor vg;
+    for(int d=0; d < 2*Nd; ++d)
+    {
+      const int mu = d % Nd;
+      const bool fwd = (d < Nd);
+      const int  n   = nb[d];
+      const Real* c  = aniso ? &coeffs[mu] : 0;
+
+      const Spinor* v = (n < vol) ? &psi[n] : &psi_halo[n-vol];
+      if (g5)
+      {
+	vg = GammaConst<Ns,Ns*Ns-1>() * (*v);
+	v = &vg;
+      }
+
+      if (fwd)
+	hop(acc, u[mu][x], *v, mu, isign == PLUS, false, c);
+      else
+	hop(acc, (n < vol) ? u[mu][n] : link_halo[n-vol], *v, mu, isign != PLUS, true, c);
+    }
+
+    cloverSite(inv_tri[x], acc, t);
+  }
+
+
+  // chi_o at odd site row of plane p
+  void FusedCloverSchur::oddSite(Spinor& chi, int row, int p, const Spinor* psi,
+				 const Spinor* buf, int nslots, int isign, bool g5) const
+  {
+    const int  vol  = g->vol;
+    const int  half = g->half;
+    const int* nb   = &(g->nbr[1][row*2*Nd]);
+    const int* ni   = &(g->nbr_idx[row*2*Nd]);
+    const int  x    = g->site[1][row];
+
+    Spinor acc;
+    zero_rep(acc);
+
+    for(int d=0; d < 2*Nd; ++d)
+    {
+      const int mu = d % Nd;
+      const bool fwd = (d < Nd);
+      const int  n   = nb[d];
+      const Real* c  = aniso ? &coeffs[mu] : 0;
+
+      const Spinor* tv;
+      if (n < vol)
+      {
+	const int q = p + ((mu == Nd-1) ? (fwd ? 1 : -1) : 0);
+	const int slot = ((q % nslots) + nslots) % nslots;
+	tv = &buf[slot*half + ni[d]];
+      }
+      else
+	tv = &te_halo[n-vol];
+
+      if (fwd)
+	hop(acc, u[mu][x], *tv, mu, isign == PLUS, false, c);
+      else
+	hop(acc, (n < vol) ? u[mu][n] : link_halo[n-vol], *tv, mu, isign != PLUS, true, c);
+    }
+
+    const Spinor* v = &psi[x];
+    Spinor vg;
+    if (g5)
+    {
+      vg = GammaConst<Ns,Ns*Ns-1>() * (*v);
+      v = &vg;
+    }
+
+    //  A_oo psi - 1/4 D_oe t_e
+    Spinor r;
+    cloverSite(tri[x], *v, r);
+
+    const Real mquarter = -0.25;
+    r += acc * mquarter.elem();
+
+    if (twisted)
+    {
+      const Real m = (isign == PLUS) ? twisted_m : Real(-twisted_m);
+      Spinor tw = GammaConst<Ns,Ns*Ns-1>() * timesI(*v);
+      r += tw * m.elem();
+    }
+
+    if (g5)
+      chi = GammaConst<Ns,Ns*Ns-1>() * r;
+    else
+      chi = r;
+  }
+
+
+  //! A thread streams its slab of planes through a ring of three t_e planes
+  void FusedCloverSchur::streamLoop(int lo, int hi, int myId, SweepArgs* a)
+  {
+    const FusedCloverSchur& op = *(a->op);
+    const Geometry& geo = *(op.g);
+    const int half = geo.half;
+    Spinor* ring = a->buf + myId*3*half;
+
+    if (lo >= hi)
+      return;
+
+    // t_e of plane q, unwrapped, in slot q mod 3
+    auto makePlane = [&](int q) {
+      if (geo.split_time && (q < 0 || q >= geo.nplane))
+	return;   // in the halo
+
+      const int pa   = (q + geo.nplane) % geo.nplane;
+      const int slot = (q + 3) % 3;
+      for(int i=0; i < half; ++i)
+	op.evenSite(ring[slot*half + i], pa*half + i, a->psi, a->isign, a->g5);
+    };
+
+    makePlane(lo-1);
+    makePlane(lo);
+
+    for(int p=lo; p < hi; ++p)
+    {
+      makePlane(p+1);
+
+      for(int i=0; i < half; ++i)
+      {
+	const int row = p*half + i;
+	op.oddSite(a->chi[geo.site[1][row]], row, p, a->psi, ring, 3, a->isign, a->g5);
+      }
+    }
+  }
+
+
+  //! t_e on all even rows
+  void FusedCloverSchur::evenLoop(int lo, int hi, int myId, SweepArgs* a)
+  {
+    const FusedCloverSchur& op = *(a->op);
+    for(int row=lo; row < hi; ++row)
+      op.evenSite(a->buf[row], row, a->psi, a->isign, a->g5);
+  }
+
+
+  //! chi on all odd rows from the half lattice t_e
+  void FusedCloverSchur::oddLoop(int lo, int hi, int myId, SweepArgs* a)
+  {
+    const FusedCloverSchur& op = *(a->op);
+    const Geometry& geo = *(op.g);
+    for(int row=lo; row < hi; ++row)
+      op.oddSite(a->chi[geo.site[1][row]], row, row / geo.half, a->psi,
+		 a->buf, geo.nplane, a->isign, a->g5);
+  }
+
+
+  //! t_e on the even faces, for the neighbours
+  void FusedCloverSchur::faceLoop(int lo, int hi, int myId, SweepArgs* a)
+  {
+    const FusedCloverSchur& op = *(a->op);
+    const Geometry& geo = *(op.g);
+    for(int k=lo; k < hi; ++k)
+      op.evenSite(op.te_send[geo.face_slot[k]], geo.face_row[k], a->psi, a->isign, a->g5);
+  }
+
+
+  /*! Fill a halo
+   *
+   *  The forward halo of a node holds the face  c[mu] = 0  of the node
+   *  above it, and the backward halo the face  c[mu] = L[mu]-1  of the
+   *  node below. All faces are exchanged at once.
+   */
+  template<typename S>
+  void FusedCloverSchur::exchange(std::vector<S>& send, std::vector<S>& recv, int q)
+  {
+#if defined(ARCH_PARSCALAR) || defined(ARCH_PARSCALARVEC)
+    const Geometry& geo = geometry();
+    const std::vector<int> (&face)[2*Nd][2] = geo.face;
+    const int (&halo_off)[2*Nd][2] = geo.halo_off;
+
+    std::vector<QMP_msgmem_t>    mm;
+    std::vector<QMP_msghandle_t> mh;
+    double sent = 0;
+
+    for(int d=0; d < 2*Nd; ++d)
+    {
+      const int n = face[d][q].size();
+      if (halo_off[d][q] < 0 || n == 0)
+	continue;
+
+      const int mu = d % Nd;
+      const bool forward = (d < Nd);
+      const size_t bytes = n * sizeof(S);
+
+      QMP_msgmem_t m_recv = QMP_declare_msgmem(&recv[halo_off[d][q]], bytes);
+      QMP_msgmem_t m_send = QMP_declare_msgmem(&send[halo_off[d][q]], bytes);
+      mm.push_back(m_recv);
+      mm.push_back(m_send);
+      sent += bytes;
+
+      mh.push_back(QMP_declare_receive_relative(m_recv, mu, forward ? +1 : -1, 0));
+      mh.push_back(QMP_declare_send_relative(m_send, mu, forward ? -1 : +1, 0));
+    }
+
+    if (mh.size() == 0)
+      return;
+
+    QMP_msghandle_t all = QMP_declare_multiple(&mh[0], mh.size());
+    if (all == (QMP_msghandle_t)NULL)
+      QDP_error_exit("FusedCloverSchur: QMP_declare_multiple failed\n");
+
+    {
+      PerfCounters::HaloRegion perf_halo(sent);
+
+      QMP_status_t err;
+      if ((err = QMP_start(all)) != QMP_SUCCESS)
+	QDP_error_exit(QMP_error_string(err));
+      if ((err = QMP_wait(all)) != QMP_SUCCESS)
+	QDP_error_exit(QMP_error_string(err));
+    }
+
+    QMP_free_msghandle(all);
+    for(int i=0; i < mm.size(); ++i)
+      QMP_free_msgmem(mm[i]);
+#endif
+  }
+#endif
+
+
+  // The links across the backward faces
+  void FusedCloverSchur::exchangeLinks() const
+  {
+#if ! defined(QDP_IS_QDPJIT) && (QDP_ND == 4) && (QDP_NS == 4)
+    const Geometry& geo = *g;
+
+    link_halo.resize(geo.halo_vol);
+    if (geo.halo_vol > 0)
+    {
+      std::vector<ColorMat> link_send(geo.halo_vol);
+      for(int q=0; q < 2; ++q)
+      {
+	for(int d=0; d < 2*Nd; ++d)
+	  for(int i=0; i < geo.face[d][q].size(); ++i)
+	    link_send[geo.halo_off[d][q] + i] = u[d % Nd][geo.face[d][q][i]];
+
+	exchange(link_send, link_halo, q);
+      }
+    }
+
+    links_ready = true;
+#endif
+  }
+
+
+  // chi_o = M psi_o, gamma_5 on load and store if g5
+  void FusedCloverSchur::sweep(T& chi, const T& psi_, enum PlusMinus isign, bool g5) const
+  {
+    START_CODE();
+
+#if ! defined(QDP_IS_QDPJIT) && (QDP_ND == 4) && (QDP_NS == 4)
+    const Geometry& geo = *g;
+
+    // The links and the buffers, on the first sweep
+    if (! links_ready)
+    {
+      exchangeLinks();
+
+      psi_halo.resize(geo.halo_vol);
+      te_halo.resize(geo.halo_vol);
+      te_send.resize(geo.halo_vol);
+      te_buf.resize(geo.stream ? 3*geo.half*qdpNumThreads() : geo.nplane*geo.half);
+    }
+
+    // A slab reads psi on the planes next to it, which its neighbour
+    // writes. The two passes only read psi at the site they write.
+    Handle<T> copy;
+    if (geo.stream && &chi == &psi_)
+      copy = new T(psi_);
+    const T& psi = (copy.operator->() != 0) ? *copy : psi_;
+
+    SweepArgs a = {this, &(psi.elem(0)), &(chi.elem(0)), &te_buf[0], 0, isign, g5};
+
+    if (geo.halo_vol > 0)
+    {
+      // psi on the odd faces of the neighbours
+      for(int d=0; d < 2*Nd; ++d)
+	for(int i=0; i < geo.face[d][1].size(); ++i)
+	  te_send[geo.halo_off[d][1] + i] = psi.elem(geo.face[d][1][i]);
+
+      exchange(te_send, psi_halo, 1);
+
+      // and t_e on their even faces
+      dispatch_to_threads(geo.face_row.size(), a, faceLoop);
+      exchange(te_send, te_halo, 0);
+    }
+
+    if (geo.stream)
+    {
+      a.nslots = 3;
+      dispatch_to_threads(geo.nplane, a, streamLoop);
+    }
+    else
+    {
+      a.nslots = geo.nplane;
+      dispatch_to_threads(geo.nplane*geo.half, a, evenLoop);
+      dispatch_to_threads(geo.nplane*geo.half, a, oddLoop);
+    }
+#endif
+
+    END_CODE();
+  }
+
+
+  // chi_o = M psi_o
+  void FusedCloverSchur::apply(T& chi, const T& psi, enum PlusMinus isign) const
+  {
+    sweep(chi, psi, isign, false);
+  }
+
+
+  // chi_o = M^dag M psi_o
+  void FusedCloverSchur::applyMdagM(T& chi, const T& psi) const
+  {
+    T y;
+    sweep(y, psi, PLUS, false);
+
+    if (twisted)
+      sweep(chi, y, MINUS, false);
+    else
+      sweep(chi, y, PLUS, true);
+  }
+
+} // End Namespace Chroma
@@ -0,0 +1,202 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Fused, plane streamed Schur complement of the even-odd clover operator
+ */
+
+#ifndef __clover_schur_fused_w_h__
+#define __clover_schur_fused_w_h__
+
+#include "chromabase.h"
+#include "state.h"
+#include "actions/ferm/fermacts/clover_fermact_params_w.h"
+#include "actions/ferm/linop/clover_term_qdp_w.h"
+
+#include <vector>
+
+namespace Chroma
+{
+
+  //! The packed clover blocks of a term, null for terms that hide them
+  /*! \ingroup linop */
+  template<typename C>
+  inline
+  const PrimitiveClovTriang<REAL>* cloverTriangles(const C& clov)
+  {
+    return 0;
+  }
+
+  //! The packed clover blocks of a QDP clover term
+  /*! \ingroup linop */
+  inline
+  const PrimitiveClovTriang<REAL>* cloverTriangles(const QDPCloverTermT<LatticeFermion, LatticeColorMatrix>& clov)
+  {
+    return clov.getTriBuffer();
+  }
+
+
+  //! Fused Schur complement of the even-odd clover operator
+  /*!
+   * \ingroup linop
+   *
+   * Applies
+   *
+   *    chi_o = ( A_oo - 1/4 D_oe A^{-1}_ee D_eo [+- i mu gamma_5] ) psi_o
+   *
+   * in one sweep over the odd sites, instead of a dslash, a clover
+   * inverse, a second dslash and a clover term that each write a half
+   * lattice temporary.
+   *
+   * The node is walked along the time direction one plane at a time.
+   * Each thread owns a slab of planes and keeps  t_e = A^{-1}_ee D_eo psi
+   * for three planes in a private ring: after t_e of plane p+1 is made,
+   * plane p of chi is finished, so t_e never leaves the cache. The t_e
+   * planes next to a slab are made by both threads next to it. When a
+   * slab would be shorter than MinSlab planes the redundant work does not
+   * pay off, and the same site kernels run as two threaded passes through
+   * one half lattice t_e.
+   *
+   * Directions split over nodes take a one-site halo: psi on the odd
+   * faces before the sweep, and t_e on the even faces, which are made
+   * first for that. The gauge links across the backward faces are
+   * exchanged by the first sweep. The site tables only depend on the
+   * layout, and are made once for all operators.
+   *
+   * Only used (usable() is true) when the action asks for it with
+   * FusedSchur, and not under QDP-JIT, for clover terms that do not
+   * expose their packed blocks, for boundary conditions that modify
+   * the fermion, or for odd node extents.
+   */
+  class FusedCloverSchur
+  {
+  public:
+    // Typedefs to save typing
+    typedef LatticeFermion               T;
+    typedef multi1d<LatticeColorMatrix>  Q;
+    typedef PrimitiveClovTriang<REAL>    Triang;
+    typedef LatticeFermion::Subtype_t      Spinor;
+    typedef LatticeHalfFermion::Subtype_t  HalfSpinor;
+    typedef LatticeColorMatrix::Subtype_t  ColorMat;
+
+    //! Shortest slab of planes a thread streams
+    enum {MinSlab = 4};
+
+    //! Empty until created
+    FusedCloverSchur() : ok(false), g(0), links_ready(false) {}
+
+    //! Take the links and the clover blocks
+    /*!
+     * \param fs        fermion state ( Read )
+     * \param param     clover parameters ( Read )
+     * \param tri       the term, used on the odd sites ( Read )
+     * \param inv_tri   the inverse term, used on the even sites ( Read )
+     *
+     * The links stay in the state, and the blocks in their clover terms.
+     */
+    void create(Handle< FermState<T,Q,Q> > fs,
+		const CloverFermActParams& param,
+		const Triang* tri,
+		const Triang* inv_tri);
+
+    //! Can the fused sweep be used
+    bool usable() const {return ok;}
+
+    //! chi_o = M psi_o
+    void apply(T& chi, const T& psi, enum PlusMinus isign) const;
+
+    //! chi_o = M^dag M psi_o
+    /*!
+     * Two sweeps,  y = M psi  and  chi = gamma_5 M gamma_5 y,  with the
+     * gamma_5 taken into the loads and stores of the second. With a twisted
+     * mass M is not gamma_5-hermitian, and the second sweep is  M^dag.
+     */
+    void applyMdagM(T& chi, const T& psi) const;
+
+  private:
+    //! The sweep on the sites of the node
+    struct Geometry
+    {
+      bool           ok;           /*!< even extents, and planes of equal parity counts */
+      int            vol;          /*!< sites on the node */
+      int            nplane;       /*!< local time extent */
+      int            half;         /*!< sites of one parity in a plane */
+      bool           split_time;
+      bool           stream;       /*!< streamed slabs, else two passes */
+
+      // Site of plane-ordered row  p*half + i  of each parity
+      std::vector<int>   site[2];
+      // Neighbour site of row and direction, or vol + halo slot
+      std::vector<int>   nbr[2];
+      // Index in its plane of the even neighbour of an odd row
+      std::vector<int>   nbr_idx;
+
+      // Face sites for each direction and parity, the neighbour's halo order
+      std::vector<int>   face[2*Nd][2];
+      int                halo_off[2*Nd][2];
+      int                halo_vol;
+
+      // Faces as one list: even face rows and their halo slots
+      std::vector<int>   face_row;
+      std::vector<int>   face_slot;
+    };
+
+    //! The tables of the layout, made on first use
+    static const Geometry& geometry();
+
+    //! Arguments of the sweeps
+    struct SweepArgs
+    {
+      const FusedCloverSchur* op;
+      const Spinor*  psi;
+      Spinor*        chi;
+      Spinor*        buf;       /*!< t_e planes */
+      int            nslots;    /*!< planes in buf, 3 per thread when streaming */
+      int            isign;
+      bool           g5;
+    };
+
+    //! chi_o = M psi_o, gamma_5 on load and store if g5
+    void sweep(T& chi, const T& psi, enum PlusMinus isign, bool g5) const;
+
+    //! The links across the backward faces
+    void exchangeLinks() const;
+
+    //! t_e at even site row
+    void evenSite(Spinor& t, int row, const Spinor* psi, int isign, bool g5) const;
+
+    //! chi_o at odd site row of plane p, t_e of plane q in slot q of buf
+    void oddSite(Spinor& chi, int row, int p, const Spinor* psi,
+		 const Spinor* buf, int nslots, int isign, bool g5) const;
+
+    //! Fill a halo from the faces of the neighbours, sites of parity q
+    template<typename S>
+    static void exchange(std::vector<S>& send, std::vector<S>& recv, int q);
+
+    // Thread loops
+    static void streamLoop(int lo, int hi, int myId, SweepArgs* a);
+    static void evenLoop(int lo, int hi, int myId, SweepArgs* a);
+    static void oddLoop(int lo, int hi, int myId, SweepArgs* a);
+    static void faceLoop(int lo, int hi, int myId, SweepArgs* a);
+
+    bool           ok;
+    bool           twisted;
+    Real           twisted_m;
+    bool           aniso;
+    multi1d<Real>  coeffs;       /*!< anisotropy of the links */
+    Handle< FermState<T,Q,Q> >  fs;
+    const ColorMat*  u[Nd];      /*!< the links of fs */
+    const Triang*  tri;
+    const Triang*  inv_tri;
+    const Geometry*  g;
+
+    mutable bool   links_ready;
+    mutable std::vector<ColorMat>  link_halo;   /*!< U_mu(x-mu) across backward faces */
+    mutable std::vector<Spinor>  psi_halo;
+    mutable std::vector<Spinor>  te_halo;
+    mutable std::vector<Spinor>  te_send;
+    mutable std::vector<Spinor>  te_buf;   /*!< rings or the half lattice t_e */
+  };
+
+} // End Namespace Chroma
+
+
+#endif
@@ -11,6 +11,7 @@
 #include "actions/ferm/fermacts/clover_fermact_params_w.h"
 #include "actions/ferm/linop/clover_term_base_w.h"
 #include "meas/glue/mesfield.h"
+#include "util/info/perf_counters.h"
 #include <complex>
 namespace Chroma 
 { 
@@ -73,6 +74,17 @@ namespace Chroma
 			const CloverFermActParams& param_,
 			const QDPCloverTermT<T,U>& from_);
 
+    //! Create the term and its inverse on cb together
+    /*!
+     * Same result as create(fs,param_), inv.create(fs,param_,*this) and
+     * inv.choles(cb), but F(mu,nu) is computed once and packing, inversion
+     * and log det are done in one site pass per checkerboard.
+     */
+    void createWithInverse(Handle< FermState<T, multi1d<U>, multi1d<U> > > fs,
+			   const CloverFermActParams& param_,
+			   QDPCloverTermT<T,U>& inv,
+			   int cb);
+
     //! Computes the inverse of the term on cb using Cholesky
     /*!
      * \param cb   checkerboard of work (Read)
@@ -108,12 +120,10 @@ namespace Chroma
 
     void applySite(T& chi, const T& psi, enum PlusMinus isign, int site) const;
 
-#ifdef BUILD_QPHIX
-    // Access the clover tri-buffer for packing
+    // Access the clover tri-buffer for packing and fused operators
     const PrimitiveClovTriang<REALT>* getTriBuffer() const {
       return tri;
     }
-#endif
 
     //! Calculates Tr_D ( Gamma_mat L )
     void triacntr(U& B, int mat, int cb) const;
@@ -145,6 +155,10 @@ namespace Chroma
     Real getCloverCoeff(int mu, int nu) const;
 
   private:
+    //! Set the links, BC and parameters, returning the effective mass term
+    RealT init(Handle< FermState<T, multi1d<U>, multi1d<U> > > fs,
+	       const CloverFermActParams& param_);
+
 			Handle< FermBC<T,multi1d<U>,multi1d<U> > >      fbc;
     multi1d<U>  u;
     CloverFermActParams          param;
@@ -240,14 +254,12 @@ namespace Chroma
   }
 
 
-  //! Creation routine
+  //! Set the links, BC and parameters
   template<typename T, typename U>
-  void QDPCloverTermT<T,U>::create(Handle< FermState<T,multi1d<U>,multi1d<U> > > fs,
-				   const CloverFermActParams& param_)
+  typename QDPCloverTermT<T,U>::RealT
+  QDPCloverTermT<T,U>::init(Handle< FermState<T,multi1d<U>,multi1d<U> > > fs,
+			    const CloverFermActParams& param_)
   {
-#ifndef QDP_IS_QDPJIT
-    START_CODE();
-   
     u.resize(Nd);
     
     u = fs->getLinks();
@@ -276,18 +288,30 @@ namespace Chroma
       RealT ff = where(param.anisoParam.anisoP, param.anisoParam.nu / param.anisoParam.xi_0, Real(1));
       diag_mass = 1 + (Nd-1)*ff + param.Mass;
     }
-    
-    /* Calculate F(mu,nu) */
-    multi1d<U> f;
-    mesField(f, u);
-    makeClov(f, diag_mass);
-    
 
     choles_done.resize(rb.numSubsets());
     for(int i=0; i < rb.numSubsets(); i++) {
       choles_done[i] = false;
     }
+
+    return diag_mass;
+  }
+
+
+  //! Creation routine
+  template<typename T, typename U>
+  void QDPCloverTermT<T,U>::create(Handle< FermState<T,multi1d<U>,multi1d<U> > > fs,
+				   const CloverFermActParams& param_)
+  {
+#ifndef QDP_IS_QDPJIT
+    START_CODE();
+   
+    RealT diag_mass = init(fs, param_);
     
+    /* Calculate F(mu,nu) */
+    multi1d<U> f;
+    mesField(f, u);
+    makeClov(f, diag_mass);
 
     END_CODE();
 #endif
@@ -394,6 +418,123 @@ namespace Chroma
     };
     
     
+    //! Pack the (coefficient weighted) field strength of one site
+    /*!
+     * \param f          F(mu,nu) on the site in the order of mesField   (Read)
+     * \param diag_mass  effective mass term                            (Read)
+     * \param tri        packed clover term of the site                  (Write)
+     */
+    template<typename REALT>
+    inline
+    void packClovSite(const RComplex<REALT> f[6][Nc][Nc],
+		      const RScalar<REALT>& diag_mass,
+		      PrimitiveClovTriang<REALT>& tri)
+    {
+      /*# Construct diagonal */
+
+      for(int jj = 0; jj < 2; jj++) {
+
+	for(int ii = 0; ii < 2*Nc; ii++) {
+
+	  tri.diag[jj][ii] = diag_mass;
+	}
+      }
+
+
+
+      RComplex<REALT> E_minus;
+      RComplex<REALT> B_minus;
+      RComplex<REALT> ctmp_0;
+      RComplex<REALT> ctmp_1;
+      RScalar<REALT> rtmp_0;
+      RScalar<REALT> rtmp_1;
+
+      for(int i = 0; i < Nc; ++i) {
+
+	/*# diag_L(i,0) = 1 - i*diag(E_z - B_z) */
+	/*#             = 1 - i*diag(F(3,2) - F(1,0)) */
+	ctmp_0 = f[5][i][i];
+	ctmp_0 -= f[0][i][i];
+	rtmp_0 = imag(ctmp_0);
+	tri.diag[0][i] += rtmp_0;
+
+	/*# diag_L(i+Nc,0) = 1 + i*diag(E_z - B_z) */
+	/*#                = 1 + i*diag(F(3,2) - F(1,0)) */
+	tri.diag[0][i+Nc] -= rtmp_0;
+
+	/*# diag_L(i,1) = 1 + i*diag(E_z + B_z) */
+	/*#             = 1 + i*diag(F(3,2) + F(1,0)) */
+	ctmp_1 = f[5][i][i];
+	ctmp_1 += f[0][i][i];
+	rtmp_1 = imag(ctmp_1);
+	tri.diag[1][i] -= rtmp_1;
+
+	/*# diag_L(i+Nc,1) = 1 - i*diag(E_z + B_z) */
+	/*#                = 1 - i*diag(F(3,2) + F(1,0)) */
+	tri.diag[1][i+Nc] += rtmp_1;
+      }
+
+      /*# Construct lower triangular portion */
+      /*# Block diagonal terms */
+      for(int i = 1; i < Nc; ++i) {
+
+	for(int j = 0; j < i; ++j) {
+
+	  int elem_ij  = i*(i-1)/2 + j;
+	  int elem_tmp = (i+Nc)*(i+Nc-1)/2 + j+Nc;
+
+	  /*# L(i,j,0) = -i*(E_z - B_z)[i,j] */
+	  /*#          = -i*(F(3,2) - F(1,0)) */
+	  ctmp_0 = f[0][i][j];
+	  ctmp_0 -= f[5][i][j];
+	  tri.offd[0][elem_ij] = timesI(ctmp_0);
+
+	  /*# L(i+Nc,j+Nc,0) = +i*(E_z - B_z)[i,j] */
+	  /*#                = +i*(F(3,2) - F(1,0)) */
+	  tri.offd[0][elem_tmp] = -tri.offd[0][elem_ij];
+
+	  /*# L(i,j,1) = i*(E_z + B_z)[i,j] */
+	  /*#          = i*(F(3,2) + F(1,0)) */
+	  ctmp_1 = f[5][i][j];
+	  ctmp_1 += f[0][i][j];
+	  tri.offd[1][elem_ij] = timesI(ctmp_1);
+
+	  /*# L(i+Nc,j+Nc,1) = -i*(E_z + B_z)[i,j] */
+	  /*#                = -i*(F(3,2) + F(1,0)) */
+	  tri.offd[1][elem_tmp] = -tri.offd[1][elem_ij];
+	}
+      }
+
+      /*# Off-diagonal */
+      for(int i = 0; i < Nc; ++i) {
+
+	for(int j = 0; j < Nc; ++j) {
+
+	  // Flipped index
+	  // by swapping i <-> j. In the past i would run slow
+	  // and now j runs slow
+	  int elem_ij  = (i+Nc)*(i+Nc-1)/2 + j;
+
+	  /*# i*E_- = (i*E_x + E_y) */
+	  /*#       = (i*F(3,0) + F(3,1)) */
+	  E_minus = timesI(f[2][i][j]);
+	  E_minus += f[4][i][j];
+
+	  /*# i*B_- = (i*B_x + B_y) */
+	  /*#       = (i*F(2,1) - F(2,0)) */
+	  B_minus = timesI(f[3][i][j]);
+	  B_minus -= f[1][i][j];
+
+	  /*# L(i+Nc,j,0) = -i*(E_- - B_-)  */
+	  tri.offd[0][elem_ij] = B_minus - E_minus;
+
+	  /*# L(i+Nc,j,1) = +i*(E_- + B_-)  */
+	  tri.offd[1][elem_ij] = E_minus + B_minus;
+	}
+      }
+    }
+
+
     /* This is the extracted site loop for makeClover */
     template<typename U>
     inline 
@@ -404,118 +545,19 @@ namespace Chroma
       typedef typename QDPCloverMakeClovArg<U>::REALT REALT;
       
       const RealT& diag_mass = a->diag_mass;
-      const U& f0=a->f0;
-      const U& f1=a->f1;
-      const U& f2=a->f2;
-      const U& f3=a->f3;
-      const U& f4=a->f4;
-      const U& f5=a->f5;
+      const U* f[6] = { &a->f0, &a->f1, &a->f2, &a->f3, &a->f4, &a->f5 };
       PrimitiveClovTriang < REALT >* tri=a->tri;
 
       // SITE LOOP STARTS HERE
       for(int site = lo; site < hi; ++site)  {
-	/*# Construct diagonal */
-	
-	for(int jj = 0; jj < 2; jj++) {
-	  
-	  for(int ii = 0; ii < 2*Nc; ii++) {
-	    
-	    tri[site].diag[jj][ii] = diag_mass.elem().elem().elem();
-	  }
-	}
-	
-       
-
-	RComplex<REALT> E_minus;
-	RComplex<REALT> B_minus;
-	RComplex<REALT> ctmp_0;
-	RComplex<REALT> ctmp_1;
-	RScalar<REALT> rtmp_0;
-	RScalar<REALT> rtmp_1;
-	
-	for(int i = 0; i < Nc; ++i) {
-	  
-	  /*# diag_L(i,0) = 1 - i*diag(E_z - B_z) */
-	  /*#             = 1 - i*diag(F(3,2) - F(1,0)) */
-	  ctmp_0 = f5.elem(site).elem().elem(i,i);
-	  ctmp_0 -= f0.elem(site).elem().elem(i,i);
-	  rtmp_0 = imag(ctmp_0);
-	  tri[site].diag[0][i] += rtmp_0;
-	  
-	  /*# diag_L(i+Nc,0) = 1 + i*diag(E_z - B_z) */
-	  /*#                = 1 + i*diag(F(3,2) - F(1,0)) */
-	  tri[site].diag[0][i+Nc] -= rtmp_0;
-	  
-	  /*# diag_L(i,1) = 1 + i*diag(E_z + B_z) */
-	  /*#             = 1 + i*diag(F(3,2) + F(1,0)) */
-	  ctmp_1 = f5.elem(site).elem().elem(i,i);
-	  ctmp_1 += f0.elem(site).elem().elem(i,i);
-	  rtmp_1 = imag(ctmp_1);
-	  tri[site].diag[1][i] -= rtmp_1;
-	  
-	  /*# diag_L(i+Nc,1) = 1 - i*diag(E_z + B_z) */
-	  /*#                = 1 - i*diag(F(3,2) + F(1,0)) */
-	  tri[site].diag[1][i+Nc] += rtmp_1;
-	}
-	
-	/*# Construct lower triangular portion */
-	/*# Block diagonal terms */
-	for(int i = 1; i < Nc; ++i) {
-	  
-	  for(int j = 0; j < i; ++j) {
-	    
-	    int elem_ij  = i*(i-1)/2 + j;
-	    int elem_tmp = (i+Nc)*(i+Nc-1)/2 + j+Nc;
-	    
-	    /*# L(i,j,0) = -i*(E_z - B_z)[i,j] */
-	    /*#          = -i*(F(3,2) - F(1,0)) */
-	    ctmp_0 = f0.elem(site).elem().elem(i,j);
-	    ctmp_0 -= f5.elem(site).elem().elem(i,j);
-	    tri[site].offd[0][elem_ij] = timesI(ctmp_0);
-	    
-	    /*# L(i+Nc,j+Nc,0) = +i*(E_z - B_z)[i,j] */
-	    /*#                = +i*(F(3,2) - F(1,0)) */
-	    tri[site].offd[0][elem_tmp] = -tri[site].offd[0][elem_ij];
-	    
-	    /*# L(i,j,1) = i*(E_z + B_z)[i,j] */
-	    /*#          = i*(F(3,2) + F(1,0)) */
-	    ctmp_1 = f5.elem(site).elem().elem(i,j);
-	    ctmp_1 += f0.elem(site).elem().elem(i,j);
-	    tri[site].offd[1][elem_ij] = timesI(ctmp_1);
-	    
-	    /*# L(i+Nc,j+Nc,1) = -i*(E_z + B_z)[i,j] */
-	    /*#                = -i*(F(3,2) + F(1,0)) */
-	    tri[site].offd[1][elem_tmp] = -tri[site].offd[1][elem_ij];
-	  }
-	}
-	
-	/*# Off-diagonal */
-	for(int i = 0; i < Nc; ++i) {
-	  
-	  for(int j = 0; j < Nc; ++j) {
-	    
-	    // Flipped index
-	    // by swapping i <-> j. In the past i would run slow
-	    // and now j runs slow
-	    int elem_ij  = (i+Nc)*(i+Nc-1)/2 + j;
-	    
-	    /*# i*E_- = (i*E_x + E_y) */
-	    /*#       = (i*F(3,0) + F(3,1)) */
-	    E_minus = timesI(f2.elem(site).elem().elem(i,j));
-	    E_minus += f4.elem(site).elem().elem(i,j);
-	    
-	    /*# i*B_- = (i*B_x + B_y) */
-	    /*#       = (i*F(2,1) - F(2,0)) */
-	    B_minus = timesI(f3.elem(site).elem().elem(i,j));
-	    B_minus -= f1.elem(site).elem().elem(i,j);
-	    
-	    /*# L(i+Nc,j,0) = -i*(E_- - B_-)  */
-	    tri[site].offd[0][elem_ij] = B_minus - E_minus;
-	    
-	    /*# L(i+Nc,j,1) = +i*(E_- + B_-)  */
-	    tri[site].offd[1][elem_ij] = E_minus + B_minus;
-	  }
-	}
+	RComplex<REALT> fs[6][Nc][Nc];
+
+	for(int k = 0; k < 6; ++k)
+	  for(int i = 0; i < Nc; ++i)
+	    for(int j = 0; j < Nc; ++j)
+	      fs[k][i][j] = f[k]->elem(site).elem().elem(i,j);
+
+	packClovSite(fs, diag_mass.elem().elem().elem(), tri[site]);
       } /* End Site loop */
 #endif
     } /* Function */
@@ -616,6 +658,188 @@ namespace Chroma
       int cb;
     };
 
+    //! In place LDL^dag inverse of one packed block
+    /*!
+     * \param diag     real diagonal of the block               (Modify)
+     * \param offd     strictly lower triangle of the block     (Modify)
+     * \param tr_log   accumulates log|det| of the block        (Modify)
+     * \param num_neg  accumulates negative pivots              (Modify)
+     */
+    template<typename REALT>
+    inline
+    void ldlInvBlock(RScalar<REALT>* diag, RComplex<REALT>* offd,
+		     REALT& tr_log, int& num_neg)
+    {
+      const int N = 2*Nc;
+      RScalar<REALT> zip=0;
+
+      // Triangular storage 
+      RScalar<REALT> inv_d[N] QDP_ALIGN16;
+      RComplex<REALT> inv_offd[2*Nc*Nc-Nc] QDP_ALIGN16;
+      RComplex<REALT> v[N] QDP_ALIGN16;
+      RScalar<REALT>  diag_g[N] QDP_ALIGN16;
+      // Algorithm 4.1.2 LDL^\dagger Decomposition
+      // From Golub, van Loan 3rd ed, page 139
+      for(int i=0; i < N; i++) { 
+	inv_d[i] = diag[i];
+      }
+
+      for(int i=0; i < 2*Nc*Nc-Nc; i++) { 
+	inv_offd[i]  =offd[i];
+      }
+
+      for(int j=0; j < N; ++j) { 
+
+	// Compute v(0:j-1)
+	//
+	// for i=0:j-2
+	//   v(i) = A(j,i) A(i,i)
+	// end
+
+
+	for(int i=0; i < j; i++) { 
+	  int elem_ji = j*(j-1)/2 + i;
+
+	  RComplex<REALT> A_ii = cmplx( inv_d[i], zip );
+	  v[i] = A_ii*adj(inv_offd[elem_ji]);
+	}
+
+	// v(j) = A(j,j) - A(j, 0:j-2) v(0:j-2)
+	//                 ^ This is done with a loop over k ie:
+	//
+	// v(j) = A(j,j) - sum_k A*(j,k) v(k)     k=0...j-2
+	//
+	//      = A(j,j) - sum_k A*(j,k) A(j,k) A(k,k)
+	//      = A(j,j) - sum_k | A(j,k) |^2 A(k,k)
+
+	v[j] = cmplx(inv_d[j],zip);
+
+	for(int k=0; k < j; k++) { 
+	  int elem_jk = j*(j-1)/2 + k;
+	  v[j] -= inv_offd[elem_jk]*v[k];
+	}
+
+
+	// At this point in time v[j] has to be real, since
+	// A(j,j) is from diag ie real and all | A(j,k) |^2 is real
+	// as is A(k,k)
+
+	// A(j,j) is the diagonal element - so store it.
+	inv_d[j] = real( v[j] );
+
+	// Last line of algorithm:
+	// A( j+1 : n, j) = ( A(j+1:n, j) - A(j+1:n, 1:j-1)v(1:k-1) ) / v(j)
+	//
+	// use k as first colon notation and l as second so
+	// 
+	// for k=j+1 < n-1
+	//      A(k,j) = A(k,j) ;
+	//      for l=0 < j-1
+	//         A(k,j) -= A(k, l) v(l)
+	//      end
+	//      A(k,j) /= v(j);
+	//
+	for(int k=j+1; k < N; k++) { 
+	  int elem_kj = k*(k-1)/2 + j;
+	  for(int l=0; l < j; l++) { 
+	    int elem_kl = k*(k-1)/2 + l;
+	    inv_offd[elem_kj] -= inv_offd[elem_kl] * v[l];
+	  }
+	  inv_offd[elem_kj] /= v[j];
+	}
+      }
+
+      // Now fix up the inverse
+      RScalar<REALT> one;
+      one.elem() = (REALT)1;
+
+      for(int i=0; i < N; i++) { 
+	diag_g[i] = one/inv_d[i];
+
+	// Compute the trace log
+	// NB we are always doing trace log | A | 
+	// (because we are always working with actually A^\dagger A
+	//  even in one flavour case where we square root)
+	tr_log += log(fabs(inv_d[i].elem()));
+	// However, it is worth counting just the no of negative logdets
+	// on site
+	if( inv_d[i].elem() < 0 ) { 
+	  num_neg++;
+	}
+      }
+      // Now we need to invert the L D L^\dagger 
+      // We can do this by solving:
+      //
+      //  L D L^\dagger M^{-1} = 1   
+      //
+      // This can be done by solving L D X = 1  (X = L^\dagger M^{-1})
+      //
+      // Then solving L^\dagger M^{-1} = X
+      //
+      // LD is lower diagonal and so X will also be lower diagonal.
+      // LD X = 1 can be solved by forward substitution.
+      //
+      // Likewise L^\dagger is strictly upper triagonal and so
+      // L^\dagger M^{-1} = X can be solved by forward substitution.
+      RComplex<REALT> sum;
+      for(int k = 0; k < N; ++k) {
+
+	for(int i = 0; i < k; ++i) {
+	  zero_rep(v[i]);
+	}
+
+	/*# Forward substitution */
+
+	// The first element is the inverse of the diagonal
+	v[k] = cmplx(diag_g[k],zip);
+
+	for(int i = k+1; i < N; ++i) {
+	  zero_rep(v[i]);
+
+	  for(int j = k; j < i; ++j) {
+	    int elem_ij = i*(i-1)/2+j;      
+
+	    // subtract l_ij*d_j*x_{kj}
+	    v[i] -= inv_offd[elem_ij] *inv_d[j]*v[j];
+
+	  }
+
+	  // scale out by 1/d_i
+	  v[i] *= diag_g[i];
+	}
+
+	/*# Backward substitution */
+	// V[N-1] remains unchanged
+	// Start from V[N-2]
+
+	for(int i = N-2; (int)i >= (int)k; --i) {
+	  for(int j = i+1; j < N; ++j) {
+	    int elem_ji = j*(j-1)/2 + i;
+	    // Subtract terms of typ (l_ji)*x_kj
+	    v[i] -= adj(inv_offd[elem_ji]) * v[j];
+	  }
+	}
+
+	/*# Overwrite column k of invcl.offd */
+	inv_d[k] = real(v[k]);
+	for(int i = k+1; i < N; ++i) {
+
+	  int elem_ik = i*(i-1)/2+k;
+	  inv_offd[elem_ik] = v[i];
+	}
+      }
+
+
+      // Overwrite original data
+      for(int i=0; i < N; i++) { 
+	diag[i] = inv_d[i];
+      }
+      for(int i=0; i < 2*Nc*Nc-Nc; i++) { 
+	offd[i] = inv_offd[i];
+      }
+    }
+
+
     template<typename U>
     inline 
     void LDagDLInvSiteLoop(int lo, int hi, int myId, LDagDLInvArgs<U>* a) 
@@ -628,10 +852,6 @@ namespace Chroma
       PrimitiveClovTriang < REALT>* tri = a->tri;
       int cb = a->cb;
       
-      
-      RScalar<REALT> zip=0;
-      int N = 2*Nc;
-      
       // Loop through the sites.
       for(int ssite=lo; ssite < hi; ++ssite)  {
 
@@ -640,171 +860,8 @@ namespace Chroma
 	int site_neg_logdet=0;
 	// Loop through the blocks on the site.
 	for(int block=0; block < 2; block++) { 
-	  
-	  // Triangular storage 
-	  RScalar<REALT> inv_d[N] QDP_ALIGN16;
-	  RComplex<REALT> inv_offd[2*Nc*Nc-Nc] QDP_ALIGN16;
-	  RComplex<REALT> v[N] QDP_ALIGN16;
-	  RScalar<REALT>  diag_g[N] QDP_ALIGN16;
-	  // Algorithm 4.1.2 LDL^\dagger Decomposition
-	  // From Golub, van Loan 3rd ed, page 139
-	  for(int i=0; i < N; i++) { 
-	    inv_d[i] = tri[site].diag[block][i];
-	  }
-	  
-	  for(int i=0; i < 2*Nc*Nc-Nc; i++) { 
-	    inv_offd[i]  =tri[site].offd[block][i];
-	  }
-	  
-	  for(int j=0; j < N; ++j) { 
-	    
-	    // Compute v(0:j-1)
-	    //
-	    // for i=0:j-2
-	    //   v(i) = A(j,i) A(i,i)
-	    // end
-	    
-	    
-	    for(int i=0; i < j; i++) { 
-	      int elem_ji = j*(j-1)/2 + i;
-	      
-	      RComplex<REALT> A_ii = cmplx( inv_d[i], zip );
-	      v[i] = A_ii*adj(inv_offd[elem_ji]);
-	    }
-	    
-	    // v(j) = A(j,j) - A(j, 0:j-2) v(0:j-2)
-	    //                 ^ This is done with a loop over k ie:
-	    //
-	    // v(j) = A(j,j) - sum_k A*(j,k) v(k)     k=0...j-2
-	    //
-	    //      = A(j,j) - sum_k A*(j,k) A(j,k) A(k,k)
-	    //      = A(j,j) - sum_k | A(j,k) |^2 A(k,k)
-	    
-	    v[j] = cmplx(inv_d[j],zip);
-	    
-	    for(int k=0; k < j; k++) { 
-	      int elem_jk = j*(j-1)/2 + k;
-	      v[j] -= inv_offd[elem_jk]*v[k];
-	    }
-	    
-	    
-	    // At this point in time v[j] has to be real, since
-	    // A(j,j) is from diag ie real and all | A(j,k) |^2 is real
-	    // as is A(k,k)
-	    
-	    // A(j,j) is the diagonal element - so store it.
-	    inv_d[j] = real( v[j] );
-	    
-	    // Last line of algorithm:
-	    // A( j+1 : n, j) = ( A(j+1:n, j) - A(j+1:n, 1:j-1)v(1:k-1) ) / v(j)
-	    //
-	    // use k as first colon notation and l as second so
-	    // 
-	    // for k=j+1 < n-1
-	    //      A(k,j) = A(k,j) ;
-	    //      for l=0 < j-1
-	    //         A(k,j) -= A(k, l) v(l)
-	    //      end
-	    //      A(k,j) /= v(j);
-	    //
-	    for(int k=j+1; k < N; k++) { 
-	      int elem_kj = k*(k-1)/2 + j;
-	      for(int l=0; l < j; l++) { 
-		int elem_kl = k*(k-1)/2 + l;
-		inv_offd[elem_kj] -= inv_offd[elem_kl] * v[l];
-	      }
-	      inv_offd[elem_kj] /= v[j];
-	    }
-	  }
-	  
-	  // Now fix up the inverse
-	  RScalar<REALT> one;
-	  one.elem() = (REALT)1;
-	  
-	  for(int i=0; i < N; i++) { 
-	    diag_g[i] = one/inv_d[i];
-	    
-	    // Compute the trace log
-	    // NB we are always doing trace log | A | 
-	    // (because we are always working with actually A^\dagger A
-	    //  even in one flavour case where we square root)
-	    tr_log_diag.elem(site).elem().elem().elem() += log(fabs(inv_d[i].elem()));
-	    // However, it is worth counting just the no of negative logdets
-	    // on site
-	    if( inv_d[i].elem() < 0 ) { 
-	      site_neg_logdet++;
-	    }
-	  }
-	  // Now we need to invert the L D L^\dagger 
-	  // We can do this by solving:
-	  //
-	  //  L D L^\dagger M^{-1} = 1   
-	  //
-	  // This can be done by solving L D X = 1  (X = L^\dagger M^{-1})
-	  //
-	  // Then solving L^\dagger M^{-1} = X
-	  //
-	  // LD is lower diagonal and so X will also be lower diagonal.
-	  // LD X = 1 can be solved by forward substitution.
-	  //
-	  // Likewise L^\dagger is strictly upper triagonal and so
-	  // L^\dagger M^{-1} = X can be solved by forward substitution.
-	  RComplex<REALT> sum;
-	  for(int k = 0; k < N; ++k) {
-
-	    for(int i = 0; i < k; ++i) {
-	      zero_rep(v[i]);
-	    }
-	    
-	    /*# Forward substitution */
-	    
-	    // The first element is the inverse of the diagonal
-	    v[k] = cmplx(diag_g[k],zip);
-	    
-	    for(int i = k+1; i < N; ++i) {
-	      zero_rep(v[i]);
-	      
-	      for(int j = k; j < i; ++j) {
-		int elem_ij = i*(i-1)/2+j;	
-		
-		// subtract l_ij*d_j*x_{kj}
-		v[i] -= inv_offd[elem_ij] *inv_d[j]*v[j];
-		
-	      }
-	      
-	      // scale out by 1/d_i
-	      v[i] *= diag_g[i];
-	    }
-	    
-	    /*# Backward substitution */
-	    // V[N-1] remains unchanged
-	    // Start from V[N-2]
-	    
-	    for(int i = N-2; (int)i >= (int)k; --i) {
-	      for(int j = i+1; j < N; ++j) {
-		int elem_ji = j*(j-1)/2 + i;
-		// Subtract terms of typ (l_ji)*x_kj
-		v[i] -= adj(inv_offd[elem_ji]) * v[j];
-	      }
-	    }
-	    
-	    /*# Overwrite column k of invcl.offd */
-	    inv_d[k] = real(v[k]);
-	    for(int i = k+1; i < N; ++i) {
-
-	      int elem_ik = i*(i-1)/2+k;
-	      inv_offd[elem_ik] = v[i];
-	    }
-	  }
-	  
-	  
-	  // Overwrite original data
-	  for(int i=0; i < N; i++) { 
-	    tri[site].diag[block][i] = inv_d[i];
-	  }
-	  for(int i=0; i < 2*Nc*Nc-Nc; i++) { 
-	    tri[site].offd[block][i] = inv_offd[i];
-	  }
+	  ldlInvBlock(tri[site].diag[block], tri[site].offd[block],
+		      tr_log_diag.elem(site).elem().elem().elem(), site_neg_logdet);
 	}
 	
 	if( site_neg_logdet != 0 ) { 
@@ -814,6 +871,69 @@ namespace Chroma
 	}
       }/* End Site Loop */
     } /* End Function */
+
+
+    template<typename U>
+    struct FusedClovArgs { 
+      typedef typename WordType<U>::Type_t REALT;
+      typedef OScalar< PScalar< PScalar< RScalar<REALT> > > > RealT;
+      typedef OLattice< PScalar< PScalar< RScalar<REALT> > > > LatticeRealT;
+      const RealT& diag_mass;
+      const multi1d<U>& f;
+      RScalar<REALT> coeff[6];           // clover coefficient of each F(mu,nu)
+      PrimitiveClovTriang<REALT>* tri;     // the term
+      PrimitiveClovTriang<REALT>* inv_tri; // the term, inverted if invertP
+      LatticeRealT& tr_log_diag;
+      int cb;
+      bool invertP;
+    };
+
+    /* Packing, LDL^dag inverse and log det of a site without
+     * going through memory in between */
+    template<typename U>
+    inline 
+    void fusedClovSiteLoop(int lo, int hi, int myId, FusedClovArgs<U>* a) 
+    {
+#ifndef QDP_IS_QDPJIT
+      typedef typename FusedClovArgs<U>::REALT REALT;
+
+      const multi1d<U>& f = a->f;
+      int cb = a->cb;
+
+      for(int ssite=lo; ssite < hi; ++ssite)  {
+
+	int site = rb[cb].siteTable()[ssite];
+
+	RComplex<REALT> fs[6][Nc][Nc];
+	for(int k = 0; k < 6; ++k)
+	  for(int i = 0; i < Nc; ++i)
+	    for(int j = 0; j < Nc; ++j)
+	      fs[k][i][j] = f[k].elem(site).elem().elem(i,j) * a->coeff[k];
+
+	PrimitiveClovTriang<REALT> blk;
+	packClovSite(fs, a->diag_mass.elem().elem().elem(), blk);
+	a->tri[site] = blk;
+
+	if (a->invertP) { 
+	  REALT& tr_log = a->tr_log_diag.elem(site).elem().elem().elem();
+	  tr_log = 0;
+
+	  int site_neg_logdet=0;
+	  for(int block=0; block < 2; block++) { 
+	    ldlInvBlock(blk.diag[block], blk.offd[block], tr_log, site_neg_logdet);
+	  }
+	  
+	  if( site_neg_logdet != 0 ) { 
+	    // Report if site has any negative terms. (-ve def)
+	    std::cout << "WARNING: found " << site_neg_logdet
+		      << " negative eigenvalues in Clover DET at site: " << site << std::endl;
+	  }
+	}
+
+	a->inv_tri[site] = blk;
+      }/* End Site Loop */
+#endif
+    } /* End Function */
   } /* End Namespace */
 
 
@@ -844,7 +964,60 @@ namespace Chroma
     END_CODE();
 #endif
   }
- 
+
+
+  //! Creation of the term and its inverse on cb
+  template<typename T, typename U>
+  void QDPCloverTermT<T,U>::createWithInverse(Handle< FermState<T,multi1d<U>,multi1d<U> > > fs,
+					      const CloverFermActParams& param_,
+					      QDPCloverTermT<T,U>& inv,
+					      int cb)
+  {
+#ifndef QDP_IS_QDPJIT
+    START_CODE();
+
+    if ( Nd != 4 ){
+      QDPIO::cerr << __func__ << ": expecting Nd==4" << std::endl;
+      QDP_abort(1);
+    }
+    
+    if ( Ns != 4 ){
+      QDPIO::cerr << __func__ << ": expecting Ns==4" << std::endl;
+      QDP_abort(1);
+    }
+
+    RealT diag_mass = init(fs, param_);
+    inv.init(fs, param_);
+
+    /* Calculate F(mu,nu) */
+    multi1d<U> f;
+    mesField(f, u);
+
+    // The clover coefficients are applied per site instead of
+    // making scaled copies of F
+    QDPCloverEnv::FusedClovArgs<U> a = { diag_mass, f, {}, tri, inv.tri, inv.tr_log_diag_, 1-cb, false };
+    a.coeff[0] = getCloverCoeff(0,1).elem().elem().elem();
+    a.coeff[1] = getCloverCoeff(0,2).elem().elem().elem();
+    a.coeff[2] = getCloverCoeff(0,3).elem().elem().elem();
+    a.coeff[3] = getCloverCoeff(1,2).elem().elem().elem();
+    a.coeff[4] = getCloverCoeff(1,3).elem().elem().elem();
+    a.coeff[5] = getCloverCoeff(2,3).elem().elem().elem();
+
+    // Other checkerboard: the term in both
+    dispatch_to_threads(rb[1-cb].numSiteTable(), a, QDPCloverEnv::fusedClovSiteLoop<U>);
+
+    // This checkerboard: the term and its inverse
+    a.cb = cb;
+    a.invertP = true;
+    dispatch_to_threads(rb[cb].numSiteTable(), a, QDPCloverEnv::fusedClovSiteLoop<U>);
+
+    inv.choles_done[cb] = true;
+
+    END_CODE();
+#endif
+  }
+
+
   /*! CHLCLOVMS - Cholesky decompose the clover mass term and uses it to
    *              compute  lower(A^-1) = lower((L.L^dag)^-1)
    *              Adapted from Golub and Van Loan, Matrix Computations, 2nd, Sec 4.2.4
@@ -2150,6 +2323,12 @@ namespace Chroma
     QDPCloverEnv::ApplyArgs<T> arg = { chi,psi,tri,cb };
     int num_sites = rb[cb].siteTable().size();
 
+    // Clover block, source and result are each streamed once
+    PerfCounters::Region perf_region("clover_apply",
+				     double(num_sites)*double(this->nFlops()),
+				     double(num_sites)*double(sizeof(PrimitiveClovTriang<REALT>))
+				     + 2*PerfCounters::fieldBytes(psi, rb[cb]));
+
     // The dispatch function is at the end of the file
     // ought to work for non-threaded targets too...
     dispatch_to_threads(num_sites, arg, QDPCloverEnv::applySiteLoop<T>);
@@ -2230,6 +2409,20 @@ namespace Chroma
   typedef QDPCloverTermT<LatticeFermion, LatticeColorMatrix> QDPCloverTerm;
   typedef QDPCloverTermT<LatticeFermionF, LatticeColorMatrixF> QDPCloverTermF;
   typedef QDPCloverTermT<LatticeFermionD, LatticeColorMatrixD> QDPCloverTermD;
+
+
+  //! Create a clover term and its inverse on cb with the fused pass
+  /*! \ingroup linop */
+  template<typename T, typename U>
+  inline
+  void createCloverWithInverse(QDPCloverTermT<T,U>& clov,
+			       QDPCloverTermT<T,U>& invclov,
+			       Handle< FermState<T, multi1d<U>, multi1d<U> > > fs,
+			       const CloverFermActParams& param,
+			       int cb)
+  {
+    clov.createWithInverse(fs, param, invclov, cb);
+  }
 } // End Namespace Chroma
 
 
@@ -8,6 +8,8 @@
 
 #include "chroma_config.h"
 #include "qdp_config.h"
+#include "state.h"
+#include "actions/ferm/fermacts/clover_fermact_params_w.h"
 
 // The QDP naive clover term
 //
@@ -99,4 +101,28 @@ namespace Chroma {
 #endif
 
 
+namespace Chroma {
+
+  //! Create a clover term and its inverse on cb
+  /*!
+   * \ingroup linop
+   *
+   * Terms with a fused setup overload this
+   */
+  template<typename C, typename T, typename P, typename Q>
+  inline
+  void createCloverWithInverse(C& clov,
+			       C& invclov,
+			       Handle< FermState<T,P,Q> > fs,
+			       const CloverFermActParams& param,
+			       int cb)
+  {
+    clov.create(fs, param);
+    invclov.create(fs, param, clov);  // make a copy
+    invclov.choles(cb);
+  }
+
+}  // end namespace Chroma
+
+
 #endif
@@ -24,13 +24,13 @@ namespace Chroma
 
     param = param_;
 
-    clov.create(fs, param);
- 
-    invclov.create(fs,param,clov);  // make a copy
-    invclov.choles(0);  // invert the cb=0 part
+    // The term, and its inverse on cb=0
+    createCloverWithInverse(clov, invclov, fs, param, 0);
 
     D.create(fs, param.anisoParam);
 
+    fused.create(fs, param, cloverTriangles(clov), cloverTriangles(invclov));
+
     clov_deriv_time = 0;
     clov_apply_time = 0;
 
@@ -145,6 +145,13 @@ namespace Chroma
   {
     START_CODE();
 
+    if (fused.usable())
+    {
+      fused.apply(chi, psi, isign);
+      END_CODE();
+      return;
+    }
+
     LatticeFermion tmp1; moveToFastMemoryHint(tmp1);
     LatticeFermion tmp2; moveToFastMemoryHint(tmp2);
     Real mquarter = -0.25;
@@ -187,6 +194,31 @@ namespace Chroma
   }
 
 
+  //! Apply M^dag M
+  /*!
+   * \param chi 	  Pseudofermion field     	       (Write)
+   * \param psi 	  Pseudofermion field     	       (Read)
+   */
+  void EvenOddPrecCloverLinOp::mdagm(LatticeFermion& chi, 
+				     const LatticeFermion& psi) const
+  {
+    START_CODE();
+
+    if (fused.usable())
+    {
+      fused.applyMdagM(chi, psi);
+    }
+    else
+    {
+      LatticeFermion tmp; moveToFastMemoryHint(tmp);
+      (*this)(tmp, psi, PLUS);
+      (*this)(chi, tmp, MINUS);
+    }
+
+    END_CODE();
+  }
+
+
   //! Apply the even-even block onto a source std::vector
   void 
   EvenOddPrecCloverLinOp::derivEvenEvenLinOp(multi1d<LatticeColorMatrix>& ds_u, 
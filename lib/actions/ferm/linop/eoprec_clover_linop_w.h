@@ -12,6 +12,8 @@
 #include "actions/ferm/fermacts/clover_fermact_params_w.h"
 #include "actions/ferm/linop/dslash_w.h"
 #include "actions/ferm/linop/clover_term_w.h"
+#include "actions/ferm/linop/clover_schur_fused_w.h"
+#include "lmdagm.h"
 
 
 namespace Chroma 
@@ -25,9 +27,13 @@ namespace Chroma
    * The kernel for Clover fermions is
    *
    *      M  =  A + (d+M) - (1/2) D'
+   *
+   * With a QDP clover term and FusedSchur set in the action, the Schur
+   * complement and M^dag.M are applied by FusedCloverSchur.
    */
   class EvenOddPrecCloverLinOp : public EvenOddPrecLogDetLinearOperator<LatticeFermion, 
-				 multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> >
+				 multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> >,
+				 public FusedMdagM<LatticeFermion>
   {
   public:
     // Typedefs to save typing
@@ -83,6 +89,12 @@ namespace Chroma
     void operator()(LatticeFermion& chi, const LatticeFermion& psi, 
 		    enum PlusMinus isign) const;
 
+    //! chi = M^dag M psi
+    void mdagm(LatticeFermion& chi, const LatticeFermion& psi) const;
+
+    //! Is the Schur complement applied by FusedCloverSchur
+    bool fusedSchurP() const {return fused.usable();}
+
     //! Apply the even-even block onto a source std::vector
     void derivEvenEvenLinOp(multi1d<LatticeColorMatrix>& ds_u, 
 			    const LatticeFermion& chi, const LatticeFermion& psi, 
@@ -126,6 +138,7 @@ namespace Chroma
     WilsonDslash D;
     CloverTerm   clov;
     CloverTerm   invclov;  // uggh, only needed for evenEvenLinOp
+    FusedCloverSchur fused;
     mutable double clov_apply_time;
     mutable double clov_deriv_time;
     mutable StopWatch swatch;
@@ -94,6 +94,22 @@ namespace Chroma
       result += tmp;
     }
 
+    //! Compute dS/dU and the action together
+    void derivAndS(multi1d<LatticeColorMatrix>& result,
+		   const Handle< GaugeState<P,Q> >& state,
+		   Double& S_out) const
+    {
+      Double S_plaq;
+      plaq->derivAndS(result,state,S_plaq);
+
+      multi1d<LatticeColorMatrix> tmp;
+      Double S_rect;
+      rect->derivAndS(tmp,state,S_rect);
+      result += tmp;
+
+      S_out = S_plaq + S_rect;
+    }
+
     //! Compute the actions
     Double S(const Handle< GaugeState<P,Q> >& state) const
     {
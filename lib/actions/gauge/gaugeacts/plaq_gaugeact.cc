@@ -329,14 +329,56 @@ namespace Chroma
   {
     START_CODE();
 
+    derivNoBC(ds_u, state->getLinks());
+
+    // Zero the force on any fixed boundaries
+    getGaugeBC().zero(ds_u);
+
+    END_CODE();
+  }
+
+
+  //! Computes the derivative and the action together
+  /*!
+   * Every plaquette turns up in the force on each of its four links as
+   * U_mu * staple, with the normalisation -c/(2Nc) instead of the -c/Nc
+   * of the action. So  S = (1/2) Sum_mu Sum_x Re Tr ds_u[mu]  on the
+   * force before the boundaries are zeroed, and no second set of
+   * plaquettes is built.
+   *
+   * \param ds_u       result      ( Write )
+   * \param state      gauge field ( Read )
+   * \param S_out      action      ( Write )
+   */
+  void
+  PlaqGaugeAct::derivAndS(multi1d<LatticeColorMatrix>& ds_u,
+			  const Handle< GaugeState<P,Q> >& state,
+			  Double& S_out) const
+  {
+    START_CODE();
+
+    derivNoBC(ds_u, state->getLinks());
+
+    S_out = Double(0.5) * sumReTrace(ds_u);
+
+    // Zero the force on any fixed boundaries
+    getGaugeBC().zero(ds_u);
+
+    END_CODE();
+  }
+
+
+  // dS/dU without the boundary conditions applied
+  void
+  PlaqGaugeAct::derivNoBC(multi1d<LatticeColorMatrix>& ds_u,
+			  const multi1d<LatticeColorMatrix>& u) const
+  {
     ds_u.resize(Nd);
 
     LatticeColorMatrix tmp_0;
     LatticeColorMatrix tmp_1;
     LatticeColorMatrix tmp_2;
 
-    const multi1d<LatticeColorMatrix>& u = state->getLinks();
-
     ds_u = zero;
 
     for(int mu = 0; mu < Nd; mu++)
@@ -400,11 +442,6 @@ namespace Chroma
       ds_u[mu] *= Real(-param.coeff)/(Real(2*Nc));
     }
 #endif
-
-    // Zero the force on any fixed boundaries
-    getGaugeBC().zero(ds_u);
-
-    END_CODE();
   }
 
 
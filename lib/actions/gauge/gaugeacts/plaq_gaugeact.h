@@ -92,6 +92,11 @@ namespace Chroma
     void deriv(multi1d<LatticeColorMatrix>& result,
 	       const Handle< GaugeState<P,Q> >& state) const;
 
+    //! Compute dS/dU and the action from the same staples
+    void derivAndS(multi1d<LatticeColorMatrix>& result,
+		   const Handle< GaugeState<P,Q> >& state,
+		   Double& S_out) const;
+
     //! compute spatial dS/dU given a time direction
     void derivSpatial(multi1d<LatticeColorMatrix>& result,
 		      const Handle< GaugeState<P,Q> >& state,
@@ -131,6 +136,10 @@ namespace Chroma
 	      const AnisoParam_t& aniso);
 
   private:
+    //! dS/dU without the boundary conditions applied
+    void derivNoBC(multi1d<LatticeColorMatrix>& ds_u,
+		   const multi1d<LatticeColorMatrix>& u) const;
+
     Handle< CreateGaugeState<P,Q> >  cgs;  /*!< Create Gauge State */
     PlaqGaugeActParams  param;             /*!< The parameters */
   };
@@ -275,13 +275,74 @@ namespace Chroma
     swatch.reset();
     swatch.start();
 
+    derivNoBC(ds_u, state->getLinks());
+
+    getGaugeBC().zero(ds_u);
+    swatch.stop();
+    RectGaugeActEnv::time_spent += swatch.getTimeInSeconds();
+#else
+
+    // This version uses new deriv_spatial/deriv_temporal structure.
+    // Above version saves a couple of closings of the staples
+    // so is faster and should be preferred.
+    // This is for testing only
+    ds_u.resize(Nd);
+    multi1d<LatticeColorMatrix> ds_tmp(Nd);
+    
+    ds_u = zero;
+    ds_tmp = zero;
+
+    derivSpatial(ds_u, state);
+    derivTemporal(ds_tmp, state);
+    
+    for(int mu=0; mu < Nd; ++mu) { 
+      ds_u[mu] += ds_tmp[mu];
+    }
+#endif
+    END_CODE();
+  }
+
+
+  //! Computes the derivative and the action together
+  /*!
+   * Each rectangle turns up in the force on each of its six links as
+   * U_mu * staple, with the normalisation -c/(2Nc) instead of the -c/Nc
+   * of the action. So  S = (1/3) Sum_mu Sum_x Re Tr ds_u[mu]  on the
+   * force before the boundaries are zeroed.
+   */
+  void
+  RectGaugeAct::derivAndS(multi1d<LatticeColorMatrix>& ds_u,
+			  const Handle< GaugeState<P,Q> >& state,
+			  Double& S_out) const
+  {
+    START_CODE();
+
+    QDP::StopWatch swatch;
+    swatch.reset();
+    swatch.start();
+
+    derivNoBC(ds_u, state->getLinks());
+
+    S_out = sumReTrace(ds_u) / Double(3);
+
+    getGaugeBC().zero(ds_u);
+    swatch.stop();
+    RectGaugeActEnv::time_spent += swatch.getTimeInSeconds();
+
+    END_CODE();
+  }
+
+
+  // dS/dU without the boundary conditions applied
+  void
+  RectGaugeAct::derivNoBC(multi1d<LatticeColorMatrix>& ds_u,
+			  const multi1d<LatticeColorMatrix>& u) const
+  {
     ds_u.resize(Nd);
     Real c;
 
     multi1d<LatticeColorMatrix> ds_tmp(Nd);
 
-    const multi1d<LatticeColorMatrix>& u = state->getLinks();
-    
     ds_u = zero;
     ds_tmp = zero; 
 
@@ -313,32 +374,9 @@ namespace Chroma
     for(int mu = 0; mu < Nd; mu++) { 
       ds_u[mu] = u[mu]*ds_tmp[mu];
     }
-
-    getGaugeBC().zero(ds_u);
-    swatch.stop();
-    RectGaugeActEnv::time_spent += swatch.getTimeInSeconds();
-#else
-
-    // This version uses new deriv_spatial/deriv_temporal structure.
-    // Above version saves a couple of closings of the staples
-    // so is faster and should be preferred.
-    // This is for testing only
-    ds_u.resize(Nd);
-    multi1d<LatticeColorMatrix> ds_tmp(Nd);
-    
-    ds_u = zero;
-    ds_tmp = zero;
-
-    derivSpatial(ds_u, state);
-    derivTemporal(ds_tmp, state);
-    
-    for(int mu=0; mu < Nd; ++mu) { 
-      ds_u[mu] += ds_tmp[mu];
-    }
-#endif
-    END_CODE();
   }
 
+
   void
   RectGaugeAct::derivSpatial(multi1d<LatticeColorMatrix>& ds_u,
 			     const Handle< GaugeState<P,Q> >& state) const
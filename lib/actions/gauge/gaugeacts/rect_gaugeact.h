@@ -84,6 +84,11 @@ namespace Chroma
     void deriv(multi1d<LatticeColorMatrix>& result,
 	       const Handle< GaugeState<P,Q> >& state) const;
 
+    //! Compute dS/dU and the action from the same staples
+    void derivAndS(multi1d<LatticeColorMatrix>& result,
+		   const Handle< GaugeState<P,Q> >& state,
+		   Double& S_out) const;
+
     //! compute spatial dS/dU given a time direction
     void derivSpatial(multi1d<LatticeColorMatrix>& result,
 		      const Handle< GaugeState<P,Q> >& state) const;
@@ -139,6 +144,10 @@ namespace Chroma
     Handle< CreateGaugeState<P,Q> >  cgs;  // Create gauge state
     RectGaugeActParams params; // THe parameter struct
 
+    // dS/dU without the boundary conditions applied
+    void derivNoBC(multi1d<LatticeColorMatrix>& ds_u, 
+		   const multi1d<LatticeColorMatrix>& u) const;
+
     // A function for computing the  contribution from one rectangle 
     // in the mu/nu plane specified.
     void deriv_part(int mu, int nu, Real c_munu,
@@ -75,6 +75,14 @@ namespace Chroma
       plaq->deriv(result,state);
     }
 
+    //! Compute dS/dU and the action together
+    void derivAndS(multi1d<LatticeColorMatrix>& result,
+		   const Handle< GaugeState<P,Q> >& state,
+		   Double& S_out) const
+    {
+      plaq->derivAndS(result,state,S_out);
+    }
+
     //! Compute the actions
     Double S(const Handle< GaugeState<P,Q> >& state) const
     {
@@ -62,6 +62,18 @@ namespace Chroma
     //! Compute the action on a gauge configuration
     virtual Double S(const Handle< GaugeState<P,Q> >& state) const = 0;
 
+    //! Compute dS/dU and the action together
+    /*! 
+     * Default version. Derived classes whose action can be read off the
+     * force they have just built should override this.
+     */
+    virtual void derivAndS(P& result, const Handle< GaugeState<P,Q> >& state,
+			   Double& S_out) const 
+    {
+      deriv(result, state);
+      S_out = S(state);
+    }
+
   };
 
 
@@ -92,6 +104,21 @@ namespace Chroma
     virtual void staple(LatticeColorMatrix& result,
 			const Handle< GaugeState<P,Q> >& state,
 			int mu, int cb) const = 0;
+
+  protected:
+    //! Sum of Re Tr of all the link components of a force  U_mu * staple_mu
+    /*!
+     * A closed loop of n links turns up once in the force on each of its
+     * links, so for a single loop shape this is n times Sum Re Tr loop.
+     */
+    static Double sumReTrace(const multi1d<LatticeColorMatrix>& ds_u)
+    {
+      LatticeReal tr = real(trace(ds_u[0]));
+      for(int mu=1; mu < ds_u.size(); ++mu)
+	tr += real(trace(ds_u[mu]));
+
+      return sum(tr);
+    }
   };
 
 }
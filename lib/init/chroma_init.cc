@@ -6,6 +6,7 @@
 
 #include "init/chroma_init.h"
 #include "io/xmllog_io.h"
+#include "util/info/perf_counters.h"
 
 #include "qdp_init.h"
 
@@ -140,6 +141,10 @@ namespace Chroma
 		    << "   --chroma-l   [" << getXMLLogFileName() << "]  xml log file name\n"
 		    << "   -cwd         [" << getCWD() << "]  xml working directory\n"
 		    << "   --chroma-cwd [" << getCWD() << "]  xml working directory\n"
+		    << "   -perf               per-kernel flop/byte summary\n"
+		    << "   --chroma-perf       per-kernel flop/byte summary\n"
+		    << "   -perf-trace <file>  summary and Chrome/Perfetto trace json\n"
+		    << "   --chroma-perf-trace <file>  summary and Chrome/Perfetto trace json\n"
 
 		    
 		    << std::endl;
@@ -208,6 +213,27 @@ namespace Chroma
 	}
       }
 
+      // Search for -perf or --chroma-perf
+      if( argv_i == std::string("-perf") || argv_i == std::string("--chroma-perf") ) 
+      {
+	PerfCounters::enable("");
+      }
+
+      // Search for -perf-trace or --chroma-perf-trace
+      if( argv_i == std::string("-perf-trace") || argv_i == std::string("--chroma-perf-trace") ) 
+      {
+	if( i + 1 < *argc ) {
+	  PerfCounters::enable(std::string( (*argv)[i+1] ));
+	  // Skip over next
+	  i++;
+	}
+	else {
+	  // i + 1 is too big
+	  QDPIO::cerr << "Error: dangling -perf-trace specified. " << std::endl;
+	  QDP_abort(1);
+	}
+      }
+
     }
 
 
@@ -329,6 +355,8 @@ namespace Chroma
     if (! QDP_isInitialized())
       return;
 
+    // Dump the kernel trace if one was requested
+    PerfCounters::writeTrace();
     
     /*
     if( xmlInputP ) { 
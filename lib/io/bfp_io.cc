@@ -0,0 +1,424 @@
+/*! \file
+ * \brief Block floating point (compressed) QIO files for propagators and fermions
+ *
+ * On disk the object is a multi1d<LatticeInteger> record. Per site the
+ * words hold first the shared exponents, one per block, and then the
+ * 16-bit mantissas packed two per word.
+ */
+
+#include "io/bfp_io.h"
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+namespace Chroma
+{
+
+  namespace BFPIO
+  {
+    namespace
+    {
+      //! Stored mantissa width
+      const int mantissa_bits = 16;
+
+      //! Largest stored mantissa
+      const int mantissa_max = (1 << (mantissa_bits-1)) - 1;
+
+      //! Error of each element relative to the largest magnitude in its block
+      double relErrorBound()
+      {
+	return std::ldexp(1.0, 2-mantissa_bits);
+      }
+
+      std::string blockName(BFPBlock_t block)
+      {
+	return (block == BFP_SITE) ? std::string("SITE") : std::string("SPIN_COLOR");
+      }
+
+      BFPBlock_t blockType(const std::string& name)
+      {
+	if (name == "SITE")
+	  return BFP_SITE;
+	else if (name == "SPIN_COLOR")
+	  return BFP_SPIN_COLOR;
+
+	std::ostringstream error_stream;
+	error_stream << "BFPIO: unknown block type = " << name << std::endl;
+	throw error_stream.str();
+      }
+
+
+      //! Flattening of the site data into blocks of reals
+      template<typename T> struct SiteTraits;
+
+      //! Propagator blocks are the columns (source spin and colour)
+      template<> struct SiteTraits<LatticePropagator>
+      {
+	static std::string name() {return "LatticePropagator";}
+	static int numBlocks() {return Ns*Nc;}
+	static int blockLen() {return 2*Ns*Nc;}
+
+	static void get(const LatticePropagator& p, int site, double* x)
+	{
+	  int n = 0;
+	  for(int s2=0; s2 < Ns; ++s2)
+	    for(int c2=0; c2 < Nc; ++c2)
+	      for(int s1=0; s1 < Ns; ++s1)
+		for(int c1=0; c1 < Nc; ++c1)
+		{
+		  x[n++] = p.elem(site).elem(s1,s2).elem(c1,c2).real();
+		  x[n++] = p.elem(site).elem(s1,s2).elem(c1,c2).imag();
+		}
+	}
+
+	static void set(LatticePropagator& p, int site, const double* x)
+	{
+	  int n = 0;
+	  for(int s2=0; s2 < Ns; ++s2)
+	    for(int c2=0; c2 < Nc; ++c2)
+	      for(int s1=0; s1 < Ns; ++s1)
+		for(int c1=0; c1 < Nc; ++c1)
+		{
+		  p.elem(site).elem(s1,s2).elem(c1,c2).real() = x[n++];
+		  p.elem(site).elem(s1,s2).elem(c1,c2).imag() = x[n++];
+		}
+	}
+      };
+
+      //! Fermion blocks are the spin components
+      template<> struct SiteTraits<LatticeFermion>
+      {
+	static std::string name() {return "LatticeFermion";}
+	static int numBlocks() {return Ns;}
+	static int blockLen() {return 2*Nc;}
+
+	static void get(const LatticeFermion& p, int site, double* x)
+	{
+	  int n = 0;
+	  for(int s=0; s < Ns; ++s)
+	    for(int c=0; c < Nc; ++c)
+	    {
+	      x[n++] = p.elem(site).elem(s).elem(c).real();
+	      x[n++] = p.elem(site).elem(s).elem(c).imag();
+	    }
+	}
+
+	static void set(LatticeFermion& p, int site, const double* x)
+	{
+	  int n = 0;
+	  for(int s=0; s < Ns; ++s)
+	    for(int c=0; c < Nc; ++c)
+	    {
+	      p.elem(site).elem(s).elem(c).real() = x[n++];
+	      p.elem(site).elem(s).elem(c).imag() = x[n++];
+	    }
+	}
+      };
+
+
+      //! Number of exponents per site
+      template<typename T>
+      int numExponents(BFPBlock_t block)
+      {
+	return (block == BFP_SITE) ? 1 : SiteTraits<T>::numBlocks();
+      }
+
+      //! Number of words per site
+      template<typename T>
+      int numWords(BFPBlock_t block)
+      {
+	int nreal = SiteTraits<T>::numBlocks() * SiteTraits<T>::blockLen();
+	return numExponents<T>(block) + (nreal + 1)/2;
+      }
+
+      int& word(LatticeInteger& w, int site) {return w.elem(site).elem().elem().elem();}
+      int  word(const LatticeInteger& w, int site) {return w.elem(site).elem().elem().elem();}
+
+
+      //! Arguments for the site loops
+      template<typename T>
+      struct CodecArgs
+      {
+	T&                        obj;
+	multi1d<LatticeInteger>&  words;
+	BFPBlock_t                block;
+      };
+
+
+      //! Compress sites [lo,hi)
+      template<typename T>
+      void encodeSiteLoop(int lo, int hi, int myId, CodecArgs<T>* arg)
+      {
+#ifndef QDP_IS_QDPJIT
+	const int nblock = SiteTraits<T>::numBlocks();
+	const int blen   = SiteTraits<T>::blockLen();
+	const int nexp   = numExponents<T>(arg->block);
+	const int nreal  = nblock*blen;
+	const int per    = nreal / nexp;      // reals sharing one exponent
+
+	std::vector<double> x(nreal + 1, 0.0);
+	std::vector<int>    q(nreal + 1, 0);
+
+	for(int site=lo; site < hi; ++site)
+	{
+	  SiteTraits<T>::get(arg->obj, site, &x[0]);
+
+	  for(int b=0; b < nexp; ++b)
+	  {
+	    double m = 0;
+	    for(int i=b*per; i < (b+1)*per; ++i)
+	      m = std::max(m, std::fabs(x[i]));
+
+	    // m = f * 2^e  with 0.5 <= f < 1, so all |x| < 2^e
+	    int e = 0;
+	    if (m > 0)
+	      std::frexp(m, &e);
+
+	    double scale = std::ldexp(1.0, mantissa_bits-1-e);
+	    for(int i=b*per; i < (b+1)*per; ++i)
+	    {
+	      long r = std::lround(x[i] * scale);
+	      q[i] = int(std::max(long(-mantissa_max), std::min(long(mantissa_max), r)));
+	    }
+
+	    word(arg->words[b], site) = e;
+	  }
+
+	  for(int i=0; i < nreal; i += 2)
+	  {
+	    unsigned int lo16 = (unsigned short)(q[i]);
+	    unsigned int hi16 = (unsigned short)(q[i+1]);
+	    word(arg->words[nexp + i/2], site) = int(lo16 | (hi16 << 16));
+	  }
+	}
+#endif
+      }
+
+
+      //! Expand sites [lo,hi)
+      template<typename T>
+      void decodeSiteLoop(int lo, int hi, int myId, CodecArgs<T>* arg)
+      {
+#ifndef QDP_IS_QDPJIT
+	const int nblock = SiteTraits<T>::numBlocks();
+	const int blen   = SiteTraits<T>::blockLen();
+	const int nexp   = numExponents<T>(arg->block);
+	const int nreal  = nblock*blen;
+	const int per    = nreal / nexp;
+
+	std::vector<double> x(nreal + 1, 0.0);
+
+	for(int site=lo; site < hi; ++site)
+	{
+	  for(int i=0; i < nreal; i += 2)
+	  {
+	    unsigned int w = (unsigned int)(word(arg->words[nexp + i/2], site));
+	    x[i]   = double(short(w & 0xffff));
+	    x[i+1] = double(short(w >> 16));
+	  }
+
+	  for(int b=0; b < nexp; ++b)
+	  {
+	    double scale = std::ldexp(1.0, word(arg->words[b], site) - (mantissa_bits-1));
+	    for(int i=b*per; i < (b+1)*per; ++i)
+	      x[i] *= scale;
+	  }
+
+	  SiteTraits<T>::set(arg->obj, site, &x[0]);
+	}
+#endif
+      }
+
+
+      //! Check the site loops can run
+      void checkHost()
+      {
+#ifdef QDP_IS_QDPJIT
+	std::ostringstream error_stream;
+	error_stream << "BFPIO: block floating point IO is not supported with QDP-JIT" << std::endl;
+	throw error_stream.str();
+#endif
+      }
+
+
+      //! Compress
+      template<typename T>
+      void encode(const T& obj, BFPBlock_t block, multi1d<LatticeInteger>& words)
+      {
+	checkHost();
+
+	words.resize(numWords<T>(block));
+	for(int i=0; i < words.size(); ++i)
+	  words[i] = zero;
+
+	CodecArgs<T> args = {const_cast<T&>(obj), words, block};
+	dispatch_to_threads(Layout::sitesOnNode(), args, encodeSiteLoop<T>);
+      }
+
+      //! Expand
+      template<typename T>
+      void decode(multi1d<LatticeInteger>& words, BFPBlock_t block, T& obj)
+      {
+	checkHost();
+
+	CodecArgs<T> args = {obj, words, block};
+	dispatch_to_threads(Layout::sitesOnNode(), args, decodeSiteLoop<T>);
+      }
+
+
+      //! Replace xml by the group nested in the wrapper at path
+      /*! An empty original comes back as the empty wrapper */
+      void unwrap(XMLReader& xml, const std::string& path)
+      {
+	const std::string inner_path = (xml.count(path + "/*") == 0) ? path : path + "/*";
+
+	XMLReader inner(xml, inner_path);
+	std::ostringstream os;
+	inner.printCurrentContext(os);
+
+	std::istringstream is(os.str());
+	xml.open(is);
+      }
+
+
+      //! Write
+      template<typename T>
+      void writeBFPT(XMLReader& file_xml, XMLReader& record_xml,
+		     const T& obj,
+		     const std::string& file, BFPBlock_t block,
+		     QDP_volfmt_t volfmt, QDP_serialparallel_t serpar)
+      {
+	START_CODE();
+
+	multi1d<LatticeInteger> words;
+	encode(obj, block, words);
+
+	// Measure what was lost
+	T dec;
+	decode(words, block, dec);
+
+	Double obj_norm = norm2(obj);
+	Double rel_l2_error = zero;
+	if (toBool(obj_norm > 0))
+	  rel_l2_error = sqrt(norm2(obj - dec) / obj_norm);
+
+	// Layout goes into the file XML, so a reader can size the record
+	XMLBufferWriter bfp_file_xml;
+	push(bfp_file_xml, "BlockFloatingPoint");
+	write(bfp_file_xml, "object_type", SiteTraits<T>::name());
+	write(bfp_file_xml, "block", blockName(block));
+	write(bfp_file_xml, "mantissa_bits", mantissa_bits);
+	write(bfp_file_xml, "nword", words.size());
+	push(bfp_file_xml, "FileXML");
+	bfp_file_xml << file_xml;
+	pop(bfp_file_xml);
+	pop(bfp_file_xml);
+
+	// Error bound goes into the record XML
+	XMLBufferWriter bfp_record_xml;
+	push(bfp_record_xml, "BlockFloatingPoint");
+	write(bfp_record_xml, "rel_error_bound", relErrorBound());
+	write(bfp_record_xml, "rel_l2_error", rel_l2_error);
+	push(bfp_record_xml, "RecordXML");
+	bfp_record_xml << record_xml;
+	pop(bfp_record_xml);
+	pop(bfp_record_xml);
+
+	QDPIO::cout << "BFPIO: writing " << SiteTraits<T>::name()
+		    << " block=" << blockName(block)
+		    << "  words/site=" << words.size()
+		    << "  rel_l2_error=" << rel_l2_error << std::endl;
+
+	QDPFileWriter to(bfp_file_xml, file, volfmt, serpar, QDPIO_OPEN);
+	write(to, bfp_record_xml, words);
+	close(to);
+
+	END_CODE();
+      }
+
+
+      //! Read
+      template<typename T>
+      void readBFPT(XMLReader& file_xml, XMLReader& record_xml,
+		    T& obj,
+		    const std::string& file, QDP_serialparallel_t serpar)
+      {
+	START_CODE();
+
+	QDPFileReader from(file_xml, file, serpar);
+
+	std::string object_type, block_name;
+	int bits, nword;
+	{
+	  XMLReader bfptop(file_xml, "/BlockFloatingPoint");
+	  read(bfptop, "object_type", object_type);
+	  read(bfptop, "block", block_name);
+	  read(bfptop, "mantissa_bits", bits);
+	  read(bfptop, "nword", nword);
+	}
+	BFPBlock_t block = blockType(block_name);
+
+	if (object_type != SiteTraits<T>::name() || bits != mantissa_bits || nword != numWords<T>(block))
+	{
+	  std::ostringstream error_stream;
+	  error_stream << "BFPIO: incompatible file " << file
+		       << ": object_type=" << object_type
+		       << " mantissa_bits=" << bits
+		       << " nword=" << nword << std::endl;
+	  throw error_stream.str();
+	}
+
+	multi1d<LatticeInteger> words(nword);
+	read(from, record_xml, words);
+	close(from);
+
+	decode(words, block, obj);
+
+	// Hand back the original metadata
+	unwrap(file_xml, "/BlockFloatingPoint/FileXML");
+	unwrap(record_xml, "/BlockFloatingPoint/RecordXML");
+
+	END_CODE();
+      }
+
+    } // anonymous namespace
+
+
+    // Write a propagator in block floating point
+    void writeBFP(XMLReader& file_xml, XMLReader& record_xml,
+		  const LatticePropagator& obj,
+		  const std::string& file, BFPBlock_t block,
+		  QDP_volfmt_t volfmt, QDP_serialparallel_t serpar)
+    {
+      writeBFPT(file_xml, record_xml, obj, file, block, volfmt, serpar);
+    }
+
+    // Write a fermion in block floating point
+    void writeBFP(XMLReader& file_xml, XMLReader& record_xml,
+		  const LatticeFermion& obj,
+		  const std::string& file, BFPBlock_t block,
+		  QDP_volfmt_t volfmt, QDP_serialparallel_t serpar)
+    {
+      writeBFPT(file_xml, record_xml, obj, file, block, volfmt, serpar);
+    }
+
+    // Read a block floating point propagator
+    void readBFP(XMLReader& file_xml, XMLReader& record_xml,
+		 LatticePropagator& obj,
+		 const std::string& file, QDP_serialparallel_t serpar)
+    {
+      readBFPT(file_xml, record_xml, obj, file, serpar);
+    }
+
+    // Read a block floating point fermion
+    void readBFP(XMLReader& file_xml, XMLReader& record_xml,
+		 LatticeFermion& obj,
+		 const std::string& file, QDP_serialparallel_t serpar)
+    {
+      readBFPT(file_xml, record_xml, obj, file, serpar);
+    }
+
+  } // namespace BFPIO
+
+}  // end namespace Chroma
@@ -0,0 +1,82 @@
+// -*- C++ -*-
+/*! \file
+ * \brief Block floating point (compressed) QIO files for propagators and fermions
+ *
+ * Each block of reals shares one binary exponent and stores 16-bit
+ * mantissas. A block is either a whole site, or one spin-colour column
+ * of a propagator (one spin component of a fermion). Each element is
+ * stored to within 2^-14 of the largest magnitude in its block.
+ *
+ * Plain single precision, with no shared exponents, is the separate
+ * LatticePropagatorF object type and needs 144 words per site. The
+ * BFP files have no striping of their own: parallel and striped writes
+ * use the parallel_io flag and the PARTFILE/MULTIFILE volume formats
+ * like any other QIO file.
+ */
+
+#ifndef __bfp_io_h__
+#define __bfp_io_h__
+
+#include "chromabase.h"
+
+namespace Chroma
+{
+
+  //! Block floating point compression
+  /*! \ingroup io */
+  namespace BFPIO
+  {
+    //! Exponent sharing
+    enum BFPBlock_t
+    {
+      BFP_SITE,          /*!< one exponent per site */
+      BFP_SPIN_COLOR     /*!< one exponent per spin-colour column */
+    };
+
+    //! Write a propagator in block floating point
+    /*!
+     * The file XML is wrapped in a BlockFloatingPoint group holding the
+     * layout, and the record XML in a BlockFloatingPoint group holding the
+     * error bound and the measured error.
+     *
+     * \param file_xml     file XML of the object ( Read )
+     * \param record_xml   record XML of the object ( Read )
+     * \param obj          propagator ( Read )
+     * \param file         file name ( Read )
+     * \param block        exponent sharing ( Read )
+     * \param volfmt       volume format ( Read )
+     * \param serpar       serial or parallel IO ( Read )
+     */
+    void writeBFP(XMLReader& file_xml, XMLReader& record_xml,
+		  const LatticePropagator& obj,
+		  const std::string& file, BFPBlock_t block,
+		  QDP_volfmt_t volfmt, QDP_serialparallel_t serpar);
+
+    //! Write a fermion in block floating point
+    void writeBFP(XMLReader& file_xml, XMLReader& record_xml,
+		  const LatticeFermion& obj,
+		  const std::string& file, BFPBlock_t block,
+		  QDP_volfmt_t volfmt, QDP_serialparallel_t serpar);
+
+    //! Read a block floating point propagator
+    /*!
+     * \param file_xml     original file XML of the object ( Write )
+     * \param record_xml   original record XML of the object ( Write )
+     * \param obj          propagator ( Write )
+     * \param file         file name ( Read )
+     * \param serpar       serial or parallel IO ( Read )
+     */
+    void readBFP(XMLReader& file_xml, XMLReader& record_xml,
+		 LatticePropagator& obj,
+		 const std::string& file, QDP_serialparallel_t serpar);
+
+    //! Read a block floating point fermion
+    void readBFP(XMLReader& file_xml, XMLReader& record_xml,
+		 LatticeFermion& obj,
+		 const std::string& file, QDP_serialparallel_t serpar);
+
+  } // namespace BFPIO
+
+}  // end namespace Chroma
+
+#endif
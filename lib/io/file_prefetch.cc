@@ -0,0 +1,149 @@
+/*! \file
+ * \brief Read whole files ahead of their use on I/O threads
+ */
+
+#include "io/file_prefetch.h"
+
+#include <fstream>
+#include <new>
+
+namespace Chroma
+{
+
+  namespace
+  {
+    //! Whole contents of a file
+    bool readFile(const std::string& file, std::string& buf)
+    {
+      std::ifstream in(file.c_str(), std::ios::in | std::ios::binary);
+      if (! in)
+	return false;
+
+      // tellg gives -1 on a stream it cannot position, e.g. a pipe or a
+      // directory. Nothing may throw here, this runs on the reader thread
+      in.seekg(0, std::ios::end);
+      std::streamoff size = in.tellg();
+      in.seekg(0, std::ios::beg);
+
+      if (! in || size < 0)
+	return false;
+
+      try
+      {
+	buf.resize(size);
+      }
+      catch(const std::bad_alloc&)
+      {
+	buf.clear();
+	return false;
+      }
+
+      if (size > 0)
+	in.read(&buf[0], size);
+
+      return bool(in);
+    }
+  }
+
+
+  // Start reading
+  FilePrefetcher::FilePrefetcher(const multi1d<std::string>& files_, int readahead_, int num_threads) :
+    files(files_.size()), slots(files_.size()),
+    readahead(readahead_), next_read(0), next_take(0), stop(false)
+  {
+    for(int i=0; i < files_.size(); ++i)
+    {
+      files[i] = files_[i];
+      slots[i].ready = false;
+      slots[i].ok    = false;
+    }
+
+    if (readahead < 0)
+      readahead = 0;
+
+    if (num_threads < 1)
+      num_threads = 1;
+
+    if (Layout::primaryNode())
+    {
+      for(int n=0; n < num_threads; ++n)
+	threads.push_back(std::thread(&FilePrefetcher::worker, this));
+    }
+  }
+
+
+  // Stops the I/O threads
+  FilePrefetcher::~FilePrefetcher()
+  {
+    {
+      std::lock_guard<std::mutex> lk(mtx);
+      stop = true;
+    }
+    cv.notify_all();
+
+    for(int n=0; n < threads.size(); ++n)
+      threads[n].join();
+  }
+
+
+  // Body of an I/O thread
+  void FilePrefetcher::worker()
+  {
+    std::unique_lock<std::mutex> lk(mtx);
+
+    while (true)
+    {
+      cv.wait(lk, [this]{ return stop || next_read >= int(files.size()) || next_read <= next_take + readahead; });
+
+      if (stop || next_read >= int(files.size()))
+	return;
+
+      int i = next_read++;
+
+      lk.unlock();
+      std::string buf;
+      bool ok = readFile(files[i], buf);
+      lk.lock();
+
+      slots[i].buf.swap(buf);
+      slots[i].ok    = ok;
+      slots[i].ready = true;
+      cv.notify_all();
+    }
+  }
+
+
+  // Contents of the next file
+  void FilePrefetcher::next(std::string& buf)
+  {
+    if (next_take >= int(files.size()))
+      throw std::string("FilePrefetcher: no more files");
+
+    const std::string& file = files[next_take];
+    int ok = 1;
+
+    buf.clear();
+
+    if (Layout::primaryNode())
+    {
+      std::unique_lock<std::mutex> lk(mtx);
+      cv.wait(lk, [this]{ return slots[next_take].ready; });
+
+      buf.swap(slots[next_take].buf);
+      ok = slots[next_take].ok ? 1 : 0;
+      ++next_take;
+      lk.unlock();
+      cv.notify_all();
+    }
+    else
+    {
+      ++next_take;
+    }
+
+    QDPInternal::broadcast(ok);
+
+    if (! ok)
+      throw std::string("FilePrefetcher: error reading ") + file;
+  }
+
+} // namespace Chroma
@@ -0,0 +1,78 @@
+// -*- C++ -*-
+/*! \file
+ * \brief Read whole files ahead of their use on I/O threads
+ */
+
+#ifndef __file_prefetch_h__
+#define __file_prefetch_h__
+
+#include "chromabase.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+
+namespace Chroma
+{
+
+  //! Read a list of files ahead of their use
+  /*! \ingroup io
+   *
+   * On the primary node, I/O threads read the files into memory, several
+   * at a time and at most  readahead  beyond the next one to be taken. The
+   * contents are handed out in order and can be parsed with a
+   * BinaryBufferReader, so the scatter of one file overlaps the reads of
+   * the next ones. The other nodes get empty buffers, as QDP only reads
+   * on the primary node anyway.
+   *
+   * Memory on the primary node is up to  readahead+2  whole files.
+   */
+  class FilePrefetcher
+  {
+  public:
+    //! Start reading
+    /*!
+     * \param files        files in the order they will be taken ( Read )
+     * \param readahead    number of files read beyond the next one ( Read )
+     * \param num_threads  number of I/O threads ( Read )
+     */
+    FilePrefetcher(const multi1d<std::string>& files, int readahead, int num_threads);
+
+    //! Stops the I/O threads
+    ~FilePrefetcher();
+
+    //! Contents of the next file, waiting for it if needed
+    /*! Throws a std::string on all nodes if the file could not be read */
+    void next(std::string& buf);
+
+  private:
+    //! Hide copy and assignment
+    FilePrefetcher(const FilePrefetcher&);
+    void operator=(const FilePrefetcher&);
+
+    //! Body of an I/O thread
+    void worker();
+
+    struct Slot_t
+    {
+      std::string  buf;
+      bool         ready;
+      bool         ok;
+    };
+
+    std::vector<std::string>   files;
+    std::vector<Slot_t>        slots;
+    int                        readahead;
+    int                        next_read;   /*!< next file to start reading */
+    int                        next_take;   /*!< next file to hand out */
+    bool                       stop;
+
+    std::mutex                 mtx;
+    std::condition_variable    cv;
+    std::vector<std::thread>   threads;
+  };
+
+} // namespace Chroma
+
+#endif
@@ -1123,6 +1123,16 @@ namespace Chroma
   }
 
 
+  // CoherentSink header reader
+  void read(XMLReader& xml, const std::string& path, CoherentSink_t& param)
+  {
+    XMLReader paramtop(xml, path);
+
+    read(paramtop, "SeqSource", param.seqsource_header);
+    read(paramtop, "ForwardProps", param.forward_props);
+  }
+
+
   // SequentialSource header reader
   void read(XMLReader& xml, const std::string& path, SequentialSource_t& param)
   {
@@ -1132,6 +1142,10 @@ namespace Chroma
     read(paramtop, "SeqSource", param.seqsource_header);
     read(paramtop, "ForwardProps", param.forward_props);
     readGaugeHeader(paramtop, "Config_info", param.gauge_header);
+
+    param.coherent_sinks.resize(0);
+    if (paramtop.count("CoherentSinks") != 0)
+      read(paramtop, "CoherentSinks", param.coherent_sinks);
   }
 
 
@@ -1145,6 +1159,69 @@ namespace Chroma
     read(paramtop, "SeqSource", param.seqsource_header);
     read(paramtop, "ForwardProps", param.forward_props);
     readGaugeHeader(paramtop, "Config_info", param.gauge_header);
+
+    param.coherent_sinks.resize(0);
+    if (paramtop.count("CoherentSinks") != 0)
+      read(paramtop, "CoherentSinks", param.coherent_sinks);
+  }
+
+
+  // The SeqSource header as seen from one forward source
+  void readSeqSources(XMLReader& xml, const std::string& path,
+		      const PropSourceConst_t& source_header,
+		      multi1d<SeqSource_t>& seqsource_headers)
+  {
+    XMLReader paramtop(xml, path);
+
+    if (paramtop.count("CoherentSinks") == 0)
+    {
+      seqsource_headers.resize(1);
+      read(paramtop, "SeqSource", seqsource_headers[0]);
+      return;
+    }
+
+    multi1d<CoherentSink_t> coherent_sinks;
+    read(paramtop, "CoherentSinks", coherent_sinks);
+
+    multi1d<int> t_srce = source_header.getTSrce();
+
+    // Count, then copy the sinks made from this source
+    multi1d<bool> match(coherent_sinks.size());
+    int num = 0;
+    for(int i=0; i < coherent_sinks.size(); ++i)
+    {
+      match[i] = false;
+      if (coherent_sinks[i].forward_props.size() == 0)
+	continue;
+
+      multi1d<int> t = coherent_sinks[i].forward_props[0].source_header.getTSrce();
+
+      bool sameP = (t.size() == t_srce.size());
+      for(int mu=0; sameP && mu < t.size(); ++mu)
+	sameP = (t[mu] == t_srce[mu]);
+
+      match[i] = sameP;
+      if (sameP)
+	++num;
+    }
+
+    if (num == 0)
+      throw std::string("readSeqSource: no coherent sink belongs to the forward source");
+
+    seqsource_headers.resize(num);
+    for(int i=0, n=0; i < coherent_sinks.size(); ++i)
+      if (match[i])
+	seqsource_headers[n++] = coherent_sinks[i].seqsource_header;
+  }
+
+
+  void readSeqSource(XMLReader& xml, const std::string& path,
+		     const PropSourceConst_t& source_header,
+		     SeqSource_t& seqsource_header)
+  {
+    multi1d<SeqSource_t> seqsource_headers;
+    readSeqSources(xml, path, source_header, seqsource_headers);
+    seqsource_header = seqsource_headers[0];
   }
 
 
@@ -1417,6 +1494,18 @@ namespace Chroma
   }
 
 
+  //! CoherentSink header writer
+  void write(XMLWriter& xml, const std::string& path, const CoherentSink_t& param)
+  {
+    push(xml, path);
+
+    write(xml, "SeqSource", param.seqsource_header);
+    write(xml, "ForwardProps", param.forward_props);
+
+    pop(xml);
+  }
+
+
   //! SequentialSource header writer
   void write(XMLWriter& xml, const std::string& path, const SequentialSource_t& param)
   {
@@ -1429,6 +1518,8 @@ namespace Chroma
     write(xml, "SeqSource", param.seqsource_header);
     write(xml, "ForwardProps", param.forward_props);
     write(xml, "Config_info", param.gauge_header);
+    if (param.coherent_sinks.size() > 0)
+      write(xml, "CoherentSinks", param.coherent_sinks);
 
 //    if( path != "." )
     pop(xml);
@@ -1448,6 +1539,8 @@ namespace Chroma
     write(xml, "SeqSource", param.seqsource_header);
     write(xml, "ForwardProps", param.forward_props);
     write(xml, "Config_info", param.gauge_header);
+    if (param.coherent_sinks.size() > 0)
+      write(xml, "CoherentSinks", param.coherent_sinks);
 
 //    if( path != "." )
     pop(xml);
@@ -125,12 +125,26 @@ namespace Chroma
   };
 
 
+  //! One of the sinks summed into a coherent sequential source
+  struct CoherentSink_t
+  {
+    SeqSource_t             seqsource_header;
+    multi1d<ForwardProp_t>  forward_props;
+  };
+
+
   //! Mega structure holding a full sequential source
+  /*!
+   * A coherent source sums the sequential sources of several forward
+   * sources or sink time slices. All of them are listed in coherent_sinks,
+   * and the first one is also held in seqsource_header and forward_props.
+   */
   struct SequentialSource_t
   {
     PropSinkSmear_t         sink_header;
     SeqSource_t             seqsource_header;
     multi1d<ForwardProp_t>  forward_props;
+    multi1d<CoherentSink_t> coherent_sinks;   /*!< empty unless coherent */
     std::string             gauge_header;
   };
 
@@ -138,11 +152,12 @@ namespace Chroma
   //! Mega structure holding a full sequential prop
   struct SequentialProp_t
   {
-    ChromaProp_t           seqprop_header;
-    PropSinkSmear_t        sink_header;
-    SeqSource_t            seqsource_header;
-    multi1d<ForwardProp_t> forward_props;
-    std::string            gauge_header;
+    ChromaProp_t            seqprop_header;
+    PropSinkSmear_t         sink_header;
+    SeqSource_t             seqsource_header;
+    multi1d<ForwardProp_t>  forward_props;
+    multi1d<CoherentSink_t> coherent_sinks;   /*!< empty unless coherent */
+    std::string             gauge_header;
   };
 
 
@@ -264,6 +279,13 @@ namespace Chroma
   void write(XMLWriter& xml, const std::string& path, const ForwardProp_t& header);
 
 
+  //! CoherentSink reader
+  void read(XMLReader& xml, const std::string& path, CoherentSink_t& header);
+
+  //! CoherentSink writer
+  void write(XMLWriter& xml, const std::string& path, const CoherentSink_t& header);
+
+
   //! SequentialSource reader
   void read(XMLReader& xml, const std::string& path, SequentialSource_t& header);
 
@@ -278,6 +300,29 @@ namespace Chroma
   void write(XMLWriter& xml, const std::string& path, const SequentialProp_t& header);
 
 
+  //! The SeqSource headers of a sequential prop as seen from one forward source
+  /*!
+   * For a coherent sequential prop these are the sinks whose forward props
+   * were made from the given source, in the order they were summed. They
+   * differ in t_sink. Otherwise it is simply the SeqSource header.
+   * Throws if no sink belongs to the source.
+   *
+   * \param xml               sequential prop record xml          ( Read )
+   * \param path              path to the SequentialProp header   ( Read )
+   * \param source_header     source of the forward prop          ( Read )
+   * \param seqsource_headers the matching SeqSource headers      ( Write )
+   */
+  void readSeqSources(XMLReader& xml, const std::string& path,
+		      const PropSourceConst_t& source_header,
+		      multi1d<SeqSource_t>& seqsource_headers);
+
+  //! The first SeqSource header of a sequential prop as seen from one forward source
+  /*! See readSeqSources */
+  void readSeqSource(XMLReader& xml, const std::string& path,
+		     const PropSourceConst_t& source_header,
+		     SeqSource_t& seqsource_header);
+
+
   //! Source/sink spin indices
   void read(XMLReader& xml, const std::string& path, QQQSpinIndices_t& input);
 
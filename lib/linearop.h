@@ -39,6 +39,19 @@ namespace Chroma
       (*this)(chi,psi,isign);
     }
 
+    //! Apply the operator onto several source vectors
+    /*!
+     * Operators that can share work between the vectors, like the
+     * gauge field communications, override this
+     */
+    virtual void operator() (multi1d<T>& chi, const multi1d<T>& psi, 
+			     enum PlusMinus isign) const
+    {
+      chi.resize(psi.size());
+      for(int n=0; n < psi.size(); ++n)
+	(*this)(chi[n],psi[n],isign);
+    }
+
     //! Return the subset on which the operator acts
     virtual const Subset& subset() const = 0;
 
@@ -11,6 +11,43 @@
 
 namespace Chroma 
 { 
+  //! Operators with their own M^dag.M
+  /*!
+   * \ingroup linop
+   *
+   * An operator that can apply M^dag.M in fewer memory passes than
+   * M followed by M^dag derives from this as well.
+   */
+  template<typename T>
+  class FusedMdagM
+  {
+  public:
+    //! Virtual destructor to help with cleanup;
+    virtual ~FusedMdagM() {}
+
+    //! chi = M^dag M psi
+    virtual void mdagm(T& chi, const T& psi) const = 0;
+  };
+
+
+  //! chi = M^dag M psi, fused if the operator provides it
+  /*! \ingroup linop */
+  template<typename T>
+  inline void applyMdagM(const LinearOperator<T>& M, T& chi, const T& psi)
+  {
+    const FusedMdagM<T>* f = dynamic_cast<const FusedMdagM<T>*>(&M);
+    if (f)
+    {
+      f->mdagm(chi, psi);
+      return;
+    }
+
+    T  tmp;  QDP::Hints::moveToFastMemoryHint(tmp);
+    M(tmp, psi, PLUS);
+    M(chi, tmp, MINUS);
+  }
+
+
   //! M^dag.M linear operator
   /*!
    * \ingroup linop
@@ -38,10 +75,7 @@ namespace Chroma
     /*! For this operator, the sign is ignored */
     inline void operator() (T& chi, const T& psi, enum PlusMinus isign) const
       {
-	T  tmp;  QDP::Hints::moveToFastMemoryHint(tmp);
-
-	(*A)(tmp, psi, PLUS);
-	(*A)(chi, tmp, MINUS);
+	applyMdagM(*A, chi, psi);
       }
 
     unsigned long nFlops(void) const {
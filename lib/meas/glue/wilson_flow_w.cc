@@ -33,6 +33,7 @@
 #include "util/gauge/stout_utils.h"
 #include "util/gauge/expmat.h"
 #include "util/gauge/taproj.h"
+#include "util/gauge/su3_batch.h"
 
 //using namespace Chroma;
 namespace Chroma
@@ -133,20 +134,15 @@ namespace Chroma
     multi1d<LatticeColorMatrix> Q1(Nd);
 
 
-    multi1d<LatticeComplex> f;   // routine will resize these
-
-
     for (mu = 0; mu <= Nd-1; mu++)
     {
       Stouting::getQsandCs(dest, Q1[mu],QQ,C,mu,smear_in_this_dirP,rho_b1) ;
       Stouting::getQsandCs(u   , Q0[mu],QQ,C,mu,smear_in_this_dirP,rho_b2) ;
 
       Q = Q1[mu] - Q0[mu] ;
-      QQ = Q * Q ;
-      Stouting::getFs(Q,QQ,f);   // This routine computes the f-s
           
-      // Assemble the stout links exp(iQ)U_{mu} 
-      next[mu]=(f[0] + f[1]*Q + f[2]*QQ)*dest[mu];      
+      // Assemble the stout links exp(iQ)U_{mu} in one pass
+      SU3Batch::expiQMult(next[mu], Q, dest[mu]);
 
     }
 
@@ -162,11 +158,9 @@ namespace Chroma
       Stouting::getQsandCs(dest, Q2,QQ,C,mu,smear_in_this_dirP,rho_c) ;
 
       Q = Q2 - Q1[mu] + Q0[mu] ;
-      QQ = Q * Q ;
-      Stouting::getFs(Q,QQ,f);   // This routine computes the f-s
           
-      // Assemble the stout links exp(iQ)U_{mu} 
-      next[mu]=(f[0] + f[1]*Q + f[2]*QQ)*dest[mu];      
+      // Assemble the stout links exp(iQ)U_{mu} in one pass
+      SU3Batch::expiQMult(next[mu], Q, dest[mu]);
 
     }
 
@@ -59,6 +59,181 @@ void CVSBuildingBlocks( TextWriter & Out )
   Out << "CVSBuildingBlocks_cc = " << CVSBuildingBlocks_cc << "\n";
 }
 
+//###################################################################################//
+// fused gamma traces and momentum projection                                        //
+//###################################################################################//
+
+namespace
+{
+#ifndef QDP_IS_QDPJIT
+  //! Arguments for the fused contraction
+  struct BkwdFrwdProjArgs
+  {
+    const LatticePropagator& B;
+    const LatticePropagator& FG;
+    const SftMom&            Phases;
+    const multi1d< int >&    TSlice;
+    int                      NumQ;
+    int                      NT;
+    double*                  Acc;
+  };
+
+  //! Colour traced spin matrix at each site, accumulated onto every momentum
+  /*!
+   * M_{ca}(x) = sum_{b,colours} FG_{cb}(x) conj( B_{ab}(x) ), so that
+   * localInnerProduct( B, Gamma(i) * FG ) = sum_{a,c} Gamma(i)_{ac} M_{ca}.
+   * Each thread accumulates into its own slice of Acc, indexed by
+   * ( ( thread * NumQ + q ) * NT + t ) * Ns * Ns + c * Ns + a.
+   */
+  void bkwdFrwdProjLoop( int lo, int hi, int myId, BkwdFrwdProjArgs* a )
+  {
+    const int NS2 = Ns * Ns;
+    double* acc = a->Acc + 2 * myId * a->NumQ * a->NT * NS2;
+    const int* tab = all.siteTable().slice();
+
+    double mre[ Ns * Ns ];
+    double mim[ Ns * Ns ];
+
+    for( int j = lo; j < hi; j ++ )
+    {
+      int site = tab[ j ];
+
+      for( int c = 0; c < Ns; c ++ )
+      {
+        for( int s = 0; s < Ns; s ++ )
+        {
+          double re = 0.0;
+          double im = 0.0;
+
+          for( int b = 0; b < Ns; b ++ )
+          {
+            for( int k = 0; k < Nc; k ++ )
+            {
+              for( int l = 0; l < Nc; l ++ )
+              {
+                double fr = a->FG.elem( site ).elem( c, b ).elem( k, l ).real();
+                double fi = a->FG.elem( site ).elem( c, b ).elem( k, l ).imag();
+                double br = a->B.elem( site ).elem( s, b ).elem( k, l ).real();
+                double bi = a->B.elem( site ).elem( s, b ).elem( k, l ).imag();
+
+                re += fr * br + fi * bi;
+                im += fi * br - fr * bi;
+              }
+            }
+          }
+
+          mre[ c * Ns + s ] = re;
+          mim[ c * Ns + s ] = im;
+        }
+      }
+
+      int t = a->TSlice[ site ];
+
+      for( int q = 0; q < a->NumQ; q ++ )
+      {
+        double pr = a->Phases[ q ].elem( site ).elem().elem().real();
+        double pi = a->Phases[ q ].elem( site ).elem().elem().imag();
+
+        double* aq = acc + 2 * ( q * a->NT + t ) * NS2;
+
+        for( int n = 0; n < NS2; n ++ )
+        {
+          aq[ 2 * n     ] += pr * mre[ n ] - pi * mim[ n ];
+          aq[ 2 * n + 1 ] += pr * mim[ n ] + pi * mre[ n ];
+        }
+      }
+    }
+  }
+#endif
+
+  //! All 16 gamma traces projected onto all momenta
+  /*!
+   * Proj( i, q, t ) = sum_x exp( i q.x ) localInnerProduct( B, Gamma(i) * F * Gamma(GammaInsertion) )
+   * restricted to time slice t. Outside of QDP-JIT the colour traced spin matrix is
+   * formed once per site and the 16 traces are taken after the projection, all in a
+   * single pass over the lattice.
+   */
+  void BkwdFrwdProject( const LatticePropagator & B,
+                        const LatticePropagator & F,
+                        int                       GammaInsertion,
+                        const SftMom &            Phases,
+                        multi3d< DComplex > &     Proj )
+  {
+    const int NumQ = Phases.numMom();
+    const int NT   = Phases.numSubsets();
+    const int NS2  = Ns * Ns;
+
+    Proj.resize( NS2, NumQ, NT );
+
+    LatticePropagator FG = F * Gamma( GammaInsertion );
+
+#ifndef QDP_IS_QDPJIT
+    const int NThreads = qdpNumThreads();
+    const int Stride   = 2 * NumQ * NT * NS2;
+
+    multi1d< double > Acc( NThreads * Stride );
+    Acc = 0.0;
+
+    BkwdFrwdProjArgs args = { B, FG, Phases, Phases.getSet().latticeColoring(), NumQ, NT, Acc.slice() };
+    dispatch_to_threads( all.siteTable().size(), args, bkwdFrwdProjLoop );
+
+    // Reduce over threads, then nodes
+    for( int n = 1; n < NThreads; n ++ )
+      for( int k = 0; k < Stride; k ++ )
+        Acc[ k ] += Acc[ n * Stride + k ];
+
+    QDPInternal::globalSumArray( Acc.slice(), Stride );
+
+    // Gamma matrices as spin matrices, to apply the traces as a linear map
+    multi1d< SpinMatrix > G( NS2 );
+    for( int i = 0; i < NS2; i ++ )
+      G[ i ] = Gamma( i ) * SpinMatrix( Real( 1 ) );
+
+    for( int i = 0; i < NS2; i ++ )
+    {
+      for( int q = 0; q < NumQ; q ++ )
+      {
+        for( int t = 0; t < NT; t ++ )
+        {
+          const double* m = Acc.slice() + 2 * ( q * NT + t ) * NS2;
+          double re = 0.0;
+          double im = 0.0;
+
+          for( int r = 0; r < Ns; r ++ )
+          {
+            for( int c = 0; c < Ns; c ++ )
+            {
+              // Gamma(i)_{rc} M_{cr}
+              double gr = G[ i ].elem().elem( r, c ).elem().real();
+              double gi = G[ i ].elem().elem( r, c ).elem().imag();
+              if( gr == 0.0 && gi == 0.0 ) continue;
+
+              double mr = m[ 2 * ( c * Ns + r )     ];
+              double mi = m[ 2 * ( c * Ns + r ) + 1 ];
+
+              re += gr * mr - gi * mi;
+              im += gr * mi + gi * mr;
+            }
+          }
+
+          Proj( i, q, t ) = cmplx( Double( re ), Double( im ) );
+        }
+      }
+    }
+#else
+    for( int i = 0; i < NS2; i ++ )
+    {
+      LatticeComplex Trace = localInnerProduct( B, Gamma( i ) * FG );
+      multi2d< DComplex > Projections = Phases.sft( Trace );
+
+      for( int q = 0; q < NumQ; q ++ )
+        for( int t = 0; t < NT; t ++ )
+          Proj( i, q, t ) = Projections[ q ][ t ];
+    }
+#endif
+  }
+}
+
 //###################################################################################//
 // backward forward trace                                                            //
 //###################################################################################//
@@ -86,14 +261,7 @@ void BkwdFrwdTr( const LatticePropagator &             B,
 
   StopWatch Timer;
 
-  int TRCalls = 0;
-  int FTCalls = 0;
-  int GFGCalls = 0;
-  int IPCalls = 0;
-  double TRTime = 0.0;
-  double FTTime = 0.0;
-  double GFGTime = 0.0;
-  double IPTime = 0.0;
+  double ProjTime = 0.0;
   double IOTime = 0.0;
 
   const unsigned short int NLinks = LinkDirs.size();
@@ -149,47 +317,38 @@ void BkwdFrwdTr( const LatticePropagator &             B,
   Timer.stop();
   IOTime += Timer.getTimeInSeconds();
 
-  for( int i = 0; i < Ns * Ns; i ++ )
-  {
-    Timer.reset();
-    Timer.start();
+  //#################################################################################//
+  // all gamma traces and momenta in one pass                                        //
+  //#################################################################################//
 
-    // assumes any Gamma5 matrices have already been absorbed
-    LatticePropagator GFG = Gamma(i) * F * Gamma( GammaInsertion );
+  Timer.reset();
+  Timer.start();
 
+  // assumes any Gamma5 matrices have already been absorbed
+  multi3d< DComplex > AllProjections;
+  BkwdFrwdProject( B, F, GammaInsertion, Phases, AllProjections );
+
+  Timer.stop();
+  ProjTime += Timer.getTimeInSeconds();
+
+  for( int i = 0; i < Ns * Ns; i ++ )
+  {
     // There is an overall minus sign from interchanging the initial and final states for baryons.  This
     // might not be present for mesons, so we should think about this carefully.
     // It seems there should be another sign for conjugating the operator, but it appears to be absent.
     // There is a minus sign for all Dirac structures with a gamma_t.  In the current scheme this is all
     // gamma_i with i = 8, ..., 15.  If the gamma basis changes, then this must change.
-    if( ( TimeReverse == true ) & ( i < 8 ) ) GFG *= -1;
-
-    Timer.stop();
-    GFGCalls += 1;
-    GFGTime += Timer.getTimeInSeconds();
-    Timer.reset();
-    Timer.start();
-
-    LatticeComplex Trace = localInnerProduct( B, GFG );
-
-    Timer.stop();
-    IPCalls += 1;
-    IPTime += Timer.getTimeInSeconds();
-    Timer.reset();
-    Timer.start();
-
-    multi2d< DComplex > Projections = Phases.sft( Trace );
-
-    Timer.stop();
-    FTTime += Timer.getTimeInSeconds();
-    FTCalls += 1;
+    const bool Negate = ( TimeReverse == true ) & ( i < 8 );
 
     Timer.reset();
     Timer.start();
 
     for( int q = 0; q < NumQ; q ++ )
     {
-      multi1d< DComplex > Projection = Projections[ q ];
+      multi1d< DComplex > Projection( NT );
+      for( int t = 0; t < NT; t ++ )
+        Projection[ t ] = Negate ? DComplex( -AllProjections( i, q, t ) ) : AllProjections( i, q, t );
+
       multi1d< int > Q = Phases.numToMom( q );
 
       int o = PhasesCanonical.momToNum( Q );
@@ -273,9 +432,7 @@ void BkwdFrwdTr( const LatticePropagator &             B,
   }
 
   QDPIO::cout << __func__ << ":  io time = " << IOTime << " seconds" << std::endl;
-  QDPIO::cout << __func__ << ": gfg time = " << GFGTime / (double) GFGCalls << " seconds" << std::endl;
-  QDPIO::cout << __func__ << ":  ip time = " << IPTime / (double) IPCalls << " seconds" << std::endl;
-  QDPIO::cout << __func__ << ":  ft time = " << FTTime / (double) FTCalls << " seconds" << std::endl;
+  QDPIO::cout << __func__ << ": contraction and ft time = " << ProjTime << " seconds" << std::endl;
   TotalTime.stop();
   QDPIO::cout << __func__ << ": total time = " << TotalTime.getTimeInSeconds() << " seconds" << std::endl;
 
@@ -5,6 +5,7 @@
 
 #include "meas/hadron/barhqlq_w.h"
 #include "meas/hadron/barspinmat_w.h"
+#include "meas/hadron/baryon_2pt_plan_w.h"
 
 namespace Chroma 
 {
@@ -373,223 +374,171 @@ namespace Chroma
     // C g_5 NR = (1/2)*C gamma_5 * ( 1 + g_4 )
     SpinMatrix Cg5NR = BaryonSpinMats::Cg5NR();
 
-    LatticeComplex b_prop;
+    // Collect all channels, so the diquarks and spin traces they share
+    // are built and projected only once
+    Baryon2PtPlan plan;
+    const int q1 = plan.addQuark(quark_propagator_1);
+    const int q2 = plan.addQuark(quark_propagator_2);
 
-    // Loop over baryons
     for(int baryons = 0; baryons < num_baryons; ++baryons)
-    {
-      LatticePropagator di_quark;
+      plan.addChannel();
 
-      switch (baryons)
-      {
-      case 0:
-	// Sigma^+_1 (or proton); use also for Lambda_1!
-	// |S_1, s_z=1/2> = (s C gamma_5 u) "u_up"
-	// C gamma_5 = Gamma(5)
-	// Polarized:
-	// T_mixed = T = (1 + \Sigma_3)*(1 + gamma_4) / 2 
-	//             = (1 + Gamma(8) - i G(3) - i G(11)) / 2
-	b_prop = Baryon2PtContractions::sigma2pt(quark_propagator_1, quark_propagator_2, 
-						 T_mixed, Cg5);
-	break;
-
-      case 1:
-	// Lambda_1
-	// |L_1, s_z=1/2> = 2*(u C gamma_5 d) "s_up" + (s C gamma_5 d) "u_up"
-	//                  + (u C gamma_5 s) "d_up" , see comments at top   
-	// C gamma_5 = Gamma(5)
-	// Polarized:
-	// T_mixed = T = (1 + \Sigma_3)*(1 + gamma_4) / 2 
-	//             = (1 + Gamma(8) - i G(3) - i G(11)) / 2
-	b_prop = Baryon2PtContractions::lambda2pt(quark_propagator_1, quark_propagator_2, 
-						  T_mixed, Cg5);
-	break;
-
-      case 2:
-	// Sigma^{*+}_1
-	// |S*_1, s_z=3/2> = 2*(s C gamma_- u) "u_up" + (u C gamma_- u) "s_up"
-	// Polarized:
-	// T_mixed = T = (1 + \Sigma_3)*(1 + gamma_4) / 2 
-	//             = (1 + Gamma(8) - i G(3) - i G(11)) / 2
-	b_prop = Baryon2PtContractions::sigmast2pt(quark_propagator_1, quark_propagator_2, 
-						   T_mixed, BaryonSpinMats::Cgm());
-	break;
-
-      case 3:
-	// Sigma^+_2; use also for Lambda_2!
-	// |S_2, s_z=1/2> = (s C gamma_4 gamma_5 u) "u_up"
-	// C gamma_5 gamma_4 = - Gamma(13)
-	// Polarized:
-	// T_mixed = T = (1 + \Sigma_3)*(1 + gamma_4) / 2 
-	//             = (1 + Gamma(8) - i G(3) - i G(11)) / 2
-	b_prop = Baryon2PtContractions::sigma2pt(quark_propagator_1, quark_propagator_2, 
-						 T_mixed, Cg5g4);
-	break;
-
-      case 4:
-	// Lambda_2
-	// |L_2, s_z=1/2> = 2*(u C gamma_4 gamma_5 d) "s_up"
-	//                  + (s C gamma_4 gamma_5 d) "u_up"
-	//                  + (u C gamma_4 gamma_5 s) "d_up"
-	// Polarized:
-	// T_mixed = T = (1 + \Sigma_3)*(1 + gamma_4) / 2 
-	//             = (1 + Gamma(8) - i G(3) - i G(11)) / 2
-	b_prop = Baryon2PtContractions::lambda2pt(quark_propagator_1, quark_propagator_2, 
-						  T_mixed, Cg5g4);
-	break;
-
-      case 5:
-	// Sigma^{*+}_2
-	// |S*_2, s_z=3/2> = 2*(s C gamma_4 gamma_- u) "u_up" + (u C gamma_4 gamma_- u) "s_up"
-	// Polarized:
-	// T_mixed = T = (1 + \Sigma_3)*(1 + gamma_4) / 2 
-	//             = (1 + Gamma(8) - i G(3) - i G(11)) / 2
-	b_prop = Baryon2PtContractions::sigmast2pt(quark_propagator_1, quark_propagator_2, 
-						   T_mixed, BaryonSpinMats::Cg4m());
-	break;
-
-      case 6:
-	// Sigma^+_3; use also for Lambda_3!
-	// |S_3, s_z=1/2> = (s C (1/2)(1 + gamma_4) gamma_5 u) "u_up"
-	// C gamma_5 gamma_4 = - Gamma(13)
-	// Polarized:
-	// T_mixed = T = (1 + \Sigma_3)*(1 + gamma_4) / 2 
-	//             = (1 + Gamma(8) - i G(3) - i G(11)) / 2
-	b_prop = Baryon2PtContractions::sigma2pt(quark_propagator_1, quark_propagator_2, 
-						 T_mixed, Cg5NR);
-	break;
-
-      case 7:
-	// Lambda_3
-	// |L_3, s_z=1/2> = 2*(u C (1/2)(1 + gamma_4) gamma_5 d) "s_up"
-	//                  + (s C (1/2)(1 + gamma_4) gamma_5 d) "u_up"
-	//                  + (u C (1/2)(1 + gamma_4) gamma_5 s) "d_up"
-	// Polarized:
-	// T_mixed = T = (1 + \Sigma_3)*(1 + gamma_4) / 2 
-	//             = (1 + Gamma(8) - i G(3) - i G(11)) / 2
-	b_prop = Baryon2PtContractions::lambda2pt(quark_propagator_1, quark_propagator_2, 
-						  T_mixed, Cg5NR);
-	break;
-
-      case 8:
-	// Sigma^{*+}_3
-	// |S*_3, s_z=3/2> = 2*(s C (1/2)(1+gamma_4) gamma_- u) "u_up" 
-	//                   + (u C (1/2)(1+gamma_4) gamma_- u) "s_up"
-	// Polarized:
-	// T_mixed = T = (1 + \Sigma_3)*(1 + gamma_4) / 2 
-	//             = (1 + Gamma(8) - i G(3) - i G(11)) / 2
-	// Arrgh, goofy CgmNR normalization again from szin code. 
-	b_prop = Baryon2PtContractions::sigmast2pt(quark_propagator_1, quark_propagator_2, 
-						   T_mixed, BaryonSpinMats::CgmNR());
-
-	// Agghh, we have a goofy factor of 4 normalization factor here. The
-	// ancient szin way didn't care about norms, so it happily made it
-	// 4 times too big. There is a missing 0.5 in the NR normalization
-	// in the old szin code.
-	// So, we compensate to keep the same normalization
-	b_prop *= 4.0;
-	break;
-
-
-      case 9:
-	// Sigma^+_4 -- but unpolarised
-	// |S_4, s_z=1/2> = (s C gamma_5 u) "u_up", see comments at top
-	// C gamma_5 = Gamma(5)
-	// Unpolarized:
-	// T_unpol = T = (1/2)(1 + gamma_4)
-	b_prop = Baryon2PtContractions::sigma2pt(quark_propagator_1, quark_propagator_2, 
-						 T_unpol, Cg5);
-	break;
-
-      case 10:
-	// Sigma^+_5
-	// |S_5, s_z=1/2> = (s C gamma_4 gamma_5 u) "u_up", see comments at top
-	// C gamma_5 gamma_4 = - Gamma(13)
-	// Unpolarized:
-	// T_unpol = T = (1/2)(1 + gamma_4)
-	b_prop = Baryon2PtContractions::sigma2pt(quark_propagator_1, quark_propagator_2, 
-						 T_unpol, Cg5g4);
-	break;
-    
-      case 11:
-	// Sigma^+_6
-	// |S_6, s_z=1/2> = (s C (1/2)(1 + gamma_4) gamma_5 u) "u_up", see comments at top
-	// C gamma_5 = Gamma(5)
-	// Unpolarized:
-	// T_unpol = T = (1/2)(1 + gamma_4)
-	b_prop = Baryon2PtContractions::sigma2pt(quark_propagator_1, quark_propagator_2, 
-						 T_unpol, Cg5NR);
-	break;
-
-      case 12:
-	// Lambda_4 : naive Lambda interpolating field
-	// |L_4 > = (d C gamma_5 u) s
-	// C gamma_5 = Gamma(5)
-	// UnPolarized:
-	// T_unpol = T = (1/2)(1 + gamma_4)
-	b_prop = Baryon2PtContractions::lambdaNaive2pt(quark_propagator_1, quark_propagator_2, 
-						       T_unpol, Cg5);
-	break;
-      
-      case 13:
-	// Xi_1
-	// |X_1 > = (s C gamma_5 u) s
-	// C gamma_5 = Gamma(5)
-	// UnPolarized:
-	// T_unpol = T = (1/2)(1 + gamma_4)
-	b_prop = Baryon2PtContractions::xi2pt(quark_propagator_1, quark_propagator_2, 
-					      T_unpol, Cg5);
-	break;
-
-      case 14:
-	// Lambda_5 : naive Lambda interpolating field
-	// |L_5 > = (d C gamma_5 u) "s_up"
-	// C gamma_5 = Gamma(5)
-	// UnPolarized: 
-	// T_mixed = T = (1 + \Sigma_3)*(1 + gamma_4) / 2 
-	//             = (1 + Gamma(8) - i G(3) - i G(11)) / 2
-	b_prop = Baryon2PtContractions::lambdaNaive2pt(quark_propagator_1, quark_propagator_2, 
-						       T_unpol, Cg5);
-	break;
-      
-      case 15:
-	// Xi_2
-	// |X_2 > = (s C gamma_5 u) "s_up"
-	// C gamma_5 = Gamma(5)
-	// UnPolarized:
-	// T_mixed = T = (1 + \Sigma_3)*(1 + gamma_4) / 2 
-	//             = (1 + Gamma(8) - i G(3) - i G(11)) / 2
-	b_prop = Baryon2PtContractions::xi2pt(quark_propagator_1, quark_propagator_2, 
-					      T_mixed, Cg5);
-	break;
-
-      case 16:
-	// Proton_negpar_3; use also for Lambda_negpar_3!
-	// |P_7, s_z=1/2> = (d C gamma_5 (1/2)(1 - g_4) u) "u_up", see comments at top
-	// C g_5 NR negpar = (1/2)*C gamma_5 * ( 1 - g_4 )
-	// T = (1 + \Sigma_3)*(1 - gamma_4) / 2 
-	//   = (1 - Gamma(8) + i G(3) - i G(11)) / 2
-	b_prop = Baryon2PtContractions::sigma2pt(quark_propagator_1, quark_propagator_2, 
-						 BaryonSpinMats::TmixedNegPar(), 
-						 BaryonSpinMats::Cg5NRnegPar());
-	break;
-		  
-      default:
-	QDP_error_exit("Unknown baryon", baryons);
-      }
-                        
-      // Project onto zero and if desired non-zero momentum
-      multi2d<DComplex> hsum;
-      hsum = phases.sft(b_prop);
-
-      for(int sink_mom_num=0; sink_mom_num < num_mom; ++sink_mom_num) 
-	for(int t = 0; t < length; ++t)
-	{
-	  // NOTE: there is NO  1/2  multiplying hsum
-	  barprop[baryons][sink_mom_num][t] = hsum[sink_mom_num][t];
-	}
+    // Sigma^+_1 (or proton); use also for Lambda_1!
+    // |S_1, s_z=1/2> = (s C gamma_5 u) "u_up"
+    // C gamma_5 = Gamma(5)
+    // Polarized:
+    // T_mixed = T = (1 + \Sigma_3)*(1 + gamma_4) / 2
+    //             = (1 + Gamma(8) - i G(3) - i G(11)) / 2
+    Baryon2PtContractions::sigma2pt(plan, 0, 1.0, q1, q2,
+				    T_mixed, Cg5);
+
+    // Lambda_1
+    // |L_1, s_z=1/2> = 2*(u C gamma_5 d) "s_up" + (s C gamma_5 d) "u_up"
+    //                  + (u C gamma_5 s) "d_up" , see comments at top
+    // C gamma_5 = Gamma(5)
+    // Polarized:
+    // T_mixed = T = (1 + \Sigma_3)*(1 + gamma_4) / 2
+    //             = (1 + Gamma(8) - i G(3) - i G(11)) / 2
+    Baryon2PtContractions::lambda2pt(plan, 1, 1.0, q1, q2,
+				     T_mixed, Cg5);
+
+    // Sigma^{*+}_1
+    // |S*_1, s_z=3/2> = 2*(s C gamma_- u) "u_up" + (u C gamma_- u) "s_up"
+    // Polarized:
+    // T_mixed = T = (1 + \Sigma_3)*(1 + gamma_4) / 2
+    //             = (1 + Gamma(8) - i G(3) - i G(11)) / 2
+    Baryon2PtContractions::sigmast2pt(plan, 2, 1.0, q1, q2,
+				      T_mixed, BaryonSpinMats::Cgm(), BaryonSpinMats::Cgm());
+
+    // Sigma^+_2; use also for Lambda_2!
+    // |S_2, s_z=1/2> = (s C gamma_4 gamma_5 u) "u_up"
+    // C gamma_5 gamma_4 = - Gamma(13)
+    // Polarized:
+    // T_mixed = T = (1 + \Sigma_3)*(1 + gamma_4) / 2
+    //             = (1 + Gamma(8) - i G(3) - i G(11)) / 2
+    Baryon2PtContractions::sigma2pt(plan, 3, 1.0, q1, q2,
+				    T_mixed, Cg5g4);
+
+    // Lambda_2
+    // |L_2, s_z=1/2> = 2*(u C gamma_4 gamma_5 d) "s_up"
+    //                  + (s C gamma_4 gamma_5 d) "u_up"
+    //                  + (u C gamma_4 gamma_5 s) "d_up"
+    // Polarized:
+    // T_mixed = T = (1 + \Sigma_3)*(1 + gamma_4) / 2
+    //             = (1 + Gamma(8) - i G(3) - i G(11)) / 2
+    Baryon2PtContractions::lambda2pt(plan, 4, 1.0, q1, q2,
+				     T_mixed, Cg5g4);
+
+    // Sigma^{*+}_2
+    // |S*_2, s_z=3/2> = 2*(s C gamma_4 gamma_- u) "u_up" + (u C gamma_4 gamma_- u) "s_up"
+    // Polarized:
+    // T_mixed = T = (1 + \Sigma_3)*(1 + gamma_4) / 2
+    //             = (1 + Gamma(8) - i G(3) - i G(11)) / 2
+    Baryon2PtContractions::sigmast2pt(plan, 5, 1.0, q1, q2,
+				      T_mixed, BaryonSpinMats::Cg4m(), BaryonSpinMats::Cg4m());
+
+    // Sigma^+_3; use also for Lambda_3!
+    // |S_3, s_z=1/2> = (s C (1/2)(1 + gamma_4) gamma_5 u) "u_up"
+    // C gamma_5 gamma_4 = - Gamma(13)
+    // Polarized:
+    // T_mixed = T = (1 + \Sigma_3)*(1 + gamma_4) / 2
+    //             = (1 + Gamma(8) - i G(3) - i G(11)) / 2
+    Baryon2PtContractions::sigma2pt(plan, 6, 1.0, q1, q2,
+				    T_mixed, Cg5NR);
+
+    // Lambda_3
+    // |L_3, s_z=1/2> = 2*(u C (1/2)(1 + gamma_4) gamma_5 d) "s_up"
+    //                  + (s C (1/2)(1 + gamma_4) gamma_5 d) "u_up"
+    //                  + (u C (1/2)(1 + gamma_4) gamma_5 s) "d_up"
+    // Polarized:
+    // T_mixed = T = (1 + \Sigma_3)*(1 + gamma_4) / 2
+    //             = (1 + Gamma(8) - i G(3) - i G(11)) / 2
+    Baryon2PtContractions::lambda2pt(plan, 7, 1.0, q1, q2,
+				     T_mixed, Cg5NR);
+
+    // Sigma^{*+}_3
+    // |S*_3, s_z=3/2> = 2*(s C (1/2)(1+gamma_4) gamma_- u) "u_up"
+    //                   + (u C (1/2)(1+gamma_4) gamma_- u) "s_up"
+    // Polarized:
+    // T_mixed = T = (1 + \Sigma_3)*(1 + gamma_4) / 2
+    //             = (1 + Gamma(8) - i G(3) - i G(11)) / 2
+    // Arrgh, goofy CgmNR normalization again from szin code.
+    // Agghh, we have a goofy factor of 4 normalization factor here. The
+    // ancient szin way didn't care about norms, so it happily made it
+    // 4 times too big. There is a missing 0.5 in the NR normalization
+    // in the old szin code.
+    // So, we compensate to keep the same normalization
+    Baryon2PtContractions::sigmast2pt(plan, 8, 4.0, q1, q2,
+				      T_mixed, BaryonSpinMats::CgmNR(), BaryonSpinMats::CgmNR());
+
+    // Sigma^+_4 -- but unpolarised
+    // |S_4, s_z=1/2> = (s C gamma_5 u) "u_up", see comments at top
+    // C gamma_5 = Gamma(5)
+    // Unpolarized:
+    // T_unpol = T = (1/2)(1 + gamma_4)
+    Baryon2PtContractions::sigma2pt(plan, 9, 1.0, q1, q2,
+				    T_unpol, Cg5);
+
+    // Sigma^+_5
+    // |S_5, s_z=1/2> = (s C gamma_4 gamma_5 u) "u_up", see comments at top
+    // C gamma_5 gamma_4 = - Gamma(13)
+    // Unpolarized:
+    // T_unpol = T = (1/2)(1 + gamma_4)
+    Baryon2PtContractions::sigma2pt(plan, 10, 1.0, q1, q2,
+				    T_unpol, Cg5g4);
 
-    } // end loop over baryons
+    // Sigma^+_6
+    // |S_6, s_z=1/2> = (s C (1/2)(1 + gamma_4) gamma_5 u) "u_up", see comments at top
+    // C gamma_5 = Gamma(5)
+    // Unpolarized:
+    // T_unpol = T = (1/2)(1 + gamma_4)
+    Baryon2PtContractions::sigma2pt(plan, 11, 1.0, q1, q2,
+				    T_unpol, Cg5NR);
+
+    // Lambda_4 : naive Lambda interpolating field
+    // |L_4 > = (d C gamma_5 u) s
+    // C gamma_5 = Gamma(5)
+    // UnPolarized:
+    // T_unpol = T = (1/2)(1 + gamma_4)
+    Baryon2PtContractions::lambdaNaive2pt(plan, 12, 1.0, q1, q2,
+					  T_unpol, Cg5);
+
+    // Xi_1
+    // |X_1 > = (s C gamma_5 u) s
+    // C gamma_5 = Gamma(5)
+    // UnPolarized:
+    // T_unpol = T = (1/2)(1 + gamma_4)
+    Baryon2PtContractions::xi2pt(plan, 13, 1.0, q1, q2,
+				 T_unpol, Cg5);
+
+    // Lambda_5 : naive Lambda interpolating field
+    // |L_5 > = (d C gamma_5 u) "s_up"
+    // C gamma_5 = Gamma(5)
+    // UnPolarized:
+    // T_mixed = T = (1 + \Sigma_3)*(1 + gamma_4) / 2
+    //             = (1 + Gamma(8) - i G(3) - i G(11)) / 2
+    Baryon2PtContractions::lambdaNaive2pt(plan, 14, 1.0, q1, q2,
+					  T_unpol, Cg5);
+
+    // Xi_2
+    // |X_2 > = (s C gamma_5 u) "s_up"
+    // C gamma_5 = Gamma(5)
+    // UnPolarized:
+    // T_mixed = T = (1 + \Sigma_3)*(1 + gamma_4) / 2
+    //             = (1 + Gamma(8) - i G(3) - i G(11)) / 2
+    Baryon2PtContractions::xi2pt(plan, 15, 1.0, q1, q2,
+				 T_mixed, Cg5);
+
+    // Proton_negpar_3; use also for Lambda_negpar_3!
+    // |P_7, s_z=1/2> = (d C gamma_5 (1/2)(1 - g_4) u) "u_up", see comments at top
+    // C g_5 NR negpar = (1/2)*C gamma_5 * ( 1 - g_4 )
+    // T = (1 + \Sigma_3)*(1 - gamma_4) / 2
+    //   = (1 - Gamma(8) + i G(3) - i G(11)) / 2
+    Baryon2PtContractions::sigma2pt(plan, 16, 1.0, q1, q2,
+				    BaryonSpinMats::TmixedNegPar(), BaryonSpinMats::Cg5NRnegPar());
+
+    // Evaluate; NOTE: there is NO  1/2  multiplying the projections
+    plan.evaluate(phases, barprop);
 
     END_CODE();
   }
@@ -0,0 +1,348 @@
+/*! \file
+ *  \brief Contraction planner for baryon 2-pt functions sharing diquarks
+ */
+
+#include "meas/hadron/baryon_2pt_plan_w.h"
+
+namespace Chroma
+{
+
+  namespace
+  {
+    //! Are two spin matrices the same?
+    bool sameSpinMatrix(const SpinMatrix& a, const SpinMatrix& b)
+    {
+      return toDouble(norm2(a - b)) <= 1.0e-20 * (1.0 + toDouble(norm2(a)));
+    }
+
+#ifndef QDP_IS_QDPJIT
+    //! Arguments of the fused momentum projection
+    struct ProjArgs
+    {
+      const LatticeSpinMatrix& S;
+      const SftMom&            phases;
+      const multi1d<int>&      tslice;
+      int                      num_mom;
+      int                      length;
+      double*                  partial;   /*!< 2*Ns*Ns*num_mom*length per thread */
+    };
+
+    //! Spin matrix at each site, accumulated onto every momentum and time slice
+    /*!
+     * Each thread accumulates into its own slice of partial, indexed by
+     * ( ( thread * num_mom + mom ) * length + t ) * Ns * Ns + s1 * Ns + s2.
+     */
+    void projSiteLoop(int lo, int hi, int myId, ProjArgs* a)
+    {
+      const int NS2 = Ns*Ns;
+      double* acc = a->partial + 2*NS2*a->num_mom*a->length*myId;
+      const int* tab = all.siteTable().slice();
+
+      for(int j=lo; j < hi; ++j)
+      {
+	const int site = tab[j];
+	const int t    = a->tslice[site];
+
+	for(int mom=0; mom < a->num_mom; ++mom)
+	{
+	  const double pr = a->phases[mom].elem(site).elem().elem().real();
+	  const double pi = a->phases[mom].elem(site).elem().elem().imag();
+
+	  double* am = acc + 2*NS2*(mom*a->length + t);
+
+	  for(int s1=0; s1 < Ns; ++s1)
+	  {
+	    for(int s2=0; s2 < Ns; ++s2)
+	    {
+	      const double sr = a->S.elem(site).elem(s1,s2).elem().real();
+	      const double si = a->S.elem(site).elem(s1,s2).elem().imag();
+
+	      am[2*(s1*Ns + s2)]     += pr*sr - pi*si;
+	      am[2*(s1*Ns + s2) + 1] += pr*si + pi*sr;
+	    }
+	  }
+	}
+      }
+    }
+#endif
+  }
+
+
+  //! Register a quark propagator
+  int Baryon2PtPlan::addQuark(const LatticePropagator& q)
+  {
+    quarks.push_back(&q);
+    return quarks.size() - 1;
+  }
+
+
+  //! Start a new channel
+  int Baryon2PtPlan::addChannel()
+  {
+    return num_channels++;
+  }
+
+
+  //! Find or insert a diquark
+  int Baryon2PtPlan::findDiquark(int qa, int qb, const SpinMatrix& sp_src, const SpinMatrix& sp_snk)
+  {
+    for(int d=0; d < diquarks.size(); ++d)
+    {
+      const Diquark_t& dq = diquarks[d];
+      if (dq.qa == qa && dq.qb == qb &&
+	  sameSpinMatrix(dq.sp_src, sp_src) && sameSpinMatrix(dq.sp_snk, sp_snk))
+	return d;
+    }
+
+    Diquark_t dq;
+    dq.qa = qa;
+    dq.qb = qb;
+    dq.sp_src = sp_src;
+    dq.sp_snk = sp_snk;
+    diquarks.push_back(dq);
+
+    return diquarks.size() - 1;
+  }
+
+
+  //! Find or insert a colour-traced spin matrix
+  int Baryon2PtPlan::findSpinTrace(int diquark, int qc, DiquarkPart_t part)
+  {
+    for(int n=0; n < traces.size(); ++n)
+    {
+      const SpinTrace_t& tr = traces[n];
+      if (tr.diquark == diquark && tr.qc == qc && tr.part == part)
+	return n;
+    }
+
+    SpinTrace_t tr;
+    tr.diquark = diquark;
+    tr.qc = qc;
+    tr.part = part;
+    traces.push_back(tr);
+
+    return traces.size() - 1;
+  }
+
+
+  //! Add a term to a channel
+  void Baryon2PtPlan::addTerm(int channel, double coeff, const SpinMatrix& T, int qc,
+			      int qa, int qb, const SpinMatrix& sp_src, const SpinMatrix& sp_snk,
+			      DiquarkPart_t part)
+  {
+    if (channel < 0 || channel >= num_channels)
+    {
+      QDPIO::cerr << __func__ << ": invalid channel = " << channel << std::endl;
+      QDP_abort(1);
+    }
+
+    if (qa < 0 || qa >= quarks.size() || qb < 0 || qb >= quarks.size() || qc < 0 || qc >= quarks.size())
+    {
+      QDPIO::cerr << __func__ << ": invalid quark index" << std::endl;
+      QDP_abort(1);
+    }
+
+    Term_t term;
+    term.channel = channel;
+    term.trace   = findSpinTrace(findDiquark(qa, qb, sp_src, sp_snk), qc, part);
+    term.coeff   = coeff;
+    term.T       = T;
+    terms.push_back(term);
+  }
+
+
+  //! Evaluate all channels
+  void Baryon2PtPlan::evaluate(const SftMom& phases, multi3d<DComplex>& barprop) const
+  {
+    START_CODE();
+
+    StopWatch swatch;
+    swatch.reset();
+    swatch.start();
+
+    const int num_mom = phases.numMom();
+    const int length  = phases.numSubsets();
+
+    barprop.resize(num_channels, num_mom, length);
+    for(int c=0; c < num_channels; ++c)
+      for(int mom=0; mom < num_mom; ++mom)
+	for(int t=0; t < length; ++t)
+	  barprop(c,mom,t) = zero;
+
+#if QDP_NC == 3
+    // Projections of the colour-traced spin matrices, one block of
+    // 2 * Ns*Ns reals per [trace][mom][t]
+    const int NS2    = Ns*Ns;
+    const int stride = 2*NS2*num_mom*length;
+
+    multi1d<double> acc(traces.size() * stride);
+    acc = 0.0;
+
+#ifndef QDP_IS_QDPJIT
+    const int nthreads = qdpNumThreads();
+    multi1d<double> partial(nthreads * stride);
+#endif
+
+    // Build each diquark once, then every spin trace that uses it
+    for(int d=0; d < diquarks.size(); ++d)
+    {
+      const Diquark_t& dq = diquarks[d];
+
+      LatticePropagator di_quark = quarkContract13(*(quarks[dq.qa]) * dq.sp_src,
+						   dq.sp_snk * *(quarks[dq.qb]));
+
+      LatticeColorMatrix di_quark_spin;
+      bool have_spin_trace = false;
+
+      for(int n=0; n < traces.size(); ++n)
+      {
+	const SpinTrace_t& tr = traces[n];
+	if (tr.diquark != d)
+	  continue;
+
+	LatticeSpinMatrix S;
+	if (tr.part == DIQUARK_TRACE_SPIN)
+	{
+	  if (! have_spin_trace)
+	  {
+	    di_quark_spin = traceSpin(di_quark);
+	    have_spin_trace = true;
+	  }
+	  S = traceColor(*(quarks[tr.qc]) * di_quark_spin);
+	}
+	else
+	{
+	  S = traceColor(*(quarks[tr.qc]) * di_quark);
+	}
+
+	// Project onto all momenta in one pass over the sites
+	double* acc_n = acc.slice() + n*stride;
+
+#ifndef QDP_IS_QDPJIT
+	partial = 0.0;
+
+	ProjArgs args = {S, phases, phases.getSet().latticeColoring(), num_mom, length, partial.slice()};
+	dispatch_to_threads(all.siteTable().size(), args, projSiteLoop);
+
+	for(int th=0; th < nthreads; ++th)
+	  for(int k=0; k < stride; ++k)
+	    acc_n[k] += partial[th*stride + k];
+#else
+	for(int mom=0; mom < num_mom; ++mom)
+	{
+	  multi1d<SpinMatrixD> hsum = sumMulti(phases[mom] * S, phases.getSet());
+	  for(int t=0; t < length; ++t)
+	    for(int s1=0; s1 < Ns; ++s1)
+	      for(int s2=0; s2 < Ns; ++s2)
+	      {
+		double* m = acc_n + 2*(NS2*(mom*length + t) + s1*Ns + s2);
+		m[0] = toDouble(real(peekSpin(hsum[t], s1, s2)));
+		m[1] = toDouble(imag(peekSpin(hsum[t], s1, s2)));
+	      }
+	}
+#endif
+      }
+    }
+
+#ifndef QDP_IS_QDPJIT
+    // A single global sum for every projection of every trace
+    QDPInternal::globalSumArray(acc.slice(), acc.size());
+#endif
+
+    // Apply the projectors per time slice:  tr[ T M ] = sum_{r,c} T_{rc} M_{cr}
+    for(int k=0; k < terms.size(); ++k)
+    {
+      const Term_t& term = terms[k];
+      const double* acc_n = acc.slice() + term.trace*stride;
+
+      for(int mom=0; mom < num_mom; ++mom)
+      {
+	for(int t=0; t < length; ++t)
+	{
+	  const double* m = acc_n + 2*NS2*(mom*length + t);
+	  double re = 0.0;
+	  double im = 0.0;
+
+	  for(int r=0; r < Ns; ++r)
+	  {
+	    for(int c=0; c < Ns; ++c)
+	    {
+	      double tr = term.T.elem().elem(r,c).elem().real();
+	      double ti = term.T.elem().elem(r,c).elem().imag();
+	      if (tr == 0.0 && ti == 0.0)
+		continue;
+
+	      double mr = m[2*(c*Ns + r)];
+	      double mi = m[2*(c*Ns + r) + 1];
+
+	      re += tr*mr - ti*mi;
+	      im += tr*mi + ti*mr;
+	    }
+	  }
+
+	  barprop(term.channel, mom, t) += cmplx(Double(term.coeff*re), Double(term.coeff*im));
+	}
+      }
+    }
+#endif
+
+    swatch.stop();
+    QDPIO::cout << "Baryon2PtPlan: channels= " << num_channels
+		<< "  terms= " << terms.size()
+		<< "  diquarks= " << diquarks.size()
+		<< "  spin traces= " << traces.size()
+		<< "  time= " << swatch.getTimeInSeconds() << " secs" << std::endl;
+
+    END_CODE();
+  }
+
+
+  //! Baryon 2pt contractions
+  namespace Baryon2PtContractions
+  {
+    //! Sigma 2-pt added to a plan
+    void sigma2pt(Baryon2PtPlan& plan, int channel, double scale, int q1, int q2,
+		  const SpinMatrix& T, const SpinMatrix& sp)
+    {
+      plan.addTerm(channel, scale, T, q2, q1, q2, sp, sp, Baryon2PtPlan::DIQUARK_TRACE_SPIN);
+      plan.addTerm(channel, scale, T, q2, q1, q2, sp, sp, Baryon2PtPlan::DIQUARK_FULL);
+    }
+
+    //! Cascade 2-pt added to a plan
+    void xi2pt(Baryon2PtPlan& plan, int channel, double scale, int q1, int q2,
+	       const SpinMatrix& T, const SpinMatrix& sp)
+    {
+      plan.addTerm(channel, scale, T, q1, q1, q2, sp, sp, Baryon2PtPlan::DIQUARK_TRACE_SPIN);
+      plan.addTerm(channel, scale, T, q1, q1, q2, sp, sp, Baryon2PtPlan::DIQUARK_FULL);
+    }
+
+    //! Lambda 2-pt added to a plan
+    void lambda2pt(Baryon2PtPlan& plan, int channel, double scale, int q1, int q2,
+		   const SpinMatrix& T, const SpinMatrix& sp)
+    {
+      plan.addTerm(channel, scale, T, q1, q2, q2, sp, sp, Baryon2PtPlan::DIQUARK_TRACE_SPIN);
+      plan.addTerm(channel, scale, T, q1, q2, q2, sp, sp, Baryon2PtPlan::DIQUARK_FULL);
+      plan.addTerm(channel, scale, T, q2, q2, q1, sp, sp, Baryon2PtPlan::DIQUARK_FULL);
+    }
+
+    //! Naive Lambda 2-pt added to a plan
+    void lambdaNaive2pt(Baryon2PtPlan& plan, int channel, double scale, int q1, int q2,
+			const SpinMatrix& T, const SpinMatrix& sp)
+    {
+      plan.addTerm(channel, scale, T, q1, q2, q2, sp, sp, Baryon2PtPlan::DIQUARK_TRACE_SPIN);
+    }
+
+    //! Delta 2-pt added to a plan
+    void sigmast2pt(Baryon2PtPlan& plan, int channel, double scale, int q1, int q2,
+		    const SpinMatrix& T, const SpinMatrix& spSRC, const SpinMatrix& spSNK)
+    {
+      plan.addTerm(channel, 2*scale, T, q2, q1, q2, spSRC, spSNK, Baryon2PtPlan::DIQUARK_TRACE_SPIN);
+      plan.addTerm(channel, 2*scale, T, q2, q1, q2, spSRC, spSNK, Baryon2PtPlan::DIQUARK_FULL);
+      plan.addTerm(channel, 2*scale, T, q2, q2, q1, spSRC, spSNK, Baryon2PtPlan::DIQUARK_FULL);
+      plan.addTerm(channel, 2*scale, T, q1, q2, q2, spSRC, spSNK, Baryon2PtPlan::DIQUARK_FULL);
+      plan.addTerm(channel,   scale, T, q1, q2, q2, spSRC, spSNK, Baryon2PtPlan::DIQUARK_TRACE_SPIN);
+    }
+
+  }  // namespace  Baryon2PtContractions
+
+}  // end namespace Chroma
@@ -0,0 +1,135 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Contraction planner for baryon 2-pt functions sharing diquarks
+ */
+
+#ifndef __baryon_2pt_plan_w_h__
+#define __baryon_2pt_plan_w_h__
+
+#include "chromabase.h"
+#include "util/ft/sftmom.h"
+#include <vector>
+
+namespace Chroma
+{
+
+  //! Contraction planner for baryon 2-pt functions
+  /*!
+   * \ingroup hadron
+   *
+   * Every channel is a sum of terms
+   *
+   *   coeff * tr[ T tr_c( q_c X ) ]
+   *
+   * where X is the diquark  quarkContract13(q_a * sp_src, sp_snk * q_b)  or its
+   * spin trace. The whole set of channels is collected first. Each distinct
+   * diquark is then built once, each distinct colour-traced spin matrix
+   * tr_c( q_c X ) is built and projected onto all momenta once, and the
+   * projectors T and coefficients are applied per time slice.
+   *
+   * Outside of QDP-JIT the projection of a spin matrix onto every momentum
+   * and time slice is a single pass over the sites, and the projections
+   * of all the spin matrices go through one global sum.
+   */
+  class Baryon2PtPlan
+  {
+  public:
+    //! Which part of the diquark enters the trace
+    enum DiquarkPart_t
+    {
+      DIQUARK_FULL,          /*!< tr[ T tr_c( q_c X ) ] */
+      DIQUARK_TRACE_SPIN     /*!< tr[ T tr_c( q_c tr_s X ) ] */
+    };
+
+    //! Register a quark propagator, the reference must outlive the plan
+    /*! \return the quark index */
+    int addQuark(const LatticePropagator& q);
+
+    //! Start a new channel
+    /*! \return the channel index */
+    int addChannel();
+
+    //! Number of channels
+    int numChannels() const {return num_channels;}
+
+    //! Add a term to a channel
+    void addTerm(int channel, double coeff, const SpinMatrix& T, int qc,
+		 int qa, int qb, const SpinMatrix& sp_src, const SpinMatrix& sp_snk,
+		 DiquarkPart_t part);
+
+    //! Evaluate all channels
+    /*! \return barprop[channel][mom][t] */
+    void evaluate(const SftMom& phases, multi3d<DComplex>& barprop) const;
+
+  private:
+    //! A diquark  quarkContract13(q_a * sp_src, sp_snk * q_b)
+    struct Diquark_t
+    {
+      int qa;
+      int qb;
+      SpinMatrix sp_src;
+      SpinMatrix sp_snk;
+    };
+
+    //! A colour-traced spin matrix  tr_c( q_c X )
+    struct SpinTrace_t
+    {
+      int diquark;
+      int qc;
+      DiquarkPart_t part;
+    };
+
+    //! One term of a channel
+    struct Term_t
+    {
+      int channel;
+      int trace;
+      double coeff;
+      SpinMatrix T;
+    };
+
+    int findDiquark(int qa, int qb, const SpinMatrix& sp_src, const SpinMatrix& sp_snk);
+    int findSpinTrace(int diquark, int qc, DiquarkPart_t part);
+
+    std::vector<const LatticePropagator*> quarks;
+    std::vector<Diquark_t>   diquarks;
+    std::vector<SpinTrace_t> traces;
+    std::vector<Term_t>      terms;
+    int num_channels = 0;
+  };
+
+
+  //! Baryon 2pt contractions
+  /*! \ingroup hadron */
+  namespace Baryon2PtContractions
+  {
+    //! Sigma 2-pt added to a plan
+    /*! \ingroup hadron */
+    void sigma2pt(Baryon2PtPlan& plan, int channel, double scale, int q1, int q2,
+		  const SpinMatrix& T, const SpinMatrix& sp);
+
+    //! Cascade 2-pt added to a plan
+    /*! \ingroup hadron */
+    void xi2pt(Baryon2PtPlan& plan, int channel, double scale, int q1, int q2,
+	       const SpinMatrix& T, const SpinMatrix& sp);
+
+    //! Lambda 2-pt added to a plan
+    /*! \ingroup hadron */
+    void lambda2pt(Baryon2PtPlan& plan, int channel, double scale, int q1, int q2,
+		   const SpinMatrix& T, const SpinMatrix& sp);
+
+    //! Naive Lambda 2-pt added to a plan
+    /*! \ingroup hadron */
+    void lambdaNaive2pt(Baryon2PtPlan& plan, int channel, double scale, int q1, int q2,
+			const SpinMatrix& T, const SpinMatrix& sp);
+
+    //! Delta 2-pt added to a plan
+    /*! \ingroup hadron */
+    void sigmast2pt(Baryon2PtPlan& plan, int channel, double scale, int q1, int q2,
+		    const SpinMatrix& T, const SpinMatrix& spSRC, const SpinMatrix& spSNK);
+
+  }  // namespace  Baryon2PtContractions
+
+}  // end namespace Chroma
+
+#endif
@@ -0,0 +1,363 @@
+/*! \file
+ * \brief Dilution scheme that solves for each diluted source on demand
+ *
+ */
+
+#include "fermact.h"
+#include "meas/hadron/dilution_quark_source_solve_w.h"
+#include "meas/hadron/dilution_scheme_factory.h"
+#include "meas/inline/io/named_objmap.h"
+#include "meas/sources/dilutezN_source_const.h"
+#include "actions/ferm/fermacts/fermact_factory_w.h"
+#include "actions/ferm/fermacts/fermacts_aggregate_w.h"
+
+
+namespace Chroma
+{
+
+  // Read parameters
+  void read(XMLReader& xml, const std::string& path, DilutionQuarkSourceSolveEnv::Params& param)
+  {
+    DilutionQuarkSourceSolveEnv::Params tmp(xml, path);
+    param = tmp;
+  }
+
+
+  // Writer
+  void write(XMLWriter& xml, const std::string& path, const DilutionQuarkSourceSolveEnv::Params& param)
+  {
+    param.writeXML(xml, path);
+  }
+
+
+  /*!
+   * \ingroup hadron
+   *
+   *
+   */
+  namespace DilutionQuarkSourceSolveEnv
+  {
+    //Read the diluted sources of a timeslice
+    void read(XMLReader& xml, const std::string& path, Params::QuarkSources_t::TimeSliceSources_t& input)
+    {
+      XMLReader inputtop(xml, path);
+
+      read(inputtop, "DilutionSources", input.dilution_sources);
+    }
+
+    //Read the timeslices of a quark
+    void read(XMLReader& xml, const std::string& path, Params::QuarkSources_t& input)
+    {
+      XMLReader inputtop(xml, path);
+
+      read(inputtop, "TimeSliceSources", input.timeslice_sources);
+    }
+
+
+    //Write the diluted sources of a timeslice
+    void write(XMLWriter& xml, const std::string& path, const Params::QuarkSources_t::TimeSliceSources_t& input)
+    {
+      push(xml, path);
+      write(xml, "DilutionSources", input.dilution_sources);
+      pop(xml);
+    }
+
+    //Write the timeslices of a quark
+    void write(XMLWriter& xml, const std::string& path, const Params::QuarkSources_t& input)
+    {
+      push(xml, path);
+      write(xml, "TimeSliceSources", input.timeslice_sources);
+      pop(xml);
+    }
+
+
+    //! Initialize
+    Params::Params()
+    {
+    }
+
+
+    //! Read parameters
+    Params::Params(XMLReader& xml, const std::string& path)
+    {
+      XMLReader paramtop(xml, path);
+
+      int version;
+      read(paramtop, "version", version);
+
+      switch (version)
+      {
+      case 1:
+	/**************************************************************************/
+	break;
+
+      default :
+	/**************************************************************************/
+
+	QDPIO::cerr << "Input parameter version " << version << " unsupported." << std::endl;
+	QDP_abort(1);
+      }
+
+      read(paramtop, "gauge_id", gauge_id);
+      read(paramtop, "Propagator", prop);
+      read(paramtop, "QuarkSources", quark_sources);
+    }
+
+
+    // Writer
+    void Params::writeXML(XMLWriter& xml, const std::string& path) const
+    {
+      push(xml, path);
+
+      int version = 1;
+      write(xml, "version", version);
+      write(xml, "gauge_id", gauge_id);
+      write(xml, "Propagator", prop);
+      write(xml, "QuarkSources", quark_sources);
+
+      pop(xml);
+    }
+
+    // Anonymous namespace for registration
+    namespace
+    {
+      DilutionScheme<LatticeFermion>* createScheme(XMLReader& xml_in,
+						   const std::string& path)
+      {
+	return new SolveDilutionScheme(Params(xml_in, path));
+      }
+
+      //! Local registration flag
+      bool registered = false;
+    }
+
+    const std::string name = "DILUTION_QUARK_SOURCE_SOLVE_FERM";
+
+    //! Register all the factories
+    bool registerAll()
+    {
+      bool success = true;
+
+      if (! registered)
+      {
+	success &= WilsonTypeFermActsEnv::registerAll();
+	success &= TheFermDilutionSchemeFactory::Instance().registerObject(name, createScheme);
+	registered = true;
+      }
+      return success;
+    }
+
+
+    //-------------------------------------------------------------------------------
+    // Check the sources and build the solver
+    void SolveDilutionScheme::init()
+    {
+      START_CODE();
+
+      const Params::QuarkSources_t& quark = params.quark_sources;
+
+      if (quark.timeslice_sources.size() == 0)
+      {
+	QDPIO::cerr << name << ": no time slices given" << std::endl;
+	QDP_abort(1);
+      }
+
+      int N;
+
+      try
+      {
+	for(int t0 = 0; t0 < quark.timeslice_sources.size(); ++t0)
+	{
+	  const multi1d<PropSourceConst_t>& sources = quark.timeslice_sources[t0].dilution_sources;
+
+	  if (sources.size() == 0)
+	  {
+	    QDPIO::cerr << name << ": no dilutions on time slice " << t0 << std::endl;
+	    QDP_abort(1);
+	  }
+
+	  for(int dil = 0; dil < sources.size(); ++dil)
+	  {
+	    if (sources[dil].source.id != DiluteZNQuarkSourceConstEnv::getName())
+	    {
+	      QDPIO::cerr << "Expected source_type = " << DiluteZNQuarkSourceConstEnv::getName() << std::endl;
+	      QDP_abort(1);
+	    }
+
+	    std::istringstream  xml_s(sources[dil].source.xml);
+	    XMLReader  sourcetop(xml_s);
+
+	    DiluteZNQuarkSourceConstEnv::Params  srcParams(sourcetop,
+							   sources[dil].source.path);
+
+	    if (t0 == 0 && dil == 0)
+	    {
+	      seed      = srcParams.ran_seed;
+	      N         = srcParams.N;
+	      decay_dir = sources[dil].j_decay;
+	    }
+
+	    // The seed is the unique id of the quark
+	    if ( toBool(srcParams.ran_seed != seed) )
+	    {
+	      QDPIO::cerr << name << ": seeds do not match: t0= " << t0 << " dil= " << dil << std::endl;
+	      QDP_abort(1);
+	    }
+
+	    if (srcParams.N != N)
+	    {
+	      QDPIO::cerr << name << ": N does not match: t0= " << t0 << " dil= " << dil << std::endl;
+	      QDP_abort(1);
+	    }
+
+	    if (sources[dil].t_source != sources[0].t_source)
+	    {
+	      QDPIO::cerr << name << ": t0's DO NOT MATCH FOR ALL DILUTIONS ON TIME SLICE "
+			  << t0 << std::endl;
+	      QDP_abort(1);
+	    }
+	  } // dil
+	} // t0
+      }
+      catch (const std::string& e)
+      {
+	QDPIO::cerr << name << ": Error reading source headers: " << e << std::endl;
+	QDP_abort(1);
+      }
+
+      // The gauge field and its record, which stands in for the Config_info
+      // of the propagator files
+      XMLBufferWriter gauge_xml;
+      try
+      {
+	TheNamedObjMap::Instance().getData< multi1d<LatticeColorMatrix> >(params.gauge_id);
+	TheNamedObjMap::Instance().get(params.gauge_id).getRecordXML(gauge_xml);
+      }
+      catch( std::bad_cast )
+      {
+	QDPIO::cerr << name << ": caught dynamic cast error" << std::endl;
+	QDP_abort(1);
+      }
+      catch (const std::string& e)
+      {
+	QDPIO::cerr << name << ": std::map call failed: " << e << std::endl;
+	QDP_abort(1);
+      }
+      const multi1d<LatticeColorMatrix>& u =
+	TheNamedObjMap::Instance().getData< multi1d<LatticeColorMatrix> >(params.gauge_id);
+
+      {
+	XMLBufferWriter config_xml;
+	write(config_xml, "Config_info", gauge_xml);
+
+	std::istringstream config_is(config_xml.str());
+	XMLReader config_top(config_is);
+	XMLReader xml_tmp(config_top, "/Config_info");
+	std::ostringstream os;
+	xml_tmp.print(os);
+
+	cfgInfo = os.str();
+      }
+
+      // The solver is built once and used for every dilution
+      try
+      {
+	typedef LatticeFermion               T;
+	typedef multi1d<LatticeColorMatrix>  P;
+	typedef multi1d<LatticeColorMatrix>  Q;
+
+	std::istringstream  xml_f(params.prop.fermact.xml);
+	XMLReader  fermacttop(xml_f);
+	QDPIO::cout << name << ": FermAct = " << params.prop.fermact.id << std::endl;
+
+	S_f = TheFermionActionFactory::Instance().createObject(params.prop.fermact.id,
+							       fermacttop,
+							       params.prop.fermact.path);
+
+	Handle< FermState<T,P,Q> > state(S_f->createState(u));
+
+	PP = S_f->qprop(state, params.prop.invParam);
+      }
+      catch (const std::string& e)
+      {
+	QDPIO::cerr << name << ": Caught Exception creating the solver: " << e << std::endl;
+	QDP_abort(1);
+      }
+
+      END_CODE();
+    } // init
+
+
+    // The kappa parameter in the wilson action
+    Real SolveDilutionScheme::getKappa() const
+    {
+      Real kappa;
+      std::istringstream  xml_k(params.prop.fermact.xml);
+
+      XMLReader  proptop(xml_k);
+      if ( toBool(proptop.count("/FermionAction/Kappa") != 0) )
+      {
+	read(proptop, "/FermionAction/Kappa", kappa);
+      }
+      else
+      {
+	Real mass;
+	read(proptop, "/FermionAction/Mass", mass);
+	kappa = massToKappa(mass);
+      }
+
+      return kappa;
+    }
+
+
+    //Create and return the diluted source, without the smearing of its header
+    //as for the files of DILUTION_QUARK_SOURCE_CONST_FERM
+    LatticeFermion SolveDilutionScheme::dilutedSource(int t0, int dil) const
+    {
+      const PropSourceConst_t& source_header =
+	params.quark_sources.timeslice_sources[t0].dilution_sources[dil];
+
+      std::istringstream  xml_s(source_header.source.xml);
+      XMLReader  sourcetop(xml_s);
+
+      DiluteZNQuarkSourceConstEnv::Params  srcParams(sourcetop,
+						     source_header.source.path);
+      srcParams.smear = false;
+
+      DiluteZNQuarkSourceConstEnv::SourceConst<LatticeFermion>  srcConst(srcParams);
+
+      //Dummy gauge field to send to the source construction routine;
+      multi1d<LatticeColorMatrix> dummy;
+
+      return srcConst(dummy);
+    }
+
+
+    //Solve for the diluted source as MAKE_SOURCE would have built it
+    LatticeFermion SolveDilutionScheme::dilutedSolution(int t0, int dil) const
+    {
+      const PropSourceConst_t& source_header =
+	params.quark_sources.timeslice_sources[t0].dilution_sources[dil];
+
+      const multi1d<LatticeColorMatrix>& u =
+	TheNamedObjMap::Instance().getData< multi1d<LatticeColorMatrix> >(params.gauge_id);
+
+      std::istringstream  xml_s(source_header.source.xml);
+      XMLReader  sourcetop(xml_s);
+
+      DiluteZNQuarkSourceConstEnv::Params  srcParams(sourcetop,
+						     source_header.source.path);
+      DiluteZNQuarkSourceConstEnv::SourceConst<LatticeFermion>  srcConst(srcParams);
+
+      LatticeFermion soln = zero;
+      SystemSolverResults_t res = (*PP)(soln, srcConst(u));
+
+      QDPIO::cout << name << ": t0= " << t0 << " dil= " << dil
+		  << " n_count= " << res.n_count << std::endl;
+
+      return soln;
+    }
+
+  } // namespace DilutionQuarkSourceSolveEnv
+
+}// namespace Chroma
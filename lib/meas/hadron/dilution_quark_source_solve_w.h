@@ -0,0 +1,149 @@
+// -*- C++ -*-
+/*! \file
+ * \brief Dilution scheme that solves for each diluted source on demand
+ *
+ * The diluted sources are given by their MAKE_SOURCE headers. Each source
+ * is rebuilt from its seed, and solved for, only when its solution is
+ * requested, so no solution files are read or written and a solution is
+ * never held by the scheme.
+ */
+
+#ifndef __dilution_quark_source_solve_h__
+#define __dilution_quark_source_solve_h__
+
+#include "chromabase.h"
+#include "handle.h"
+#include "fermact.h"
+#include "syssolver.h"
+#include "meas/hadron/dilution_scheme.h"
+#include "io/qprop_io.h"
+
+namespace Chroma
+{
+  /*! \ingroup hadron */
+  namespace DilutionQuarkSourceSolveEnv
+  {
+    extern const std::string name;
+    bool registerAll();
+
+    //! Parameter structure
+    /*! \ingroup hadron */
+    struct Params
+    {
+      Params();
+      Params(XMLReader& xml_in, const std::string& path);
+      void writeXML(XMLWriter& xml_out, const std::string& path) const;
+
+      struct QuarkSources_t
+      {
+	struct TimeSliceSources_t
+	{
+	  multi1d<PropSourceConst_t> dilution_sources;  /*!< diluted sources per timeslice */
+	};
+
+	multi1d<TimeSliceSources_t> timeslice_sources;  /*!< full time dilution is assumed */
+      };
+
+      std::string    gauge_id;        /*!< gauge field the solutions are computed on */
+      ChromaProp_t   prop;            /*!< propagator parameters for every dilution */
+      QuarkSources_t quark_sources;   /*!< all the diluted sources of a single quark */
+
+    }; // struct Params
+
+
+    //! Dilution scheme whose solutions are computed when they are requested
+    /*!
+     * Any measurement that goes through the DilutionScheme interface, such
+     * as STOCH_HADRON or the STOCH_GROUP operators, can use it in place of
+     * DILUTION_QUARK_SOURCE_CONST_FERM. How many solutions are live at once
+     * is then up to the measurement. Every call of dilutedSolution does a
+     * solve, so a measurement that asks twice pays twice.
+     */
+    class SolveDilutionScheme : public DilutionScheme<LatticeFermion>
+    {
+    public:
+
+      //! Virtual destructor to help with cleanup;
+      ~SolveDilutionScheme() {}
+
+      //! Default constructor
+      SolveDilutionScheme( const Params& p )
+	{
+	  params = p;
+	  init();
+	}
+
+      //! The decay direction
+      int getDecayDir() const {return decay_dir;}
+
+      //! The seed identifies this quark
+      const Seed& getSeed() const {return seed;}
+
+      //! The actual t0 corresponding to this time dilution element
+      int getT0( int t0 ) const {return params.quark_sources.timeslice_sources[t0].dilution_sources[0].t_source;}
+
+      //! The number of dilutions per timeslice fo timeslice t0
+      int getDilSize( int t0 ) const {return params.quark_sources.timeslice_sources[t0].dilution_sources.size();}
+
+      //! The number of dilution timeslices included
+      int getNumTimeSlices() const {return params.quark_sources.timeslice_sources.size();}
+
+      //! The kappa parameter in the wilson action
+      Real getKappa() const;
+
+      //! The info from the cfg on which the inversions are performed
+      std::string getCfgInfo() const
+	{
+	  return cfgInfo;
+	}
+
+      //! returns the prop header for a given dilution
+      std::string getPropHeader(int t0, int dil) const
+	{
+	  return params.prop.fermact.xml;
+	}
+
+      //! returns the source header for a given dilution
+      std::string getSourceHeader(int t0, int dil) const
+	{
+	  return params.quark_sources.timeslice_sources[t0].dilution_sources[dil].source.xml;
+	}
+
+      //! Return the diluted source std::vector
+      LatticeFermion dilutedSource(int t0, int dil) const;
+
+      //! Solve for and return the solution std::vector corresponding to the diluted source
+      LatticeFermion dilutedSolution(int t0, int dil) const;
+
+    protected:
+      //! Initialize the object
+      void init();
+
+      //! Hide partial constructor
+      SolveDilutionScheme() {}
+
+    private:
+      Params params;
+      int    decay_dir;
+      Seed   seed;
+      std::string cfgInfo;
+      Handle< FermionAction<LatticeFermion,
+			    multi1d<LatticeColorMatrix>,
+			    multi1d<LatticeColorMatrix> > > S_f;
+      Handle< SystemSolver<LatticeFermion> > PP;
+    };
+
+  } // namespace DilutionQuarkSourceSolveEnv
+
+
+  //! Reader
+  /*! @ingroup hadron */
+  void read(XMLReader& xml, const std::string& path, DilutionQuarkSourceSolveEnv::Params& param);
+
+  //! Writer
+  /*! @ingroup hadron */
+  void write(XMLWriter& xml, const std::string& path, const DilutionQuarkSourceSolveEnv::Params& param);
+
+} // namespace Chroma
+
+#endif
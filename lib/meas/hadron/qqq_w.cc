@@ -34,6 +34,70 @@
 
 namespace Chroma 
 {
+#if QDP_NC == 3
+  namespace
+  {
+    //! Contract the sink diquark of f1,f2 with f3 and project
+    /*!
+     * The diquark  D_k = sum_s eps_{ijk} f1_i(s) f2_j(s)  only depends on
+     * the source indices of the first two quarks, so it is built once per
+     * (i1,i2) and reused for all 48 (i3,s4) of the third quark.
+     */
+    void contractQQQ(multi2d<ThreeQuarks>& qqq, 
+		     const multi2d<LatticeFermion>& f1,
+		     const multi2d<LatticeFermion>& f2,
+		     const multi2d<LatticeFermion>& f3,
+		     const SftMom& phases,
+		     int t0, int bc_spec)
+    {
+      int length  = phases.numSubsets();
+      int num_mom = phases.numMom();
+
+      // Unit colour vectors to pick out the components of the diquark
+      multi1d<LatticeColorVector> e(Nc);
+      for(int k(0);k<Nc;k++){
+	e[k] = zero;
+	pokeColor(e[k], LatticeComplex(1.0), k);
+      }
+
+      multi1d<LatticeComplex> diquark(Nc) ;
+      LatticeComplex cc ;
+      multi2d<DComplex> foo(num_mom,length) ;
+      for(QuarkIndex i2;i2.NotEnd();++i2)
+	for(QuarkIndex i1;i1.NotEnd();++i1){
+	  // s is the sink spin index of the 1 and 2 quark
+	  // that participate in the diquark
+	  for(int k(0);k<Nc;k++){
+	    diquark[k] = 0.0;
+	    for(int s(0);s<Ns;s++) //contract the diquark on the sink
+	      diquark[k] += colorContract(peekSpin(f1[i1.s][i1.c],s ),
+					  peekSpin(f2[i2.s][i2.c],s ),
+					  e[k]);
+	  }
+
+	  for(int s4(0);s4<Ns;s4++) //sink spin index of the 3rd quark 
+	    for(QuarkIndex i3;i3.NotEnd();++i3){
+	      LatticeColorVector q = peekSpin(f3[i3.s][i3.c],s4);
+	      cc = diquark[0]*peekColor(q,0);
+	      for(int k(1);k<Nc;k++)
+		cc += diquark[k]*peekColor(q,k);
+
+	      foo = phases.sft(cc); 
+	      for(int sink_mom_num(0); sink_mom_num < num_mom; sink_mom_num++) 
+		for(int t = 0; t < length; ++t){
+		  //shift source to 0 and take care of the antiperiodic BC
+		  //sign flip for the baryon
+		  int t_eff = (t - t0 + length) % length;
+		  qqq[sink_mom_num][t_eff](i1,i2,i3,s4) = 
+		    (bc_spec < 0 && (t_eff+t0) >= length) ? -foo[sink_mom_num][t] :
+		    foo[sink_mom_num][t] ;
+		}
+	    }
+	}
+    }
+  }
+#endif
+
   //! Baryon-Baryon 2-pt functions (C\gamma_5 diquark)
   /*!
    * \ingroup hadron
@@ -87,34 +151,7 @@ namespace Chroma
       PropToFerm(q3, f3[i.s][i.c] ,i.c,i.s) ;
     }
   
-    LatticeComplex cc ;
-    multi2d<DComplex> foo(num_mom,length) ;
-    for(int s4(0);s4<Ns;s4++) //sink spin index of the 3rd quark 
-      for(QuarkIndex i3;i3.NotEnd();++i3)
-	for(QuarkIndex i2;i2.NotEnd();++i2)
-	  for(QuarkIndex i1;i1.NotEnd();++i1){
-	    //cout<<"QuarkIndex iterator: "<<i1.s<<" "<<i1.c<<std::endl;
-	    cc=0.0;
-	    // s is the sink spin index of the 1 and 2 quark
-	    // that participate in the diquark
-	    for(int s(0);s<Ns;s++) //contract the diquark on the sink
-	      cc += colorContract(peekSpin(f1[i1.s][i1.c],s ),
-				  peekSpin(f2[i2.s][i2.c],s ),
-				  peekSpin(f3[i3.s][i3.c],s4));
-
-	    foo = phases.sft(cc); 
-	    for(int sink_mom_num(0); sink_mom_num < num_mom; sink_mom_num++) 
-	      for(int t = 0; t < length; ++t){
-		//shift source to 0 and take care of the antiperiodic BC
-		//sign flip for the baryon
-		int t_eff = (t - t0 + length) % length;
-		qqq[sink_mom_num][t_eff](i1,i2,i3,s4) = 
-		  (bc_spec < 0 && (t_eff+t0) >= length) ? -foo[sink_mom_num][t] :
-		  foo[sink_mom_num][t] ;
-		//cout<<t<<" "<<qqq[sink_mom_num][t](i1,i2,i3,s4)<<std::endl ;
-	      }
-	    //cout<<i1.s<<" "<<qqq[0][0](i1,i2,i3,s4)<<std::endl ;
-	  }
+    contractQQQ(qqq, f1, f2, f3, phases, t0, bc_spec);
 
     QDPIO::cout<<"Finished the qqq code\n";
 
@@ -161,34 +198,7 @@ namespace Chroma
       PropToFerm(q3, f3[i.s][i.c] ,i.c,i.s) ;
     }
   
-    LatticeComplex cc ;
-    multi2d<DComplex> foo(num_mom,length) ;
-    for(int s4(0);s4<Ns;s4++) //sink spin index of the 3rd quark 
-      for(QuarkIndex i3;i3.NotEnd();++i3)
-	for(QuarkIndex i2;i2.NotEnd();++i2)
-	  for(QuarkIndex i1;i1.NotEnd();++i1){
-	    //cout<<"QuarkIndex iterator: "<<i1.s<<" "<<i1.c<<std::endl;
-	    cc=0.0;
-	    // s is the sink spin index of the 1 and 2 quark
-	    // that participate in the diquark
-	    for(int s(0);s<Ns;s++) //contract the diquark on the sink
-	      cc += colorContract(peekSpin(f1[i1.s][i1.c],s ),
-				  peekSpin(f2[i2.s][i2.c],s ),
-				  peekSpin(f3[i3.s][i3.c],s4));
-
-	    foo = phases.sft(cc); 
-	    for(int sink_mom_num(0); sink_mom_num < num_mom; sink_mom_num++) 
-	      for(int t = 0; t < length; ++t){
-		//shift source to 0 and take care of the antiperiodic BC
-		//sign flip for the baryon
-		int t_eff = (t - t0 + length) % length;
-		qqq[sink_mom_num][t_eff](i1,i2,i3,s4) = 
-		  (bc_spec < 0 && (t_eff+t0) >= length) ? -foo[sink_mom_num][t] :
-		  foo[sink_mom_num][t] ;
-		//cout<<t<<" "<<qqq[sink_mom_num][t](i1,i2,i3,s4)<<std::endl ;
-	      }
-	    //cout<<i1.s<<" "<<qqq[0][0](i1,i2,i3,s4)<<std::endl ;
-	  }
+    contractQQQ(qqq, f1, f2, f3, phases, t0, bc_spec);
 
     QDPIO::cout<<"Finished the qqq code\n";
 
@@ -11,6 +11,7 @@
 #include "meas/eig/eig_spec_array.h"
 #include "meas/inline/io/named_objmap.h"
 #include "meas/inline/make_xml_file.h"
+#include "update/molecdyn/monomial/remez_coeff_store.h"
 
 #include "actions/ferm/linop/lopscl.h"
 #include "actions/ferm/fermacts/fermact_factory_w.h"
@@ -240,6 +241,8 @@ namespace Chroma
 		  xml_out);
     pop(xml_out); // LowestEv
 
+    Real lambda_lo = lambda[0];
+
     QDPIO::cout << "Look for highest ev" << std::endl;
     Handle< LinearOperator<LatticeFermion> > MinusMM(new lopscl<LatticeFermion, Real>(MM, Real(-1.0)));
   
@@ -266,6 +269,11 @@ namespace Chroma
 		  xml_out);
     pop(xml_out); // HighestEv
 
+    // Rational approximations of this operator must cover the spectrum
+    Real lambda_hi = -lambda[0];
+    write(xml_out, "RatApproxOutOfRange",
+	  RemezCoeffStoreEnv::checkRange(params.ferm_act.id, params.ferm_act.xml, lambda_lo, lambda_hi));
+
     pop(xml_out); // pop("EigBndsMdagM");
   } 
 
@@ -312,6 +320,8 @@ namespace Chroma
 		  xml_out);
     pop(xml_out); // LowestEv
 
+    Real lambda_lo = lambda[0];
+
     {
       multi1d<Double> prof(N5);
       for(int n=0; n < N5; n++)
@@ -354,6 +364,13 @@ namespace Chroma
 		  xml_out);
     pop(xml_out); // HighestEv
 
+    // Rational approximations of this operator must cover the spectrum.
+    // None are made of the PV operator
+    Real lambda_hi = -lambda[0];
+    if (! params.usePV)
+      write(xml_out, "RatApproxOutOfRange",
+	    RemezCoeffStoreEnv::checkRange(params.ferm_act.id, params.ferm_act.xml, lambda_lo, lambda_hi));
+
     pop(xml_out); // pop("EigBndsMdagM");
   } 
 
@@ -400,6 +400,7 @@ namespace Chroma
       // Read the quark propagator and extract headers
       LatticePropagator seq_quark_prop;
       SeqSource_t seqsource_header;
+      multi1d<int> shared_t_sinks;
       QDPIO::cout << "Attempt to parse sequential propagator" << std::endl;
       try
       {
@@ -418,7 +419,23 @@ namespace Chroma
 	// Also pull out the id of this source
 	// NEED SECURITY HERE - need a way to cross check props. Use the ID.
 	{
-	  read(seqprop_record_xml, "/SequentialProp/SeqSource", seqsource_header);
+	  // A coherent seqprop holds several sinks, pick the ones made from this forward source
+	  multi1d<SeqSource_t> seqsource_headers;
+	  readSeqSources(seqprop_record_xml, "/SequentialProp", source_header, seqsource_headers);
+	  seqsource_header = seqsource_headers[0];
+
+	  // Sinks sharing this source only differ in t_sink
+	  if (seqsource_headers.size() > 1)
+	  {
+	    QDPIO::cout << "Coherent sinks share this source: the correlators are summed over t_sink =";
+	    shared_t_sinks.resize(seqsource_headers.size());
+	    for(int k=0; k < seqsource_headers.size(); ++k)
+	    {
+	      shared_t_sinks[k] = seqsource_headers[k].t_sink;
+	      QDPIO::cout << " " << shared_t_sinks[k];
+	    }
+	    QDPIO::cout << std::endl;
+	  }
 	}
 
 	// Save seqprop input
@@ -466,6 +483,8 @@ namespace Chroma
       write(xml_seq_src, "seqsrc_type", seqsrc_type);
       write(xml_seq_src, "t_source", t_source);
       write(xml_seq_src, "t_sink", t_sink);
+      if (shared_t_sinks.size() > 1)
+	write(xml_seq_src, "coherent_t_sinks", shared_t_sinks);
       write(xml_seq_src, "sink_mom", sink_mom);
       write(xml_seq_src, "gamma_insertion", gamma_insertion);
 	
@@ -12,6 +12,7 @@
 #include "meas/smear/disp_colvec_map.h"
 #include "util/ferm/subset_vectors.h"
 #include "util/ferm/key_val_db.h"
+#include "util/ferm/db_restart.h"
 #include "util/ft/sftmom.h"
 #include "util/info/proginfo.h"
 #include "meas/inline/make_xml_file.h"
@@ -204,6 +205,7 @@ namespace Chroma
     Params::Params()
     { 
       frequency = 0; 
+      restartP = false;
       param.mom2_max = 0;
     }
 
@@ -224,6 +226,11 @@ namespace Chroma
 	// Read in the output propagator/source configuration info
 	read(paramtop, "NamedObject", named_obj);
 
+	// Optionally resume from a partially written file
+	restartP = false;
+	if (paramtop.count("Restart") != 0)
+	  read(paramtop, "Restart", restartP);
+
 	// Possible alternate XML file pattern
 	if (paramtop.count("xml_file") != 0) 
 	{
@@ -249,6 +256,8 @@ namespace Chroma
       // Write out the output propagator/source configuration info
       write(xml_out, "NamedObject", named_obj);
 
+      write(xml_out, "Restart", restartP);
+
       pop(xml_out);
     }
 
@@ -581,23 +590,25 @@ namespace Chroma
       BinaryStoreDB< SerialDBKey<KeyBaryonElementalOperator_t>, SerialDBData<ValBaryonElementalOperator_t> > 
 	qdp_db;
 
+      // The meta-data for this operator
+      XMLBufferWriter file_xml;
+
+      push(file_xml, "DBMetaData");
+      write(file_xml, "id", std::string("baryonElemOp"));
+      write(file_xml, "lattSize", QDP::Layout::lattSize());
+      write(file_xml, "decay_dir", params.param.decay_dir);
+      proginfo(file_xml);    // Print out basic program info
+      write(file_xml, "Params", params.param);
+      write(file_xml, "Op_Info",displacement_list);
+      write(file_xml, "Config_info", gauge_xml);
+      write(file_xml, "Weights", getEigenValues(eigen_source, params.param.num_vecs));
+      pop(file_xml);
+
+      std::string file_str(file_xml.str());
+
       // Open the file, and write the meta-data and the binary for this operator
       if (! qdp_db.fileExists(params.named_obj.baryon_op_file))
       {
-	XMLBufferWriter file_xml;
-
-	push(file_xml, "DBMetaData");
-	write(file_xml, "id", std::string("baryonElemOp"));
-	write(file_xml, "lattSize", QDP::Layout::lattSize());
-	write(file_xml, "decay_dir", params.param.decay_dir);
-	proginfo(file_xml);    // Print out basic program info
-	write(file_xml, "Params", params.param);
-	write(file_xml, "Op_Info",displacement_list);
-	write(file_xml, "Config_info", gauge_xml);
-	write(file_xml, "Weights", getEigenValues(eigen_source, params.param.num_vecs));
-	pop(file_xml);
-
-	std::string file_str(file_xml.str());
 	qdp_db.setMaxUserInfoLen(file_str.size());
 
 	qdp_db.open(params.named_obj.baryon_op_file, O_RDWR | O_CREAT, 0664);
@@ -607,8 +618,30 @@ namespace Chroma
       else
       {
 	qdp_db.open(params.named_obj.baryon_op_file, O_RDWR, 0664);
+
+	// The operators already present were built from the same vectors and links
+	if (params.restartP)
+	{
+	  std::vector<std::string> paths;
+	  paths.push_back("/DBMetaData/id");
+	  paths.push_back("/DBMetaData/lattSize");
+	  paths.push_back("/DBMetaData/decay_dir");
+	  paths.push_back("/DBMetaData/Params/num_vecs");
+	  paths.push_back("/DBMetaData/Params/use_derivP");
+	  paths.push_back("/DBMetaData/Params/displacement_length");
+	  paths.push_back("/DBMetaData/Params/site_orthog_basis");
+	  paths.push_back("/DBMetaData/Params/LinkSmearing");
+	  paths.push_back("/DBMetaData/Config_info");
+	  paths.push_back("/DBMetaData/Weights");
+
+	  std::string user_data;
+	  qdp_db.getUserdata(user_data);
+	  DBRestartEnv::checkMetaData(name, params.named_obj.baryon_op_file, user_data, file_str, paths);
+	}
       }
 
+      int num_skipped = 0;
+
 
       //
       // Baryon operators
@@ -656,6 +689,21 @@ namespace Chroma
 	    buf[t].val.data().type_of_data = COLORVEC_MATELEM_TYPE_GENERIC;
 	  }
 
+	  // Skip the operators finished by a previous run
+	  if (params.restartP)
+	  {
+	    bool doneP = true;
+	    for(int t=0; t < phases.numSubsets(); ++t)
+	      doneP = doneP && qdp_db.exist(buf[t].key);
+
+	    if (doneP)
+	    {
+	      QDPIO::cout << "skip: mom_num= " << mom_num << " displacement num= " << l << std::endl; 
+	      ++num_skipped;
+	      continue;
+	    }
+	  }
+
 
 	  // The keys for the spin and displacements for this particular elemental operator
 	  multi1d<KeyDispColorVector_t> keyDispColorVector(3);
@@ -716,6 +764,12 @@ namespace Chroma
 
       pop(xml_out); // ElementalOps
 
+      if (params.restartP)
+      {
+	QDPIO::cout << name << ": skipped " << num_skipped << " operators found in " << params.named_obj.baryon_op_file << std::endl;
+	write(xml_out, "num_skipped", num_skipped);
+      }
+
       // Close the namelist output file XMLDAT
       pop(xml_out);     // BaryonMatElemColorVector
 
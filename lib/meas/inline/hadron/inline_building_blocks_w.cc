@@ -497,6 +497,7 @@ QDPIO::cout << "cfs=XX" << params.param.cfs.xml << "XX" << std::endl;
 
       multi1d< LatticePropagator > B( 1 );
       SeqSource_t seqsource_header;
+      multi1d<int> shared_t_sinks;
       QDPIO::cout << "Attempt to parse backward propagator" << std::endl;
       Out << "parsing backward u propagator " << params.bb.BkwdProps[loop].BkwdPropId << " ... " << "\n";  Out.flush();
       try
@@ -513,7 +514,20 @@ QDPIO::cout << "cfs=XX" << params.param.cfs.xml << "XX" << std::endl;
 	// Also pull out the id of this source
 	// NEED SECURITY HERE - need a way to cross check props. Use the ID.
 	{
-	  read(BkwdPropRecordXML, "/SequentialProp/SeqSource", seqsource_header);
+	  // A coherent seqprop holds several sinks, pick the ones made from this forward source
+	  multi1d<SeqSource_t> seqsource_headers;
+	  readSeqSources(BkwdPropRecordXML, "/SequentialProp", source_header, seqsource_headers);
+	  seqsource_header = seqsource_headers[0];
+
+	  // Sinks sharing this source only differ in t_sink
+	  if (seqsource_headers.size() > 1)
+	  {
+	    shared_t_sinks.resize(seqsource_headers.size());
+	    for(int k=0; k < seqsource_headers.size(); ++k)
+	      shared_t_sinks[k] = seqsource_headers[k].t_sink;
+
+	    Out << "coherent sinks share this source: building blocks are summed over their t_sink" << "\n";  Out.flush();
+	  }
 	}
 
 	// Sanity check - write out the norm2 of the forward prop in the j_decay direction
@@ -528,6 +542,8 @@ QDPIO::cout << "cfs=XX" << params.param.cfs.xml << "XX" << std::endl;
 	  write(XmlOut, "BkwdPropId", params.bb.BkwdProps[loop].BkwdPropId);
 	  write(XmlOut, "BkwdPropG5Format", params.bb.BkwdProps[loop].BkwdPropG5Format);
 	  write(XmlOut, "SequentialSourceType", seqsource_header.seqsrc.id);
+	  if (shared_t_sinks.size() > 1)
+	    write(XmlOut, "CoherentTSinks", shared_t_sinks);
 	  write(XmlOut, "BkwdPropXML", BkwdPropXML);
 	  write(XmlOut, "BkwdPropRecordXML", BkwdPropRecordXML);
 	  write(XmlOut, "BkwdPropCheck", BkwdPropCheck);
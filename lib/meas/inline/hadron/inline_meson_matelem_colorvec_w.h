@@ -51,6 +51,7 @@ namespace Chroma
 
       Param_t        param;      /*!< Parameters */    
       NamedObject_t  named_obj;  /*!< Named objects */
+      bool           restartP;   /*!< Skip the operators already in an existing meson_op_file */
       std::string    xml_file;   /*!< Alternate XML file pattern */
     };
 
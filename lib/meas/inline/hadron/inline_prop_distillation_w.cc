@@ -18,6 +18,7 @@
 #include "util/ferm/spin_rep.h"
 #include "util/ferm/diractodr.h"
 #include "util/ferm/twoquark_contract_ops.h"
+#include "util/ferm/db_restart.h"
 #include "util/ft/time_slice_set.h"
 #include "util/info/proginfo.h"
 #include "actions/ferm/fermacts/fermact_factory_w.h"
@@ -118,6 +119,9 @@ namespace Chroma
     
       write(xml, "Param", input.param);
       write(xml, "NamedObject", input.named_obj);
+      if (input.soln_cacheP)
+	write(xml, "SolnCache", input.soln_cache);
+      write(xml, "Restart", input.restartP);
 
       pop(xml);
     }
@@ -416,7 +420,7 @@ namespace Chroma
 
     //----------------------------------------------------------------------------
     // Param stuff
-    Params::Params() { frequency = 0; }
+    Params::Params() { frequency = 0; soln_cacheP = false; restartP = false; }
 
     Params::Params(XMLReader& xml_in, const std::string& path) 
     {
@@ -435,6 +439,19 @@ namespace Chroma
 	// Read in the output propagator/source configuration info
 	read(paramtop, "NamedObject", named_obj);
 
+	// Optional on-disk solution cache
+	soln_cacheP = false;
+	if (paramtop.count("SolnCache") != 0)
+	{
+	  soln_cacheP = true;
+	  read(paramtop, "SolnCache", soln_cache);
+	}
+
+	// Optionally resume from a partially written file
+	restartP = false;
+	if (paramtop.count("Restart") != 0)
+	  read(paramtop, "Restart", restartP);
+
 	// Possible alternate XML file pattern
 	if (paramtop.count("xml_file") != 0) 
 	{
@@ -585,31 +602,45 @@ namespace Chroma
 
       QDPIO::cout << "Open solution file" << std::endl;
 
+      XMLBufferWriter file_xml;
+
+      push(file_xml, "MODMetaData");
+      write(file_xml, "id", std::string("propDistillation"));
+      write(file_xml, "lattSize", QDP::Layout::lattSize());
+      write(file_xml, "decay_dir", decay_dir);
+      write(file_xml, "num_vecs", params.param.contract.num_vecs);
+      write(file_xml, "Nt_backward", params.param.contract.Nt_backward);
+      write(file_xml, "Nt_backward", params.param.contract.Nt_backward);
+      write(file_xml, "mass_label", params.param.contract.mass_label);
+      proginfo(file_xml);    // Print out basic program info
+      write(file_xml, "Params", params.param);
+      write(file_xml, "Config_info", gauge_xml);
+      pop(file_xml);
+
       if (! prop_obj.fileExists(params.named_obj.soln_file))
       {
-	XMLBufferWriter file_xml;
-
-	push(file_xml, "MODMetaData");
-	write(file_xml, "id", std::string("propDistillation"));
-	write(file_xml, "lattSize", QDP::Layout::lattSize());
-	write(file_xml, "decay_dir", decay_dir);
-	write(file_xml, "num_vecs", params.param.contract.num_vecs);
-	write(file_xml, "Nt_backward", params.param.contract.Nt_backward);
-	write(file_xml, "Nt_backward", params.param.contract.Nt_backward);
-	write(file_xml, "mass_label", params.param.contract.mass_label);
-	proginfo(file_xml);    // Print out basic program info
-	write(file_xml, "Params", params.param);
-	write(file_xml, "Config_info", gauge_xml);
-	pop(file_xml);
-
-	std::string file_str(file_xml.str());
-	  
 	prop_obj.insertUserdata(file_xml.str());
 	prop_obj.open(params.named_obj.soln_file, std::ios_base::in | std::ios_base::out | std::ios_base::trunc);
       }
       else
       {
 	prop_obj.open(params.named_obj.soln_file);
+
+	// The solutions already present were made with the same action and vectors
+	if (params.restartP)
+	{
+	  std::vector<std::string> paths;
+	  paths.push_back("/MODMetaData/id");
+	  paths.push_back("/MODMetaData/lattSize");
+	  paths.push_back("/MODMetaData/decay_dir");
+	  paths.push_back("/MODMetaData/mass_label");
+	  paths.push_back("/MODMetaData/Params/Propagator");
+	  paths.push_back("/MODMetaData/Config_info");
+
+	  std::string user_data;
+	  prop_obj.getUserdata(user_data);
+	  DBRestartEnv::checkMetaData(name, params.named_obj.soln_file, user_data, file_xml.str(), paths);
+	}
       }
       
       QDPIO::cout << "Finished opening solution file" << std::endl;
@@ -659,6 +690,24 @@ namespace Chroma
 
 	Handle< SystemSolver<LatticeFermion> > PP = S_f->qprop(state,
 							       params.param.prop.invParam);
+
+	// Optional on-disk cache of the solutions. The propagator group holds
+	// the fermion action, including its boundary conditions, and the inverter
+	SolnCacheEnv::SolnCache soln_cache(params.soln_cache);
+	bool use_cacheP = params.soln_cacheP && soln_cache.enabled();
+	std::string gauge_sum;
+	std::string prop_xml;
+	int num_cache_hits = 0;
+	int num_skipped = 0;
+
+	if (use_cacheP)
+	{
+	  gauge_sum = SolnCacheEnv::checksum(u);
+
+	  XMLBufferWriter prop_xml_buf;
+	  write(prop_xml_buf, "Propagator", params.param.prop);
+	  prop_xml = prop_xml_buf.str();
+	}
       
 	QDPIO::cout << "Suitable factory found: compute all the quark props" << std::endl;
 	swatch.start();
@@ -680,6 +729,19 @@ namespace Chroma
 	  // The space distillation loop
 	  for(int colorvec_src=0; colorvec_src < num_vecs; ++colorvec_src)
 	  {
+	    // Skip the solves finished by a previous run
+	    std::list<KeyPropDistillation_t> snk_keys(getSnkKeys(t_source, colorvec_src, 
+								 params.param.contract.Nt_forward,
+								 params.param.contract.Nt_backward,
+								 params.param.contract.mass_label));
+
+	    if (params.restartP && DBRestartEnv::allExist(prop_obj, snk_keys))
+	    {
+	      QDPIO::cout << "skip: t_source= " << t_source << "  colorvec_src= " << colorvec_src << std::endl; 
+	      ++num_skipped;
+	      continue;
+	    }
+
 	    StopWatch sniss1;
 	    sniss1.reset();
 	    sniss1.start();
@@ -705,9 +767,38 @@ namespace Chroma
 
 	      LatticeFermion quark_soln = zero;
 
+	      std::string soln_key;
+	      bool cache_hitP = false;
+	      if (use_cacheP)
+	      {
+		soln_key = soln_cache.makeKey(gauge_sum, prop_xml, SolnCacheEnv::checksum(chi));
+
+		XMLReader meta;
+		if (soln_cache.lookup(soln_key, quark_soln, meta))
+		{
+		  read(meta, "/SolnCache/Meta/Solve/n_count", ncg_had);
+		  cache_hitP = true;
+		  ++num_cache_hits;
+		}
+	      }
+
 	      // Do the propagator inversion
-	      SystemSolverResults_t res = (*PP)(quark_soln, chi);
-	      ncg_had = res.n_count;
+	      if (! cache_hitP)
+	      {
+		SystemSolverResults_t res = (*PP)(quark_soln, chi);
+		ncg_had = res.n_count;
+
+		if (use_cacheP)
+		{
+		  XMLBufferWriter meta;
+		  push(meta, "Solve");
+		  write(meta, "n_count", res.n_count);
+		  write(meta, "resid", res.resid);
+		  pop(meta);
+
+		  soln_cache.insert(soln_key, quark_soln, meta);
+		}
+	      }
 
 	      // Extract into the temporary output array
 	      for(int spin_sink=0; spin_sink < Ns; ++spin_sink)
@@ -745,11 +836,6 @@ namespace Chroma
 
 	    // Write the solutions
 	    QDPIO::cout << "Write propagator solution to disk" << std::endl;
-	    std::list<KeyPropDistillation_t> snk_keys(getSnkKeys(t_source, colorvec_src, 
-								 params.param.contract.Nt_forward,
-								 params.param.contract.Nt_backward,
-								 params.param.contract.mass_label));
-
 	    for(std::list<KeyPropDistillation_t>::const_iterator key= snk_keys.begin();
 		key != snk_keys.end();
 		++key)
@@ -759,6 +845,9 @@ namespace Chroma
 	      prop_obj.insert(*key, TimeSliceIO<LatticeColorVector>(tmptmp, key->t_slice));
 	    } // for key
 
+	    // Flush, so a restart sees this source as done
+	    prop_obj.flush();
+
 	    sniss2.stop();
 	    QDPIO::cout << "Time to write propagators for colorvec_src= " << colorvec_src << "  time = " 
 			<< sniss2.getTimeInSeconds() 
@@ -771,6 +860,19 @@ namespace Chroma
 	QDPIO::cout << "Propagators computed: time= " 
 		    << swatch.getTimeInSeconds() 
 		    << " secs" << std::endl;
+
+	if (use_cacheP)
+	{
+	  push(xml_out, "SolnCache");
+	  write(xml_out, "num_hits", num_cache_hits);
+	  pop(xml_out);
+	}
+
+	if (params.restartP)
+	{
+	  QDPIO::cout << name << ": skipped " << num_skipped << " colorvec sources found in " << params.named_obj.soln_file << std::endl;
+	  write(xml_out, "num_skipped", num_skipped);
+	}
       }
       catch (const std::string& e) 
       {
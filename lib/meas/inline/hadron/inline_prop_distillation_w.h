@@ -12,6 +12,7 @@
 #include "meas/inline/abs_inline_measurement.h"
 #include "io/qprop_io.h"
 #include "io/xml_group_reader.h"
+#include "util/ferm/soln_cache.h"
 
 namespace Chroma 
 { 
@@ -54,6 +55,9 @@ namespace Chroma
 
       Param_t           param;
       NamedObject_t     named_obj;
+      bool              soln_cacheP;    /*!< Use the on-disk solution cache */
+      SolnCacheParams_t soln_cache;
+      bool              restartP;       /*!< Skip the solves already in an existing soln_file */
       std::string       xml_file;       /*!< Alternate XML file pattern */
     };
 
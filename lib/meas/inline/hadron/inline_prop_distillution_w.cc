@@ -18,6 +18,7 @@
 #include "util/ferm/spin_rep.h"
 #include "util/ferm/diractodr.h"
 #include "util/ferm/twoquark_contract_ops.h"
+#include "util/ferm/db_restart.h"
 #include "util/ft/time_slice_set.h"
 #include "util/info/proginfo.h"
 #include "actions/ferm/fermacts/fermact_factory_w.h"
@@ -118,6 +119,7 @@ namespace Chroma
     
       write(xml, "Param", input.param);
       write(xml, "NamedObject", input.named_obj);
+      write(xml, "Restart", input.restartP);
 
       pop(xml);
     }
@@ -158,7 +160,7 @@ namespace Chroma
 
     //----------------------------------------------------------------------------
     // Param stuff
-    Params::Params() { frequency = 0; }
+    Params::Params() { frequency = 0; restartP = false; }
 
     Params::Params(XMLReader& xml_in, const std::string& path) 
     {
@@ -177,6 +179,11 @@ namespace Chroma
 	// Read in the output propagator/source configuration info
 	read(paramtop, "NamedObject", named_obj);
 
+	// Optionally resume from a partially written file
+	restartP = false;
+	if (paramtop.count("Restart") != 0)
+	  read(paramtop, "Restart", restartP);
+
 	// Possible alternate XML file pattern
 	if (paramtop.count("xml_file") != 0) 
 	{
@@ -345,32 +352,50 @@ namespace Chroma
       {
 	QDPIO::cout << "Open solution file" << std::endl;
 
+	XMLBufferWriter file_xml;
+
+	push(file_xml, "MODMetaData");
+	write(file_xml, "id", std::string("propDist"));
+	write(file_xml, "lattSize", QDP::Layout::lattSize());
+	write(file_xml, "decay_dir", decay_dir);
+	write(file_xml, "ensemble", dist_noise_obj.getEnsemble());
+	write(file_xml, "sequence", dist_noise_obj.getSequence());
+	write(file_xml, "t_origin", dist_noise_obj.getOrigin());
+	file_xml << params.param.contract.quark_line_xml.xml;
+	write(file_xml, "quark_line", params.param.contract.quark_lines[0]);
+	proginfo(file_xml);    // Print out basic program info
+	write(file_xml, "Params", params.param);
+	write(file_xml, "Config_info", gauge_xml);
+	pop(file_xml);
+
 	if (! prop_obj.fileExists(params.named_obj.soln_file))
 	{
-	  XMLBufferWriter file_xml;
-
-	  push(file_xml, "MODMetaData");
-	  write(file_xml, "id", std::string("propDist"));
-	  write(file_xml, "lattSize", QDP::Layout::lattSize());
-	  write(file_xml, "decay_dir", decay_dir);
-	  write(file_xml, "ensemble", dist_noise_obj.getEnsemble());
-	  write(file_xml, "sequence", dist_noise_obj.getSequence());
-	  write(file_xml, "t_origin", dist_noise_obj.getOrigin());
-	  file_xml << params.param.contract.quark_line_xml.xml;
-	  write(file_xml, "quark_line", params.param.contract.quark_lines[0]);
-	  proginfo(file_xml);    // Print out basic program info
-	  write(file_xml, "Params", params.param);
-	  write(file_xml, "Config_info", gauge_xml);
-	  pop(file_xml);
-
-	  std::string file_str(file_xml.str());
-	  
 	  prop_obj.insertUserdata(file_xml.str());
 	  prop_obj.open(params.named_obj.soln_file, std::ios_base::in | std::ios_base::out | std::ios_base::trunc);
 	}
 	else
 	{
 	  prop_obj.open(params.named_obj.soln_file);
+
+	  // The solutions already present were made with the same noise, action and vectors
+	  if (params.restartP)
+	  {
+	    std::vector<std::string> paths;
+	    paths.push_back("/MODMetaData/id");
+	    paths.push_back("/MODMetaData/lattSize");
+	    paths.push_back("/MODMetaData/decay_dir");
+	    paths.push_back("/MODMetaData/ensemble");
+	    paths.push_back("/MODMetaData/sequence");
+	    paths.push_back("/MODMetaData/t_origin");
+	    paths.push_back("/MODMetaData/Params/Propagator");
+	    paths.push_back("/MODMetaData/Params/Contractions/mass");
+	    paths.push_back("/MODMetaData/Params/Contractions/QuarkLine");
+	    paths.push_back("/MODMetaData/Config_info");
+
+	    std::string user_data;
+	    prop_obj.getUserdata(user_data);
+	    DBRestartEnv::checkMetaData(name, params.named_obj.soln_file, user_data, file_xml.str(), paths);
+	  }
 	}
 
 	QDPIO::cout << "Finished opening solution file" << std::endl;
@@ -380,6 +405,9 @@ namespace Chroma
       // Total number of iterations
       int ncg_had = 0;
 
+      // Solves found in the solution file
+      int num_skipped = 0;
+
 
       // Rotation from DR to DP
       SpinMatrix diracToDRMat(DiracToDRMat());
@@ -488,6 +516,15 @@ namespace Chroma
 	      sniss1.start();
 	      QDPIO::cout << "dist_src = " << dist_src << std::endl; 
 
+	      // Skip the solves finished by a previous run
+	      if (params.restartP && params.named_obj.save_solnP &&
+		  DBRestartEnv::allExist(prop_obj, quark_line_fact->getSnkKeys(t_source, dist_src)))
+	      {
+		QDPIO::cout << "skip: t_source= " << t_source << "  dist_src= " << dist_src << std::endl; 
+		++num_skipped;
+		continue;
+	      }
+
 	      // Prepare a distilluted source
 	      LatticeColorVector vec_srce = quark_line_fact->getSrc(t_source, dist_src);
 
@@ -554,6 +591,9 @@ namespace Chroma
 
 		  prop_obj.insert(*key, TimeSliceIO<LatticeColorVectorF>(tmptmp, dist_noise_obj.getTime(key->t_slice)));
 		} // for key
+
+		// Flush, so a restart sees this source as done
+		prop_obj.flush();
 	      }
 
 	      sniss2.stop();
@@ -569,6 +609,12 @@ namespace Chroma
 	QDPIO::cout << "Propagators computed: time= " 
 		    << swatch.getTimeInSeconds() 
 		    << " secs" << std::endl;
+
+	if (params.restartP)
+	{
+	  QDPIO::cout << name << ": skipped " << num_skipped << " sources found in " << params.named_obj.soln_file << std::endl;
+	  write(xml_out, "num_skipped", num_skipped);
+	}
       }
       catch (const std::string& e) 
       {
@@ -54,6 +54,7 @@ namespace Chroma
 
       Param_t           param;
       NamedObject_t     named_obj;
+      bool              restartP;           /*!< Skip the solves already in an existing soln_file */
       std::string       xml_file;           /*!< Alternate XML file pattern */
     };
 
@@ -74,7 +74,7 @@ namespace Chroma
 
 
   // Param stuff
-  InlinePropagatorParams::InlinePropagatorParams() { frequency = 0; }
+  InlinePropagatorParams::InlinePropagatorParams() { frequency = 0; soln_cacheP = false; }
 
   InlinePropagatorParams::InlinePropagatorParams(XMLReader& xml_in, const std::string& path) 
   {
@@ -93,6 +93,14 @@ namespace Chroma
       // Read in the output propagator/source configuration info
       read(paramtop, "NamedObject", named_obj);
 
+      // Optional on-disk solution cache
+      soln_cacheP = false;
+      if (paramtop.count("SolnCache") != 0)
+      {
+	soln_cacheP = true;
+	read(paramtop, "SolnCache", soln_cache);
+      }
+
       // Possible alternate XML file pattern
       if (paramtop.count("xml_file") != 0) 
       {
@@ -114,6 +122,8 @@ namespace Chroma
     
     write(xml_out, "Param", param);
     write(xml_out, "NamedObject", named_obj);
+    if (soln_cacheP)
+      write(xml_out, "SolnCache", soln_cache);
 
     pop(xml_out);
   }
@@ -319,11 +329,45 @@ namespace Chroma
     QDPIO::cout << "FermAct = " << params.param.fermact.id << std::endl;
 
 
+    bool success = false;
+
     //
-    // Try the factories
+    // Look for the solution in the on-disk cache
     //
-    bool success = false;
+    SolnCacheEnv::SolnCache soln_cache(params.soln_cache);
+    bool use_cacheP = params.soln_cacheP && soln_cache.enabled();
+    bool cache_hitP = false;
+    std::string soln_key;
 
+    if (use_cacheP)
+    {
+      // The Param group holds the fermion action, including its boundary
+      // conditions, and the inverter
+      XMLBufferWriter param_xml;
+      write(param_xml, "Param", params.param);
+
+      soln_key = soln_cache.makeKey(SolnCacheEnv::checksum(u), 
+				    param_xml.str(),
+				    SolnCacheEnv::checksum(quark_prop_source));
+
+      XMLReader meta;
+      if (soln_cache.lookup(soln_key, quark_propagator, meta))
+      {
+	read(meta, "/SolnCache/Meta/Propagator/ncg_had", ncg_had);
+	cache_hitP = true;
+	success = true;
+      }
+
+      push(xml_out, "SolnCache");
+      write(xml_out, "key", soln_key);
+      write(xml_out, "hit", cache_hitP);
+      pop(xml_out);
+    }
+
+
+    //
+    // Try the factories
+    //
     if (! success)
     {
       try
@@ -378,6 +422,17 @@ namespace Chroma
       QDP_abort(1);
     }
 
+    // Save a newly computed solution for later runs
+    if (use_cacheP && ! cache_hitP)
+    {
+      XMLBufferWriter meta;
+      push(meta, "Propagator");
+      write(meta, "ncg_had", ncg_had);
+      pop(meta);
+
+      soln_cache.insert(soln_key, quark_propagator, meta);
+    }
+
 
     push(xml_out,"Relaxation_Iterations");
     write(xml_out, "ncg_had", ncg_had);
@@ -429,6 +484,7 @@ namespace Chroma
 	new_header.sink_header      = orig_header.sink_header;
 	new_header.seqsource_header = orig_header.seqsource_header;
 	new_header.forward_props    = orig_header.forward_props;
+	new_header.coherent_sinks   = orig_header.coherent_sinks;
 	new_header.gauge_header     = orig_header.gauge_header;
 	write(record_xml, "SequentialProp", new_header);  
       }
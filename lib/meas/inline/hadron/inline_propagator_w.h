@@ -11,6 +11,7 @@
 #include "chromabase.h"
 #include "meas/inline/abs_inline_measurement.h"
 #include "io/qprop_io.h"
+#include "util/ferm/soln_cache.h"
 
 namespace Chroma 
 { 
@@ -40,6 +41,9 @@ namespace Chroma
       std::string     prop_id;
     } named_obj;
 
+    bool              soln_cacheP;   /*!< Use the on-disk solution cache */
+    SolnCacheParams_t soln_cache;
+
     std::string xml_file;  // Alternate XML file pattern
   };
 
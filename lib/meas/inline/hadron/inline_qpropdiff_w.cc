@@ -156,6 +156,10 @@ namespace Chroma
 	QDP_abort(1);
       }
 
+      // The largest relative difference goes to the XML output, for use
+      // in regression tests of solvers against a reference solution
+      Double max_rel_diff = zero;
+
       for(int spin=0; spin < Ns; ++spin){
     	  for(int color=0; color < Nc; ++color ) {
     			LatticeFermion fermA=zero;
@@ -174,6 +178,9 @@ namespace Chroma
 							<< " ||diff||/||A||=" << diff_L2/A_L2
 							<< " ||diff||/||B||="<<diff_L2/B_L2 << std::endl;
 
+    			if (toBool(diff_L2/A_L2 > max_rel_diff))
+    			  max_rel_diff = diff_L2/A_L2;
+
 #if 0
     	      	QDPIO::cout << "QPROP_DIFF: spin="<<spin<<" col="<<color
 			<< " ||diff||_inf="<<diff_Linf
@@ -186,6 +193,8 @@ namespace Chroma
       }
 
 
+      write(xml_out, "max_rel_diff", max_rel_diff);
+
       pop(xml_out);   // qpropdiff
         
       QDPIO::cout << "QPROP_DIFF: ran successfully" << std::endl;
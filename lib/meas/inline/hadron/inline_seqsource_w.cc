@@ -42,6 +42,27 @@ namespace Chroma
   }
 
 
+  //! Coherent sink input
+  void read(XMLReader& xml, const std::string& path, InlineSeqSourceEnv::Params::Coherent_t& input)
+  {
+    XMLReader inputtop(xml, path);
+
+    read(inputtop, "Param", input.param);
+    read(inputtop, "prop_ids", input.prop_ids);
+  }
+
+  //! Coherent sink output
+  void write(XMLWriter& xml, const std::string& path, const InlineSeqSourceEnv::Params::Coherent_t& input)
+  {
+    push(xml, path);
+
+    write(xml, "Param", input.param);
+    write(xml, "prop_ids", input.prop_ids);
+
+    pop(xml);
+  }
+
+
   namespace InlineSeqSourceEnv 
   { 
     namespace
@@ -95,6 +116,20 @@ namespace Chroma
 
 	// Read in the forward_prop/seqsource info
 	read(paramtop, "NamedObject", named_obj);
+
+	// Optional further sinks summed into the same source
+	if (paramtop.count("CoherentSinks") != 0)
+	{
+	  XMLReader coherenttop(paramtop, "CoherentSinks");
+
+	  coherent.resize(coherenttop.count("elem"));
+	  for(int n=0; n < coherent.size(); ++n)
+	  {
+	    std::ostringstream element_xpath;
+	    element_xpath << "elem[" << (n+1) << "]";
+	    read(coherenttop, element_xpath.str(), coherent[n]);
+	  }
+	}
       }
       catch(const std::string& e) 
       {
@@ -112,6 +147,13 @@ namespace Chroma
       write(xml_out, "Param", param);
       write(xml_out, "PropSink", sink_header);
       write(xml_out, "NamedObject", named_obj);
+      if (coherent.size() > 0)
+      {
+	push(xml_out, "CoherentSinks");
+	for(int n=0; n < coherent.size(); ++n)
+	  write(xml_out, "elem", coherent[n]);
+	pop(xml_out);
+      }
     
       pop(xml_out);
     }
@@ -171,66 +213,90 @@ namespace Chroma
       // Calculate some gauge invariant observables just for info.
       MesPlq(xml_out, "Observables", u);
 
+      // All the sinks. The first is the usual one, any further ones are
+      // summed coherently into the same source
+      const int num_sinks = 1 + params.coherent.size();
+
+      multi1d<SeqSource_t> seq_params(num_sinks);
+      multi1d< multi1d<std::string> > prop_ids(num_sinks);
+
+      seq_params[0] = params.param;
+      prop_ids[0]   = params.named_obj.prop_ids;
+      for(int n=1; n < num_sinks; ++n)
+      {
+	seq_params[n] = params.coherent[n-1].param;
+	prop_ids[n]   = params.coherent[n-1].prop_ids;
+      }
+
       // Sanity check
-      if (params.named_obj.prop_ids.size() == 0)
+      for(int n=0; n < num_sinks; ++n)
       {
-	QDPIO::cerr << name << ": sanity error: " << std::endl;
-	QDP_abort(1);
+	if (prop_ids[n].size() == 0)
+	{
+	  QDPIO::cerr << name << ": sanity error: " << std::endl;
+	  QDP_abort(1);
+	}
       }
 
       //
-      // Read the quark propagator and extract headers
+      // Read the quark propagators and extract headers
       //
-      multi1d<LatticePropagator> forward_props(params.named_obj.prop_ids.size());
-      multi1d<ForwardProp_t> forward_headers(params.named_obj.prop_ids.size());
+      multi1d< multi1d<LatticePropagator> > forward_props(num_sinks);
+      multi1d< multi1d<ForwardProp_t> > forward_headers(num_sinks);
       push(xml_out, "Forward_prop_infos");
-      for(int loop=0; loop < params.named_obj.prop_ids.size(); ++loop)
+      for(int n=0; n < num_sinks; ++n)
       {
-	push(xml_out, "elem");
-	try
+	forward_props[n].resize(prop_ids[n].size());
+	forward_headers[n].resize(prop_ids[n].size());
+
+	for(int loop=0; loop < prop_ids[n].size(); ++loop)
 	{
-	  // Snarf the data into a copy
-	  forward_props[loop] =
-	    TheNamedObjMap::Instance().getData<LatticePropagator>(params.named_obj.prop_ids[loop]);
+	  push(xml_out, "elem");
+	  try
+	  {
+	    // Snarf the data into a copy
+	    forward_props[n][loop] =
+	      TheNamedObjMap::Instance().getData<LatticePropagator>(prop_ids[n][loop]);
 	
-	  // Snarf the source info. This is will throw if the source_id is not there
-	  XMLReader prop_file_xml, prop_record_xml;
-	  TheNamedObjMap::Instance().get(params.named_obj.prop_ids[loop]).getFileXML(prop_file_xml);
-	  TheNamedObjMap::Instance().get(params.named_obj.prop_ids[loop]).getRecordXML(prop_record_xml);
+	    // Snarf the source info. This is will throw if the source_id is not there
+	    XMLReader prop_file_xml, prop_record_xml;
+	    TheNamedObjMap::Instance().get(prop_ids[n][loop]).getFileXML(prop_file_xml);
+	    TheNamedObjMap::Instance().get(prop_ids[n][loop]).getRecordXML(prop_record_xml);
    
-	  // Try to invert this record XML into a ChromaProp struct
+	    // Try to invert this record XML into a ChromaProp struct
+	    {
+	      Propagator_t  header;
+	      read(prop_record_xml, "/Propagator", header);
+
+	      forward_headers[n][loop].prop_header   = header.prop_header;
+	      forward_headers[n][loop].source_header = header.source_header;
+	      forward_headers[n][loop].gauge_header  = header.gauge_header;
+	    }
+
+	    // Save prop input
+	    write(xml_out, "Propagator_info", prop_record_xml);
+	  }
+	  catch( std::bad_cast ) 
 	  {
-	    Propagator_t  header;
-	    read(prop_record_xml, "/Propagator", header);
-
-	    forward_headers[loop].prop_header   = header.prop_header;
-	    forward_headers[loop].source_header = header.source_header;
-	    forward_headers[loop].gauge_header  = header.gauge_header;
+	    QDPIO::cerr << name << ": caught dynamic cast error" 
+			<< std::endl;
+	    QDP_abort(1);
 	  }
-
-	  // Save prop input
-	  write(xml_out, "Propagator_info", prop_record_xml);
-	}
-	catch( std::bad_cast ) 
-	{
-	  QDPIO::cerr << name << ": caught dynamic cast error" 
-		      << std::endl;
-	  QDP_abort(1);
-	}
-	catch (const std::string& e) 
-	{
-	  QDPIO::cerr << name << ": std::map call failed: " << e 
-		      << std::endl;
-	  QDP_abort(1);
+	  catch (const std::string& e) 
+	  {
+	    QDPIO::cerr << name << ": std::map call failed: " << e 
+			<< std::endl;
+	    QDP_abort(1);
+	  }
+	  pop(xml_out);
 	}
-	pop(xml_out);
       }
       pop(xml_out);
 
       QDPIO::cout << "Forward propagator successfully read and parsed" << std::endl;
 
       // Derived from input prop
-      int j_decay  = forward_headers[0].source_header.j_decay;
+      int j_decay  = forward_headers[0][0].source_header.j_decay;
 
       // Initialize the slow Fourier transform phases
       SftMom phases(0, true, j_decay);
@@ -238,29 +304,65 @@ namespace Chroma
       // Sanity check - write out the norm2 of the forward prop in the j_decay direction
       // Use this for any possible verification
       push(xml_out, "Forward_prop_correlators");
-      for(int loop=0; loop < params.named_obj.prop_ids.size(); ++loop)
+      for(int n=0; n < num_sinks; ++n)
       {
-	multi1d<Double> forward_prop_corr = sumMulti(localNorm2(forward_props[loop]),
-						     phases.getSet());
+	for(int loop=0; loop < prop_ids[n].size(); ++loop)
+	{
+	  multi1d<Double> forward_prop_corr = sumMulti(localNorm2(forward_props[n][loop]),
+						       phases.getSet());
 
-	push(xml_out, "elem");
-	write(xml_out, "forward_prop_corr", forward_prop_corr);
-	pop(xml_out);
+	  push(xml_out, "elem");
+	  write(xml_out, "forward_prop_corr", forward_prop_corr);
+	  pop(xml_out);
+	}
       }
       pop(xml_out);
 
       // A sanity check
-      if (params.param.t_sink < 0 || params.param.t_sink >= QDP::Layout::lattSize()[j_decay]) 
+      for(int n=0; n < num_sinks; ++n)
       {
-	QDPIO::cerr << "Sink time coordinate incorrect." << std::endl;
-	QDPIO::cerr << "t_sink = " << params.param.t_sink << std::endl;
-	QDP_abort(1);
+	if (seq_params[n].t_sink < 0 || seq_params[n].t_sink >= QDP::Layout::lattSize()[j_decay]) 
+	{
+	  QDPIO::cerr << "Sink time coordinate incorrect." << std::endl;
+	  QDPIO::cerr << "t_sink = " << seq_params[n].t_sink << std::endl;
+	  QDP_abort(1);
+	}
+      }
+
+      // The contractions identify a coherent sink by the source of its forward
+      // props. Sinks from the same source must differ in t_sink.
+      for(int n=0; n < num_sinks; ++n)
+      {
+	for(int m=0; m < n; ++m)
+	{
+	  multi1d<int> t_n = forward_headers[n][0].source_header.getTSrce();
+	  multi1d<int> t_m = forward_headers[m][0].source_header.getTSrce();
+
+	  bool sameP = true;
+	  for(int mu=0; mu < t_n.size(); ++mu)
+	    sameP = sameP && (t_n[mu] == t_m[mu]);
+
+	  if (! sameP)
+	    continue;
+
+	  if (seq_params[n].t_sink == seq_params[m].t_sink)
+	  {
+	    QDPIO::cerr << name << ": coherent sinks " << m << " and " << n 
+			<< " have forward props from the same source and the same t_sink = "
+			<< seq_params[n].t_sink << std::endl;
+	    QDP_abort(1);
+	  }
+
+	  QDPIO::cout << name << ": coherent sinks " << m << " and " << n 
+		      << " share a source, with t_sink = " << seq_params[m].t_sink 
+		      << " and " << seq_params[n].t_sink << std::endl;
+	}
       }
 
 
       //------------------ Start main body of calculations -----------------------------
 
-      LatticePropagator quark_prop_src;
+      LatticePropagator quark_prop_src = zero;
 
       try
       {
@@ -279,38 +381,40 @@ namespace Chroma
 									   params.sink_header.sink.path,
 									   u));
 
-	// Do the sink smearing BEFORE the interpolating operator
-	for(int loop=0; loop < params.named_obj.prop_ids.size(); ++loop)
+	for(int n=0; n < num_sinks; ++n)
 	{
-	  forward_headers[loop].sink_header = params.sink_header;
-	  (*sinkSmearing)(forward_props[loop]);
-	}
+	  // Do the sink smearing BEFORE the interpolating operator
+	  for(int loop=0; loop < prop_ids[n].size(); ++loop)
+	  {
+	    forward_headers[n][loop].sink_header = params.sink_header;
+	    (*sinkSmearing)(forward_props[n][loop]);
+	  }
     
   
-	//
-	// Construct the sequential source
-	//
-	QDPIO::cout << "Sequential source = " << params.param.seqsrc.xml << std::endl;
-
-	std::istringstream  xml_seq(params.param.seqsrc.xml);
-	XMLReader  seqsrctop(xml_seq);
-	QDPIO::cout << "SeqSource = " << params.param.seqsrc.id << std::endl;
+	  //
+	  // Construct the sequential source
+	  //
+	  QDPIO::cout << "Sequential source = " << seq_params[n].seqsrc.xml << std::endl;
+
+	  std::istringstream  xml_seq(seq_params[n].seqsrc.xml);
+	  XMLReader  seqsrctop(xml_seq);
+	  QDPIO::cout << "SeqSource = " << seq_params[n].seqsrc.id << std::endl;
 	
-	Handle< HadronSeqSource<LatticePropagator> >
-	  hadSeqSource(TheWilsonHadronSeqSourceFactory::Instance().createObject(params.param.seqsrc.id,
-										seqsrctop,
-										params.param.seqsrc.path));
+	  Handle< HadronSeqSource<LatticePropagator> >
+	    hadSeqSource(TheWilsonHadronSeqSourceFactory::Instance().createObject(seq_params[n].seqsrc.id,
+										  seqsrctop,
+										  seq_params[n].seqsrc.path));
 
-	swatch.reset();
-	swatch.start();
-	quark_prop_src = (*hadSeqSource)(u, forward_headers, forward_props);
+	  swatch.reset();
+	  swatch.start();
+	  quark_prop_src += (*hadSeqSource)(u, forward_headers[n], forward_props[n]);
 
-	swatch.stop();
+	  swatch.stop();
     
-	QDPIO::cout << "Hadron sequential source computed: time= " 
-		    << swatch.getTimeInSeconds() 
-		    << " secs" << std::endl;
-
+	  QDPIO::cout << "Hadron sequential source computed: time= " 
+		      << swatch.getTimeInSeconds() 
+		      << " secs" << std::endl;
+	}
 
 	// Do the sink smearing AFTER the interpolating operator
 	(*sinkSmearing)(quark_prop_src);
@@ -352,9 +456,19 @@ namespace Chroma
 	SequentialSource_t new_header;
 	new_header.sink_header      = params.sink_header;
 	new_header.seqsource_header = params.param;
-	new_header.forward_props    = forward_headers;
+	new_header.forward_props    = forward_headers[0];
 	new_header.gauge_header     = gauge_xml.printCurrentContext();
 
+	if (num_sinks > 1)
+	{
+	  new_header.coherent_sinks.resize(num_sinks);
+	  for(int n=0; n < num_sinks; ++n)
+	  {
+	    new_header.coherent_sinks[n].seqsource_header = seq_params[n];
+	    new_header.coherent_sinks[n].forward_props    = forward_headers[n];
+	  }
+	}
+
 	XMLBufferWriter record_xml;
 	write(record_xml, "SequentialSource", new_header);
 
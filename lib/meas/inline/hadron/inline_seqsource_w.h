@@ -40,6 +40,21 @@ namespace Chroma
 	multi1d<std::string>   prop_ids;
 	std::string            seqsource_id;
       } named_obj;
+
+      //! A further sink summed into the same sequential source
+      /*!
+       * Contractions pick out the sinks of a forward prop by its source
+       * position. Sinks whose forward props share a source must differ in
+       * t_sink, and their three-point functions are summed in every
+       * contraction with that source.
+       */
+      struct Coherent_t
+      {
+	SeqSource_t            param;      /*!< Sequential source of this sink */
+	multi1d<std::string>   prop_ids;   /*!< Forward props for this sink */
+      };
+
+      multi1d<Coherent_t>      coherent;   /*!< Empty unless coherent */
     };
 
     //! Compute a sequential source
@@ -3,6 +3,7 @@
  *
  */
 
+#include "fermact.h"
 #include "handle.h"
 #include "meas/inline/hadron/inline_stoch_baryon_w.h"
 #include "meas/inline/abs_inline_measurement_factory.h"
@@ -14,6 +15,8 @@
 #include "meas/glue/mesplq.h"
 #include "util/ft/sftmom.h"
 #include "util/info/proginfo.h"
+#include "actions/ferm/fermacts/fermact_factory_w.h"
+#include "actions/ferm/fermacts/fermacts_aggregate_w.h"
 #include "meas/inline/make_xml_file.h"
 
 #include "meas/inline/io/named_objmap.h"
@@ -43,6 +46,7 @@ namespace Chroma
       if (! registered)
       {
 	success &= BaryonOperatorEnv::registerAll();
+	success &= WilsonTypeFermActsEnv::registerAll();
 	success &= TheInlineMeasurementFactory::Instance().registerObject(name, createMeasurement);
 	registered = true;
       }
@@ -57,7 +61,11 @@ namespace Chroma
   {
     XMLReader inputtop(xml, path);
 
-    read(inputtop, "soln_files", input.soln_files);
+    if (inputtop.count("soln_files") != 0)
+      read(inputtop, "soln_files", input.soln_files);
+
+    if (inputtop.count("Sources") != 0)
+      read(inputtop, "Sources", input.sources);
   }
 
 
@@ -66,6 +74,8 @@ namespace Chroma
   {
     push(xml, path);
     write(xml, "soln_files", input.soln_files);
+    if (input.sources.size() > 0)
+      write(xml, "Sources", input.sources);
     pop(xml);
   }
 
@@ -123,6 +133,13 @@ namespace Chroma
       param.baryon_operator = os.str();
     }
 
+    // The solves are done here when the propagator parameters are given
+    param.pipelineP = false;
+    if (paramtop.count("Propagator") != 0)
+    {
+      param.pipelineP = true;
+      read(paramtop, "Propagator", param.prop);
+    }
   }
 
 
@@ -135,6 +152,8 @@ namespace Chroma
 
     write(xml, "version", version);
     write(xml, "mom2_max", param.mom2_max);
+    if (param.pipelineP)
+      write(xml, "Propagator", param.prop);
 
     pop(xml);
   }
@@ -165,6 +184,7 @@ namespace Chroma
   InlineStochBaryonParams::InlineStochBaryonParams()
   { 
     frequency = 0; 
+    param.pipelineP = false;
   }
 
   InlineStochBaryonParams::InlineStochBaryonParams(XMLReader& xml_in, const std::string& path) 
@@ -418,6 +438,21 @@ namespace Chroma
       QDPIO::cout << "quarks.size= " << quarks.size() << std::endl;
       for(int n=0; n < quarks.size(); ++n)
       {
+	// In the pipelined mode only the headers are known here, the solutions
+	// are computed once the sources are built
+	if (params.param.pipelineP)
+	{
+	  QDPIO::cout << "Pipelined mode: sources for source number=" << n << std::endl;
+	  quarks[n].dilutions.resize(params.named_obj.prop.op[n].sources.size());
+
+	  for(int i=0; i < quarks[n].dilutions.size(); ++i)
+	  {
+	    quarks[n].dilutions[i].source_header = params.named_obj.prop.op[n].sources[i];
+	    quarks[n].dilutions[i].prop_header   = params.param.prop;
+	  }
+	  continue;
+	}
+
 	QDPIO::cout << "Attempt to read solutions for source number=" << n << std::endl;
 	quarks[n].dilutions.resize(params.named_obj.prop.op[n].soln_files.size());
 
@@ -641,6 +676,67 @@ namespace Chroma
       }
     }
 
+    //
+    // In the pipelined mode quarks 1 and 2 are solved here and held, since
+    // every sink operator element needs one solution of each. Quark 0 is
+    // solved one dilution at a time while operator B is built.
+    //
+    typedef LatticeFermion               T;
+    typedef multi1d<LatticeColorMatrix>  P;
+    typedef multi1d<LatticeColorMatrix>  Q;
+
+    Handle< FermionAction<T,P,Q> > S_f;
+    Handle< SystemSolver<LatticeFermion> > PP;
+
+    if (params.param.pipelineP)
+    {
+      swatch.start();
+
+      try
+      {
+	std::istringstream  xml_f(params.param.prop.fermact.xml);
+	XMLReader  fermacttop(xml_f);
+	QDPIO::cout << "FermAct = " << params.param.prop.fermact.id << std::endl;
+
+	S_f = TheFermionActionFactory::Instance().createObject(params.param.prop.fermact.id,
+							       fermacttop,
+							       params.param.prop.fermact.path);
+
+	Handle< FermState<T,P,Q> > state(S_f->createState(u));
+
+	PP = S_f->qprop(state, params.param.prop.invParam);
+
+	push(xml_out, "Solves");
+	for(int n=1; n < quarks.size(); ++n)
+	{
+	  for(int i=0; i < quarks[n].dilutions.size(); ++i)
+	  {
+	    quarks[n].dilutions[i].soln = zero;
+	    SystemSolverResults_t res = (*PP)(quarks[n].dilutions[i].soln, quarks[n].dilutions[i].source);
+
+	    push(xml_out, "elem");
+	    write(xml_out, "n", n);
+	    write(xml_out, "i", i);
+	    write(xml_out, "n_count", res.n_count);
+	    pop(xml_out);
+	  }
+	}
+	pop(xml_out);  // Solves
+      }
+      catch(const std::string& e) 
+      {
+	QDPIO::cerr << ": Caught Exception solving for the sources: " << e << std::endl;
+	QDP_abort(1);
+      }
+
+      swatch.stop();
+
+      QDPIO::cout << "Quarks 1 and 2 solved: time= "
+		  << swatch.getTimeInSeconds() 
+		  << " secs" << std::endl;
+    }
+
+
     // Operator A
     swatch.start();
     BaryonOperator_t  baryon_opA;
@@ -775,38 +871,79 @@ namespace Chroma
     {
       for(int ord=0; ord < baryon_opB.orderings.size(); ++ord)
       {
-	QDPIO::cout << "Operator B: ordering = " << ord << std::endl;
-
 	baryon_opB.perms[ord] = perms[ord];
-      
-	// Operator construction
-	const QuarkSourceSolutions_t& q0 = quarks[perms[ord][0]];
-	const QuarkSourceSolutions_t& q1 = quarks[perms[ord][1]];
-	const QuarkSourceSolutions_t& q2 = quarks[perms[ord][2]];
 
-	baryon_opB.orderings[ord].op.resize(q0.dilutions.size(),
-					    q1.dilutions.size(),
-					    q2.dilutions.size());
-	
-	for(int i=0; i < q0.dilutions.size(); ++i)
+	baryon_opB.orderings[ord].op.resize(quarks[perms[ord][0]].dilutions.size(),
+					    quarks[perms[ord][1]].dilutions.size(),
+					    quarks[perms[ord][2]].dilutions.size());
+      }
+
+      // In the pipelined mode each pass holds one solution of quark 0 and
+      // fills, in every ordering, the elements that use it
+      int num_passes = (params.param.pipelineP) ? quarks[0].dilutions.size() : 1;
+
+      for(int d0=0; d0 < num_passes; ++d0)
+      {
+	LatticeFermion soln0;
+
+	if (params.param.pipelineP)
 	{
-	  for(int j=0; j < q1.dilutions.size(); ++j)
+	  soln0 = zero;
+	  SystemSolverResults_t res = (*PP)(soln0, quarks[0].dilutions[d0].source);
+
+	  push(xml_out, "elem");
+	  write(xml_out, "dilution", d0);
+	  write(xml_out, "n_count", res.n_count);
+	  pop(xml_out);
+	}
+
+	for(int ord=0; ord < baryon_opB.orderings.size(); ++ord)
+	{
+	  QDPIO::cout << "Operator B: ordering = " << ord << std::endl;
+
+	  // Operator construction
+	  const QuarkSourceSolutions_t& q0 = quarks[perms[ord][0]];
+	  const QuarkSourceSolutions_t& q1 = quarks[perms[ord][1]];
+	  const QuarkSourceSolutions_t& q2 = quarks[perms[ord][2]];
+
+	  // The dilution range of each slot, pinned to d0 for quark 0 when pipelined
+	  multi1d<int> lo(3), hi(3);
+	  for(int s=0; s < 3; ++s)
 	  {
-	    for(int k=0; k < q2.dilutions.size(); ++k)
+	    lo[s] = 0;
+	    hi[s] = quarks[perms[ord][s]].dilutions.size();
+
+	    if (params.param.pipelineP && perms[ord][s] == 0)
 	    {
-	      multi1d<LatticeComplex> bar = (*baryonOperator)(q0.dilutions[i].soln,
-							      q1.dilutions[j].soln,
-							      q2.dilutions[k].soln,
-							      PLUS);
+	      lo[s] = d0;
+	      hi[s] = d0 + 1;
+	    }
+	  }
 
-	      baryon_opB.orderings[ord].op(i,j,k).ind.resize(bar.size());
-	      for(int l=0; l < bar.size(); ++l)
-		baryon_opB.orderings[ord].op(i,j,k).ind[l].elem = phases.sft(bar[l]);
+	  bool pin0 = params.param.pipelineP && perms[ord][0] == 0;
+	  bool pin1 = params.param.pipelineP && perms[ord][1] == 0;
+	  bool pin2 = params.param.pipelineP && perms[ord][2] == 0;
 
-	    } // end for k
-	  } // end for j
-	} // end for i
-      } // end for ord
+	  for(int i=lo[0]; i < hi[0]; ++i)
+	  {
+	    for(int j=lo[1]; j < hi[1]; ++j)
+	    {
+	      for(int k=lo[2]; k < hi[2]; ++k)
+	      {
+		multi1d<LatticeComplex> bar = (*baryonOperator)((pin0) ? soln0 : q0.dilutions[i].soln,
+								(pin1) ? soln0 : q1.dilutions[j].soln,
+								(pin2) ? soln0 : q2.dilutions[k].soln,
+								PLUS);
+
+		baryon_opB.orderings[ord].op(i,j,k).ind.resize(bar.size());
+		for(int l=0; l < bar.size(); ++l)
+		  baryon_opB.orderings[ord].op(i,j,k).ind[l].elem = phases.sft(bar[l]);
+
+	      } // end for k
+	    } // end for j
+	  } // end for i
+	} // end for ord
+      } // end for d0
     } // end try
     catch(const std::string& e) 
     {
@@ -38,6 +38,9 @@ namespace Chroma
       std::string      baryon_operator;        /*!< baryon operator xml */
       std::string      baryon_operator_type;   /*!< baryon operator name */
 
+      bool             pipelineP;          /*!< Solve the dilutions here instead of reading them */
+      ChromaProp_t     prop;               /*!< Propagator parameters used in the pipelined mode */
+
     } param;
 
     struct Prop_t
@@ -46,6 +49,7 @@ namespace Chroma
       struct Operator_t
       {
 	multi1d<std::string> soln_files;
+	multi1d<PropSourceConst_t> sources;   /*!< Diluted sources solved in the pipelined mode */
       };
 
       std::string          op_file;
@@ -63,7 +67,14 @@ namespace Chroma
 
 
   //! Inline measurement of stochastic baryon operators
-  /*! \ingroup inlinehadron */
+  /*! \ingroup inlinehadron
+   *
+   * When the propagator parameters are given, the diluted sources are
+   * solved here and no solution files are read. A sink operator element
+   * needs one solution of each quark, so the solutions of quarks 1 and 2
+   * are all held, while those of quark 0 are solved and dropped one at a
+   * time. This holds two thirds of the solutions of the file based mode.
+   */
   class InlineStochBaryon : public AbsInlineMeasurement 
   {
   public:
@@ -62,7 +62,13 @@ namespace Chroma
 
 
     //! Inline measurement of stochastic group baryon operators
-    /*! \ingroup inlinehadron */
+    /*! \ingroup inlinehadron
+     *
+     * Pairs with DILUTION_QUARK_SOURCE_SOLVE_FERM to solve for the
+     * dilutions in place of reading solution files. The solutions are then
+     * computed while the annihilation operators of a time slice are built,
+     * and dropped with that time slice.
+     */
     class InlineMeas : public AbsInlineMeasurement 
     {
     public:
@@ -61,7 +61,13 @@ namespace Chroma
 
 
     //! Inline measurement of stochastic group meson operators
-    /*! \ingroup inlinehadron */
+    /*! \ingroup inlinehadron
+     *
+     * The dilution schemes are taken from the factory, so with
+     * DILUTION_QUARK_SOURCE_SOLVE_FERM the solutions are computed as they
+     * are first smeared. Only the smeared quarks of the current time slice
+     * are held.
+     */
     class InlineMeas : public AbsInlineMeasurement 
     {
     public:
@@ -54,6 +54,7 @@ namespace Chroma{
       if (! registered)
       {
 	success &= BaryonOperatorEnv::registerAll();
+	success &= DilutionSchemeEnv::registerAll();
 	success &= TheInlineMeasurementFactory::Instance().registerObject(name, createMeasurement);
 	registered = true;
       }
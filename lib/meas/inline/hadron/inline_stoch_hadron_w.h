@@ -98,7 +98,12 @@ namespace Chroma
     void ParseBaryon(BaryonOp&,const GroupXML_t&) ;
 
   //! Inline measurement of stochastic baryon operators
-  /*! \ingroup inlinehadron */
+  /*! \ingroup inlinehadron
+   *
+   * With the DILUTION_QUARK_SOURCE_SOLVE_FERM dilution scheme the
+   * solutions are computed here rather than read from files. All the
+   * smeared solutions are still held, as the baryons contract three.
+   */
     class InlineMeas : public AbsInlineMeasurement{
     protected:
       //! Do the measurement
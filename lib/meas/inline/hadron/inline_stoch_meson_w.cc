@@ -3,6 +3,7 @@
  *
  */
 
+#include "fermact.h"
 #include "handle.h"
 #include "meas/inline/hadron/inline_stoch_meson_w.h"
 #include "meas/inline/abs_inline_measurement_factory.h"
@@ -16,6 +17,8 @@
 #include "meas/glue/mesplq.h"
 #include "util/ft/sftmom.h"
 #include "util/info/proginfo.h"
+#include "actions/ferm/fermacts/fermact_factory_w.h"
+#include "actions/ferm/fermacts/fermacts_aggregate_w.h"
 #include "meas/inline/make_xml_file.h"
 
 #include "meas/inline/io/named_objmap.h"
@@ -46,6 +49,7 @@ namespace Chroma
       {
 	success &= QuarkSourceSmearingEnv::registerAll();
 	success &= QuarkSinkSmearingEnv::registerAll();
+	success &= WilsonTypeFermActsEnv::registerAll();
 	success &= TheInlineMeasurementFactory::Instance().registerObject(name, createMeasurement);
 	registered = true;
       }
@@ -60,7 +64,11 @@ namespace Chroma
   {
     XMLReader inputtop(xml, path);
 
-    read(inputtop, "soln_files", input.soln_files);
+    if (inputtop.count("soln_files") != 0)
+      read(inputtop, "soln_files", input.soln_files);
+
+    if (inputtop.count("Sources") != 0)
+      read(inputtop, "Sources", input.sources);
   }
 
 
@@ -69,6 +77,8 @@ namespace Chroma
   {
     push(xml, path);
     write(xml, "soln_files", input.soln_files);
+    if (input.sources.size() > 0)
+      write(xml, "Sources", input.sources);
     pop(xml);
   }
 
@@ -117,6 +127,14 @@ namespace Chroma
     }
 
     read(paramtop, "mom2_max", param.mom2_max);
+
+    // The solves are done here when the propagator parameters are given
+    param.pipelineP = false;
+    if (paramtop.count("Propagator") != 0)
+    {
+      param.pipelineP = true;
+      read(paramtop, "Propagator", param.prop);
+    }
   }
 
 
@@ -129,6 +147,8 @@ namespace Chroma
 
     write(xml, "version", version);
     write(xml, "mom2_max", param.mom2_max);
+    if (param.pipelineP)
+      write(xml, "Propagator", param.prop);
 
     pop(xml);
   }
@@ -159,6 +179,7 @@ namespace Chroma
   InlineStochMesonParams::InlineStochMesonParams()
   { 
     frequency = 0; 
+    param.pipelineP = false;
   }
 
   InlineStochMesonParams::InlineStochMesonParams(XMLReader& xml_in, const std::string& path) 
@@ -323,6 +344,24 @@ namespace Chroma
   }
 
 
+  namespace
+  {
+    //! Regenerate a diluted source from its header
+    /*! The source constructor sets the seed and restores it afterwards */
+    LatticeFermion dilutedSource(const PropSourceConst_t& source_header,
+				 const multi1d<LatticeColorMatrix>& u)
+    {
+      std::istringstream  xml_s(source_header.source.xml);
+      XMLReader  sourcetop(xml_s);
+
+      DiluteZNQuarkSourceConstEnv::Params  srcParams(sourcetop, 
+						     source_header.source.path);
+      DiluteZNQuarkSourceConstEnv::SourceConst<LatticeFermion>  srcConst(srcParams);
+
+      return srcConst(u);
+    }
+  }
+
 
   //--------------------------------------------------------------
   // Function call
@@ -420,6 +459,21 @@ namespace Chroma
       QDPIO::cout << "quarks.size= " << quarks.size() << std::endl;
       for(int n=0; n < quarks.size(); ++n)
       {
+	// In the pipelined mode only the headers are known here, the solutions
+	// are computed one at a time while the operators are built
+	if (params.param.pipelineP)
+	{
+	  QDPIO::cout << "Pipelined mode: sources for source number=" << n << std::endl;
+	  quarks[n].dilutions.resize(params.named_obj.prop.op[n].sources.size());
+
+	  for(int i=0; i < quarks[n].dilutions.size(); ++i)
+	  {
+	    quarks[n].dilutions[i].source_header = params.named_obj.prop.op[n].sources[i];
+	    quarks[n].dilutions[i].prop_header   = params.param.prop;
+	  }
+	  continue;
+	}
+
 	QDPIO::cout << "Attempt to read solutions for source number=" << n << std::endl;
 	quarks[n].dilutions.resize(params.named_obj.prop.op[n].soln_files.size());
 
@@ -588,7 +642,8 @@ namespace Chroma
     }
 
 
-    // Operator A
+    // Operator A pairs the sources of quark 1 with the solutions of quark 0,
+    // operator B the sources of quark 0 with the solutions of quark 1
     snoop.start();
     MesonOperator_t  meson_opA;
     meson_opA.mom2_max    = params.param.mom2_max;
@@ -599,6 +654,15 @@ namespace Chroma
     meson_opA.smearing_r  = params.source_smearing.source.xml;
     meson_opA.inser.resize(Ns*Ns);
 
+    MesonOperator_t  meson_opB;
+    meson_opB.mom2_max    = params.param.mom2_max;
+    meson_opB.j_decay     = j_decay;
+    meson_opB.seed_l      = quarks[0].seed;
+    meson_opB.seed_r      = quarks[1].seed;
+    meson_opB.smearing_l  = params.sink_smearing.sink.xml;
+    meson_opB.smearing_r  = params.sink_smearing.sink.xml;
+    meson_opB.inser.resize(Ns*Ns);
+
     // Sanity check
     if ( toBool(meson_opA.seed_l == meson_opA.seed_r) )
     {
@@ -606,7 +670,7 @@ namespace Chroma
       QDP_abort(1);
     }
 
-    // Construct operator A
+    // Construct the operators
     try
     {
       std::istringstream  xml_s(params.source_smearing.source.xml);
@@ -620,85 +684,8 @@ namespace Chroma
 			 params.source_smearing.source.path,
 			 u));
 
-      push(xml_out, "OperatorA");
-
-      // Source smear all the sources up front
-      multi1d<LatticeFermion> smeared_sources(quarks[1].dilutions.size());
-      for(int i=0; i < smeared_sources.size(); ++i)
-      {
-	smeared_sources[i] = quarks[1].dilutions[i].source;
-	(*sourceSmearing)(smeared_sources[i]);
-      }
-
-      // Source smear all the solutions up front
-      multi1d<LatticeFermion> smeared_solns(quarks[0].dilutions.size());
-      for(int j=0; j < smeared_solns.size(); ++j)
-      {
-	smeared_solns[j] = quarks[0].dilutions[j].soln;
-	(*sourceSmearing)(smeared_solns[j]);
-      }
-
-      QDPIO::cout << "source smearings done" << std::endl;
-
-      for(int gamma_value=0; gamma_value < Ns*Ns; ++gamma_value)
-      {
-	meson_opA.inser[gamma_value].op.resize(smeared_sources.size(), smeared_solns.size());
-
-	for(int i=0; i < smeared_sources.size(); ++i)
-	{
-	  for(int j=0; j < smeared_solns.size(); ++j)
-	  {
-	    // Optimize by restricting operations to source time slice
-	    LatticeComplex corr_fn = zero;
-	    corr_fn[phases.getSet()[quarks[1].dilutions[i].source_header.t_source]] = 
-	      localInnerProduct(smeared_sources[i], Gamma(gamma_value) * smeared_solns[j]);
-	    meson_opA.inser[gamma_value].op(i,j).elem = phases.sft(corr_fn);
-	  } // end for j
-	} // end for i
-      } // end for g
-
-      pop(xml_out); // OperatorA
-    } // opA
-    catch(const std::string& e) 
-    {
-      QDPIO::cerr << ": Caught Exception creating source smearing: " << e << std::endl;
-      QDP_abort(1);
-    }
-    catch(...)
-    {
-      QDPIO::cerr << ": Caught generic exception creating source smearing" << std::endl;
-      QDP_abort(1);
-    }
-
-    snoop.stop();
-
-    QDPIO::cout << "Operator A computed: time= "
-		<< snoop.getTimeInSeconds() 
-		<< " secs" << std::endl;
-
-
-    // Operator B
-    snoop.start();
-    MesonOperator_t  meson_opB;
-    meson_opB.mom2_max    = params.param.mom2_max;
-    meson_opB.j_decay     = j_decay;
-    meson_opB.seed_l      = quarks[0].seed;
-    meson_opB.seed_r      = quarks[1].seed;
-    meson_opB.smearing_l  = params.sink_smearing.sink.xml;
-    meson_opB.smearing_r  = params.sink_smearing.sink.xml;
-    meson_opB.inser.resize(Ns*Ns);
-
-    // Sanity check
-    if ( toBool(meson_opB.seed_l == meson_opB.seed_r) )
-    {
-      QDPIO::cerr << "meson op seeds are the same" << std::endl;
-      QDP_abort(1);
-    }
-
-    // Construct operator B
-    {
-      std::istringstream  xml_s(params.sink_smearing.sink.xml);
-      XMLReader  sinktop(xml_s);
+      std::istringstream  xml_k(params.sink_smearing.sink.xml);
+      XMLReader  sinktop(xml_k);
       QDPIO::cout << "Sink = " << params.sink_smearing.sink.id << std::endl;
 
       Handle< QuarkSourceSink<LatticeFermion> >
@@ -708,49 +695,131 @@ namespace Chroma
 		       params.sink_smearing.sink.path,
 		       u));
 
-      push(xml_out, "OperatorB");
+      // Smear all the sources up front. Each operator element involves a single
+      // solution, so the solutions are used one at a time and never all held.
+      // In the pipelined mode the sources are not held either, they are
+      // regenerated from their seed and smeared as they are needed
+      multi1d<LatticeFermion> smeared_sourcesA;
+      multi1d<LatticeFermion> smeared_sourcesB;
 
-      // Sink smear all the sources up front
-      multi1d<LatticeFermion> smeared_sources(quarks[0].dilutions.size());
-      for(int j=0; j < smeared_sources.size(); ++j)
+      if (! params.param.pipelineP)
       {
-	smeared_sources[j] = quarks[0].dilutions[j].source;
-	(*sinkSmearing)(smeared_sources[j]);
+	smeared_sourcesA.resize(quarks[1].dilutions.size());
+	for(int i=0; i < smeared_sourcesA.size(); ++i)
+	{
+	  smeared_sourcesA[i] = quarks[1].dilutions[i].source;
+	  (*sourceSmearing)(smeared_sourcesA[i]);
+	}
+
+	smeared_sourcesB.resize(quarks[0].dilutions.size());
+	for(int j=0; j < smeared_sourcesB.size(); ++j)
+	{
+	  smeared_sourcesB[j] = quarks[0].dilutions[j].source;
+	  (*sinkSmearing)(smeared_sourcesB[j]);
+	}
+
+	QDPIO::cout << "source and sink smearings done" << std::endl;
       }
 
-      // Sink smear all the solutions up front
-      multi1d<LatticeFermion> smeared_solns(quarks[1].dilutions.size());
-      for(int i=0; i < smeared_solns.size(); ++i)
+      for(int gamma_value=0; gamma_value < Ns*Ns; ++gamma_value)
       {
-	smeared_solns[i] = quarks[1].dilutions[i].soln;
-	(*sinkSmearing)(smeared_solns[i]);
+	meson_opA.inser[gamma_value].op.resize(quarks[1].dilutions.size(), quarks[0].dilutions.size());
+	meson_opB.inser[gamma_value].op.resize(quarks[0].dilutions.size(), quarks[1].dilutions.size());
       }
 
-      QDPIO::cout << "sink smearings done" << std::endl;
+      // In the pipelined mode each dilution is solved right before its
+      // contractions, and its solution is dropped right after them
+      typedef LatticeFermion               T;
+      typedef multi1d<LatticeColorMatrix>  P;
+      typedef multi1d<LatticeColorMatrix>  Q;
 
-      for(int gamma_value=0; gamma_value < Ns*Ns; ++gamma_value)
+      Handle< FermionAction<T,P,Q> > S_f;
+      Handle< SystemSolver<LatticeFermion> > PP;
+      if (params.param.pipelineP)
       {
-	meson_opB.inser[gamma_value].op.resize(smeared_sources.size(), smeared_solns.size());
+	std::istringstream  xml_f(params.param.prop.fermact.xml);
+	XMLReader  fermacttop(xml_f);
+	QDPIO::cout << "FermAct = " << params.param.prop.fermact.id << std::endl;
+
+	S_f = TheFermionActionFactory::Instance().createObject(params.param.prop.fermact.id,
+							       fermacttop,
+							       params.param.prop.fermact.path);
 
-	for(int j=0; j < smeared_sources.size(); ++j)
+	Handle< FermState<T,P,Q> > state(S_f->createState(u));
+
+	PP = S_f->qprop(state, params.param.prop.invParam);
+      }
+
+      for(int n=0; n < quarks.size(); ++n)
+      {
+	MesonOperator_t& meson_op = (n == 0) ? meson_opA : meson_opB;
+	const multi1d<LatticeFermion>& smeared_sources = (n == 0) ? smeared_sourcesA : smeared_sourcesB;
+	const QuarkSourceSink<LatticeFermion>& smearing = (n == 0) ? *sourceSmearing : *sinkSmearing;
+	const QuarkSourceSolutions_t& other = quarks[1-n];
+
+	push(xml_out, (n == 0) ? "OperatorA" : "OperatorB");
+
+	for(int j=0; j < quarks[n].dilutions.size(); ++j)
 	{
-	  for(int i=0; i < smeared_solns.size(); ++i)
+	  LatticeFermion smeared_soln;
+
+	  if (params.param.pipelineP)
 	  {
-	    // Optimize by restricting operations to source time slice
-	    LatticeComplex corr_fn = zero;
-	    corr_fn[phases.getSet()[quarks[0].dilutions[j].source_header.t_source]] = 
-	      localInnerProduct(smeared_sources[j], Gamma(gamma_value) * smeared_solns[i]);
-	    meson_opB.inser[gamma_value].op(j,i).elem = phases.sft(corr_fn);
+	    smeared_soln = zero;
+	    SystemSolverResults_t res = (*PP)(smeared_soln, 
+					      dilutedSource(quarks[n].dilutions[j].source_header, u));
+
+	    push(xml_out, "elem");
+	    write(xml_out, "dilution", j);
+	    write(xml_out, "n_count", res.n_count);
+	    pop(xml_out);
+	  }
+	  else
+	  {
+	    smeared_soln = quarks[n].dilutions[j].soln;
+	  }
+
+	  smearing(smeared_soln);
+
+	  for(int i=0; i < other.dilutions.size(); ++i)
+	  {
+	    LatticeFermion regen_source;
+	    if (params.param.pipelineP)
+	    {
+	      regen_source = dilutedSource(other.dilutions[i].source_header, u);
+	      smearing(regen_source);
+	    }
+
+	    const LatticeFermion& smeared_source = (params.param.pipelineP) ? regen_source : smeared_sources[i];
+
+	    for(int gamma_value=0; gamma_value < Ns*Ns; ++gamma_value)
+	    {
+	      // Optimize by restricting operations to source time slice
+	      LatticeComplex corr_fn = zero;
+	      corr_fn[phases.getSet()[other.dilutions[i].source_header.t_source]] = 
+		localInnerProduct(smeared_source, Gamma(gamma_value) * smeared_soln);
+	      meson_op.inser[gamma_value].op(i,j).elem = phases.sft(corr_fn);
+	    } // end for g
 	  } // end for i
 	} // end for j
-      } // end for g
 
-      pop(xml_out); // OperatorB
-    } // opB
+	pop(xml_out); // OperatorA/B
+      } // end for n
+    }
+    catch(const std::string& e) 
+    {
+      QDPIO::cerr << ": Caught Exception creating the operators: " << e << std::endl;
+      QDP_abort(1);
+    }
+    catch(...)
+    {
+      QDPIO::cerr << ": Caught generic exception creating the operators" << std::endl;
+      QDP_abort(1);
+    }
 
     snoop.stop();
 
-    QDPIO::cout << "Operator B computed: time= "
+    QDPIO::cout << "Operators computed: time= "
 		<< snoop.getTimeInSeconds() 
 		<< " secs" << std::endl;
 
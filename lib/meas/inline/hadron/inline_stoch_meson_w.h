@@ -34,6 +34,8 @@ namespace Chroma
     struct Param_t
     {
       int              mom2_max;           /*!< (mom)^2 <= mom2_max */
+      bool             pipelineP;          /*!< Solve each dilution on the fly and contract it immediately */
+      ChromaProp_t     prop;               /*!< Propagator parameters used in the pipelined mode */
     } param;
 
     PropSourceSmear_t  source_smearing;
@@ -45,6 +47,7 @@ namespace Chroma
       struct Operator_t
       {
 	multi1d<std::string> soln_files;
+	multi1d<PropSourceConst_t> sources;   /*!< Diluted sources solved in the pipelined mode */
       };
 
       std::string          op_file;
@@ -62,7 +65,15 @@ namespace Chroma
 
 
   //! Inline measurement of stochastic meson operators
-  /*! \ingroup inlinehadron */
+  /*! \ingroup inlinehadron
+   *
+   * When the propagator parameters are given, the diluted sources are
+   * solved one at a time and each solution is contracted right away, so
+   * the solution files are neither needed nor written. The sources are
+   * not held either: each one is rebuilt from its seed and smeared for
+   * every solution it is contracted with, so only a few lattice fermions
+   * are live at any time, whatever the number of dilutions.
+   */
   class InlineStochMeson : public AbsInlineMeasurement 
   {
   public:
@@ -19,7 +19,9 @@
 #include "meas/smear/link_smearing_aggregate.h"
 #include "meas/smear/link_smearing_factory.h"
 #include "util/ferm/key_timeslice_colorvec.h"
+#include "util/ferm/timeslice_io_cache.h"
 #include "util/ferm/disp_soln_cache.h"
+#include "util/ferm/db_restart.h"
 #include "util/ferm/key_val_db.h"
 #include "util/info/proginfo.h"
 #include "util/ft/sftmom.h"
@@ -35,6 +37,8 @@
 
 #include "meas/inline/io/named_objmap.h"
 
+#include <set>
+
 namespace Chroma 
 { 
   /*!
@@ -151,6 +155,10 @@ namespace Chroma
       read(inputtop, "displacement_length", input.displacement_length);
       read(inputtop, "mass_label", input.mass_label);
       read(inputtop, "num_tries", input.num_tries);
+
+      input.vec_cache_mb = 0;
+      if (inputtop.count("vec_cache_mb") == 1)
+	read(inputtop, "vec_cache_mb", input.vec_cache_mb);
     }
 
     //! Propagator output
@@ -163,6 +171,8 @@ namespace Chroma
       write(xml, "displacement_length", input.displacement_length);
       write(xml, "mass_label", input.mass_label);
       write(xml, "num_tries", input.num_tries);
+      if (input.vec_cache_mb > 0)
+	write(xml, "vec_cache_mb", input.vec_cache_mb);
 
       pop(xml);
     }
@@ -212,6 +222,7 @@ namespace Chroma
     
       write(xml, "Param", input.param);
       write(xml, "NamedObject", input.named_obj);
+      write(xml, "Restart", input.restartP);
 
       pop(xml);
     }
@@ -303,7 +314,7 @@ namespace Chroma
 
     //----------------------------------------------------------------------------
     // Param stuff
-    Params::Params() { frequency = 0; }
+    Params::Params() { frequency = 0; restartP = false; }
 
     Params::Params(XMLReader& xml_in, const std::string& path) 
     {
@@ -322,6 +333,11 @@ namespace Chroma
 	// Read in the output propagator/source configuration info
 	read(paramtop, "NamedObject", named_obj);
 
+	// Optionally resume from a partially written file
+	restartP = false;
+	if (paramtop.count("Restart") != 0)
+	  read(paramtop, "Restart", restartP);
+
 	// Possible alternate XML file pattern
 	if (paramtop.count("xml_file") != 0) 
 	{
@@ -593,7 +609,10 @@ namespace Chroma
     {
     public:
       SourcePropCache(const multi1d<LatticeColorMatrix>& u,
-		      const ChromaProp_t& prop, MODS_t& eigs, int num_tries);
+		      const ChromaProp_t& prop, MODS_t& eigs, int num_tries, int vec_cache_mb);
+
+      //! Report on the source vectors
+      ~SourcePropCache() {if (vec_cache.operator->() != 0) vec_cache->printStats("SourcePropCache");}
 
       //! New t-slice
       void newTimeSource(const Params::Param_t::KeySolnProp_t& key_);
@@ -608,6 +627,9 @@ namespace Chroma
       //! Eigenvectors
       MODS_t& eigen_source;
 
+      //! Source vectors, read ahead in the order of the time sources, if asked for
+      Handle< TimeSliceIOCache<LatticeColorVectorF, MODS_t> > vec_cache;
+
       //! Put it here
       int num_tries;
 
@@ -624,8 +646,12 @@ namespace Chroma
 
     //-------------------------------------------------------------------------------
     SourcePropCache::SourcePropCache(const multi1d<LatticeColorMatrix>& u,
-				     const ChromaProp_t& prop, MODS_t& eigs_, int num_tries_) : eigen_source(eigs_), num_tries(num_tries_)
+				     const ChromaProp_t& prop, MODS_t& eigs_, int num_tries_, int vec_cache_mb) : 
+      eigen_source(eigs_), num_tries(num_tries_)
     {
+      if (vec_cache_mb > 0)
+	vec_cache = new TimeSliceIOCache<LatticeColorVectorF, MODS_t>(eigs_, size_t(vec_cache_mb) << 20);
+
       StopWatch swatch;
       swatch.reset();
       swatch.start();
@@ -676,6 +702,16 @@ namespace Chroma
 
       //! Cache size will depend on cacheP flag
       cache.insert(key, std::map<int, LatticeColorVectorSpinMatrix>());
+
+      //! Its source vectors are wanted next
+      if (vec_cache.operator->() != 0)
+      {
+	std::vector<KeyTimeSliceColorVec_t> vec_order;
+	for(int colorvec=0; colorvec < key.num_vecs; ++colorvec)
+	  vec_order.push_back(KeyTimeSliceColorVec_t(key.t_source, colorvec));
+
+	vec_cache->hint(vec_order);
+      }
     }
 
 
@@ -706,9 +742,19 @@ namespace Chroma
       swatch.start();
 
       LatticeColorVectorF vec_srce = zero;
-      KeyTimeSliceColorVec_t src_key(t_slice, colorvec_ind);
-      TimeSliceIO<LatticeColorVectorF> time_slice_io(vec_srce, t_slice);
-      eigen_source.get(src_key, time_slice_io);
+
+      if (vec_cache.operator->() != 0)
+      {
+	// Read the upcoming source vectors in one batch, then take this one
+	vec_cache->prefetch();
+	vec_cache->getSlice(vec_srce, t_slice, colorvec_ind);
+      }
+      else
+      {
+	KeyTimeSliceColorVec_t src_key(t_slice, colorvec_ind);
+	TimeSliceIO<LatticeColorVectorF> time_slice_io(vec_srce, t_slice);
+	eigen_source.get(src_key, time_slice_io);
+      }
 
       // Loop over each spin source
       for(int spin_ind=0; spin_ind < Ns; ++spin_ind)
@@ -787,6 +833,38 @@ namespace Chroma
     } // void normDisp
 
 
+    //----------------------------------------------------------------------------
+    //! Keys of the elementals for one source vector and insertion
+    std::list< SerialDBKey<KeyUnsmearedMesonElementalOperator_t> >
+    getElemKeys(bool derivP, int t_sink, int t_source, int colorvec_src, int gamma,
+		const std::vector<int>& disp, const multi1d<int>& mom, const std::string& mass,
+		const std::vector<bool>& active_t_slices)
+    {
+      std::list< SerialDBKey<KeyUnsmearedMesonElementalOperator_t> > keys;
+
+      for(int t=0; t < active_t_slices.size(); ++t)
+      {
+	if (! active_t_slices[t]) {continue;}
+
+	SerialDBKey<KeyUnsmearedMesonElementalOperator_t> key;
+
+	key.key().derivP        = derivP;
+	key.key().t_sink        = t_sink;
+	key.key().t_slice       = t;
+	key.key().t_source      = t_source;
+	key.key().colorvec_src  = colorvec_src;
+	key.key().gamma         = gamma;
+	key.key().displacement  = disp;
+	key.key().mom           = mom;
+	key.key().mass          = mass;
+
+	keys.push_back(key);
+      }
+
+      return keys;
+    }
+
+
 
     //-------------------------------------------------------------------------------
     // Function call
@@ -1069,20 +1147,42 @@ namespace Chroma
       //
       BinaryStoreDB< SerialDBKey<KeyUnsmearedMesonElementalOperator_t>, SerialDBData<ValUnsmearedMesonElementalOperator_t> > qdp_db;
 
-      // Open the file, and write the meta-data and the binary for this operator
-      if (! qdp_db.fileExists(params.named_obj.dist_op_file))
+      // The meta-data for this operator
+      XMLBufferWriter file_xml;
+
+      push(file_xml, "DBMetaData");
+      write(file_xml, "id", std::string("unsmearedMesonElemOp"));
+      write(file_xml, "lattSize", QDP::Layout::lattSize());
+      write(file_xml, "decay_dir", decay_dir);
+      proginfo(file_xml);    // Print out basic program info
+      write(file_xml, "Config_info", gauge_xml);
+
+      // What the elementals depend on that is not in the keys
       {
-	XMLBufferWriter file_xml;
-
-	push(file_xml, "DBMetaData");
-	write(file_xml, "id", std::string("unsmearedMesonElemOp"));
-	write(file_xml, "lattSize", QDP::Layout::lattSize());
-	write(file_xml, "decay_dir", decay_dir);
-	proginfo(file_xml);    // Print out basic program info
-	write(file_xml, "Config_info", gauge_xml);
+	std::set<int> num_vecs;
+	for(auto key = params.param.prop_sources.begin(); key != params.param.prop_sources.end(); ++key)
+	  num_vecs.insert(key->num_vecs);
+
+	multi1d<int> vecs(num_vecs.size());
+	int i = 0;
+	for(auto n = num_vecs.begin(); n != num_vecs.end(); ++n)
+	  vecs[i++] = *n;
+
+	push(file_xml, "Params");
+	write(file_xml, "num_vecs", vecs);
+	write(file_xml, "use_derivP", params.param.contract.use_derivP);
+	write(file_xml, "displacement_length", params.param.contract.displacement_length);
+	write(file_xml, "Propagator", params.param.prop);
+	file_xml << params.param.link_smearing.xml;
 	pop(file_xml);
+      }
+      pop(file_xml);
 
-	std::string file_str(file_xml.str());
+      std::string file_str(file_xml.str());
+
+      // Open the file, and write the meta-data and the binary for this operator
+      if (! qdp_db.fileExists(params.named_obj.dist_op_file))
+      {
 	qdp_db.setMaxUserInfoLen(file_str.size());
 
 	qdp_db.open(params.named_obj.dist_op_file, O_RDWR | O_CREAT, 0664);
@@ -1092,8 +1192,30 @@ namespace Chroma
       else
       {
 	qdp_db.open(params.named_obj.dist_op_file, O_RDWR, 0664);
+
+	// Time slices, displacements, gammas, momenta and the mass label are
+	// part of the keys, everything else the elementals depend on is here
+	if (params.restartP)
+	{
+	  std::vector<std::string> paths;
+	  paths.push_back("/DBMetaData/id");
+	  paths.push_back("/DBMetaData/lattSize");
+	  paths.push_back("/DBMetaData/decay_dir");
+	  paths.push_back("/DBMetaData/Config_info");
+	  paths.push_back("/DBMetaData/Params/num_vecs");
+	  paths.push_back("/DBMetaData/Params/use_derivP");
+	  paths.push_back("/DBMetaData/Params/displacement_length");
+	  paths.push_back("/DBMetaData/Params/Propagator");
+	  paths.push_back("/DBMetaData/Params/LinkSmearing");
+
+	  std::string user_data;
+	  qdp_db.getUserdata(user_data);
+	  DBRestartEnv::checkMetaData(name, params.named_obj.dist_op_file, user_data, file_str, paths);
+	}
       }
 
+      int num_skipped = 0;
+
       QDPIO::cout << "Finished opening distillation file" << std::endl;
 
 
@@ -1107,7 +1229,8 @@ namespace Chroma
 
 	// Cache manager
 	QDPIO::cout << name << ": initialize the prop cache" << std::endl;
-	SourcePropCache prop_cache(u, params.param.prop, eigen_source, params.param.contract.num_tries);
+	SourcePropCache prop_cache(u, params.param.prop, eigen_source, params.param.contract.num_tries,
+				   params.param.contract.vec_cache_mb);
 
 	// All the desired solutions
 	QDPIO::cout << name << ": initialize the time sources" << std::endl;
@@ -1169,6 +1292,25 @@ namespace Chroma
 	  for(int colorvec_src=0; colorvec_src < srce_num_vecs; ++colorvec_src)
 	  {
 	    QDPIO::cout << "SOURCE: colorvec_src = " << colorvec_src << std::endl;
+
+	    // Skip the source vectors finished by a previous run before solving for them
+	    if (params.restartP)
+	    {
+	      bool doneP = true;
+	      for(auto dd = disp_gamma_moms.begin(); dd != disp_gamma_moms.end() && doneP; ++dd)
+		for(auto gg = dd->second.begin(); gg != dd->second.end() && doneP; ++gg)
+		  for(auto mm = gg->second.begin(); mm != gg->second.end() && doneP; ++mm)
+		    doneP = DBRestartEnv::allExist(qdp_db, getElemKeys(params.param.contract.use_derivP, t_sink, t_source, colorvec_src,
+									gg->first.gamma, dd->first.deriv, mm->first,
+									params.param.contract.mass_label, active_t_slices));
+
+	      if (doneP)
+	      {
+		QDPIO::cout << "skip: t_sink= " << t_sink << "  t_source= " << t_source << "  colorvec_src= " << colorvec_src << std::endl;
+		++num_skipped;
+		continue;
+	      }
+	    }
 	    
 	    StopWatch snarss1;
 	    snarss1.reset();
@@ -1211,6 +1353,15 @@ namespace Chroma
 
 		  QDPIO::cout << "Insertion: disp= " << disp << "  gamma= " << gamma << " mom= " << mom << std::endl;
 
+		  // Skip the insertions finished by a previous run
+		  if (params.restartP &&
+		      DBRestartEnv::allExist(qdp_db, getElemKeys(params.param.contract.use_derivP, t_sink, t_source, colorvec_src,
+								 gamma, disp, mom, params.param.contract.mass_label, active_t_slices)))
+		  {
+		    QDPIO::cout << "skip: insertion found in " << params.named_obj.dist_op_file << std::endl;
+		    continue;
+		  }
+
 		  //
 		  // Finally, the actual insertion
 		  // NOTE: if we did not have the possibility for derivatives, then the displacement,
@@ -1313,6 +1464,12 @@ namespace Chroma
 	QDP_abort(1);
       }
 
+      if (params.restartP)
+      {
+	QDPIO::cout << name << ": skipped " << num_skipped << " source vectors found in " << params.named_obj.dist_op_file << std::endl;
+	write(xml_out, "num_skipped", num_skipped);
+      }
+
       // Close db
       qdp_db.close();
 
@@ -66,6 +66,7 @@ namespace Chroma
 	  int                       displacement_length;    /*!< Displacement length for insertions */
 	  std::string               mass_label;             /*!< Some kind of mass label */
 	  int                       num_tries;              /*!< In case of bad things happening in the solution vectors, do retries */
+	  int                       vec_cache_mb;           /*!< Memory for cached source time slices in MB per node, 0 (default) for no cache */
 	};
 
 	std::vector<KeySolnProp_t>  prop_sources;           /*!< Sources */
@@ -84,6 +85,7 @@ namespace Chroma
 
       Param_t                       param;                  /*!< Parameters */    
       NamedObject_t                 named_obj;              /*!< Named objects */
+      bool                          restartP;               /*!< Skip the elementals already in an existing dist_op_file */
       std::string                   xml_file;               /*!< Alternate XML file pattern */
     };
 
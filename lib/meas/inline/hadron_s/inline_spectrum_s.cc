@@ -314,6 +314,14 @@ namespace Chroma {
     read(paramtop, "eight_scalars", param.eight_scalars);
     read(paramtop, "eight_rhos", param.eight_rhos);
 
+    if( paramtop.count("Valence_masses") > 0 ) {
+      read(paramtop, "Valence_masses", param.valence_masses);
+    }
+    else
+    {
+      param.valence_masses.resize(0) ; 
+    }
+
     read(paramtop, "t_srce", param.t_srce);
     read(paramtop, "nrow", param.nrow);
     read(paramtop, "sym_shift_oper", param.sym_shift_oper);
@@ -420,6 +428,8 @@ namespace Chroma {
     write(xml, "Wilson_loops", param.Wilson_loops);
     write(xml, "Baryon_local", param.Baryon_local);
     write(xml, "Baryon_vary", param.Baryon_vary);
+    if( param.valence_masses.size() > 0 )
+      write(xml, "Valence_masses", param.valence_masses);
     write(xml, "disconnected_local", param.disconnected_local);
     write(xml, "disconnected_fuzz", param.disconnected_fuzz);
     write(xml, "nrow", param.nrow);
@@ -1370,12 +1380,50 @@ namespace Chroma {
       //Dont need to allocate u_smr here
 
       multi1d<LatticeStaggeredPropagator> stag_prop(8);
+      const multi1d<Real>& valence_masses = params.param.valence_masses;
+      multi1d< multi1d<LatticeStaggeredPropagator> > valence_prop(valence_masses.size());
 
       StopWatch swatch;
       swatch.start();
-      ncg_had += build_basic_8_props(stag_prop, type_of_src, gauge_shift,
-				     sym_shift, u, qprop, xml_out, RsdCG,  
-				     Mass, j_decay);
+      if( valence_masses.size() == 0 ){
+	ncg_had += build_basic_8_props(stag_prop, type_of_src, gauge_shift,
+				       sym_shift, u, qprop, xml_out, RsdCG,  
+				       Mass, j_decay);
+      }
+      else{
+	// The mass of the action and the valence masses, all colours
+	// from one multi-shift solve per source
+	const EvenOddStaggeredTypeFermAct<T,P,Q>* S_eo = 
+	  dynamic_cast<const EvenOddStaggeredTypeFermAct<T,P,Q>*>(&S_f);
+	if( S_eo == 0 ){
+	  QDPIO::cerr << InlineStaggeredSpectrumEnv::name 
+		      << ": Valence_masses need an even-odd staggered action" << std::endl;
+	  QDP_abort(1);
+	}
+
+	multi1d<Real> masses(valence_masses.size() + 1);
+	masses[0] = Mass;
+	for(int k = 0; k < valence_masses.size(); ++k){
+	  masses[k+1] = valence_masses[k];
+	  valence_prop[k].resize(8);
+	}
+
+	for(int src_ind = 0; src_ind < 8 ; ++src_ind){
+	  multi1d<LatticeStaggeredPropagator> props;
+
+	  // t_source as in build_basic_8_props
+	  ncg_had += compute_quark_propagators_s(props, type_of_src, 
+						 gauge_shift, sym_shift,
+						 u, *S_eo, state, xml_out,
+						 masses, RsdCG, 
+						 params.prop_param.invParam.MaxCG,
+						 j_decay, src_ind, 0);
+
+	  stag_prop[src_ind] = props[0];
+	  for(int k = 0; k < valence_masses.size(); ++k)
+	    valence_prop[k][src_ind] = props[k+1];
+	}
+      }
       swatch.stop();
       double time_in_sec  = swatch.getTimeInSeconds();
       QDPIO::cout << "PROF3:build_basic_8_props " << time_in_sec << " sec" << std::endl;
@@ -1413,6 +1461,36 @@ namespace Chroma {
 			   params.param.binary_name);
       }
 
+      // the same tastes at the valence masses
+      for(int k = 0; k < valence_masses.size(); ++k){
+	push(xml_out, "Valence_mass");
+	write(xml_out, "Mass", valence_masses[k]);
+
+	std::ostringstream binary_name;
+	binary_name << params.param.binary_name << "m" << k << "." ;
+
+	if(do_8_pions){
+	  compute_8_pions( valence_prop[k], u , gauge_shift, sym_shift,
+			   xml_out, j_decay, t_length, t_source,
+			   params.param.binary_meson_dump,
+			   binary_name.str());
+	}
+	if(do_8_scalars){
+	  compute_8_scalars( valence_prop[k], u,  gauge_shift, sym_shift,
+			     xml_out, j_decay, t_length, t_source,
+			     params.param.binary_meson_dump,
+			     binary_name.str());
+	}
+	if(do_8_rhos){
+	  compute_8_vectors( valence_prop[k], u,  gauge_shift, sym_shift,
+			     xml_out, j_decay, t_length, t_source,
+			     params.param.binary_meson_dump,
+			     binary_name.str());
+	}
+
+	pop(xml_out);
+      }
+
 
       // if we need to do 4-link singlets and local baryons, do them here
       // so we can re-use the stag_pro[0] as the local corner prop
@@ -58,6 +58,10 @@ namespace Chroma
       bool eight_scalars;               // all scalar meson tastes
       bool eight_rhos;                  // all std::vector meson tastes
 
+      // extra valence masses for the 8 meson tastes, solved together
+      // with the mass of the action by one multi-shift solve
+      multi1d<Real> valence_masses;
+
       // choose parameters 
       GroupXML_t fermact ;
       GroupXML_t fermact2 ;
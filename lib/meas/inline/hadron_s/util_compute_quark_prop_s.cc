@@ -11,6 +11,8 @@
 #include "meas/smear/fuzz_smear.h"
 #include "meas/sources/srcfil.h"
 #include "meas/sources/dilute_gauss_src_s.h"
+#include "actions/ferm/invert/minvcg_mrhs.h"
+#include "util/ferm/transf.h"
 
 #include "util_compute_quark_prop_s.h"
 
@@ -809,4 +811,157 @@ namespace Chroma {
 
 
 
+  /***************************************************************************/
+
+  /**
+     All colours and all masses from one multi-shift solve.
+
+  **/
+
+  int compute_quark_propagators_s(multi1d<LatticeStaggeredPropagator> & quark_props,
+				  stag_src_type type_of_src,
+				  bool gauge_shift,
+				  bool sym_shift,
+				  const multi1d<LatticeColorMatrix> & u ,
+				  const EvenOddStaggeredTypeFermAct<LatticeStaggeredFermion,
+				  multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> > & S_f,
+				  Handle< FermState<LatticeStaggeredFermion,
+				  multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> > > state,
+				  XMLWriter & xml_out,
+				  const multi1d<Real> & Masses,
+				  Real RsdCG, int MaxCG,
+				  int j_decay,
+				  int src_ind, int t_source){
+
+    typedef LatticeStaggeredFermion      T;
+    typedef multi1d<LatticeColorMatrix>  P;
+    typedef multi1d<LatticeColorMatrix>  Q;
+
+    // safety checks
+    check_qprop_source_compatability(type_of_src, gauge_shift, sym_shift,
+				     QPROP_NO_FUZZ);
+
+    int n_mass = Masses.size();
+
+    // All the colour sources
+    multi1d<T> q_source(Nc);
+    for(int color_source = 0; color_source < Nc; ++color_source){
+
+      q_source[color_source] = zero ;
+
+      if( type_of_src == LOCAL_SRC ){
+	multi1d<int> coord(Nd);
+
+	PropIndexTodelta(src_ind, coord) ;
+	srcfil(q_source[color_source], coord,color_source ) ;
+      }
+      else if( type_of_src == GAUGE_INVAR_LOCAL_SOURCE  ) {
+	multi1d<int> coord(Nd);
+
+	// start with local source 
+	coord[0]=0; coord[1] = 0; coord[2] = 0; coord[3] = 0;
+	coord[j_decay] = t_source ;
+	T q_source_local = zero ;
+	srcfil(q_source_local, coord,color_source ) ;
+
+	// now do the shift
+	PropIndexTodelta(src_ind, coord) ;
+	q_source[color_source] = shiftDeltaPropCov(coord, q_source_local, u, sym_shift);
+      }
+      else if( type_of_src ==  NOISY_LOCAL_SOURCE  ) {
+	gaussian_color_src_on_slice(q_source[color_source], color_source,t_source, j_decay);  
+      }
+      else{
+	QDPIO::cerr << "Conflicting source and shift types in " <<
+	  "util_compute_quark_prop_s.cc" <<std::endl;
+	QDPIO::cerr << "double-check your source --- no fuzz-smearing here" 
+		    << std::endl;
+	exit(0);
+      }
+    }
+
+    Handle< EvenOddLinearOperator<T,P,Q> > M(S_f.linOp(state));
+    Handle< LinearOperator<T> > A(S_f.lMdagM(state));
+    Real Mass = S_f.getQuarkMass();
+
+    // (M^dag M)_ee = 4m^2 - D_eo D_oe, so the masses are shifts of A
+    multi1d<Real> shifts(n_mass);
+    multi1d<Real> RsdCGs(n_mass);
+    for(int k = 0; k < n_mass; ++k){
+      shifts[k] = 4*(Masses[k]*Masses[k] - Mass*Mass);
+      RsdCGs[k] = RsdCG;
+    }
+
+    // The preconditioned source  M_ee chi_e + M_eo^dag chi_o  is split into
+    // chi_e and M_eo^dag chi_o, which do not depend on the mass.
+    // A part that vanishes, like for a point source, costs nothing.
+    multi1d<T> rhs(2*Nc);
+    for(int color_source = 0; color_source < Nc; ++color_source){
+      rhs[2*color_source] = zero;
+      rhs[2*color_source][rb[0]] = q_source[color_source];
+
+      rhs[2*color_source+1] = zero;
+      M->evenOddLinOp(rhs[2*color_source+1], q_source[color_source], MINUS);
+    }
+
+    StopWatch swatch;
+    swatch.start();
+
+    multi1d< multi1d<T> > y;
+    multi1d<int> n_count;
+    MInvCGMultiRHS(*A, rhs, y, shifts, RsdCGs, MaxCG, n_count);
+
+    swatch.stop();
+    double time_in_sec  = swatch.getTimeInSeconds();
+
+    int ncg_had = 0 ;
+    for(int n = 0; n < n_count.size(); ++n)
+      ncg_had += n_count[n];
+
+    quark_props.resize(n_mass);
+    multi1d<Real> resid(n_mass);
+
+    for(int k = 0; k < n_mass; ++k){
+      Real invm = Real(1)/(2*Masses[k]);
+      resid[k] = zero;
+
+      for(int color_source = 0; color_source < Nc; ++color_source){
+	T psi, tmp1, r;
+	psi = tmp1 = zero;
+
+	// psi_e = 2m y_chi_e + y_(M_eo^dag chi_o)
+	psi[rb[0]] = 2*Masses[k]*y[2*color_source][k] + y[2*color_source+1][k];
+
+	// psi_o = (1/2m) chi_o - (1/2m) D_oe psi_e 
+	M->oddEvenLinOp(tmp1, psi, PLUS);
+	psi[rb[1]] = invm*(q_source[color_source] - tmp1);
+
+	// True residual, the operator has the mass of the action
+	(*M)(r, psi, PLUS);
+	r += 2*(Masses[k] - Mass)*psi;
+	r -= q_source[color_source];
+	Real rel = sqrt(norm2(r)/norm2(q_source[color_source]));
+	if ( toBool(rel > resid[k]) )
+	  resid[k] = rel;
+
+	FermToProp(psi, quark_props[k], color_source);
+      }
+    }
+
+    // this is done for xmldif reasons
+    if( src_ind == 0 ){
+      push(xml_out,"MultiMassQprop");
+      write(xml_out, "Staggered_src_tag" , src_ind);
+      write(xml_out, "Masses" , Masses);
+      write(xml_out, "RsdCG", RsdCG);
+      write(xml_out, "Final_RsdCG", resid);
+      write(xml_out, "n_count", n_count);
+      write(xml_out, "time_in_sec",time_in_sec );
+      pop(xml_out);
+    }
+
+    return ncg_had ;
+  }
+
+
 } // end of namespace
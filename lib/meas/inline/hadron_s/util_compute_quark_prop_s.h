@@ -9,10 +9,45 @@
 #define  util_compute_quark_prop_s_h__
 
 #include "chromabase.h"
+#include "handle.h"
+#include "stagtype_fermact_s.h"
 
 enum stag_src_enum { LOCAL_SRC  , FUZZED_SRC , GAUGE_INVAR_LOCAL_SOURCE , 
          NOISY_LOCAL_SOURCE , LOAD_IN_SOURCE } ;
 typedef   stag_src_enum stag_src_type ;
 
+namespace Chroma 
+{
+  //! Staggered quark propagators for several masses at once
+  /*!
+   * All Nc colour sources are solved together with all the masses in one
+   * multi-shift CG on the even-odd normal operator 4m^2 - D_eo D_oe. The
+   * masses enter only as shifts of that operator, and the mass dependent
+   * preconditioned source  2m chi_e - D_eo chi_o  is split in two mass
+   * independent parts, so every operator application serves all the
+   * colours and masses.
+   *
+   * \param quark_props  propagator per mass ( Write )
+   * \param Masses       valence masses ( Read )
+   * \param RsdCG        target residual for every mass ( Read )
+   * \param MaxCG        maximum number of iterations ( Read )
+   * \return total number of iterations over the sources
+   */
+  int compute_quark_propagators_s(multi1d<LatticeStaggeredPropagator> & quark_props,
+				  stag_src_type type_of_src,
+				  bool gauge_shift,
+				  bool sym_shift,
+				  const multi1d<LatticeColorMatrix> & u ,
+				  const EvenOddStaggeredTypeFermAct<LatticeStaggeredFermion,
+				  multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> > & S_f,
+				  Handle< FermState<LatticeStaggeredFermion,
+				  multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> > > state,
+				  XMLWriter & xml_out,
+				  const multi1d<Real> & Masses,
+				  Real RsdCG, int MaxCG,
+				  int j_decay,
+				  int src_ind, int t_source);
+}
+
 
 #endif
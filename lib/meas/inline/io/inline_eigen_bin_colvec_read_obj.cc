@@ -9,6 +9,7 @@
 #include "meas/inline/abs_inline_measurement_factory.h"
 #include "meas/inline/io/inline_eigen_bin_colvec_read_obj.h"
 #include "meas/inline/io/named_objmap.h"
+#include "io/file_prefetch.h"
 
 #include "util/ferm/subset_vectors.h"
 
@@ -36,6 +37,9 @@ namespace Chroma
     push(xml, path);
 
     write(xml, "file_names", input.file_names);
+    write(xml, "readahead", input.readahead);
+    write(xml, "io_threads", input.io_threads);
+    write(xml, "precision", input.precision);
 
     pop(xml);
   }
@@ -58,6 +62,24 @@ namespace Chroma
     XMLReader inputtop(xml, path);
 
     read(inputtop, "file_names", input.file_names);
+
+    input.readahead = 2;
+    if (inputtop.count("readahead") == 1)
+      read(inputtop, "readahead", input.readahead);
+
+    input.io_threads = 2;
+    if (inputtop.count("io_threads") == 1)
+      read(inputtop, "io_threads", input.io_threads);
+
+    input.precision = 0;
+    if (inputtop.count("precision") == 1)
+      read(inputtop, "precision", input.precision);
+
+    if (input.precision != 0 && input.precision != 32 && input.precision != 64)
+    {
+      QDPIO::cerr << __func__ << ": precision must be 32, 64 or 0, found " << input.precision << std::endl;
+      QDP_abort(1);
+    }
   }
 
 
@@ -65,6 +87,23 @@ namespace Chroma
   { 
     namespace
     {
+      //! Read one vector and its weights stored in precision V, R
+      template<typename V, typename R>
+      void readPair(BinaryReader& bin, int Lt, EVPair<LatticeColorVector>& read_pair)
+      {
+	V vec;
+	read(bin, vec);
+	read_pair.eigenVector = vec;
+
+	read_pair.eigenValue.weights.resize(Lt);
+	for(int t=0; t < Lt; ++t)
+	{
+	  R w;
+	  read(bin, w);
+	  read_pair.eigenValue.weights[t] = w;
+	}
+      }
+
       AbsInlineMeasurement* createMeasurement(XMLReader& xml_in, 
 					      const std::string& path) 
       {
@@ -185,22 +224,36 @@ namespace Chroma
 	const int Lt = QDP::Layout::lattSize()[decay_dir];
 
 	// Read the object
+	// The files are read whole on I/O threads, ahead of the one being
+	// converted and scattered here
 	swatch.start();
+
+	FilePrefetcher prefetch(params.file.file_names, 
+				params.file.readahead, 
+				params.file.io_threads);
+
 	for(int i=0; i < params.file.file_names.size(); ++i)
 	{
-	  BinaryFileReader bin(params.file.file_names[i]);
+	  std::string buf;
+	  prefetch.next(buf);
 
-	  EVPair<T> read_pair;
-	  // Read the std::vector
-	  read(bin, read_pair.eigenVector);
+	  BinaryBufferReader bin(buf);
 
-	  // Resize the eigenvalue.weights array
-	  read_pair.eigenValue.weights.resize(Lt);
+	  EVPair<T> read_pair;
 
-	  // Read the weights
-	  for(int t=0; t < Lt; ++t)
+	  // Read the std::vector and the weights
+	  switch (params.file.precision)
 	  {
-	    read(bin, read_pair.eigenValue.weights[t]);
+	  case 32:
+	    readPair<LatticeColorVectorF,RealF>(bin, Lt, read_pair);
+	    break;
+
+	  case 64:
+	    readPair<LatticeColorVectorD,RealD>(bin, Lt, read_pair);
+	    break;
+
+	  default:
+	    readPair<LatticeColorVector,Real>(bin, Lt, read_pair);
 	  }
 
 	  // Insert into new std::map
@@ -38,6 +38,9 @@ namespace Chroma
       struct File_t
       {
 	multi1d<std::string>   file_names;
+	int                    readahead;    /*!< files read ahead of the one being scattered */
+	int                    io_threads;   /*!< threads reading files */
+	int                    precision;    /*!< precision in the files: 32, 64, or 0 for the default */
       } file;
     };
 
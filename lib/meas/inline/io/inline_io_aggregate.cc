@@ -27,8 +27,10 @@
 #include "meas/inline/io/inline_eigen_lime_colvec_read_obj.h"
 #include "meas/inline/io/inline_eigen_bin_lime_colvec_read_obj.h"
 #include "meas/inline/io/inline_read_map_obj_disk.h"
+#include "meas/inline/io/inline_read_map_obj_sharded.h"
 #include "meas/inline/io/inline_copy_map_obj.h"
 #include "meas/inline/io/inline_write_timeslice_map_obj_disk.h"
+#include "meas/inline/io/inline_erase_amg_space.h"
 
 #include "chroma_config.h"
 #ifdef BUILD_QOP_MG
@@ -97,9 +99,13 @@ namespace Chroma
 
 	// MapObjDisk reader
        	success &= InlineReadMapObjDiskEnv::registerAll();
+       	success &= InlineReadMapObjShardedEnv::registerAll();
        	success &= InlineCopyMapObjEnv::registerAll();
        	success &= InlineWriteTimeSliceMapObjDiskEnv::registerAll();
 
+	// Adaptive aggregation multigrid setups
+	success &= InlineEraseAMGSpaceEnv::registerAll();
+
 #ifdef BUILD_QOP_MG
 	success &= InlineEraseMGSpaceEnv::registerAll();
 #endif
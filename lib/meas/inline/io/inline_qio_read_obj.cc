@@ -17,6 +17,7 @@
 #include "util/ferm/key_prop_colorvec.h"
 #include "handle.h"
 #include "actions/ferm/invert/containers.h"
+#include "io/bfp_io.h"
 
 namespace Chroma 
 { 
@@ -423,6 +424,43 @@ namespace Chroma
 	}
 
 
+	//------------------------------------------------------------------------
+	//! Read a block floating point propagator or fermion
+	/*!
+	 * Either exponent sharing is detected from the file, so the BFP and
+	 * BFPSpinColor object types share this reader.
+	 */
+	template<typename T>
+	class QIOReadLatBFP : public QIOReadObject
+	{
+	private:
+	  Params params;
+
+	public:
+	  QIOReadLatBFP(const Params& p) : params(p) {}
+
+	  //! Read and expand the object
+	  void operator()(QDP_serialparallel_t serpar) {
+	    XMLReader file_xml, record_xml;
+
+	    TheNamedObjMap::Instance().create<T>(params.named_obj.object_id);
+	    T& obj = TheNamedObjMap::Instance().getData<T>(params.named_obj.object_id);
+
+	    BFPIO::readBFP(file_xml, record_xml, obj, params.file.file_name, serpar);
+
+	    TheNamedObjMap::Instance().get(params.named_obj.object_id).setFileXML(file_xml);
+	    TheNamedObjMap::Instance().get(params.named_obj.object_id).setRecordXML(record_xml);
+	  }
+	};
+
+	// Call back
+	template<typename T>
+	QIOReadObject* qioReadLatBFP(const Params& p)
+	{
+	  return new QIOReadLatBFP<T>(p);
+	}
+
+
 #if 0
 	// RGE: FOR SOME REASON, QDP CANNOT CAST A DOUBLE TO FLOATING HERE. NEED TO FIX.
 
@@ -822,6 +860,10 @@ namespace Chroma
 									qioReadLatPropF);
 	  success &= TheQIOReadObjectFactory::Instance().registerObject(std::string("LatticePropagatorD"), 
 									qioReadLatPropD);
+	  success &= TheQIOReadObjectFactory::Instance().registerObject(std::string("LatticePropagatorBFP"), 
+									qioReadLatBFP<LatticePropagator>);
+	  success &= TheQIOReadObjectFactory::Instance().registerObject(std::string("LatticePropagatorBFPSpinColor"), 
+									qioReadLatBFP<LatticePropagator>);
 
 	  success &= TheQIOReadObjectFactory::Instance().registerObject(std::string("LatticeStaggeredPropagator"),   
 									qioReadStagLatProp);
@@ -835,6 +877,10 @@ namespace Chroma
 	  
 	  success &= TheQIOReadObjectFactory::Instance().registerObject(std::string("LatticeFermion"), 
 									qioReadLatFerm);
+	  success &= TheQIOReadObjectFactory::Instance().registerObject(std::string("LatticeFermionBFP"), 
+									qioReadLatBFP<LatticeFermion>);
+	  success &= TheQIOReadObjectFactory::Instance().registerObject(std::string("LatticeFermionBFPSpinColor"), 
+									qioReadLatBFP<LatticeFermion>);
 
 //      success &= TheQIOReadObjectFactory::Instance().registerObject(std::string("LatticeFermionF"), 
 //								   qioReadLatFermF);
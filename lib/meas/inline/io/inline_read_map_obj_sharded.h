@@ -0,0 +1,60 @@
+// -*- C++ -*-
+/*! \file
+ * \brief Inline task to open a sharded map object store as a named object
+ */
+
+#ifndef __inline_read_map_obj_sharded_h__
+#define __inline_read_map_obj_sharded_h__
+
+#include "chromabase.h"
+#include "meas/inline/abs_inline_measurement.h"
+
+namespace Chroma 
+{ 
+  /*! \ingroup inlineio */
+  namespace InlineReadMapObjShardedEnv 
+  {
+    bool registerAll();
+
+    //! Parameter structure
+    /*! \ingroup inlineio */
+    struct Params 
+    {
+      Params(XMLReader& xml_in, const std::string& path);
+
+      unsigned int frequency;
+
+      struct File {
+	std::string   file_name;    /*!< directory of the store */
+      } file;
+
+      struct NamedObject_t {
+	std::string   object_type; 
+	std::string   object_id;
+     } named_obj;
+    };
+
+
+    //! Inline opening of a sharded store, read only
+    /*! \ingroup inlineio */
+    class InlineMeas : public AbsInlineMeasurement 
+    {
+    public:
+      ~InlineMeas() {}
+      InlineMeas(const Params& p) : params(p) {}
+
+      unsigned long getFrequency(void) const {return params.frequency;}
+
+      //! Do the reading
+      void operator()(const unsigned long update_no,
+		      XMLWriter& xml_out); 
+
+    private:
+      Params params;
+    };
+
+  }
+
+}
+
+#endif
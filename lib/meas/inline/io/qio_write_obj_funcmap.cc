@@ -13,6 +13,7 @@
 #include "util/ferm/key_prop_colorvec.h"
 #include "handle.h"
 #include "qdp_map_obj_memory.h"
+#include "io/bfp_io.h"
 
 
 #include "actions/ferm/invert/containers.h"
@@ -142,6 +143,24 @@ namespace Chroma
 #endif
 
 
+      //------------------------------------------------------------------------
+      //! Write a propagator or fermion in block floating point
+      /*! The file is only as parallel as volfmt and serpar make it */
+      template<typename T, BFPIO::BFPBlock_t block>
+      void QIOWriteLatBFP(const std::string& buffer_id,
+			  const std::string& file, 
+			  QDP_volfmt_t volfmt, QDP_serialparallel_t serpar)
+      {
+	XMLReader file_xml, record_xml;
+
+	const T& obj = TheNamedObjMap::Instance().getData<T>(buffer_id);
+	TheNamedObjMap::Instance().get(buffer_id).getFileXML(file_xml);
+	TheNamedObjMap::Instance().get(buffer_id).getRecordXML(record_xml);
+
+	BFPIO::writeBFP(file_xml, record_xml, obj, file, block, volfmt, serpar);
+      }
+
+
       //------------------------------------------------------------------------
       //! Write a propagator
       void QIOWriteLatStagProp(const std::string& buffer_id,
@@ -515,11 +534,19 @@ namespace Chroma
 								      QIOWriteLatPropF);
 	success &= TheQIOWriteObjFuncMap::Instance().registerFunction(std::string("LatticePropagatorD"), 
 								      QIOWriteLatPropD);
+	success &= TheQIOWriteObjFuncMap::Instance().registerFunction(std::string("LatticePropagatorBFP"), 
+								      QIOWriteLatBFP<LatticePropagator, BFPIO::BFP_SITE>);
+	success &= TheQIOWriteObjFuncMap::Instance().registerFunction(std::string("LatticePropagatorBFPSpinColor"), 
+								      QIOWriteLatBFP<LatticePropagator, BFPIO::BFP_SPIN_COLOR>);
 
 	success &= TheQIOWriteObjFuncMap::Instance().registerFunction(std::string("LatticeFermion"), 
 								      QIOWriteLatFerm<LatticeFermion>);
 	success &= TheQIOWriteObjFuncMap::Instance().registerFunction(std::string("LatticeStaggeredFermion"),
                                                                       QIOWriteLatFerm<LatticeStaggeredFermion>);
+	success &= TheQIOWriteObjFuncMap::Instance().registerFunction(std::string("LatticeFermionBFP"), 
+								      QIOWriteLatBFP<LatticeFermion, BFPIO::BFP_SITE>);
+	success &= TheQIOWriteObjFuncMap::Instance().registerFunction(std::string("LatticeFermionBFPSpinColor"), 
+								      QIOWriteLatBFP<LatticeFermion, BFPIO::BFP_SPIN_COLOR>);
 
 //      success &= TheQIOWriteObjFuncMap::Instance().registerFunction(std::string("LatticeFermionF"), 
 //								    QIOWriteLatFermF);
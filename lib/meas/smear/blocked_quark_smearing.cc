@@ -0,0 +1,181 @@
+/*! \file
+ *  \brief Temporally blocked Gaussian/Jacobi smearing of color std::vector and propagator
+ */
+
+#include "chromabase.h"
+
+#include "meas/smear/quark_smearing_factory.h"
+#include "meas/smear/blocked_quark_smearing.h"
+#include "meas/smear/blocked_smear.h"
+
+namespace Chroma
+{
+
+  // Read parameters
+  void read(XMLReader& xml, const std::string& path, BlockedQuarkSmearingEnv::Params& param)
+  {
+    BlockedQuarkSmearingEnv::Params tmp(xml, path);
+    param = tmp;
+  }
+
+  //! Parameters for running code
+  void write(XMLWriter& xml, const std::string& path, const BlockedQuarkSmearingEnv::Params& param)
+  {
+    param.writeXML(xml, path);
+  }
+
+
+  //! Hooks to register the class
+  namespace BlockedQuarkSmearingEnv
+  {
+    namespace
+    {
+      //! Callback function
+      QuarkSmearing<LatticePropagator>* createProp(XMLReader& xml_in,
+						   const std::string& path)
+      {
+	return new QuarkSmear<LatticePropagator>(Params(xml_in, path));
+      }
+
+      //! Callback function
+      QuarkSmearing<LatticeStaggeredPropagator>* createStagProp(XMLReader& xml_in,
+								const std::string& path)
+      {
+	return new QuarkSmear<LatticeStaggeredPropagator>(Params(xml_in, path));
+      }
+
+      //! Callback function
+      QuarkSmearing<LatticeFermion>* createFerm(XMLReader& xml_in,
+						const std::string& path)
+      {
+	return new QuarkSmear<LatticeFermion>(Params(xml_in, path));
+      }
+
+      //! Callback function
+      QuarkSmearing<LatticeColorVector>* createColorVec(XMLReader& xml_in,
+							const std::string& path)
+      {
+	return new QuarkSmear<LatticeColorVector>(Params(xml_in, path));
+      }
+
+      //! Local registration flag
+      bool registered = false;
+
+      //! Name to be used
+      const std::string name = "GAUGE_INV_BLOCKED";
+
+
+      //! Smear with the requested kernel
+      template<typename T>
+      void smear(const Params& params, T& quark, const multi1d<LatticeColorMatrix>& u)
+      {
+	if (params.smear_type == "GAUSSIAN")
+	  blockedGausSmear(u, quark, params.wvf_param, params.wvfIntPar, params.no_smear_dir,
+			   params.block_iter, params.tile_size);
+	else
+	  blockedJacobiSmear(u, quark, params.wvf_param, params.wvfIntPar, params.no_smear_dir,
+			     params.block_iter, params.tile_size);
+      }
+    }
+
+    //! Return the name
+    std::string getName() {return name;}
+
+    //! Register all the factories
+    bool registerAll()
+    {
+      bool success = true;
+      if (! registered)
+      {
+	success &= Chroma::ThePropSmearingFactory::Instance().registerObject(name, createProp);
+	success &= Chroma::TheStagPropSmearingFactory::Instance().registerObject(name, createStagProp);
+	success &= Chroma::TheFermSmearingFactory::Instance().registerObject(name, createFerm);
+	success &= Chroma::TheColorVecSmearingFactory::Instance().registerObject(name, createColorVec);
+	registered = true;
+      }
+      return success;
+    }
+
+
+    //! Parameters for running code
+    Params::Params(XMLReader& xml, const std::string& path)
+    {
+      XMLReader paramtop(xml, path);
+
+      read(paramtop, "smear_type", smear_type);
+      read(paramtop, "wvf_param", wvf_param);
+      read(paramtop, "wvfIntPar", wvfIntPar);
+      read(paramtop, "no_smear_dir", no_smear_dir);
+
+      block_iter = 4;
+      if (paramtop.count("block_iter") > 0)
+	read(paramtop, "block_iter", block_iter);
+
+      tile_size = 8;
+      if (paramtop.count("tile_size") > 0)
+	read(paramtop, "tile_size", tile_size);
+
+      if (smear_type != "GAUSSIAN" && smear_type != "JACOBI")
+      {
+	QDPIO::cerr << name << ": unknown smear_type = " << smear_type
+		    << ", expected GAUSSIAN or JACOBI" << std::endl;
+	QDP_abort(1);
+      }
+    }
+
+
+    //! Parameters for running code
+    void Params::writeXML(XMLWriter& xml, const std::string& path) const
+    {
+      push(xml, path);
+
+      write(xml, "wvf_kind", BlockedQuarkSmearingEnv::getName());
+      write(xml, "smear_type", smear_type);
+      write(xml, "wvf_param", wvf_param);
+      write(xml, "wvfIntPar", wvfIntPar);
+      write(xml, "no_smear_dir", no_smear_dir);
+      write(xml, "block_iter", block_iter);
+      write(xml, "tile_size", tile_size);
+
+      pop(xml);
+    }
+
+
+    //! Smear the quark
+    template<>
+    void
+    QuarkSmear<LatticePropagator>::operator()(LatticePropagator& quark,
+					      const multi1d<LatticeColorMatrix>& u) const
+    {
+      smear(params, quark, u);
+    }
+
+    //! Smear the quark
+    template<>
+    void
+    QuarkSmear<LatticeStaggeredPropagator>::operator()(LatticeStaggeredPropagator& quark,
+						       const multi1d<LatticeColorMatrix>& u) const
+    {
+      smear(params, quark, u);
+    }
+
+    //! Smear the quark
+    template<>
+    void
+    QuarkSmear<LatticeFermion>::operator()(LatticeFermion& quark,
+					   const multi1d<LatticeColorMatrix>& u) const
+    {
+      smear(params, quark, u);
+    }
+
+    //! Smear the color-std::vector
+    template<>
+    void
+    QuarkSmear<LatticeColorVector>::operator()(LatticeColorVector& quark,
+					       const multi1d<LatticeColorMatrix>& u) const
+    {
+      smear(params, quark, u);
+    }
+
+  }  // end namespace
+}  // end namespace Chroma
@@ -0,0 +1,75 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Temporally blocked Gaussian/Jacobi smearing of color std::vector and propagator
+ */
+
+#ifndef __blocked_quark_smearing_h__
+#define __blocked_quark_smearing_h__
+
+#include "meas/smear/quark_smearing.h"
+
+namespace Chroma
+{
+  //! Name and registration
+  /*! @ingroup smear */
+  namespace BlockedQuarkSmearingEnv
+  {
+    bool registerAll();
+
+    //! Return the name
+    std::string getName();
+
+    //! Params for temporally blocked quark smearing
+    /*! @ingroup smear */
+    struct Params
+    {
+      Params() {}
+      Params(XMLReader& in, const std::string& path);
+      void writeXML(XMLWriter& in, const std::string& path) const;
+
+      std::string smear_type;           /*!< GAUSSIAN or JACOBI */
+      Real wvf_param;                   /*!< Smearing width (GAUSSIAN) or hopping parameter (JACOBI) */
+      int  wvfIntPar;                   /*!< Number of smearing hits */
+      int  no_smear_dir;		/*!< No smearing in this direction */
+      int  block_iter;                  /*!< Iterations per memory pass */
+      int  tile_size;                   /*!< Tile edge in each smeared direction */
+    };
+
+
+    //! Temporally blocked quark smearing
+    /*! @ingroup smear
+     *
+     * Gaussian or Jacobi quark smearing with several iterations
+     * applied per pass over the field
+     */
+    template<typename T>
+    class QuarkSmear : public QuarkSmearing<T>
+    {
+    public:
+      //! Full constructor
+      QuarkSmear(const Params& p) : params(p) {}
+
+      //! Smear the quark
+      void operator()(T& quark, const multi1d<LatticeColorMatrix>& u) const;
+
+    private:
+      //! Hide partial constructor
+      QuarkSmear() {}
+
+    private:
+      Params  params;   /*!< smearing params */
+    };
+
+  }  // end namespace
+
+  //! Reader
+  /*! @ingroup smear */
+  void read(XMLReader& xml, const std::string& path, BlockedQuarkSmearingEnv::Params& param);
+
+  //! Writer
+  /*! @ingroup smear */
+  void write(XMLWriter& xml, const std::string& path, const BlockedQuarkSmearingEnv::Params& param);
+
+}  // end namespace Chroma
+
+#endif
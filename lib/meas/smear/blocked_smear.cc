@@ -0,0 +1,437 @@
+/*! \file
+ *  \brief Temporally blocked Gaussian and Jacobi smearing
+ *
+ *  Both smearings are iterations of the form
+ *
+ *    chi_{n+1} = alpha * chi_0 + beta * chi_n + gamma * H chi_n
+ *
+ *  where H is the covariant hopping term in the smeared directions.
+ *  The lattice is cut into tiles within each time slice. Each tile is
+ *  loaded together with a halo of width block_iter, and block_iter
+ *  iterations are applied on the tile in a thread-private buffer before
+ *  the interior is written back. The field therefore streams through
+ *  memory once every block_iter iterations instead of once per iteration,
+ *  and each link is applied to all spin and colour columns of the site
+ *  at once.
+ *
+ *  The tiles wrap periodically within the node, so this kernel requires
+ *  every smeared direction to be local to the node. Otherwise, and under
+ *  QDP-JIT, it falls back to the standard whole-lattice implementations.
+ *  There is no halo exchange between nodes. Each call logs which path
+ *  it took.
+ */
+
+#include "chromabase.h"
+#include "meas/smear/blocked_smear.h"
+#include "meas/smear/gaus_smear.h"
+#include "meas/smear/jacobi_smear.h"
+
+#include <vector>
+#include <algorithm>
+
+namespace Chroma
+{
+
+  namespace BlockedSmearEnv
+  {
+    namespace
+    {
+      //! Local geometry of the node sub-lattice and its tiling
+      struct Geometry
+      {
+	Geometry(int no_smear_dir, int tile_, int halo_);
+
+	int           ns;         /*!< number of smeared directions */
+	multi1d<int>  dirs;       /*!< the smeared directions */
+	multi1d<int>  L;          /*!< node sub-lattice extents */
+	multi1d<int>  lex_stride; /*!< strides of the node lexicographic index */
+	std::vector<int> site;    /*!< node lexicographic index -> QDP site index */
+
+	int           tile;       /*!< tile edge */
+	int           halo;       /*!< halo width */
+	int           edge;       /*!< box edge = tile + 2*halo */
+	int           box_vol;    /*!< sites in the halo-extended box */
+	multi1d<int>  box_stride; /*!< strides within the box */
+	std::vector<int> dist;    /*!< distance of each box site to the box boundary */
+
+	multi1d<int>  ntile;      /*!< tiles per smeared direction */
+	int           tiles_per_slice;
+	int           t_dir;      /*!< unsmeared direction, or -1 */
+	int           num_tiles;  /*!< total tiles on the node */
+      };
+
+
+      Geometry::Geometry(int no_smear_dir, int tile_, int halo_) : tile(tile_), halo(halo_)
+      {
+	L = Layout::subgridLattSize();
+
+	t_dir = (no_smear_dir >= 0 && no_smear_dir < Nd) ? no_smear_dir : -1;
+	ns = (t_dir < 0) ? Nd : Nd-1;
+
+	dirs.resize(ns);
+	for(int mu=0, k=0; mu < Nd; ++mu)
+	  if (mu != t_dir)
+	    dirs[k++] = mu;
+
+	// Node lexicographic index -> QDP site index
+	lex_stride.resize(Nd);
+	int vol = 1;
+	for(int mu=0; mu < Nd; ++mu)
+	{
+	  lex_stride[mu] = vol;
+	  vol *= L[mu];
+	}
+
+	site.resize(vol);
+	for(int s=0; s < Layout::sitesOnNode(); ++s)
+	{
+	  multi1d<int> coord = Layout::siteCoords(Layout::nodeNumber(), s);
+	  int lex = 0;
+	  for(int mu=0; mu < Nd; ++mu)
+	    lex += (coord[mu] % L[mu]) * lex_stride[mu];
+
+	  site[lex] = s;
+	}
+
+	// The halo-extended box
+	edge = tile + 2*halo;
+	box_stride.resize(ns);
+	box_vol = 1;
+	for(int k=0; k < ns; ++k)
+	{
+	  box_stride[k] = box_vol;
+	  box_vol *= edge;
+	}
+
+	dist.resize(box_vol);
+	for(int b=0; b < box_vol; ++b)
+	{
+	  int d = edge;
+	  for(int k=0; k < ns; ++k)
+	  {
+	    int i = (b / box_stride[k]) % edge;
+	    d = std::min(d, std::min(i, edge-1-i));
+	  }
+	  dist[b] = d;
+	}
+
+	// Tiles
+	ntile.resize(ns);
+	tiles_per_slice = 1;
+	for(int k=0; k < ns; ++k)
+	{
+	  ntile[k] = (L[dirs[k]] + tile - 1) / tile;
+	  tiles_per_slice *= ntile[k];
+	}
+
+	num_tiles = tiles_per_slice * ((t_dir < 0) ? 1 : L[t_dir]);
+      }
+
+
+      //! Why the blocked kernel cannot be used on this layout, or 0 if it can
+      const char* fallbackReason(int no_smear_dir)
+      {
+#ifndef QDP_IS_QDPJIT
+	const multi1d<int>& nodes = Layout::logicalSize();
+	for(int mu=0; mu < Nd; ++mu)
+	  if (mu != no_smear_dir && nodes[mu] != 1)
+	    return "smeared directions are split across nodes";
+
+	return 0;
+#else
+	return "no raw site access with QDP-JIT";
+#endif
+      }
+
+
+      //! Arguments for the tile loop
+      template<typename T, typename C>
+      struct TileArgs
+      {
+	const Geometry&               geom;
+	const multi1d< OLattice<C> >& u;
+	const OLattice<T>&            src;
+	const OLattice<T>&            chi;
+	OLattice<T>&                  out;
+	const Real&                   alpha;
+	const Real&                   beta;
+	const Real&                   gamma;
+	bool                          use_src;
+	int                           niter;
+      };
+
+
+      //! Apply niter iterations on tiles [lo,hi)
+      template<typename T, typename C>
+      void tileLoop(int lo, int hi, int myId, TileArgs<T,C>* arg)
+      {
+#ifndef QDP_IS_QDPJIT
+	const Geometry& g = arg->geom;
+	const int V  = g.box_vol;
+	const int ns = g.ns;
+
+	// Thread private buffers, reused for all tiles of this thread
+	std::vector<T>   buf0(V), buf1(V), sbuf;
+	std::vector<C>   links(ns*V);
+	std::vector<int> box_site(V);
+	std::vector<bool> write_back(V);
+
+	if (arg->use_src)
+	  sbuf.resize(V);
+
+	multi1d<int> org(ns);
+
+	for(int tile_id=lo; tile_id < hi; ++tile_id)
+	{
+	  // Locate the tile
+	  int rem = tile_id % g.tiles_per_slice;
+	  int t   = tile_id / g.tiles_per_slice;
+	  for(int k=0; k < ns; ++k)
+	  {
+	    org[k] = (rem % g.ntile[k]) * g.tile;
+	    rem /= g.ntile[k];
+	  }
+
+	  // Gather the halo-extended box
+	  for(int b=0; b < V; ++b)
+	  {
+	    int lex = (g.t_dir < 0) ? 0 : t * g.lex_stride[g.t_dir];
+	    bool inside = true;
+
+	    for(int k=0; k < ns; ++k)
+	    {
+	      int mu = g.dirs[k];
+	      int i  = (b / g.box_stride[k]) % g.edge;
+	      int xi = org[k] + i - g.halo;
+
+	      // Only the tile interior inside the sub-lattice is written back
+	      if (i < g.halo || i >= g.halo + g.tile || xi >= g.L[mu])
+		inside = false;
+
+	      xi = ((xi % g.L[mu]) + g.L[mu]) % g.L[mu];
+	      lex += xi * g.lex_stride[mu];
+	    }
+
+	    int s = g.site[lex];
+	    box_site[b]   = s;
+	    write_back[b] = inside;
+
+	    buf0[b] = arg->chi.elem(s);
+	    if (arg->use_src)
+	      sbuf[b] = arg->src.elem(s);
+
+	    for(int k=0; k < ns; ++k)
+	      links[k*V+b] = arg->u[g.dirs[k]].elem(s);
+	  }
+
+	  // Iterate on the box. After iteration j the sites at distance >= j
+	  // from the box boundary are exact.
+	  std::vector<T>* in  = &buf0;
+	  std::vector<T>* res = &buf1;
+
+	  for(int j=1; j <= arg->niter; ++j)
+	  {
+	    for(int b=0; b < V; ++b)
+	    {
+	      if (g.dist[b] < j)
+		continue;
+
+	      T hop;
+	      zero_rep(hop);
+
+	      for(int k=0; k < ns; ++k)
+	      {
+		int bf = b + g.box_stride[k];
+		int bb = b - g.box_stride[k];
+
+		hop += links[k*V+b] * (*in)[bf];
+		hop += adj(links[k*V+bb]) * (*in)[bb];
+	      }
+
+	      T& r = (*res)[b];
+	      r  = (*in)[b] * arg->beta.elem();
+	      r += hop * arg->gamma.elem();
+	      if (arg->use_src)
+		r += sbuf[b] * arg->alpha.elem();
+	    }
+
+	    std::swap(in, res);
+	  }
+
+	  // Scatter the interior
+	  for(int b=0; b < V; ++b)
+	    if (write_back[b])
+	      arg->out.elem(box_site[b]) = (*in)[b];
+	}
+#endif
+      }
+
+
+      //! Blocked smearing driver
+      /*!
+       * chi_{n+1} = alpha * chi_0 + beta * chi_n + gamma * H chi_n
+       */
+      template<typename T, typename C>
+      void blockedSmear(const multi1d< OLattice<C> >& u,
+			OLattice<T>& chi,
+			const Real& alpha, const Real& beta, const Real& gamma,
+			bool use_src, int iter, int no_smear_dir,
+			int block_iter, int tile_size)
+      {
+	START_CODE();
+
+	if (block_iter < 1 || tile_size < 1)
+	{
+	  QDPIO::cerr << __func__ << ": invalid block_iter = " << block_iter
+		      << "  tile_size = " << tile_size << std::endl;
+	  QDP_abort(1);
+	}
+
+	Geometry geom(no_smear_dir, tile_size, block_iter);
+
+	OLattice<T> src;
+	if (use_src)
+	  src = chi;
+
+	OLattice<T> out;
+
+	for(int n=0; n < iter; n += block_iter)
+	{
+	  int niter = std::min(block_iter, iter - n);
+
+	  TileArgs<T,C> args = {geom, u, src, chi, out, alpha, beta, gamma, use_src, niter};
+	  dispatch_to_threads(geom.num_tiles, args, tileLoop<T,C>);
+
+	  chi = out;
+	}
+
+	END_CODE();
+      }
+
+    } // end anonymous namespace
+
+
+    //! Gaussian smearing
+    template<typename T>
+    void gaus(const multi1d<LatticeColorMatrix>& u,
+	      T& chi,
+	      const Real& width, int ItrGaus, int j_decay,
+	      int block_iter, int tile_size)
+    {
+      const char* reason = fallbackReason(j_decay);
+      if (reason)
+      {
+	QDPIO::cout << "blockedGausSmear: " << reason << ", using gausSmear" << std::endl;
+	gausSmear(u, chi, width, ItrGaus, j_decay);
+	return;
+      }
+
+      QDPIO::cout << "blockedGausSmear: blocked kernel, block_iter= " << block_iter
+		  << "  tile_size= " << tile_size << std::endl;
+
+      // One gausSmear iteration is  chi <- (1 + 2*nd*ftmp)*chi - ftmp * H chi
+      Real ftmp = - (width*width) / Real(4*ItrGaus);
+      int  nd   = (j_decay < Nd) ? Nd-1 : Nd;
+
+      Real alpha = zero;
+      Real beta  = Real(1) + Real(2*nd)*ftmp;
+      Real gamma = -ftmp;
+
+      blockedSmear(u, chi, alpha, beta, gamma, false, ItrGaus, j_decay, block_iter, tile_size);
+    }
+
+
+    //! Jacobi smearing
+    template<typename T>
+    void jacobi(const multi1d<LatticeColorMatrix>& u,
+		T& chi,
+		const Real& kappa, int iter, int no_smear_dir,
+		int block_iter, int tile_size)
+    {
+      const char* reason = fallbackReason(no_smear_dir);
+      if (reason)
+      {
+	QDPIO::cout << "blockedJacobiSmear: " << reason << ", using jacobiSmear" << std::endl;
+	jacobiSmear(u, chi, kappa, iter, no_smear_dir);
+	return;
+      }
+
+      QDPIO::cout << "blockedJacobiSmear: blocked kernel, block_iter= " << block_iter
+		  << "  tile_size= " << tile_size << std::endl;
+
+      // One jacobiSmear iteration is  chi <- chi_0 + kappa * H chi
+      Real alpha = Real(1);
+      Real beta  = zero;
+
+      blockedSmear(u, chi, alpha, beta, kappa, true, iter, no_smear_dir, block_iter, tile_size);
+    }
+
+  } // end namespace BlockedSmearEnv
+
+
+  void blockedGausSmear(const multi1d<LatticeColorMatrix>& u,
+			LatticeColorVector& chi,
+			const Real& width, int ItrGaus, int j_decay,
+			int block_iter, int tile_size)
+  {
+    BlockedSmearEnv::gaus(u, chi, width, ItrGaus, j_decay, block_iter, tile_size);
+  }
+
+  void blockedGausSmear(const multi1d<LatticeColorMatrix>& u,
+			LatticeFermion& chi,
+			const Real& width, int ItrGaus, int j_decay,
+			int block_iter, int tile_size)
+  {
+    BlockedSmearEnv::gaus(u, chi, width, ItrGaus, j_decay, block_iter, tile_size);
+  }
+
+  void blockedGausSmear(const multi1d<LatticeColorMatrix>& u,
+			LatticeStaggeredPropagator& chi,
+			const Real& width, int ItrGaus, int j_decay,
+			int block_iter, int tile_size)
+  {
+    BlockedSmearEnv::gaus(u, chi, width, ItrGaus, j_decay, block_iter, tile_size);
+  }
+
+  void blockedGausSmear(const multi1d<LatticeColorMatrix>& u,
+			LatticePropagator& chi,
+			const Real& width, int ItrGaus, int j_decay,
+			int block_iter, int tile_size)
+  {
+    BlockedSmearEnv::gaus(u, chi, width, ItrGaus, j_decay, block_iter, tile_size);
+  }
+
+
+  void blockedJacobiSmear(const multi1d<LatticeColorMatrix>& u,
+			  LatticeColorVector& chi,
+			  const Real& kappa, int iter, int no_smear_dir,
+			  int block_iter, int tile_size)
+  {
+    BlockedSmearEnv::jacobi(u, chi, kappa, iter, no_smear_dir, block_iter, tile_size);
+  }
+
+  void blockedJacobiSmear(const multi1d<LatticeColorMatrix>& u,
+			  LatticeFermion& chi,
+			  const Real& kappa, int iter, int no_smear_dir,
+			  int block_iter, int tile_size)
+  {
+    BlockedSmearEnv::jacobi(u, chi, kappa, iter, no_smear_dir, block_iter, tile_size);
+  }
+
+  void blockedJacobiSmear(const multi1d<LatticeColorMatrix>& u,
+			  LatticeStaggeredPropagator& chi,
+			  const Real& kappa, int iter, int no_smear_dir,
+			  int block_iter, int tile_size)
+  {
+    BlockedSmearEnv::jacobi(u, chi, kappa, iter, no_smear_dir, block_iter, tile_size);
+  }
+
+  void blockedJacobiSmear(const multi1d<LatticeColorMatrix>& u,
+			  LatticePropagator& chi,
+			  const Real& kappa, int iter, int no_smear_dir,
+			  int block_iter, int tile_size)
+  {
+    BlockedSmearEnv::jacobi(u, chi, kappa, iter, no_smear_dir, block_iter, tile_size);
+  }
+
+}  // end namespace Chroma
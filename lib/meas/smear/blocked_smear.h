@@ -0,0 +1,101 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Temporally blocked Gaussian and Jacobi smearing
+ */
+
+#ifndef __blocked_smear_h__
+#define __blocked_smear_h__
+
+namespace Chroma
+{
+
+  //! Do a covariant Gaussian smearing of a lattice color std::vector field
+  /*!
+   * \ingroup smear
+   *
+   * Same result as gausSmear, but several iterations are applied per memory
+   * pass on halo-extended tiles of each time slice.
+   *
+   * Arguments:
+   *
+   *  \param u           gauge field ( Read )
+   *  \param chi         color std::vector field ( Modify )
+   *  \param width       width of "shell" wave function ( Read )
+   *  \param ItrGaus     number of iterations to approximate Gaussian ( Read )
+   *  \param j_decay     direction of decay ( Read )
+   *  \param block_iter  iterations per memory pass ( Read )
+   *  \param tile_size   tile edge in each smeared direction ( Read )
+   */
+  void blockedGausSmear(const multi1d<LatticeColorMatrix>& u,
+			LatticeColorVector& chi,
+			const Real& width, int ItrGaus, int j_decay,
+			int block_iter, int tile_size);
+
+  //! Do a covariant Gaussian smearing of a lattice fermion field
+  /*! \ingroup smear */
+  void blockedGausSmear(const multi1d<LatticeColorMatrix>& u,
+			LatticeFermion& chi,
+			const Real& width, int ItrGaus, int j_decay,
+			int block_iter, int tile_size);
+
+  //! Do a covariant Gaussian smearing of a lattice staggered propagator field
+  /*! \ingroup smear */
+  void blockedGausSmear(const multi1d<LatticeColorMatrix>& u,
+			LatticeStaggeredPropagator& chi,
+			const Real& width, int ItrGaus, int j_decay,
+			int block_iter, int tile_size);
+
+  //! Do a covariant Gaussian smearing of a lattice propagator field
+  /*! \ingroup smear */
+  void blockedGausSmear(const multi1d<LatticeColorMatrix>& u,
+			LatticePropagator& chi,
+			const Real& width, int ItrGaus, int j_decay,
+			int block_iter, int tile_size);
+
+
+  //! Do a covariant Jacobi smearing of a lattice color std::vector field
+  /*!
+   * \ingroup smear
+   *
+   * Same result as jacobiSmear, but several iterations are applied per memory
+   * pass on halo-extended tiles of each time slice.
+   *
+   * Arguments:
+   *
+   *  \param u             gauge field ( Read )
+   *  \param chi           color std::vector field ( Modify )
+   *  \param kappa         hopping parameter ( Read )
+   *  \param iter          number of iterations ( Read )
+   *  \param no_smear_dir  no smearing in this direction ( Read )
+   *  \param block_iter    iterations per memory pass ( Read )
+   *  \param tile_size     tile edge in each smeared direction ( Read )
+   */
+  void blockedJacobiSmear(const multi1d<LatticeColorMatrix>& u,
+			  LatticeColorVector& chi,
+			  const Real& kappa, int iter, int no_smear_dir,
+			  int block_iter, int tile_size);
+
+  //! Do a covariant Jacobi smearing of a lattice fermion field
+  /*! \ingroup smear */
+  void blockedJacobiSmear(const multi1d<LatticeColorMatrix>& u,
+			  LatticeFermion& chi,
+			  const Real& kappa, int iter, int no_smear_dir,
+			  int block_iter, int tile_size);
+
+  //! Do a covariant Jacobi smearing of a lattice staggered propagator field
+  /*! \ingroup smear */
+  void blockedJacobiSmear(const multi1d<LatticeColorMatrix>& u,
+			  LatticeStaggeredPropagator& chi,
+			  const Real& kappa, int iter, int no_smear_dir,
+			  int block_iter, int tile_size);
+
+  //! Do a covariant Jacobi smearing of a lattice propagator field
+  /*! \ingroup smear */
+  void blockedJacobiSmear(const multi1d<LatticeColorMatrix>& u,
+			  LatticePropagator& chi,
+			  const Real& kappa, int iter, int no_smear_dir,
+			  int block_iter, int tile_size);
+
+}  // end namespace Chroma
+
+#endif
@@ -102,6 +102,10 @@ namespace Chroma
       read(paramtop, "alpha1", alpha1);
       read(paramtop, "alpha2", alpha2);
       read(paramtop, "alpha3", alpha3);
+
+      BatchedProject = false;
+      if (paramtop.count("BatchedProject") != 0)
+	read(paramtop, "BatchedProject", BatchedProject);
     }
 
 
@@ -122,6 +126,8 @@ namespace Chroma
       write(xml, "no_smear_dir", num_smear);
       write(xml, "BlkMax", BlkMax);
       write(xml, "BlkAccu", BlkAccu);
+      if (BatchedProject)
+	write(xml, "BatchedProject", BatchedProject);
 
       pop(xml);
     }
@@ -143,11 +149,12 @@ namespace Chroma
 	  if (params.no_smear_dir < 0 || params.no_smear_dir >= Nd)
 	    Hyp_Smear(u, u_hyp, 
 		      params.alpha1, params.alpha2, params.alpha3, 
-		      params.BlkAccu, params.BlkMax);
+		      params.BlkAccu, params.BlkMax, params.BatchedProject);
 	  else
 	    Hyp_Smear3d(u, u_hyp, 
 			params.alpha1, params.alpha2, params.alpha3, 
-			params.BlkAccu, params.BlkMax, params.no_smear_dir);
+			params.BlkAccu, params.BlkMax, params.no_smear_dir,
+			params.BatchedProject);
 
 	  u = u_hyp;
 	}
@@ -23,7 +23,7 @@ namespace Chroma
     /*! @ingroup smear */
     struct Params
     {
-      Params() {}
+      Params() : BatchedProject(false) {}
       Params(XMLReader& in, const std::string& path);
       void writeXML(XMLWriter& in, const std::string& path) const;
     
@@ -34,6 +34,7 @@ namespace Chroma
       int no_smear_dir;			/*!< Direction to not smear */
       int BlkMax;                       /*!< Max number of iterations */
       Real BlkAccu;                     /*!< Relative error to maximize trace */
+      bool BatchedProject;              /*!< Converge the projection per site */
     };
 
 
@@ -6,9 +6,23 @@
 #include "chromabase.h"
 #include "meas/smear/hyp_smear.h"
 #include "util/gauge/sun_proj.h"
+#include "util/gauge/su3_batch.h"
 
 namespace Chroma 
 { 
+  namespace
+  {
+    //! Project onto SU(Nc), with sun_proj or converged per site
+    inline void project(const LatticeColorMatrix& w, LatticeColorMatrix& v,
+			const Real& BlkAccu, int BlkMax, bool batched)
+    {
+      if (batched)
+	SU3Batch::maxTraceProject(w, v, BlkAccu, BlkMax);
+      else
+	sun_proj(w, v, BlkAccu, BlkMax);
+    }
+  }
+
   //! Construct the "hyp-smeared" links of Anna Hasenfratz
   /*!
    * \ingroup smear
@@ -25,12 +39,13 @@ namespace Chroma
    *  \param alpha3	staple coefficient "3" (Read)
    *  \param BlkAccu	accuracy in SU(Nc) projection (Read)
    *  \param BlkMax	max number of iterations in SU(Nc) projection (Read)
+   *  \param batched	project each site to its own accuracy (Read)
    */
 
   void Hyp_Smear(const multi1d<LatticeColorMatrix>& u,
 		 multi1d<LatticeColorMatrix>& u_hyp,
 		 const Real& alpha1, const Real& alpha2, const Real& alpha3,
-		 const Real& BlkAccu, int BlkMax)
+		 const Real& BlkAccu, int BlkMax, bool batched)
   {
     multi1d<LatticeColorMatrix> u_lv1(Nd*(Nd-1));
     multi1d<LatticeColorMatrix> u_lv2(Nd*(Nd-1));
@@ -91,12 +106,12 @@ namespace Chroma
 	if (Nd == 2)
 	{
 	  u_hyp[mu] = u[mu];
-	  sun_proj(u_tmp, u_hyp[mu], BlkAccu, BlkMax);
+	  project(u_tmp, u_hyp[mu], BlkAccu, BlkMax, batched);
 	}
 	else
 	{
 	  u_lv1[ii] = u[mu];
-	  sun_proj(u_tmp, u_lv1[ii], BlkAccu, BlkMax);
+	  project(u_tmp, u_lv1[ii], BlkAccu, BlkMax, batched);
 	}
       }
     }
@@ -153,7 +168,7 @@ namespace Chroma
 	 * Project onto SU(Nc)
 	 */
 	u_hyp[mu] = u[mu];
-	sun_proj(u_tmp, u_hyp[mu], BlkAccu, BlkMax);
+	project(u_tmp, u_hyp[mu], BlkAccu, BlkMax, batched);
       }
     }
     else if (Nd == 4)
@@ -214,7 +229,7 @@ namespace Chroma
 	   * Project onto SU(Nc)
 	   */
 	  u_lv2[ii] = u[mu];
-	  sun_proj(u_tmp, u_lv2[ii], BlkAccu, BlkMax);
+	  project(u_tmp, u_lv2[ii], BlkAccu, BlkMax, batched);
 	}
       }
 
@@ -263,7 +278,7 @@ namespace Chroma
 	 * Project onto SU(Nc)
 	 */
 	u_hyp[mu] = u[mu];
-	sun_proj(u_tmp, u_hyp[mu], BlkAccu, BlkMax);
+	project(u_tmp, u_hyp[mu], BlkAccu, BlkMax, batched);
       }
     }
 
@@ -6,9 +6,23 @@
 #include "chromabase.h"
 #include "meas/smear/hyp_smear3d.h"
 #include "util/gauge/sun_proj.h"
+#include "util/gauge/su3_batch.h"
 
 namespace Chroma 
 { 
+  namespace
+  {
+    //! Project onto SU(Nc), with sun_proj or converged per site
+    inline void project(const LatticeColorMatrix& w, LatticeColorMatrix& v,
+			const Real& BlkAccu, int BlkMax, bool batched)
+    {
+      if (batched)
+	SU3Batch::maxTraceProject(w, v, BlkAccu, BlkMax);
+      else
+	sun_proj(w, v, BlkAccu, BlkMax);
+    }
+  }
+
   //! Construct the "hyp-smeared" links of Anna Hasenfratz involving only the spatial links
   /*!
    * \ingroup smear
@@ -26,12 +40,13 @@ namespace Chroma
    *  \param BlkAccu	accuracy in SU(Nc) projection (Read)
    *  \param BlkMax	max number of iterations in SU(Nc) projection (Read)
    *  \param j_decay	direction of no staple(Read)
+   *  \param batched	project each site to its own accuracy (Read)
    */
 
   void Hyp_Smear3d(const multi1d<LatticeColorMatrix>& u,
 		   multi1d<LatticeColorMatrix>& u_hyp,
 		   const Real& alpha1, const Real& alpha2, const Real& alpha3,
-		   const Real& BlkAccu, int BlkMax,int j_decay)
+		   const Real& BlkAccu, int BlkMax,int j_decay, bool batched)
   {
     multi1d<LatticeColorMatrix> u_lv1((Nd-1)*(Nd-2));
     LatticeColorMatrix u_tmp;
@@ -88,7 +103,7 @@ namespace Chroma
 	 * Project onto SU(Nc)
 	 */
 	u_lv1[ii] = u[mu];
-	sun_proj(u_tmp, u_lv1[ii], BlkAccu, BlkMax);
+	project(u_tmp, u_lv1[ii], BlkAccu, BlkMax, batched);
       }
     }
 
@@ -140,7 +155,7 @@ namespace Chroma
        * Project onto SU(Nc)
        */
       u_hyp[mu] = u[mu];
-      sun_proj(u_tmp, u_hyp[mu], BlkAccu, BlkMax);
+      project(u_tmp, u_hyp[mu], BlkAccu, BlkMax, batched);
     }
 
     END_CODE();
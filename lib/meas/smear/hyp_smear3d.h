@@ -22,12 +22,14 @@ namespace Chroma
    *  \param BlkAccu	accuracy in SU(Nc) projection (Read)
    *  \param BlkMax	max number of iterations in SU(Nc) projection (Read)
    *  \param j_decay	direction of no staple(Read)
+   *  \param batched	project each site until its own trace has converged,
+   *			in place of the lattice wide criterion of sun_proj (Read)
    */
 
   void Hyp_Smear3d(const multi1d<LatticeColorMatrix>& u,
 		   multi1d<LatticeColorMatrix>& u_hyp,
 		   const Real& alpha1, const Real& alpha2, const Real& alpha3,
-		   const Real& BlkAccu, int BlkMax,int j_decay);
+		   const Real& BlkAccu, int BlkMax,int j_decay, bool batched = false);
 
 }
 
@@ -8,6 +8,7 @@
 #include "meas/smear/gaus_quark_smearing.h"
 #include "meas/smear/vector_quark_smearing.h"
 #include "meas/smear/jacobi_quark_smearing.h"
+#include "meas/smear/blocked_quark_smearing.h"
 
 namespace Chroma
 {
@@ -31,6 +32,7 @@ namespace Chroma
 	success &= GausQuarkSmearingEnv::registerAll();
 	success &= VectorQuarkSmearingEnv::registerAll();
 	success &= JacobiQuarkSmearingEnv::registerAll();
+	success &= BlockedQuarkSmearingEnv::registerAll();
 	registered = true;
       }
       return success;
@@ -20,6 +20,7 @@
 #include "meas/sources/source_const_factory.h"
 #include "meas/sources/dilutezN_source_const.h"
 #include "meas/sources/zN_src.h"
+#include "util/ferm/counter_rng.h"
 
 namespace Chroma
 {
@@ -82,6 +83,7 @@ namespace Chroma
     Params::Params()
     {
       smear = false ;
+      counter_rngP = false;
       j_decay = -1;
       t_source = -1;
     }
@@ -115,6 +117,11 @@ namespace Chroma
       }
 
       read(paramtop, "ran_seed", ran_seed);
+
+      counter_rngP = false;
+      if (paramtop.count("CounterRNG") != 0)
+	read(paramtop, "CounterRNG", counter_rngP);
+
       read(paramtop, "N", N);
       read(paramtop, "j_decay", j_decay);
       read(paramtop, "t_source", t_source);
@@ -141,6 +148,8 @@ namespace Chroma
 
       write(xml, "version", version);
       write(xml, "ran_seed", ran_seed);
+      if (counter_rngP)
+	write(xml, "CounterRNG", counter_rngP);
       write(xml, "N", N);
       write(xml, "j_decay", j_decay);
       write(xml, "t_source", t_source);
@@ -227,7 +236,13 @@ namespace Chroma
 
       // Create the noisy quark source on the entire lattice
       LatticeFermion quark_noise;
-      zN_src(quark_noise, params.N);
+      if (params.counter_rngP)
+      {
+	CounterRNG rng(CounterRNG::seedToKey(params.ran_seed), 0, 0);
+	zN_src(quark_noise, params.N, rng);
+      }
+      else
+	zN_src(quark_noise, params.N);
 
       // This is the filtered noise source to return
       LatticeFermion quark_source = zero;
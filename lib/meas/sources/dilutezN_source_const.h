@@ -38,6 +38,7 @@ namespace Chroma
       bool smear ; // a flag that tells me to smear or not to smear
 
       Seed                     ran_seed;             /*!< Set the seed to this value */
+      bool                     counter_rngP;         /*!< Layout independent noise keyed on ran_seed */
       int                      N;                    /*!< Z(N) */
       
       multi1d<int>             spatial_mask_size;    /*!< Spatial size of periodic mask */
@@ -7,6 +7,7 @@
 #include "meas/sources/source_const_factory.h"
 #include "meas/sources/rndz2wall_source_const.h"
 #include "util/ferm/transf.h"
+#include "util/ferm/counter_rng.h"
 
 namespace Chroma
 {
@@ -63,6 +64,7 @@ namespace Chroma
     //! Initialize
     Params::Params()
     {
+      counter_rngP = false;
       j_decay = -1;
       t_source = -1;
     }
@@ -89,6 +91,10 @@ namespace Chroma
 
       read(paramtop, "ran_seed", ran_seed);
 
+      counter_rngP = false;
+      if (paramtop.count("CounterRNG") != 0)
+	read(paramtop, "CounterRNG", counter_rngP);
+
       /**
 #if 0
 #warning "CHECK IF SETTING SEED IS DESIRED BEHAVIOR"
@@ -116,6 +122,8 @@ namespace Chroma
       int version = 1;
       write(xml, "version", version);
       write(xml, "ran_seed", ran_seed);
+      if (counter_rngP)
+	write(xml, "CounterRNG", counter_rngP);
       write(xml, "j_decay", j_decay);
       write(xml, "t_source", t_source);
       pop(xml);
@@ -148,9 +156,18 @@ namespace Chroma
       LatticeReal ar, ai;
       LatticeComplex z;
 
-      random(rnd);
+      // Layout independent noise keyed on ran_seed if requested
+      CounterRNG rng(CounterRNG::seedToKey(params.ran_seed), 0, 0);
+
+      if (params.counter_rngP)
+	rng.uniform(rnd);
+      else
+	random(rnd);
       ar = where( rnd>0.5, LatticeReal(sqrt(0.5)), LatticeReal(-sqrt(0.5)) );
-      random(rnd);
+      if (params.counter_rngP)
+	rng.uniform(rnd);
+      else
+	random(rnd);
       ai = where( rnd>0.5, LatticeReal(sqrt(0.5)), LatticeReal(-sqrt(0.5)) );
       z = cmplx(ar, ai);
 
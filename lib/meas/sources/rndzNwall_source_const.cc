@@ -8,6 +8,7 @@
 #include "meas/sources/source_const_factory.h"
 #include "meas/sources/rndzNwall_source_const.h"
 #include "util/ferm/transf.h"
+#include "util/ferm/counter_rng.h"
 
 
 #include "meas/smear/quark_smearing_factory.h"
@@ -80,6 +81,7 @@ namespace Chroma
     //! Initialize
     Params::Params()
     {
+      counter_rngP = false;
       j_decay = -1;
       t_source = -1;
       N=4 ;
@@ -106,6 +108,11 @@ namespace Chroma
       }
 
       read(paramtop, "ran_seed", ran_seed);
+
+      counter_rngP = false;
+      if (paramtop.count("CounterRNG") != 0)
+	read(paramtop, "CounterRNG", counter_rngP);
+
       read(paramtop, "j_decay", j_decay);
       read(paramtop, "t_source", t_source);
       read(paramtop, "N", N);
@@ -138,6 +145,8 @@ namespace Chroma
       xml << link_smearing.xml;
       write(xml, "version", version);
       write(xml, "ran_seed", ran_seed);
+      if (counter_rngP)
+	write(xml, "CounterRNG", counter_rngP);
       write(xml, "j_decay", j_decay);
       write(xml, "t_source", t_source);
       write(xml, "N", N);
@@ -204,7 +213,14 @@ namespace Chroma
 	  LatticeReal rnd,theta;
 	  LatticeComplex z;
 
-	  random(rnd);
+	  // Layout independent noise keyed on ran_seed if requested
+	  if (params.counter_rngP)
+	  {
+	    CounterRNG rng(CounterRNG::seedToKey(params.ran_seed), 0, 0);
+	    rng.uniform(rnd);
+	  }
+	  else
+	    random(rnd);
 	  
 	  Real twopiN = Chroma::twopi / params.N;
 	  theta = twopiN * floor(params.N*rnd);
@@ -30,6 +30,7 @@ namespace Chroma
       void writeXML(XMLWriter& in, const std::string& path) const;
     
       Seed     ran_seed;             /*!< Set the seed to this value */
+      bool     counter_rngP;         /*!< Layout independent noise keyed on ran_seed */
 
       int      j_decay;              /*!< decay direction */
       int      t_source;             /*!< source time slice location */
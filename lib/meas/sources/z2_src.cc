@@ -63,6 +63,24 @@ namespace Chroma {
   }
 
 
+  //! Volume source of complex Z2 noise from a counter based generator
+  /*!
+   * \ingroup sources
+   *
+   * The same noise as z2_src(a), drawn from rng, so it does not depend
+   * on the node layout nor move the QDP generator on.
+   */
+  void z2_src(LatticeFermion& a, CounterRNG& rng)
+  {
+    rng.z2(a);
+  }
+
+  void z2_src(LatticeStaggeredFermion& a, CounterRNG& rng)
+  {
+    rng.z2(a);
+  }
+
+
   //! Timeslice source of complex Z2 noise
   /*!
    * \ingroup sources
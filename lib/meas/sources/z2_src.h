@@ -6,6 +6,8 @@
 #ifndef  Z2_SRC_INC
 #define  Z2_SRC_INC 
 
+#include "util/ferm/counter_rng.h"
+
 namespace Chroma 
 {
   //! Z2-source
@@ -20,6 +22,14 @@ namespace Chroma
   /*! @ingroup sources */
   void z2_src(LatticeFermion& a, int slice, int mu);
 
+  //! Z2-source from a counter based generator, the same on any layout
+  /*! @ingroup sources */
+  void z2_src(LatticeFermion& a, CounterRNG& rng);
+
+  //! Z2-source from a counter based generator, the same on any layout
+  /*! @ingroup sources */
+  void z2_src(LatticeStaggeredFermion& a, CounterRNG& rng);
+
 }  // end namespace Chroma
 
 #endif
@@ -61,5 +61,18 @@ namespace Chroma
   }
 
 
+
+  //! Volume source of Z(N) noise from a counter based generator
+  /*!
+   * \ingroup sources
+   *
+   * The same noise as zN_src(a, N), drawn from rng, so it does not depend
+   * on the node layout nor move the QDP generator on.
+   */
+  void zN_src(LatticeFermion& a, int N, CounterRNG& rng)
+  {
+    rng.zN(a, N);
+  }
+
 }  // end namespace Chroma
 
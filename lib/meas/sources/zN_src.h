@@ -6,6 +6,8 @@
 #ifndef  ZN_SRC_INC
 #define  ZN_SRC_INC 
 
+#include "util/ferm/counter_rng.h"
+
 namespace Chroma 
 {
   //! Z(N)-rng
@@ -16,6 +18,10 @@ namespace Chroma
   /*! @ingroup sources */
   void zN_src(LatticeFermion& a, int N);
 
+  //! Z(N)-source from a counter based generator, the same on any layout
+  /*! @ingroup sources */
+  void zN_src(LatticeFermion& a, int N, CounterRNG& rng);
+
 }  // end namespace Chroma
 
 #endif
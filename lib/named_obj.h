@@ -15,8 +15,16 @@
 
 #include "chromabase.h"
 #include "handle.h"
+#include "qdp_map_obj.h"
+#include "qdp_map_obj_memory.h"
+#include "util/ferm/subset_ev_pair.h"
 #include <map>
+#include <vector>
 #include <string>
+#include <cstdio>
+#include <iomanip>
+#include <algorithm>
+#include <sys/resource.h>
 
 namespace Chroma
 {
@@ -53,11 +61,236 @@ namespace Chroma
     //! Getter
     virtual void getRecordXML(XMLBufferWriter& xml) const = 0;
 
+    //! Bytes of data resident in memory on this node (0 if unknown or spilled)
+    virtual size_t residentBytes() const {return 0;}
+
+    //! Can the data be written to scratch and released?
+    virtual bool spillable() const {return false;}
+
+    //! Is the data currently in memory?
+    virtual bool resident() const {return true;}
+
+    //! Write the data to a scratch file and release the memory
+    virtual void spill(const std::string& path) {}
+
+    //! Read the data back from a scratch file
+    virtual void restore(const std::string& path) {}
+
+    //! Remove the scratch file of spilled data
+    virtual void removeSpill(const std::string& path) const {}
+
     // This is key for cleanup
     virtual ~NamedObjectBase() {}
   };
 
 
+  //--------------------------------------------------------------------------------------
+  //! Size accounting and spill support for named objects
+  /*! @ingroup support
+   *
+   * The default is an object of unknown size that is never spilled.
+   */
+  template<typename T>
+  struct NamedObjectSpillTraits
+  {
+    static size_t bytes(const T& obj) {return 0;}
+    static bool spillable() {return false;}
+    static void save(const std::string& path, const T& obj) {}
+    static void load(const std::string& path, T& obj) {}
+    static void remove(const std::string& path) {}
+  };
+
+
+  //! Remove the node-local QIO part file of a spilled object
+  /*! @ingroup support */
+  inline void removeNamedObjectSpillPart(const std::string& path)
+  {
+    // QIO part files carry the node number as a suffix
+    std::ostringstream part;
+    part << path << ".vol" << std::setw(4) << std::setfill('0') << Layout::nodeNumber();
+    std::remove(part.str().c_str());
+  }
+
+
+  //! Lattice objects are spilled with QIO, one part file per node
+  /*! @ingroup support */
+  template<typename T>
+  struct NamedObjectSpillTraits< OLattice<T> >
+  {
+    static size_t bytes(const OLattice<T>& obj) 
+    {
+      return size_t(Layout::sitesOnNode()) * sizeof(T);
+    }
+
+    static bool spillable() {return true;}
+
+    static void save(const std::string& path, const OLattice<T>& obj) 
+    {
+      XMLBufferWriter file_xml, record_xml;
+      push(file_xml, "NamedObjectSpill");
+      pop(file_xml);
+      push(record_xml, "NamedObjectSpill");
+      pop(record_xml);
+
+      QDPFileWriter to(file_xml, path, QDPIO_PARTFILE, QDPIO_PARALLEL, QDPIO_OPEN);
+      QDP::write(to, record_xml, obj);
+      close(to);
+    }
+
+    static void load(const std::string& path, OLattice<T>& obj) 
+    {
+      XMLReader file_xml, record_xml;
+      QDPFileReader from(file_xml, path, QDPIO_PARALLEL);
+      QDP::read(from, record_xml, obj);
+      close(from);
+    }
+
+    static void remove(const std::string& path) {removeNamedObjectSpillPart(path);}
+  };
+
+
+  //! Arrays of lattice objects (e.g. gauge fields) are spilled as one QIO record
+  /*! @ingroup support */
+  template<typename T>
+  struct NamedObjectSpillTraits< multi1d< OLattice<T> > >
+  {
+    static size_t bytes(const multi1d< OLattice<T> >& obj) 
+    {
+      return size_t(obj.size()) * size_t(Layout::sitesOnNode()) * sizeof(T);
+    }
+
+    static bool spillable() {return true;}
+
+    static void save(const std::string& path, const multi1d< OLattice<T> >& obj) 
+    {
+      XMLBufferWriter file_xml, record_xml;
+      push(file_xml, "NamedObjectSpill");
+      pop(file_xml);
+      push(record_xml, "NamedObjectSpill");
+      write(record_xml, "size", obj.size());
+      pop(record_xml);
+
+      QDPFileWriter to(file_xml, path, QDPIO_PARTFILE, QDPIO_PARALLEL, QDPIO_OPEN);
+      QDP::write(to, record_xml, obj);
+      close(to);
+    }
+
+    static void load(const std::string& path, multi1d< OLattice<T> >& obj) 
+    {
+      XMLReader file_xml, record_xml;
+      QDPFileReader from(file_xml, path, QDPIO_PARALLEL);
+      QDP::read(from, record_xml, obj);
+      close(from);
+    }
+
+    static void remove(const std::string& path) {removeNamedObjectSpillPart(path);}
+  };
+
+
+  //! Bytes on this node of one value held by a map object (0 if unknown)
+  /*! @ingroup support */
+  template<typename V>
+  struct NamedObjectValueBytes
+  {
+    static size_t bytes() {return 0;}
+  };
+
+  template<typename T>
+  struct NamedObjectValueBytes< OLattice<T> >
+  {
+    static size_t bytes() {return size_t(Layout::sitesOnNode()) * sizeof(T);}
+  };
+
+  //! Colour vectors with their eigenvalues
+  template<typename T>
+  struct NamedObjectValueBytes< EVPair<T> >
+  {
+    static size_t bytes() {return NamedObjectValueBytes<T>::bytes();}
+  };
+
+
+  //! Map objects, e.g. the colour vectors, are spilled as one binary file
+  /*! @ingroup support
+   *
+   * Only memory map objects are counted and spilled. A disk map object
+   * holds no values in memory and counts as 0 bytes. A spilled map object
+   * comes back as a memory map object with the same keys, values and
+   * user data. The keys and values need the binary readers and writers
+   * that disk map objects need as well. The memory is only released if
+   * no other handle to the map object is held.
+   */
+  template<typename K, typename V>
+  struct NamedObjectSpillTraits< Handle< QDP::MapObject<K,V> > >
+  {
+    typedef QDP::MapObject<K,V>        MapObj_t;
+    typedef QDP::MapObjectMemory<K,V>  MemObj_t;
+
+    static size_t bytes(const Handle<MapObj_t>& obj) 
+    {
+      if (obj.operator->() == 0 || dynamic_cast<const MemObj_t*>(obj.operator->()) == 0)
+	return 0;
+
+      return size_t(obj->size()) * NamedObjectValueBytes<V>::bytes();
+    }
+
+    static bool spillable() {return true;}
+
+    static void save(const std::string& path, const Handle<MapObj_t>& obj) 
+    {
+      std::string user_data;
+      obj->getUserdata(user_data);
+
+      std::vector<K> keys;
+      obj->keys(keys);
+
+      BinaryFileWriter bin(path);
+      write(bin, user_data);
+      write(bin, int(keys.size()));
+
+      V val;
+      for(int i=0; i < keys.size(); ++i)
+      {
+	obj->get(keys[i], val);
+	write(bin, keys[i]);
+	write(bin, val);
+      }
+      bin.close();
+    }
+
+    static void load(const std::string& path, Handle<MapObj_t>& obj) 
+    {
+      MemObj_t* mem = new MemObj_t();
+      obj = Handle<MapObj_t>(mem);
+
+      BinaryFileReader bin(path);
+
+      std::string user_data;
+      int num;
+      read(bin, user_data, 1 << 30);
+      read(bin, num);
+      mem->insertUserdata(user_data);
+
+      K key;
+      V val;
+      for(int i=0; i < num; ++i)
+      {
+	read(bin, key);
+	read(bin, val);
+	mem->insert(key, val);
+      }
+      mem->flush();
+      bin.close();
+    }
+
+    //! The binary file is written by the primary node only
+    static void remove(const std::string& path) 
+    {
+      if (Layout::primaryNode())
+	std::remove(path.c_str());
+    }
+  };
+
+
   //--------------------------------------------------------------------------------------
   //! Type specific named object
   /*! @ingroup support
@@ -67,10 +300,10 @@ namespace Chroma
   {
   public:
     //! Constructor
-    NamedObject() : data(new T) {}
+    NamedObject() : data(new T), is_resident(true) {}
   
     template<typename P1>
-    NamedObject(const P1& p1) : data(new T(p1)) {}
+    NamedObject(const P1& p1) : data(new T(p1)), is_resident(true) {}
  
     //! Destructor
     ~NamedObject() {}
@@ -131,30 +364,91 @@ namespace Chroma
 
     //! Mutable data ref
     virtual T& getData() {
+      checkResident();
       return *data;
     }
 
     //! Const data ref
     virtual const T& getData() const {
+      checkResident();
       return *data;
     }
 
+    //! Bytes of data resident in memory on this node
+    size_t residentBytes() const
+    {
+      return (is_resident) ? NamedObjectSpillTraits<T>::bytes(*data) : 0;
+    }
+
+    //! Can the data be written to scratch and released?
+    bool spillable() const {return NamedObjectSpillTraits<T>::spillable();}
+
+    //! Is the data currently in memory?
+    bool resident() const {return is_resident;}
+
+    //! Write the data to a scratch file and release the memory
+    void spill(const std::string& path)
+    {
+      if (! is_resident)
+	return;
+
+      NamedObjectSpillTraits<T>::save(path, *data);
+      data = Handle<T>();
+      is_resident = false;
+    }
+
+    //! Read the data back from a scratch file
+    void restore(const std::string& path)
+    {
+      if (is_resident)
+	return;
+
+      data = Handle<T>(new T);
+      NamedObjectSpillTraits<T>::load(path, *data);
+      is_resident = true;
+    }
+
+    //! Remove the scratch file of spilled data
+    void removeSpill(const std::string& path) const
+    {
+      NamedObjectSpillTraits<T>::remove(path);
+    }
+
+  private:
+    void checkResident() const
+    {
+      if (! is_resident)
+      {
+	std::ostringstream error_stream;
+	error_stream << "NamedObject::getData : data is spilled and must be accessed through the NamedObjectMap" << std::endl;
+	throw error_stream.str();
+      }
+    }
+
   private:
     Handle<T>   data;
     std::string file_xml;
     std::string record_xml;
+    bool        is_resident;
   };
 
 
   //--------------------------------------------------------------------------------------
   //! The Map Itself
   /*! @ingroup support
+   *
+   * The map optionally enforces a memory budget. Objects that exceed the
+   * budget are spilled, least recently used first, to node-local scratch
+   * and read back in when next looked up. Since callers hold references
+   * to the data while a measurement runs, spilling only happens when
+   * enforceBudget() is called between measurements.
    */
   class NamedObjectMap 
   {
   public:
     // Creation: clear the std::map
-    NamedObjectMap() {
+    NamedObjectMap() : budget(0), spill_dir("."), clock(0), peak_bytes(0),
+		       hits(0), faults(0), spills(0) {
       the_map.clear();
     };
 
@@ -166,6 +460,8 @@ namespace Chroma
       {
 	I iter = the_map.begin();
 
+	if (! iter->second->resident())
+	  removeSpillFile(iter->first, iter->second);
 	delete iter->second;
 
 	the_map.erase(iter);
@@ -173,6 +469,14 @@ namespace Chroma
     }
 
 
+    //! Set the memory budget in bytes per node (0 disables spilling) and the scratch directory
+    void setBudget(size_t budget_, const std::string& spill_dir_)
+    {
+      budget    = budget_;
+      spill_dir = spill_dir_;
+    }
+
+
     //! Create an entry of arbitrary type.
     template<typename T>
     void create(const std::string& id) 
@@ -198,6 +502,7 @@ namespace Chroma
         error_stream << "NamedObjectMap::create : error creating NamedObject for id= " << id << std::endl;
         throw error_stream.str();
       }
+      last_use[id] = ++clock;
     }
 
     //! Create an entry of arbitrary type, with 1 parameter
@@ -224,6 +529,7 @@ namespace Chroma
         error_stream << "NamedObjectMap::create : error creating NamedObject for id= " << id << std::endl;
         throw error_stream.str();
       }
+      last_use[id] = ++clock;
     }
 
 
@@ -247,11 +553,16 @@ namespace Chroma
       // If found then delete it.
       if( iter != the_map.end() ) 
       { 
+	// Remove any scratch copy
+	if (! iter->second->resident())
+	  removeSpillFile(iter->first, iter->second);
+
       	// Delete the data.of the record
 	delete iter->second;
 
 	// Delete the record
 	the_map.erase(iter);
+	last_use.erase(id);
       }
       else 
       {
@@ -273,6 +584,7 @@ namespace Chroma
   
   
     //! Look something up and return a NamedObjectBase reference
+    /*! A spilled object is transparently read back in */
     NamedObjectBase& get(const std::string& id) const
     {
       // Find it
@@ -286,6 +598,23 @@ namespace Chroma
       }
       else 
       {
+	// Fault it back in if needed
+	if (iter->second->resident())
+	{
+	  ++hits;
+	}
+	else
+	{
+	  QDPIO::cout << "NamedObjectMap: restoring id = " << id << std::endl;
+	  iter->second->restore(spillPath(id));
+	  removeSpillFile(id, iter->second);
+	  ++faults;
+	}
+	last_use[id] = ++clock;
+
+	// Objects are filled after they are created, so sample on each lookup
+	samplePeak();
+
 	// Found, return the reference
 	return *(iter->second);
       }
@@ -319,9 +648,154 @@ namespace Chroma
       return dynamic_cast<NamedObject<T>&>(get(id)).getData();
     }
 
+
+    //! Total bytes of resident objects on this node
+    size_t residentBytes() const
+    {
+      size_t total = 0;
+      for(MapType_t::const_iterator j = the_map.begin(); j != the_map.end(); j++) 
+	total += j->second->residentBytes();
+
+      return total;
+    }
+
+
+    //! Spill least recently used objects until the budget is met
+    /*! 
+     * Must only be called when no references to named object data are
+     * held, i.e., between inline measurements.
+     */
+    void enforceBudget()
+    {
+      size_t total = residentBytes();
+      peak_bytes = std::max(peak_bytes, total);
+
+      if (budget == 0)
+	return;
+
+      while (total > budget)
+      {
+	// Find the least recently used resident object that can be spilled
+	MapType_t::iterator victim = the_map.end();
+	unsigned long oldest = 0;
+
+	for(MapType_t::iterator j = the_map.begin(); j != the_map.end(); j++) 
+	{
+	  if (! j->second->resident() || ! j->second->spillable() || j->second->residentBytes() == 0)
+	    continue;
+
+	  unsigned long t = last_use[j->first];
+	  if (victim == the_map.end() || t < oldest)
+	  {
+	    victim = j;
+	    oldest = t;
+	  }
+	}
+
+	if (victim == the_map.end())
+	{
+	  QDPIO::cout << "NamedObjectMap: over budget, but nothing left to spill: resident bytes = " 
+		      << total << "  budget = " << budget << std::endl;
+	  break;
+	}
+
+	size_t nbytes = victim->second->residentBytes();
+
+	QDPIO::cout << "NamedObjectMap: spilling id = " << victim->first 
+		    << "  bytes = " << nbytes << std::endl;
+
+	victim->second->spill(spillPath(victim->first));
+	total -= nbytes;
+	++spills;
+      }
+    }
+
+
+    //! Write the accounting and spill statistics
+    /*!
+     * The peak of the named objects is sampled on every lookup and between
+     * measurements. It misses objects that grow between two lookups, and
+     * all memory that is not a named object, so the high water mark of the
+     * whole process is written as well. All values are those of the
+     * primary node.
+     */
+    void writeStats(XMLWriter& xml, const std::string& path) const
+    {
+      push(xml, path);
+      write(xml, "budget_bytes", (unsigned long)(budget));
+      write(xml, "resident_bytes", (unsigned long)(residentBytes()));
+      write(xml, "peak_bytes", (unsigned long)(std::max(peak_bytes, residentBytes())));
+      write(xml, "process_peak_bytes", processPeakBytes());
+      write(xml, "hits", hits);
+      write(xml, "faults", faults);
+      write(xml, "spills", spills);
+
+      push(xml, "Objects");
+      for(MapType_t::const_iterator j = the_map.begin(); j != the_map.end(); j++) 
+      {
+	push(xml, "elem");
+	write(xml, "id", j->first);
+	write(xml, "resident", j->second->resident());
+	write(xml, "bytes", (unsigned long)(j->second->residentBytes()));
+	pop(xml);
+      }
+      pop(xml);
+
+      pop(xml);
+    }
+
+  private:
+    //! High water mark of the resident memory of this process
+    static unsigned long processPeakBytes()
+    {
+      struct rusage usage;
+      if (getrusage(RUSAGE_SELF, &usage) != 0)
+	return 0;
+
+      // Linux reports kilobytes
+      return (unsigned long)(usage.ru_maxrss) * 1024;
+    }
+
+    //! Scratch file name for an id
+    std::string spillPath(const std::string& id) const
+    {
+      // Keep the id from escaping the scratch directory
+      std::string name(id);
+      for(std::string::iterator c = name.begin(); c != name.end(); ++c)
+	if (*c == '/')
+	  *c = '_';
+
+      return spill_dir + "/named_obj_spill_" + name;
+    }
+
+    //! Remove the scratch file of a spilled object
+    void removeSpillFile(const std::string& id, const NamedObjectBase* obj) const
+    {
+      if (! obj->spillable())
+	return;
+
+      obj->removeSpill(spillPath(id));
+    }
+
+    //! Update the peak of the resident bytes
+    void samplePeak() const
+    {
+      peak_bytes = std::max(peak_bytes, residentBytes());
+    }
+
   private:
     typedef std::map<std::string, NamedObjectBase*> MapType_t;
     MapType_t the_map;
+
+    size_t       budget;
+    std::string  spill_dir;
+
+    mutable std::map<std::string, unsigned long> last_use;
+    mutable unsigned long clock;
+    mutable size_t peak_bytes;
+    mutable unsigned long hits;
+    mutable unsigned long faults;
+    unsigned long spills;
   };
 
 }
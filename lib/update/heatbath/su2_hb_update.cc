@@ -2,10 +2,32 @@
 #include "chromabase.h"
 #include "util/gauge/su2extract.h"
 #include "util/gauge/sunfill.h"
+#include "util/ferm/counter_rng.h"
 
 namespace Chroma 
 {
 
+  //! Uniform numbers on sub
+  /*!
+   * From the counter based generator when it is on, else from the QDP
+   * one, followed by the scalar draw of the original code if dummy
+   */
+  static void hb_random(LatticeReal& x, const Subset& sub, bool dummy)
+  {
+    if (CounterRNGEnv::heatbathP())
+    {
+      CounterRNGEnv::heatbathRNG().uniform(x);
+      return;
+    }
+
+    random(x,sub);
+    if (dummy)
+    {
+      Real RDummy;
+      random(RDummy);
+    }
+  }
+
   void print_field(const LatticeReal& a0);
   void su2_a_0(const LatticeReal&, LatticeReal& ,
 	       const Subset& sub, const int NmaxHB,
@@ -75,9 +97,7 @@ namespace Chroma
     if(iWarning>0) QDPIO::cerr <<"large a_0!!!"<<std::endl;
     LatticeReal a_r;
     a_r[sub]=sqrt(a_abs);
-    random(CosTheta,sub);
-    Real RDummy;
-    random(RDummy);
+    hb_random(CosTheta,sub,true);
     CosTheta[sub]=1.0-2.0*CosTheta;
     a[3][sub]=a_r*CosTheta;
     //LatticeReal pr_a;
@@ -85,8 +105,7 @@ namespace Chroma
     //print_field(pr_a);
     CosTheta[sub]=(1-CosTheta*CosTheta);
     CosTheta[sub]=sqrt(CosTheta);//SinTheta
-    random(Phi,sub);
-    random(RDummy);
+    hb_random(Phi,sub,true);
     Phi[sub]*=8.0*atan(1.0);
     a_r[sub]*=CosTheta; //a_r*SinTheta
     a[1][sub]=a_r*cos(Phi);
@@ -115,18 +134,15 @@ namespace Chroma
     w_exp[sub]=exp(-2.0*weight); //too small, need to avoid
     LatticeReal x; //container for random numbers
     int n_runs=0;
-    Real RDummy;
     do {
       n_runs++;
       //random(x[sub]);
-      random(x,sub);
-      random(RDummy);
+      hb_random(x,sub,true);
       //a_0[sub]=where(lAccept,a_0,1.0+log(x*(1.0-w_exp)+w_exp)/weight);
       a_0[sub]=where(lAccept,a_0,1.0+log(w_exp*(1-x)+x)/weight);
       //print_field(a_0);exit(1);
       //random(x[sub]);
-      random(x,sub);
-      random(RDummy);
+      hb_random(x,sub,true);
       //lAccept[sub] = where(lAccept,(1 > 0),((x*x) < (1.0-a_0*a_0)));
       //x=1.0l-x;
       x=x*x;
@@ -153,10 +169,10 @@ namespace Chroma
     int n_runs=0;
     do {
       n_runs++;
-      random(xr1);
-      random(xr2);
-      random(xr3);
-      random(xr4);
+      hb_random(xr1,all,false);
+      hb_random(xr2,all,false);
+      hb_random(xr3,all,false);
+      hb_random(xr4,all,false);
       xr1=-(log(xr1)/weight);
       xr3 = cos(2.0l*M_PI*xr3);
       xr3=xr3*xr3;
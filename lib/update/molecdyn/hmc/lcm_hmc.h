@@ -18,6 +18,7 @@
 #include "update/molecdyn/hmc/global_metropolis_accrej.h"
 
 #include "util/gauge/taproj.h" 
+#include "util/ferm/counter_rng.h"
 
 
 namespace Chroma 
@@ -60,12 +61,19 @@ namespace Chroma
     void refreshP(AbsFieldState<multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> >& s) const
     {
       START_CODE();
+
+      // Layout independent momenta if requested
+      bool counterP = CounterRNGEnv::momentumP();
+      CounterRNG rng = CounterRNGEnv::momentumRNG();
       
       // Loop over direcsions
       for(int mu = 0; mu < Nd; mu++) 
       {
 	// Pull the gaussian noise
-	gaussian(s.getP()[mu]);
+	if (counterP)
+	  rng.gaussian(s.getP()[mu]);
+	else
+	  gaussian(s.getP()[mu]);
 
 	// Old conventions
 	//s.getP()[mu] *= sqrt(0.5);  // Gaussian Normalisation
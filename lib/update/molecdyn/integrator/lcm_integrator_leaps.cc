@@ -2,7 +2,9 @@
 #include "util/gauge/taproj.h"
 #include "util/gauge/reunit.h"
 #include "util/gauge/expmat.h"
+#include "util/gauge/su3_batch.h"
 #include "update/molecdyn/monomial/force_monitors.h"
+#include "util/info/perf_counters.h"
 
 namespace Chroma 
 { 
@@ -44,7 +46,10 @@ namespace Chroma
       if( monomials.size() > 0 ) { 
 	push(xml_out, "elem");
 	swatch.reset(); swatch.start();
-	monomials[0].mon->dsdq(dsdQ,s);
+	{
+	  PerfCounters::Scope perf_scope("monomial:" + monomials[0].id);
+	  monomials[0].mon->dsdq(dsdQ,s);
+	}
 	swatch.stop();
 	QDPIO::cout << "FORCE TIME: " << monomials[0].id <<  " : " << swatch.getTimeInSeconds() << std::endl;
 	pop(xml_out); //elem
@@ -52,7 +57,10 @@ namespace Chroma
 	  push(xml_out, "elem");
 	  multi1d<LatticeColorMatrix> cur_F(Nd);
 	  swatch.reset(); swatch.start();
-	  monomials[i].mon->dsdq(cur_F, s);
+	  {
+	    PerfCounters::Scope perf_scope("monomial:" + monomials[i].id);
+	    monomials[i].mon->dsdq(cur_F, s);
+	  }
 	  swatch.stop();
 	  dsdQ += cur_F;
 
@@ -68,10 +76,8 @@ namespace Chroma
 
       for(int mu =0; mu < Nd; mu++) {
 
-	(s.getP())[mu] += real_step_size[mu] * dsdQ[mu];
-	
-	// taproj it...
-	taproj( (s.getP())[mu] );
+	// p[mu] = taproj( p[mu] + dt*dsdQ[mu] ) in one pass
+	SU3Batch::addTaproj( (s.getP())[mu], real_step_size[mu], dsdQ[mu] );
       }
       
       pop(xml_out); // pop("leapP");
@@ -85,9 +91,6 @@ namespace Chroma
     {
       START_CODE();
 
-      LatticeColorMatrix tmp_1;
-      LatticeColorMatrix tmp_2;
-      
       XMLWriter& xml_out= TheXMLLogWriter::Instance();
       // Self description rule
       push(xml_out, "leapQ");
@@ -106,25 +109,15 @@ namespace Chroma
       
       // Mutable
       multi1d<LatticeColorMatrix>& u = s.getQ();
+
+      PerfCounters::Region perf_region("leapQ");
       
       for(int mu = 0; mu < Nd; mu++) 
       {
-	//  dt*p[mu]
-	tmp_1 = real_step_size[mu]*(s.getP())[mu];
-	
-	// tmp_1 = exp(dt*p[mu])  
-	if(QDP_NC != 3) expmat(tmp_1, EXP_TWELFTH_ORDER);
-	else expmat(tmp_1, EXP_EXACT);
-	
-	// tmp_2 = exp(dt*p[mu]) u[mu] = tmp_1 * u[mu]
-	tmp_2 = tmp_1*(s.getQ())[mu];
-	
-	// u[mu] =  tmp_1 * u[mu] =  tmp_2 
-	(s.getQ())[mu] = tmp_2;
-	
-	// Reunitarize u[mu]
-	int numbad;
-	reunit((s.getQ())[mu], numbad, REUNITARIZE_ERROR);
+	// u[mu] = reunit( exp(dt*p[mu]) u[mu] ) in one pass
+	int numbad = SU3Batch::expMultReunit(u[mu], p_mom[mu], real_step_size[mu], true);
+	if ( numbad > 0 )
+	  QDP_error_exit("Unitarity violated", numbad);
       }
 
       pop(xml_out);
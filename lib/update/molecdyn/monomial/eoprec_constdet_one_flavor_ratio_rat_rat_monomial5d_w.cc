@@ -7,6 +7,7 @@
 
 #include "update/molecdyn/monomial/rat_approx_factory.h"
 #include "update/molecdyn/monomial/rat_approx_aggregate.h"
+#include "update/molecdyn/monomial/remez_coeff_store.h"
 
 #include "actions/ferm/fermacts/fermacts_aggregate_w.h"
 #include "actions/ferm/fermacts/fermact_factory_w.h"
@@ -88,6 +89,7 @@ namespace Chroma
     //*********************************************************************
     // Action rational approx
     {
+      RemezCoeffStoreEnv::OperatorScope op_scope(param.numer.fermact.xml);
       std::istringstream is(param.numer.action.ratApprox.xml);
       XMLReader approx_reader(is);
       QDPIO::cout << "Construct action rational approx= " << param.numer.action.ratApprox.id << std::endl;
@@ -103,6 +105,7 @@ namespace Chroma
     //*********************************************************************
     // Force rational approx
     {
+      RemezCoeffStoreEnv::OperatorScope op_scope(param.numer.fermact.xml);
       std::istringstream is(param.numer.force.ratApprox.xml);
       XMLReader approx_reader(is);
       QDPIO::cout << "Construct force rational approx= " << param.numer.force.ratApprox.id << std::endl;
@@ -144,6 +147,7 @@ namespace Chroma
     //*********************************************************************
     // Action rational approx
     {
+      RemezCoeffStoreEnv::OperatorScope op_scope(param.denom.fermact.xml);
       std::istringstream is(param.denom.action.ratApprox.xml);
       XMLReader approx_reader(is);
       QDPIO::cout << "Construct action rational approx= " << param.denom.action.ratApprox.id << std::endl;
@@ -159,6 +163,7 @@ namespace Chroma
     //*********************************************************************
     // Force rational approx
     {
+      RemezCoeffStoreEnv::OperatorScope op_scope(param.denom.fermact.xml);
       std::istringstream is(param.denom.force.ratApprox.xml);
       XMLReader approx_reader(is);
       QDPIO::cout << "Construct force rational approx= " << param.denom.force.ratApprox.id << std::endl;
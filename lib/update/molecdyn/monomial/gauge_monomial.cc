@@ -89,7 +89,7 @@ namespace Chroma
 
 
   // Constructor
-  GaugeMonomial::GaugeMonomial(const GaugeMonomialParams& param_) 
+  GaugeMonomial::GaugeMonomial(const GaugeMonomialParams& param_) : force_SP(false)
   {
     std::istringstream is(param_.gauge_act);
     XMLReader gaugeact_reader(is);
@@ -53,9 +53,15 @@ namespace Chroma
     GaugeMonomial(const GaugeMonomialParams& param_);
 
     //! Copy Constructor
-    GaugeMonomial(const GaugeMonomial& m) : gaugeact((m.gaugeact)) {}
+    GaugeMonomial(const GaugeMonomial& m) : gaugeact((m.gaugeact)), force_SP(false) {}
 
     //! Create a suitable state and compute F
+    /*!
+     * The action on the same links comes out of the force for little
+     * extra work. It is kept with the state, so that S on the links of
+     * the last force evaluation, e.g. at the end of a trajectory, does
+     * not build the loops again.
+     */
     void dsdq(P& F, const AbsFieldState<P,Q>& s) 
     {
       START_CODE();
@@ -66,7 +72,9 @@ namespace Chroma
       // Make a gauge connect state
       Handle< GaugeState<P,Q> > g_state(getGaugeAct().createState(s.getQ()));
 
-      getGaugeAct().deriv(F, g_state);
+      getGaugeAct().derivAndS(F, g_state, force_S);
+      force_state = g_state;
+      force_SP = true;
 
       monitorForces(xml_out, "Forces", F);
       pop(xml_out);
@@ -84,7 +92,12 @@ namespace Chroma
       push(xml_out, "GaugeMonomial");
 
       Handle< GaugeState<P,Q> > g_state(getGaugeAct().createState(s.getQ()));
-      Double action = getGaugeAct().S(g_state);
+
+      Double action;
+      if (force_SP && sameLinks(g_state->getLinks(), force_state->getLinks()))
+	action = force_S;
+      else
+	action = getGaugeAct().S(g_state);
 
       write(xml_out, "S", action);
       pop(xml_out);
@@ -115,9 +128,24 @@ namespace Chroma
       GaugeMonomial();
       void operator=(const GaugeMonomial&);
 
+      //! Are two sets of links identical?
+      static bool sameLinks(const Q& a, const Q& b)
+      {
+	for(int mu=0; mu < a.size(); ++mu)
+	  if (toBool(norm2(a[mu] - b[mu]) > Double(0)))
+	    return false;
+
+	return true;
+      }
+
     private:
       // A handle for the gaugeact
       Handle< GaugeAction<P,Q> > gaugeact;
+
+      // The state of the last force evaluation and the action on it
+      Handle< GaugeState<P,Q> > force_state;
+      Double  force_S;
+      bool    force_SP;
     };
 
 
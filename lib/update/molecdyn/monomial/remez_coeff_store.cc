@@ -0,0 +1,255 @@
+/*! @file
+ * @brief On-disk store of Remez coefficients
+ */
+
+#include "update/molecdyn/monomial/remez_coeff_store.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <cstdio>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+
+namespace Chroma
+{
+
+  namespace RemezCoeffStoreEnv
+  {
+    namespace
+    {
+      //! An approximation in use
+      struct Range_t
+      {
+	Key_t        key;
+	std::string  op;      /*!< its operator, empty if unknown */
+      };
+
+      //! Approximations created in this job
+      std::vector<Range_t>  ranges;
+
+      //! Operator of the approximations being made
+      std::string  current_op;
+
+      //! FermionAction group without the whitespace between tags
+      std::string normalize(const std::string& xml)
+      {
+	std::string out;
+	std::string blank;
+
+	for(int i=0; i < xml.size(); ++i)
+	{
+	  char c = xml[i];
+	  if (c == ' ' || c == '\t' || c == '\n' || c == '\r')
+	  {
+	    blank += c;
+	    continue;
+	  }
+
+	  // Blanks within the text of an element are kept
+	  bool between_tags = (out.size() == 0 || out[out.size()-1] == '>') && c == '<';
+	  if (! between_tags)
+	    out += blank;
+	  blank.clear();
+
+	  out += c;
+	}
+
+	return out;
+      }
+
+      //! Key as XML, also stored in the file to guard against collisions
+      void writeKey(XMLWriter& xml, const std::string& path, const Key_t& key)
+      {
+	push(xml, path);
+	write(xml, "power_num", int(key.power_num));
+	write(xml, "power_den", int(key.power_den));
+	write(xml, "degree", key.degree);
+	write(xml, "lower", key.lower);
+	write(xml, "upper", key.upper);
+	write(xml, "prec", int(key.prec));
+	pop(xml);
+      }
+
+      //! Printed key, as found under /RemezCoeffStore/Key
+      std::string printKey(const Key_t& key)
+      {
+	XMLBufferWriter xml;
+	push(xml, "RemezCoeffStore");
+	writeKey(xml, "Key", key);
+	pop(xml);
+
+	std::istringstream is(xml.str());
+	XMLReader xml_in(is);
+	XMLReader keytop(xml_in, "/RemezCoeffStore/Key");
+
+	return keytop.printCurrentContext();
+      }
+
+      //! File name of an entry
+      std::string fileName(const std::string& dir, const Key_t& key)
+      {
+	std::ostringstream os;
+	os << dir << "/remez_" << key.power_num << "_" << key.power_den
+	   << "_deg" << key.degree
+	   << std::scientific << std::setprecision(8)
+	   << "_" << toDouble(key.lower)
+	   << "_" << toDouble(key.upper)
+	   << "_prec" << key.prec << ".xml";
+
+	return os.str();
+      }
+
+      //! Existence, decided on the primary node
+      bool exists(const std::string& file)
+      {
+	int found = 0;
+	if (Layout::primaryNode())
+	{
+	  struct stat st;
+	  found = (stat(file.c_str(), &st) == 0) ? 1 : 0;
+	}
+	QDPInternal::broadcast(found);
+
+	return found != 0;
+      }
+
+      void readCoeff(XMLReader& xml, const std::string& path, RemezCoeff_t& coeff)
+      {
+	XMLReader coefftop(xml, path);
+	read(coefftop, "norm", coeff.norm);
+	read(coefftop, "res", coeff.res);
+	read(coefftop, "pole", coeff.pole);
+      }
+
+      void writeCoeff(XMLWriter& xml, const std::string& path, const RemezCoeff_t& coeff)
+      {
+	push(xml, path);
+	write(xml, "norm", coeff.norm);
+	write(xml, "res", coeff.res);
+	write(xml, "pole", coeff.pole);
+	pop(xml);
+      }
+    }
+
+
+    // Look up
+    bool lookup(const std::string& dir, const Key_t& key,
+		RemezCoeff_t& pfe, RemezCoeff_t& ipfe)
+    {
+      std::string file = fileName(dir, key);
+      if (! exists(file))
+	return false;
+
+      try
+      {
+	XMLReader xml(file);
+
+	XMLReader keytop(xml, "/RemezCoeffStore/Key");
+	if (keytop.printCurrentContext() != printKey(key))
+	{
+	  QDPIO::cerr << "RemezCoeffStore: key mismatch in " << file << std::endl;
+	  return false;
+	}
+
+	readCoeff(xml, "/RemezCoeffStore/PFECoeffs", pfe);
+	readCoeff(xml, "/RemezCoeffStore/IPFECoeffs", ipfe);
+      }
+      catch(const std::string& e)
+      {
+	QDPIO::cerr << "RemezCoeffStore: unusable entry " << file << ": " << e << std::endl;
+	return false;
+      }
+
+      QDPIO::cout << "RemezCoeffStore: read " << file << std::endl;
+      return true;
+    }
+
+
+    // Insert
+    void insert(const std::string& dir, const Key_t& key,
+		const RemezCoeff_t& pfe, const RemezCoeff_t& ipfe,
+		const Real& error)
+    {
+      std::string file = fileName(dir, key);
+      std::string tmp  = file + ".tmp";
+
+      if (Layout::primaryNode())
+	mkdir(dir.c_str(), 0755);
+
+      {
+	XMLFileWriter xml(tmp);
+	push(xml, "RemezCoeffStore");
+	writeKey(xml, "Key", key);
+	write(xml, "error", error);
+	writeCoeff(xml, "PFECoeffs", pfe);
+	writeCoeff(xml, "IPFECoeffs", ipfe);
+	pop(xml);
+	xml.close();
+      }
+
+      if (Layout::primaryNode())
+      {
+	if (std::rename(tmp.c_str(), file.c_str()) != 0)
+	  QDPIO::cerr << "RemezCoeffStore: could not rename " << tmp << " to " << file << std::endl;
+      }
+
+      QDPIO::cout << "RemezCoeffStore: wrote " << file << std::endl;
+    }
+
+
+    // Enter the scope of an operator
+    OperatorScope::OperatorScope(const std::string& fermact_xml) : prev(current_op)
+    {
+      current_op = normalize(fermact_xml);
+    }
+
+    // Leave it
+    OperatorScope::~OperatorScope()
+    {
+      current_op = prev;
+    }
+
+
+    // Remember an interval
+    void registerRange(const Key_t& key)
+    {
+      Range_t r;
+      r.key = key;
+      r.op  = current_op;
+
+      ranges.push_back(r);
+    }
+
+
+    // Compare the intervals of the operator against its measured spectrum
+    int checkRange(const std::string& who, const std::string& fermact_xml,
+		   const Real& lambda_lo, const Real& lambda_hi)
+    {
+      const std::string op = normalize(fermact_xml);
+      int num_out = 0;
+
+      for(int i=0; i < ranges.size(); ++i)
+      {
+	if (ranges[i].op.empty() || ranges[i].op != op)
+	  continue;
+
+	const Key_t& key = ranges[i].key;
+
+	if ( toBool(lambda_lo < key.lower) || toBool(lambda_hi > key.upper) )
+	{
+	  QDPIO::cerr << "WARNING: rational approximation of x^(" << key.power_num << "/" << key.power_den
+		      << ") with degree " << key.degree
+		      << " is valid on [" << key.lower << ", " << key.upper
+		      << "] but the spectrum of " << who
+		      << " is [" << lambda_lo << ", " << lambda_hi << "]" << std::endl;
+	  ++num_out;
+	}
+      }
+
+      return num_out;
+    }
+
+  }  // end namespace
+
+} //end namespace Chroma
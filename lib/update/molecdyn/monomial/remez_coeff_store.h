@@ -0,0 +1,93 @@
+// -*- C++ -*-
+/*! @file
+ * @brief On-disk store of Remez coefficients
+ *
+ * Remez runs of high degree take minutes, and every job with the same
+ * monomials repeats them identically. The store keeps the coefficients in
+ * a directory, one XML file per (power, degree, bounds, precision), so a
+ * job reads them instead.
+ */
+
+#ifndef __remez_coeff_store_h__
+#define __remez_coeff_store_h__
+
+#include "update/molecdyn/monomial/remez_coeff.h"
+#include <string>
+
+namespace Chroma
+{
+
+  //! Store of Remez coefficients
+  /*! @ingroup monomial */
+  namespace RemezCoeffStoreEnv
+  {
+    //! What identifies an approximation
+    struct Key_t
+    {
+      unsigned long  power_num;   /*!< Approximate x^(power_num/power_den) */
+      unsigned long  power_den;
+      int            degree;
+      Real           lower;       /*!< lower bound of approximation region */
+      Real           upper;       /*!< upper bound of approximation region */
+      unsigned long  prec;        /*!< number of digits used for bigfloat calcs */
+    };
+
+    //! Look up the coefficients of x^(power_num/power_den)
+    /*!
+     * \param dir    store directory ( Read )
+     * \param key    approximation ( Read )
+     * \param pfe    PFE of the approximation on a hit ( Write )
+     * \param ipfe   PFE of the inverse on a hit ( Write )
+     * \return true on a hit
+     */
+    bool lookup(const std::string& dir, const Key_t& key,
+		RemezCoeff_t& pfe, RemezCoeff_t& ipfe);
+
+    //! Insert freshly generated coefficients
+    /*!
+     * The file is written under a temporary name and renamed, so that
+     * concurrent jobs never read a partial entry
+     *
+     * \param error  maximum relative error of the approximation ( Read )
+     */
+    void insert(const std::string& dir, const Key_t& key,
+		const RemezCoeff_t& pfe, const RemezCoeff_t& ipfe,
+		const Real& error);
+
+
+    //! The operator of the approximations made while in scope
+    /*!
+     * A rational monomial holds one of these, made from the FermionAction
+     * group of the operator, around the construction of its approximations
+     */
+    class OperatorScope
+    {
+    public:
+      OperatorScope(const std::string& fermact_xml);
+      ~OperatorScope();
+
+    private:
+      std::string prev;
+    };
+
+    //! Remember the interval of an approximation in use, and its operator
+    void registerRange(const Key_t& key);
+
+    //! Warn about approximations of an operator that do not cover its measured spectrum
+    /*!
+     * Approximations of other operators, or made outside any OperatorScope,
+     * are not checked
+     *
+     * \param who          name of the operator in messages ( Read )
+     * \param fermact_xml  FermionAction group of the operator ( Read )
+     * \param lambda_lo    lowest measured eigenvalue ( Read )
+     * \param lambda_hi    highest measured eigenvalue ( Read )
+     * \return number of approximations out of range
+     */
+    int checkRange(const std::string& who, const std::string& fermact_xml,
+		   const Real& lambda_lo, const Real& lambda_hi);
+  }
+
+} //end namespace chroma
+
+#endif
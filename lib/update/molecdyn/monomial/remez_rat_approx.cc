@@ -8,6 +8,7 @@
 #include "update/molecdyn/monomial/rat_approx_aggregate.h"
 
 #include "update/molecdyn/monomial/remez.h"
+#include "update/molecdyn/monomial/remez_coeff_store.h"
 
 namespace Chroma 
 { 
@@ -69,6 +70,9 @@ namespace Chroma
 	read(paramtop, "digitPrecision", digitPrecision);
       else
 	digitPrecision = 50;
+
+      if (paramtop.count("coeffDir") != 0)
+	read(paramtop, "coeffDir", coeffDir);
     }
 
 
@@ -84,6 +88,8 @@ namespace Chroma
       write(xml, "upperMax", upperMax);
       write(xml, "degree", degree);
       write(xml, "digitPrecision", digitPrecision);
+      if (coeffDir != "")
+	write(xml, "coeffDir", coeffDir);
       
       pop(xml);
     }
@@ -107,27 +113,51 @@ namespace Chroma
 	QDP_abort(1);
       }
 
+      RemezCoeffStoreEnv::Key_t key;
+      key.power_num = power_num;
+      key.power_den = power_den;
+      key.degree    = params.degree;
+      key.lower     = params.lowerMin;
+      key.upper     = params.upperMax;
+      key.prec      = prec;
+
+      // Checked against later eigenvalue bound measurements of the
+      // operator in scope
+      RemezCoeffStoreEnv::registerRange(key);
+
       // Find approx to  x^abs(params.numPower/params.denPower)
-      QDPIO::cout << "Compute partial fraction expansion" << std::endl;
-      QDPIO::cout << "Numerator Power=" << power_num << " Denominator Power=" << power_den << std::endl;
-      Remez  remez(params.lowerMin, params.upperMax, prec);
-      remez.generateApprox(params.degree, power_num, power_den);
+      RemezCoeff_t  approx_pfe, approx_ipfe;
+
+      if (params.coeffDir == "" ||
+	  ! RemezCoeffStoreEnv::lookup(params.coeffDir, key, approx_pfe, approx_ipfe))
+      {
+	QDPIO::cout << "Compute partial fraction expansion" << std::endl;
+	QDPIO::cout << "Numerator Power=" << power_num << " Denominator Power=" << power_den << std::endl;
+	Remez  remez(params.lowerMin, params.upperMax, prec);
+	Real error = remez.generateApprox(params.degree, power_num, power_den);
+
+	approx_pfe  = remez.getPFE();
+	approx_ipfe = remez.getIPFE();
+
+	if (params.coeffDir != "")
+	  RemezCoeffStoreEnv::insert(params.coeffDir, key, approx_pfe, approx_ipfe, error);
+      }
 
       if (params.numPower > 0)
       {
 	// Find approx to  x^(params.numPower/params.denPower)
 	QDPIO::cout << "Sign = +1" << std::endl;
 
-	pfe = remez.getPFE();
-	ipfe = remez.getIPFE();
+	pfe = approx_pfe;
+	ipfe = approx_ipfe;
       }
       else
       {
 	// Find approx to  x^(-params.numPower/params.denPower)
 	QDPIO::cout << "Sign = -1" << std::endl;
 
-	pfe = remez.getIPFE();
-	ipfe = remez.getPFE();
+	pfe = approx_ipfe;
+	ipfe = approx_pfe;
       }
 
       END_CODE();
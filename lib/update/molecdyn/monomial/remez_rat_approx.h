@@ -31,6 +31,7 @@ namespace Chroma
       Real upperMax;        /*!< upper bound of approximation region */
       int  degree;          /*!< degree of approximation */
       int  digitPrecision;  /*!< number of digits used for bigfloat calcs */
+      std::string coeffDir; /*!< optional directory of stored coefficients */
     };
 
 
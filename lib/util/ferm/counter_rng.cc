@@ -0,0 +1,342 @@
+/*! \file
+ * \brief Counter based random numbers, independent of the node layout
+ */
+
+#include "util/ferm/counter_rng.h"
+
+#include <stdint.h>
+#include <cmath>
+#include <vector>
+
+namespace Chroma
+{
+  namespace
+  {
+    //! Kinds of fill
+    enum { UNIFORM, GAUSSIAN, Z2, ZN };
+
+    //! Philox4x32-10
+    inline void philox(const uint32_t ctr[4], const uint32_t key[2], uint32_t out[4])
+    {
+      uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+      uint32_t k0 = key[0], k1 = key[1];
+
+      for(int r=0; r < 10; ++r)
+      {
+	uint64_t p0 = uint64_t(0xD2511F53) * c0;
+	uint64_t p1 = uint64_t(0xCD9E8D57) * c2;
+
+	c0 = uint32_t(p1 >> 32) ^ c1 ^ k0;
+	c1 = uint32_t(p1);
+	c2 = uint32_t(p0 >> 32) ^ c3 ^ k1;
+	c3 = uint32_t(p0);
+
+	k0 += 0x9E3779B9;
+	k1 += 0xBB67AE85;
+      }
+
+      out[0] = c0;  out[1] = c1;  out[2] = c2;  out[3] = c3;
+    }
+
+
+    //! Random words of one site
+    struct SiteStream
+    {
+      uint32_t  ctr[4];
+      uint32_t  key[2];
+      uint32_t  buf[4];
+      int       n;
+
+      uint32_t next()
+      {
+	if (n == 4)
+	{
+	  philox(ctr, key, buf);
+	  ++ctr[1];
+	  n = 0;
+	}
+	return buf[n++];
+      }
+    };
+
+    //! Uniform in [0,1) with the full mantissa of the word
+    inline float uniformWord(SiteStream& s, float)
+    {
+      return float(s.next() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    inline double uniformWord(SiteStream& s, double)
+    {
+      uint32_t a = s.next() >> 5;
+      uint32_t b = s.next() >> 6;
+      return (double(a) * 67108864.0 + double(b)) * (1.0 / 9007199254740992.0);
+    }
+
+
+    //! Global lexicographic site index of each site on this node
+    /*!
+     * Rebuilt whenever the lattice size changes, e.g. when the layout is
+     * recreated between tests.
+     */
+    const std::vector<uint32_t>& globalSites()
+    {
+      static std::vector<uint32_t> lex;
+      static multi1d<int> lex_size;
+
+      const multi1d<int>& latt_size = Layout::lattSize();
+
+      bool stale = (int(lex.size()) != Layout::sitesOnNode() || lex_size.size() != latt_size.size());
+      for(int mu=0; ! stale && mu < latt_size.size(); ++mu)
+	stale = (lex_size[mu] != latt_size[mu]);
+
+      if (stale)
+      {
+	LatticeInt idx = zero;
+	for(int mu=Nd-1; mu >= 0; --mu)
+	  idx = idx*latt_size[mu] + Layout::latticeCoordinate(mu);
+
+	lex.resize(Layout::sitesOnNode());
+	for(int site=0; site < lex.size(); ++site)
+	  lex[site] = idx.elem(site).elem().elem().elem();
+
+	lex_size = latt_size;
+      }
+
+      return lex;
+    }
+
+
+    template<typename W>
+    struct FillArgs
+    {
+      W*               x;
+      int              nw;      /*!< words per site */
+      int              dist;
+      int              N;
+      const uint32_t*  key;
+      uint32_t         stream;
+      uint32_t         update;
+      uint32_t         draw;
+      const uint32_t*  lex;
+    };
+
+    template<typename W>
+    void fillSiteLoop(int lo, int hi, int myId, FillArgs<W>* a)
+    {
+      const W twopi = W(6.283185307179586476925286);
+      const int nw = a->nw;
+
+      for(int site=lo; site < hi; ++site)
+      {
+	SiteStream s;
+	s.ctr[0] = a->lex[site];
+	s.ctr[1] = a->draw;
+	s.ctr[2] = a->stream;
+	s.ctr[3] = a->update;
+	s.key[0] = a->key[0];
+	s.key[1] = a->key[1];
+	s.n = 4;
+
+	W* x = a->x + site*nw;
+
+	switch (a->dist)
+	{
+	case UNIFORM:
+	  for(int i=0; i < nw; ++i)
+	    x[i] = uniformWord(s, W());
+	  break;
+
+	case GAUSSIAN:
+	  // Box-Muller on pairs of words
+	  for(int i=0; i < nw; i += 2)
+	  {
+	    W u1 = W(1) - uniformWord(s, W());
+	    W u2 = uniformWord(s, W());
+	    W r  = std::sqrt(W(-2) * std::log(u1));
+	    x[i] = r * std::cos(twopi*u2);
+	    if (i+1 < nw)
+	      x[i+1] = r * std::sin(twopi*u2);
+	  }
+	  break;
+
+	case Z2:
+	  for(int i=0; i < nw; ++i)
+	    x[i] = (s.next() & 0x80000000u) ? W(-1) : W(1);
+	  break;
+
+	case ZN:
+	  for(int i=0; i < nw; i += 2)
+	  {
+	    W theta = (twopi / a->N) * std::floor(a->N * uniformWord(s, W()));
+	    x[i]   = std::cos(theta);
+	    x[i+1] = std::sin(theta);
+	  }
+	  break;
+	}
+      }
+    }
+  }
+
+
+  // Key of the generator
+  CounterRNG::CounterRNG(unsigned long seed, unsigned int stream_, unsigned int update_) :
+    stream(stream_), update(update_), draw(0)
+  {
+    key[0] = uint32_t(seed);
+    key[1] = uint32_t(uint64_t(seed) >> 32);
+  }
+
+
+  // Fill all the words of a field
+  template<typename T>
+  void CounterRNG::fill(OLattice<T>& x, int dist, int N)
+  {
+#ifndef QDP_IS_QDPJIT
+    typedef typename WordType<T>::Type_t W;
+
+    const std::vector<uint32_t>& lex = globalSites();
+
+    FillArgs<W> a;
+    a.x      = (W*)&(x.elem(0));
+    a.nw     = sizeof(T) / sizeof(W);
+    a.dist   = dist;
+    a.N      = N;
+    a.key    = key;
+    a.stream = stream;
+    a.update = update;
+    a.draw   = draw;
+    a.lex    = &lex[0];
+
+    dispatch_to_threads(Layout::sitesOnNode(), a, fillSiteLoop<W>);
+
+    // At most two 32-bit words per real word, four per block
+    draw += (2*a.nw + 3) / 4;
+#else
+    QDPIO::cerr << "CounterRNG: not supported with QDP-JIT" << std::endl;
+    QDP_abort(1);
+#endif
+  }
+
+
+  void CounterRNG::uniform(LatticeReal& r)
+  {
+    fill(r, UNIFORM, 0);
+  }
+
+  void CounterRNG::gaussian(LatticeColorMatrix& m)
+  {
+    fill(m, GAUSSIAN, 0);
+  }
+
+  void CounterRNG::gaussian(LatticeFermion& psi)
+  {
+    fill(psi, GAUSSIAN, 0);
+  }
+
+  void CounterRNG::z2(LatticeFermion& psi)
+  {
+    fill(psi, Z2, 0);
+  }
+
+  void CounterRNG::z2(LatticeStaggeredFermion& psi)
+  {
+    fill(psi, Z2, 0);
+  }
+
+  void CounterRNG::zN(LatticeFermion& psi, int N)
+  {
+    if (N < 1)
+    {
+      QDPIO::cerr << "CounterRNG: invalid N = " << N << " for Z(N) noise" << std::endl;
+      QDP_abort(1);
+    }
+
+    fill(psi, ZN, N);
+  }
+
+
+  // Pack the four 12-bit words of a QDP seed
+  unsigned long CounterRNG::seedToKey(const Seed& seed)
+  {
+    unsigned long k = 0;
+    for(int i=0; i < 4; ++i)
+      k |= (unsigned long)(seed.elem().elem(i).elem() & 0xfff) << (12*i);
+
+    return k;
+  }
+
+
+  namespace CounterRNGEnv
+  {
+    namespace
+    {
+      bool           momentum_p    = false;
+      unsigned long  momentum_seed = 0;
+      bool           heatbath_p    = false;
+      unsigned long  heatbath_seed = 0;
+      unsigned long  cur_update    = 0;
+      bool           cur_warm_up   = false;
+
+      //! Streams of the momenta and the heatbath
+      const unsigned int momentum_stream = 1;
+      const unsigned int heatbath_stream = 2;
+      const unsigned int warm_up_stream  = 3;
+
+      //! The heatbath generator of the current sweep
+      CounterRNG& heatbathGen()
+      {
+	static CounterRNG rng(0, heatbath_stream, 0);
+	return rng;
+      }
+
+      //! Start the heatbath draws of the current sweep
+      void rekeyHeatbath()
+      {
+	heatbathGen() = CounterRNG(heatbath_seed, 
+				   cur_warm_up ? warm_up_stream : heatbath_stream, 
+				   cur_update);
+      }
+    }
+
+    void setMomentumSeed(unsigned long seed)
+    {
+      momentum_p    = true;
+      momentum_seed = seed;
+    }
+
+    void setHeatbathSeed(unsigned long seed)
+    {
+      heatbath_p    = true;
+      heatbath_seed = seed;
+      rekeyHeatbath();
+    }
+
+    void setUpdate(unsigned long update_no, bool warm_up)
+    {
+      cur_update  = update_no;
+      cur_warm_up = warm_up;
+      rekeyHeatbath();
+    }
+
+    bool momentumP()
+    {
+      return momentum_p;
+    }
+
+    CounterRNG momentumRNG()
+    {
+      return CounterRNG(momentum_seed, momentum_stream, cur_update);
+    }
+
+    bool heatbathP()
+    {
+      return heatbath_p;
+    }
+
+    CounterRNG& heatbathRNG()
+    {
+      return heatbathGen();
+    }
+  }
+
+} // namespace Chroma
@@ -0,0 +1,102 @@
+// -*- C++ -*-
+/*! \file
+ * \brief Counter based random numbers, independent of the node layout
+ */
+
+#ifndef __counter_rng_h__
+#define __counter_rng_h__
+
+#include "chromabase.h"
+
+namespace Chroma
+{
+  //! Counter based random numbers
+  /*!
+   * \ingroup ferm
+   *
+   * Random numbers from the Philox4x32-10 bijection (Salmon et al, SC11).
+   * Each number is a function of (seed, global site, stream, update, draw),
+   * so nothing is kept per site. Fields come out the same on any number of
+   * nodes, the site loop is embarrassingly parallel, and there is no state
+   * to save in a checkpoint.
+   *
+   * Every fill moves on the draw counter, so successive fills of one object
+   * are independent. Two objects with the same key give the same numbers.
+   */
+  class CounterRNG
+  {
+  public:
+    //! Key of the generator
+    /*!
+     * \param seed     seed                                       (Read)
+     * \param stream   separates different uses of one seed       (Read)
+     * \param update   trajectory or configuration number         (Read)
+     */
+    CounterRNG(unsigned long seed, unsigned int stream, unsigned int update);
+
+    //! Uniform in [0,1)
+    void uniform(LatticeReal& r);
+
+    //! Unit variance gaussian in every real component
+    void gaussian(LatticeColorMatrix& m);
+
+    //! Unit variance gaussian in every real component
+    void gaussian(LatticeFermion& psi);
+
+    //! Complex Z2 noise, each component of the form  +-1 +- i
+    void z2(LatticeFermion& psi);
+
+    //! Complex Z2 noise, each component of the form  +-1 +- i
+    void z2(LatticeStaggeredFermion& psi);
+
+    //! Complex Z(N) noise
+    void zN(LatticeFermion& psi, int N);
+
+    //! A seed for this generator from a QDP seed
+    static unsigned long seedToKey(const Seed& seed);
+
+  private:
+    template<typename T>
+    void fill(OLattice<T>& x, int dist, int N);
+
+    unsigned int  key[2];
+    unsigned int  stream;
+    unsigned int  update;
+    unsigned int  draw;
+  };
+
+
+  //! Process wide use of the counter based generator
+  /*! \ingroup ferm */
+  namespace CounterRNGEnv
+  {
+    //! Draw the HMC momenta from a counter based generator with this seed
+    void setMomentumSeed(unsigned long seed);
+
+    //! Draw the gauge heatbath numbers from a counter based generator with this seed
+    void setHeatbathSeed(unsigned long seed);
+
+    //! Set the number of the current trajectory or sweep
+    /*!
+     * Warm up sweeps that are numbered apart from the production ones
+     * take their heatbath numbers from a stream of their own.
+     */
+    void setUpdate(unsigned long update_no, bool warm_up = false);
+
+    //! Are the momenta drawn from the counter based generator?
+    bool momentumP();
+
+    //! Generator for the momenta of the current trajectory
+    CounterRNG momentumRNG();
+
+    //! Are the heatbath numbers drawn from the counter based generator?
+    bool heatbathP();
+
+    //! Generator for the heatbath of the current sweep
+    /*! Shared by all the draws of the sweep, each fill moves it on */
+    CounterRNG& heatbathRNG();
+  }
+
+} // namespace Chroma
+
+#endif
@@ -0,0 +1,65 @@
+/*! \file
+ * \brief Support for restarting measurements from a partially written output file
+ */
+
+#include "util/ferm/db_restart.h"
+
+namespace Chroma
+{
+  namespace DBRestartEnv
+  {
+    namespace
+    {
+      //! Printed entry, or empty if absent
+      std::string getEntry(XMLReader& xml, const std::string& path)
+      {
+	if (xml.count(path) == 0)
+	  return std::string();
+
+	XMLReader entry(xml, path);
+	return entry.printCurrentContext();
+      }
+    }
+
+
+    // Check metadata
+    void checkMetaData(const std::string& name,
+		       const std::string& file,
+		       const std::string& stored,
+		       const std::string& current,
+		       const std::vector<std::string>& paths)
+    {
+      try
+      {
+	std::istringstream stored_is(stored);
+	XMLReader stored_xml(stored_is);
+
+	std::istringstream current_is(current);
+	XMLReader current_xml(current_is);
+
+	for(int i=0; i < paths.size(); ++i)
+	{
+	  std::string stored_entry  = getEntry(stored_xml, paths[i]);
+	  std::string current_entry = getEntry(current_xml, paths[i]);
+
+	  if (stored_entry != current_entry)
+	  {
+	    QDPIO::cerr << name << ": cannot restart from " << file << ": " << paths[i] << " differs" << std::endl;
+	    QDPIO::cerr << "found in file:\n" << stored_entry << std::endl;
+	    QDPIO::cerr << "this run:\n" << current_entry << std::endl;
+	    QDP_abort(1);
+	  }
+	}
+      }
+      catch(const std::string& e)
+      {
+	QDPIO::cerr << name << ": cannot parse the metadata of " << file << ": " << e << std::endl;
+	QDP_abort(1);
+      }
+
+      QDPIO::cout << name << ": restarting from " << file << std::endl;
+    }
+
+  } // namespace DBRestartEnv
+
+} // namespace Chroma
@@ -0,0 +1,57 @@
+// -*- C++ -*-
+/*! \file
+ * \brief Support for restarting measurements from a partially written output file
+ *
+ * A measurement writing its results key by key into a database can be
+ * resumed after the job was killed: the existing file is opened, its
+ * metadata is checked against the current run, and every combination
+ * whose keys are all present already is skipped.
+ */
+
+#ifndef __db_restart_h__
+#define __db_restart_h__
+
+#include "chromabase.h"
+#include <string>
+#include <vector>
+
+namespace Chroma
+{
+  //! Restarting from partial output
+  /*! \ingroup ferm */
+  namespace DBRestartEnv
+  {
+    //! Abort unless the metadata of an existing file agrees with this run
+    /*!
+     * Each entry is compared as printed XML. An entry absent from both is
+     * accepted.
+     *
+     * \param name      measurement name used in messages   ( Read )
+     * \param file      output file name used in messages    ( Read )
+     * \param stored    metadata found in the file           ( Read )
+     * \param current   metadata of this run                 ( Read )
+     * \param paths     absolute paths of the entries        ( Read )
+     */
+    void checkMetaData(const std::string& name,
+		       const std::string& file,
+		       const std::string& stored,
+		       const std::string& current,
+		       const std::vector<std::string>& paths);
+
+    //! Are all the keys present in the db?
+    template<typename DB, typename C>
+    bool allExist(DB& db, const C& keys)
+    {
+      for(typename C::const_iterator key = keys.begin(); key != keys.end(); ++key)
+      {
+	if (! db.exist(*key))
+	  return false;
+      }
+
+      return true;
+    }
+  }
+
+} // namespace Chroma
+
+#endif
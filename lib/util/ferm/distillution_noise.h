@@ -28,7 +28,15 @@ namespace Chroma
  
   //---------------------------------------------------------------------
   //! Lattice origin
-  /*! \ingroup ferm */
+  /*! \ingroup ferm
+   *
+   * The origin and the noises are drawn by a scalar RANNYU stream seeded
+   * from a hash of the ensemble, sequence and quark line labels, not by
+   * the QDP lattice generator. They do not depend on the node layout nor
+   * on the order of the measurements. They are left off CounterRNG, as
+   * that would change the noises that stored perambulators and elementals
+   * were made with.
+   */
   class DistillutionNoise
   {
   public:
@@ -9,6 +9,7 @@
 #include "util/ferm/map_obj/map_obj_memory_w.h"
 #include "util/ferm/map_obj/map_obj_disk_w.h"
 #include "util/ferm/map_obj/map_obj_null_w.h"
+#include "util/ferm/map_obj/map_obj_sharded_w.h"
 
 
 namespace Chroma {
@@ -31,6 +32,7 @@ namespace Chroma {
 	success &= MapObjectDiskEnv::registerAll();
 	success &= MapObjectMemoryEnv::registerAll();
 	success &= MapObjectNullEnv::registerAll();
+	success &= MapObjectShardedEnv::registerAll();
 
 	registered = true;
       }
@@ -0,0 +1,460 @@
+// -*- C++ -*-
+/*! \file
+ * \brief Sharded disk std::map object, each node doing its own I/O
+ */
+
+#ifndef __map_obj_sharded_h__
+#define __map_obj_sharded_h__
+
+#include "chromabase.h"
+#include "qdp_map_obj.h"
+#include "util/ferm/subset_ev_pair.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <vector>
+#include <sstream>
+#include <type_traits>
+
+// The node blocks are written straight from and to the site data
+#ifdef QDP_IS_QDPJIT
+#error "map_obj_sharded.h needs the sites of a lattice field in one contiguous array, which QDP-JIT does not provide"
+#endif
+
+namespace Chroma
+{
+
+  //! Layout of the node local part of a value in a sharded map
+  /*! \ingroup ferm */
+  template<typename V>
+  struct ShardedValue;
+
+  //! Lattice objects: the sites of this node, in the node's own order
+  template<typename T>
+  struct ShardedValue< OLattice<T> >
+  {
+    static size_t localBytes() {return sizeof(T) * Layout::sitesOnNode();}
+
+    static char* data(OLattice<T>& v) {contiguous(v); return (char*)&(v.elem(0));}
+    static const char* data(const OLattice<T>& v) {contiguous(v); return (const char*)&(v.elem(0));}
+
+    //! The sites must be one array of T
+    static void contiguous(const OLattice<T>& v)
+    {
+      const int last = Layout::sitesOnNode() - 1;
+      if (&(v.elem(last)) - &(v.elem(0)) != last)
+      {
+	QDPIO::cerr << "MapObjectSharded: the sites of a lattice field are not contiguous" << std::endl;
+	QDP_abort(1);
+      }
+    }
+
+    //! Global (not per site) parts, kept in the index
+    static void getExtra(const OLattice<T>& v, multi1d<Real>& extra) {extra.resize(0);}
+    static void setExtra(OLattice<T>& v, const multi1d<Real>& extra) {}
+  };
+
+  //! Eigenpairs: the vector goes to the shards, the weights to the index
+  template<typename T>
+  struct ShardedValue< EVPair<T> >
+  {
+    static size_t localBytes() {return ShardedValue<T>::localBytes();}
+
+    static char* data(EVPair<T>& v) {return ShardedValue<T>::data(v.eigenVector);}
+    static const char* data(const EVPair<T>& v) {return ShardedValue<T>::data(v.eigenVector);}
+
+    static void getExtra(const EVPair<T>& v, multi1d<Real>& extra) {extra = v.eigenValue.weights;}
+    static void setExtra(EVPair<T>& v, const multi1d<Real>& extra) {v.eigenValue.weights = extra;}
+  };
+
+
+  //! Disk std::map object spread over several files, written by all nodes
+  /*! \ingroup ferm
+   *
+   * The store is a directory with an index and  num_shards  data files.
+   * Record r lives in shard  r % num_shards, and within it each node
+   * owns a contiguous block of its own sites. So every node reads and
+   * writes its part of every object itself, in parallel, with no
+   * gather onto the primary node.
+   *
+   * The index (keys, record numbers, weights, user data and the layout)
+   * is held in memory on every node, so lookups need no I/O. It is
+   * written by the primary node on flush().
+   *
+   * The data are stored in the node local site order, so a store can
+   * only be read back with the same lattice, node grid and precision.
+   * This is checked on open. Keys must be plain structs.
+   *
+   * A store opened without  std::ios_base::out  is read only.
+   */
+  template<typename K, typename V>
+  class MapObjectSharded : public QDP::MapObject<K,V>
+  {
+  public:
+    //! Empty map
+    MapObjectSharded() : num_shards(0), next_record(0), dirty(false), read_only(false) {}
+
+    //! Writes the index and closes the shards
+    ~MapObjectSharded()
+    {
+      if (num_shards > 0)
+      {
+	flush();
+	for(int s=0; s < fds.size(); ++s)
+	  ::close(fds[s]);
+      }
+    }
+
+    //! Open a store
+    /*!
+     * \param dir          directory of the store ( Read )
+     * \param num_shards_  number of data files of a new store ( Read )
+     * \param mode         with  std::ios_base::trunc  any old store is discarded,
+     *                     without  std::ios_base::out  the store must exist and is
+     *                     only read ( Read )
+     */
+    void open(const std::string& dir_, int num_shards_, std::ios_base::openmode mode)
+    {
+      dir = dir_;
+      num_shards = (num_shards_ < 1) ? 1 : num_shards_;
+
+      read_only  = (mode & std::ios_base::out) == 0;
+      bool trunc = ! read_only && (mode & std::ios_base::trunc) != 0;
+
+      // Make the directory before anybody opens a file in it
+      int have_index = 0;
+      if (Layout::primaryNode())
+      {
+	if (! read_only)
+	  mkdir(dir.c_str(), 0755);
+
+	struct stat st;
+	have_index = (! trunc && stat(indexName().c_str(), &st) == 0) ? 1 : 0;
+      }
+      QDPInternal::broadcast(have_index);
+
+      if (read_only && ! have_index)
+      {
+	QDPIO::cerr << "MapObjectSharded: no store to read in " << dir << std::endl;
+	QDP_abort(1);
+      }
+
+      if (have_index)
+	readIndex();
+
+      if (trunc && Layout::primaryNode())
+      {
+	for(int s=0; s < num_shards; ++s)
+	  ::close(::open(shardName(s).c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644));
+      }
+
+      // Synchronise, so no node opens a shard before it is truncated
+      int sync = 0;
+      QDPInternal::broadcast(sync);
+
+      fds.resize(num_shards);
+      int bad = 0;
+      for(int s=0; s < num_shards; ++s)
+      {
+	fds[s] = read_only ? ::open(shardName(s).c_str(), O_RDONLY) : ::open(shardName(s).c_str(), O_RDWR | O_CREAT, 0644);
+	if (fds[s] < 0)
+	  bad = 1;
+      }
+      check(bad, "cannot open the shards of " + dir);
+
+      dirty = ! have_index;
+    }
+
+    //! Check if a key exists
+    bool exist(const K& key) const
+    {
+      return index.find(keyString(key)) != index.end();
+    }
+
+    //! Insert a value
+    int insert(const K& key, const V& val)
+    {
+      writable();
+
+      std::string k = keyString(key);
+
+      typename std::map<std::string,Entry_t>::iterator it = index.find(k);
+      if (it == index.end())
+      {
+	Entry_t e;
+	e.record = next_record++;
+	it = index.insert(std::make_pair(k, e)).first;
+      }
+
+      ShardedValue<V>::getExtra(val, it->second.extra);
+
+      const size_t bytes = ShardedValue<V>::localBytes();
+      ssize_t n = ::pwrite(fds[shard(it->second.record)], ShardedValue<V>::data(val), bytes, offset(it->second.record));
+      check(n != ssize_t(bytes), "write error in " + dir);
+
+      dirty = true;
+      return 0;
+    }
+
+    //! Insert user data into the metadata
+    int insertUserdata(const std::string& user_data_)
+    {
+      writable();
+
+      user_data = user_data_;
+      dirty = true;
+      return 0;
+    }
+
+    //! Get a value
+    int get(const K& key, V& val) const
+    {
+      typename std::map<std::string,Entry_t>::const_iterator it = index.find(keyString(key));
+      if (it == index.end())
+      {
+	QDPIO::cerr << "MapObjectSharded: key not found in " << dir << std::endl;
+	QDP_abort(1);
+      }
+
+      const size_t bytes = ShardedValue<V>::localBytes();
+      ssize_t n = ::pread(fds[shard(it->second.record)], ShardedValue<V>::data(val), bytes, offset(it->second.record));
+      check(n != ssize_t(bytes), "read error in " + dir);
+
+      ShardedValue<V>::setExtra(val, it->second.extra);
+
+      return 0;
+    }
+
+    //! Get the user data
+    int getUserdata(std::string& user_data_) const
+    {
+      user_data_ = user_data;
+      return 0;
+    }
+
+    //! Forget a key. The space of its record is not reused
+    void erase(const K& key)
+    {
+      writable();
+
+      index.erase(keyString(key));
+      dirty = true;
+    }
+
+    //! Forget all keys
+    void clear()
+    {
+      writable();
+
+      index.clear();
+      next_record = 0;
+      dirty = true;
+    }
+
+    //! Write the index and commit the shards
+    void flush()
+    {
+      if (num_shards == 0 || read_only)
+	return;
+
+      for(int s=0; s < fds.size(); ++s)
+	::fdatasync(fds[s]);
+
+      if (dirty)
+	writeIndex();
+
+      dirty = false;
+    }
+
+    //! Number of keys
+    unsigned int size() const {return index.size();}
+
+    //! All the keys
+    void keys(std::vector<K>& keys_) const
+    {
+      keys_.clear();
+      for(typename std::map<std::string,Entry_t>::const_iterator it = index.begin(); it != index.end(); ++it)
+      {
+	K key;
+	std::memcpy(&key, it->first.data(), sizeof(K));
+	keys_.push_back(key);
+      }
+    }
+
+  private:
+    //! Hide copy and assignment
+    MapObjectSharded(const MapObjectSharded&);
+    void operator=(const MapObjectSharded&);
+
+    static_assert(std::is_pod<K>::value, "MapObjectSharded: keys must be plain structs");
+
+    struct Entry_t
+    {
+      long           record;
+      multi1d<Real>  extra;
+    };
+
+    //! Keys are compared on their bytes
+    static std::string keyString(const K& key)
+    {
+      return std::string((const char*)&key, sizeof(K));
+    }
+
+    std::string indexName() const {return dir + "/index";}
+
+    std::string shardName(int s) const
+    {
+      std::ostringstream os;
+      os << dir << "/shard." << s;
+      return os.str();
+    }
+
+    int shard(long record) const {return record % num_shards;}
+
+    off_t offset(long record) const
+    {
+      off_t slot = record / num_shards;
+      return (slot*Layout::numNodes() + Layout::nodeNumber()) * off_t(ShardedValue<V>::localBytes());
+    }
+
+    //! Abort on a change to a read only store
+    void writable() const
+    {
+      if (read_only)
+      {
+	QDPIO::cerr << "MapObjectSharded: " << dir << " is open read only" << std::endl;
+	QDP_abort(1);
+      }
+    }
+
+    //! Abort on all nodes if any node failed
+    static void check(bool failed, const std::string& what)
+    {
+      double bad = failed ? 1 : 0;
+      QDPInternal::globalSum(bad);
+      if (bad > 0)
+      {
+	QDPIO::cerr << "MapObjectSharded: " << what << std::endl;
+	QDP_abort(1);
+      }
+    }
+
+    //! What must match for the stored node blocks to be usable
+    static void layoutSignature(multi1d<int>& sig)
+    {
+      sig.resize(2*Nd + 2);
+      for(int mu=0; mu < Nd; ++mu)
+      {
+	sig[mu]    = Layout::lattSize()[mu];
+	sig[Nd+mu] = Layout::logicalSize()[mu];
+      }
+      sig[2*Nd]   = Layout::numNodes();
+      sig[2*Nd+1] = ShardedValue<V>::localBytes() / Layout::sitesOnNode();
+    }
+
+    void writeIndex()
+    {
+      std::string tmp = indexName() + ".tmp";
+
+      {
+	BinaryFileWriter bin(tmp);
+
+	multi1d<int> sig;
+	layoutSignature(sig);
+
+	write(bin, std::string("MapObjectSharded"));
+	write(bin, sig);
+	write(bin, num_shards);
+	write(bin, user_data);
+	write(bin, int(next_record));
+	write(bin, int(index.size()));
+
+	for(typename std::map<std::string,Entry_t>::const_iterator it = index.begin(); it != index.end(); ++it)
+	{
+	  K key;
+	  std::memcpy(&key, it->first.data(), sizeof(K));
+
+	  write(bin, key);
+	  write(bin, int(it->second.record));
+	  write(bin, it->second.extra);
+	}
+
+	bin.close();
+      }
+
+      int bad = 0;
+      if (Layout::primaryNode())
+	bad = (std::rename(tmp.c_str(), indexName().c_str()) != 0);
+      check(bad, "cannot replace the index of " + dir);
+    }
+
+    void readIndex()
+    {
+      BinaryFileReader bin(indexName());
+
+      std::string magic;
+      read(bin, magic, 64);
+      if (magic != "MapObjectSharded")
+      {
+	QDPIO::cerr << "MapObjectSharded: " << indexName() << " is not an index" << std::endl;
+	QDP_abort(1);
+      }
+
+      multi1d<int> sig, stored_sig;
+      layoutSignature(sig);
+      read(bin, stored_sig);
+
+      bool same = (sig.size() == stored_sig.size());
+      for(int i=0; same && i < sig.size(); ++i)
+	same = (sig[i] == stored_sig[i]);
+
+      if (! same)
+      {
+	QDPIO::cerr << "MapObjectSharded: " << dir
+		    << " was written with a different lattice, node grid or precision" << std::endl;
+	QDP_abort(1);
+      }
+
+      int nr, num;
+      read(bin, num_shards);
+      read(bin, user_data, 1 << 30);
+      read(bin, nr);
+      read(bin, num);
+      next_record = nr;
+
+      index.clear();
+      for(int i=0; i < num; ++i)
+      {
+	K key;
+	Entry_t e;
+	int record;
+
+	read(bin, key);
+	read(bin, record);
+	read(bin, e.extra);
+	e.record = record;
+
+	index.insert(std::make_pair(keyString(key), e));
+      }
+
+      bin.close();
+    }
+
+    std::string                     dir;
+    int                             num_shards;
+    long                            next_record;
+    bool                            dirty;
+    bool                            read_only;
+    std::string                     user_data;
+    std::map<std::string,Entry_t>   index;
+    std::vector<int>                fds;
+  };
+
+} // namespace Chroma
+
+#endif
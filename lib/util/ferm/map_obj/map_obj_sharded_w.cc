@@ -0,0 +1,133 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Sharded disk std::map object, factory registration
+ */
+
+#include "chromabase.h"
+#include "util/ferm/map_obj/map_obj_factory_w.h"
+#include "util/ferm/map_obj/map_obj_sharded_w.h"
+#include "util/ferm/key_prop_colorvec.h"
+#ifndef QDP_IS_QDPJIT
+#include "util/ferm/map_obj/map_obj_sharded.h"
+#endif
+#include <string>
+
+namespace Chroma 
+{ 
+  
+  namespace MapObjectShardedEnv 
+  {
+
+    namespace
+    {
+      // Parameter structure
+      struct Params
+      {
+	Params() {}
+	Params(XMLReader& xml_in, const std::string& path);
+
+	std::string   file_name;    /*!< directory of the store */
+	int           num_shards;   /*!< number of data files */
+	std::string   mode;         /*!< WRITE (new store), APPEND or READ */
+
+	//! Open mode of the store
+	std::ios_base::openmode openMode() const;
+      };
+
+      // Reader for input parameters
+      Params::Params(XMLReader& xml, const std::string& path)
+      {
+	XMLReader paramtop(xml, path);
+
+	read(paramtop, "FileName", file_name);
+
+	num_shards = 1;
+	if (paramtop.count("NumShards") == 1)
+	  read(paramtop, "NumShards", num_shards);
+
+	mode = "WRITE";
+	if (paramtop.count("Mode") == 1)
+	  read(paramtop, "Mode", mode);
+
+	openMode();
+      }
+
+      // Open mode of the store
+      std::ios_base::openmode Params::openMode() const
+      {
+	if (mode == "WRITE")
+	  return std::ios_base::in | std::ios_base::out | std::ios_base::trunc;
+	else if (mode == "APPEND")
+	  return std::ios_base::in | std::ios_base::out;
+	else if (mode == "READ")
+	  return std::ios_base::in;
+
+	QDPIO::cerr << "MAP_OBJECT_SHARDED: unknown Mode " << mode << ", expected WRITE, APPEND or READ" << std::endl;
+	QDP_abort(1);
+	return std::ios_base::in;
+      }
+
+
+#ifndef QDP_IS_QDPJIT
+      //! Callback function
+      QDP::MapObject<int,EVPair<LatticeColorVector> >* createMapObjIntKeyCV(XMLReader& xml_in,
+									    const std::string& path,
+									    const std::string& user_data) 
+      {
+	Params params(xml_in, path);
+	
+	auto obj = new MapObjectSharded<int,EVPair<LatticeColorVector> >();
+	obj->open(params.file_name, params.num_shards, params.openMode());
+
+	// A store that is read keeps its own user data
+	if (params.mode == "WRITE" || (params.mode == "APPEND" && obj->size() == 0))
+	  obj->insertUserdata(user_data);
+
+	return obj;
+      }
+
+      //! Callback function
+      QDP::MapObject<KeyPropColorVec_t,LatticeFermion>* createMapObjKeyPropColorVecLF(XMLReader& xml_in,
+										      const std::string& path,
+										      const std::string& user_data) 
+      {
+	Params params(xml_in, path);
+
+	auto obj = new MapObjectSharded<KeyPropColorVec_t,LatticeFermion>();
+	obj->open(params.file_name, params.num_shards, params.openMode());
+
+	// A store that is read keeps its own user data
+	if (params.mode == "WRITE" || (params.mode == "APPEND" && obj->size() == 0))
+	  obj->insertUserdata(user_data);
+
+	return obj;
+      }
+#endif
+
+      //! Local registration flag
+      bool registered = false;
+
+      //! Name to be used
+      const std::string name = "MAP_OBJECT_SHARDED";
+    } // namespace anonymous
+
+    std::string getName() {return name;}
+
+    //! Register all the factories
+    bool registerAll() 
+    {
+      bool success = true; 
+      if (! registered)
+      {
+#ifndef QDP_IS_QDPJIT
+	success &= Chroma::TheMapObjIntKeyColorEigenVecFactory::Instance().registerObject(name, createMapObjIntKeyCV);
+	success &= Chroma::TheMapObjKeyPropColorVecFactory::Instance().registerObject(name, createMapObjKeyPropColorVecLF);
+#endif
+	registered = true;
+      }
+      return success;
+    }
+  } // Namespace MapObjectShardedEnv
+
+
+} // Chroma
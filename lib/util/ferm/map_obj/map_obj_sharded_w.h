@@ -0,0 +1,22 @@
+// -*- C++ -*-
+/*! \file
+ * \brief Header file for std::map obj aggregate registrations 
+ */
+
+#ifndef __map_obj_sharded_w_h__
+#define __map_obj_sharded_w_h__
+
+namespace Chroma 
+{
+
+  //! Private Namespace 
+  namespace MapObjectShardedEnv 
+  { 
+    //! Registrations
+    bool registerAll();
+  }
+
+
+}
+
+#endif
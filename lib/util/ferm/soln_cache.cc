@@ -0,0 +1,308 @@
+/*! \file
+ * \brief Content-addressed on-disk cache of solver solutions
+ */
+
+#include "util/ferm/soln_cache.h"
+#include "util/ferm/crc48.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <utime.h>
+#include <cstdio>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+
+namespace Chroma
+{
+
+  // Default parameters
+  SolnCacheParams_t::SolnCacheParams_t() : max_size_gb(0) {}
+
+  // Read parameters
+  void read(XMLReader& xml, const std::string& path, SolnCacheParams_t& param)
+  {
+    XMLReader paramtop(xml, path);
+
+    read(paramtop, "CacheDir", param.cache_dir);
+
+    param.max_size_gb = 0;
+    if (paramtop.count("MaxSizeGB") != 0)
+      read(paramtop, "MaxSizeGB", param.max_size_gb);
+  }
+
+  // Write parameters
+  void write(XMLWriter& xml, const std::string& path, const SolnCacheParams_t& param)
+  {
+    push(xml, path);
+
+    write(xml, "CacheDir", param.cache_dir);
+    write(xml, "MaxSizeGB", param.max_size_gb);
+
+    pop(xml);
+  }
+
+
+  namespace SolnCacheEnv
+  {
+    namespace
+    {
+      //! FNV-1a over a byte range
+      unsigned long long fnv1a(unsigned long long h, const void* data, size_t bytes)
+      {
+	const unsigned char* p = static_cast<const unsigned char*>(data);
+	for(size_t i=0; i < bytes; ++i)
+	{
+	  h ^= p[i];
+	  h *= 1099511628211ULL;
+	}
+	return h;
+      }
+
+      //! Value as fixed width hex
+      std::string toHex(unsigned long long v, int width)
+      {
+	std::ostringstream os;
+	os << std::hex << std::setw(width) << std::setfill('0') << v;
+	return os.str();
+      }
+
+      //! An entry found when scanning the cache directory
+      struct Entry_t
+      {
+	std::string file;
+	double      size;
+	time_t      mtime;
+      };
+
+      bool olderThan(const Entry_t& a, const Entry_t& b)
+      {
+	return a.mtime < b.mtime;
+      }
+
+      const std::string suffix = ".soln";
+
+#ifndef QDP_IS_QDPJIT
+      //! Global lexicographic index of each site on this node
+      /*!
+       * Built once per lattice size, so the layout can be recreated with a
+       * different size without leaving a stale table behind.
+       */
+      const std::vector<unsigned long long>& localLexIndex()
+      {
+	static std::vector<unsigned long long> lex;
+	static multi1d<int> lex_size;
+
+	const multi1d<int>& latt_size = Layout::lattSize();
+
+	bool stale = (int(lex.size()) != Layout::sitesOnNode() || lex_size.size() != latt_size.size());
+	for(int mu=0; ! stale && mu < latt_size.size(); ++mu)
+	  stale = (lex_size[mu] != latt_size[mu]);
+
+	if (stale)
+	{
+	  lex.assign(Layout::sitesOnNode(), 0);
+	  for(int mu=Nd-1; mu >= 0; --mu)
+	  {
+	    LatticeInt x = Layout::latticeCoordinate(mu);
+	    for(int site=0; site < lex.size(); ++site)
+	      lex[site] = lex[site]*latt_size[mu] + x.elem(site).elem().elem().elem();
+	  }
+
+	  lex_size = latt_size;
+	}
+
+	return lex;
+      }
+#endif
+    }
+
+
+    //----------------------------------------------------------------------------
+    Checksum::Checksum() : field(0), lex(NULL)
+    {
+      for(int k=0; k < 4; ++k)
+	partial[k] = 0;
+
+#ifndef QDP_IS_QDPJIT
+      lex = &(localLexIndex()[0]);
+#endif
+    }
+
+    // Fold in one site
+    void Checksum::addSite(int site, const void* data, size_t bytes)
+    {
+      unsigned long long h = 14695981039346656037ULL;
+      h = fnv1a(h, &(lex[site]), sizeof(lex[site]));
+      h = fnv1a(h, &field, sizeof(field));
+      h = fnv1a(h, data, bytes);
+
+      // Sum 16-bit pieces, exact in double for up to 2^37 sites
+      for(int k=0; k < 4; ++k)
+	partial[k] += double((h >> (16*k)) & 0xffffULL);
+    }
+
+    // Sum over nodes
+    std::string Checksum::finish()
+    {
+      QDPInternal::globalSumArray(partial, 4);
+
+      unsigned long long v = 0;
+      for(int k=0; k < 4; ++k)
+	v += (unsigned long long)(partial[k]) << (16*k);
+
+      return toHex(v, 16);
+    }
+
+
+    // Checksum of a gauge field
+    std::string checksum(const multi1d<LatticeColorMatrix>& u)
+    {
+      Checksum sum;
+      for(int mu=0; mu < u.size(); ++mu)
+	addField(sum, u[mu]);
+      return sum.finish();
+    }
+
+
+    //----------------------------------------------------------------------------
+    // Constructor
+    SolnCache::SolnCache(const SolnCacheParams_t& p) : params(p), is_enabled(true)
+    {
+#ifdef QDP_IS_QDPJIT
+      QDPIO::cout << "SolnCache: field checksums are not available with QDP-JIT, cache disabled" << std::endl;
+      is_enabled = false;
+#endif
+
+      if (params.cache_dir == "")
+	is_enabled = false;
+
+      if (is_enabled && Layout::primaryNode())
+	mkdir(params.cache_dir.c_str(), 0755);
+    }
+
+
+    // Key
+    std::string SolnCache::makeKey(const std::string& gauge_sum,
+				   const std::string& param_xml,
+				   const std::string& src_sum) const
+    {
+      CRC48::CRC48_t crc;
+      CRC48::initCRC48(crc);
+      CRC48::calcCRC48(crc, param_xml.c_str(), param_xml.length());
+
+      unsigned char bytes[6];
+      CRC48::getCRC48(crc, bytes, 6);
+
+      unsigned long long v = 0;
+      for(int i=0; i < 6; ++i)
+	v = (v << 8) | bytes[i];
+
+      return gauge_sum + "_" + toHex(v, 12) + "_" + src_sum;
+    }
+
+
+    // File name
+    std::string SolnCache::fileName(const std::string& key) const
+    {
+      return params.cache_dir + "/" + key + suffix;
+    }
+
+
+    // Existence, decided on the primary node
+    bool SolnCache::exists(const std::string& file) const
+    {
+      int found = 0;
+      if (Layout::primaryNode())
+      {
+	struct stat st;
+	found = (stat(file.c_str(), &st) == 0) ? 1 : 0;
+      }
+      QDPInternal::broadcast(found);
+
+      return found != 0;
+    }
+
+
+    // Update the modification time used for eviction
+    void SolnCache::touch(const std::string& file) const
+    {
+      if (Layout::primaryNode())
+	utime(file.c_str(), NULL);
+    }
+
+
+    // Rename into place
+    void SolnCache::commit(const std::string& tmp, const std::string& file) const
+    {
+      if (Layout::primaryNode())
+      {
+	if (std::rename(tmp.c_str(), file.c_str()) != 0)
+	  QDPIO::cerr << "SolnCache: could not rename " << tmp << " to " << file << std::endl;
+      }
+    }
+
+
+    // Evict least recently used entries, keeping the newest
+    void SolnCache::evict(const std::string& keep) const
+    {
+      if (params.max_size_gb <= 0 || ! Layout::primaryNode())
+	return;
+
+      DIR* dir = opendir(params.cache_dir.c_str());
+      if (dir == NULL)
+	return;
+
+      std::vector<Entry_t> entries;
+      double total = 0;
+
+      struct dirent* d;
+      while ((d = readdir(dir)) != NULL)
+      {
+	std::string name(d->d_name);
+	if (name.size() <= suffix.size() ||
+	    name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0)
+	  continue;
+
+	Entry_t e;
+	e.file = params.cache_dir + "/" + name;
+
+	struct stat st;
+	if (stat(e.file.c_str(), &st) != 0)
+	  continue;
+
+	e.size  = double(st.st_size);
+	e.mtime = st.st_mtime;
+	total  += e.size;
+
+	// The entry just inserted counts towards the size but is never removed
+	if (e.file != keep)
+	  entries.push_back(e);
+      }
+      closedir(dir);
+
+      const double limit = params.max_size_gb * 1024.0 * 1024.0 * 1024.0;
+      if (total <= limit)
+	return;
+
+      std::sort(entries.begin(), entries.end(), olderThan);
+
+      int num_evicted = 0;
+      for(int i=0; i < entries.size() && total > limit; ++i)
+      {
+	if (std::remove(entries[i].file.c_str()) == 0)
+	{
+	  total -= entries[i].size;
+	  ++num_evicted;
+	}
+      }
+
+      QDPIO::cout << "SolnCache: evicted " << num_evicted << " entries, size now "
+		  << total / (1024.0 * 1024.0 * 1024.0) << " GB" << std::endl;
+    }
+
+  } // namespace SolnCacheEnv
+
+} // namespace Chroma
@@ -0,0 +1,229 @@
+// -*- C++ -*-
+/*! \file
+ * \brief Content-addressed on-disk cache of solver solutions
+ *
+ * Each solution is keyed by a checksum of the gauge field, the XML of the
+ * propagator parameters (fermion action with its boundary conditions and
+ * the inverter) and a checksum of the source. A rerun or a different
+ * analysis on the same configuration finds the solution instead of
+ * inverting again.
+ */
+
+#ifndef __soln_cache_h__
+#define __soln_cache_h__
+
+#include "chromabase.h"
+#include <string>
+
+namespace Chroma
+{
+  //! Parameters for the solution cache
+  /*! \ingroup ferm */
+  struct SolnCacheParams_t
+  {
+    SolnCacheParams_t();
+
+    std::string   cache_dir;      /*!< Directory holding the cached solutions */
+    double        max_size_gb;    /*!< Evict least recently used entries beyond this size, <= 0 is unlimited */
+  };
+
+  //! Read parameters
+  void read(XMLReader& xml, const std::string& path, SolnCacheParams_t& param);
+
+  //! Write parameters
+  void write(XMLWriter& xml, const std::string& path, const SolnCacheParams_t& param);
+
+
+  //! Solution cache
+  /*! \ingroup ferm */
+  namespace SolnCacheEnv
+  {
+    //! Layout independent checksum of lattice fields
+    /*!
+     * Every site is hashed together with its global lexicographic index, and
+     * the site hashes are summed, so the result does not depend on the node
+     * layout or the site ordering.
+     */
+    class Checksum
+    {
+    public:
+      Checksum();
+
+      //! Start the next field; fields at the same site are distinguished by their ordinal
+      void nextField() {++field;}
+
+      //! Fold in the data of one local site
+      void addSite(int site, const void* data, size_t bytes);
+
+      //! Sum over nodes and return as hex. Collective
+      std::string finish();
+
+    private:
+      int    field;
+      double partial[4];
+      const unsigned long long* lex;   /*!< global lexicographic index of each local site */
+    };
+
+
+    //! Fold in a lattice field
+    template<typename T>
+    void addField(Checksum& sum, const OLattice<T>& f)
+    {
+      sum.nextField();
+#ifndef QDP_IS_QDPJIT
+      const int* tab = all.siteTable().slice();
+      for(int j=0; j < all.numSiteTable(); ++j)
+	sum.addSite(tab[j], &(f.elem(tab[j])), sizeof(T));
+#endif
+    }
+
+    //! Checksum of a lattice field
+    template<typename T>
+    std::string checksum(const OLattice<T>& f)
+    {
+      Checksum sum;
+      addField(sum, f);
+      return sum.finish();
+    }
+
+    //! Checksum of a gauge field
+    std::string checksum(const multi1d<LatticeColorMatrix>& u);
+
+
+    //! On-disk solution cache
+    /*!
+     * Entries are QIO files named after their key, written under a temporary
+     * name and renamed so that a crashed job never leaves a partial entry.
+     * A hit touches the file, and eviction removes the least recently used
+     * entries once the directory exceeds the size limit.
+     */
+    class SolnCache
+    {
+    public:
+      //! Constructor
+      SolnCache(const SolnCacheParams_t& p);
+
+      //! Is the cache usable?
+      bool enabled() const {return is_enabled;}
+
+      //! Key from the gauge checksum, the parameter XML and the source checksum
+      std::string makeKey(const std::string& gauge_sum,
+			  const std::string& param_xml,
+			  const std::string& src_sum) const;
+
+      //! Look up a solution
+      /*!
+       * \param key         cache key ( Read )
+       * \param soln        solution on a hit ( Write )
+       * \param meta        record XML, the metadata is under /SolnCache/Meta ( Write )
+       * \return true on a hit
+       */
+      template<typename T>
+      bool lookup(const std::string& key, T& soln, XMLReader& meta);
+
+      //! Insert a solution, then evict if above the size limit
+      /*!
+       * \param key         cache key ( Read )
+       * \param soln        solution ( Read )
+       * \param meta        metadata, e.g. the iteration count and residual ( Read )
+       */
+      template<typename T>
+      void insert(const std::string& key, const T& soln, XMLBufferWriter& meta);
+
+    private:
+      //! File name of an entry
+      std::string fileName(const std::string& key) const;
+
+      //! Does the file exist? Collective
+      bool exists(const std::string& file) const;
+
+      //! Mark an entry as recently used
+      void touch(const std::string& file) const;
+
+      //! Move the finished temporary file into place
+      void commit(const std::string& tmp, const std::string& file) const;
+
+      //! Remove least recently used entries beyond the size limit, never the file keep
+      void evict(const std::string& keep) const;
+
+      SolnCacheParams_t params;
+      bool is_enabled;
+    };
+
+
+    //! Look up a solution
+    template<typename T>
+    bool SolnCache::lookup(const std::string& key, T& soln, XMLReader& meta)
+    {
+      if (! is_enabled)
+	return false;
+
+      std::string file = fileName(key);
+      if (! exists(file))
+	return false;
+
+      try
+      {
+	XMLReader file_xml;
+	QDPFileReader rdr(file_xml, file, QDPIO_SERIAL);
+	read(rdr, meta, soln);
+	close(rdr);
+
+	// Guard against a foreign file under this name
+	std::string stored_key;
+	read(meta, "/SolnCache/key", stored_key);
+	if (stored_key != key)
+	{
+	  QDPIO::cerr << "SolnCache: key mismatch in " << file << std::endl;
+	  return false;
+	}
+      }
+      catch(const std::string& e)
+      {
+	QDPIO::cerr << "SolnCache: unusable entry " << file << ": " << e << std::endl;
+	return false;
+      }
+
+      touch(file);
+      QDPIO::cout << "SolnCache: hit " << key << std::endl;
+
+      return true;
+    }
+
+
+    //! Insert a solution
+    template<typename T>
+    void SolnCache::insert(const std::string& key, const T& soln, XMLBufferWriter& meta)
+    {
+      if (! is_enabled)
+	return;
+
+      std::string file = fileName(key);
+      std::string tmp  = file + ".tmp";
+
+      XMLBufferWriter file_xml;
+      push(file_xml, "SolnCache");
+      write(file_xml, "key", key);
+      pop(file_xml);
+
+      XMLBufferWriter record_xml;
+      push(record_xml, "SolnCache");
+      write(record_xml, "key", key);
+      write(record_xml, "Meta", meta);
+      pop(record_xml);
+
+      QDPFileWriter to(file_xml, tmp, QDPIO_SINGLEFILE, QDPIO_SERIAL, QDPIO_OPEN);
+      write(to, record_xml, soln);
+      close(to);
+
+      commit(tmp, file);
+      QDPIO::cout << "SolnCache: inserted " << key << std::endl;
+
+      evict(file);
+    }
+
+  } // namespace SolnCacheEnv
+
+} // namespace Chroma
+
+#endif
@@ -11,18 +11,41 @@
 #include "chromabase.h"
 #include "qdp_map_obj_disk.h"
 #include "util/ferm/key_timeslice_colorvec.h"
+#include "util/ft/time_slice_set.h"
 
-namespace Chroma 
-{ 
+#include <list>
+#include <map>
+#include <deque>
+#include <vector>
+
+namespace Chroma
+{
   /*! \ingroup inlinehadron */
   //----------------------------------------------------------------------------
   //----------------------------------------------------------------------------
   //! Cache for holding time slice eigenvectors
+  /*!
+   * Holds the time slices of the colour vectors that were read, each
+   * packed to the sites of its slice on this node. The number of slices
+   * is bounded by a memory budget, and the least recently used slice is
+   * dropped when a new one is needed.
+   *
+   * A caller that knows its order of access passes it to hint(). Then
+   * prefetch() reads the upcoming slices in one batch, at a point of the
+   * caller's choosing. The reads are collective QDP I/O, so they are
+   * done synchronously on the calling thread and do not overlap with
+   * computation. All nodes must make the same calls.
+   */
+  template<typename V, typename M = QDP::MapObjectDisk< KeyTimeSliceColorVec_t,TimeSliceIO<V> > >
   class TimeSliceIOCache
   {
   public:
     //! Constructor
-    TimeSliceIOCache(QDP::MapObjectDisk<KeyTimeSliceColorVec_t,LatticeColorVector>& eigen_source_);
+    /*!
+     * \param eigen_source_   time sliced colour vectors ( Read )
+     * \param max_bytes       memory budget per node, 0 for no bound ( Read )
+     */
+    TimeSliceIOCache(M& eigen_source_, size_t max_bytes = 0);
 
     //! Virtual destructor
     virtual ~TimeSliceIOCache() {}
@@ -30,22 +53,243 @@ namespace Chroma
     //! Get number of vectors
     virtual int getNumVecs() const {return num_vecs;}
 
-    //! Get the whole std::vector
-    virtual LatticeColorVector& getVec(int colorvec);
+    //! Get only time slice t_actual of a vector, zero elsewhere
+    virtual void getSlice(V& dest, int t_actual, int colorvec);
+
+    //! Add to the upcoming sequence of (t_slice, colorvec) requests
+    virtual void hint(const std::vector<KeyTimeSliceColorVec_t>& upcoming);
 
-    //! Get a std::vector
-    virtual LatticeColorVector& getVec(int t_actual, int colorvec);
+    //! Read the hinted slices that are not yet held
+    /*!
+     * Stops once the hinted slices would fill the budget, so that
+     * nothing is dropped before it is used.
+     *
+     * \param max_reads   at most this many slices, all if negative ( Read )
+     */
+    virtual void prefetch(int max_reads = -1);
+
+    //! Print hits, misses, prefetches and evictions
+    virtual void printStats(const std::string& who) const;
 
   private:
+    //! (t_slice, colorvec)
+    typedef std::pair<int,int>  Key_t;
+
+    //! A cached time slice
+    struct Entry_t
+    {
+#ifndef QDP_IS_QDPJIT
+      std::vector<typename V::Subtype_t>  sites;   /*!< in the order of the slice site table */
+#else
+      V                                   vec;     /*!< no raw site access, so the whole field */
+#endif
+      typename std::list<Key_t>::iterator lru_pos;
+    };
+
+    //! Entry of a slice, read if absent
+    /*! \return true if the slice had to be read */
+    bool entry(int t_actual, int colorvec);
+
     // Arguments
-    QDP::MapObjectDisk< KeyTimeSliceColorVec_t,TimeSliceIO<LatticeColorVector> >& eigen_source;
+    M&                                    eigen_source;
 
     // Local
-    multi1d<LatticeColorVector>  eigen_cache;
-    multi2d<bool>                cache_marker;
-    int                          num_vecs;
+    TimeSliceSet                          tslice;
+    V                                     buf;          /*!< the field a slice is read into */
+    std::map<Key_t, Entry_t>              eigen_cache;
+    std::list<Key_t>                      lru;          /*!< most recently used first */
+    std::deque<KeyTimeSliceColorVec_t>    upcoming;
+    int                                   num_vecs;
+    int                                   max_slices;   /*!< 0 for no bound */
+
+    // Statistics
+    unsigned long                         hits;
+    unsigned long                         misses;
+    unsigned long                         prefetched;
+    unsigned long                         evictions;
   };
 
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  template<typename V, typename M>
+  TimeSliceIOCache<V,M>::TimeSliceIOCache(M& eigen_source_, size_t max_bytes)
+    : eigen_source(eigen_source_), tslice(Nd-1),
+      hits(0), misses(0), prefetched(0), evictions(0)
+  {
+    // Figure out how many vectors are in the source
+    // We know time slice 0 has to be a part of the sources
+    num_vecs = 0;
+    while(1)
+    {
+      KeyTimeSliceColorVec_t key;
+      key.t_slice  = 0;
+      key.colorvec = num_vecs;
+
+      if (! eigen_source.exist(key)) {break;}
+
+      ++num_vecs;
+    }
+
+    if (num_vecs == 0)
+    {
+      // A store may hold only some time slices
+      QDPIO::cout << __func__ << ": no eigenvectors on time slice 0, num_vecs unknown" << std::endl;
+    }
+    else
+    {
+      QDPIO::cout << __func__ << ": found in eigenstd::vector source num_vecs= " << num_vecs << std::endl;
+    }
+
+    // Size of one slice on a node that holds it, the same on all nodes
+    // so that all of them keep the same slices
+#ifndef QDP_IS_QDPJIT
+    size_t slice_bytes = sizeof(typename V::Subtype_t) * Layout::sitesOnNode() / Layout::subgridLattSize()[Nd-1];
+#else
+    size_t slice_bytes = sizeof(typename V::Subtype_t) * Layout::sitesOnNode();
+#endif
+
+    max_slices = 0;
+    if (max_bytes > 0)
+    {
+      max_slices = max_bytes / slice_bytes;
+      if (max_slices < 1)
+	max_slices = 1;
+
+      QDPIO::cout << __func__ << ": hold at most " << max_slices << " time slices" << std::endl;
+    }
+  }
+
+
+  // Entry of a slice
+  template<typename V, typename M>
+  bool TimeSliceIOCache<V,M>::entry(int t_actual, int colorvec)
+  {
+    Key_t key(t_actual, colorvec);
+
+    typename std::map<Key_t, Entry_t>::iterator it = eigen_cache.find(key);
+    if (it != eigen_cache.end())
+    {
+      // Most recently used
+      lru.splice(lru.begin(), lru, it->second.lru_pos);
+      return false;
+    }
+
+    // Make room
+    if (max_slices > 0 && eigen_cache.size() >= max_slices)
+    {
+      eigen_cache.erase(lru.back());
+      lru.pop_back();
+      ++evictions;
+    }
+
+    // Read it
+    KeyTimeSliceColorVec_t key_vec;
+    key_vec.t_slice  = t_actual;
+    key_vec.colorvec = colorvec;
+
+    TimeSliceIO<V> time_slice_io(buf, t_actual);
+    eigen_source.get(key_vec, time_slice_io);
+
+    Entry_t& e = eigen_cache[key];
+
+#ifndef QDP_IS_QDPJIT
+    const multi1d<int>& tab = tslice.getSet()[t_actual].siteTable();
+    e.sites.resize(tab.size());
+    for(int j=0; j < tab.size(); ++j)
+      e.sites[j] = buf.elem(tab[j]);
+#else
+    e.vec = zero;
+    e.vec[tslice.getSet()[t_actual]] = buf;
+#endif
+
+    lru.push_front(key);
+    e.lru_pos = lru.begin();
+
+    return true;
+  }
+
+
+  // Get only one time slice
+  template<typename V, typename M>
+  void TimeSliceIOCache<V,M>::getSlice(V& dest, int t_actual, int colorvec)
+  {
+    if (entry(t_actual, colorvec))
+      ++misses;
+    else
+      ++hits;
+
+    const Entry_t& e = eigen_cache[Key_t(t_actual, colorvec)];
+
+#ifndef QDP_IS_QDPJIT
+    dest = zero;
+
+    const multi1d<int>& tab = tslice.getSet()[t_actual].siteTable();
+    for(int j=0; j < tab.size(); ++j)
+      dest.elem(tab[j]) = e.sites[j];
+#else
+    dest = e.vec;
+#endif
+
+    // Requests skipped by the caller are dropped with it
+    for(int i=0; i < upcoming.size(); ++i)
+    {
+      if (upcoming[i].t_slice == t_actual && upcoming[i].colorvec == colorvec)
+      {
+	upcoming.erase(upcoming.begin(), upcoming.begin() + i + 1);
+	break;
+      }
+    }
+  }
+
+
+  // The upcoming requests
+  template<typename V, typename M>
+  void TimeSliceIOCache<V,M>::hint(const std::vector<KeyTimeSliceColorVec_t>& upcoming_)
+  {
+    upcoming.insert(upcoming.end(), upcoming_.begin(), upcoming_.end());
+  }
+
+
+  // Read the hinted slices
+  template<typename V, typename M>
+  void TimeSliceIOCache<V,M>::prefetch(int max_reads)
+  {
+    std::map<Key_t,bool> wanted;
+    int num_reads = 0;
+
+    for(int i=0; i < upcoming.size(); ++i)
+    {
+      if (max_reads >= 0 && num_reads >= max_reads)
+	break;
+
+      // Do not push out slices that are still to be used
+      wanted[Key_t(upcoming[i].t_slice, upcoming[i].colorvec)] = true;
+      if (max_slices > 0 && wanted.size() > max_slices)
+	break;
+
+      if (entry(upcoming[i].t_slice, upcoming[i].colorvec))
+      {
+	++prefetched;
+	++num_reads;
+      }
+    }
+  }
+
+
+  // Print the statistics
+  template<typename V, typename M>
+  void TimeSliceIOCache<V,M>::printStats(const std::string& who) const
+  {
+    QDPIO::cout << who << ": TimeSliceIOCache"
+		<< "  hits= " << hits
+		<< "  misses= " << misses
+		<< "  prefetched= " << prefetched
+		<< "  evictions= " << evictions
+		<< "  held= " << eigen_cache.size()
+		<< std::endl;
+  }
+
 }
 
 #endif
@@ -0,0 +1,1088 @@
+/*! \file
+ *  \brief Batched site-local SU(3) kernels: exponential, projections, reunitarisation
+ */
+
+#include "chromabase.h"
+#include "util/gauge/su3_batch.h"
+#include "util/gauge/expmat.h"
+#include "util/gauge/reunit.h"
+#include "util/gauge/taproj.h"
+#include "util/gauge/sun_proj.h"
+#include "util/gauge/stout_utils.h"
+#include "meas/gfix/polar_dec.h"
+
+#include <cmath>
+
+namespace Chroma
+{
+
+  namespace SU3Batch
+  {
+
+    //! Cayley-Hamilton coefficients of exp(iQ) for a traceless hermitian Q
+    template<typename R>
+    void expCoeffs(R c0, R c1,
+		   R f[3][2], R b1[3][2], R b2[3][2],
+		   bool dobs)
+    {
+      if( c1 < 4.0e-3 )
+      {
+	// RGE: set to 4.0e-3 (CM uses this value). I ran into nans with 1.0e-4
+	// ================================================================================
+	// 
+	// Corner Case 1: if c1 < 1.0e-4 this implies c0max ~ 3x10^-7
+	//    and in this case the division c0/c0max in arccos c0/c0max can be undefined
+	//    and produce NaN's
+	
+	// In this case what we can do is get the f-s a different way. We go back to basics:
+	//
+	// We solve (using std::maple) the matrix equations using the eigenvalues 
+	//
+	//  [ 1, q_1, q_1^2 ] [ f_0 ]       [ exp( iq_1 ) ]
+	//  [ 1, q_2, q_2^2 ] [ f_1 ]   =   [ exp( iq_2 ) ]
+	//  [ 1, q_3, q_3^2 ] [ f_2 ]       [ exp( iq_3 ) ]
+	//
+	// with q_1 = 2 u w, q_2 = -u + w, q_3 = - u - w
+	// 
+	// with u and w defined as  u = sqrt( c_1/ 3 ) cos (theta/3)
+	//                     and  w = sqrt( c_1 ) sin (theta/3)
+	//                          theta = arccos ( c0 / c0max )
+	// leaving c0max as a symbol.
+	//
+	//  we then expand the resulting f_i as a series around c0 = 0 and c1 = 0
+	//  and then substitute in c0max = 2 ( c_1/ 3)^(3/2)
+	//  
+	//  we then convert the results to polynomials and take the real and imaginary parts:
+	//  we get at the end of the day (to low order)
+	
+	//                  1    2 
+	//   f0[re] := 1 - --- c0  + h.o.t
+	//                 720     
+	//
+	//	         1       1           1        2 
+	//   f0[im] := - - c0 + --- c0 c1 - ---- c0 c1   + h.o.t
+	//               6      120         5040        
+	//
+	//
+	//             1        1            1        2 
+	//   f1[re] := -- c0 - --- c0 c1 + ----- c0 c1  +  h.o.t
+	//             24      360         13440        f
+	//
+	//                 1       1    2    1     3    1     2
+	//   f1[im] := 1 - - c1 + --- c1  - ---- c1  - ---- c0   + h.o.t
+	//                 6      120       5040       5040
+	//
+	//               1   1        1    2     1     3     1     2
+	//   f2[re] := - - + -- c1 - --- c1  + ----- c1  + ----- c0  + h.o.t
+	//               2   24      720       40320       40320    
+	//
+	//              1        1              1        2
+	//   f2[im] := --- c0 - ---- c0 c1 + ------ c0 c1  + h.o.t
+	//             120      2520         120960
+	
+	//  We then express these using Horner's rule for more stable evaluation.
+	// 
+	//  to get the b-s we use the fact that
+	//                                      b2_i = d f_i / d c0
+	//                                 and  b1_i = d f_i / d c1
+	//
+	//  where the derivatives are partial derivativs
+	//
+	//  And we just differentiate the polynomials above (keeping the same level
+	//  of truncation) and reexpress that as Horner's rule
+	// 
+	//  This clearly also handles the case of a unit gauge as no c1, u etc appears in the 
+	//  denominator and the arccos is never taken. In this case, we have the results in 
+	//  the raw c0, c1 form and we don't need to flip signs and take complex conjugates.
+	//
+	//  I checked the expressions below by taking the difference between the Horner forms
+	//  below from the expanded forms (and their derivatives) above and checking for the
+	//  differences to be zero. At this point in time std::maple seems happy.
+	//  ==================================================================================
+	
+	f[0][0] = 1.0-c0*c0/720.0;
+	f[0][1] = -(c0/6.0)*(1.0-(c1/20.0)*(1.0-(c1/42.0)));
+
+	f[1][0] = c0/24.0*(1.0-c1/15.0*(1.0-3.0*c1/112.0));
+	f[1][1] = 1.0-c1/6.0*(1.0-c1/20.0*(1.0-c1/42.0))-c0*c0/5040.0;
+
+	f[2][0] = 0.5*(-1.0+c1/12.0*(1.0-c1/30.0*(1.0-c1/56.0))+c0*c0/20160.0);
+	f[2][1] = 0.5*(c0/60.0*(1.0-c1/21.0*(1.0-c1/48.0)));
+
+	if( dobs )
+	{
+	  b2[0][0] = -c0/360.0;
+	  b2[0][1] = -(1.0/6.0)*(1.0-(c1/20.0)*(1.0-c1/42.0));
+
+	  b1[0][0] = 0;
+	  b1[0][1] = (c0/120.0)*(1.0-c1/21.0);
+
+	  b2[1][0] = (1.0/24.0)*(1.0-c1/15.0*(1.0-3.0*c1/112.0));
+	  b2[1][1] = -c0/2520.0;
+
+	  b1[1][0] = -c0/360.0*(1.0 - 3.0*c1/56.0);
+	  b1[1][1] = -1.0/6.0*(1.0-c1/10.0*(1.0-c1/28.0));
+
+	  b2[2][0] = 0.5*c0/10080.0;
+	  b2[2][1] = 0.5*(1.0/60.0*(1.0-c1/21.0*(1.0-c1/48.0)));
+
+	  b1[2][0] = 0.5*(1.0/12.0*(1.0-(2.0*c1/30.0)*(1.0-3.0*c1/112.0)));
+	  b1[2][1] = 0.5*(-c0/1260.0*(1.0-c1/24.0));
+	}
+
+	return;
+      }
+
+      // Normal case: as per the paper
+      bool c0_negativeP = c0 < 0;
+      R c0abs = fabs((double)c0);
+      R c0max = 2*pow( (double)(c1/(double)3), (double)1.5);
+      R theta;
+
+      R eps = (c0max - c0abs)/c0max;
+
+      if( eps < 0 )
+      {
+	// Corner case 2: |c0| > c0max only through rounding, so theta = 0
+	theta = 0;
+      }
+      else if ( eps < 1.0e-3 )
+      {
+	// Corner case 3: c0 -> c0max. Series of acos(1-eps) to O(eps^6)
+	R sqtwo = sqrt((R)2);
+	theta = sqtwo*sqrt(eps)*( 1.0 + ( (1/(R)12) + ( (3/(R)160) + ( (5/(R)896) + ( (35/(R)18432) + (63/(R)90112)*eps ) *eps) *eps) *eps) *eps);
+      }
+      else
+      {
+	theta = acos( c0abs/c0max );
+      }
+
+      R u = sqrt(c1/3)*cos(theta/3);
+      R w = sqrt(c1)*sin(theta/3);
+
+      R u_sq = u*u;
+      R w_sq = w*w;
+
+      R xi0, xi1 = 0;
+      {
+	bool w_smallP = fabs(w) < 0.05;
+	if( w_smallP )
+	  xi0 = (R)1 - ((R)1/(R)6)*w_sq*( 1 - ((R)1/(R)20)*w_sq*( (R)1 - ((R)1/(R)42)*w_sq ) );
+	else
+	  xi0 = sin(w)/w;
+
+	if( dobs )
+	{
+	  if( w_smallP )
+	    xi1 = -1*( ((R)1/(R)3) - ((R)1/(R)30)*w_sq*( (R)1 - ((R)1/(R)28)*w_sq*( (R)1 - ((R)1/(R)54)*w_sq ) ) );
+	  else
+	    xi1 = cos(w)/w_sq - sin(w)/(w_sq*w);
+	}
+      }
+
+      R cosu = cos(u);
+      R sinu = sin(u);
+      R cosw = cos(w);
+      R sin2u = sin(2*u);
+      R cos2u = cos(2*u);
+      R ucosu = u*cosu;
+      R usinu = u*sinu;
+      R ucos2u = u*cos2u;
+      R usin2u = u*sin2u;
+
+      R denum = (R)9*u_sq - w_sq;
+
+      {
+	R subexp1 = u_sq - w_sq;
+	R subexp2 = 8*u_sq*cosw;
+	R subexp3 = (3*u_sq + w_sq)*xi0;
+
+	f[0][0] = ( (subexp1)*cos2u + cosu*subexp2 + 2*usinu*subexp3 ) / denum ;
+	f[0][1] = ( (subexp1)*sin2u - sinu*subexp2 + 2*ucosu*subexp3 ) / denum ;
+      }
+      {
+	R subexp = (3*u_sq -w_sq)*xi0;
+
+	f[1][0] = (2*(ucos2u - ucosu*cosw)+subexp*sinu)/denum;
+	f[1][1] = (2*(usin2u + usinu*cosw)+subexp*cosu)/denum;
+      }
+      {
+	R subexp=3*xi0;
+
+	f[2][0] = (cos2u - cosu*cosw -usinu*subexp) /denum ;
+	f[2][1] = (sin2u + sinu*cosw -ucosu*subexp) /denum ;
+      }
+
+      if( dobs )
+      {
+	R r_1[3][2];
+	R r_2[3][2];
+
+	{
+	  R subexp1 = u_sq - w_sq;
+	  R subexp2 =  8*cosw + (3*u_sq + w_sq)*xi0 ;
+	  R subexp3 =  4*u_sq*cosw - (9*u_sq + w_sq)*xi0 ;
+
+	  r_1[0][0] = 2*(ucos2u - sin2u *(subexp1)+ucosu*( subexp2 )- sinu*( subexp3 ) );
+	  r_1[0][1] = 2*(usin2u + cos2u *(subexp1)-usinu*( subexp2 )- cosu*( subexp3 ) );
+	}
+	{
+	  R subexp1 = cosw+3*xi0;
+	  R subexp2 = 2*cosw + xi0*(w_sq - 3*u_sq);
+
+	  r_1[1][0] = 2*((cos2u - 2*usin2u) + usinu*( subexp1 )) - cosu*( subexp2 );
+	  r_1[1][1] = 2*((sin2u + 2*ucos2u) + ucosu*( subexp1 )) + sinu*( subexp2 );
+	}
+	{
+	  R subexp = cosw - 3*xi0;
+	  r_1[2][0] = -2*sin2u -3*ucosu*xi0 + sinu*( subexp );
+	  r_1[2][1] = 2*cos2u  +3*usinu*xi0 + cosu*( subexp );
+	}
+	{
+	  R subexp = cosw + xi0 + 3*u_sq*xi1;
+	  r_2[0][0] = -2*(cos2u + u*( 4*ucosu*xi0 - sinu*(subexp )) );
+	  r_2[0][1] = -2*(sin2u - u*( 4*usinu*xi0 + cosu*(subexp )) );
+	}
+	{
+	  R subexp =  cosw + xi0 - 3*u_sq*xi1;
+	  r_2[1][0] =  2*ucosu*xi0 - sinu*( subexp ) ;
+	  r_2[1][1] = -2*usinu*xi0 - cosu*( subexp ) ;
+	}
+	{
+	  R subexp = 3*xi1;
+	  r_2[2][0] =    cosu*xi0 - usinu*subexp ;
+	  r_2[2][1] = -( sinu*xi0 + ucosu*subexp ) ;
+	}
+
+	R b_denum=2*denum*denum;
+
+	for(int j=0; j < 3; j++)
+	{
+	  R subexp1 = 2*u;
+	  R subexp2 = 3*u_sq - w_sq;
+	  R subexp3 = 2*(15*u_sq + w_sq);
+
+	  for(int k=0; k < 2; k++)
+	  {
+	    b1[j][k] = ( subexp1*r_1[j][k] + subexp2*r_2[j][k] - subexp3*f[j][k] )/b_denum;
+	    b2[j][k] = ( r_1[j][k] - 3*u*r_2[j][k] - 24*u*f[j][k] )/b_denum;
+	  }
+	}
+
+	// f_j(-c0, c1) = (-1)^j f*_j(c0, c1), and b1 follows f while b2 picks up
+	// an extra sign from d/dc0
+	if( c0_negativeP )
+	{
+	  b1[0][1] *= -1;
+	  b1[1][0] *= -1;
+	  b1[2][1] *= -1;
+
+	  b2[0][0] *= -1;
+	  b2[1][1] *= -1;
+	  b2[2][0] *= -1;
+	}
+      }
+
+      // Flip the f-s last, the unflipped ones are needed for the b-s
+      if( c0_negativeP )
+      {
+	f[0][1] *= -1;
+	f[1][0] *= -1;
+	f[2][1] *= -1;
+      }
+    }
+
+    // The lattice precision, for the stout smearing and force, and double
+    // for the batched kernels
+    template void expCoeffs<float>(float, float, float[3][2], float[3][2], float[3][2], bool);
+    template void expCoeffs<double>(double, double, double[3][2], double[3][2], double[3][2], bool);
+
+
+#if ! defined(QDP_IS_QDPJIT) && QDP_NC == 3
+    namespace
+    {
+      //! Number of sites processed together
+      const int lanes = 8;
+
+      //! A batch of 3x3 complex matrices, sites innermost
+      template<typename W>
+      struct MatT
+      {
+	W re[3][3][lanes];
+	W im[3][3][lanes];
+      };
+
+      //! The kernels work in double, except exp(iQ) u of the stout smearing
+      //! and the Wilson flow, which keeps the lattice precision of the old code
+      typedef MatT<double> Mat;
+
+      //! Largest deviation from unitarity tolerated by reunit
+      inline double fuzz()
+      {
+	return (sizeof(REAL) == sizeof(float)) ? 1.0e-5 : 1.0e-13;
+      }
+
+      //! Gather a batch; unused lanes hold the unit matrix
+      template<typename W>
+      inline void load(MatT<W>& m, const LatticeColorMatrix& u, const int* sites, int n)
+      {
+	for(int l=0; l < lanes; ++l)
+	{
+	  if (l < n)
+	  {
+	    const int site = sites[l];
+	    for(int i=0; i < 3; ++i)
+	      for(int j=0; j < 3; ++j)
+	      {
+		m.re[i][j][l] = u.elem(site).elem().elem(i,j).real();
+		m.im[i][j][l] = u.elem(site).elem().elem(i,j).imag();
+	      }
+	  }
+	  else
+	  {
+	    for(int i=0; i < 3; ++i)
+	      for(int j=0; j < 3; ++j)
+	      {
+		m.re[i][j][l] = (i == j) ? 1 : 0;
+		m.im[i][j][l] = 0;
+	      }
+	  }
+	}
+      }
+
+      //! Scatter a batch
+      template<typename W>
+      inline void store(LatticeColorMatrix& u, const MatT<W>& m, const int* sites, int n)
+      {
+	for(int l=0; l < n; ++l)
+	{
+	  const int site = sites[l];
+	  for(int i=0; i < 3; ++i)
+	    for(int j=0; j < 3; ++j)
+	    {
+	      u.elem(site).elem().elem(i,j).real() = m.re[i][j][l];
+	      u.elem(site).elem().elem(i,j).imag() = m.im[i][j][l];
+	    }
+	}
+      }
+
+      //! c = a * b, c must not alias a or b
+      template<typename W>
+      inline void mult(MatT<W>& c, const MatT<W>& a, const MatT<W>& b)
+      {
+	for(int i=0; i < 3; ++i)
+	  for(int j=0; j < 3; ++j)
+	  {
+	    W* cr = c.re[i][j];
+	    W* ci = c.im[i][j];
+	    for(int l=0; l < lanes; ++l)
+	    {
+	      cr[l] = 0;
+	      ci[l] = 0;
+	    }
+	    for(int k=0; k < 3; ++k)
+	    {
+	      const W* ar = a.re[i][k];
+	      const W* ai = a.im[i][k];
+	      const W* br = b.re[k][j];
+	      const W* bi = b.im[k][j];
+	      for(int l=0; l < lanes; ++l)
+	      {
+		cr[l] += ar[l]*br[l] - ai[l]*bi[l];
+		ci[l] += ar[l]*bi[l] + ai[l]*br[l];
+	      }
+	    }
+	  }
+      }
+
+      //! r = exp(iQ) for traceless hermitian Q
+      template<typename W>
+      inline void expiQ(MatT<W>& r, const MatT<W>& Q)
+      {
+	MatT<W> QQ;
+	mult(QQ, Q, Q);
+
+	W c0[lanes], c1[lanes];
+	for(int l=0; l < lanes; ++l)
+	{
+	  c0[l] = 0;
+	  c1[l] = 0;
+	}
+	for(int i=0; i < 3; ++i)
+	{
+	  for(int l=0; l < lanes; ++l)
+	    c1[l] += QQ.re[i][i][l];
+
+	  for(int k=0; k < 3; ++k)
+	    for(int l=0; l < lanes; ++l)
+	      c0[l] += QQ.re[i][k][l]*Q.re[k][i][l] - QQ.im[i][k][l]*Q.im[k][i][l];
+	}
+
+	// The transcendentals and corner cases are per site
+	W f_re[3][lanes], f_im[3][lanes];
+	for(int l=0; l < lanes; ++l)
+	{
+	  W f[3][2], b1[3][2], b2[3][2];
+	  expCoeffs<W>(((W)1/(W)3)*c0[l], ((W)1/(W)2)*c1[l], f, b1, b2, false);
+	  for(int k=0; k < 3; ++k)
+	  {
+	    f_re[k][l] = f[k][0];
+	    f_im[k][l] = f[k][1];
+	  }
+	}
+
+	// r = f0 + f1 Q + f2 QQ
+	for(int i=0; i < 3; ++i)
+	  for(int j=0; j < 3; ++j)
+	    for(int l=0; l < lanes; ++l)
+	    {
+	      r.re[i][j][l] = f_re[1][l]*Q.re[i][j][l] - f_im[1][l]*Q.im[i][j][l]
+		+ f_re[2][l]*QQ.re[i][j][l] - f_im[2][l]*QQ.im[i][j][l];
+	      r.im[i][j][l] = f_re[1][l]*Q.im[i][j][l] + f_im[1][l]*Q.re[i][j][l]
+		+ f_re[2][l]*QQ.im[i][j][l] + f_im[2][l]*QQ.re[i][j][l];
+	    }
+
+	for(int i=0; i < 3; ++i)
+	  for(int l=0; l < lanes; ++l)
+	  {
+	    r.re[i][i][l] += f_re[0][l];
+	    r.im[i][i][l] += f_im[0][l];
+	  }
+      }
+
+      //! Reunitarise as in reunit(): normalise column 0, orthogonalise and
+      //! normalise column 1, column 2 from the conjugate cross product
+      /*! \return the number of lanes among the first n beyond the fuzz */
+      inline int reunitMat(Mat& a, int n)
+      {
+	double t1[lanes], t2_re[lanes], t2_im[lanes], t3[lanes];
+	double old_re[3][lanes], old_im[3][lanes];
+
+	for(int l=0; l < lanes; ++l)
+	  t1[l] = 0;
+	for(int c=0; c < 3; ++c)
+	  for(int l=0; l < lanes; ++l)
+	    t1[l] += a.re[c][0][l]*a.re[c][0][l] + a.im[c][0][l]*a.im[c][0][l];
+	for(int l=0; l < lanes; ++l)
+	  t1[l] = sqrt(t1[l]);
+
+	for(int c=0; c < 3; ++c)
+	  for(int l=0; l < lanes; ++l)
+	  {
+	    a.re[c][0][l] /= t1[l];
+	    a.im[c][0][l] /= t1[l];
+	  }
+
+	for(int l=0; l < lanes; ++l)
+	{
+	  t2_re[l] = 0;
+	  t2_im[l] = 0;
+	}
+	for(int c=0; c < 3; ++c)
+	  for(int l=0; l < lanes; ++l)
+	  {
+	    t2_re[l] += a.re[c][0][l]*a.re[c][1][l] + a.im[c][0][l]*a.im[c][1][l];
+	    t2_im[l] += a.re[c][0][l]*a.im[c][1][l] - a.im[c][0][l]*a.re[c][1][l];
+	  }
+
+	for(int c=0; c < 3; ++c)
+	  for(int l=0; l < lanes; ++l)
+	  {
+	    a.re[c][1][l] -= t2_re[l]*a.re[c][0][l] - t2_im[l]*a.im[c][0][l];
+	    a.im[c][1][l] -= t2_re[l]*a.im[c][0][l] + t2_im[l]*a.re[c][0][l];
+	  }
+
+	for(int l=0; l < lanes; ++l)
+	  t3[l] = 0;
+	for(int c=0; c < 3; ++c)
+	  for(int l=0; l < lanes; ++l)
+	    t3[l] += a.re[c][1][l]*a.re[c][1][l] + a.im[c][1][l]*a.im[c][1][l];
+	for(int l=0; l < lanes; ++l)
+	  t3[l] = sqrt(t3[l]);
+
+	for(int c=0; c < 3; ++c)
+	  for(int l=0; l < lanes; ++l)
+	  {
+	    a.re[c][1][l] /= t3[l];
+	    a.im[c][1][l] /= t3[l];
+	    old_re[c][l] = a.re[c][2][l];
+	    old_im[c][l] = a.im[c][2][l];
+	  }
+
+	// a(c,2) = conj( a(c+1,0) a(c+2,1) - a(c+2,0) a(c+1,1) )
+	for(int c=0; c < 3; ++c)
+	{
+	  const int c1 = (c+1) % 3;
+	  const int c2 = (c+2) % 3;
+	  for(int l=0; l < lanes; ++l)
+	  {
+	    a.re[c][2][l] =
+	      (a.re[c1][0][l]*a.re[c2][1][l] - a.im[c1][0][l]*a.im[c2][1][l]) -
+	      (a.re[c2][0][l]*a.re[c1][1][l] - a.im[c2][0][l]*a.im[c1][1][l]);
+	    a.im[c][2][l] =
+	      -(a.re[c1][0][l]*a.im[c2][1][l] + a.im[c1][0][l]*a.re[c2][1][l]) +
+	      (a.re[c2][0][l]*a.im[c1][1][l] + a.im[c2][0][l]*a.re[c1][1][l]);
+	  }
+	}
+
+	// Deviation:  sqrt( (1-t1)^2 + |t2|^2 + (1-t3)^2 + |old col 2 - new col 2|^2 )
+	const double fz = fuzz();
+	int numbad = 0;
+	for(int l=0; l < n; ++l)
+	{
+	  double sigmasq = (1-t1[l])*(1-t1[l]) + t2_re[l]*t2_re[l] + t2_im[l]*t2_im[l]
+	    + (1-t3[l])*(1-t3[l]);
+	  for(int c=0; c < 3; ++c)
+	  {
+	    double dr = old_re[c][l] - a.re[c][2][l];
+	    double di = old_im[c][l] - a.im[c][2][l];
+	    sigmasq += dr*dr + di*di;
+	  }
+	  if (sqrt(sigmasq) > fz)
+	    ++numbad;
+	}
+
+	return numbad;
+      }
+
+      //! a <- traceless antihermitian part of a
+      inline void taprojMat(Mat& a)
+      {
+	Mat b;
+	for(int i=0; i < 3; ++i)
+	  for(int j=0; j < 3; ++j)
+	    for(int l=0; l < lanes; ++l)
+	    {
+	      b.re[i][j][l] = 0.5*(a.re[i][j][l] - a.re[j][i][l]);
+	      b.im[i][j][l] = 0.5*(a.im[i][j][l] + a.im[j][i][l]);
+	    }
+
+	for(int l=0; l < lanes; ++l)
+	{
+	  double tr = (b.im[0][0][l] + b.im[1][1][l] + b.im[2][2][l]) / 3.0;
+	  for(int i=0; i < 3; ++i)
+	    b.im[i][i][l] -= tr;
+	}
+
+	a = b;
+      }
+
+      //! Re tr(a) per lane
+      inline void realTrace(double tr[lanes], const Mat& a)
+      {
+	for(int l=0; l < lanes; ++l)
+	  tr[l] = a.re[0][0][l] + a.re[1][1][l] + a.re[2][2][l];
+      }
+
+      //! Determinant per lane
+      inline void det(double d_re[lanes], double d_im[lanes], const Mat& a)
+      {
+	for(int l=0; l < lanes; ++l)
+	{
+	  d_re[l] = 0;
+	  d_im[l] = 0;
+	}
+	for(int j=0; j < 3; ++j)
+	{
+	  const int j1 = (j+1) % 3;
+	  const int j2 = (j+2) % 3;
+	  for(int l=0; l < lanes; ++l)
+	  {
+	    // cofactor C_0j = a_1j1 a_2j2 - a_1j2 a_2j1
+	    double c_re = a.re[1][j1][l]*a.re[2][j2][l] - a.im[1][j1][l]*a.im[2][j2][l]
+	      - a.re[1][j2][l]*a.re[2][j1][l] + a.im[1][j2][l]*a.im[2][j1][l];
+	    double c_im = a.re[1][j1][l]*a.im[2][j2][l] + a.im[1][j1][l]*a.re[2][j2][l]
+	      - a.re[1][j2][l]*a.im[2][j1][l] - a.im[1][j2][l]*a.re[2][j1][l];
+	    d_re[l] += a.re[0][j][l]*c_re - a.im[0][j][l]*c_im;
+	    d_im[l] += a.re[0][j][l]*c_im + a.im[0][j][l]*c_re;
+	  }
+	}
+      }
+
+
+      //! Site table shared by all kernels
+      struct Sites
+      {
+	Sites() : tab(all.siteTable().slice()), num(all.numSiteTable()) {}
+
+	const int* tab;
+	int num;
+      };
+
+
+      //----------------------------------------------------------------------
+      struct ExpiQMultArgs
+      {
+	LatticeColorMatrix& next;
+	const LatticeColorMatrix& Q;
+	const LatticeColorMatrix& u;
+	const int* tab;
+      };
+
+      void expiQMultLoop(int lo, int hi, int myId, ExpiQMultArgs* a)
+      {
+	MatT<REAL> Q, u, r, n;
+	for(int s=lo; s < hi; s += lanes)
+	{
+	  const int* sites = a->tab + s;
+	  const int nl = (hi - s < lanes) ? hi - s : lanes;
+
+	  load(Q, a->Q, sites, nl);
+	  load(u, a->u, sites, nl);
+	  expiQ(r, Q);
+	  mult(n, r, u);
+	  store(a->next, n, sites, nl);
+	}
+      }
+
+
+      //----------------------------------------------------------------------
+      struct ExpMultReunitArgs
+      {
+	LatticeColorMatrix& u;
+	const LatticeColorMatrix& p;
+	double eps;
+	bool reunitarize;
+	const int* tab;
+	multi1d<int>& numbad;
+      };
+
+      void expMultReunitLoop(int lo, int hi, int myId, ExpMultReunitArgs* a)
+      {
+	Mat p, u, r, n;
+	for(int s=lo; s < hi; s += lanes)
+	{
+	  const int* sites = a->tab + s;
+	  const int nl = (hi - s < lanes) ? hi - s : lanes;
+
+	  load(p, a->p, sites, nl);
+	  load(u, a->u, sites, nl);
+
+	  // exp(eps p) = exp(iQ)  with  Q = -i eps p
+	  for(int i=0; i < 3; ++i)
+	    for(int j=0; j < 3; ++j)
+	      for(int l=0; l < lanes; ++l)
+	      {
+		double re = p.re[i][j][l];
+		p.re[i][j][l] =  a->eps * p.im[i][j][l];
+		p.im[i][j][l] = -a->eps * re;
+	      }
+
+	  expiQ(r, p);
+	  mult(n, r, u);
+
+	  if (a->reunitarize)
+	    a->numbad[myId] += reunitMat(n, nl);
+
+	  store(a->u, n, sites, nl);
+	}
+      }
+
+
+      //----------------------------------------------------------------------
+      struct AddTaprojArgs
+      {
+	LatticeColorMatrix& p;
+	double eps;
+	const LatticeColorMatrix* f;
+	const int* tab;
+      };
+
+      void addTaprojLoop(int lo, int hi, int myId, AddTaprojArgs* a)
+      {
+	Mat p, f;
+	for(int s=lo; s < hi; s += lanes)
+	{
+	  const int* sites = a->tab + s;
+	  const int nl = (hi - s < lanes) ? hi - s : lanes;
+
+	  load(p, a->p, sites, nl);
+	  if (a->f != 0)
+	  {
+	    load(f, *(a->f), sites, nl);
+	    for(int i=0; i < 3; ++i)
+	      for(int j=0; j < 3; ++j)
+		for(int l=0; l < lanes; ++l)
+		{
+		  p.re[i][j][l] += a->eps * f.re[i][j][l];
+		  p.im[i][j][l] += a->eps * f.im[i][j][l];
+		}
+	  }
+
+	  taprojMat(p);
+	  store(a->p, p, sites, nl);
+	}
+      }
+
+
+      //----------------------------------------------------------------------
+      struct ReunitArgs
+      {
+	LatticeColorMatrix& u;
+	const int* tab;
+	multi1d<int>& numbad;
+      };
+
+      void reunitLoop(int lo, int hi, int myId, ReunitArgs* a)
+      {
+	Mat u;
+	for(int s=lo; s < hi; s += lanes)
+	{
+	  const int* sites = a->tab + s;
+	  const int nl = (hi - s < lanes) ? hi - s : lanes;
+
+	  load(u, a->u, sites, nl);
+	  a->numbad[myId] += reunitMat(u, nl);
+	  store(a->u, u, sites, nl);
+	}
+      }
+
+
+      //----------------------------------------------------------------------
+      struct MaxTraceArgs
+      {
+	const LatticeColorMatrix& w;
+	LatticeColorMatrix& v;
+	double accu;
+	int max_iter;
+	const int* tab;
+      };
+
+      void maxTraceLoop(int lo, int hi, int myId, MaxTraceArgs* a)
+      {
+	// The three SU(2) subgroups
+	const int sub_i[3] = {0, 0, 1};
+	const int sub_j[3] = {1, 2, 2};
+
+	Mat w, v, vw;
+	double old_tr[lanes], new_tr[lanes];
+
+	for(int s=lo; s < hi; s += lanes)
+	{
+	  const int* sites = a->tab + s;
+	  const int nl = (hi - s < lanes) ? hi - s : lanes;
+
+	  load(w, a->w, sites, nl);
+	  load(v, a->v, sites, nl);
+
+	  mult(vw, v, w);
+	  realTrace(old_tr, vw);
+
+	  for(int iter=0; iter < a->max_iter; ++iter)
+	  {
+	    for(int sub=0; sub < 3; ++sub)
+	    {
+	      const int i = sub_i[sub];
+	      const int j = sub_j[sub];
+
+	      for(int l=0; l < lanes; ++l)
+	      {
+		// g = g0 + i g.sigma maximising Re tr(g vw) on the (i,j) block
+		double g0 =  vw.re[i][i][l] + vw.re[j][j][l];
+		double g1 = -vw.im[i][j][l] - vw.im[j][i][l];
+		double g2 =  vw.re[j][i][l] - vw.re[i][j][l];
+		double g3 = -vw.im[i][i][l] + vw.im[j][j][l];
+		double nrm = sqrt(g0*g0 + g1*g1 + g2*g2 + g3*g3);
+		if (nrm == 0)
+		  continue;
+		g0 /= nrm; g1 /= nrm; g2 /= nrm; g3 /= nrm;
+
+		// Left multiply rows i and j of v and of vw by
+		//   [  g0 + i g3    g2 + i g1 ]
+		//   [ -g2 + i g1    g0 - i g3 ]
+		for(int k=0; k < 3; ++k)
+		{
+		  double xr = v.re[i][k][l], xi = v.im[i][k][l];
+		  double yr = v.re[j][k][l], yi = v.im[j][k][l];
+		  v.re[i][k][l] =  g0*xr - g3*xi + g2*yr - g1*yi;
+		  v.im[i][k][l] =  g0*xi + g3*xr + g2*yi + g1*yr;
+		  v.re[j][k][l] = -g2*xr - g1*xi + g0*yr + g3*yi;
+		  v.im[j][k][l] = -g2*xi + g1*xr + g0*yi - g3*yr;
+
+		  xr = vw.re[i][k][l]; xi = vw.im[i][k][l];
+		  yr = vw.re[j][k][l]; yi = vw.im[j][k][l];
+		  vw.re[i][k][l] =  g0*xr - g3*xi + g2*yr - g1*yi;
+		  vw.im[i][k][l] =  g0*xi + g3*xr + g2*yi + g1*yr;
+		  vw.re[j][k][l] = -g2*xr - g1*xi + g0*yr + g3*yi;
+		  vw.im[j][k][l] = -g2*xi + g1*xr + g0*yi - g3*yr;
+		}
+	      }
+	    }
+
+	    // Remove the rounding drift, as sun_proj does
+	    reunitMat(v, 0);
+	    mult(vw, v, w);
+	    realTrace(new_tr, vw);
+
+	    bool converged = true;
+	    for(int l=0; l < nl; ++l)
+	    {
+	      if (fabs(new_tr[l] - old_tr[l]) > a->accu * fabs(old_tr[l]))
+		converged = false;
+	      old_tr[l] = new_tr[l];
+	    }
+	    if (converged)
+	      break;
+	  }
+
+	  store(a->v, v, sites, nl);
+	}
+      }
+
+
+      //----------------------------------------------------------------------
+      struct PolarArgs
+      {
+	LatticeColorMatrix& v;
+	const LatticeColorMatrix& w;
+	const int* tab;
+      };
+
+      void polarLoop(int lo, int hi, int myId, PolarArgs* a)
+      {
+	Mat x, y;
+	double d_re[lanes], d_im[lanes];
+
+	for(int s=lo; s < hi; s += lanes)
+	{
+	  const int* sites = a->tab + s;
+	  const int nl = (hi - s < lanes) ? hi - s : lanes;
+
+	  load(x, a->w, sites, nl);
+
+	  // Newton iteration for the unitary polar factor:
+	  //   x <- ( x + x^{-dag} ) / 2,   x^{-dag} = conj(cofactor(x)) / conj(det x)
+	  for(int iter=0; iter < 50; ++iter)
+	  {
+	    det(d_re, d_im, x);
+
+	    double change = 0;
+	    for(int i=0; i < 3; ++i)
+	    {
+	      const int i1 = (i+1) % 3;
+	      const int i2 = (i+2) % 3;
+	      for(int j=0; j < 3; ++j)
+	      {
+		const int j1 = (j+1) % 3;
+		const int j2 = (j+2) % 3;
+		for(int l=0; l < lanes; ++l)
+		{
+		  double c_re = x.re[i1][j1][l]*x.re[i2][j2][l] - x.im[i1][j1][l]*x.im[i2][j2][l]
+		    - x.re[i1][j2][l]*x.re[i2][j1][l] + x.im[i1][j2][l]*x.im[i2][j1][l];
+		  double c_im = x.re[i1][j1][l]*x.im[i2][j2][l] + x.im[i1][j1][l]*x.re[i2][j2][l]
+		    - x.re[i1][j2][l]*x.im[i2][j1][l] - x.im[i1][j2][l]*x.re[i2][j1][l];
+
+		  // conj(c) / conj(d) = conj(c/d)
+		  double dd = d_re[l]*d_re[l] + d_im[l]*d_im[l];
+		  double q_re =  (c_re*d_re[l] + c_im*d_im[l]) / dd;
+		  double q_im = -(c_im*d_re[l] - c_re*d_im[l]) / dd;
+
+		  y.re[i][j][l] = 0.5*(x.re[i][j][l] + q_re);
+		  y.im[i][j][l] = 0.5*(x.im[i][j][l] + q_im);
+
+		  double dr = y.re[i][j][l] - x.re[i][j][l];
+		  double di = y.im[i][j][l] - x.im[i][j][l];
+		  change += dr*dr + di*di;
+		}
+	      }
+	    }
+
+	    x = y;
+	    if (change < 1.0e-28 * lanes)
+	      break;
+	  }
+
+	  // Remove the phase of the determinant
+	  det(d_re, d_im, x);
+	  for(int l=0; l < lanes; ++l)
+	  {
+	    double phi = -atan2(d_im[l], d_re[l]) / 3.0;
+	    double pr = cos(phi), pi = sin(phi);
+	    for(int i=0; i < 3; ++i)
+	      for(int j=0; j < 3; ++j)
+	      {
+		double re = x.re[i][j][l];
+		x.re[i][j][l] = re*pr - x.im[i][j][l]*pi;
+		x.im[i][j][l] = re*pi + x.im[i][j][l]*pr;
+	      }
+	  }
+
+	  store(a->v, x, sites, nl);
+	}
+      }
+
+
+      //! Sum per-thread counts over threads and nodes
+      int sumCounts(const multi1d<int>& n)
+      {
+	double tot = 0;
+	for(int i=0; i < n.size(); ++i)
+	  tot += n[i];
+	QDPInternal::globalSum(tot);
+	return int(tot);
+      }
+    }
+#endif
+
+
+    //! next = exp(iQ) u  for a traceless hermitian Q
+    void expiQMult(LatticeColorMatrix& next,
+		   const LatticeColorMatrix& Q,
+		   const LatticeColorMatrix& u)
+    {
+      START_CODE();
+
+#if ! defined(QDP_IS_QDPJIT) && QDP_NC == 3
+      Sites s;
+      ExpiQMultArgs args = {next, Q, u, s.tab};
+      dispatch_to_threads(s.num, args, expiQMultLoop);
+#else
+      LatticeColorMatrix QQ = Q*Q;
+      multi1d<LatticeComplex> f;
+      Stouting::getFs(Q, QQ, f);
+      next = (f[0] + f[1]*Q + f[2]*QQ)*u;
+#endif
+
+      END_CODE();
+    }
+
+
+    //! u <- reunit( exp(eps p) u )  for a traceless antihermitian p
+    int expMultReunit(LatticeColorMatrix& u,
+		      const LatticeColorMatrix& p,
+		      const Real& eps,
+		      bool reunitarize)
+    {
+      START_CODE();
+
+      int numbad = 0;
+
+#if ! defined(QDP_IS_QDPJIT) && QDP_NC == 3
+      Sites s;
+      multi1d<int> nbad(qdpNumThreads());
+      nbad = 0;
+      ExpMultReunitArgs args = {u, p, toDouble(eps), reunitarize, s.tab, nbad};
+      dispatch_to_threads(s.num, args, expMultReunitLoop);
+      numbad = sumCounts(nbad);
+#else
+      LatticeColorMatrix tmp_1 = eps*p;
+      if (Nc != 3) expmat(tmp_1, EXP_TWELFTH_ORDER);
+      else expmat(tmp_1, EXP_EXACT);
+
+      LatticeColorMatrix tmp_2 = tmp_1*u;
+      u = tmp_2;
+
+      if (reunitarize)
+	Chroma::reunit(u, numbad, REUNITARIZE_LABEL);
+#endif
+
+      END_CODE();
+
+      return numbad;
+    }
+
+
+    //! p <- taproj( p + eps f )
+    void addTaproj(LatticeColorMatrix& p,
+		   const Real& eps,
+		   const LatticeColorMatrix& f)
+    {
+      START_CODE();
+
+#if ! defined(QDP_IS_QDPJIT) && QDP_NC == 3
+      Sites s;
+      AddTaprojArgs args = {p, toDouble(eps), &f, s.tab};
+      dispatch_to_threads(s.num, args, addTaprojLoop);
+#else
+      p += eps*f;
+      Chroma::taproj(p);
+#endif
+
+      END_CODE();
+    }
+
+
+    //! Traceless antihermitian projection in place
+    void taproj(LatticeColorMatrix& a)
+    {
+      START_CODE();
+
+#if ! defined(QDP_IS_QDPJIT) && QDP_NC == 3
+      Sites s;
+      AddTaprojArgs args = {a, 0.0, 0, s.tab};
+      dispatch_to_threads(s.num, args, addTaprojLoop);
+#else
+      Chroma::taproj(a);
+#endif
+
+      END_CODE();
+    }
+
+
+    //! Reunitarise in place
+    int reunit(LatticeColorMatrix& u)
+    {
+      START_CODE();
+
+      int numbad = 0;
+
+#if ! defined(QDP_IS_QDPJIT) && QDP_NC == 3
+      Sites s;
+      multi1d<int> nbad(qdpNumThreads());
+      nbad = 0;
+      ReunitArgs args = {u, s.tab, nbad};
+      dispatch_to_threads(s.num, args, reunitLoop);
+      numbad = sumCounts(nbad);
+#else
+      Chroma::reunit(u, numbad, REUNITARIZE_LABEL);
+#endif
+
+      END_CODE();
+
+      return numbad;
+    }
+
+
+    //! Project w onto SU(3) by maximising Re tr(v w)
+    void maxTraceProject(const LatticeColorMatrix& w,
+			 LatticeColorMatrix& v,
+			 const Real& BlkAccu,
+			 int BlkMax)
+    {
+      START_CODE();
+
+#if ! defined(QDP_IS_QDPJIT) && QDP_NC == 3
+      Sites s;
+      MaxTraceArgs args = {w, v, toDouble(BlkAccu), BlkMax, s.tab};
+      dispatch_to_threads(s.num, args, maxTraceLoop);
+#else
+      sun_proj(w, v, BlkAccu, BlkMax);
+#endif
+
+      END_CODE();
+    }
+
+
+    //! Polar projection onto SU(3)
+    void polarProject(LatticeColorMatrix& v,
+		      const LatticeColorMatrix& w)
+    {
+      START_CODE();
+
+#if ! defined(QDP_IS_QDPJIT) && QDP_NC == 3
+      Sites s;
+      PolarArgs args = {v, w, s.tab};
+      dispatch_to_threads(s.num, args, polarLoop);
+#else
+      // The Jacobi accuracy that HISQ has always used
+      LatticeColorMatrix c = w;
+      LatticeReal alpha;
+      polar_dec(c, v, alpha, Real(1.0e-11), 100);
+#endif
+
+      END_CODE();
+    }
+
+  } // namespace SU3Batch
+
+}  // end namespace Chroma
@@ -0,0 +1,98 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Batched site-local SU(3) kernels: exponential, projections, reunitarisation
+ *
+ *  The kernels gather a batch of sites into structure-of-arrays form so the
+ *  colour algebra runs across sites in the innermost loop, and fuse whole
+ *  sequences of lattice-wide passes (e.g.  U <- reunit(exp(eps P) U) ) into
+ *  one sweep over the links.
+ *
+ *  For Nc != 3, or with QDP-JIT, the kernels fall back to the existing
+ *  whole-lattice routines.
+ */
+
+#ifndef __su3_batch_h__
+#define __su3_batch_h__
+
+#include "chromabase.h"
+
+namespace Chroma
+{
+
+  //! Batched site-local SU(3) kernels
+  /*! \ingroup gauge */
+  namespace SU3Batch
+  {
+    //! Cayley-Hamilton coefficients of exp(iQ) for a traceless hermitian Q
+    /*!
+     * exp(iQ) = f0 + f1 Q + f2 Q^2  with  c0 = tr(Q^3)/3  and  c1 = tr(Q^2)/2.
+     * If dobs is set, also the derivatives  b1_j = df_j/dc1  and  b2_j = df_j/dc0
+     * (hep-lat/0311018, eqs. 29-33), including the small-c1 and c0 -> c0max
+     * corner cases.
+     *
+     * \param c0      tr(Q^3)/3                  ( Read )
+     * \param c1      tr(Q^2)/2                  ( Read )
+     * \param f       f_j as {re,im}             ( Write )
+     * \param b1      b1_j as {re,im}            ( Write )
+     * \param b2      b2_j as {re,im}            ( Write )
+     * \param dobs    compute the b's            ( Read )
+     *
+     * Instantiated for float and double. The stout smearing and force use
+     * the lattice precision REAL, as the code this replaced did.
+     */
+    template<typename R>
+    void expCoeffs(R c0, R c1,
+		   R f[3][2], R b1[3][2], R b2[3][2],
+		   bool dobs);
+
+    //! next = exp(iQ) u  for a traceless hermitian Q, in the lattice precision
+    void expiQMult(LatticeColorMatrix& next,
+		   const LatticeColorMatrix& Q,
+		   const LatticeColorMatrix& u);
+
+    //! u <- reunit( exp(eps p) u )  for a traceless antihermitian p
+    /*!
+     * \return the number of links that violated unitarity before
+     *         reunitarisation (0 if reunitarize is false)
+     */
+    int expMultReunit(LatticeColorMatrix& u,
+		      const LatticeColorMatrix& p,
+		      const Real& eps,
+		      bool reunitarize);
+
+    //! p <- taproj( p + eps f )
+    void addTaproj(LatticeColorMatrix& p,
+		   const Real& eps,
+		   const LatticeColorMatrix& f);
+
+    //! Traceless antihermitian projection in place
+    void taproj(LatticeColorMatrix& a);
+
+    //! Reunitarise in place
+    /*! \return the number of links whose deviation from SU(3) exceeds the precision fuzz */
+    int reunit(LatticeColorMatrix& u);
+
+    //! Project w onto SU(3) by maximising Re tr(v w)
+    /*!
+     * Like sun_proj, but each site iterates the SU(2) subgroup sweeps until
+     * its own trace has converged to BlkAccu, or BlkMax sweeps are done.
+     *
+     * \param w        matrix to project          ( Read )
+     * \param v        starting guess, result     ( Modify )
+     * \param BlkAccu  relative accuracy          ( Read )
+     * \param BlkMax   maximum number of sweeps   ( Read )
+     */
+    void maxTraceProject(const LatticeColorMatrix& w,
+			 LatticeColorMatrix& v,
+			 const Real& BlkAccu,
+			 int BlkMax);
+
+    //! Polar projection onto SU(3):  v = w (w^dag w)^{-1/2} / det^{1/3}
+    /*! The phase of the determinant is removed on the same branch as polar_dec */
+    void polarProject(LatticeColorMatrix& v,
+		      const LatticeColorMatrix& w);
+  }
+
+}  // end namespace Chroma
+
+#endif
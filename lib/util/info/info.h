@@ -17,6 +17,7 @@
 
 #include "proginfo.h"
 #include "printgeom.h"
+#include "perf_counters.h"
 
 #endif
 
@@ -0,0 +1,290 @@
+/*! \file
+ *  \brief Per-kernel call, time, flop and byte counters with trace export
+ */
+
+#include "chromabase.h"
+#include "util/info/perf_counters.h"
+
+#include <sys/time.h>
+#include <map>
+#include <vector>
+#include <fstream>
+#include <iomanip>
+#include <cstdio>
+
+namespace Chroma
+{
+
+  namespace PerfCounters
+  {
+    namespace
+    {
+      //! Totals for one (scope, kernel) pair
+      struct Totals
+      {
+	Totals() : calls(0), secs(0), flops(0), bytes(0) {}
+
+	unsigned long calls;
+	double        secs;
+	double        flops;
+	double        bytes;
+      };
+
+      //! One complete trace event
+      struct Event
+      {
+	std::string name;
+	std::string cat;
+	double      ts;      /*!< start in microseconds */
+	double      dur;     /*!< duration in microseconds */
+	double      flops;
+	double      bytes;
+      };
+
+      bool is_enabled = false;
+      std::string trace_file;
+
+      //! Stop collecting events beyond this count to bound memory
+      const size_t max_events = 1000000;
+      size_t dropped_events = 0;
+
+      double t0 = 0;
+
+      std::vector<std::string> scopes;
+      std::map< std::pair<std::string,std::string>, Totals > totals;
+      std::vector<Event> events;
+
+
+      //! Wall clock in seconds
+      double now()
+      {
+	struct timeval t;
+	gettimeofday(&t, NULL);
+	return double(t.tv_sec) + 1.0e-6*double(t.tv_usec);
+      }
+
+      //! Full name of the current scope
+      std::string currentScope()
+      {
+	if (scopes.size() == 0)
+	  return "global";
+
+	std::string s = scopes[0];
+	for(int i=1; i < scopes.size(); ++i)
+	  s += "/" + scopes[i];
+	return s;
+      }
+
+      //! Append an event to the trace
+      void addEvent(const std::string& name, const std::string& cat,
+		    double start, double secs, double flops, double bytes)
+      {
+	if (trace_file == "")
+	  return;
+
+	if (events.size() >= max_events)
+	{
+	  ++dropped_events;
+	  return;
+	}
+
+	Event e;
+	e.name  = name;
+	e.cat   = cat;
+	e.ts    = 1.0e6*(start - t0);
+	e.dur   = 1.0e6*secs;
+	e.flops = flops;
+	e.bytes = bytes;
+	events.push_back(e);
+      }
+
+      //! Escape a std::string for JSON
+      std::string jsonString(const std::string& s)
+      {
+	std::string r = "\"";
+	for(int i=0; i < s.size(); ++i)
+	{
+	  char c = s[i];
+	  if (c == '"' || c == '\\')
+	    r += '\\';
+	  if (c == '\n')
+	    r += "\\n";
+	  else
+	    r += c;
+	}
+	r += "\"";
+	return r;
+      }
+    }
+
+
+    //! Turn on recording
+    void enable(const std::string& trace_file_)
+    {
+      is_enabled = true;
+      trace_file = trace_file_;
+      t0 = now();
+    }
+
+    //! Is recording on?
+    bool enabled()
+    {
+      return is_enabled;
+    }
+
+    //! Record one or more calls of a kernel
+    void record(const char* kernel, double secs, double flops, double bytes,
+		unsigned long calls)
+    {
+      if (! is_enabled)
+	return;
+
+      Totals& t = totals[std::make_pair(currentScope(), std::string(kernel))];
+      t.calls += calls;
+      t.secs  += secs;
+      t.flops += flops;
+      t.bytes += bytes;
+    }
+
+
+    //! Start timing a kernel
+    Region::Region(const char* kernel_, double flops_, double bytes_, const char* cat_) :
+      kernel(kernel_), cat(cat_), flops(flops_), bytes(bytes_), start(0)
+    {
+      if (is_enabled)
+	start = now();
+    }
+
+    //! Record the kernel
+    Region::~Region()
+    {
+      if (! is_enabled)
+	return;
+
+      double secs = now() - start;
+      record(kernel, secs, flops, bytes);
+      addEvent(kernel, cat, start, secs, flops, bytes);
+    }
+
+
+    //! Enter a scope
+    Scope::Scope(const std::string& name) : start(0)
+    {
+      if (! is_enabled)
+	return;
+
+      scopes.push_back(name);
+      start = now();
+    }
+
+    //! Leave a scope
+    Scope::~Scope()
+    {
+      if (! is_enabled)
+	return;
+
+      double secs = now() - start;
+      std::string name = scopes.back();
+      addEvent(name, "scope", start, secs, 0, 0);
+      record("total", secs, 0, 0);
+      scopes.pop_back();
+    }
+
+
+    //! Print the summary table and write it to xml
+    void report(XMLWriter& xml, const std::string& path)
+    {
+      if (! is_enabled)
+	return;
+
+      QDPIO::cout << "PerfCounters: summary (flops and bytes summed over nodes)" << std::endl;
+      QDPIO::cout << std::setw(40) << std::left << "scope"
+		  << std::setw(24) << "kernel" << std::right
+		  << std::setw(10) << "calls"
+		  << std::setw(12) << "secs"
+		  << std::setw(12) << "GFlop/s"
+		  << std::setw(12) << "GB/s"
+		  << std::endl;
+
+      push(xml, path);
+      for(std::map< std::pair<std::string,std::string>, Totals >::const_iterator p = totals.begin();
+	  p != totals.end();
+	  ++p)
+      {
+	const Totals& t = p->second;
+
+	// Nodes run in lock step, so the calls and times agree up to noise
+	double flops = t.flops;
+	double bytes = t.bytes;
+	QDPInternal::globalSum(flops);
+	QDPInternal::globalSum(bytes);
+
+	double gflops = (t.secs > 0) ? 1.0e-9*flops/t.secs : 0.0;
+	double gbytes = (t.secs > 0) ? 1.0e-9*bytes/t.secs : 0.0;
+
+	QDPIO::cout << std::setw(40) << std::left << p->first.first
+		    << std::setw(24) << p->first.second << std::right
+		    << std::setw(10) << t.calls
+		    << std::setw(12) << std::setprecision(4) << t.secs
+		    << std::setw(12) << std::setprecision(4) << gflops
+		    << std::setw(12) << std::setprecision(4) << gbytes
+		    << std::endl;
+
+	push(xml, "elem");
+	write(xml, "scope", p->first.first);
+	write(xml, "kernel", p->first.second);
+	write(xml, "calls", int(t.calls));
+	write(xml, "secs", t.secs);
+	write(xml, "flops", flops);
+	write(xml, "bytes", bytes);
+	write(xml, "GFlops", gflops);
+	write(xml, "GBytes", gbytes);
+	pop(xml);
+      }
+      pop(xml);
+    }
+
+
+    //! Write the collected trace as Chrome trace JSON
+    void writeTrace()
+    {
+      if (! is_enabled || trace_file == "")
+	return;
+
+      if (Layout::primaryNode())
+      {
+	std::ofstream f(trace_file.c_str());
+	if (! f)
+	{
+	  QDPIO::cerr << "PerfCounters: cannot open trace file " << trace_file << std::endl;
+	  return;
+	}
+
+	f << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	for(int i=0; i < events.size(); ++i)
+	{
+	  const Event& e = events[i];
+	  f << "{\"name\":" << jsonString(e.name)
+	    << ",\"cat\":" << jsonString(e.cat)
+	    << ",\"ph\":\"X\",\"pid\":0,\"tid\":0"
+	    << std::fixed << std::setprecision(3)
+	    << ",\"ts\":" << e.ts
+	    << ",\"dur\":" << e.dur
+	    << std::scientific << std::setprecision(6)
+	    << ",\"args\":{\"flops\":" << e.flops << ",\"bytes\":" << e.bytes << "}}";
+	  if (i+1 < events.size())
+	    f << ",";
+	  f << "\n";
+	}
+	f << "]}\n";
+      }
+
+      if (dropped_events > 0)
+	QDPIO::cout << "PerfCounters: trace truncated, dropped " << dropped_events << " events" << std::endl;
+
+      QDPIO::cout << "PerfCounters: wrote trace to " << trace_file << std::endl;
+    }
+
+  } // namespace PerfCounters
+
+}  // end namespace Chroma
@@ -0,0 +1,124 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Per-kernel call, time, flop and byte counters with trace export
+ *
+ *  Counters are keyed by the kernel name and the enclosing scope (the
+ *  inline measurement or monomial being evaluated). Nothing is recorded
+ *  unless the counters have been enabled, e.g. with the -perf-trace
+ *  command line option.
+ *
+ *  Kernel names are not copied until a call is recorded, so they must be
+ *  string literals. A disabled region then costs one branch.
+ *
+ *  Chroma's own halo exchanges and global sums are recorded as the
+ *  "halo" and "global_sum" kernels through HaloRegion and
+ *  ReductionRegion. Those done inside QDP (shifts, norm2, innerProduct)
+ *  cannot be hooked, and their time is part of the enclosing region.
+ */
+
+#ifndef __perf_counters_h__
+#define __perf_counters_h__
+
+#include "chromabase.h"
+#include <string>
+
+namespace Chroma
+{
+
+  //! Performance counters
+  /*! \ingroup info */
+  namespace PerfCounters
+  {
+    //! Turn on recording. A non-empty trace_file also collects a Chrome/Perfetto trace
+    void enable(const std::string& trace_file);
+
+    //! Is recording on?
+    bool enabled();
+
+    //! Record one or more calls of a kernel
+    /*!
+     * \param kernel   kernel name ( Read )
+     * \param secs     wall-clock time of all calls ( Read )
+     * \param flops    flops of all calls, on this node ( Read )
+     * \param bytes    bytes moved by all calls, on this node ( Read )
+     * \param calls    number of calls ( Read )
+     */
+    void record(const char* kernel, double secs, double flops, double bytes,
+		unsigned long calls = 1);
+
+    //! Bytes of one lattice field on the sites of a subset on this node
+    template<typename T>
+    double fieldBytes(const OLattice<T>& f, const Subset& s)
+    {
+      return double(s.numSiteTable()) * double(sizeof(T));
+    }
+
+
+    //! Timed region for a kernel
+    /*! 
+     * The call is recorded when the region goes out of scope. The category
+     * groups the events in the trace.
+     */
+    class Region
+    {
+    public:
+      Region(const char* kernel_, double flops_ = 0, double bytes_ = 0,
+	     const char* cat_ = "kernel");
+      ~Region();
+
+      //! Add flops to this call
+      void addFlops(double f) {flops += f;}
+
+      //! Add bytes to this call
+      void addBytes(double b) {bytes += b;}
+
+    private:
+      const char* kernel;
+      const char* cat;
+      double      flops;
+      double      bytes;
+      double      start;
+    };
+
+
+    //! Timed halo exchange
+    /*! \param bytes_  bytes sent by this node */
+    class HaloRegion : public Region
+    {
+    public:
+      HaloRegion(double bytes_) : Region("halo", 0, bytes_, "comm") {}
+    };
+
+
+    //! Timed global sum
+    /*! \param n  number of doubles summed */
+    class ReductionRegion : public Region
+    {
+    public:
+      ReductionRegion(int n) : Region("global_sum", 0, double(n)*sizeof(double), "comm") {}
+    };
+
+
+    //! Enclosing scope (inline measurement, monomial) for all kernels recorded within
+    class Scope
+    {
+    public:
+      Scope(const std::string& name);
+      ~Scope();
+
+    private:
+      double start;
+    };
+
+
+    //! Print the summary table and write it to xml
+    void report(XMLWriter& xml, const std::string& path);
+
+    //! Write the collected trace, if any, as Chrome trace JSON
+    void writeTrace();
+
+  } // namespace PerfCounters
+
+}  // end namespace Chroma
+
+#endif
@@ -0,0 +1,774 @@
+/*! \file
+ *  \brief Micro-benchmarks of the main kernels
+ *
+ *  Input (read from the -i file, default DATA):
+ *
+ *  <ChromaBench>
+ *    <Param>
+ *      <nrow>8 8 8 16</nrow>
+ *      <MinTime>1.0</MinTime>          optional: seconds spent on each kernel
+ *      <N5>8</N5>                      optional: DWF fifth dimension
+ *      <SolverIters>20</SolverIters>   optional: iterations per solver call
+ *      <QIOFile>./chroma_bench.lime</QIOFile>   optional: scratch file
+ *      <Benchmarks>                    optional: default is all of them
+ *        <elem>STREAM</elem>
+ *        <elem>WILSON_DSLASH</elem>
+ *        ...
+ *      </Benchmarks>
+ *    </Param>
+ *    <JSONFile>chroma_bench.json</JSONFile>
+ *  </ChromaBench>
+ *
+ *  Lattice sizes are swept by chroma_bench_sweep.sh, which runs the
+ *  program once per size; thread counts are swept by running once per
+ *  point, and precisions by building against single and double
+ *  precision QDP++.
+ *  Every JSON file records the lattice, precision, nodes and threads.
+ *
+ *  Flops and bytes are per call and summed over nodes. Bytes are the
+ *  compulsory traffic, each field touched being read or written once, so
+ *  GB/s is a lower bound on the achieved bandwidth. It is quoted against
+ *  the STREAM triad measured in the same run.
+ */
+
+#include "chroma.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+
+using namespace Chroma;
+
+namespace
+{
+  //! A benchmarked kernel
+  class BenchKernel
+  {
+  public:
+    virtual ~BenchKernel() {}
+
+    //! Make one call
+    virtual void operator()() = 0;
+
+    //! Flops of one call on this node, 0 if not known
+    virtual double flops() const = 0;
+
+    //! Compulsory bytes of one call on this node
+    virtual double bytes() const = 0;
+  };
+
+
+  //! Timing of one kernel
+  struct BenchResult
+  {
+    std::string name;
+    int         calls;
+    double      secs;     /*!< per call */
+    double      flops;    /*!< per call, all nodes */
+    double      bytes;    /*!< per call, all nodes */
+  };
+
+
+  //! Sizes of the fields on this node
+  double sites()        {return double(Layout::sitesOnNode());}
+  double realBytes()    {return double(sizeof(REAL));}
+  double fermBytes()    {return 2*Nc*Ns*realBytes();}
+  double propBytes()    {return 2*Nc*Nc*Ns*Ns*realBytes();}
+  double linkBytes()    {return Nd*2*Nc*Nc*realBytes()*sites();}
+
+
+  //! Average time over nodes, so all nodes agree on the call count
+  double nodeAverage(double secs)
+  {
+    QDPInternal::globalSum(secs);
+    return secs / double(Layout::numNodes());
+  }
+
+
+  //! Time a kernel for at least min_time seconds
+  BenchResult runKernel(const std::string& name, BenchKernel& kernel, double min_time)
+  {
+    QDPIO::cout << "BENCH: " << name << std::endl;
+
+    // Warm up and find the call count
+    StopWatch swatch;
+    int calls = 1;
+    double secs = 0;
+    for(;;)
+    {
+      swatch.reset();
+      swatch.start();
+      for(int i=0; i < calls; ++i)
+	kernel();
+      swatch.stop();
+
+      secs = nodeAverage(swatch.getTimeInSeconds());
+      if (secs >= min_time || calls >= (1 << 24))
+	break;
+
+      calls *= 2;
+    }
+
+    // The timed run
+    swatch.reset();
+    swatch.start();
+    for(int i=0; i < calls; ++i)
+      kernel();
+    swatch.stop();
+
+    BenchResult res;
+    res.name  = name;
+    res.calls = calls;
+    res.secs  = nodeAverage(swatch.getTimeInSeconds()) / double(calls);
+    res.flops = kernel.flops();
+    res.bytes = kernel.bytes();
+    QDPInternal::globalSum(res.flops);
+    QDPInternal::globalSum(res.bytes);
+
+    QDPIO::cout << "BENCH: " << name << " calls= " << calls
+		<< " secs/call= " << res.secs
+		<< " GFlop/s= " << 1.0e-9*res.flops/res.secs
+		<< " GB/s= " << 1.0e-9*res.bytes/res.secs << std::endl;
+
+    return res;
+  }
+
+
+  //! STREAM triad
+  class StreamTriad : public BenchKernel
+  {
+  public:
+    StreamTriad()
+    {
+      gaussian(psi);
+      gaussian(eta);
+      a = 0.5;
+    }
+
+    void operator()() {chi = psi + a*eta;}
+    double flops() const {return 4*Nc*Ns*sites();}
+    double bytes() const {return 3*fermBytes()*sites();}
+
+  private:
+    LatticeFermion chi, psi, eta;
+    Real a;
+  };
+
+
+  //! Wilson dslash on one checkerboard
+  class WilsonDslashKernel : public BenchKernel
+  {
+  public:
+    WilsonDslashKernel(Handle< FermState<LatticeFermion,
+		       multi1d<LatticeColorMatrix>,
+		       multi1d<LatticeColorMatrix> > > fs) : D(fs)
+    {
+      gaussian(psi);
+    }
+
+    void operator()() {D.apply(chi, psi, PLUS, 0);}
+    double flops() const {return double(D.nFlops())*sites()/2;}
+    double bytes() const {return linkBytes() + 2*fermBytes()*sites()/2;}
+
+  private:
+    WilsonDslash D;
+    LatticeFermion chi, psi;
+  };
+
+
+  //! Clover term apply on one checkerboard
+  class CloverApply : public BenchKernel
+  {
+  public:
+    CloverApply(const QDPCloverTerm& clov_) : clov(clov_)
+    {
+      gaussian(psi);
+    }
+
+    void operator()() {clov.apply(chi, psi, PLUS, 0);}
+    double flops() const {return double(clov.nFlops())*sites()/2;}
+    double bytes() const
+    {
+      return (double(sizeof(PrimitiveClovTriang<REAL>)) + 2*fermBytes())*sites()/2;
+    }
+
+  private:
+    const QDPCloverTerm& clov;
+    LatticeFermion chi, psi;
+  };
+
+
+  //! Clover term inverse on one checkerboard
+  /*! The blocks are inverted in place, so each call first copies the
+   *  term back from the saved one */
+  class CloverInverse : public BenchKernel
+  {
+  public:
+    CloverInverse(Handle< FermState<LatticeFermion,
+		  multi1d<LatticeColorMatrix>,
+		  multi1d<LatticeColorMatrix> > > fs_,
+		  const CloverFermActParams& param_,
+		  const QDPCloverTerm& clov_) : fs(fs_), param(param_), clov(clov_) {}
+
+    void operator()()
+    {
+      inv.create(fs, param, clov);
+      inv.choles(0);
+    }
+
+    //! Estimate: LDL^dag and inverse of two hermitian 6x6 blocks
+    double flops() const {return 4608*sites()/2;}
+
+    //! The copy of the whole term, then the inverse in place
+    double bytes() const {return 3*double(sizeof(PrimitiveClovTriang<REAL>))*sites();}
+
+  private:
+    Handle< FermState<LatticeFermion,
+		      multi1d<LatticeColorMatrix>,
+		      multi1d<LatticeColorMatrix> > > fs;
+    CloverFermActParams param;
+    const QDPCloverTerm& clov;
+    QDPCloverTerm inv;
+  };
+
+
+  //! Unpreconditioned domain wall operator
+  class DWFKernel : public BenchKernel
+  {
+  public:
+    DWFKernel(Handle< FermState<LatticeFermion,
+	      multi1d<LatticeColorMatrix>,
+	      multi1d<LatticeColorMatrix> > > fs, int N5_) :
+      A(fs, Real(1.8), Real(0.01), N5_, AnisoParam_t()), N5(N5_), chi(N5_), psi(N5_)
+    {
+      for(int s=0; s < N5; ++s)
+	gaussian(psi[s]);
+    }
+
+    void operator()() {A(chi, psi, PLUS);}
+
+    //! Wilson hop plus the fifth dimension terms on every 5-d site
+    double flops() const {return double(N5)*(1320 + 8*Nc*Ns)*sites();}
+    double bytes() const {return linkBytes() + 2*double(N5)*fermBytes()*sites();}
+
+  private:
+    UnprecDWLinOpArray A;
+    int N5;
+    multi1d<LatticeFermion> chi, psi;
+  };
+
+
+  //! Compulsory bytes of one even-odd preconditioned Wilson application
+  double eoWilsonBytes()
+  {
+    return 2*linkBytes() + 5*fermBytes()*sites()/2;
+  }
+
+
+  //! Fixed number of CG iterations on the even-odd Wilson operator
+  class CGKernel : public BenchKernel
+  {
+  public:
+    CGKernel(Handle< FermState<LatticeFermion,
+	     multi1d<LatticeColorMatrix>,
+	     multi1d<LatticeColorMatrix> > > fs, int iters_) :
+      M(fs, Real(0.1)), iters(iters_)
+    {
+      gaussian(chi);
+    }
+
+    void operator()()
+    {
+      psi = zero;
+      InvCG2(M, chi, psi, Real(1.0e-30), iters);
+    }
+
+    double flops() const {return double(iters)*(2*double(M.nFlops()) + 20*Nc*Ns*sites()/2);}
+    double bytes() const {return double(iters)*(2*eoWilsonBytes() + 11*fermBytes()*sites()/2);}
+
+  private:
+    EvenOddPrecWilsonLinOp M;
+    int iters;
+    LatticeFermion chi, psi;
+  };
+
+
+  //! Fixed number of BiCGStab iterations on the even-odd Wilson operator
+  class BiCGStabKernel : public BenchKernel
+  {
+  public:
+    BiCGStabKernel(Handle< FermState<LatticeFermion,
+		   multi1d<LatticeColorMatrix>,
+		   multi1d<LatticeColorMatrix> > > fs, int iters_) :
+      M(fs, Real(0.1)), iters(iters_)
+    {
+      gaussian(chi);
+    }
+
+    void operator()()
+    {
+      psi = zero;
+      InvBiCGStab(M, chi, psi, Real(1.0e-30), iters, PLUS);
+    }
+
+    double flops() const {return double(iters)*(2*double(M.nFlops()) + 80*Nc*Ns*sites()/2);}
+    double bytes() const {return double(iters)*(2*eoWilsonBytes() + 20*fermBytes()*sites()/2);}
+
+  private:
+    EvenOddPrecWilsonLinOp M;
+    int iters;
+    LatticeFermion chi, psi;
+  };
+
+
+  //! One level of isotropic stout smearing
+  class StoutKernel : public BenchKernel
+  {
+  public:
+    StoutKernel(const multi1d<LatticeColorMatrix>& u_) :
+      u(u_), u_smr(Nd), smear_dirs(Nd), rho(Nd,Nd)
+    {
+      smear_dirs = true;
+      for(int mu=0; mu < Nd; ++mu)
+	for(int nu=0; nu < Nd; ++nu)
+	  rho(mu,nu) = (mu == nu) ? Real(0) : Real(0.1);
+    }
+
+    void operator()() {Stouting::smear_links(u, u_smr, smear_dirs, rho);}
+
+    //! Estimate: six staples and the exponential per link
+    double flops() const {return Nd*3400*sites();}
+    double bytes() const {return 2*linkBytes();}
+
+  private:
+    const multi1d<LatticeColorMatrix>& u;
+    multi1d<LatticeColorMatrix> u_smr;
+    multi1d<bool> smear_dirs;
+    multi2d<Real> rho;
+  };
+
+
+  //! Meson two-point contractions for all 16 gammas
+  class MesonKernel : public BenchKernel
+  {
+  public:
+    MesonKernel(const LatticePropagator& prop_, const SftMom& phases_) :
+      prop(prop_), phases(phases_) {}
+
+    void operator()()
+    {
+      XMLBufferWriter xml;
+      mesons(prop, prop, phases, 0, xml, "Mesons");
+    }
+
+    //! Trace of a 12x12 product per gamma, then the projection
+    double flops() const {return Ns*Ns*(8*144 + 8*phases.numMom())*sites();}
+    double bytes() const {return propBytes()*sites();}
+
+  private:
+    const LatticePropagator& prop;
+    const SftMom& phases;
+  };
+
+
+  //! Baryon two-point contractions
+  class BaryonKernel : public BenchKernel
+  {
+  public:
+    BaryonKernel(const LatticePropagator& prop_, const SftMom& phases_) :
+      prop(prop_), phases(phases_) {}
+
+    void operator()()
+    {
+      XMLBufferWriter xml;
+      baryon(prop, phases, 0, 1, false, xml, "Baryons");
+    }
+
+    //! Estimate: 19 contractions and the projection of 22 baryons
+    /*! The other 3 baryons are multiples. A contraction is 6768 complex
+     *  multiply-adds per site: two spin matrix products, the diquark and
+     *  two propagator products */
+    double flops() const {return (19*8*6768 + 22*8*phases.numMom())*sites();}
+    double bytes() const {return propBytes()*sites();}
+
+  private:
+    const LatticePropagator& prop;
+    const SftMom& phases;
+  };
+
+
+  //! Epsilon contraction of three colour matrices
+  class ColorContractKernel : public BenchKernel
+  {
+  public:
+    ColorContractKernel(const multi1d<LatticeColorMatrix>& u_) : u(u_) {}
+
+    void operator()() {c = colorContract(u[0], u[1], u[2]);}
+
+    //! 36 terms, each two complex multiplies and an add
+    double flops() const {return 504*sites();}
+    double bytes() const {return (3*2*Nc*Nc + 2)*realBytes()*sites();}
+
+  private:
+    const multi1d<LatticeColorMatrix>& u;
+    LatticeComplex c;
+  };
+
+
+  //! Momentum projection of a correlator
+  class SftMomKernel : public BenchKernel
+  {
+  public:
+    SftMomKernel(const SftMom& phases_) : phases(phases_)
+    {
+      gaussian(cf);
+    }
+
+    void operator()() {multi2d<DComplex> hsum = phases.sft(cf);}
+    double flops() const {return 8*phases.numMom()*sites();}
+    double bytes() const {return 2*(1 + phases.numMom())*realBytes()*sites();}
+
+  private:
+    const SftMom& phases;
+    LatticeComplex cf;
+  };
+
+
+  //! QIO write of a propagator
+  class QIOWriteKernel : public BenchKernel
+  {
+  public:
+    QIOWriteKernel(const LatticePropagator& prop_, const std::string& file_) :
+      prop(prop_), file(file_) {}
+
+    void operator()()
+    {
+      XMLBufferWriter file_xml;
+      push(file_xml, "ChromaBench");
+      pop(file_xml);
+
+      XMLBufferWriter record_xml;
+      push(record_xml, "Propagator");
+      pop(record_xml);
+
+      QDPFileWriter to(file_xml, file, QDPIO_SINGLEFILE, QDPIO_SERIAL, QDPIO_OPEN);
+      write(to, record_xml, prop);
+      close(to);
+    }
+
+    double flops() const {return 0;}
+    double bytes() const {return propBytes()*sites();}
+
+  private:
+    const LatticePropagator& prop;
+    std::string file;
+  };
+
+
+  //! QIO read of a propagator
+  class QIOReadKernel : public BenchKernel
+  {
+  public:
+    QIOReadKernel(const std::string& file_) : file(file_) {}
+
+    void operator()()
+    {
+      XMLReader file_xml;
+      XMLReader record_xml;
+
+      QDPFileReader from(file_xml, file, QDPIO_SERIAL);
+      read(from, record_xml, prop);
+      close(from);
+    }
+
+    double flops() const {return 0;}
+    double bytes() const {return propBytes()*sites();}
+
+  private:
+    std::string file;
+    LatticePropagator prop;
+  };
+
+
+  //! Write the results as JSON
+  void writeJSON(const std::string& file,
+		 const multi1d<int>& nrow,
+		 double stream_gbs,
+		 const std::vector<BenchResult>& results)
+  {
+    if (! Layout::primaryNode())
+      return;
+
+    std::ofstream f(file.c_str());
+    if (! f)
+    {
+      std::cerr << "chroma_bench: cannot open " << file << std::endl;
+      return;
+    }
+
+    f << "{\n";
+    f << "  \"lattice\": [";
+    for(int mu=0; mu < nrow.size(); ++mu)
+      f << nrow[mu] << ((mu+1 < nrow.size()) ? ", " : "");
+    f << "],\n";
+    f << "  \"precision\": " << BASE_PRECISION << ",\n";
+    f << "  \"nodes\": " << Layout::numNodes() << ",\n";
+    f << "  \"threads\": " << qdpNumThreads() << ",\n";
+    f << std::scientific << std::setprecision(6);
+    f << "  \"stream_GBs\": " << stream_gbs << ",\n";
+    f << "  \"results\": [\n";
+    for(int i=0; i < results.size(); ++i)
+    {
+      const BenchResult& r = results[i];
+      double gbs = 1.0e-9*r.bytes/r.secs;
+
+      f << "    {\"name\": \"" << r.name << "\""
+	<< ", \"calls\": " << r.calls
+	<< ", \"secs_per_call\": " << r.secs
+	<< ", \"flops_per_call\": " << r.flops
+	<< ", \"bytes_per_call\": " << r.bytes;
+      if (r.flops > 0)
+	f << ", \"GFlops\": " << 1.0e-9*r.flops/r.secs;
+      else
+	f << ", \"GFlops\": null";
+      f << ", \"GBs\": " << gbs;
+      if (stream_gbs > 0)
+	f << ", \"stream_fraction\": " << gbs/stream_gbs;
+      else
+	f << ", \"stream_fraction\": null";
+      f << "}" << ((i+1 < results.size()) ? "," : "") << "\n";
+    }
+    f << "  ]\n";
+    f << "}\n";
+  }
+
+
+  //! Is this benchmark selected?
+  bool selected(const multi1d<std::string>& list, const std::string& name)
+  {
+    if (list.size() == 0)
+      return true;
+
+    for(int i=0; i < list.size(); ++i)
+      if (list[i] == name)
+	return true;
+
+    return false;
+  }
+}
+
+
+//! Micro-benchmarks
+/*! \defgroup chroma_bench Micro-benchmarks
+ *  \ingroup main
+ *
+ * Times the main kernels and writes GFlop/s and GB/s as JSON
+ */
+
+int main(int argc, char *argv[])
+{
+  // Put the machine into a known state
+  Chroma::initialize(&argc, &argv);
+
+  START_CODE();
+
+  multi1d<int> nrow;
+  double min_time = 1.0;
+  int N5 = 8;
+  int solver_iters = 20;
+  std::string qio_file = "./chroma_bench.lime";
+  std::string json_file = "chroma_bench.json";
+  multi1d<std::string> benchmarks;
+
+  try
+  {
+    XMLReader xml_in(Chroma::getXMLInputFileName());
+    XMLReader paramtop(xml_in, "/ChromaBench/Param");
+
+    read(paramtop, "nrow", nrow);
+
+    if (paramtop.count("MinTime") > 0)
+      read(paramtop, "MinTime", min_time);
+
+    if (paramtop.count("N5") > 0)
+      read(paramtop, "N5", N5);
+
+    if (paramtop.count("SolverIters") > 0)
+      read(paramtop, "SolverIters", solver_iters);
+
+    if (paramtop.count("QIOFile") > 0)
+      read(paramtop, "QIOFile", qio_file);
+
+    if (paramtop.count("Benchmarks") > 0)
+      read(paramtop, "Benchmarks", benchmarks);
+
+    if (xml_in.count("/ChromaBench/JSONFile") > 0)
+      read(xml_in, "/ChromaBench/JSONFile", json_file);
+  }
+  catch(const std::string& e)
+  {
+    QDPIO::cerr << "chroma_bench: Caught Exception reading XML: " << e << std::endl;
+    QDP_abort(1);
+  }
+
+  Layout::setLattSize(nrow);
+  Layout::create();
+
+  XMLFileWriter& xml_out = Chroma::getXMLOutputInstance();
+  push(xml_out, "chroma_bench");
+  proginfo(xml_out);    // Print out basic program info
+
+  // Random gauge field, projected back to SU(3) so the solvers behave
+  multi1d<LatticeColorMatrix> u(Nd);
+  for(int mu=0; mu < u.size(); ++mu)
+  {
+    gaussian(u[mu]);
+    reunit(u[mu]);
+  }
+
+  Handle< FermState<LatticeFermion,
+    multi1d<LatticeColorMatrix>,
+    multi1d<LatticeColorMatrix> > > fs(new PeriodicFermState<LatticeFermion,
+				       multi1d<LatticeColorMatrix>,
+				       multi1d<LatticeColorMatrix> >(u));
+
+  LatticePropagator prop;
+  gaussian(prop);
+
+  SftMom phases(3, false, Nd-1);
+
+  std::vector<BenchResult> results;
+  double stream_gbs = 0;
+
+  if (selected(benchmarks, "STREAM"))
+  {
+    StreamTriad k;
+    results.push_back(runKernel("STREAM", k, min_time));
+    stream_gbs = 1.0e-9*results.back().bytes/results.back().secs;
+  }
+
+  if (selected(benchmarks, "WILSON_DSLASH"))
+  {
+    WilsonDslashKernel k(fs);
+    results.push_back(runKernel("WILSON_DSLASH", k, min_time));
+  }
+
+  if (selected(benchmarks, "CLOVER_APPLY") || selected(benchmarks, "CLOVER_INVERSE"))
+  {
+    CloverFermActParams cparam;
+    cparam.Mass = Real(0.1);
+    cparam.clovCoeffR = Real(1);
+    cparam.clovCoeffT = Real(1);
+
+    QDPCloverTerm clov;
+    clov.create(fs, cparam);
+
+    if (selected(benchmarks, "CLOVER_APPLY"))
+    {
+      CloverApply k(clov);
+      results.push_back(runKernel("CLOVER_APPLY", k, min_time));
+    }
+
+    if (selected(benchmarks, "CLOVER_INVERSE"))
+    {
+      CloverInverse k(fs, cparam, clov);
+      results.push_back(runKernel("CLOVER_INVERSE", k, min_time));
+    }
+  }
+
+  if (selected(benchmarks, "DWF"))
+  {
+    DWFKernel k(fs, N5);
+    results.push_back(runKernel("DWF", k, min_time));
+  }
+
+  if (selected(benchmarks, "CG"))
+  {
+    CGKernel k(fs, solver_iters);
+    results.push_back(runKernel("CG", k, min_time));
+  }
+
+  if (selected(benchmarks, "BICGSTAB"))
+  {
+    BiCGStabKernel k(fs, solver_iters);
+    results.push_back(runKernel("BICGSTAB", k, min_time));
+  }
+
+  if (selected(benchmarks, "STOUT"))
+  {
+    StoutKernel k(u);
+    results.push_back(runKernel("STOUT", k, min_time));
+  }
+
+  if (selected(benchmarks, "MESONS"))
+  {
+    MesonKernel k(prop, phases);
+    results.push_back(runKernel("MESONS", k, min_time));
+  }
+
+  if (selected(benchmarks, "BARYONS"))
+  {
+    BaryonKernel k(prop, phases);
+    results.push_back(runKernel("BARYONS", k, min_time));
+  }
+
+  if (selected(benchmarks, "COLOR_CONTRACT"))
+  {
+    ColorContractKernel k(u);
+    results.push_back(runKernel("COLOR_CONTRACT", k, min_time));
+  }
+
+  if (selected(benchmarks, "SFTMOM"))
+  {
+    SftMomKernel k(phases);
+    results.push_back(runKernel("SFTMOM", k, min_time));
+  }
+
+  if (selected(benchmarks, "QIO_WRITE") || selected(benchmarks, "QIO_READ"))
+  {
+    QIOWriteKernel w(prop, qio_file);
+
+    if (selected(benchmarks, "QIO_WRITE"))
+      results.push_back(runKernel("QIO_WRITE", w, min_time));
+    else
+      w();
+
+    if (selected(benchmarks, "QIO_READ"))
+    {
+      QIOReadKernel k(qio_file);
+      results.push_back(runKernel("QIO_READ", k, min_time));
+    }
+
+    if (Layout::primaryNode())
+      std::remove(qio_file.c_str());
+  }
+
+  // Results in the xml output as well
+  push(xml_out, "Results");
+  write(xml_out, "stream_GBs", stream_gbs);
+  for(int i=0; i < results.size(); ++i)
+  {
+    const BenchResult& r = results[i];
+    push(xml_out, "elem");
+    write(xml_out, "name", r.name);
+    write(xml_out, "calls", r.calls);
+    write(xml_out, "secs_per_call", r.secs);
+    write(xml_out, "GFlops", 1.0e-9*r.flops/r.secs);
+    write(xml_out, "GBs", 1.0e-9*r.bytes/r.secs);
+    pop(xml_out);
+  }
+  pop(xml_out);
+
+  writeJSON(json_file, nrow, stream_gbs, results);
+  QDPIO::cout << "chroma_bench: wrote " << json_file << std::endl;
+
+  pop(xml_out);
+
+  END_CODE();
+
+  // Time to bolt
+  Chroma::finalize();
+
+  exit(0);
+}
@@ -0,0 +1,37 @@
+#!/bin/sh
+#
+# Run chroma_bench once per lattice size
+#
+#   chroma_bench_sweep.sh input.xml "8 8 8 16" "16 16 16 32" ...
+#
+# For each size, the <nrow> and <JSONFile> of input.xml are replaced and
+# the results go to chroma_bench_<nrow joined by x>.json. The program and
+# its launcher are taken from BENCH, e.g.
+#
+#   BENCH="mpirun -n 4 ./chroma_bench" chroma_bench_sweep.sh DATA "8 8 8 16"
+#
+
+BENCH=${BENCH:-./chroma_bench}
+
+if [ $# -lt 2 ]; then
+    echo "usage: $0 input.xml \"nx ny nz nt\" ..." 1>&2
+    exit 1
+fi
+
+input=$1
+shift
+
+if ! grep -q "<JSONFile>" $input; then
+    echo "$0: $input needs a <JSONFile> element" 1>&2
+    exit 1
+fi
+
+for nrow in "$@"; do
+    tag=`echo $nrow | tr ' ' 'x'`
+
+    sed -e "s|<nrow>.*</nrow>|<nrow>$nrow</nrow>|" \
+	-e "s|<JSONFile>.*</JSONFile>|<JSONFile>chroma_bench_$tag.json</JSONFile>|" \
+	$input > chroma_bench_$tag.ini.xml
+
+    $BENCH -i chroma_bench_$tag.ini.xml -o chroma_bench_$tag.out.xml || exit 1
+done
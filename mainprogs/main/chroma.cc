@@ -16,6 +16,8 @@ struct Params_t
 {
   multi1d<int>    nrow;
   std::string     inline_measurement_xml;
+  int             named_obj_budget_mb;      /*!< named object memory budget per node, 0 = unlimited */
+  std::string     named_obj_spill_dir;      /*!< node-local scratch for spilled named objects */
 };
 
 struct Inline_input_t
@@ -31,6 +33,16 @@ void read(XMLReader& xml, const std::string& path, Params_t& p)
   XMLReader paramtop(xml, path);
   read(paramtop, "nrow", p.nrow);
 
+  p.named_obj_budget_mb = 0;
+  p.named_obj_spill_dir = ".";
+  if (paramtop.count("NamedObjectStore") > 0)
+  {
+    XMLReader storetop(paramtop, "NamedObjectStore");
+    read(storetop, "MemoryBudgetMB", p.named_obj_budget_mb);
+    if (storetop.count("SpillDir") > 0)
+      read(storetop, "SpillDir", p.named_obj_spill_dir);
+  }
+
   XMLReader measurements_xml(paramtop, "InlineMeasurements");
   std::ostringstream inline_os;
   measurements_xml.print(inline_os);
@@ -220,6 +232,10 @@ int main(int argc, char *argv[])
     InlineDefaultGaugeField::reset();
     InlineDefaultGaugeField::set(u, config_xml);
 
+    // Memory budget for named objects
+    TheNamedObjMap::Instance().setBudget(size_t(input.param.named_obj_budget_mb) << 20,
+					 input.param.named_obj_spill_dir);
+
     // Measure inline observables 
     push(xml_out, "InlineObservables");
     xml_out.flush();
@@ -236,11 +252,23 @@ int main(int argc, char *argv[])
       AbsInlineMeasurement& the_meas = *(the_measurements[m]);
       if( cur_update % the_meas.getFrequency() == 0 ) 
       {
+	// Counters are aggregated per measurement
+	std::string meas_name;
+	{
+	  std::ostringstream elem_path;
+	  elem_path << "/InlineMeasurements/elem[" << (m+1) << "]/Name";
+	  read(MeasXML, elem_path.str(), meas_name);
+	}
+	PerfCounters::Scope perf_scope(meas_name);
+
 	// Caller writes elem rule
 	push(xml_out, "elem");
 	the_meas(cur_update, xml_out);
 	pop(xml_out); 
 
+	// No references to named objects are held here, so it is safe to spill
+	TheNamedObjMap::Instance().enforceBudget();
+
 	xml_out.flush();
       }
     }
@@ -253,6 +281,12 @@ int main(int argc, char *argv[])
 
     pop(xml_out); // pop("InlineObservables");
 
+    // Named object memory accounting
+    TheNamedObjMap::Instance().writeStats(xml_out, "NamedObjectStore");
+
+    // Per-kernel flop/byte summary
+    PerfCounters::report(xml_out, "PerfCounters");
+
     // Reset the default gauge field
     InlineDefaultGaugeField::reset();
   }
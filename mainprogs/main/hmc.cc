@@ -14,6 +14,8 @@ namespace Chroma
   {
     GroupXML_t    cfg;
     QDP::Seed     rng_seed;
+    bool          momentum_seedP;     // momenta from the counter based generator
+    unsigned long momentum_seed;
     unsigned long start_update_num;
     unsigned long n_warm_up_updates;
     unsigned long n_production_updates;
@@ -28,6 +30,8 @@ namespace Chroma
     bool          rev_checkP;
     int           rev_check_frequency;
     bool          monitorForcesP;
+    int           named_obj_budget_mb;      /*!< named object memory budget per node, 0 = unlimited */
+    std::string   named_obj_spill_dir;      /*!< node-local scratch for spilled named objects */
 
   };
   
@@ -39,6 +43,14 @@ namespace Chroma
       XMLReader paramtop(xml, path);
       p.cfg = readXMLGroup(paramtop, "Cfg", "cfg_type");
       read(paramtop, "./RNG", p.rng_seed);
+
+      // Optional layout independent momenta
+      p.momentum_seedP = false;
+      if ( paramtop.count("./MomentumSeed") == 1 ) {
+	read(paramtop, "./MomentumSeed", p.momentum_seed);
+	p.momentum_seedP = true;
+      }
+
       read(paramtop, "./StartUpdateNum", p.start_update_num);
       read(paramtop, "./NWarmUpUpdates", p.n_warm_up_updates);
       read(paramtop, "./NProductionUpdates", p.n_production_updates);
@@ -114,6 +126,17 @@ namespace Chroma
 	p.monitorForcesP = true;
       }
 
+      // Optional memory budget for named objects
+      p.named_obj_budget_mb = 0;
+      p.named_obj_spill_dir = ".";
+      if( paramtop.count("./NamedObjectStore") == 1 ) {
+	XMLReader storetop(paramtop, "./NamedObjectStore");
+	read(storetop, "./MemoryBudgetMB", p.named_obj_budget_mb);
+	if( storetop.count("./SpillDir") == 1 ) {
+	  read(storetop, "./SpillDir", p.named_obj_spill_dir);
+	}
+      }
+
       if( paramtop.count("./InlineMeasurements") == 0 ) {
 	XMLBufferWriter dummy;
 	push(dummy, "InlineMeasurements");
@@ -148,6 +171,9 @@ namespace Chroma
       push(xml, path);
       xml << p.cfg.xml;
       write(xml, "RNG", p.rng_seed);
+      if ( p.momentum_seedP ) { 
+	write(xml, "MomentumSeed", p.momentum_seed);
+      }
       write(xml, "StartUpdateNum", p.start_update_num);
       write(xml, "NWarmUpUpdates", p.n_warm_up_updates);
       write(xml, "NProductionUpdates", p.n_production_updates);
@@ -168,6 +194,12 @@ namespace Chroma
 	write(xml, "ReverseCheckFrequency", p.rev_check_frequency);
       }
       write(xml, "MonitorForces", p.monitorForcesP);
+      if( p.named_obj_budget_mb > 0 ) { 
+	push(xml, "NamedObjectStore");
+	write(xml, "MemoryBudgetMB", p.named_obj_budget_mb);
+	write(xml, "SpillDir", p.named_obj_spill_dir);
+	pop(xml);
+      }
 
       xml << p.inline_measurement_xml;
       
@@ -389,9 +421,30 @@ namespace Chroma
     // It is a handle
     default_measurements[0] = new InlinePlaquetteEnv::InlineMeas(plaq_params);
 
+    // The names of the user measurements, to aggregate the counters by
+    multi1d<std::string> user_meas_names(user_measurements.size());
+    {
+      std::istringstream meas_is(mc_control.inline_measurement_xml);
+      XMLReader meas_xml(meas_is);
+      for(int m=0; m < user_meas_names.size(); m++) 
+      {
+	std::ostringstream elem_path;
+	elem_path << "/InlineMeasurements/elem[" << (m+1) << "]/Name";
+	read(meas_xml, elem_path.str(), user_meas_names[m]);
+      }
+    }
+
     {
       // Initialise the RNG
       QDP::RNG::setrn(mc_control.rng_seed);
+
+      if ( mc_control.momentum_seedP ) { 
+	CounterRNGEnv::setMomentumSeed(mc_control.momentum_seed);
+      }
+
+      // Memory budget for named objects
+      TheNamedObjMap::Instance().setBudget(size_t(mc_control.named_obj_budget_mb) << 20,
+					   mc_control.named_obj_spill_dir);
       
       // Fictitious momenta for now
       multi1d<LatticeColorMatrix> p(Nd);
@@ -430,6 +483,9 @@ namespace Chroma
 	// Increase current update counter
 	cur_update++;
 	
+	// Momenta of a trajectory are keyed on its number
+	CounterRNGEnv::setUpdate(cur_update);
+
 	// Decide if the next update is a warm up or not
 	bool warm_up_p = cur_update  <= mc_control.n_warm_up_updates;
 	QDPIO::cout << "Doing Update: " << cur_update << " warm_up_p = " << warm_up_p << std::endl;
@@ -588,6 +644,7 @@ namespace Chroma
 
 	    // Caller writes elem rule 
 	    AbsInlineMeasurement& the_meas = *(default_measurements[m]);
+	    PerfCounters::Scope perf_scope(InlinePlaquetteEnv::name);
 	    push(xml_out, "elem");
 	    the_meas(cur_update, xml_out);
 	    pop(xml_out);
@@ -608,12 +665,18 @@ namespace Chroma
 	    AbsInlineMeasurement& the_meas = *(user_measurements[m]);
 	    if( cur_update % the_meas.getFrequency() == 0 )  {
 	      
+	      // Counters are aggregated per measurement
+	      PerfCounters::Scope perf_scope(user_meas_names[m]);
+
 	      // Caller writes elem rule
 	      push(xml_out, "elem");
 	      QDPIO::cout << "HMC: calling user measurement number = " << m << std::endl;
 	      the_meas(cur_update, xml_out);
 	      QDPIO::cout << "HMC: finished user measurement number = " << m << std::endl;
 	      pop(xml_out); 
+
+	      // No references to named objects are held here, so it is safe to spill
+	      TheNamedObjMap::Instance().enforceBudget();
 	    }
 	  }
 	  QDPIO::cout << "HMC: finished user measurements" << std::endl;
@@ -662,6 +725,12 @@ namespace Chroma
       pop(xml_out); // pop("MCUpdates")
     }
 
+    // Per-kernel flop/byte summary
+    PerfCounters::report(xml_out, "PerfCounters");
+
+    // Named object memory accounting
+    TheNamedObjMap::Instance().writeStats(xml_out, "NamedObjectStore");
+
     pop(xml_log); // pop("doHMC")
     pop(xml_out); // pop("doHMC")
     
@@ -4,6 +4,7 @@
 
 #include "chroma.h"
 #include "actions/gauge/gaugeacts/gaugeacts_aggregate.h"
+#include "util/ferm/counter_rng.h"
 
 using namespace Chroma;
 
@@ -73,6 +74,8 @@ namespace Chroma
   struct MCControl 
   {
     QDP::Seed rng_seed;
+    bool          heatbath_seedP;     // heatbath from the counter based generator
+    unsigned long heatbath_seed;
     unsigned long start_update_num;
     unsigned long n_warm_up_updates;
     unsigned long n_production_updates;
@@ -87,6 +90,14 @@ namespace Chroma
     try { 
       XMLReader paramtop(xml, path);
       read(paramtop, "./RNG", p.rng_seed);
+
+      // Optional layout independent heatbath
+      p.heatbath_seedP = false;
+      if ( paramtop.count("./HeatbathSeed") == 1 ) {
+	read(paramtop, "./HeatbathSeed", p.heatbath_seed);
+	p.heatbath_seedP = true;
+      }
+
       read(paramtop, "./StartUpdateNum", p.start_update_num);
       read(paramtop, "./NWarmUpUpdates", p.n_warm_up_updates);
       read(paramtop, "./NProductionUpdates", p.n_production_updates);
@@ -109,6 +120,9 @@ namespace Chroma
     push(xml, path);
 
     write(xml, "RNG", p.rng_seed);
+    if ( p.heatbath_seedP ) {
+      write(xml, "HeatbathSeed", p.heatbath_seed);
+    }
     write(xml, "StartUpdateNum", p.start_update_num);
     write(xml, "NWarmUpUpdates", p.n_warm_up_updates);
     write(xml, "NProductionUpdates", p.n_production_updates);
@@ -409,6 +423,9 @@ namespace Chroma
       push(xml_out, "Update");
       // Increase current update counter
       cur_update++;
+
+      // Warm up sweeps restart their count, so take their own stream
+      CounterRNGEnv::setUpdate(cur_update, true);
 	
       // Log
       write(xml_out, "update_no", cur_update);
@@ -467,6 +484,9 @@ namespace Chroma
       push(xml_out, "Update");
       // Increase current update counter
       cur_update++;
+
+      // Heatbath numbers of a sweep are keyed on its number
+      CounterRNGEnv::setUpdate(cur_update);
 	
       // Decide if the next update is a warm up or not
       QDPIO::cout << "Doing Update: " << cur_update << " warm_up_p = " << false << std::endl;
@@ -521,6 +541,10 @@ namespace Chroma
     {
       // Initialise the RNG
       QDP::RNG::setrn(hb_control.mc_control.rng_seed);
+
+      if ( hb_control.mc_control.heatbath_seedP ) {
+	CounterRNGEnv::setHeatbathSeed(hb_control.mc_control.heatbath_seed);
+      }
       
       // If warmups are required, do them first
       if (hb_control.mc_control.n_warm_up_updates > 0)
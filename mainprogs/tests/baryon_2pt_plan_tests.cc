@@ -0,0 +1,87 @@
+#include "chromabase.h"
+
+#include "meas/hadron/barhqlq_w.h"
+#include "meas/hadron/barspinmat_w.h"
+#include "util/ft/sftmom.h"
+#include "gtest/gtest.h"
+
+using namespace Chroma;
+using namespace QDP;
+
+
+//! The planned barhqlq against the per-channel contractions it replaced
+class Baryon2PtPlanTest : public ::testing::Test {
+public:
+	void SetUp() {
+		gaussian(q1);
+		gaussian(q2);
+
+		tol = (sizeof(REAL) == sizeof(float)) ? 1.0e-5 : 1.0e-12;
+	}
+
+	void TearDown() {}
+
+	LatticePropagator q1;
+	LatticePropagator q2;
+	double tol;
+};
+
+
+TEST_F(Baryon2PtPlanTest, MatchesPerChannelContractions)
+{
+	using namespace Baryon2PtContractions;
+
+	SftMom phases(1, false, Nd-1);
+
+	multi3d<DComplex> barprop;
+	barhqlq(q1, q2, phases, barprop);
+
+	const int num_baryons = 17;
+	ASSERT_EQ(barprop.size3(), num_baryons);
+	ASSERT_EQ(barprop.size2(), phases.numMom());
+	ASSERT_EQ(barprop.size1(), phases.numSubsets());
+
+	SpinMatrix T_mixed = BaryonSpinMats::Tmixed();
+	SpinMatrix T_unpol = BaryonSpinMats::Tunpol();
+	SpinMatrix Cg5     = BaryonSpinMats::Cg5();
+	SpinMatrix Cg5g4   = BaryonSpinMats::Cg5g4();
+	SpinMatrix Cg5NR   = BaryonSpinMats::Cg5NR();
+
+	// The channels as barhqlq computed them before the planner
+	multi1d<LatticeComplex> b_prop(num_baryons);
+	b_prop[0]  = sigma2pt(q1, q2, T_mixed, Cg5);
+	b_prop[1]  = lambda2pt(q1, q2, T_mixed, Cg5);
+	b_prop[2]  = sigmast2pt(q1, q2, T_mixed, BaryonSpinMats::Cgm());
+	b_prop[3]  = sigma2pt(q1, q2, T_mixed, Cg5g4);
+	b_prop[4]  = lambda2pt(q1, q2, T_mixed, Cg5g4);
+	b_prop[5]  = sigmast2pt(q1, q2, T_mixed, BaryonSpinMats::Cg4m());
+	b_prop[6]  = sigma2pt(q1, q2, T_mixed, Cg5NR);
+	b_prop[7]  = lambda2pt(q1, q2, T_mixed, Cg5NR);
+	b_prop[8]  = 4.0 * sigmast2pt(q1, q2, T_mixed, BaryonSpinMats::CgmNR());
+	b_prop[9]  = sigma2pt(q1, q2, T_unpol, Cg5);
+	b_prop[10] = sigma2pt(q1, q2, T_unpol, Cg5g4);
+	b_prop[11] = sigma2pt(q1, q2, T_unpol, Cg5NR);
+	b_prop[12] = lambdaNaive2pt(q1, q2, T_unpol, Cg5);
+	b_prop[13] = xi2pt(q1, q2, T_unpol, Cg5);
+	b_prop[14] = lambdaNaive2pt(q1, q2, T_unpol, Cg5);
+	b_prop[15] = xi2pt(q1, q2, T_mixed, Cg5);
+	b_prop[16] = sigma2pt(q1, q2, BaryonSpinMats::TmixedNegPar(), BaryonSpinMats::Cg5NRnegPar());
+
+	for(int b = 0; b < num_baryons; ++b)
+	{
+		multi2d<DComplex> ref = phases.sft(b_prop[b]);
+
+		double d2 = 0, n2 = 0;
+		for(int mom = 0; mom < phases.numMom(); ++mom)
+			for(int t = 0; t < phases.numSubsets(); ++t)
+			{
+				DComplex d = barprop[b][mom][t] - ref[mom][t];
+				d2 += toDouble(localNorm2(d));
+				n2 += toDouble(localNorm2(ref[mom][t]));
+			}
+
+		double diff = sqrt(d2 / n2);
+		QDPIO::cout << "Baryon " << b << ": || planned - per-channel || / || per-channel || = " << diff << std::endl;
+		EXPECT_LT(diff, tol) << "baryon " << b;
+	}
+}
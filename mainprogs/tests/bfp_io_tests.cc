@@ -0,0 +1,106 @@
+#include "chromabase.h"
+
+#include "io/bfp_io.h"
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <cmath>
+
+using namespace Chroma;
+using namespace QDP;
+
+
+//! Write and read back in both exponent sharings
+class BFPIOTest : public ::testing::TestWithParam<BFPIO::BFPBlock_t> {
+public:
+	void SetUp() {
+		file = (GetParam() == BFPIO::BFP_SITE) ? "t_bfp_io_site.lime" : "t_bfp_io_spin_color.lime";
+
+		XMLBufferWriter file_xml_buf;
+		push(file_xml_buf, "TestFile");
+		write(file_xml_buf, "id", 17);
+		pop(file_xml_buf);
+		file_xml.open(file_xml_buf);
+
+		XMLBufferWriter record_xml_buf;
+		push(record_xml_buf, "TestRecord");
+		write(record_xml_buf, "id", 23);
+		pop(record_xml_buf);
+		record_xml.open(record_xml_buf);
+	}
+
+	void TearDown() {
+		std::remove(file.c_str());
+	}
+
+	//! Largest per-site  |x - y|^2 / |x|^2
+	/*!
+	 * Each element is within 2^-14 of the largest magnitude in its block,
+	 * so this is at most  nreal * 2^-28  for  nreal  reals per site.
+	 */
+	template<typename T>
+	double siteError(const T& x, const T& y) const {
+		T d = x - y;
+		LatticeReal r = localNorm2(d) / localNorm2(x);
+		return toDouble(globalMax(r));
+	}
+
+	//! The original file and record XML come back
+	void checkXML(XMLReader& file_in, XMLReader& record_in) const {
+		int id;
+		read(file_in, "/TestFile/id", id);
+		EXPECT_EQ(id, 17);
+		read(record_in, "/TestRecord/id", id);
+		EXPECT_EQ(id, 23);
+	}
+
+	std::string file;
+	XMLReader file_xml;
+	XMLReader record_xml;
+};
+
+
+TEST_P(BFPIOTest, PropagatorRoundTrip)
+{
+	LatticePropagator x;
+	gaussian(x);
+
+	BFPIO::writeBFP(file_xml, record_xml, x, file, GetParam(), QDPIO_SINGLEFILE, QDPIO_SERIAL);
+
+	LatticePropagator y = zero;
+	XMLReader file_in, record_in;
+	BFPIO::readBFP(file_in, record_in, y, file, QDPIO_SERIAL);
+
+	checkXML(file_in, record_in);
+
+	double bound = 2*Ns*Nc*Ns*Nc * std::ldexp(1.0, -28);
+	double err = siteError(x, y);
+	QDPIO::cout << "Propagator: max site |x - y|^2 / |x|^2 = " << err << "  bound = " << bound << std::endl;
+	ASSERT_LE(err, bound);
+}
+
+
+TEST_P(BFPIOTest, FermionRoundTrip)
+{
+	LatticeFermion x;
+	gaussian(x);
+
+	BFPIO::writeBFP(file_xml, record_xml, x, file, GetParam(), QDPIO_SINGLEFILE, QDPIO_SERIAL);
+
+	LatticeFermion y = zero;
+	XMLReader file_in, record_in;
+	BFPIO::readBFP(file_in, record_in, y, file, QDPIO_SERIAL);
+
+	checkXML(file_in, record_in);
+
+	double bound = 2*Ns*Nc * std::ldexp(1.0, -28);
+	double err = siteError(x, y);
+	QDPIO::cout << "Fermion: max site |x - y|^2 / |x|^2 = " << err << "  bound = " << bound << std::endl;
+	ASSERT_LE(err, bound);
+}
+
+
+INSTANTIATE_TEST_CASE_P(BFPIO,
+                        BFPIOTest,
+                        ::testing::Values(BFPIO::BFP_SITE,
+                                          BFPIO::BFP_SPIN_COLOR));
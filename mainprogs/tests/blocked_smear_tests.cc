@@ -0,0 +1,134 @@
+#include "chromabase.h"
+
+#include "meas/smear/gaus_smear.h"
+#include "meas/smear/jacobi_smear.h"
+#include "meas/smear/blocked_smear.h"
+#include "util/gauge/reunit.h"
+#include "gtest/gtest.h"
+
+#include <tuple>
+
+using namespace Chroma;
+using namespace QDP;
+
+
+//! Parameters are ( block_iter, tile_size )
+class BlockedSmearTest : public ::testing::TestWithParam< std::tuple<int,int> > {
+public:
+	using Q = multi1d<LatticeColorMatrix>;
+
+	void SetUp() {
+		u.resize(Nd);
+		for(int mu=0; mu < Nd; ++mu) {
+			gaussian(u[mu]);
+			reunit(u[mu]);
+		}
+
+		block_iter = std::get<0>(GetParam());
+		tile_size  = std::get<1>(GetParam());
+
+		tol = (sizeof(REAL) == sizeof(float)) ? 1.0e-5 : 1.0e-12;
+	}
+
+	void TearDown() {}
+
+	//! || a - b || / || b ||
+	template<typename T>
+	double diff(const T& a, const T& b) const {
+		T d = a - b;
+		return toDouble(sqrt(norm2(d) / norm2(b)));
+	}
+
+	Q u;
+	int block_iter;
+	int tile_size;
+	double tol;
+};
+
+
+TEST_P(BlockedSmearTest, GausColorVector)
+{
+	LatticeColorVector chi;
+	gaussian(chi);
+	LatticeColorVector ref = chi;
+
+	// One iteration more than a whole number of passes
+	int iter = 2*block_iter + 1;
+	gausSmear(u, ref, Real(2.0), iter, Nd-1);
+	blockedGausSmear(u, chi, Real(2.0), iter, Nd-1, block_iter, tile_size);
+
+	double d = diff(chi, ref);
+	QDPIO::cout << "Gaus colour vector: || blocked - gausSmear || / || gausSmear || = " << d << std::endl;
+	ASSERT_LT(d, tol);
+}
+
+
+TEST_P(BlockedSmearTest, GausPropagator)
+{
+	LatticePropagator chi;
+	gaussian(chi);
+	LatticePropagator ref = chi;
+
+	int iter = 2*block_iter + 1;
+	gausSmear(u, ref, Real(2.0), iter, Nd-1);
+	blockedGausSmear(u, chi, Real(2.0), iter, Nd-1, block_iter, tile_size);
+
+	double d = diff(chi, ref);
+	QDPIO::cout << "Gaus propagator: || blocked - gausSmear || / || gausSmear || = " << d << std::endl;
+	ASSERT_LT(d, tol);
+}
+
+
+TEST_P(BlockedSmearTest, GausNoDecayDir)
+{
+	// All four directions smeared: the tiles cover the whole lattice
+	LatticeFermion chi;
+	gaussian(chi);
+	LatticeFermion ref = chi;
+
+	int iter = 2*block_iter + 1;
+	gausSmear(u, ref, Real(2.0), iter, Nd);
+	blockedGausSmear(u, chi, Real(2.0), iter, Nd, block_iter, tile_size);
+
+	double d = diff(chi, ref);
+	QDPIO::cout << "Gaus 4d fermion: || blocked - gausSmear || / || gausSmear || = " << d << std::endl;
+	ASSERT_LT(d, tol);
+}
+
+
+TEST_P(BlockedSmearTest, JacobiColorVector)
+{
+	LatticeColorVector chi;
+	gaussian(chi);
+	LatticeColorVector ref = chi;
+
+	int iter = 2*block_iter + 1;
+	jacobiSmear(u, ref, Real(0.2), iter, Nd-1);
+	blockedJacobiSmear(u, chi, Real(0.2), iter, Nd-1, block_iter, tile_size);
+
+	double d = diff(chi, ref);
+	QDPIO::cout << "Jacobi colour vector: || blocked - jacobiSmear || / || jacobiSmear || = " << d << std::endl;
+	ASSERT_LT(d, tol);
+}
+
+
+TEST_P(BlockedSmearTest, JacobiStaggeredPropagator)
+{
+	LatticeStaggeredPropagator chi;
+	gaussian(chi);
+	LatticeStaggeredPropagator ref = chi;
+
+	int iter = 2*block_iter + 1;
+	jacobiSmear(u, ref, Real(0.2), iter, Nd-1);
+	blockedJacobiSmear(u, chi, Real(0.2), iter, Nd-1, block_iter, tile_size);
+
+	double d = diff(chi, ref);
+	QDPIO::cout << "Jacobi staggered propagator: || blocked - jacobiSmear || / || jacobiSmear || = " << d << std::endl;
+	ASSERT_LT(d, tol);
+}
+
+
+INSTANTIATE_TEST_CASE_P(BlockedSmear,
+                        BlockedSmearTest,
+                        ::testing::Combine(::testing::Values(1, 2, 3),
+                                           ::testing::Values(2, 3, 4)));
@@ -0,0 +1,246 @@
+#include "chromabase.h"
+
+#include "handle.h"
+
+#include "eoprec_linop.h"
+#include "eoprec_wilstype_fermact_w.h"
+#include "actions/ferm/linop/eoprec_clover_linop_w.h"
+#include "actions/ferm/fermacts/clover_fermact_params_w.h"
+#include "actions/ferm/fermacts/fermact_factory_w.h"
+#include "util/gauge/reunit.h"
+#include "gtest/gtest.h"
+
+using namespace Chroma;
+using namespace QDP;
+
+namespace FusedSchurTesting
+{
+
+std::string fermact_xml_plain = "<?xml version='1.0'?>      \
+   <Param>                                            \
+   <FermionAction>                                    \
+     <FermAct>CLOVER</FermAct>                        \
+     <Mass>0.1</Mass>                                 \
+     <clovCoeff>1.17</clovCoeff>                      \
+     <FusedSchur>true</FusedSchur>                    \
+     <FermionBC>                                      \
+       <FermBC>SIMPLE_FERMBC</FermBC>                 \
+       <boundary>1 1 1 -1</boundary>                  \
+     </FermionBC>                                     \
+   </FermionAction>                                   \
+  </Param>";
+
+std::string fermact_xml_twisted = "<?xml version='1.0'?>    \
+   <Param>                                            \
+   <FermionAction>                                    \
+     <FermAct>CLOVER</FermAct>                        \
+     <Mass>0.1</Mass>                                 \
+     <clovCoeff>1.17</clovCoeff>                      \
+     <TwistedM>0.05</TwistedM>                        \
+     <FusedSchur>true</FusedSchur>                    \
+     <FermionBC>                                      \
+       <FermBC>SIMPLE_FERMBC</FermBC>                 \
+       <boundary>1 1 1 -1</boundary>                  \
+     </FermionBC>                                     \
+   </FermionAction>                                   \
+  </Param>";
+
+std::string fermact_xml_aniso = "<?xml version='1.0'?>      \
+   <Param>                                            \
+   <FermionAction>                                    \
+     <FermAct>CLOVER</FermAct>                        \
+     <Mass>0.1</Mass>                                 \
+     <clovCoeffR>0.91</clovCoeffR>                    \
+     <clovCoeffT>1.27</clovCoeffT>                    \
+     <AnisoParam>                                     \
+       <anisoP>true</anisoP>                          \
+       <t_dir>3</t_dir>                               \
+       <xi_0>2.464</xi_0>                             \
+       <nu>0.95</nu>                                  \
+     </AnisoParam>                                    \
+     <FusedSchur>true</FusedSchur>                    \
+     <FermionBC>                                      \
+       <FermBC>SIMPLE_FERMBC</FermBC>                 \
+       <boundary>1 1 1 -1</boundary>                  \
+     </FermionBC>                                     \
+   </FermionAction>                                   \
+  </Param>";
+
+}
+
+using namespace FusedSchurTesting;
+
+
+class FusedSchurTest : public ::testing::TestWithParam<std::string> {
+public:
+	using T = LatticeFermion;
+	using Q = multi1d<LatticeColorMatrix>;
+	using P = multi1d<LatticeColorMatrix>;
+
+	using S_T = EvenOddPrecWilsonTypeFermAct<T,P,Q>;
+	using LinOp_T = EvenOddPrecCloverLinOp;
+
+	void SetUp() {
+		u.resize(Nd);
+		for(int mu=0; mu < Nd; ++mu) {
+			gaussian(u[mu]);
+			reunit(u[mu]);
+		}
+
+		std::istringstream input(GetParam());
+		XMLReader xml_in(input);
+
+		param = CloverFermActParams(xml_in, "/Param/FermionAction");
+
+		S = dynamic_cast<S_T*>(TheFermionActionFactory::Instance().createObject("CLOVER",
+											  xml_in,
+											  "/Param/FermionAction"));
+		state = S->createState(u);
+		M = dynamic_cast<LinOp_T*>(S->linOp(state));
+
+		tol = (sizeof(REAL) == sizeof(float)) ? 1.0e-5 : 1.0e-12;
+	}
+
+	void TearDown() {}
+
+	//! chi_o = S psi_o from the blocks of the unpreconditioned operator
+	/*!
+	 * The unpreconditioned operator on  ( -A^{-1}_ee D_eo psi_o, psi_o )
+	 * is zero on the even sites and the Schur complement on the odd ones.
+	 * The twisted mass is only in the Schur complement.
+	 */
+	void schur(T& chi, const T& psi, enum PlusMinus isign) const {
+		T t1 = zero;
+		T t2 = zero;
+		T x  = zero;
+
+		M->evenOddLinOp(t1, psi, isign);
+		M->evenEvenInvLinOp(t2, t1, isign);
+		x[rb[0]] = -t2;
+		x[rb[1]] = psi;
+
+		chi = zero;
+		M->unprecLinOp(chi, x, isign);
+
+		double even = toDouble(sqrt(norm2(chi, rb[0]) / norm2(psi, rb[1])));
+		EXPECT_LT(even, tol);
+
+		if (param.twisted_m_usedP) {
+			T tw = zero;
+			tw[rb[1]] = GammaConst<Ns,Ns*Ns-1>() * timesI(psi);
+			if (isign == PLUS)
+				chi[rb[1]] += param.twisted_m * tw;
+			else
+				chi[rb[1]] -= param.twisted_m * tw;
+		}
+	}
+
+	//! || a - b || / || b ||  on the odd sites
+	double diff(const T& a, const T& b) const {
+		T d = zero;
+		d[rb[1]] = a - b;
+		return toDouble(sqrt(norm2(d, rb[1]) / norm2(b, rb[1])));
+	}
+
+	Q u;
+	CloverFermActParams param;
+	Handle<S_T> S;
+	Handle<FermState<T,P,Q> > state;
+	Handle<LinOp_T> M;
+	double tol;
+};
+
+
+TEST_P(FusedSchurTest, CheckPlus)
+{
+	if (! M->fusedSchurP()) {
+		QDPIO::cout << "FusedCloverSchur not usable in this build" << std::endl;
+		return;
+	}
+
+	T psi = zero;
+	gaussian(psi, rb[1]);
+
+	T chi = zero;
+	T ref = zero;
+	(*M)(chi, psi, PLUS);
+	schur(ref, psi, PLUS);
+
+	double d = diff(chi, ref);
+	QDPIO::cout << "PLUS: || S_fused psi - S psi || / || S psi || = " << d << std::endl;
+	ASSERT_LT(d, tol);
+}
+
+
+TEST_P(FusedSchurTest, CheckMinus)
+{
+	if (! M->fusedSchurP()) {
+		QDPIO::cout << "FusedCloverSchur not usable in this build" << std::endl;
+		return;
+	}
+
+	T psi = zero;
+	gaussian(psi, rb[1]);
+
+	T chi = zero;
+	T ref = zero;
+	(*M)(chi, psi, MINUS);
+	schur(ref, psi, MINUS);
+
+	double d = diff(chi, ref);
+	QDPIO::cout << "MINUS: || S_fused^dag psi - S^dag psi || / || S^dag psi || = " << d << std::endl;
+	ASSERT_LT(d, tol);
+}
+
+
+TEST_P(FusedSchurTest, CheckMdagM)
+{
+	if (! M->fusedSchurP()) {
+		QDPIO::cout << "FusedCloverSchur not usable in this build" << std::endl;
+		return;
+	}
+
+	T psi = zero;
+	gaussian(psi, rb[1]);
+
+	T chi = zero;
+	T ref = zero;
+	T tmp = zero;
+	M->mdagm(chi, psi);
+	schur(tmp, psi, PLUS);
+	schur(ref, tmp, MINUS);
+
+	double d = diff(chi, ref);
+	QDPIO::cout << "MdagM: || (S^dag S)_fused psi - S^dag S psi || / || S^dag S psi || = " << d << std::endl;
+	ASSERT_LT(d, tol);
+}
+
+
+// The source may also be the result
+TEST_P(FusedSchurTest, CheckAliased)
+{
+	if (! M->fusedSchurP()) {
+		QDPIO::cout << "FusedCloverSchur not usable in this build" << std::endl;
+		return;
+	}
+
+	T psi = zero;
+	gaussian(psi, rb[1]);
+
+	T ref = zero;
+	schur(ref, psi, PLUS);
+
+	T chi = psi;
+	(*M)(chi, chi, PLUS);
+
+	double d = diff(chi, ref);
+	QDPIO::cout << "Aliased: || S_fused psi - S psi || / || S psi || = " << d << std::endl;
+	ASSERT_LT(d, tol);
+}
+
+
+INSTANTIATE_TEST_CASE_P(FusedSchur,
+                        FusedSchurTest,
+                        ::testing::Values(fermact_xml_plain,
+                                          fermact_xml_twisted,
+                                          fermact_xml_aniso));
@@ -0,0 +1,201 @@
+#include "chromabase.h"
+
+#include "io/qprop_io.h"
+#include "meas/inline/hadron/inline_seqsource_w.h"
+#include "meas/inline/io/named_objmap.h"
+#include "util/gauge/reunit.h"
+#include "gtest/gtest.h"
+
+using namespace Chroma;
+using namespace QDP;
+
+namespace CoherentSeqSourceTesting
+{
+
+//! Record XML of a point source forward prop at the origin
+std::string prop_record_xml = "<?xml version='1.0'?>       \
+  <Propagator>                                       \
+    <ForwardProp>                                    \
+      <version>9</version>                           \
+      <quarkSpinType>FULL</quarkSpinType>            \
+      <obsvP>false</obsvP>                           \
+      <FermionAction>                                \
+        <FermAct>WILSON</FermAct>                    \
+        <Mass>0.1</Mass>                             \
+        <FermionBC>                                  \
+          <FermBC>SIMPLE_FERMBC</FermBC>             \
+          <boundary>1 1 1 -1</boundary>              \
+        </FermionBC>                                 \
+      </FermionAction>                               \
+      <InvertParam>                                  \
+        <invType>CG_INVERTER</invType>               \
+        <RsdCG>1.0e-12</RsdCG>                       \
+        <MaxCG>1000</MaxCG>                          \
+      </InvertParam>                                 \
+    </ForwardProp>                                   \
+    <PropSource>                                     \
+      <version>6</version>                           \
+      <Source>                                       \
+        <version>1</version>                         \
+        <SourceType>POINT_SOURCE</SourceType>        \
+        <j_decay>3</j_decay>                         \
+        <t_srce>0 0 0 0</t_srce>                     \
+      </Source>                                      \
+      <j_decay>3</j_decay>                           \
+      <t_source>0</t_source>                         \
+    </PropSource>                                    \
+    <Config_info><weak_field/></Config_info>         \
+  </Propagator>";
+
+//! The SeqSource Param of one sink
+std::string seqsrc(int t_sink)
+{
+  std::ostringstream os;
+  os << "<Param>"
+     << "  <version>2</version>"
+     << "  <SeqSource>"
+     << "    <version>1</version>"
+     << "    <SeqSourceType>a0-a0</SeqSourceType>"
+     << "    <j_decay>3</j_decay>"
+     << "    <t_sink>" << t_sink << "</t_sink>"
+     << "    <sink_mom>1 0 0</sink_mom>"
+     << "  </SeqSource>"
+     << "</Param>";
+  return os.str();
+}
+
+//! SEQSOURCE input for the sinks t_sinks, all from the forward prop fwd
+std::string seqsourceXML(const multi1d<int>& t_sinks, const std::string& id)
+{
+  std::ostringstream os;
+  os << "<?xml version='1.0'?>"
+     << "<elem>"
+     << "  <Name>SEQSOURCE</Name>"
+     << "  <Frequency>1</Frequency>"
+     << seqsrc(t_sinks[0])
+     << "  <PropSink>"
+     << "    <version>5</version>"
+     << "    <Sink>"
+     << "      <version>1</version>"
+     << "      <SinkType>POINT_SINK</SinkType>"
+     << "      <j_decay>3</j_decay>"
+     << "    </Sink>"
+     << "  </PropSink>"
+     << "  <NamedObject>"
+     << "    <gauge_id>default_gauge_field</gauge_id>"
+     << "    <prop_ids><elem>fwd</elem></prop_ids>"
+     << "    <seqsource_id>" << id << "</seqsource_id>"
+     << "  </NamedObject>";
+  if (t_sinks.size() > 1)
+  {
+    os << "  <CoherentSinks>";
+    for(int n=1; n < t_sinks.size(); ++n)
+      os << "    <elem>" << seqsrc(t_sinks[n]) << "<prop_ids><elem>fwd</elem></prop_ids></elem>";
+    os << "  </CoherentSinks>";
+  }
+  os << "</elem>";
+  return os.str();
+}
+
+}
+
+using namespace CoherentSeqSourceTesting;
+
+
+class CoherentSeqSourceTest : public ::testing::Test {
+public:
+	void SetUp() {
+		multi1d<LatticeColorMatrix> u(Nd);
+		for(int mu=0; mu < Nd; ++mu) {
+			gaussian(u[mu]);
+			reunit(u[mu]);
+		}
+
+		XMLBufferWriter gauge_xml;
+		push(gauge_xml, "weak_field");
+		pop(gauge_xml);
+
+		TheNamedObjMap::Instance().create< multi1d<LatticeColorMatrix> >("default_gauge_field");
+		TheNamedObjMap::Instance().getData< multi1d<LatticeColorMatrix> >("default_gauge_field") = u;
+		TheNamedObjMap::Instance().get("default_gauge_field").setFileXML(gauge_xml);
+		TheNamedObjMap::Instance().get("default_gauge_field").setRecordXML(gauge_xml);
+
+		LatticePropagator fwd;
+		gaussian(fwd);
+
+		XMLBufferWriter file_xml;
+		push(file_xml, "propagator");
+		pop(file_xml);
+
+		std::istringstream record_is(prop_record_xml);
+		XMLReader record_xml(record_is);
+
+		TheNamedObjMap::Instance().create<LatticePropagator>("fwd");
+		TheNamedObjMap::Instance().getData<LatticePropagator>("fwd") = fwd;
+		TheNamedObjMap::Instance().get("fwd").setFileXML(file_xml);
+		TheNamedObjMap::Instance().get("fwd").setRecordXML(record_xml);
+
+		tol = (sizeof(REAL) == sizeof(float)) ? 1.0e-5 : 1.0e-12;
+	}
+
+	void TearDown() {
+		const char* ids[] = {"default_gauge_field", "fwd", "seq_3", "seq_5", "seq_coh"};
+		for(int i=0; i < 5; ++i)
+			if (TheNamedObjMap::Instance().check(ids[i]))
+				TheNamedObjMap::Instance().erase(ids[i]);
+	}
+
+	//! Run SEQSOURCE and return the sequential source
+	LatticePropagator run(const multi1d<int>& t_sinks, const std::string& id) {
+		std::istringstream is(seqsourceXML(t_sinks, id));
+		XMLReader xml_in(is);
+
+		InlineSeqSourceEnv::InlineMeas meas(InlineSeqSourceEnv::Params(xml_in, "/elem"));
+
+		XMLBufferWriter xml_out;
+		push(xml_out, "Test");
+		meas(0, xml_out);
+		pop(xml_out);
+
+		return TheNamedObjMap::Instance().getData<LatticePropagator>(id);
+	}
+
+	double tol;
+};
+
+
+TEST_F(CoherentSeqSourceTest, SharedSourceSumsSinks)
+{
+	multi1d<int> t3(1), t5(1), both(2);
+	t3[0] = 3;
+	t5[0] = 5;
+	both[0] = 3;
+	both[1] = 5;
+
+	LatticePropagator seq_3   = run(t3, "seq_3");
+	LatticePropagator seq_5   = run(t5, "seq_5");
+	LatticePropagator seq_coh = run(both, "seq_coh");
+
+	LatticePropagator ref = seq_3 + seq_5;
+	LatticePropagator d = seq_coh - ref;
+	double diff = toDouble(sqrt(norm2(d) / norm2(ref)));
+
+	QDPIO::cout << "|| coherent - (t_sink=3 + t_sink=5) || / || sum || = " << diff << std::endl;
+	ASSERT_LT(diff, tol);
+
+	// Both sinks are found from the forward source
+	XMLReader record_xml;
+	TheNamedObjMap::Instance().get("seq_coh").getRecordXML(record_xml);
+
+	std::istringstream prop_is(prop_record_xml);
+	XMLReader prop_xml(prop_is);
+	Propagator_t prop_header;
+	read(prop_xml, "/Propagator", prop_header);
+
+	multi1d<SeqSource_t> seqsource_headers;
+	readSeqSources(record_xml, "/SequentialSource", prop_header.source_header, seqsource_headers);
+
+	ASSERT_EQ(seqsource_headers.size(), 2);
+	EXPECT_EQ(seqsource_headers[0].t_sink, 3);
+	EXPECT_EQ(seqsource_headers[1].t_sink, 5);
+}
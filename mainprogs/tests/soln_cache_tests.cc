@@ -0,0 +1,138 @@
+#include "chromabase.h"
+
+#include "util/ferm/soln_cache.h"
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace Chroma;
+using namespace QDP;
+
+
+//! Checksums, and a cache in a scratch directory
+class SolnCacheTest : public ::testing::Test {
+public:
+	void SetUp() {
+		params.cache_dir   = "t_soln_cache_dir";
+		params.max_size_gb = 0;
+	}
+
+	void TearDown() {
+		for(size_t i=0; i < keys.size(); ++i)
+			std::remove(fileName(keys[i]).c_str());
+		rmdir(params.cache_dir.c_str());
+	}
+
+	//! Where the cache keeps an entry
+	std::string fileName(const std::string& key) const {
+		return params.cache_dir + "/" + key + ".soln";
+	}
+
+	bool onDisk(const std::string& key) const {
+		struct stat st;
+		return stat(fileName(key).c_str(), &st) == 0;
+	}
+
+	//! A key for the source psi, remembered for the cleanup
+	std::string keyFor(SolnCacheEnv::SolnCache& cache, const LatticeFermion& psi) {
+		std::string key = cache.makeKey("0000000000000000", "<Param/>", SolnCacheEnv::checksum(psi));
+		keys.push_back(key);
+		return key;
+	}
+
+	void insert(SolnCacheEnv::SolnCache& cache, const std::string& key, const LatticeFermion& soln, int n_count) {
+		XMLBufferWriter meta;
+		write(meta, "n_count", n_count);
+		cache.insert(key, soln, meta);
+	}
+
+	SolnCacheParams_t params;
+	std::vector<std::string> keys;
+};
+
+
+TEST_F(SolnCacheTest, ChecksumSeesEverySite)
+{
+	LatticeFermion psi;
+	gaussian(psi);
+
+	std::string sum = SolnCacheEnv::checksum(psi);
+	EXPECT_EQ(sum, SolnCacheEnv::checksum(psi));
+
+	// Change one site far from the origin
+	multi1d<int> coord(Nd);
+	for(int mu=0; mu < Nd; ++mu)
+		coord[mu] = Layout::lattSize()[mu] - 1;
+
+	LatticeFermion chi = psi;
+	Fermion f = peekSite(psi, coord);
+	pokeSite(chi, Fermion(Real(2)*f), coord);
+
+	EXPECT_NE(sum, SolnCacheEnv::checksum(chi));
+}
+
+
+TEST_F(SolnCacheTest, GaugeChecksumSeesTheDirection)
+{
+	multi1d<LatticeColorMatrix> u(Nd);
+	for(int mu=0; mu < Nd; ++mu)
+		gaussian(u[mu]);
+
+	multi1d<LatticeColorMatrix> v = u;
+	v[0] = u[1];
+	v[1] = u[0];
+
+	EXPECT_NE(SolnCacheEnv::checksum(u), SolnCacheEnv::checksum(v));
+}
+
+
+TEST_F(SolnCacheTest, InsertThenLookup)
+{
+	SolnCacheEnv::SolnCache cache(params);
+	ASSERT_TRUE(cache.enabled());
+
+	LatticeFermion src, soln;
+	gaussian(src);
+	gaussian(soln);
+	std::string key = keyFor(cache, src);
+
+	LatticeFermion found;
+	XMLReader meta;
+	EXPECT_FALSE(cache.lookup(key, found, meta));
+
+	insert(cache, key, soln, 42);
+
+	XMLReader meta_hit;
+	ASSERT_TRUE(cache.lookup(key, found, meta_hit));
+
+	int n_count;
+	read(meta_hit, "/SolnCache/Meta/n_count", n_count);
+	EXPECT_EQ(n_count, 42);
+	EXPECT_EQ(toDouble(norm2(found - soln)), 0.0);
+}
+
+
+TEST_F(SolnCacheTest, EvictionKeepsTheNewestEntry)
+{
+	// Any single entry is above the limit
+	params.max_size_gb = 1.0e-12;
+	SolnCacheEnv::SolnCache cache(params);
+	ASSERT_TRUE(cache.enabled());
+
+	LatticeFermion src_a, src_b, soln;
+	gaussian(src_a);
+	gaussian(src_b);
+	gaussian(soln);
+	std::string key_a = keyFor(cache, src_a);
+	std::string key_b = keyFor(cache, src_b);
+
+	insert(cache, key_a, soln, 1);
+	EXPECT_TRUE(onDisk(key_a));
+
+	insert(cache, key_b, soln, 2);
+	EXPECT_FALSE(onDisk(key_a));
+	EXPECT_TRUE(onDisk(key_b));
+}
@@ -316,4 +316,52 @@
 #     }
 #
 
+# No recorded output for these yet: run each one and commit its
+# candidate as the .out.xml before enabling it
+#    ,
+#    {
+#	 exec_path   => "$top_builddir/mainprogs/main" , 
+#	 execute     => "chroma" , 
+#	 input       => "$test_dir/chroma/hadron/propagator/prec_clover-gcrodr.ini.xml" , 
+#	 output      => "prec_clover-gcrodr.candidate.xml",
+#	 metric      => "$test_dir/chroma/hadron/propagator/prec_clover-gcrodr.metric.xml" ,
+#	 controlfile => "$test_dir/chroma/hadron/propagator/prec_clover-gcrodr.out.xml" ,
+#     }
+#    ,
+#    {
+#	 exec_path   => "$top_builddir/mainprogs/main" , 
+#	 execute     => "chroma" , 
+#	 input       => "$test_dir/chroma/hadron/propagator/prec_clover-cacg.ini.xml" , 
+#	 output      => "prec_clover-cacg.candidate.xml",
+#	 metric      => "$test_dir/chroma/hadron/propagator/prec_clover-cacg.metric.xml" ,
+#	 controlfile => "$test_dir/chroma/hadron/propagator/prec_clover-cacg.out.xml" ,
+#     }
+#    ,
+#    {
+#	 exec_path   => "$top_builddir/mainprogs/main" , 
+#	 execute     => "chroma" , 
+#	 input       => "$test_dir/chroma/hadron/propagator/unprec_clover-sap-gcr.ini.xml" , 
+#	 output      => "unprec_clover-sap-gcr.candidate.xml",
+#	 metric      => "$test_dir/chroma/hadron/propagator/unprec_clover-sap-gcr.metric.xml" ,
+#	 controlfile => "$test_dir/chroma/hadron/propagator/unprec_clover-sap-gcr.out.xml" ,
+#     }
+#    ,
+#    {
+#	 exec_path   => "$top_builddir/mainprogs/main" , 
+#	 execute     => "chroma" , 
+#	 input       => "$test_dir/chroma/hadron/propagator/prec_clover-amg.ini.xml" , 
+#	 output      => "prec_clover-amg.candidate.xml",
+#	 metric      => "$test_dir/chroma/hadron/propagator/prec_clover-amg.metric.xml" ,
+#	 controlfile => "$test_dir/chroma/hadron/propagator/prec_clover-amg.out.xml" ,
+#     }
+#    ,
+#    {
+#	 exec_path   => "$top_builddir/mainprogs/main" , 
+#	 execute     => "chroma" , 
+#	 input       => "$test_dir/chroma/hadron/propagator/prec_clover-fused-schur.ini.xml" , 
+#	 output      => "prec_clover-fused-schur.candidate.xml",
+#	 metric      => "$test_dir/chroma/hadron/propagator/prec_clover-fused-schur.metric.xml" ,
+#	 controlfile => "$test_dir/chroma/hadron/propagator/prec_clover-fused-schur.out.xml" ,
+#     }
+
      );
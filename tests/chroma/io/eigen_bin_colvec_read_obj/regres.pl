@@ -0,0 +1,21 @@
+#
+#  This is the portion of a script this is included recursively
+#
+
+#
+# Each test has a name, input file name, output file name,
+# and the good output that is tested against.
+#
+@regres_list = 
+    (
+# No recorded output yet: run it and commit the candidate as the
+# .out.xml before enabling it
+#     {
+#	 exec_path   => "$top_builddir/mainprogs/main" , 
+#	 execute     => "chroma" , 
+#	 input       => "$test_dir/chroma/io/eigen_bin_colvec_read_obj/eigen_bin_colvec_read_obj.ini.xml" , 
+#	 output      => "eigen_bin_colvec_read_obj.candidate.xml",
+#	 metric      => "$test_dir/chroma/io/eigen_bin_colvec_read_obj/eigen_bin_colvec_read_obj.metric.xml" ,
+#	 controlfile => "$test_dir/chroma/io/eigen_bin_colvec_read_obj/eigen_bin_colvec_read_obj.out.xml" ,
+#     }
+     );
@@ -0,0 +1,21 @@
+#
+#  This is the portion of a script this is included recursively
+#
+
+#
+# Each test has a name, input file name, output file name,
+# and the good output that is tested against.
+#
+@regres_list = 
+    (
+# No recorded output yet: run it and commit the candidate as the
+# .out.xml before enabling it
+#     {
+#	 exec_path   => "$top_builddir/mainprogs/main" , 
+#	 execute     => "chroma" , 
+#	 input       => "$test_dir/chroma/io/map_obj_sharded/map_obj_sharded.ini.xml" , 
+#	 output      => "map_obj_sharded.candidate.xml",
+#	 metric      => "$test_dir/chroma/io/map_obj_sharded/map_obj_sharded.metric.xml" ,
+#	 controlfile => "$test_dir/chroma/io/map_obj_sharded/map_obj_sharded.out.xml" ,
+#     }
+     );
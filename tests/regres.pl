@@ -30,6 +30,8 @@ sub regresDirs
 	    "$test_dir/chroma/io/qio_write_obj/regres.pl",
 	    "$test_dir/chroma/io/qio_read_obj/regres.pl",
 	    "$test_dir/chroma/io/usqcd_ddpairs_prop/regres.pl",
+	    "$test_dir/chroma/io/eigen_bin_colvec_read_obj/regres.pl",
+	    "$test_dir/chroma/io/map_obj_sharded/regres.pl",
 	    "$test_dir/chroma/gfix/coulgauge/regres.pl",
 	    "$test_dir/chroma/glue/gaugestate/regres.pl",
 	    "$test_dir/chroma/glue/fuzwilp/regres.pl",